@@ -0,0 +1,139 @@
+/**********************************************************************
+ * $Id$		lpc17xx_adcdma.h				2010-05-21
+ *//**
+* @file		lpc17xx_adcdma.h
+* @brief	Contains the continuous ADC acquisition through GPDMA for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup ADCDMA ADCDMA (Continuous ADC acquisition through GPDMA)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_ADCDMA_H_
+#define LPC17XX_ADCDMA_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+#include "lpc17xx_gpdma.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup ADCDMA_Public_Macros ADCDMA Public Macros
+ * @{
+ */
+
+/** Largest buffer, in samples. Each half is one DMA pass of at most 4095 transfers */
+#define ADCDMA_MAX_SAMPLES 8190
+
+/** Macro to check the buffer size */
+#define PARAM_ADCDMA_SIZE(n) (((n) >= 2) && ((n) <= ADCDMA_MAX_SAMPLES) && (((n) & 1) == 0))
+
+/** Macro to check the start mode, burst or a timer match */
+#define PARAM_ADCDMA_START(n)                                                                                          \
+    (((n) == ADC_START_CONTINUOUS) || ((n) == ADC_START_ON_MAT01) || ((n) == ADC_START_ON_MAT03) ||                   \
+     ((n) == ADC_START_ON_MAT10) || ((n) == ADC_START_ON_MAT11))
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup ADCDMA_Public_Types ADCDMA Public Types
+     * @{
+     */
+
+    /**
+     * @brief Half buffer callback, samples are raw ADGDR words: use ADC_GDR_RESULT()
+     * and ADC_GDR_CH() on them. Runs in the DMA interrupt and must return before the
+     * other half is full */
+    typedef void (*ADCDMA_CALLBACK_Type)(uint32_t* samples, uint32_t count);
+
+    /**
+     * @brief ADC acquisition configuration structure */
+    typedef struct
+    {
+        uint32_t Rate;                 /**< ADC conversion rate in Hz, up to 200000 */
+        uint8_t Channels;              /**< Bit mask of the AD0.n inputs, scanned in order */
+        uint8_t StartMode;             /**< Conversion trigger, should be:
+                                       - ADC_START_CONTINUOUS: burst mode, back to back at Rate
+                                       - ADC_START_ON_MAT01, ADC_START_ON_MAT03, ADC_START_ON_MAT10,
+                                         ADC_START_ON_MAT11: one conversion per timer match, the
+                                         timer is set up by the caller
+                                       */
+        uint8_t DMAChannel;            /**< GPDMA channel, 0 to 7, owned by the acquisition */
+        uint32_t* Buffer;              /**< Sample buffer, used as two halves */
+        uint16_t BufferSize;           /**< Buffer size in samples, even, 2 to ADCDMA_MAX_SAMPLES */
+        ADCDMA_CALLBACK_Type Callback; /**< Called with each filled half */
+    } ADCDMA_CFG_Type;
+
+    /**
+     * @brief ADC acquisition state. The fields are private */
+    typedef struct
+    {
+        ADCDMA_CFG_Type Cfg;   /**< Copy of the configuration */
+        GPDMA_LLI_Type* Chain; /**< Circular chain from the GPDMA pool, one item per half */
+        uint32_t Overruns;     /**< Halves lost because the callback ran late */
+        uint8_t NextHalf;      /**< Half expected to complete next */
+    } ADCDMA_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup ADCDMA_Public_Functions ADCDMA Public Functions
+     * @{
+     */
+
+    Status ADCDMA_Init(ADCDMA_Type* acq, const ADCDMA_CFG_Type* cfg);
+    void ADCDMA_Start(ADCDMA_Type* acq);
+    void ADCDMA_Stop(ADCDMA_Type* acq);
+    Bool ADCDMA_IntHandler(ADCDMA_Type* acq);
+    uint32_t ADCDMA_GetOverruns(const ADCDMA_Type* acq);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_ADCDMA_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
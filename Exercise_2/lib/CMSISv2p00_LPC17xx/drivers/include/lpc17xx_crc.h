@@ -0,0 +1,111 @@
+/**********************************************************************
+ * $Id$		lpc17xx_crc.h				2010-05-21
+ *//**
+* @file		lpc17xx_crc.h
+* @brief	Contains the table driven CRC-32 for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup CRC CRC (Table driven CRC-32)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_CRC_H_
+#define LPC17XX_CRC_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup CRC_Public_Macros CRC Public Macros
+ * @{
+ */
+
+/** Table variants, by flash used: 64 bytes, 4 KB, 8 KB. The tables of the
+ * variants an application does not call are dropped by --gc-sections */
+#define CRC32_NIBBLE 0
+#define CRC32_SLICE4 1
+#define CRC32_SLICE8 2
+
+/** Variant behind CRC32_Update(). Can be overridden with -D */
+#ifndef CRC32_METHOD
+#define CRC32_METHOD CRC32_SLICE8
+#endif
+
+#if (CRC32_METHOD == CRC32_NIBBLE)
+#define CRC32_Update CRC32_UpdateNibble
+#elif (CRC32_METHOD == CRC32_SLICE4)
+#define CRC32_Update CRC32_UpdateSlice4
+#else
+#define CRC32_Update CRC32_UpdateSlice8
+#endif
+
+/** Starting value of a running CRC */
+#define CRC32_INIT 0
+
+/** CRC of data followed by its own CRC, least significant byte first as the
+ * Ethernet FCS: a frame is intact if its CRC, FCS included, is this value */
+#define CRC32_RESIDUE 0x2144DF1CUL
+
+/** Check the FCS of an Ethernet frame, len counts the 4 FCS bytes */
+#define CRC32_FCS_OK(frame, len) (CRC32_Update(CRC32_INIT, (frame), (len)) == CRC32_RESIDUE)
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup CRC_Public_Functions CRC Public Functions
+     * @{
+     */
+
+    uint32_t CRC32_UpdateNibble(uint32_t crc, const void* data, uint32_t len);
+    uint32_t CRC32_UpdateSlice4(uint32_t crc, const void* data, uint32_t len);
+    uint32_t CRC32_UpdateSlice8(uint32_t crc, const void* data, uint32_t len);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_CRC_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
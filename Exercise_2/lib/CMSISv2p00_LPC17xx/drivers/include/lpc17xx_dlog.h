@@ -0,0 +1,178 @@
+/**********************************************************************
+ * $Id$		lpc17xx_dlog.h				2010-05-21
+ *//**
+* @file		lpc17xx_dlog.h
+* @brief	Contains the deferred binary logger for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup DLOG DLOG (Deferred logger)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_DLOG_H_
+#define LPC17XX_DLOG_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include <stdint.h>
+#include "LPC17xx.h"
+#include "lpc_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup DLOG_Public_Macros DLOG Public Macros
+ * @{
+ */
+
+/** Size of the record ring in words, a power of two, can be set from the
+ * compiler command line */
+#ifndef DLOG_RING_WORDS
+#define DLOG_RING_WORDS 256
+#endif
+
+/** Most arguments of one record */
+#define DLOG_MAX_ARGS 4
+
+/** Words of a record before its arguments: header, format, time stamp */
+#define DLOG_HDR_WORDS 3
+
+/** Record header: sync byte, argument count in bits 16 to 19. A header is
+ * never 0, 0 marks a ring slot not written yet */
+#define DLOG_SYNC         0xD1000000UL
+#define DLOG_HDR(nargs)   (DLOG_SYNC | ((uint32_t)(nargs) << 16))
+#define DLOG_HDR_NARGS(h) (((h) >> 16) & 0x0F)
+
+/** Format address of the record that reports lost records, its argument is
+ * the number lost */
+#define DLOG_FMT_DROPPED 0
+
+/** Output modes */
+#define DLOG_MODE_BINARY 0 /**< Records as they are, for the host decoder */
+#define DLOG_MODE_TEXT   1 /**< Records formatted on the target */
+
+/** Log a format string and up to DLOG_MAX_ARGS integer or pointer arguments.
+ * Conversions: %d %i %u %x %X %c %s %p %%, with an optional 0 flag and width.
+ * %s strings are read when the record is shipped, so they must outlive it;
+ * the host decoder only resolves strings that are in the firmware image */
+#define DLOG(...) DLOG_PICK_(__VA_ARGS__, DLOG4_, DLOG3_, DLOG2_, DLOG1_, DLOG0_, 0)(__VA_ARGS__)
+
+/** Macro to check the output mode */
+#define PARAM_DLOG_MODE(n) (((n) == DLOG_MODE_BINARY) || ((n) == DLOG_MODE_TEXT))
+
+/** Macro to check the argument count */
+#define PARAM_DLOG_NARGS(n) ((n) <= DLOG_MAX_ARGS)
+
+/**
+ * @}
+ */
+
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup DLOG_Private_Macros DLOG Private Macros
+ * @{
+ */
+
+#define DLOG_PICK_(_f, _1, _2, _3, _4, m, ...) m
+#define DLOG_W_(a)                             ((uint32_t)(uintptr_t)(a))
+#define DLOG0_(f)                              DLOG_Put((f), 0, NULL)
+#define DLOG1_(f, a)                           DLOG_Put((f), 1, (const uint32_t[]){ DLOG_W_(a) })
+#define DLOG2_(f, a, b)                        DLOG_Put((f), 2, (const uint32_t[]){ DLOG_W_(a), DLOG_W_(b) })
+#define DLOG3_(f, a, b, c)                                                                                             \
+    DLOG_Put((f), 3, (const uint32_t[]){ DLOG_W_(a), DLOG_W_(b), DLOG_W_(c) })
+#define DLOG4_(f, a, b, c, d)                                                                                          \
+    DLOG_Put((f), 4, (const uint32_t[]){ DLOG_W_(a), DLOG_W_(b), DLOG_W_(c), DLOG_W_(d) })
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup DLOG_Public_Types DLOG Public Types
+     * @{
+     */
+
+    /**
+     * @brief Output transport. Takes what it can without waiting, for example
+     * UARTBUF_Write(), and returns the number of bytes taken */
+    typedef uint32_t (*DLOG_SINK_Type)(void* arg, const uint8_t* data, uint32_t len);
+
+    /**
+     * @brief Logger configuration */
+    typedef struct
+    {
+        uint8_t Mode;        /**< Output mode, should be:
+                             - DLOG_MODE_BINARY: records for the host decoder
+                             - DLOG_MODE_TEXT: formatted text
+                             */
+        DLOG_SINK_Type Sink; /**< Transport of the output */
+        void* SinkArg;       /**< First argument of Sink */
+    } DLOG_CFG_Type;
+
+    /**
+     * @brief Logger statistics */
+    typedef struct
+    {
+        uint32_t Records;   /**< Records shipped */
+        uint32_t Dropped;   /**< Records lost to a full ring */
+        uint32_t HighWater; /**< Most ring words in use, as seen by DLOG_Process() */
+    } DLOG_STATS_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup DLOG_Public_Functions DLOG Public Functions
+     * @{
+     */
+
+    void DLOG_Init(const DLOG_CFG_Type* cfg);
+    void DLOG_Put(const char* fmt, uint32_t nargs, const uint32_t* args);
+    uint32_t DLOG_Process(void);
+    uint32_t DLOG_Format(char* out, uint32_t max, const char* fmt, uint32_t nargs, const uint32_t* args);
+    void DLOG_GetStats(DLOG_STATS_Type* stats);
+    void DLOG_AttachDebug(void);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_DLOG_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -68,6 +68,11 @@ extern "C"
 #define EMAC_MODE_100M_FULL (3) /**< 100Mbps FullDuplex mode */
 #define EMAC_MODE_100M_HALF (4) /**< 100Mbps HalfDuplex mode */
 
+/* EMAC link status bits, see EMAC_GetLinkStatus() */
+#define EMAC_LINK_UP       (1 << 0) /**< Link up */
+#define EMAC_LINK_100M     (1 << 1) /**< 100Mbps, otherwise 10Mbps */
+#define EMAC_LINK_FULL_DUP (1 << 2) /**< FullDuplex, otherwise HalfDuplex */
+
 /**
  * @}
  */
@@ -676,6 +681,29 @@ extern "C"
                               */
     } EMAC_CFG_Type;
 
+    /**
+     * @brief EMAC PHY management states, see EMAC_PHYTick()
+     */
+    typedef enum
+    {
+        EMAC_PHY_STOPPED = 0, /**< EMAC_InitAsync() not called */
+        EMAC_PHY_RESETTING,   /**< PHY reset, identification and mode setting */
+        EMAC_PHY_LINK_DOWN,   /**< Waiting for the link, e.g. auto-negotiation */
+        EMAC_PHY_LINK_UP,     /**< Link up, MAC set to its speed and duplex */
+        EMAC_PHY_FAILED       /**< PHY not answering, reset time out or unknown PHY */
+    } EMAC_PHY_STATE_Type;
+
+    /**
+     * @brief EMAC PHY management configuration
+     */
+    typedef struct
+    {
+        uint32_t ResetTimeout;             /**< Ticks the PHY may take to reset and answer */
+        uint32_t PollInterval;             /**< Ticks between two link status reads, 1 or more */
+        void (*LinkChange)(uint32_t link); /**< Link change callback with the EMAC_LINK_ bits,
+                                              called from EMAC_PHYTick(), NULL for none */
+    } EMAC_PHY_CFG_Type;
+
     /**
      * @}
      */
@@ -686,12 +714,16 @@ extern "C"
      */
     /* Init/DeInit EMAC peripheral */
     Status EMAC_Init(EMAC_CFG_Type* EMAC_ConfigStruct);
+    Status EMAC_InitAsync(EMAC_CFG_Type* EMAC_ConfigStruct, EMAC_PHY_CFG_Type* PHY_ConfigStruct);
     void EMAC_DeInit(void);
 
     /* PHY functions --------------*/
     int32_t EMAC_CheckPHYStatus(uint32_t ulPHYState);
     int32_t EMAC_SetPHYMode(uint32_t ulPHYMode);
     int32_t EMAC_UpdatePHYStatus(void);
+    void EMAC_PHYTick(void);
+    EMAC_PHY_STATE_Type EMAC_GetPHYState(void);
+    uint32_t EMAC_GetLinkStatus(void);
 
     /* Filter functions ----------*/
     void EMAC_SetHashFilter(uint8_t dstMAC_addr[], FunctionalState NewState);
@@ -78,6 +78,20 @@ extern "C"
 /** Fast GPIO port 4 half-word accessible definition */
 #define GPIO4_HalfWord ((GPIO_HalfWord_TypeDef*)(LPC_GPIO4_BASE))
 
+/** Fast GPIO port n register block, the five ports are 0x20 apart from port 0 */
+#define GPIO_PORT(n) ((LPC_GPIO_TypeDef*)(LPC_GPIO0_BASE + ((uint32_t)(n) << 5)))
+
+/** Macro to check the GPIO port number */
+#define PARAM_GPIO_PORT(n) ((n) <= 4)
+
+/** SRAM bit-band region and its alias, the GPIO ports (0x2009C000) are inside it */
+#define GPIO_BITBAND_REF   0x20000000UL
+#define GPIO_BITBAND_ALIAS 0x22000000UL
+
+/** Bit-band alias word of bit n of the GPIO register reg */
+#define GPIO_BITBAND(reg, n)                                                                                           \
+    (*(volatile uint32_t*)(GPIO_BITBAND_ALIAS + ((ADDR32(&(reg)) - GPIO_BITBAND_REF) << 5) + ((uint32_t)(n) << 2)))
+
     /**
      * @}
      */
@@ -160,6 +174,105 @@ extern "C"
     void FIO_ByteClearValue(uint8_t portNum, uint8_t byteNum, uint8_t bitValue);
     uint8_t FIO_ByteReadValue(uint8_t portNum, uint8_t byteNum);
 
+    /* Fast path (inline, unchecked) ------------------------------- */
+    /* portNum must be in range from 0 to 4, it is not checked. With a constant
+       portNum each call compiles to a single load or store on the port. */
+
+    /**
+     * @brief  Set output bits, same as GPIO_SetValue()
+     * @param[in] portNum   Port number, in range from 0 to 4
+     * @param[in] bitValue  Bits to set */
+    static inline void GPIO_FastSet(uint8_t portNum, uint32_t bitValue)
+    {
+        HWREG_WRITE(GPIO_PORT(portNum)->FIOSET, bitValue);
+    }
+
+    /**
+     * @brief  Clear output bits, same as GPIO_ClearValue()
+     * @param[in] portNum   Port number, in range from 0 to 4
+     * @param[in] bitValue  Bits to clear */
+    static inline void GPIO_FastClear(uint8_t portNum, uint32_t bitValue)
+    {
+        HWREG_WRITE(GPIO_PORT(portNum)->FIOCLR, bitValue);
+    }
+
+    /**
+     * @brief  Read the pin state, same as GPIO_ReadValue()
+     * @param[in] portNum   Port number, in range from 0 to 4
+     * @return Current value of the port */
+    static inline uint32_t GPIO_FastRead(uint8_t portNum)
+    {
+        return HWREG_READ(GPIO_PORT(portNum)->FIOPIN);
+    }
+
+    /**
+     * @brief  Toggle output bits. The output latch is read back from FIOSET,
+     *         not the pin level from FIOPIN. The bits not in bitValue are never
+     *         written, but the read and the two stores are not atomic for the
+     *         toggled ones
+     * @param[in] portNum   Port number, in range from 0 to 4
+     * @param[in] bitValue  Bits to toggle */
+    static inline void GPIO_FastToggle(uint8_t portNum, uint32_t bitValue)
+    {
+        LPC_GPIO_TypeDef* pGPIO = GPIO_PORT(portNum);
+        uint32_t latch = HWREG_READ(pGPIO->FIOSET);
+
+        HWREG_WRITE(pGPIO->FIOSET, ~latch & bitValue);
+        HWREG_WRITE(pGPIO->FIOCLR, latch & bitValue);
+    }
+
+    /* Single pin (unchecked) ------------------------------- */
+    /* Each write or toggle is a single store of the pin mask to FIOSET or
+       FIOCLR, which only changes the latch of that pin. Never a store to the
+       bit-band alias of FIOPIN: the bus does that as a read-modify-write of
+       the whole word, which writes the sampled level of every pin back into
+       its output latch, and corrupts outputs whose level differs from the
+       latch (open-drain lines held low by another device, heavily loaded
+       pins). */
+
+    /**
+     * @brief  Write one output pin
+     * @param[in] portNum  Port number, in range from 0 to 4
+     * @param[in] pinNum   Pin number, in range from 0 to 31
+     * @param[in] value    0: low, 1: high */
+    static inline void GPIO_PinWrite(uint8_t portNum, uint8_t pinNum, uint8_t value)
+    {
+        LPC_GPIO_TypeDef* pGPIO = GPIO_PORT(portNum);
+
+        HWREG_WRITE(*(value ? &pGPIO->FIOSET : &pGPIO->FIOCLR), 1UL << pinNum);
+    }
+
+    /**
+     * @brief  Read one pin
+     * @param[in] portNum  Port number, in range from 0 to 4
+     * @param[in] pinNum   Pin number, in range from 0 to 31
+     * @return 0: low, 1: high */
+    static inline uint8_t GPIO_PinRead(uint8_t portNum, uint8_t pinNum)
+    {
+        return (uint8_t)GPIO_BITBAND(GPIO_PORT(portNum)->FIOPIN, pinNum);
+    }
+
+    /**
+     * @brief  Toggle one output pin, safe from any interrupt priority.
+     *         The latch bit is loaded exclusively from the bit-band alias of
+     *         FIOSET, then the pin mask is store-exclusive to FIOCLR or FIOSET.
+     *         The Cortex-M3 local monitor does not compare addresses and is
+     *         cleared by every exception entry and return, so the store fails
+     *         and the toggle is retried if an interrupt ran in between.
+     *         Interrupts are never masked. Another bus master writing the
+     *         same pin is not ordered against the toggle
+     * @param[in] portNum  Port number, in range from 0 to 4
+     * @param[in] pinNum   Pin number, in range from 0 to 31 */
+    static inline void GPIO_PinToggle(uint8_t portNum, uint8_t pinNum)
+    {
+        LPC_GPIO_TypeDef* pGPIO = GPIO_PORT(portNum);
+        volatile uint32_t* pLatch = &GPIO_BITBAND(pGPIO->FIOSET, pinNum);
+
+        while (__STREXW(1UL << pinNum, __LDREXW(pLatch) ? &pGPIO->FIOCLR : &pGPIO->FIOSET) != 0)
+        {
+        }
+    }
+
     /**
      * @}
      */
@@ -0,0 +1,151 @@
+/**********************************************************************
+ * $Id$		lpc17xx_heap.h				2010-05-21
+ *//**
+* @file		lpc17xx_heap.h
+* @brief	Contains the bounded time TLSF memory allocator for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup HEAP HEAP (Bounded time TLSF memory allocator)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_HEAP_H_
+#define LPC17XX_HEAP_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup HEAP_Public_Macros HEAP Public Macros
+ * @{
+ */
+
+/** Alignment of the returned blocks, in bytes */
+#define HEAP_ALIGN 8
+
+/** Blocks are smaller than 2^HEAP_FL_MAX bytes, 128 KB covers all the RAM of the
+ * part. Can be overridden with -D, the HEAP_Type size follows */
+#ifndef HEAP_FL_MAX
+#define HEAP_FL_MAX 17
+#endif
+
+/** Second level lists per power of two: the rounding of a request wastes at
+ * most 1/16 of it */
+#define HEAP_SL_LOG2 4
+#define HEAP_SL_COUNT (1 << HEAP_SL_LOG2)
+
+/** Sizes below 2^HEAP_FL_SHIFT share the first level list 0 */
+#define HEAP_FL_SHIFT (HEAP_SL_LOG2 + 3)
+#define HEAP_FL_COUNT (HEAP_FL_MAX - HEAP_FL_SHIFT + 1)
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup HEAP_Public_Types HEAP Public Types
+     * @{
+     */
+
+    /**
+     * @brief Heap block header, HEAP_ALIGN bytes on the target. The free list
+     * links live in the payload of free blocks. The fields are private */
+    typedef struct HEAP_BLOCK
+    {
+        struct HEAP_BLOCK* PrevPhys; /**< Block just below, valid while that one is free */
+        uint32_t Size;               /**< Payload bytes, bit 0: free, bit 1: previous block free */
+    } HEAP_BLOCK_Type;
+
+    /**
+     * @brief Heap state. Free blocks are kept in segregated lists, a two level
+     * bitmap finds a fitting list in constant time. The fields are private */
+    typedef struct
+    {
+        uint32_t FlBitmap;                                  /**< Non empty first level classes */
+        uint32_t SlBitmap[HEAP_FL_COUNT];                   /**< Non empty lists per class */
+        HEAP_BLOCK_Type* Free[HEAP_FL_COUNT][HEAP_SL_COUNT]; /**< List heads */
+        uint32_t Size;                                      /**< Pool bytes in use by the heap */
+        uint32_t Used;                                      /**< Bytes in allocated blocks, headers included */
+        uint32_t HighWater;                                 /**< Most bytes ever used */
+        uint32_t Allocs;                                    /**< Blocks currently allocated */
+        uint32_t Failures;                                  /**< Requests that could not be served */
+    } HEAP_Type;
+
+    /**
+     * @brief Heap statistics */
+    typedef struct
+    {
+        uint32_t Size;          /**< Pool bytes managed, headers included */
+        uint32_t Used;          /**< Bytes in allocated blocks, headers included */
+        uint32_t HighWater;     /**< Most bytes ever used */
+        uint32_t Free;          /**< Payload bytes of the free blocks */
+        uint32_t LargestFree;   /**< Payload bytes of the largest free block */
+        uint32_t FreeBlocks;    /**< Number of free blocks */
+        uint32_t Allocs;        /**< Blocks currently allocated */
+        uint32_t Failures;      /**< Requests that could not be served */
+        uint8_t Fragmentation;  /**< Free memory outside the largest free block, in percent */
+    } HEAP_STATS_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup HEAP_Public_Functions HEAP Public Functions
+     * @{
+     */
+
+    void HEAP_Init(HEAP_Type* heap, void* pool, uint32_t size);
+    void* HEAP_Alloc(HEAP_Type* heap, uint32_t size);
+    void HEAP_Free(HEAP_Type* heap, void* ptr);
+    void* HEAP_Realloc(HEAP_Type* heap, void* ptr, uint32_t size);
+    uint32_t HEAP_GetBlockSize(const void* ptr);
+    void HEAP_GetStats(HEAP_Type* heap, HEAP_STATS_Type* stats);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_HEAP_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -47,10 +47,17 @@
  */
 
 /************************** DEBUG MODE DEFINITIONS *********************************/
-/* Un-comment the line below to compile the library in DEBUG mode, this will expanse
-   the "CHECK_PARAM" macro in the FW library code */
-
+/* The library is compiled in DEBUG mode unless the release profile is selected
+   with -DLIBCFG_RELEASE (make PROFILE=release). DEBUG expanses the "CHECK_PARAM"
+   macro in the FW library code to a runtime check; in the release profile only
+   the checks that the compiler can evaluate at compile time are kept. Inside
+   the library few parameters are constants; the constant arguments passed by
+   the application to the timer, ADC and CAN entry points are checked at the
+   call site instead (CHECK_PARAM_CALL, see lpc_types.h) */
+
+#ifndef LIBCFG_RELEASE
 #define DEBUG
+#endif
 
 /******************* PERIPHERAL FW LIBRARY CONFIGURATION DEFINITIONS ***********************/
 /* Comment the line below to disable the specific peripheral inclusion */
@@ -132,6 +139,60 @@
 /* EMAC ------------------------------ */
 #define _EMAC
 
+/* PROF ------------------------------ */
+#define _PROF
+
+/* CAPTURE --------------------------- */
+#define _CAPTURE
+
+/* STATS ----------------------------- */
+#define _STATS
+
+/* ADCDMA ---------------------------- */
+#define _ADCDMA
+
+/* WAVEGEN --------------------------- */
+#define _WAVEGEN
+
+/* UARTBUF --------------------------- */
+#define _UARTBUF
+
+/* UARTDMA --------------------------- */
+#define _UARTDMA
+
+/* DLOG ------------------------------ */
+#define _DLOG
+
+/* STDIO ----------------------------- */
+#define _STDIO
+
+/* HEAP ------------------------------ */
+#define _HEAP
+
+/* SSPDMA ---------------------------- */
+#define _SSPDMA
+
+/* I2CQ ------------------------------ */
+#define _I2CQ
+
+/* CANQ ------------------------------ */
+#define _CANQ
+
+/* CRC ------------------------------- */
+#define _CRC
+
+/* EMACQ ----------------------------- */
+#define _EMACQ
+
+/* I2SDMA ---------------------------- */
+#define _I2SDMA
+
+/* RESAMPLE -------------------------- */
+#define _RESAMPLE
+/* Portable arm_fir_decimate_q15() and arm_fir_interpolate_q15(). Remove
+ * when linking the CMSIS-DSP library */
+#define _RESAMPLE_FIR
+
 /************************** GLOBAL/PUBLIC MACRO DEFINITIONS *********************************/
 
 #ifdef DEBUG
@@ -145,6 +206,21 @@
  * @return		None
  *******************************************************************************/
 #define CHECK_PARAM(expr) ((expr) ? (void)0 : check_failed((uint8_t*)__FILE__, __LINE__))
+#elif defined(__GNUC__) && defined(__OPTIMIZE__)
+/*******************************************************************************
+ * @brief		Release profile CHECK_PARAM. No code is generated, but when
+ * 				expr is a compile-time constant (a constant argument seen
+ * 				through inlining or constant propagation) and false, the
+ * 				build stops with an error at the offending call.
+ * @param[in]	expr - Parameter check expression
+ * @return		None
+ *******************************************************************************/
+#define CHECK_PARAM(expr)                                                                                              \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (__builtin_constant_p(expr) && !(expr))                                                                     \
+            check_failed_const();                                                                                      \
+    } while (0)
 #else
 #define CHECK_PARAM(expr)
 #endif /* DEBUG */
@@ -160,6 +236,9 @@
 
 #ifdef DEBUG
 void check_failed(uint8_t* file, uint32_t line);
+#elif defined(__GNUC__) && defined(__OPTIMIZE__)
+/* Never defined: any call left after optimization is a constant parameter error */
+extern void check_failed_const(void) __attribute__((error("CHECK_PARAM failed on a constant parameter")));
 #endif
 
 /**
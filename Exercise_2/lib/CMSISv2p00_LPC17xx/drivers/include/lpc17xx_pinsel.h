@@ -125,6 +125,14 @@ extern "C"
 #define PINSEL_I2C_Normal_Mode ((0)) /**< The standard drive mode */
 #define PINSEL_I2C_Fast_Mode   ((1)) /**< Fast Mode Plus drive mode */
 
+/***********************************************************************
+ * Pin table helpers for PINSEL_ConfigPins()
+ **********************************************************************/
+/** Initializer of one PINSEL_CFG_Type table entry */
+#define PINSEL_CFG(port, pin, func, mode, od) {(port), (pin), (func), (mode), (od)}
+/** Number of entries of a pin table array */
+#define PINSEL_TABLE_SIZE(table) (sizeof(table) / sizeof((table)[0]))
+
 /**
  * @}
  */
@@ -141,6 +149,18 @@ extern "C"
 #define PINSEL_I2CPADCFG_SCLDRV0 _BIT(2) /**< Drive mode control for the SCL0 pin, P0.28 */
 #define PINSEL_I2CPADCFG_SCLI2C0 _BIT(3) /**< I2C mode control for the SCL0 pin, P0.28 */
 
+/* Number of PINSEL/PINMODE registers used by ports 0 to 4 (PINSEL0..9) and of PINMODE_OD registers */
+#define PINSEL_NUM_PINSEL 10
+#define PINSEL_NUM_OD     5
+
+/** Macros to check a PINSEL_CFG_Type entry: port, pin, function, resistor mode and open drain mode */
+#define PARAM_PINSEL_PORT(n)    ((n) <= PINSEL_PORT_4)
+#define PARAM_PINSEL_PIN(n)     ((n) <= PINSEL_PIN_31)
+#define PARAM_PINSEL_FUNC(n)    ((n) <= PINSEL_FUNC_3)
+#define PARAM_PINSEL_PINMODE(n) (((n) == PINSEL_PINMODE_PULLUP) || ((n) == PINSEL_PINMODE_TRISTATE) \
+                                 || ((n) == PINSEL_PINMODE_PULLDOWN))
+#define PARAM_PINSEL_OD(n)      (((n) == PINSEL_PINMODE_NORMAL) || ((n) == PINSEL_PINMODE_OPENDRAIN))
+
     /**
      * @}
      */
@@ -178,6 +198,7 @@ extern "C"
      */
 
     void PINSEL_ConfigPin(PINSEL_CFG_Type* PinCfg);
+    void PINSEL_ConfigPins(const PINSEL_CFG_Type* PinTable, uint32_t NumPins);
     void PINSEL_ConfigTraceFunc(FunctionalState NewState);
     void PINSEL_SetI2C0Pins(uint8_t i2cPinMode, FunctionalState filterSlewRateEnable);
 
@@ -0,0 +1,521 @@
+/**********************************************************************
+ * $Id$		lpc17xx_dlog.c				2010-05-21
+ *//**
+* @file		lpc17xx_dlog.c
+* @brief	Contains all functions support for the deferred binary logger on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup DLOG
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_dlog.h"
+#include "debug_frmwrk.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _DLOG
+
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup DLOG_Private_Macros DLOG Private Macros
+ * @{
+ */
+
+/** Index mask of the ring */
+#define DLOG_MASK (DLOG_RING_WORDS - 1)
+
+/** Staging buffer, holds one encoded or formatted record */
+#define DLOG_STAGE_SIZE 128
+
+/**
+ * @}
+ */
+
+/* Private Variables ---------------------------------------------------------- */
+/** @defgroup DLOG_Private_Variables DLOG Private Variables
+ * @{
+ */
+
+/** Record ring. A slot is 0 until a producer has written it, the consumer
+ * clears the slots it frees */
+static volatile uint32_t dlog_ring[DLOG_RING_WORDS];
+
+/** Words ever reserved, moved by the producers with LDREX/STREX */
+static volatile uint32_t dlog_head;
+
+/** Words ever freed, moved by DLOG_Process() */
+static volatile uint32_t dlog_tail;
+
+/** Records lost to a full ring, and the part already reported */
+static volatile uint32_t dlog_dropped;
+static uint32_t dlog_dropped_sent;
+
+static uint32_t dlog_records;
+static uint32_t dlog_high_water;
+static DLOG_CFG_Type dlog_cfg;
+
+/** Encoded or formatted record waiting for the sink */
+static uint8_t dlog_stage[DLOG_STAGE_SIZE];
+static uint32_t dlog_stage_len;
+static uint32_t dlog_stage_sent;
+
+/**
+ * @}
+ */
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup DLOG_Private_Functions DLOG Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Count a lost record, from any context
+                                                                         * @param[in]	None
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void dlog_drop(void)
+{
+    uint32_t n;
+
+    do
+    {
+        n = __LDREXW(&dlog_dropped);
+    } while (__STREXW(n + 1, &dlog_dropped));
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Write an unsigned number in a base, right aligned in a field
+                                                                         * @param[out]	out		Destination
+                                                                         * @param[in]	max		Room in the destination
+                                                                         * @param[in]	value	Number
+                                                                         * @param[in]	base	10 or 16
+                                                                         * @param[in]	upper	Upper case hex digits
+                                                                         * @param[in]	width	Field width, 0 for none
+                                                                         * @param[in]	pad		Fill character, ' ' or '0'
+                                                                         * @param[in]	neg		Print a minus sign
+                                                                         * @return		Number of characters written
+                                                                         **********************************************************************/
+static uint32_t dlog_number(char* out, uint32_t max, uint32_t value, uint32_t base, Bool upper, uint32_t width,
+                            char pad, Bool neg)
+{
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char tmp[11];
+    uint32_t n = 0, len = 0;
+
+    do
+    {
+        tmp[n++] = digits[value % base];
+        value /= base;
+    } while (value != 0);
+
+    /* The sign goes before zero padding, after space padding */
+    if (neg && (pad == '0') && (len < max))
+    {
+        out[len++] = '-';
+    }
+    while ((width > n + (neg ? 1 : 0)) && (len < max))
+    {
+        out[len++] = pad;
+        width--;
+    }
+    if (neg && (pad != '0') && (len < max))
+    {
+        out[len++] = '-';
+    }
+    while (n && (len < max))
+    {
+        out[len++] = tmp[--n];
+    }
+    return len;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Fill the staging buffer with the next output: a lost record
+                                                                         * report, or the oldest committed record, which is freed
+                                                                         * @param[in]	None
+                                                                         * @return		FALSE if there is nothing to ship
+                                                                         **********************************************************************/
+static Bool dlog_stage_next(void)
+{
+    uint32_t rec[DLOG_HDR_WORDS + DLOG_MAX_ARGS];
+    uint32_t tail = dlog_tail;
+    uint32_t dropped = dlog_dropped;
+    uint32_t n, i;
+
+    if (dropped != dlog_dropped_sent)
+    {
+        rec[0] = DLOG_HDR(1);
+        rec[1] = DLOG_FMT_DROPPED;
+        rec[2] = DWT->CYCCNT;
+        rec[3] = dropped - dlog_dropped_sent;
+        dlog_dropped_sent = dropped;
+        n = DLOG_HDR_WORDS + 1;
+    }
+    else
+    {
+        /* A record still being written holds back the ones after it */
+        rec[0] = dlog_ring[tail & DLOG_MASK];
+        if (rec[0] == 0)
+        {
+            return FALSE;
+        }
+        __DMB();
+        if (dlog_head - tail > dlog_high_water)
+        {
+            dlog_high_water = dlog_head - tail;
+        }
+        n = DLOG_HDR_WORDS + DLOG_HDR_NARGS(rec[0]);
+        for (i = 0; i < n; i++)
+        {
+            if (i)
+            {
+                rec[i] = dlog_ring[(tail + i) & DLOG_MASK];
+            }
+            dlog_ring[(tail + i) & DLOG_MASK] = 0;
+        }
+        __DMB();
+        dlog_tail = tail + n;
+        dlog_records++;
+    }
+
+    if (dlog_cfg.Mode == DLOG_MODE_BINARY)
+    {
+        for (i = 0; i < n * 4; i++)
+        {
+            dlog_stage[i] = (uint8_t)(rec[i / 4] >> (8 * (i % 4)));
+        }
+        dlog_stage_len = n * 4;
+    }
+    else if (rec[1] == DLOG_FMT_DROPPED)
+    {
+        dlog_stage_len = DLOG_Format((char*)dlog_stage, DLOG_STAGE_SIZE, "<%u lost>\n", 1, &rec[3]);
+    }
+    else
+    {
+        dlog_stage_len = DLOG_Format((char*)dlog_stage, DLOG_STAGE_SIZE, (const char*)(uintptr_t)rec[1], n - 3, &rec[3]);
+    }
+    dlog_stage_sent = 0;
+    return TRUE;
+}
+
+#ifdef _DBGFWK
+/*********************************************************************/ /**
+                                                                         * @brief		Deferred versions of the debug framework output functions,
+                                                                         * same text as the blocking ones
+                                                                         **********************************************************************/
+static void dlog_db_msg(LPC_UART_TypeDef* UARTx, const void* s)
+{
+    DLOG("%s", s);
+}
+
+static void dlog_db_msg_(LPC_UART_TypeDef* UARTx, const void* s)
+{
+    DLOG("%s\n\r", s);
+}
+
+static void dlog_db_char(LPC_UART_TypeDef* UARTx, uint8_t ch)
+{
+    DLOG("%c", ch);
+}
+
+static void dlog_db_dec(LPC_UART_TypeDef* UARTx, uint8_t decn)
+{
+    DLOG("%03u", decn);
+}
+
+static void dlog_db_dec_16(LPC_UART_TypeDef* UARTx, uint16_t decn)
+{
+    DLOG("%05u", decn);
+}
+
+static void dlog_db_dec_32(LPC_UART_TypeDef* UARTx, uint32_t decn)
+{
+    DLOG("%010u", decn);
+}
+
+static void dlog_db_hex(LPC_UART_TypeDef* UARTx, uint8_t hexn)
+{
+    DLOG("0x%02X", hexn);
+}
+
+static void dlog_db_hex_16(LPC_UART_TypeDef* UARTx, uint16_t hexn)
+{
+    DLOG("0x%04X", hexn);
+}
+
+static void dlog_db_hex_32(LPC_UART_TypeDef* UARTx, uint32_t hexn)
+{
+    DLOG("0x%08X", hexn);
+}
+#endif /* _DBGFWK */
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup DLOG_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Empty the record ring and set the output. Starts the DWT cycle
+                                                                         * counter, which stamps the records
+                                                                         * @param[in]	cfg		Configuration, copied
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void DLOG_Init(const DLOG_CFG_Type* cfg)
+{
+    uint32_t i;
+
+    CHECK_PARAM(PARAM_DLOG_MODE(cfg->Mode));
+
+    dlog_cfg = *cfg;
+    for (i = 0; i < DLOG_RING_WORDS; i++)
+    {
+        dlog_ring[i] = 0;
+    }
+    dlog_head = 0;
+    dlog_tail = 0;
+    dlog_dropped = 0;
+    dlog_dropped_sent = 0;
+    dlog_records = 0;
+    dlog_high_water = 0;
+    dlog_stage_len = 0;
+    dlog_stage_sent = 0;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Store one record: the format address, a time stamp and the raw
+                                                                         * arguments. Nothing is formatted here
+                                                                         * @param[in]	fmt		Format string, must outlive the record
+                                                                         * @param[in]	nargs	Number of arguments, 0 to DLOG_MAX_ARGS
+                                                                         * @param[in]	args	Arguments
+                                                                         * @return		None
+                                                                         * @note		Lock free, can be called from any context, including interrupts
+                                                                         * that preempt another call. A full ring drops the record and
+                                                                         * counts it. Use the DLOG() macro rather than this function
+                                                                         **********************************************************************/
+void DLOG_Put(const char* fmt, uint32_t nargs, const uint32_t* args)
+{
+    uint32_t n = DLOG_HDR_WORDS + nargs;
+    uint32_t head, i;
+
+    CHECK_PARAM(PARAM_DLOG_NARGS(nargs));
+
+    /* Reserve the words, an interrupt in between makes the STREX fail */
+    do
+    {
+        head = __LDREXW(&dlog_head);
+        if (head + n - dlog_tail > DLOG_RING_WORDS)
+        {
+            __CLREX();
+            dlog_drop();
+            return;
+        }
+    } while (__STREXW(head + n, &dlog_head));
+
+    dlog_ring[(head + 1) & DLOG_MASK] = (uint32_t)(uintptr_t)fmt;
+    dlog_ring[(head + 2) & DLOG_MASK] = DWT->CYCCNT;
+    for (i = 0; i < nargs; i++)
+    {
+        dlog_ring[(head + DLOG_HDR_WORDS + i) & DLOG_MASK] = args[i];
+    }
+
+    /* The header commits the record, it must be the last word seen */
+    __DMB();
+    dlog_ring[head & DLOG_MASK] = DLOG_HDR(nargs);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Ship records to the sink until it is full or the ring is empty.
+                                                                         * Call from the idle loop or a low priority task
+                                                                         * @param[in]	None
+                                                                         * @return		Number of bytes given to the sink
+                                                                         * @note		Call from one execution context only
+                                                                         **********************************************************************/
+uint32_t DLOG_Process(void)
+{
+    uint32_t total = 0, n;
+
+    for (;;)
+    {
+        if (dlog_stage_sent < dlog_stage_len)
+        {
+            n = dlog_cfg.Sink(dlog_cfg.SinkArg, &dlog_stage[dlog_stage_sent], dlog_stage_len - dlog_stage_sent);
+            dlog_stage_sent += n;
+            total += n;
+            if (dlog_stage_sent < dlog_stage_len)
+            {
+                return total;
+            }
+        }
+        if (!dlog_stage_next())
+        {
+            return total;
+        }
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Format a record as text, the conversions of DLOG()
+                                                                         * @param[out]	out		Destination, not terminated
+                                                                         * @param[in]	max		Room in the destination
+                                                                         * @param[in]	fmt		Format string
+                                                                         * @param[in]	nargs	Number of arguments
+                                                                         * @param[in]	args	Arguments, missing ones read as 0
+                                                                         * @return		Number of characters written, the text is cut at max
+                                                                         **********************************************************************/
+uint32_t DLOG_Format(char* out, uint32_t max, const char* fmt, uint32_t nargs, const uint32_t* args)
+{
+    uint32_t len = 0, arg = 0, width, value;
+    const char* s;
+    char pad;
+
+    while (*fmt && (len < max))
+    {
+        if (*fmt != '%')
+        {
+            out[len++] = *fmt++;
+            continue;
+        }
+        fmt++;
+        pad = ' ';
+        width = 0;
+        if (*fmt == '0')
+        {
+            pad = '0';
+            fmt++;
+        }
+        while ((*fmt >= '0') && (*fmt <= '9'))
+        {
+            width = width * 10 + (*fmt++ - '0');
+        }
+        if (*fmt == 'l')
+        {
+            fmt++;
+        }
+        if (*fmt == '%')
+        {
+            out[len++] = '%';
+            fmt++;
+            continue;
+        }
+        if (*fmt == '\0')
+        {
+            break;
+        }
+        value = (arg < nargs) ? args[arg] : 0;
+        arg++;
+        switch (*fmt++)
+        {
+            case 'd':
+            case 'i':
+                len += dlog_number(&out[len], max - len, ((int32_t)value < 0) ? -value : value, 10, FALSE, width, pad,
+                                   ((int32_t)value < 0) ? TRUE : FALSE);
+                break;
+            case 'u': len += dlog_number(&out[len], max - len, value, 10, FALSE, width, pad, FALSE); break;
+            case 'x': len += dlog_number(&out[len], max - len, value, 16, FALSE, width, pad, FALSE); break;
+            case 'X': len += dlog_number(&out[len], max - len, value, 16, TRUE, width, pad, FALSE); break;
+            case 'p': len += dlog_number(&out[len], max - len, value, 16, FALSE, 8, '0', FALSE); break;
+            case 'c': out[len++] = (char)value; break;
+            case 's':
+                s = (const char*)(uintptr_t)value;
+                while (s && *s && (len < max))
+                {
+                    out[len++] = *s++;
+                }
+                break;
+            default: break;
+        }
+    }
+    return len;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the record counters and the ring high-water mark
+                                                                         * @param[out]	stats	Statistics
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void DLOG_GetStats(DLOG_STATS_Type* stats)
+{
+    stats->Records = dlog_records;
+    stats->Dropped = dlog_dropped;
+    stats->HighWater = dlog_high_water;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Route the debug framework output (_DBG, _DBD32, _DBH32...)
+                                                                         * through the logger. Call after debug_frmwrk_init(), input
+                                                                         * (_DG) stays on the UART
+                                                                         * @param[in]	None
+                                                                         * @return		None
+                                                                         * @note		_DBG() and _DBG_() then log only the string pointer, as
+                                                                         * DLOG("%s") does: the text is read when the record is shipped,
+                                                                         * and in binary mode the host decoder only resolves strings of
+                                                                         * the firmware image. Their arguments must be string literals or
+                                                                         * other static strings that do not change, never RAM buffers
+                                                                         **********************************************************************/
+void DLOG_AttachDebug(void)
+{
+#ifdef _DBGFWK
+    _db_msg = dlog_db_msg;
+    _db_msg_ = dlog_db_msg_;
+    _db_char = dlog_db_char;
+    _db_dec = dlog_db_dec;
+    _db_dec_16 = dlog_db_dec_16;
+    _db_dec_32 = dlog_db_dec_32;
+    _db_hex = dlog_db_hex;
+    _db_hex_16 = dlog_db_hex_16;
+    _db_hex_32 = dlog_db_hex_32;
+#endif /* _DBGFWK */
+}
+
+/**
+ * @}
+ */
+
+#endif /* _DLOG */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -65,19 +65,8 @@ static GPIO_Byte_TypeDef* FIO_ByteGetPointer(uint8_t portNum);
                                                                          **********************************************************************/
 static LPC_GPIO_TypeDef* GPIO_GetPointer(uint8_t portNum)
 {
-    LPC_GPIO_TypeDef* pGPIO = NULL;
-
-    switch (portNum)
-    {
-        case 0: pGPIO = LPC_GPIO0; break;
-        case 1: pGPIO = LPC_GPIO1; break;
-        case 2: pGPIO = LPC_GPIO2; break;
-        case 3: pGPIO = LPC_GPIO3; break;
-        case 4: pGPIO = LPC_GPIO4; break;
-        default: break;
-    }
-
-    return pGPIO;
+    /* Ports are evenly spaced, so no per-port switch is needed */
+    return (PARAM_GPIO_PORT(portNum) ? GPIO_PORT(portNum) : NULL);
 }
 
 /*********************************************************************/ /**
@@ -89,19 +78,7 @@ static LPC_GPIO_TypeDef* GPIO_GetPointer(uint8_t portNum)
                                                                          **********************************************************************/
 static GPIO_HalfWord_TypeDef* FIO_HalfWordGetPointer(uint8_t portNum)
 {
-    GPIO_HalfWord_TypeDef* pFIO = NULL;
-
-    switch (portNum)
-    {
-        case 0: pFIO = GPIO0_HalfWord; break;
-        case 1: pFIO = GPIO1_HalfWord; break;
-        case 2: pFIO = GPIO2_HalfWord; break;
-        case 3: pFIO = GPIO3_HalfWord; break;
-        case 4: pFIO = GPIO4_HalfWord; break;
-        default: break;
-    }
-
-    return pFIO;
+    return (PARAM_GPIO_PORT(portNum) ? (GPIO_HalfWord_TypeDef*)GPIO_PORT(portNum) : NULL);
 }
 
 /*********************************************************************/ /**
@@ -113,19 +90,7 @@ static GPIO_HalfWord_TypeDef* FIO_HalfWordGetPointer(uint8_t portNum)
                                                                          **********************************************************************/
 static GPIO_Byte_TypeDef* FIO_ByteGetPointer(uint8_t portNum)
 {
-    GPIO_Byte_TypeDef* pFIO = NULL;
-
-    switch (portNum)
-    {
-        case 0: pFIO = GPIO0_Byte; break;
-        case 1: pFIO = GPIO1_Byte; break;
-        case 2: pFIO = GPIO2_Byte; break;
-        case 3: pFIO = GPIO3_Byte; break;
-        case 4: pFIO = GPIO4_Byte; break;
-        default: break;
-    }
-
-    return pFIO;
+    return (PARAM_GPIO_PORT(portNum) ? (GPIO_Byte_TypeDef*)GPIO_PORT(portNum) : NULL);
 }
 
 /* End of Private Functions --------------------------------------------------- */
@@ -0,0 +1,598 @@
+/**********************************************************************
+ * $Id$		lpc17xx_heap.c				2010-05-21
+ *//**
+* @file		lpc17xx_heap.c
+* @brief	Contains all functions support for the bounded time TLSF memory allocator on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup HEAP
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_heap.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _HEAP
+
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup HEAP_Private_Macros HEAP Private Macros
+ * @{
+ */
+
+/** Flags in the low bits of HEAP_BLOCK_Type.Size */
+#define HEAP_BLOCK_FREE      ((uint32_t)(1 << 0))
+#define HEAP_BLOCK_PREV_FREE ((uint32_t)(1 << 1))
+#define HEAP_BLOCK_FLAGS     (HEAP_BLOCK_FREE | HEAP_BLOCK_PREV_FREE)
+
+/** Header bytes in front of each payload */
+#define HEAP_HDR ((uint32_t)sizeof(HEAP_BLOCK_Type))
+
+/** Smallest payload, room for the two free list links */
+#define HEAP_MIN_PAYLOAD ((uint32_t)((2 * sizeof(void*) + HEAP_ALIGN - 1) & ~(HEAP_ALIGN - 1)))
+
+/** Largest payload that still maps to a first level class */
+#define HEAP_MAX_PAYLOAD ((uint32_t)(1UL << HEAP_FL_MAX) - HEAP_ALIGN)
+
+/** Free list links, in the payload of a free block */
+#define HEAP_NEXT_FREE(b) (((HEAP_BLOCK_Type**)((b) + 1))[0])
+#define HEAP_PREV_FREE(b) (((HEAP_BLOCK_Type**)((b) + 1))[1])
+
+/**
+ * @}
+ */
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup HEAP_Private_Functions HEAP Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Index of the highest set bit
+                                                                         * @param[in]	x		Value, not 0
+                                                                         * @return		0 to 31
+                                                                         **********************************************************************/
+static uint32_t heap_fls(uint32_t x)
+{
+    return 31 - __CLZ(x);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Index of the lowest set bit
+                                                                         * @param[in]	x		Value, not 0
+                                                                         * @return		0 to 31
+                                                                         **********************************************************************/
+static uint32_t heap_ffs(uint32_t x)
+{
+    return 31 - __CLZ(x & (0 - x));
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the payload size of a block
+                                                                         * @param[in]	b		Block
+                                                                         * @return		Size in bytes
+                                                                         **********************************************************************/
+static uint32_t heap_size(const HEAP_BLOCK_Type* b)
+{
+    return b->Size & ~HEAP_BLOCK_FLAGS;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the block just above a block
+                                                                         * @param[in]	b		Block
+                                                                         * @return		Next block, the end sentinel after the last one
+                                                                         **********************************************************************/
+static HEAP_BLOCK_Type* heap_next(const HEAP_BLOCK_Type* b)
+{
+    return (HEAP_BLOCK_Type*)((uint8_t*)(b + 1) + heap_size(b));
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the list class of a size
+                                                                         * @param[in]	size	Payload size
+                                                                         * @param[out]	fl		First level index
+                                                                         * @param[out]	sl		Second level index
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void heap_mapping(uint32_t size, uint32_t* fl, uint32_t* sl)
+{
+    uint32_t f;
+
+    if (size < (1UL << HEAP_FL_SHIFT))
+    {
+        *fl = 0;
+        *sl = size / ((1UL << HEAP_FL_SHIFT) / HEAP_SL_COUNT);
+    }
+    else
+    {
+        f = heap_fls(size);
+        *sl = (size >> (f - HEAP_SL_LOG2)) ^ HEAP_SL_COUNT;
+        *fl = f - HEAP_FL_SHIFT + 1;
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Link a free block into the list of its class
+                                                                         * @param[in]	heap	Heap
+                                                                         * @param[in]	b		Block
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void heap_insert(HEAP_Type* heap, HEAP_BLOCK_Type* b)
+{
+    uint32_t fl, sl;
+    HEAP_BLOCK_Type* head;
+
+    heap_mapping(heap_size(b), &fl, &sl);
+    head = heap->Free[fl][sl];
+    HEAP_NEXT_FREE(b) = head;
+    HEAP_PREV_FREE(b) = NULL;
+    if (head != NULL)
+    {
+        HEAP_PREV_FREE(head) = b;
+    }
+    heap->Free[fl][sl] = b;
+    heap->FlBitmap |= 1UL << fl;
+    heap->SlBitmap[fl] |= 1UL << sl;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Unlink a free block from the list of its class
+                                                                         * @param[in]	heap	Heap
+                                                                         * @param[in]	b		Block
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void heap_remove(HEAP_Type* heap, HEAP_BLOCK_Type* b)
+{
+    uint32_t fl, sl;
+    HEAP_BLOCK_Type* next = HEAP_NEXT_FREE(b);
+    HEAP_BLOCK_Type* prev = HEAP_PREV_FREE(b);
+
+    heap_mapping(heap_size(b), &fl, &sl);
+    if (next != NULL)
+    {
+        HEAP_PREV_FREE(next) = prev;
+    }
+    if (prev != NULL)
+    {
+        HEAP_NEXT_FREE(prev) = next;
+    }
+    else
+    {
+        heap->Free[fl][sl] = next;
+        if (next == NULL)
+        {
+            heap->SlBitmap[fl] &= ~(1UL << sl);
+            if (heap->SlBitmap[fl] == 0)
+            {
+                heap->FlBitmap &= ~(1UL << fl);
+            }
+        }
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Take a free block of at least a size out of the lists. The
+                                                                         * size is rounded up to the next list boundary so that any block
+                                                                         * of the list found fits: good fit, no list walk
+                                                                         * @param[in]	heap	Heap
+                                                                         * @param[in]	size	Payload size, aligned
+                                                                         * @return		Block, NULL if none fits
+                                                                         **********************************************************************/
+static HEAP_BLOCK_Type* heap_take(HEAP_Type* heap, uint32_t size)
+{
+    uint32_t fl, sl, map;
+    HEAP_BLOCK_Type* b;
+
+    if (size >= (1UL << HEAP_FL_SHIFT))
+    {
+        size += (1UL << (heap_fls(size) - HEAP_SL_LOG2)) - 1;
+    }
+    heap_mapping(size, &fl, &sl);
+    if (fl >= HEAP_FL_COUNT)
+    {
+        return NULL;
+    }
+
+    map = heap->SlBitmap[fl] & (~0UL << sl);
+    if (map == 0)
+    {
+        map = (fl + 1 < 32) ? (heap->FlBitmap & (~0UL << (fl + 1))) : 0;
+        if (map == 0)
+        {
+            return NULL;
+        }
+        fl = heap_ffs(map);
+        map = heap->SlBitmap[fl];
+    }
+    sl = heap_ffs(map);
+
+    b = heap->Free[fl][sl];
+    heap_remove(heap, b);
+    return b;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Give the tail of a block beyond a size back to the free
+                                                                         * lists, merged with a free block above. Nothing happens if the
+                                                                         * tail is too small to hold a block
+                                                                         * @param[in]	heap	Heap
+                                                                         * @param[in]	b		Used block
+                                                                         * @param[in]	size	Payload size to keep, aligned
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void heap_trim(HEAP_Type* heap, HEAP_BLOCK_Type* b, uint32_t size)
+{
+    uint32_t total = heap_size(b);
+    HEAP_BLOCK_Type* rest;
+    HEAP_BLOCK_Type* next;
+
+    if (total < size + HEAP_HDR + HEAP_MIN_PAYLOAD)
+    {
+        return;
+    }
+
+    rest = (HEAP_BLOCK_Type*)((uint8_t*)(b + 1) + size);
+    rest->Size = (total - size - HEAP_HDR) | HEAP_BLOCK_FREE;
+    rest->PrevPhys = b;
+    b->Size = size | (b->Size & HEAP_BLOCK_FLAGS);
+    heap->Used -= total - size;
+
+    next = heap_next(rest);
+    if (next->Size & HEAP_BLOCK_FREE)
+    {
+        heap_remove(heap, next);
+        rest->Size += HEAP_HDR + heap_size(next);
+        next = heap_next(rest);
+    }
+    next->PrevPhys = rest;
+    next->Size |= HEAP_BLOCK_PREV_FREE;
+    heap_insert(heap, rest);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Round a request up to a payload size
+                                                                         * @param[in]	size	Requested bytes
+                                                                         * @return		Payload size, 0 if the request is too large
+                                                                         **********************************************************************/
+static uint32_t heap_adjust(uint32_t size)
+{
+    if (size > HEAP_MAX_PAYLOAD)
+    {
+        return 0;
+    }
+    size = (size + HEAP_ALIGN - 1) & ~(HEAP_ALIGN - 1);
+    return (size < HEAP_MIN_PAYLOAD) ? HEAP_MIN_PAYLOAD : size;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Allocate with interrupts already disabled
+                                                                         * @param[in]	heap	Heap
+                                                                         * @param[in]	size	Requested bytes
+                                                                         * @return		Payload, NULL if out of memory
+                                                                         **********************************************************************/
+static void* heap_alloc(HEAP_Type* heap, uint32_t size)
+{
+    uint32_t adjust = heap_adjust(size);
+    HEAP_BLOCK_Type* b = (adjust != 0) ? heap_take(heap, adjust) : NULL;
+
+    if (b == NULL)
+    {
+        heap->Failures++;
+        return NULL;
+    }
+
+    b->Size &= ~HEAP_BLOCK_FREE;
+    heap_next(b)->Size &= ~HEAP_BLOCK_PREV_FREE;
+    heap->Used += HEAP_HDR + heap_size(b);
+    heap->Allocs++;
+    heap_trim(heap, b, adjust);
+
+    if (heap->Used > heap->HighWater)
+    {
+        heap->HighWater = heap->Used;
+    }
+    return b + 1;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Free with interrupts already disabled, the block is merged
+                                                                         * with its free neighbours
+                                                                         * @param[in]	heap	Heap
+                                                                         * @param[in]	ptr		Payload, not NULL
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void heap_free(HEAP_Type* heap, void* ptr)
+{
+    HEAP_BLOCK_Type* b = (HEAP_BLOCK_Type*)ptr - 1;
+    HEAP_BLOCK_Type* next;
+    HEAP_BLOCK_Type* prev;
+
+    heap->Used -= HEAP_HDR + heap_size(b);
+    heap->Allocs--;
+    b->Size |= HEAP_BLOCK_FREE;
+
+    if (b->Size & HEAP_BLOCK_PREV_FREE)
+    {
+        prev = b->PrevPhys;
+        heap_remove(heap, prev);
+        prev->Size += HEAP_HDR + heap_size(b);
+        b = prev;
+    }
+    next = heap_next(b);
+    if (next->Size & HEAP_BLOCK_FREE)
+    {
+        heap_remove(heap, next);
+        b->Size += HEAP_HDR + heap_size(next);
+        next = heap_next(b);
+    }
+    next->PrevPhys = b;
+    next->Size |= HEAP_BLOCK_PREV_FREE;
+    heap_insert(heap, b);
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup HEAP_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Set up a heap on a memory pool, as one free block
+                                                                         * @param[in]	heap	Heap
+                                                                         * @param[in]	pool	Pool start, aligned up to HEAP_ALIGN
+                                                                         * @param[in]	size	Pool size in bytes. A pool larger than a
+                                                                         * block can be, 2^HEAP_FL_MAX bytes, is only used up to that
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void HEAP_Init(HEAP_Type* heap, void* pool, uint32_t size)
+{
+    uintptr_t start = ((uintptr_t)pool + HEAP_ALIGN - 1) & ~(uintptr_t)(HEAP_ALIGN - 1);
+    HEAP_BLOCK_Type* b;
+    HEAP_BLOCK_Type* end;
+    uint32_t fl, sl;
+
+    size -= (uint32_t)(start - (uintptr_t)pool);
+    size &= ~(HEAP_ALIGN - 1);
+    CHECK_PARAM(size >= 2 * HEAP_HDR + HEAP_MIN_PAYLOAD);
+
+    heap->FlBitmap = 0;
+    for (fl = 0; fl < HEAP_FL_COUNT; fl++)
+    {
+        heap->SlBitmap[fl] = 0;
+        for (sl = 0; sl < HEAP_SL_COUNT; sl++)
+        {
+            heap->Free[fl][sl] = NULL;
+        }
+    }
+    heap->Used = 0;
+    heap->HighWater = 0;
+    heap->Allocs = 0;
+    heap->Failures = 0;
+
+    /* One free block, then a used empty block that stops merging at the end */
+    size -= 2 * HEAP_HDR;
+    if (size > HEAP_MAX_PAYLOAD)
+    {
+        size = HEAP_MAX_PAYLOAD;
+    }
+    b = (HEAP_BLOCK_Type*)start;
+    b->PrevPhys = NULL;
+    b->Size = size | HEAP_BLOCK_FREE;
+    end = heap_next(b);
+    end->PrevPhys = b;
+    end->Size = HEAP_BLOCK_PREV_FREE;
+    heap->Size = size + 2 * HEAP_HDR;
+    heap_insert(heap, b);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Allocate a block, in constant time. Callable from interrupts,
+                                                                         * which are disabled for a bounded number of steps
+                                                                         * @param[in]	heap	Heap
+                                                                         * @param[in]	size	Requested bytes, 0 gives a minimum block
+                                                                         * @return		Payload aligned to HEAP_ALIGN, NULL if out of memory
+                                                                         **********************************************************************/
+void* HEAP_Alloc(HEAP_Type* heap, uint32_t size)
+{
+    uint32_t primask;
+    void* ptr;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    ptr = heap_alloc(heap, size);
+    __set_PRIMASK(primask);
+    return ptr;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Free a block, in constant time. Callable from interrupts
+                                                                         * @param[in]	heap	Heap
+                                                                         * @param[in]	ptr		Payload from HEAP_Alloc() or HEAP_Realloc(),
+                                                                         * NULL is ignored
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void HEAP_Free(HEAP_Type* heap, void* ptr)
+{
+    uint32_t primask;
+
+    if (ptr == NULL)
+    {
+        return;
+    }
+    primask = __get_PRIMASK();
+    __disable_irq();
+    heap_free(heap, ptr);
+    __set_PRIMASK(primask);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Resize a block. It shrinks or grows in place when the block
+                                                                         * above is free, otherwise the data moves to a new block
+                                                                         * @param[in]	heap	Heap
+                                                                         * @param[in]	ptr		Payload, NULL allocates
+                                                                         * @param[in]	size	New size in bytes, 0 frees
+                                                                         * @return		Payload, NULL if out of memory: the old block is kept
+                                                                         * @note		Only a move copies, with interrupts enabled
+                                                                         **********************************************************************/
+void* HEAP_Realloc(HEAP_Type* heap, void* ptr, uint32_t size)
+{
+    HEAP_BLOCK_Type* b = (HEAP_BLOCK_Type*)ptr - 1;
+    HEAP_BLOCK_Type* next;
+    uint32_t adjust, have, primask, i;
+    uint8_t* moved;
+
+    if (ptr == NULL)
+    {
+        return HEAP_Alloc(heap, size);
+    }
+    if (size == 0)
+    {
+        HEAP_Free(heap, ptr);
+        return NULL;
+    }
+    adjust = heap_adjust(size);
+    if (adjust == 0)
+    {
+        return NULL;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    have = heap_size(b);
+    next = heap_next(b);
+    if ((adjust > have) && (next->Size & HEAP_BLOCK_FREE) && (have + HEAP_HDR + heap_size(next) >= adjust))
+    {
+        /* Take the free block above */
+        heap_remove(heap, next);
+        b->Size += HEAP_HDR + heap_size(next);
+        heap_next(b)->Size &= ~HEAP_BLOCK_PREV_FREE;
+        heap->Used += HEAP_HDR + heap_size(next);
+        have = heap_size(b);
+    }
+    if (adjust <= have)
+    {
+        heap_trim(heap, b, adjust);
+        if (heap->Used > heap->HighWater)
+        {
+            heap->HighWater = heap->Used;
+        }
+        __set_PRIMASK(primask);
+        return ptr;
+    }
+    __set_PRIMASK(primask);
+
+    moved = (uint8_t*)HEAP_Alloc(heap, size);
+    if (moved != NULL)
+    {
+        for (i = 0; i < have; i++)
+        {
+            moved[i] = ((uint8_t*)ptr)[i];
+        }
+        HEAP_Free(heap, ptr);
+    }
+    return moved;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the usable size of a block, at least what was requested
+                                                                         * @param[in]	ptr		Payload, not NULL
+                                                                         * @return		Size in bytes
+                                                                         **********************************************************************/
+uint32_t HEAP_GetBlockSize(const void* ptr)
+{
+    return heap_size((const HEAP_BLOCK_Type*)ptr - 1);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the heap statistics. Walks the free lists with interrupts
+                                                                         * disabled, keep it out of time critical paths
+                                                                         * @param[in]	heap	Heap
+                                                                         * @param[out]	stats	Statistics
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void HEAP_GetStats(HEAP_Type* heap, HEAP_STATS_Type* stats)
+{
+    uint32_t primask, fl, sl, size;
+    HEAP_BLOCK_Type* b;
+
+    stats->Free = 0;
+    stats->LargestFree = 0;
+    stats->FreeBlocks = 0;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    stats->Size = heap->Size;
+    stats->Used = heap->Used;
+    stats->HighWater = heap->HighWater;
+    stats->Allocs = heap->Allocs;
+    stats->Failures = heap->Failures;
+    for (fl = 0; fl < HEAP_FL_COUNT; fl++)
+    {
+        for (sl = 0; sl < HEAP_SL_COUNT; sl++)
+        {
+            for (b = heap->Free[fl][sl]; b != NULL; b = HEAP_NEXT_FREE(b))
+            {
+                size = heap_size(b);
+                stats->Free += size;
+                stats->FreeBlocks++;
+                if (size > stats->LargestFree)
+                {
+                    stats->LargestFree = size;
+                }
+            }
+        }
+    }
+    __set_PRIMASK(primask);
+
+    stats->Fragmentation =
+        (stats->Free != 0) ? (uint8_t)(100 - (uint32_t)(((uint64_t)stats->LargestFree * 100) / stats->Free)) : 0;
+}
+
+/**
+ * @}
+ */
+
+#endif /* _HEAP */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
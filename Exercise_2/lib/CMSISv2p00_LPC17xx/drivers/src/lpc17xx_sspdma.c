@@ -0,0 +1,376 @@
+/**********************************************************************
+ * $Id$		lpc17xx_sspdma.c				2010-05-21
+ *//**
+* @file		lpc17xx_sspdma.c
+* @brief	Contains all functions support for the GPDMA driven SSP transaction queue on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup SSPDMA
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_sspdma.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _SSPDMA
+
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup SSPDMA_Private_Macros SSPDMA Private Macros
+ * @{
+ */
+
+/** GPDMA channel registers of channel n */
+#define SSPDMA_DMACH(n) ((LPC_GPDMACH_TypeDef*)(LPC_GPDMACH0_BASE + ((uint32_t)(n) << 5)))
+
+/**
+ * @}
+ */
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup SSPDMA_Private_Functions SSPDMA Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Move the chip select to a device, releasing the one asserted
+                                                                         * @param[in]	ssp		GPDMA driven SSP
+                                                                         * @param[in]	cs		Device, SSPDMA_NO_CS releases only
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void sspdma_select(SSPDMA_Type* ssp, uint8_t cs)
+{
+    if ((ssp->Cfg.ChipSelect == NULL) || (ssp->CsActive == cs))
+    {
+        return;
+    }
+    if (ssp->CsActive != SSPDMA_NO_CS)
+    {
+        ssp->Cfg.ChipSelect(ssp->CsActive, DISABLE);
+    }
+    ssp->CsActive = cs;
+    if (cs != SSPDMA_NO_CS)
+    {
+        ssp->Cfg.ChipSelect(cs, ENABLE);
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Give the next piece of the head transfer to both channels.
+                                                                         * Receive only interrupts at its terminal count: the last frame
+                                                                         * has then crossed the bus in both directions
+                                                                         * @param[in]	ssp		GPDMA driven SSP
+                                                                         * @param[in]	xfer	Head transfer, frames left
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void sspdma_piece(SSPDMA_Type* ssp, const SSPDMA_XFER_Type* xfer)
+{
+    GPDMA_Channel_CFG_Type dma_cfg;
+    uint32_t size = xfer->Length - ssp->Offset;
+
+    if (size > GPDMA_LLI_MAX_TRANSFER)
+    {
+        size = GPDMA_LLI_MAX_TRANSFER;
+    }
+
+    dma_cfg.TransferSize = size;
+    dma_cfg.TransferWidth = 0;
+    dma_cfg.DMALLI = 0;
+
+    /* Receive, into one byte for a write only transfer */
+    dma_cfg.ChannelNum = ssp->Cfg.RxChannel;
+    dma_cfg.TransferType = GPDMA_TRANSFERTYPE_P2M;
+    dma_cfg.SrcConn = ssp->RxConn;
+    dma_cfg.DstConn = 0;
+    dma_cfg.SrcMemAddr = 0;
+    dma_cfg.DstMemAddr = (xfer->RxData != NULL) ? ADDR32(xfer->RxData + ssp->Offset) : ADDR32(&ssp->Sink);
+    GPDMA_Setup(&dma_cfg);
+    if (xfer->RxData == NULL)
+    {
+        SSPDMA_DMACH(ssp->Cfg.RxChannel)->DMACCControl &= ~GPDMA_DMACCxControl_DI;
+    }
+
+    /* Transmit, the dummy byte over and over for a read only transfer */
+    dma_cfg.ChannelNum = ssp->Cfg.TxChannel;
+    dma_cfg.TransferType = GPDMA_TRANSFERTYPE_M2P;
+    dma_cfg.SrcConn = 0;
+    dma_cfg.DstConn = ssp->TxConn;
+    dma_cfg.SrcMemAddr = (xfer->TxData != NULL) ? ADDR32(xfer->TxData + ssp->Offset) : ADDR32(&ssp->Cfg.Dummy);
+    dma_cfg.DstMemAddr = 0;
+    GPDMA_Setup(&dma_cfg);
+    if (xfer->TxData == NULL)
+    {
+        SSPDMA_DMACH(ssp->Cfg.TxChannel)->DMACCControl &= ~GPDMA_DMACCxControl_SI;
+    }
+    SSPDMA_DMACH(ssp->Cfg.TxChannel)->DMACCConfig &= ~GPDMA_DMACCxConfig_ITC;
+
+    ssp->Offset += size;
+    GPDMA_ChannelCmd(ssp->Cfg.RxChannel, ENABLE);
+    GPDMA_ChannelCmd(ssp->Cfg.TxChannel, ENABLE);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Start the next piece of the queue, completing the transfers
+                                                                         * that are done. Runs with the DMA interrupt unable to preempt it
+                                                                         * @param[in]	ssp		GPDMA driven SSP
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void sspdma_next(SSPDMA_Type* ssp)
+{
+    SSPDMA_XFER_Type* xfer;
+
+    while ((xfer = ssp->Head) != NULL)
+    {
+        if (ssp->Offset < xfer->Length)
+        {
+            if (ssp->Offset == 0)
+            {
+                sspdma_select(ssp, xfer->ChipSelect);
+            }
+            sspdma_piece(ssp, xfer);
+            return;
+        }
+
+        /* Unlink before the callback, which may queue the descriptor again */
+        ssp->Head = xfer->Next;
+        if (ssp->Head == NULL)
+        {
+            ssp->Tail = NULL;
+        }
+        ssp->Depth--;
+        ssp->Offset = 0;
+        ssp->Transfers++;
+        ssp->Bytes += xfer->Length;
+        if (!(xfer->Flags & SSPDMA_KEEP_CS))
+        {
+            sspdma_select(ssp, SSPDMA_NO_CS);
+        }
+        if (xfer->Callback != NULL)
+        {
+            xfer->Callback(xfer);
+        }
+    }
+    ssp->Busy = 0;
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup SSPDMA_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Switch an SSP to GPDMA operation with an empty transfer queue
+                                                                         * @param[in]	ssp		GPDMA driven SSP
+                                                                         * @param[in]	SSPx	SSP peripheral, should be:
+                                                                         * - LPC_SSP0: SSP0 peripheral
+                                                                         * - LPC_SSP1: SSP1 peripheral
+                                                                         * @param[in]	cfg		Configuration, copied
+                                                                         * @return		None
+                                                                         * @note		SSP_Init() and GPDMA_Init() must have been called, the pins set
+                                                                         * and the SSP enabled in master mode with frames of 8 bits or less.
+                                                                         * Call SSPDMA_IntHandler() from DMA_IRQHandler. The SSP interrupt is
+                                                                         * not used
+                                                                         **********************************************************************/
+void SSPDMA_Init(SSPDMA_Type* ssp, LPC_SSP_TypeDef* SSPx, const SSPDMA_CFG_Type* cfg)
+{
+    CHECK_PARAM(PARAM_SSPx(SSPx));
+    CHECK_PARAM(PARAM_SSPDMA_CHANNELS(cfg->TxChannel, cfg->RxChannel));
+
+    ssp->SSPx = SSPx;
+    ssp->Cfg = *cfg;
+    ssp->TxConn = (SSPx == LPC_SSP0) ? GPDMA_CONN_SSP0_Tx : GPDMA_CONN_SSP1_Tx;
+    ssp->RxConn = ssp->TxConn + 1;
+    ssp->CsActive = SSPDMA_NO_CS;
+    ssp->Head = NULL;
+    ssp->Tail = NULL;
+    ssp->Offset = 0;
+    ssp->Busy = 0;
+    ssp->Depth = 0;
+    ssp->MaxDepth = 0;
+    ssp->Transfers = 0;
+    ssp->Bytes = 0;
+    ssp->Errors = 0;
+
+    /* A frame left in the receive FIFO would shift every transfer by one */
+    while (SSPx->SR & SSP_SR_RNE)
+    {
+        (void)SSPx->DR;
+    }
+    SSP_DMACmd(SSPx, SSP_DMA_RX, ENABLE);
+    SSP_DMACmd(SSPx, SSP_DMA_TX, ENABLE);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Stop both DMA channels and leave DMA mode. Queued transfers
+                                                                         * are dropped without their callbacks, the chip select is released
+                                                                         * @param[in]	ssp		GPDMA driven SSP
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void SSPDMA_DeInit(SSPDMA_Type* ssp)
+{
+    GPDMA_ChannelCmd(ssp->Cfg.TxChannel, DISABLE);
+    GPDMA_ChannelCmd(ssp->Cfg.RxChannel, DISABLE);
+    LPC_GPDMA->DMACIntTCClear =
+        GPDMA_DMACIntTCClear_Ch(ssp->Cfg.TxChannel) | GPDMA_DMACIntTCClear_Ch(ssp->Cfg.RxChannel);
+    SSP_DMACmd(ssp->SSPx, SSP_DMA_TX, DISABLE);
+    SSP_DMACmd(ssp->SSPx, SSP_DMA_RX, DISABLE);
+    sspdma_select(ssp, SSPDMA_NO_CS);
+    ssp->Head = NULL;
+    ssp->Tail = NULL;
+    ssp->Offset = 0;
+    ssp->Depth = 0;
+    ssp->Busy = 0;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Queue a transfer, without copying or waiting. Transfers run
+                                                                         * back to back in the order they were queued, the next one is
+                                                                         * started from the interrupt that completes the previous one
+                                                                         * @param[in]	ssp		GPDMA driven SSP
+                                                                         * @param[in]	xfer	Descriptor, with the buffers, Length, ChipSelect,
+                                                                         * Flags and Callback set. It must not be queued already
+                                                                         * @return		None
+                                                                         * @note		Can be called from any context, including a completion callback
+                                                                         **********************************************************************/
+void SSPDMA_Submit(SSPDMA_Type* ssp, SSPDMA_XFER_Type* xfer)
+{
+    uint32_t primask;
+
+    xfer->Next = NULL;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (ssp->Tail != NULL)
+    {
+        ssp->Tail->Next = xfer;
+    }
+    else
+    {
+        ssp->Head = xfer;
+    }
+    ssp->Tail = xfer;
+    if (++ssp->Depth > ssp->MaxDepth)
+    {
+        ssp->MaxDepth = ssp->Depth;
+    }
+
+    /* Idle channels raise no terminal count, start here */
+    if (!ssp->Busy)
+    {
+        ssp->Busy = 1;
+        sspdma_next(ssp);
+    }
+    __set_PRIMASK(primask);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Tell whether the transfer queue is empty
+                                                                         * @param[in]	ssp		GPDMA driven SSP
+                                                                         * @return		TRUE when every transfer is complete
+                                                                         **********************************************************************/
+Bool SSPDMA_IsIdle(const SSPDMA_Type* ssp)
+{
+    return ssp->Busy ? FALSE : TRUE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the transfer statistics
+                                                                         * @param[in]	ssp		GPDMA driven SSP
+                                                                         * @param[out]	stats	Statistics since SSPDMA_Init()
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void SSPDMA_GetStats(const SSPDMA_Type* ssp, SSPDMA_STATS_Type* stats)
+{
+    stats->Transfers = ssp->Transfers;
+    stats->Bytes = ssp->Bytes;
+    stats->MaxDepth = ssp->MaxDepth;
+    stats->Errors = ssp->Errors;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Serve the receive channel of the SSP, call from DMA_IRQHandler.
+                                                                         * Completes the transfer on the bus and starts the next one
+                                                                         * @param[in]	ssp		GPDMA driven SSP
+                                                                         * @return		TRUE if the interrupt was for this SSP
+                                                                         **********************************************************************/
+Bool SSPDMA_IntHandler(SSPDMA_Type* ssp)
+{
+    uint32_t tx_ch = GPDMA_DMACIntTCStat_Ch(ssp->Cfg.TxChannel);
+    uint32_t rx_ch = GPDMA_DMACIntTCStat_Ch(ssp->Cfg.RxChannel);
+
+    if (LPC_GPDMA->DMACIntErrStat & (tx_ch | rx_ch))
+    {
+        LPC_GPDMA->DMACIntErrClr = LPC_GPDMA->DMACIntErrStat & (tx_ch | rx_ch);
+        ssp->Errors++;
+
+        /* A bus error stops its channel: stop the other one too and give up
+         * the rest of the transfer */
+        GPDMA_ChannelCmd(ssp->Cfg.TxChannel, DISABLE);
+        GPDMA_ChannelCmd(ssp->Cfg.RxChannel, DISABLE);
+        LPC_GPDMA->DMACIntTCClear = rx_ch;
+        if (ssp->Busy)
+        {
+            ssp->Offset = ssp->Head->Length;
+            sspdma_next(ssp);
+        }
+        return TRUE;
+    }
+
+    if (LPC_GPDMA->DMACIntTCStat & rx_ch)
+    {
+        LPC_GPDMA->DMACIntTCClear = rx_ch;
+        sspdma_next(ssp);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/**
+ * @}
+ */
+
+#endif /* _SSPDMA */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
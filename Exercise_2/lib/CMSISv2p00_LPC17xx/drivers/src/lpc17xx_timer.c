@@ -66,7 +66,7 @@ static uint32_t converPtrToTimeNum(LPC_TIM_TypeDef* TIMx);
                                                                          **********************************************************************/
 static uint32_t getPClock(uint32_t timernum)
 {
-    uint32_t clkdlycnt;
+    uint32_t clkdlycnt = 0;
     switch (timernum)
     {
         case 0: clkdlycnt = CLKPWR_GetPCLK(CLKPWR_PCLKSEL_TIMER0); break;
@@ -365,8 +365,8 @@ void TIM_Init(LPC_TIM_TypeDef* TIMx, TIM_MODE_OPT TimerCounterMode, void* TIM_Co
         CLKPWR_SetPCLKDiv(CLKPWR_PCLKSEL_TIMER3, CLKPWR_PCLKSEL_CCLK_DIV_4);
     }
 
-    TIMx->CCR &= ~TIM_CTCR_MODE_MASK;
-    TIMx->CCR |= TIM_TIMER_MODE;
+    TIMx->CTCR &= ~TIM_CTCR_MODE_MASK;
+    TIMx->CTCR |= TimerCounterMode;
 
     TIMx->TC = 0;
     TIMx->PC = 0;
@@ -389,9 +389,9 @@ void TIM_Init(LPC_TIM_TypeDef* TIMx, TIM_MODE_OPT TimerCounterMode, void* TIM_Co
     {
 
         pCounterCfg = (TIM_COUNTERCFG_Type*)TIM_ConfigStruct;
-        TIMx->CCR &= ~TIM_CTCR_INPUT_MASK;
+        TIMx->CTCR &= ~TIM_CTCR_INPUT_MASK;
         if (pCounterCfg->CountInputSelect == TIM_COUNTER_INCAP1)
-            TIMx->CCR |= _BIT(2);
+            TIMx->CTCR |= _BIT(2);
     }
 
     // Clear interrupt pending
@@ -124,7 +124,8 @@ static Status uart_set_divisors(LPC_UART_TypeDef* UARTx, uint32_t baudrate)
                 tmp++;
             }
 
-            if (tmp < 1 || tmp > 65536) /* Out of range */
+            /* Out of range, the fractional divider also needs DLM:DLL > 2 */
+            if (tmp < 1 || tmp > 65536 || (d != 0 && tmp < 3))
                 continue;
 
             if (current_error < best_error)
@@ -542,7 +543,7 @@ uint32_t UART_Send(LPC_UART_TypeDef* UARTx, uint8_t* txbuf, uint32_t buflen, TRA
         {
             timeOut = UART_BLOCKING_TIMEOUT;
             // Wait for THR empty with timeout
-            while (!(UARTx->LSR & UART_LSR_THRE))
+            while (!(HWREG_READ(UARTx->LSR) & UART_LSR_THRE))
             {
                 if (timeOut == 0)
                     break;
@@ -615,7 +616,7 @@ uint32_t UART_Receive(LPC_UART_TypeDef* UARTx, uint8_t* rxbuf, uint32_t buflen,
         while (bToRecv)
         {
             timeOut = UART_BLOCKING_TIMEOUT;
-            while (!(UARTx->LSR & UART_LSR_RDR))
+            while (!(HWREG_READ(UARTx->LSR) & UART_LSR_RDR))
             {
                 if (timeOut == 0)
                     break;
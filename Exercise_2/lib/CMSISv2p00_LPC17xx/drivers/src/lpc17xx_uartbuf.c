@@ -0,0 +1,408 @@
+/**********************************************************************
+ * $Id$		lpc17xx_uartbuf.c				2010-05-21
+ *//**
+* @file		lpc17xx_uartbuf.c
+* @brief	Contains all functions support for the interrupt driven ring buffered UART on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup UARTBUF
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include <string.h>
+#include "lpc17xx_uartbuf.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _UARTBUF
+
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup UARTBUF_Private_Macros UARTBUF Private Macros
+ * @{
+ */
+
+/** Receive FIFO level field of FIFOLVL */
+#define UARTBUF_FIFOLVL_RX(n) ((n) & 0x0F)
+
+/** Line status bits counted as errors */
+#define UARTBUF_LSR_ERRORS (UART_LSR_OE | UART_LSR_PE | UART_LSR_FE | UART_LSR_BI)
+
+/**
+ * @}
+ */
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup UARTBUF_Private_Functions UARTBUF Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Reset a ring over its storage
+                                                                         * @param[in]	ring	Ring
+                                                                         * @param[in]	data	Storage
+                                                                         * @param[in]	size	Storage size, a power of two
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void uartbuf_ring_init(UARTBUF_RING_Type* ring, uint8_t* data, uint32_t size)
+{
+    ring->Data = data;
+    ring->Mask = size - 1;
+    ring->Head = 0;
+    ring->Tail = 0;
+    ring->HighWater = 0;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Producer side: copy bytes into a ring, as many as fit
+                                                                         * @param[in]	ring	Ring
+                                                                         * @param[in]	data	Bytes
+                                                                         * @param[in]	len		Number of bytes
+                                                                         * @return		Number of bytes copied
+                                                                         **********************************************************************/
+static uint32_t uartbuf_ring_put(UARTBUF_RING_Type* ring, const uint8_t* data, uint32_t len)
+{
+    uint32_t head = ring->Head;
+    uint32_t used = head - ring->Tail;
+    uint32_t index = head & ring->Mask;
+    uint32_t first;
+
+    if (len > ring->Mask + 1 - used)
+    {
+        len = ring->Mask + 1 - used;
+    }
+    first = ring->Mask + 1 - index;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(&ring->Data[index], data, first);
+    memcpy(ring->Data, data + first, len - first);
+
+    /* The bytes must be in place before the consumer can see them */
+    __DMB();
+    ring->Head = head + len;
+
+    if (used + len > ring->HighWater)
+    {
+        ring->HighWater = used + len;
+    }
+    return len;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Consumer side: copy bytes out of a ring, as many as it holds
+                                                                         * @param[in]	ring	Ring
+                                                                         * @param[in]	data	Destination
+                                                                         * @param[in]	len		Room in the destination
+                                                                         * @return		Number of bytes copied
+                                                                         **********************************************************************/
+static uint32_t uartbuf_ring_get(UARTBUF_RING_Type* ring, uint8_t* data, uint32_t len)
+{
+    uint32_t tail = ring->Tail;
+    uint32_t used = ring->Head - tail;
+    uint32_t index = tail & ring->Mask;
+    uint32_t first;
+
+    /* Read the bytes only after the head that covers them */
+    __DMB();
+    if (len > used)
+    {
+        len = used;
+    }
+    first = ring->Mask + 1 - index;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(data, &ring->Data[index], first);
+    memcpy(data + first, ring->Data, len - first);
+
+    __DMB();
+    ring->Tail = tail + len;
+    return len;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Refill the empty transmit FIFO from the transmit ring
+                                                                         * @param[in]	ub		Ring buffered UART
+                                                                         * @return		Number of bytes written to the FIFO
+                                                                         **********************************************************************/
+static uint32_t uartbuf_tx_fill(UARTBUF_Type* ub)
+{
+    UARTBUF_RING_Type* ring = &ub->Tx;
+    uint32_t tail = ring->Tail;
+    uint32_t count = ring->Head - tail;
+    uint32_t i;
+
+    __DMB();
+    if (count > UART_TX_FIFO_SIZE)
+    {
+        count = UART_TX_FIFO_SIZE;
+    }
+    for (i = 0; i < count; i++)
+    {
+        ub->UARTx->THR = ring->Data[(tail + i) & ring->Mask];
+    }
+    __DMB();
+    ring->Tail = tail + count;
+    return count;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Empty the receive FIFO into the receive ring
+                                                                         * @param[in]	ub		Ring buffered UART
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void uartbuf_rx_drain(UARTBUF_Type* ub)
+{
+    UARTBUF_RING_Type* ring = &ub->Rx;
+    uint32_t head = ring->Head;
+    uint32_t used = head - ring->Tail;
+    uint32_t level;
+
+    /* FIFOLVL saves one line status read per byte */
+    while ((level = UARTBUF_FIFOLVL_RX(ub->UARTx->FIFOLVL)) != 0)
+    {
+        while (level--)
+        {
+            if (used <= ring->Mask)
+            {
+                ring->Data[head & ring->Mask] = (uint8_t)ub->UARTx->RBR;
+                head++;
+                used++;
+            }
+            else
+            {
+                (void)ub->UARTx->RBR; // keep the interrupt from firing again
+                ub->Dropped++;
+            }
+        }
+    }
+
+    __DMB();
+    ring->Head = head;
+    if (used > ring->HighWater)
+    {
+        ring->HighWater = used;
+    }
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup UARTBUF_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Switch a UART to interrupt driven operation over two rings:
+                                                                         * FIFOs on with the receive trigger at 8 characters, receive,
+                                                                         * line status and THRE interrupts on
+                                                                         * @param[in]	ub		Ring buffered UART
+                                                                         * @param[in]	UARTx	UART peripheral, should be:
+                                                                         * - LPC_UART0: UART0 peripheral
+                                                                         * - LPC_UART1: UART1 peripheral
+                                                                         * - LPC_UART2: UART2 peripheral
+                                                                         * - LPC_UART3: UART3 peripheral
+                                                                         * @param[in]	cfg		Ring storage
+                                                                         * @return		None
+                                                                         * @note		UART_Init() must have been called and the pins set. Enable
+                                                                         * the UART interrupt in the NVIC and call UARTBUF_IntHandler()
+                                                                         * from it. 921600 baud needs PCLK_UARTn = CCLK
+                                                                         **********************************************************************/
+void UARTBUF_Init(UARTBUF_Type* ub, LPC_UART_TypeDef* UARTx, const UARTBUF_CFG_Type* cfg)
+{
+    UART_FIFO_CFG_Type fifo_cfg;
+
+    CHECK_PARAM(PARAM_UARTx(UARTx));
+    CHECK_PARAM(PARAM_UARTBUF_SIZE(cfg->TxSize));
+    CHECK_PARAM(PARAM_UARTBUF_SIZE(cfg->RxSize));
+
+    ub->UARTx = UARTx;
+    uartbuf_ring_init(&ub->Tx, cfg->TxBuffer, cfg->TxSize);
+    uartbuf_ring_init(&ub->Rx, cfg->RxBuffer, cfg->RxSize);
+    ub->TxBusy = 0;
+    ub->Dropped = 0;
+    ub->Errors = 0;
+
+    /* 8 characters leave 8 character times to serve the interrupt */
+    fifo_cfg.FIFO_ResetRxBuf = ENABLE;
+    fifo_cfg.FIFO_ResetTxBuf = ENABLE;
+    fifo_cfg.FIFO_DMAMode = DISABLE;
+    fifo_cfg.FIFO_Level = UART_FIFO_TRGLEV2;
+    UART_FIFOConfig(UARTx, &fifo_cfg);
+
+    UART_TxCmd(UARTx, ENABLE);
+    UART_IntConfig(UARTx, UART_INTCFG_RBR, ENABLE);
+    UART_IntConfig(UARTx, UART_INTCFG_RLS, ENABLE);
+    UART_IntConfig(UARTx, UART_INTCFG_THRE, ENABLE);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Disable the interrupts of a ring buffered UART, bytes still in
+                                                                         * the rings are dropped
+                                                                         * @param[in]	ub		Ring buffered UART
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void UARTBUF_DeInit(UARTBUF_Type* ub)
+{
+    UART_IntConfig(ub->UARTx, UART_INTCFG_RBR, DISABLE);
+    UART_IntConfig(ub->UARTx, UART_INTCFG_RLS, DISABLE);
+    UART_IntConfig(ub->UARTx, UART_INTCFG_THRE, DISABLE);
+    ub->TxBusy = 0;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Queue bytes for transmission, without waiting
+                                                                         * @param[in]	ub		Ring buffered UART
+                                                                         * @param[in]	data	Bytes to send
+                                                                         * @param[in]	len		Number of bytes
+                                                                         * @return		Number of bytes queued, less than len when the transmit ring
+                                                                         * is full
+                                                                         * @note		Call from one execution context only
+                                                                         **********************************************************************/
+uint32_t UARTBUF_Write(UARTBUF_Type* ub, const uint8_t* data, uint32_t len)
+{
+    len = uartbuf_ring_put(&ub->Tx, data, len);
+
+    /* An idle transmitter raises no THRE interrupt, prime its FIFO. THRE is
+     * masked meanwhile so the interrupt cannot refill it at the same time */
+    ub->UARTx->IER &= ~UART_IER_THREINT_EN;
+    if (!ub->TxBusy && uartbuf_tx_fill(ub))
+    {
+        ub->TxBusy = 1;
+    }
+    ub->UARTx->IER |= UART_IER_THREINT_EN;
+    return len;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Take received bytes, without waiting
+                                                                         * @param[in]	ub		Ring buffered UART
+                                                                         * @param[out]	data	Destination
+                                                                         * @param[in]	len		Room in the destination
+                                                                         * @return		Number of bytes read, 0 if nothing was received
+                                                                         * @note		Call from one execution context only
+                                                                         **********************************************************************/
+uint32_t UARTBUF_Read(UARTBUF_Type* ub, uint8_t* data, uint32_t len)
+{
+    return uartbuf_ring_get(&ub->Rx, data, len);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the room left in the transmit ring
+                                                                         * @param[in]	ub		Ring buffered UART
+                                                                         * @return		Bytes that UARTBUF_Write() can take now
+                                                                         **********************************************************************/
+uint32_t UARTBUF_GetTxFree(const UARTBUF_Type* ub)
+{
+    return ub->Tx.Mask + 1 - (ub->Tx.Head - ub->Tx.Tail);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the number of bytes waiting in the receive ring
+                                                                         * @param[in]	ub		Ring buffered UART
+                                                                         * @return		Bytes that UARTBUF_Read() can return now
+                                                                         **********************************************************************/
+uint32_t UARTBUF_GetRxCount(const UARTBUF_Type* ub)
+{
+    return ub->Rx.Head - ub->Rx.Tail;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the high-water marks and error counters
+                                                                         * @param[in]	ub		Ring buffered UART
+                                                                         * @param[out]	stats	Statistics
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void UARTBUF_GetStats(const UARTBUF_Type* ub, UARTBUF_STATS_Type* stats)
+{
+    stats->TxHighWater = ub->Tx.HighWater;
+    stats->RxHighWater = ub->Rx.HighWater;
+    stats->Dropped = ub->Dropped;
+    stats->Errors = ub->Errors;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Serve the UART interrupt, call from UARTn_IRQHandler. Moves
+                                                                         * received bytes to the receive ring and refills the transmit
+                                                                         * FIFO, 16 bytes per interrupt
+                                                                         * @param[in]	ub		Ring buffered UART
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void UARTBUF_IntHandler(UARTBUF_Type* ub)
+{
+    uint32_t iir;
+
+    while (!((iir = ub->UARTx->IIR) & UART_IIR_INTSTAT_PEND))
+    {
+        switch (iir & UART_IIR_INTID_MASK)
+        {
+            case UART_IIR_INTID_RLS:
+                // Reading LSR clears the source, the bad byte stays in the FIFO
+                if (ub->UARTx->LSR & UARTBUF_LSR_ERRORS)
+                {
+                    ub->Errors++;
+                }
+                uartbuf_rx_drain(ub);
+                break;
+            case UART_IIR_INTID_RDA:
+            case UART_IIR_INTID_CTI: uartbuf_rx_drain(ub); break;
+            case UART_IIR_INTID_THRE:
+                if (uartbuf_tx_fill(ub) == 0)
+                {
+                    ub->TxBusy = 0;
+                }
+                break;
+            default: return;
+        }
+    }
+}
+
+/**
+ * @}
+ */
+
+#endif /* _UARTBUF */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
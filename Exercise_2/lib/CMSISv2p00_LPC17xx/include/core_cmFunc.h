@@ -297,6 +297,130 @@ static __INLINE void __set_FPSCR(uint32_t fpscr)
 
 #include <cmsis_iar.h>
 
+#elif defined ( __USE_HOST_SIM ) /*------------------ Host Simulator -------------------*/
+/* Host simulator functions (see sim_LPC17xx.h). Core special registers are
+   kept by the simulator so masking takes effect on the simulated NVIC. */
+
+typedef struct
+{
+  uint32_t PRIMASK;
+  uint32_t FAULTMASK;
+  uint32_t BASEPRI;
+  uint32_t CONTROL;
+  uint32_t IPSR;
+  uint32_t APSR;
+  uint32_t MSP;
+  uint32_t PSP;
+} SIM_CoreReg_Type;
+
+extern volatile SIM_CoreReg_Type SIM_CoreReg;
+extern void SIM_ServiceIRQ(void);
+
+static __INLINE void __enable_irq(void)
+{
+  SIM_CoreReg.PRIMASK = 0;
+  SIM_ServiceIRQ();
+}
+
+static __INLINE void __disable_irq(void)
+{
+  SIM_CoreReg.PRIMASK = 1;
+}
+
+static __INLINE uint32_t __get_CONTROL(void)
+{
+  return(SIM_CoreReg.CONTROL);
+}
+
+static __INLINE void __set_CONTROL(uint32_t control)
+{
+  SIM_CoreReg.CONTROL = control;
+}
+
+static __INLINE uint32_t __get_IPSR(void)
+{
+  return(SIM_CoreReg.IPSR);
+}
+
+static __INLINE uint32_t __get_APSR(void)
+{
+  return(SIM_CoreReg.APSR);
+}
+
+static __INLINE uint32_t __get_xPSR(void)
+{
+  return(SIM_CoreReg.APSR | SIM_CoreReg.IPSR);
+}
+
+static __INLINE uint32_t __get_PSP(void)
+{
+  return(SIM_CoreReg.PSP);
+}
+
+static __INLINE void __set_PSP(uint32_t topOfProcStack)
+{
+  SIM_CoreReg.PSP = topOfProcStack;
+}
+
+static __INLINE uint32_t __get_MSP(void)
+{
+  return(SIM_CoreReg.MSP);
+}
+
+static __INLINE void __set_MSP(uint32_t topOfMainStack)
+{
+  SIM_CoreReg.MSP = topOfMainStack;
+}
+
+static __INLINE uint32_t __get_PRIMASK(void)
+{
+  return(SIM_CoreReg.PRIMASK);
+}
+
+static __INLINE void __set_PRIMASK(uint32_t priMask)
+{
+  SIM_CoreReg.PRIMASK = priMask & 1;
+  if (SIM_CoreReg.PRIMASK == 0) SIM_ServiceIRQ();
+}
+
+#if       (__CORTEX_M >= 0x03)
+
+static __INLINE void __enable_fault_irq(void)
+{
+  SIM_CoreReg.FAULTMASK = 0;
+  SIM_ServiceIRQ();
+}
+
+static __INLINE void __disable_fault_irq(void)
+{
+  SIM_CoreReg.FAULTMASK = 1;
+}
+
+static __INLINE uint32_t __get_BASEPRI(void)
+{
+  return(SIM_CoreReg.BASEPRI);
+}
+
+static __INLINE void __set_BASEPRI(uint32_t value)
+{
+  SIM_CoreReg.BASEPRI = value & 0xFF;
+  SIM_ServiceIRQ();
+}
+
+static __INLINE uint32_t __get_FAULTMASK(void)
+{
+  return(SIM_CoreReg.FAULTMASK);
+}
+
+static __INLINE void __set_FAULTMASK(uint32_t faultMask)
+{
+  SIM_CoreReg.FAULTMASK = faultMask & 1;
+  if (SIM_CoreReg.FAULTMASK == 0) SIM_ServiceIRQ();
+}
+
+#endif /* (__CORTEX_M >= 0x03) */
+
+
 #elif defined ( __GNUC__ ) /*------------------ GNU Compiler ---------------------*/
 /* GNU gcc specific functions */
 
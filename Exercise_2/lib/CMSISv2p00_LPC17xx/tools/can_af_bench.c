@@ -0,0 +1,281 @@
+/**************************************************************************//**
+ * @file     can_af_bench.c
+ * @brief    Host benchmark of the CAN acceptance filter table loaders
+ * @version  V1.00
+ *
+ * @note
+ * Usage: can_af_bench [sets] [seed]
+ *
+ * Loads random identifier sets of 1000 entries into the acceptance filter
+ * RAM twice: entry by entry, the way CAN_LoadExplicitEntry() and
+ * CAN_LoadGroupEntry() are used, and in one call of CAN_LoadAFTable(). It
+ * prints the mean number of AF RAM accesses and the mean host time per
+ * load. Each access is trapped by the simulator, so the time mostly follows
+ * the access count. Two kinds of sets are used:
+ * - std: 1000 distinct standard identifiers of both controllers, unordered
+ * - ext: 1000 extended identifiers of CAN1 in runs of 1 to 32, given run
+ *   by run. One controller only: CAN_LoadGroupEntry() misplaces extended
+ *   groups once both controllers have some
+ * Each loaded table is then checked with CAN_LookupAFEntry(). Every
+ * identifier of the set must be accepted, and its neighbours outside the
+ * set must be rejected.
+ * Built by "make HOST=1 can_af_bench" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "LPC17xx.h"
+#include "sim_LPC17xx.h"
+#include "lpc17xx_can.h"
+
+#define BENCH_SET_SIZE    1000
+#define BENCH_MAX_RUN     32
+
+/* Cost of the loads of one method on one kind of set */
+typedef struct
+{
+    const char* name;
+    uint64_t loads;
+    uint64_t accesses;
+    uint64_t total_ns;
+    uint64_t words;
+} Bench_Type;
+
+/* A run of consecutive identifiers */
+typedef struct
+{
+    uint32_t first;
+    uint32_t length;
+} Run_Type;
+
+/* Counts the accesses to the AF RAM page, which stays ordinary memory */
+static SIM_Model_Type af_ram_model = { LPC_CANAF_RAM_BASE, "CANAF_RAM", NULL, NULL, NULL, NULL, NULL, NULL, 0 };
+
+static uint32_t set[BENCH_SET_SIZE];
+static uint32_t scratch[BENCH_SET_SIZE];
+static Run_Type runs[BENCH_SET_SIZE];
+static uint32_t rng;
+
+static uint32_t next_random(void)
+{
+    rng = rng * 1664525UL + 1013904223UL;
+    return rng >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int in_set(uint32_t key, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (set[i] == key)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* 1000 distinct standard keys in random order */
+static uint32_t make_std_set(void)
+{
+    static uint8_t used[2 << 11];
+    uint32_t n = 0, ctrl, id;
+
+    memset(used, 0, sizeof(used));
+    while (n < BENCH_SET_SIZE)
+    {
+        ctrl = next_random() & 1;
+        id = next_random() & 0x7FF;
+        if (!used[(ctrl << 11) | id])
+        {
+            used[(ctrl << 11) | id] = 1;
+            set[n++] = CAN_AF_STD_KEY(ctrl, id);
+        }
+    }
+    return n;
+}
+
+/* 1000 extended keys in runs separated by gaps, runs in random order */
+static uint32_t make_ext_set(uint32_t* num_runs)
+{
+    uint32_t n = 0, r = 0, i, j, len, base;
+    Run_Type tmp;
+
+    base = next_random() & 0xFFFFF;
+    while (n < BENCH_SET_SIZE)
+    {
+        len = 1 + next_random() % BENCH_MAX_RUN;
+        if (len > BENCH_SET_SIZE - n)
+        {
+            len = BENCH_SET_SIZE - n;
+        }
+        runs[r].first = base;
+        runs[r].length = len;
+        base += len + 2 + next_random() % 1000;
+        for (i = 0; i < len; i++)
+        {
+            set[n++] = CAN_AF_EXT_KEY(CAN1_CTRL, runs[r].first + i);
+        }
+        r++;
+    }
+    for (i = r; i-- > 1;)
+    {
+        j = next_random() % (i + 1);
+        tmp = runs[i];
+        runs[i] = runs[j];
+        runs[j] = tmp;
+    }
+    *num_runs = r;
+    return n;
+}
+
+/* Every key of the set accepted, the neighbours outside it rejected */
+static void check(const char* name, uint32_t count)
+{
+    uint32_t i, key;
+
+    for (i = 0; i < count; i++)
+    {
+        key = set[i];
+        if (!CAN_LookupAFEntry(key))
+        {
+            fprintf(stderr, "can_af_bench: %s table misses key %08x\n", name, (unsigned)key);
+            exit(1);
+        }
+        if ((((key + 1) & 0x7FF) != 0) && !in_set(key + 1, count) && CAN_LookupAFEntry(key + 1))
+        {
+            fprintf(stderr, "can_af_bench: %s table accepts key %08x\n", name, (unsigned)(key + 1));
+            exit(1);
+        }
+    }
+}
+
+static void account(Bench_Type* b, uint64_t t0, uint64_t a0, uint32_t words)
+{
+    b->total_ns += now_ns() - t0;
+    b->accesses += af_ram_model.accesses - a0;
+    b->words += words;
+    b->loads++;
+}
+
+static void load_bulk(Bench_Type* b, uint32_t count)
+{
+    uint64_t t0, a0;
+
+    memcpy(scratch, set, count * sizeof(uint32_t));
+    t0 = now_ns();
+    a0 = af_ram_model.accesses;
+    if (CAN_LoadAFTable(LPC_CANAF, scratch, count) != CAN_OK)
+    {
+        fprintf(stderr, "can_af_bench: CAN_LoadAFTable failed\n");
+        exit(1);
+    }
+    account(b, t0, a0, LPC_CANAF->ENDofTable >> 2);
+    check(b->name, count);
+}
+
+static void load_std_entries(Bench_Type* b, uint32_t count)
+{
+    uint64_t t0, a0;
+    uint32_t i;
+
+    CAN_LoadAFTable(LPC_CANAF, scratch, 0);
+    t0 = now_ns();
+    a0 = af_ram_model.accesses;
+    for (i = 0; i < count; i++)
+    {
+        if (CAN_LoadExplicitEntry((set[i] & (1 << 13)) ? LPC_CAN2 : LPC_CAN1, set[i] & 0x7FF, STD_ID_FORMAT) != CAN_OK)
+        {
+            fprintf(stderr, "can_af_bench: CAN_LoadExplicitEntry failed\n");
+            exit(1);
+        }
+    }
+    account(b, t0, a0, (count + 1) / 2);
+    check(b->name, count);
+}
+
+static void load_ext_entries(Bench_Type* b, uint32_t count, uint32_t num_runs)
+{
+    uint64_t t0, a0;
+    uint32_t i, j, words = 0;
+    CAN_ERROR err = CAN_OK;
+
+    CAN_LoadAFTable(LPC_CANAF, scratch, 0);
+    t0 = now_ns();
+    a0 = af_ram_model.accesses;
+    for (i = 0; (i < num_runs) && (err == CAN_OK); i++)
+    {
+        if (runs[i].length >= CAN_AF_GROUP_MIN)
+        {
+            err = CAN_LoadGroupEntry(LPC_CAN1, runs[i].first, runs[i].first + runs[i].length - 1, EXT_ID_FORMAT);
+            words += 2;
+        }
+        for (j = 0; (runs[i].length < CAN_AF_GROUP_MIN) && (j < runs[i].length) && (err == CAN_OK); j++)
+        {
+            err = CAN_LoadExplicitEntry(LPC_CAN1, runs[i].first + j, EXT_ID_FORMAT);
+            words++;
+        }
+    }
+    if (err != CAN_OK)
+    {
+        fprintf(stderr, "can_af_bench: entry by entry load failed (%d)\n", (int)err);
+        exit(1);
+    }
+    account(b, t0, a0, words);
+    check(b->name, count);
+}
+
+static void report(const char* set_name, Bench_Type* b)
+{
+    printf("%-4s %-8s %6.0f AF RAM accesses %9.1f us %6.1f words per load\n", set_name, b->name,
+           (double)b->accesses / (double)b->loads, (double)b->total_ns / (double)b->loads / 1000.0,
+           (double)b->words / (double)b->loads);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long sets = (argc > 1) ? strtoul(argv[1], NULL, 0) : 3UL;
+    uint32_t seed = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 1;
+    Bench_Type std_entries = { "entries", 0, 0, 0, 0 };
+    Bench_Type std_bulk = { "bulk", 0, 0, 0, 0 };
+    Bench_Type ext_entries = { "entries", 0, 0, 0, 0 };
+    Bench_Type ext_bulk = { "bulk", 0, 0, 0, 0 };
+    uint32_t count, num_runs;
+    unsigned long s;
+
+    SIM_Init();
+    SIM_AttachModel(&af_ram_model);
+    rng = seed;
+
+    for (s = 0; s < sets; s++)
+    {
+        count = make_std_set();
+        load_std_entries(&std_entries, count);
+        load_bulk(&std_bulk, count);
+
+        count = make_ext_set(&num_runs);
+        load_ext_entries(&ext_entries, count, num_runs);
+        load_bulk(&ext_bulk, count);
+    }
+
+    printf("%lu sets of %u identifiers, seed %u\n", sets, (unsigned)BENCH_SET_SIZE, (unsigned)seed);
+    report("std", &std_entries);
+    report("std", &std_bulk);
+    report("ext", &ext_entries);
+    report("ext", &ext_bulk);
+    return 0;
+}
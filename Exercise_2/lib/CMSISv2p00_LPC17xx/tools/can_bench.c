@@ -0,0 +1,219 @@
+/**************************************************************************//**
+ * @file     can_bench.c
+ * @brief    Host benchmark of the CAN frame queues at 1 Mbit/s bus load
+ * @version  V1.00
+ *
+ * @note
+ * Usage: can_bench [frames]
+ *
+ * Runs CANQ on CAN1 at 1 Mbit/s with the simulator in bit rate paced mode.
+ * [frames] (default 20000) back to back 8-byte frames arrive on the bus,
+ * the backlog is kept topped up so the receive side never idles, while the
+ * same number of 8-byte frames is queued with CANQ_Send() so the transmit
+ * side is saturated too. The application polls the queues every 0.1, 1 and
+ * 5 ms of simulated time, the 64 frame receive ring covering 7 ms of bus
+ * time. Every frame is checked for order and content, and the per
+ * identifier counters against the traffic. Prints one line per poll period
+ * with the bus load reached, RxDropped, Overruns and the ring and queue
+ * high water marks, and exits non zero if a frame was lost or damaged.
+ * Built by "make HOST=1 can_bench" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "LPC17xx.h"
+#include "lpc17xx_can.h"
+#include "lpc17xx_canq.h"
+#include "sim_LPC17xx.h"
+
+#define BENCH_BUS         1
+#define BENCH_BITRATE     1000000
+#define BENCH_FRAME_BITS  111         /* standard identifier, 8 data bytes, interframe space */
+#define BENCH_RX_SIZE     64
+#define BENCH_TX_SIZE     64
+#define BENCH_TX_ID       0x123
+#define BENCH_CHUNK       256         /* frames per backlog top up */
+
+static CANQ_Type queue;
+static CAN_MSG_Type rx_ring[BENCH_RX_SIZE];
+static CANQ_TX_ENTRY_Type tx_heap[BENCH_TX_SIZE];
+static CANQ_COUNTER_Type counters[3];
+static const uint32_t rx_ids[3] = { 0x100, 0x123, 0x7FF };
+
+void CAN_IRQHandler(void)
+{
+    CANQ_IntHandler(&queue);
+}
+
+static uint32_t frame_seq(const uint8_t* data)
+{
+    return data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static int frame_ok(const uint8_t* data, uint32_t seq)
+{
+    uint32_t i;
+
+    if (frame_seq(data) != seq)
+    {
+        return 0;
+    }
+    for (i = 4; i < 8; i++)
+    {
+        if (data[i] != (uint8_t)(seq * 7 + i))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void frame_fill(uint8_t* data, uint32_t seq)
+{
+    uint32_t i;
+
+    for (i = 0; i < 4; i++)
+    {
+        data[i] = (uint8_t)(seq >> (8 * i));
+    }
+    for (i = 4; i < 8; i++)
+    {
+        data[i] = (uint8_t)(seq * 7 + i);
+    }
+}
+
+/* One run polling every poll_us microseconds, returns 1 when nothing was lost */
+static int run(uint32_t n, uint32_t poll_us)
+{
+    static SIM_CAN_Frame_Type chunk[BENCH_CHUNK];
+    static SIM_CAN_Frame_Type out[SIM_CAN_BUF_SIZE];
+    CANQ_CFG_Type cfg;
+    CANQ_STATS_Type stats;
+    CAN_MSG_Type msg;
+    uint32_t injected = 0, received = 0, queued = 0, sent = 0, bad = 0;
+    uint32_t poll = SystemCoreClock / 1000000 * poll_us;
+    uint64_t limit = (uint64_t)SystemCoreClock / BENCH_BITRATE * BENCH_FRAME_BITS * n * 2 + SystemCoreClock;
+    uint64_t t0, elapsed;
+    uint32_t i, k, got, ids_ok;
+    int ok;
+
+    for (i = 0; i < 3; i++)
+    {
+        counters[i].Id = rx_ids[i];
+        counters[i].Rx = 0;
+        counters[i].Tx = 0;
+    }
+    cfg.RxBuffer = rx_ring;
+    cfg.RxSize = BENCH_RX_SIZE;
+    cfg.TxBuffer = tx_heap;
+    cfg.TxSize = BENCH_TX_SIZE;
+    cfg.Counters = counters;
+    cfg.NumCounters = 3;
+    CANQ_Init(&queue, LPC_CAN1, &cfg);
+
+    t0 = SIM_GetCycles();
+    while ((received < n || sent < n) && (SIM_GetCycles() - t0 < limit))
+    {
+        /* Keep the receive backlog full, frames not yet seen by the interrupt */
+        CANQ_GetStats(&queue, &stats);
+        while ((injected < n) && (injected - stats.RxFrames <= SIM_CAN_BUF_SIZE - BENCH_CHUNK))
+        {
+            for (k = 0; (k < BENCH_CHUNK) && (injected + k < n); k++)
+            {
+                chunk[k].id = rx_ids[(injected + k) % 3];
+                chunk[k].ext = 0;
+                chunk[k].rtr = 0;
+                chunk[k].len = 8;
+                frame_fill(chunk[k].data, injected + k);
+            }
+            SIM_CAN_Inject(BENCH_BUS, chunk, k);
+            injected += k;
+        }
+
+        /* The application's share of the period, then it services the queues */
+        SIM_Advance(poll);
+        while (CANQ_Receive(&queue, &msg))
+        {
+            if (msg.len != 8 || msg.id != rx_ids[received % 3] || !frame_ok(msg.dataA, received))
+            {
+                bad++;
+            }
+            received++;
+        }
+        while (queued < n)
+        {
+            memset(&msg, 0, sizeof(msg));
+            msg.id = BENCH_TX_ID;
+            msg.len = 8;
+            msg.format = STD_ID_FORMAT;
+            msg.type = DATA_FRAME;
+            frame_fill(msg.dataA, queued);
+            if (CANQ_Send(&queue, &msg) != SUCCESS)
+            {
+                break;
+            }
+            queued++;
+        }
+        got = SIM_CAN_Drain(BENCH_BUS, out, SIM_CAN_BUF_SIZE);
+        for (i = 0; i < got; i++)
+        {
+            if (out[i].len != 8 || out[i].id != BENCH_TX_ID || !frame_ok(out[i].data, sent))
+            {
+                bad++;
+            }
+            sent++;
+        }
+    }
+    elapsed = SIM_GetCycles() - t0;
+
+    CANQ_GetStats(&queue, &stats);
+    ids_ok = 1;
+    for (i = 0; i < 3; i++)
+    {
+        if (CANQ_GetCounter(&queue, rx_ids[i])->Rx != n / 3 + (i < n % 3))
+        {
+            ids_ok = 0;
+        }
+    }
+    ids_ok = ids_ok && (CANQ_GetCounter(&queue, BENCH_TX_ID)->Tx == n);
+
+    ok = (received == n) && (sent == n) && (bad == 0) && ids_ok && (stats.RxDropped == 0) && (stats.Overruns == 0)
+         && (stats.RxFrames == n) && (stats.TxFrames == n);
+    printf("%7.1f %8u %8u %6.1f%% %6.1f%% %9u %8u %6u %6u  %s\n", poll_us / 1000.0, (unsigned)received,
+           (unsigned)sent, 100.0 * received * BENCH_FRAME_BITS / ((double)elapsed / SystemCoreClock * BENCH_BITRATE),
+           100.0 * sent * BENCH_FRAME_BITS / ((double)elapsed / SystemCoreClock * BENCH_BITRATE),
+           (unsigned)stats.RxDropped, (unsigned)stats.Overruns, (unsigned)stats.RxHighWater,
+           (unsigned)stats.TxHighWater, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    static const uint32_t polls[] = { 100, 1000, 5000 };
+    uint32_t n = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000;
+    uint32_t failures = 0;
+    uint32_t i;
+
+    SIM_Init();
+    SystemInit();
+    CAN_Init(LPC_CAN1, BENCH_BITRATE);
+    CAN_SetAFMode(LPC_CANAF, CAN_AccBP);
+    SIM_CAN_SetPaced(BENCH_BUS, 1);
+
+    printf("%u frames each way, CAN1 at %u bit/s, %u bits per frame\n", (unsigned)n, BENCH_BITRATE,
+           BENCH_FRAME_BITS);
+    printf("poll ms       rx       tx rx load tx load RxDropped Overruns RxHigh TxHigh\n");
+    for (i = 0; i < sizeof(polls) / sizeof(polls[0]); i++)
+    {
+        if (!run(n, polls[i]))
+        {
+            failures++;
+        }
+    }
+    printf("%u runs failed\n", (unsigned)failures);
+    return (failures != 0) ? 1 : 0;
+}
@@ -0,0 +1,280 @@
+/**************************************************************************//**
+ * @file     dlog_decode.c
+ * @brief    Host decoder of the DLOG binary record stream
+ * @version  V1.00
+ *
+ * @note
+ * Usage: dlog_decode [-t] [-c hz] firmware.elf [log.bin]
+ *
+ * A DLOG record is little-endian words: header (DLOG_SYNC | nargs << 16),
+ * format string address, DWT cycle count, then the arguments. The format
+ * string and the %s arguments are looked up by address in the allocated
+ * sections of the firmware image, 32-bit target or 64-bit host simulator
+ * build. The stream is read from stdin without a file name. -t prefixes
+ * each line with the time stamp, in cycles or, with -c, in microseconds.
+ * Built by "make dlog_decode" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <elf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DLOG_SYNC         0xD1000000UL
+#define DLOG_MAX_ARGS     4
+#define DLOG_HDR_WORDS    3
+
+/* One allocated section of the image */
+typedef struct
+{
+    uint64_t addr;
+    uint64_t size;
+    const uint8_t* data;
+} Section_Type;
+
+static uint8_t* image;
+static long image_size;
+static Section_Type sections[256];
+static unsigned num_sections;
+
+/* Load the image and index its allocated sections that have file contents */
+static int load_elf(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    unsigned i, n;
+
+    if (f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    image_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    image = malloc((size_t)image_size);
+    if ((image == NULL) || (fread(image, 1, (size_t)image_size, f) != (size_t)image_size))
+    {
+        fprintf(stderr, "%s: read error\n", path);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    if ((image_size < EI_NIDENT) || memcmp(image, ELFMAG, SELFMAG))
+    {
+        fprintf(stderr, "%s: not an ELF file\n", path);
+        return -1;
+    }
+
+    if (image[EI_CLASS] == ELFCLASS32)
+    {
+        Elf32_Ehdr* eh = (Elf32_Ehdr*)image;
+        Elf32_Shdr* sh = (Elf32_Shdr*)(image + eh->e_shoff);
+
+        n = eh->e_shnum;
+        for (i = 0; i < n && num_sections < 256; i++)
+        {
+            if ((sh[i].sh_flags & SHF_ALLOC) && (sh[i].sh_type == SHT_PROGBITS))
+            {
+                sections[num_sections].addr = sh[i].sh_addr;
+                sections[num_sections].size = sh[i].sh_size;
+                sections[num_sections++].data = image + sh[i].sh_offset;
+            }
+        }
+    }
+    else
+    {
+        Elf64_Ehdr* eh = (Elf64_Ehdr*)image;
+        Elf64_Shdr* sh = (Elf64_Shdr*)(image + eh->e_shoff);
+
+        n = eh->e_shnum;
+        for (i = 0; i < n && num_sections < 256; i++)
+        {
+            if ((sh[i].sh_flags & SHF_ALLOC) && (sh[i].sh_type == SHT_PROGBITS))
+            {
+                sections[num_sections].addr = sh[i].sh_addr;
+                sections[num_sections].size = sh[i].sh_size;
+                sections[num_sections++].data = image + sh[i].sh_offset;
+            }
+        }
+    }
+    return 0;
+}
+
+/* String at a target address, NULL if it is not in the image */
+static const char* lookup(uint32_t addr)
+{
+    unsigned i;
+
+    for (i = 0; i < num_sections; i++)
+    {
+        if ((addr >= sections[i].addr) && (addr - sections[i].addr < sections[i].size) &&
+            memchr(sections[i].data + (addr - sections[i].addr), 0, sections[i].size - (addr - sections[i].addr)))
+        {
+            return (const char*)sections[i].data + (addr - sections[i].addr);
+        }
+    }
+    return NULL;
+}
+
+/* Expand one record with the host printf, one conversion at a time */
+static void print_record(const char* fmt, const uint32_t* args, uint32_t nargs)
+{
+    char spec[16];
+    const char* s;
+    uint32_t arg = 0, value;
+    size_t n;
+
+    while (*fmt)
+    {
+        if (*fmt != '%')
+        {
+            putchar(*fmt++);
+            continue;
+        }
+        n = strspn(fmt + 1, "0123456789l");
+        if ((fmt[1 + n] == '\0') || (n + 3 > sizeof(spec)))
+        {
+            break;
+        }
+        if (fmt[1 + n] == '%')
+        {
+            putchar('%');
+            fmt += n + 2;
+            continue;
+        }
+        memcpy(spec, fmt, n + 1);
+        spec[n + 1] = fmt[1 + n];
+        spec[n + 2] = '\0';
+        if (spec[n] == 'l')
+        {
+            spec[n] = spec[n + 1];                    /* arguments are 32-bit anyway */
+            spec[n + 1] = '\0';
+        }
+        value = (arg < nargs) ? args[arg] : 0;
+        arg++;
+        switch (fmt[1 + n])
+        {
+            case 'd': case 'i':
+                printf(spec, (int32_t)value);
+                break;
+            case 'u': case 'x': case 'X': case 'c':
+                printf(spec, value);
+                break;
+            case 'p':
+                printf("%08x", value);
+                break;
+            case 's':
+                s = lookup(value);
+                if (s != NULL)
+                {
+                    printf(spec, s);
+                }
+                else
+                {
+                    printf("<str@%08x>", value);
+                }
+                break;
+            default:
+                break;
+        }
+        fmt += n + 2;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t rec[DLOG_HDR_WORDS + DLOG_MAX_ARGS];
+    uint32_t nargs, records = 0, resyncs = 0;
+    double hz = 0;
+    int stamps = 0, i = 1;
+    const char* fmt;
+    FILE* in = stdin;
+    uint8_t b[4];
+
+    while ((i < argc) && (argv[i][0] == '-'))
+    {
+        if (!strcmp(argv[i], "-t"))
+        {
+            stamps = 1;
+        }
+        else if (!strcmp(argv[i], "-c") && (i + 1 < argc))
+        {
+            hz = atof(argv[++i]);
+        }
+        else
+        {
+            break;
+        }
+        i++;
+    }
+    if ((i >= argc) || (load_elf(argv[i]) != 0))
+    {
+        fprintf(stderr, "usage: %s [-t] [-c hz] firmware.elf [log.bin]\n", argv[0]);
+        return 1;
+    }
+    if ((i + 1 < argc) && ((in = fopen(argv[i + 1], "rb")) == NULL))
+    {
+        perror(argv[i + 1]);
+        return 1;
+    }
+
+    /* Header search goes byte by byte, so a cut stream resynchronizes */
+    if (fread(b, 1, 4, in) != 4)
+    {
+        return 0;
+    }
+    for (;;)
+    {
+        rec[0] = b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+        nargs = (rec[0] >> 16) & 0x0F;
+        if (((rec[0] & 0xFFF00000UL) != DLOG_SYNC) || (rec[0] & 0xFFFF) || (nargs > DLOG_MAX_ARGS))
+        {
+            resyncs++;
+            memmove(b, b + 1, 3);
+            if (fread(&b[3], 1, 1, in) != 1)
+            {
+                break;
+            }
+            continue;
+        }
+        if (fread(&rec[1], 4, DLOG_HDR_WORDS - 1 + nargs, in) != DLOG_HDR_WORDS - 1 + nargs)
+        {
+            break;
+        }
+        records++;
+        if (stamps)
+        {
+            if (hz > 0)
+            {
+                printf("[%12.3f] ", rec[2] * 1e6 / hz);
+            }
+            else
+            {
+                printf("[%10u] ", rec[2]);
+            }
+        }
+        if (rec[1] == 0)
+        {
+            printf("<%u lost>\n", nargs ? rec[3] : 0);
+        }
+        else if ((fmt = lookup(rec[1])) != NULL)
+        {
+            print_record(fmt, &rec[3], nargs);
+        }
+        else
+        {
+            printf("<unknown format %08x>\n", rec[1]);
+        }
+        if (fread(b, 1, 4, in) != 4)
+        {
+            break;
+        }
+    }
+    if (resyncs)
+    {
+        fprintf(stderr, "%u records, %u bytes skipped\n", records, resyncs);
+    }
+    return 0;
+}
@@ -0,0 +1,240 @@
+/**************************************************************************//**
+ * @file     gpio_bench.c
+ * @brief    Host benchmark of the GPIO library calls against the inline fast path
+ * @version  V1.00
+ *
+ * @note
+ * Usage: gpio_bench [calls]
+ *
+ * Times [calls] (default 1000000) pin set, clear, read and toggle operations
+ * on port 1 through GPIO_SetValue()/GPIO_ClearValue()/GPIO_ReadValue(), the
+ * FIO_ aliases and the GPIO_Fast inlines, and prints host TSC cycles per
+ * operation. HWREG_READ()/HWREG_WRITE() are redefined to plain accesses
+ * before lpc17xx_gpio.h is included, as on the target, and the GPIO model
+ * is detached during the timing, so a fast call costs what its load or
+ * store costs. Before timing, every variant is run against the GPIO model
+ * and must leave the same outputs.
+ * Built by "make HOST=1 gpio_bench" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <x86intrin.h>
+
+#include "lpc_types.h"
+
+/* The target's register accessors, see the note above */
+#undef HWREG_READ
+#undef HWREG_WRITE
+#define HWREG_READ(reg)         (reg)
+#define HWREG_WRITE(reg, value) ((reg) = (value))
+
+#include "LPC17xx.h"
+#include "lpc17xx_gpio.h"
+#include "sim_LPC17xx.h"
+
+#define BENCH_PORT        1
+#define BENCH_RUNS        5           /* best of */
+#define BENCH_CHECK_OPS   1000
+
+/* One operation, three ways */
+typedef struct
+{
+    const char* name;
+    void (*op[3])(uint32_t n);        /* GPIO_, FIO_, GPIO_Fast */
+} Bench_Type;
+
+static volatile uint32_t sink;
+
+static void set_gpio(uint32_t n)
+{
+    while (n--)
+    {
+        GPIO_SetValue(BENCH_PORT, n);
+    }
+}
+
+static void set_fio(uint32_t n)
+{
+    while (n--)
+    {
+        FIO_SetValue(BENCH_PORT, n);
+    }
+}
+
+static void set_fast(uint32_t n)
+{
+    while (n--)
+    {
+        GPIO_FastSet(BENCH_PORT, n);
+    }
+}
+
+static void clear_gpio(uint32_t n)
+{
+    while (n--)
+    {
+        GPIO_ClearValue(BENCH_PORT, n);
+    }
+}
+
+static void clear_fio(uint32_t n)
+{
+    while (n--)
+    {
+        FIO_ClearValue(BENCH_PORT, n);
+    }
+}
+
+static void clear_fast(uint32_t n)
+{
+    while (n--)
+    {
+        GPIO_FastClear(BENCH_PORT, n);
+    }
+}
+
+static void read_gpio(uint32_t n)
+{
+    uint32_t acc = 0;
+
+    while (n--)
+    {
+        acc += GPIO_ReadValue(BENCH_PORT);
+    }
+    sink = acc;
+}
+
+static void read_fio(uint32_t n)
+{
+    uint32_t acc = 0;
+
+    while (n--)
+    {
+        acc += FIO_ReadValue(BENCH_PORT);
+    }
+    sink = acc;
+}
+
+static void read_fast(uint32_t n)
+{
+    uint32_t acc = 0;
+
+    while (n--)
+    {
+        acc += GPIO_FastRead(BENCH_PORT);
+    }
+    sink = acc;
+}
+
+/* Toggle by read, set and clear, the way it was written before GPIO_FastToggle() */
+static void toggle_gpio(uint32_t n)
+{
+    while (n--)
+    {
+        uint32_t pin = GPIO_ReadValue(BENCH_PORT);
+
+        GPIO_SetValue(BENCH_PORT, ~pin & n);
+        GPIO_ClearValue(BENCH_PORT, pin & n);
+    }
+}
+
+static void toggle_fio(uint32_t n)
+{
+    while (n--)
+    {
+        uint32_t pin = FIO_ReadValue(BENCH_PORT);
+
+        FIO_SetValue(BENCH_PORT, ~pin & n);
+        FIO_ClearValue(BENCH_PORT, pin & n);
+    }
+}
+
+static void toggle_fast(uint32_t n)
+{
+    while (n--)
+    {
+        GPIO_FastToggle(BENCH_PORT, n);
+    }
+}
+
+static const Bench_Type benches[] = {
+    { "set", { set_gpio, set_fio, set_fast } },
+    { "clear", { clear_gpio, clear_fio, clear_fast } },
+    { "read", { read_gpio, read_fio, read_fast } },
+    { "toggle", { toggle_gpio, toggle_fio, toggle_fast } },
+};
+
+#define BENCH_COUNT       (sizeof(benches) / sizeof(benches[0]))
+
+/* Every variant of one operation must leave the same outputs on the model */
+static void check(const Bench_Type* b)
+{
+    uint32_t out[3];
+    uint32_t way;
+
+    for (way = 0; way < 3; way++)
+    {
+        SIM_Reset();
+        LPC_GPIO1->FIODIR = 0xFFFFFFFFUL;
+        LPC_GPIO1->FIOSET = 0x5A5A5A5AUL;
+        b->op[way](BENCH_CHECK_OPS);
+        out[way] = SIM_GPIO_GetOutput(BENCH_PORT);
+    }
+    if (out[1] != out[0] || out[2] != out[0])
+    {
+        fprintf(stderr, "gpio_bench: %s: outputs 0x%08X 0x%08X 0x%08X\n", b->name, (unsigned)out[0],
+                (unsigned)out[1], (unsigned)out[2]);
+        exit(1);
+    }
+}
+
+/* Best of BENCH_RUNS, host cycles per operation including the loop */
+static double measure(void (*op)(uint32_t n), uint32_t n)
+{
+    double best = 0;
+    uint32_t run;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+        uint64_t t0 = __rdtsc();
+        double cycles;
+
+        op(n);
+        cycles = (double)(__rdtsc() - t0) / (double)n;
+        if (run == 0 || cycles < best)
+        {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t n = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000000;
+    uint32_t i;
+
+    SIM_Init();
+    for (i = 0; i < BENCH_COUNT; i++)
+    {
+        check(&benches[i]);
+    }
+    SIM_DetachModel(LPC_GPIO_BASE);
+
+    printf("%u operations on port %u, best of %u, host TSC cycles per operation\n", (unsigned)n,
+           (unsigned)BENCH_PORT, BENCH_RUNS);
+    printf("operation    GPIO_    FIO_  GPIO_Fast  speedup\n");
+    for (i = 0; i < BENCH_COUNT; i++)
+    {
+        const Bench_Type* b = &benches[i];
+        double gpio = measure(b->op[0], n);
+        double fio = measure(b->op[1], n);
+        double fast = measure(b->op[2], n);
+
+        printf("%-9s %7.1f %7.1f %10.1f %7.1fx\n", b->name, gpio, fio, fast, gpio / fast);
+    }
+    return 0;
+}
@@ -0,0 +1,267 @@
+/**************************************************************************//**
+ * @file     heap_bench.c
+ * @brief    Host allocation stress benchmark of HEAP against the C library
+ * @version  V1.00
+ *
+ * @note
+ * Usage: heap_bench [ops] [seed]
+ *
+ * Runs the same random allocate / resize / free sequence on a HEAP pool the
+ * size of the LPC1769 main SRAM and on the malloc of the C library, and
+ * prints the mean, 99.9th percentile and worst time per call of each (the
+ * worst case mostly shows host scheduling, the percentile the allocator).
+ * Requests are mostly small (8 to 256 bytes) with a few large ones (1 to
+ * 4 KB), up to 256 live blocks and at most half the pool live in bytes: a
+ * request past that is skipped on both allocators, so the fixed pool
+ * competes with the unbounded C library on the same live set. Failed calls
+ * are left out of the times and counted on a line of their own, and any
+ * failure fails the run.
+ * The HEAP blocks are filled and checked on free to catch corruption. HEAP
+ * also reports its high-water mark and the fragmentation left.
+ * Built by "make HOST=1 heap_bench" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lpc17xx_heap.h"
+
+#define BENCH_POOL_SIZE   (32 * 1024)
+#define BENCH_SLOTS       256
+#define BENCH_LIVE_MAX    (BENCH_POOL_SIZE / 2)   /* bytes held at most, room for the free block headers and splits */
+
+/* Time of the calls of one allocator */
+typedef struct
+{
+    const char* name;
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t worst_ns;
+    uint64_t failures;
+    uint32_t* samples;
+} Bench_Type;
+
+static uint8_t pool[BENCH_POOL_SIZE];
+static HEAP_Type heap;
+static uint32_t rng;
+
+static uint32_t next_random(void)
+{
+    rng = rng * 1664525UL + 1013904223UL;
+    return rng >> 8;
+}
+
+static uint32_t random_size(void)
+{
+    uint32_t r = next_random();
+
+    if ((r & 31) == 0)
+    {
+        return 1024 + (next_random() % 3072);
+    }
+    return 8 + (next_random() % 249);
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void account(Bench_Type* b, uint64_t dt)
+{
+    b->samples[b->calls] = (dt > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)dt;
+    b->calls++;
+    b->total_ns += dt;
+    if (dt > b->worst_ns)
+    {
+        b->worst_ns = dt;
+    }
+}
+
+/* One run of the sequence, on HEAP (use_heap) or on the C library. HEAP
+ * statistics are taken at the end, before the blocks still held are freed */
+static void run(Bench_Type* b, int use_heap, unsigned long ops, uint32_t seed, HEAP_STATS_Type* stats)
+{
+    static uint8_t* slot[BENCH_SLOTS];
+    static uint32_t len[BENCH_SLOTS];
+    unsigned long op;
+    uint32_t i, n, size;
+    uint32_t live = 0;
+    uint64_t t0, dt;
+    uint8_t* p;
+
+    memset(slot, 0, sizeof(slot));
+    rng = seed;
+    for (op = 0; op < ops; op++)
+    {
+        i = next_random() % BENCH_SLOTS;
+        if (slot[i] == NULL)
+        {
+            size = random_size();
+            if (live + size > BENCH_LIVE_MAX)
+            {
+                continue;
+            }
+            t0 = now_ns();
+            p = use_heap ? HEAP_Alloc(&heap, size) : malloc(size);
+            dt = now_ns() - t0;
+            if (p == NULL)
+            {
+                b->failures++;
+                continue;
+            }
+            account(b, dt);
+            memset(p, (int)i, size);
+            slot[i] = p;
+            len[i] = size;
+            live += size;
+        }
+        else if ((next_random() & 7) == 0)
+        {
+            size = random_size();
+            if (live - len[i] + size > BENCH_LIVE_MAX)
+            {
+                continue;
+            }
+            t0 = now_ns();
+            p = use_heap ? HEAP_Realloc(&heap, slot[i], size) : realloc(slot[i], size);
+            dt = now_ns() - t0;
+            if (p == NULL)
+            {
+                b->failures++;
+                continue;
+            }
+            account(b, dt);
+            if (size > len[i])
+            {
+                memset(p + len[i], (int)i, size - len[i]);
+            }
+            slot[i] = p;
+            live += size - len[i];
+            len[i] = size;
+        }
+        else
+        {
+            if (use_heap)
+            {
+                for (n = 0; n < len[i]; n++)
+                {
+                    if (slot[i][n] != (uint8_t)i)
+                    {
+                        fprintf(stderr, "heap_bench: block %u corrupted at op %lu\n", (unsigned)i, op);
+                        exit(1);
+                    }
+                }
+            }
+            t0 = now_ns();
+            if (use_heap)
+            {
+                HEAP_Free(&heap, slot[i]);
+            }
+            else
+            {
+                free(slot[i]);
+            }
+            account(b, now_ns() - t0);
+            slot[i] = NULL;
+            live -= len[i];
+        }
+    }
+
+    if (use_heap && (stats != NULL))
+    {
+        HEAP_GetStats(&heap, stats);
+    }
+    for (i = 0; i < BENCH_SLOTS; i++)
+    {
+        if (slot[i] != NULL)
+        {
+            if (use_heap)
+            {
+                HEAP_Free(&heap, slot[i]);
+            }
+            else
+            {
+                free(slot[i]);
+            }
+        }
+    }
+}
+
+static int compare_u32(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+
+    return (x > y) - (x < y);
+}
+
+static void report(Bench_Type* b)
+{
+    uint32_t p999 = 0;
+
+    if (b->calls != 0)
+    {
+        qsort(b->samples, (size_t)b->calls, sizeof(uint32_t), compare_u32);
+        p999 = b->samples[(b->calls * 999) / 1000];
+    }
+    printf("%-6s %10llu calls  mean %6.1f ns  p99.9 %6u ns  worst %8llu ns\n", b->name,
+           (unsigned long long)b->calls, b->calls ? (double)b->total_ns / (double)b->calls : 0.0, (unsigned)p999,
+           (unsigned long long)b->worst_ns);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long ops = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1000000UL;
+    uint32_t seed = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 1;
+    Bench_Type heap_bench = { "HEAP", 0, 0, 0, 0, NULL };
+    Bench_Type libc_bench = { "libc", 0, 0, 0, 0, NULL };
+    HEAP_STATS_Type stats, end;
+
+    heap_bench.samples = malloc(ops * sizeof(uint32_t));
+    libc_bench.samples = malloc(ops * sizeof(uint32_t));
+    if ((heap_bench.samples == NULL) || (libc_bench.samples == NULL))
+    {
+        fprintf(stderr, "heap_bench: out of memory\n");
+        return 1;
+    }
+
+    /* The simulator is left uninitialized: with no NVIC to scan, the PRIMASK
+     * critical sections cost what they cost on the target, a few instructions */
+    HEAP_Init(&heap, pool, sizeof(pool));
+
+    /* Warm up both, then measure */
+    run(&heap_bench, 1, ops / 10, seed + 1, NULL);
+    run(&libc_bench, 0, ops / 10, seed + 1, NULL);
+    heap_bench.calls = heap_bench.total_ns = heap_bench.worst_ns = heap_bench.failures = 0;
+    libc_bench.calls = libc_bench.total_ns = libc_bench.worst_ns = libc_bench.failures = 0;
+
+    HEAP_Init(&heap, pool, sizeof(pool));
+    run(&heap_bench, 1, ops, seed, &stats);
+    HEAP_GetStats(&heap, &end);
+    run(&libc_bench, 0, ops, seed, NULL);
+
+    printf("%lu operations, seed %u, %u byte HEAP pool, at most %u bytes live\n", ops, (unsigned)seed,
+           (unsigned)sizeof(pool), (unsigned)BENCH_LIVE_MAX);
+    report(&heap_bench);
+    report(&libc_bench);
+    printf("failed calls, not timed: HEAP %llu, libc %llu\n", (unsigned long long)heap_bench.failures,
+           (unsigned long long)libc_bench.failures);
+    printf("HEAP   high water %u of %u bytes, at the end %u blocks held, %u bytes free in %u blocks, "
+           "largest %u, fragmentation %u%%\n",
+           (unsigned)stats.HighWater, (unsigned)stats.Size, (unsigned)stats.Allocs, (unsigned)stats.Free,
+           (unsigned)stats.FreeBlocks, (unsigned)stats.LargestFree, (unsigned)stats.Fragmentation);
+    if ((end.Used != 0) || (end.Allocs != 0) || (end.FreeBlocks != 1))
+    {
+        fprintf(stderr, "heap_bench: heap not empty after the run\n");
+        return 1;
+    }
+    return ((heap_bench.failures != 0) || (libc_bench.failures != 0)) ? 1 : 0;
+}
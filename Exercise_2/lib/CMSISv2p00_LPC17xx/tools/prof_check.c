@@ -0,0 +1,187 @@
+/**************************************************************************//**
+ * @file     prof_check.c
+ * @brief    Host check of the PROF probe statistics and histogram binning
+ * @version  V1.00
+ *
+ * @note
+ * Usage: prof_check [measurements]
+ *
+ * Measures known durations with PROF_Start()/PROF_Stop() around
+ * SIM_Advance(), so the DWT cycle counter moves by exactly the simulated
+ * time, each trapped access costing a few cycles more that the overhead
+ * taken by PROF_Init() must cancel. First the bin edges (0, 1, 2^n - 1,
+ * 2^n and past the last bin), one per probe, then [measurements] (default
+ * 20000) pseudo random durations spread over all probes, one probe through
+ * PROF_SCOPE_BEGIN()/PROF_SCOPE_END() and one across a wrap of CYCCNT.
+ * Count, Min, Max, Total, the mean and every histogram bin are compared
+ * with a reference computed here, binning by shifting instead of __CLZ().
+ * Checks that PROF_Reset() clears all probes. Prints one line per case and
+ * exits non zero if any fails.
+ * Built by "make HOST=1 prof_check" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "LPC17xx.h"
+#include "lpc17xx_prof.h"
+#include "sim_LPC17xx.h"
+
+#define CHECK_ACCESS_COST 3           /* cycles per trapped access, the overhead PROF_Init() measures */
+#define CHECK_SCOPE_PROBE 6           /* measured with PROF_SCOPE_BEGIN()/PROF_SCOPE_END() */
+#define CHECK_WRAP_PROBE  7           /* measured across a wrap of CYCCNT */
+#define CHECK_RANDOM_MASK 0x3FFFF     /* longest random duration, past the last bin */
+
+/* Reference statistics of one probe */
+typedef struct
+{
+    uint32_t Count;
+    uint32_t Min;
+    uint32_t Max;
+    uint64_t Total;
+    uint32_t Hist[PROF_HIST_BINS];
+} REF_Type;
+
+static REF_Type ref[PROF_MAX_PROBES];
+static uint32_t failures;
+
+static void check(const char* name, int ok)
+{
+    printf("%-40s %s\n", name, ok ? "PASS" : "FAIL");
+    if (!ok)
+    {
+        failures++;
+    }
+}
+
+static void ref_reset(void)
+{
+    uint32_t probe, bin;
+
+    for (probe = 0; probe < PROF_MAX_PROBES; probe++)
+    {
+        ref[probe].Count = 0;
+        ref[probe].Min = 0xFFFFFFFF;
+        ref[probe].Max = 0;
+        ref[probe].Total = 0;
+        for (bin = 0; bin < PROF_HIST_BINS; bin++)
+        {
+            ref[probe].Hist[bin] = 0;
+        }
+    }
+}
+
+static void ref_record(uint8_t probe, uint32_t cycles)
+{
+    REF_Type* r = &ref[probe];
+    uint32_t bin = 0;
+
+    while ((bin < PROF_HIST_BINS - 1) && (cycles >> (bin + 1)) != 0)
+    {
+        bin++;
+    }
+    r->Count++;
+    r->Total += cycles;
+    r->Min = (cycles < r->Min) ? cycles : r->Min;
+    r->Max = (cycles > r->Max) ? cycles : r->Max;
+    r->Hist[bin]++;
+}
+
+/* Measure one duration on a probe, as an application would */
+static void measure(uint8_t probe, uint32_t cycles)
+{
+    uint32_t start;
+
+    if (probe == CHECK_SCOPE_PROBE)
+    {
+        PROF_SCOPE_BEGIN(probe);
+        SIM_Advance(cycles);
+        PROF_SCOPE_END(probe);
+    }
+    else
+    {
+        if (probe == CHECK_WRAP_PROBE)
+        {
+            DWT->CYCCNT = 0xFFFFFFFF - cycles / 2;
+        }
+        start = PROF_Start();
+        SIM_Advance(cycles);
+        PROF_Stop(probe, start);
+    }
+    ref_record(probe, cycles);
+}
+
+/* Number of probes whose statistics differ from the reference */
+static uint32_t compare(void)
+{
+    const PROF_PROBE_Type* p;
+    uint32_t probe, bin, bad = 0;
+    uint32_t mean;
+
+    for (probe = 0; probe < PROF_MAX_PROBES; probe++)
+    {
+        p = PROF_GetProbe(probe);
+        mean = (ref[probe].Count != 0) ? (uint32_t)(ref[probe].Total / ref[probe].Count) : 0;
+        if ((p->Count != ref[probe].Count) || (p->Min != ref[probe].Min) || (p->Max != ref[probe].Max)
+            || (p->Total != ref[probe].Total) || (PROF_GetMean(probe) != mean))
+        {
+            printf("  probe %u: n=%u min=%u max=%u total=%llu, expected n=%u min=%u max=%u total=%llu\n",
+                   (unsigned)probe, (unsigned)p->Count, (unsigned)p->Min, (unsigned)p->Max,
+                   (unsigned long long)p->Total, (unsigned)ref[probe].Count, (unsigned)ref[probe].Min,
+                   (unsigned)ref[probe].Max, (unsigned long long)ref[probe].Total);
+            bad++;
+            continue;
+        }
+        for (bin = 0; bin < PROF_HIST_BINS; bin++)
+        {
+            if (p->Hist[bin] != ref[probe].Hist[bin])
+            {
+                printf("  probe %u bin %u: %u, expected %u\n", (unsigned)probe, (unsigned)bin,
+                       (unsigned)p->Hist[bin], (unsigned)ref[probe].Hist[bin]);
+                bad++;
+                break;
+            }
+        }
+    }
+    return bad;
+}
+
+int main(int argc, char** argv)
+{
+    static const uint32_t edges[] = { 0, 1, 2, 3, 4, 255, 256, 257, 32767, 32768, 65535, 65536, 1000000 };
+    uint32_t n = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000;
+    uint32_t i, probe;
+
+    SIM_Init();
+    SystemInit();
+    SIM_SetAccessCost(CHECK_ACCESS_COST);
+    PROF_Init();
+    ref_reset();
+
+    /* Bin edges, the last two past the top bin */
+    for (i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+    {
+        measure(i % PROF_MAX_PROBES, edges[i]);
+    }
+    check("bin edges", compare() == 0);
+
+    /* Pseudo random durations of every magnitude, on all probes */
+    srand(1);
+    for (i = 0; i < n; i++)
+    {
+        probe = (uint32_t)rand() % PROF_MAX_PROBES;
+        measure(probe, ((uint32_t)rand() & CHECK_RANDOM_MASK) >> ((uint32_t)rand() % 19));
+    }
+    check("random durations", compare() == 0);
+    check("scope and wrap probes used", ref[CHECK_SCOPE_PROBE].Count != 0 && ref[CHECK_WRAP_PROBE].Count != 0);
+
+    /* Reset clears every probe */
+    PROF_Reset();
+    ref_reset();
+    check("PROF_Reset()", compare() == 0 && PROF_GetMean(0) == 0);
+
+    printf("%u checks failed\n", (unsigned)failures);
+    return (failures != 0) ? 1 : 0;
+}
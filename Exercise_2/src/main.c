@@ -18,6 +18,7 @@
 #include "lpc17xx_pinsel.h"  /* Pin function selection */
 #include "lpc17xx_systick.h" /* Systick handling */
 #include "lpc17xx_timer.h"   /* Timer handling */
+#include "lpc17xx_prof.h"    /* Cycle counter profiling */
 
 /* Pin Definitions */
 
@@ -53,6 +54,9 @@
 /* Systick time */
 #define SYSTICK_TIME 100 /* Interrupt time for systick in [ms] */
 
+/* Profiling probes */
+#define PROF_EINT3 0 /* EINT3_IRQHandler duration */
+
 uint8_t systick_counter = 0;         /* Counter for systick */
 uint8_t battery_level = MAX_BATTERY; /* It can be 2(max), 1(mid), 0(low) */
 uint8_t is_closed = 1;
@@ -63,58 +67,20 @@ uint8_t is_closed = 1;
  */
 void configure_GPIO_ports(void)
 {
-    PINSEL_CFG_Type pin_cfg; /* Create a variable to store the configuration of the pins */
-
-    /* We need to configure the struct with the desired configuration */
-
-    /* configuration for DOOR_BUTTON_PIN */
-    pin_cfg.Portnum = PINSEL_PORT_0;           /* The port number is 0 */
-    pin_cfg.Pinnum = PINSEL_PIN_3;             /* The pin number is 3 */
-    pin_cfg.Funcnum = PINSEL_FUNC_0;           /* The function number is 0 */
-    pin_cfg.Pinmode = PINSEL_PINMODE_PULLDOWN; /* The pin mode is pull-down */
-    pin_cfg.OpenDrain = PINSEL_PINMODE_NORMAL; /* The pin is in the normal mode */
-    PINSEL_ConfigPin(&pin_cfg);                /* Configure the pin */
-
-    /* configuration for ENDSTOP_1_PIN */
-    pin_cfg.Pinnum = PINSEL_PIN_4;
-    PINSEL_ConfigPin(&pin_cfg);
-
-    /* configuration for ENDSTOP_2_PIN */
-    pin_cfg.Pinnum = PINSEL_PIN_5;
-    PINSEL_ConfigPin(&pin_cfg);
-
-    /* configuration for BATTERY_LED_PIN */
-    pin_cfg.Pinnum = PINSEL_PIN_6;
-    pin_cfg.Pinmode = PINSEL_PINMODE_PULLUP;
-    PINSEL_ConfigPin(&pin_cfg);
-
-    /* configuration for RELAY_2 */
-    pin_cfg.Portnum = PINSEL_PORT_1;
-    pin_cfg.Pinnum = PINSEL_PIN_0;
-    pin_cfg.Funcnum = PINSEL_FUNC_0;
-    pin_cfg.Pinmode = PINSEL_PINMODE_PULLUP;
-    pin_cfg.OpenDrain = PINSEL_PINMODE_NORMAL;
-    PINSEL_ConfigPin(&pin_cfg);
-
-    /* configuration for RELAY_1 */
-    pin_cfg.Pinnum = PINSEL_PIN_1;
-    PINSEL_ConfigPin(&pin_cfg);
-
-    /* configuration for LOW_BATTERY_PIN */
-    pin_cfg.Portnum = PINSEL_PORT_0;
-    pin_cfg.Pinnum = PINSEL_PIN_28;
-    pin_cfg.Funcnum = PINSEL_FUNC_0;
-    pin_cfg.Pinmode = PINSEL_PINMODE_PULLDOWN;
-    pin_cfg.OpenDrain = PINSEL_PINMODE_NORMAL;
-    PINSEL_ConfigPin(&pin_cfg);
-
-    /* configuration for MID_BATTERY_PIN */
-    pin_cfg.Pinnum = PINSEL_PIN_29;
-    PINSEL_ConfigPin(&pin_cfg);
-
-    /* configuration for MAX_BATTERY_PIN */
-    pin_cfg.Pinnum = PINSEL_PIN_30;
-    PINSEL_ConfigPin(&pin_cfg);
+    /* Pin map: port, pin, function, resistor mode, open drain */
+    static const PINSEL_CFG_Type pin_table[] = {
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_3, PINSEL_FUNC_0, PINSEL_PINMODE_PULLDOWN, PINSEL_PINMODE_NORMAL),  /* DOOR_BUTTON */
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_4, PINSEL_FUNC_0, PINSEL_PINMODE_PULLDOWN, PINSEL_PINMODE_NORMAL),  /* ENDSTOP_1 */
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_5, PINSEL_FUNC_0, PINSEL_PINMODE_PULLDOWN, PINSEL_PINMODE_NORMAL),  /* ENDSTOP_2 */
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_6, PINSEL_FUNC_0, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL),    /* BATTERY_LED */
+        PINSEL_CFG(PINSEL_PORT_1, PINSEL_PIN_0, PINSEL_FUNC_0, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL),    /* RELAY_2 */
+        PINSEL_CFG(PINSEL_PORT_1, PINSEL_PIN_1, PINSEL_FUNC_0, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL),    /* RELAY_1 */
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_28, PINSEL_FUNC_0, PINSEL_PINMODE_PULLDOWN, PINSEL_PINMODE_NORMAL), /* LOW_BATTERY_BUTTON */
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_29, PINSEL_FUNC_0, PINSEL_PINMODE_PULLDOWN, PINSEL_PINMODE_NORMAL), /* MID_BATTERY_BUTTON */
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_30, PINSEL_FUNC_0, PINSEL_PINMODE_PULLDOWN, PINSEL_PINMODE_NORMAL), /* MAX_BATTERY_BUTTON */
+    };
+
+    PINSEL_ConfigPins(pin_table, PINSEL_TABLE_SIZE(pin_table)); /* Each PINSEL/PINMODE register is written once */
 
     /* Set the pins as input or output */
     GPIO_SetDir(PINSEL_PORT_0, DOOR_BUTTON_PIN | ENDSTOP_1_PIN | ENDSTOP_2_PIN | LOW_BATTERY_BUTTON_PIN | MID_BATTERY_BUTTON_PIN | MAX_BATTERY_BUTTON_PIN, INPUT);
@@ -136,6 +102,16 @@ void configure_SysTick(void)
     SYSTICK_InternalInit(SYSTICK_TIME);
 }
 
+/**
+ * @brief Start the DWT cycle counter and name the profiling probes
+ *
+ */
+void configure_profiling(void)
+{
+    PROF_Init();
+    PROF_SetName(PROF_EINT3, "EINT3");
+}
+
 void start_interruptions(void)
 {
     NVIC_EnableIRQ(EINT3_IRQn);   /* Enable NVIC PORT 0 interrupts */
@@ -157,6 +133,8 @@ void start_SysTick(void)
  */
 void EINT3_IRQHandler(void)
 {
+    uint32_t prof_start = PROF_Start(); /* Handler duration probe */
+
     if (GPIO_GetIntStatus(PINSEL_PORT_0, DOOR_BUTTON_PIN, RISING_EDGE) == ENABLE)
     {
         toggle_door();
@@ -177,6 +155,8 @@ void EINT3_IRQHandler(void)
     {
         battery_level = MAX_BATTERY;
     }
+
+    PROF_Stop(PROF_EINT3, prof_start);
 }
 
 /**
@@ -190,7 +170,7 @@ void SysTick_Handler(void)
     systick_counter++;
     if (battery_level == MAX_BATTERY)
     {
-        GPIO_ClearValue(PINSEL_PORT_0, BATTERY_LED_PIN);
+        GPIO_FastClear(PINSEL_PORT_0, BATTERY_LED_PIN);
     }
     else if (battery_level == MID_BATTERY && systick_counter == 10)
     {
@@ -211,8 +191,8 @@ void SysTick_Handler(void)
  */
 void close_door(void)
 {
-    GPIO_ClearValue(PINSEL_PORT_0, RELAY_1_PIN);
-    GPIO_SetValue(PINSEL_PORT_0, RELAY_2_PIN);
+    GPIO_FastClear(PINSEL_PORT_1, RELAY_1_PIN);
+    GPIO_FastSet(PINSEL_PORT_1, RELAY_2_PIN);
 }
 
 /**
@@ -221,8 +201,8 @@ void close_door(void)
  */
 void open_door(void)
 {
-    GPIO_SetValue(PINSEL_PORT_0, RELAY_1_PIN);
-    GPIO_ClearValue(PINSEL_PORT_0, RELAY_2_PIN);
+    GPIO_FastSet(PINSEL_PORT_1, RELAY_1_PIN);
+    GPIO_FastClear(PINSEL_PORT_1, RELAY_2_PIN);
 }
 
 /**
@@ -232,8 +212,7 @@ void open_door(void)
  */
 void stop_motor(void)
 {
-    GPIO_SetValue(PINSEL_PORT_0, RELAY_1_PIN);
-    GPIO_SetValue(PINSEL_PORT_0, RELAY_1_PIN);
+    GPIO_FastSet(PINSEL_PORT_1, RELAY_1_PIN | RELAY_2_PIN);
 }
 
 /**
@@ -256,18 +235,12 @@ void toggle_door(void)
 
 /**
  * @brief Toggle the LED based in previous status
+ * A single store exclusive, so it can not undo a write from another interrupt
  *
  */
 void toggle_LED(void)
 {
-    if (GPIO_ReadValue(PINSEL_PORT_0) & BATTERY_LED_PIN)
-    {
-        GPIO_ClearValue(PINSEL_PORT_0, BATTERY_LED_PIN);
-    }
-    else
-    {
-        GPIO_SetValue(PINSEL_PORT_0, BATTERY_LED_PIN);
-    }
+    GPIO_PinToggle(PINSEL_PORT_0, PINSEL_PIN_6);
 }
 
 /**
@@ -278,6 +251,7 @@ void toggle_LED(void)
 int main(void)
 {
     SystemInit();           /* Initialize the system clock (default: 100 MHz) */
+    configure_profiling();  /* Start the profiling probes */
     configure_GPIO_ports(); /* Configure GPIO pins */
     configure_SysTick();    /* Configure SysTick */
     start_interruptions();  /* Enable interruptions */
@@ -277,6 +277,56 @@ extern "C"
     uint32_t ADC_GlobalGetData(LPC_ADC_TypeDef* ADCx);
     FlagStatus ADC_GlobalGetStatus(LPC_ADC_TypeDef* ADCx, uint32_t StatusType);
 
+/* Call site checks of the ADC arguments, e.g. the conversion rate of
+   ADC_Init() or a channel number (CHECK_PARAM_CALL, lpc_types.h) */
+#ifdef CHECK_PARAM_CALLS
+#define ADC_Init(ADCx, rate)                                                                                           \
+    (CHECK_PARAM_CALL(PARAM_ADCx((ADCx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_ADC_RATE((rate))),                                                                         \
+     ADC_Init(ADCx, rate))
+#define ADC_DeInit(ADCx)                                                                                               \
+    (CHECK_PARAM_CALL(PARAM_ADCx((ADCx))),                                                                             \
+     ADC_DeInit(ADCx))
+#define ADC_StartCmd(ADCx, start_mode)                                                                                 \
+    (CHECK_PARAM_CALL(PARAM_ADCx((ADCx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_ADC_START_OPT((start_mode))),                                                              \
+     ADC_StartCmd(ADCx, start_mode))
+#define ADC_BurstCmd(ADCx, NewState)                                                                                   \
+    (CHECK_PARAM_CALL(PARAM_ADCx((ADCx))),                                                                             \
+     ADC_BurstCmd(ADCx, NewState))
+#define ADC_PowerdownCmd(ADCx, NewState)                                                                               \
+    (CHECK_PARAM_CALL(PARAM_ADCx((ADCx))),                                                                             \
+     ADC_PowerdownCmd(ADCx, NewState))
+#define ADC_EdgeStartConfig(ADCx, EdgeOption)                                                                          \
+    (CHECK_PARAM_CALL(PARAM_ADCx((ADCx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_ADC_START_ON_EDGE_OPT((EdgeOption))),                                                      \
+     ADC_EdgeStartConfig(ADCx, EdgeOption))
+#define ADC_IntConfig(ADCx, IntType, NewState)                                                                         \
+    (CHECK_PARAM_CALL(PARAM_ADCx((ADCx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_ADC_TYPE_INT_OPT((IntType))),                                                              \
+     ADC_IntConfig(ADCx, IntType, NewState))
+#define ADC_ChannelCmd(ADCx, Channel, NewState)                                                                        \
+    (CHECK_PARAM_CALL(PARAM_ADCx((ADCx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_ADC_CHANNEL_SELECTION((Channel))),                                                         \
+     ADC_ChannelCmd(ADCx, Channel, NewState))
+#define ADC_ChannelGetData(ADCx, channel)                                                                              \
+    (CHECK_PARAM_CALL(PARAM_ADCx((ADCx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_ADC_CHANNEL_SELECTION((channel))),                                                         \
+     ADC_ChannelGetData(ADCx, channel))
+#define ADC_ChannelGetStatus(ADCx, channel, StatusType)                                                                \
+    (CHECK_PARAM_CALL(PARAM_ADCx((ADCx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_ADC_CHANNEL_SELECTION((channel))),                                                         \
+     CHECK_PARAM_CALL(PARAM_ADC_DATA_STATUS((StatusType))),                                                            \
+     ADC_ChannelGetStatus(ADCx, channel, StatusType))
+#define ADC_GlobalGetData(ADCx)                                                                                        \
+    (CHECK_PARAM_CALL(PARAM_ADCx((ADCx))),                                                                             \
+     ADC_GlobalGetData(ADCx))
+#define ADC_GlobalGetStatus(ADCx, StatusType)                                                                          \
+    (CHECK_PARAM_CALL(PARAM_ADCx((ADCx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_ADC_DATA_STATUS((StatusType))),                                                            \
+     ADC_GlobalGetStatus(ADCx, StatusType))
+#endif
+
     /**
      * @}
      */
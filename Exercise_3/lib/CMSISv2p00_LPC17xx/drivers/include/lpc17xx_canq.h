@@ -0,0 +1,167 @@
+/**********************************************************************
+ * $Id$		lpc17xx_canq.h				2010-05-21
+ *//**
+* @file		lpc17xx_canq.h
+* @brief	Contains the interrupt driven CAN frame queues for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup CANQ CANQ (Interrupt driven CAN frame queues)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_CANQ_H_
+#define LPC17XX_CANQ_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+#include "lpc17xx_can.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup CANQ_Public_Macros CANQ Public Macros
+ * @{
+ */
+
+/** Macro to check the receive ring size, a power of two */
+#define PARAM_CANQ_RX_SIZE(n) (((n) >= 2) && (((n) & ((n)-1)) == 0))
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup CANQ_Public_Types CANQ Public Types
+     * @{
+     */
+
+    /**
+     * @brief Frame counters of one identifier. Standard and extended frames with the
+     * same identifier value share the counters */
+    typedef struct
+    {
+        uint32_t Id;          /**< Identifier, set by the caller */
+        volatile uint32_t Rx; /**< Frames received */
+        volatile uint32_t Tx; /**< Frames sent */
+    } CANQ_COUNTER_Type;
+
+    /**
+     * @brief Transmit queue entry */
+    typedef struct
+    {
+        CAN_MSG_Type Msg; /**< Frame */
+        uint32_t Key;     /**< Arbitration value on the bus, the lowest is sent first */
+        uint32_t Seq;     /**< Submission order, keeps the frames of one identifier in order */
+    } CANQ_TX_ENTRY_Type;
+
+    /**
+     * @brief CAN frame queues configuration */
+    typedef struct
+    {
+        CAN_MSG_Type* RxBuffer;       /**< Receive ring storage */
+        uint32_t RxSize;              /**< Receive ring size in frames, a power of two */
+        CANQ_TX_ENTRY_Type* TxBuffer; /**< Transmit queue storage */
+        uint32_t TxSize;              /**< Transmit queue size in frames */
+        CANQ_COUNTER_Type* Counters;  /**< Identifiers to count, in ascending Id order, NULL for none */
+        uint32_t NumCounters;         /**< Number of entries of Counters */
+    } CANQ_CFG_Type;
+
+    /**
+     * @brief CAN frame queues state. The fields are private */
+    typedef struct
+    {
+        LPC_CAN_TypeDef* CANx;       /**< CAN peripheral */
+        CANQ_CFG_Type Cfg;           /**< Copy of the configuration */
+        volatile uint32_t RxHead;    /**< Frames ever received, moved by the interrupt */
+        volatile uint32_t RxTail;    /**< Frames ever read, moved by CANQ_Receive() */
+        uint32_t RxHighWater;        /**< Most frames ever held by the receive ring */
+        uint32_t TxCount;            /**< Frames in the transmit queue, a binary heap */
+        uint32_t TxSeq;              /**< Seq of the next queued frame */
+        uint32_t TxHighWater;        /**< Most frames ever waiting in the transmit queue */
+        uint8_t TxBusy;              /**< Bit n: transmit buffer n + 1 holds a frame */
+        uint32_t TxKey[3];           /**< Key of the frame in each transmit buffer */
+        uint32_t TxId[3];            /**< Identifier of the frame in each transmit buffer */
+        volatile uint32_t RxFrames;  /**< Frames received */
+        volatile uint32_t TxFrames;  /**< Frames sent */
+        volatile uint32_t RxDropped; /**< Frames lost to a full receive ring */
+        volatile uint32_t Overruns;  /**< Frames lost by the controller, the interrupt ran late */
+        volatile uint32_t Errors;    /**< Bus errors */
+    } CANQ_Type;
+
+    /**
+     * @brief CAN frame queues statistics */
+    typedef struct
+    {
+        uint32_t RxFrames;    /**< Frames received */
+        uint32_t TxFrames;    /**< Frames sent */
+        uint32_t RxDepth;     /**< Frames waiting in the receive ring */
+        uint32_t RxHighWater; /**< Most frames waiting in the receive ring */
+        uint32_t TxDepth;     /**< Frames waiting for a transmit buffer */
+        uint32_t TxHighWater; /**< Most frames waiting for a transmit buffer */
+        uint32_t RxDropped;   /**< Frames lost to a full receive ring */
+        uint32_t Overruns;    /**< Frames lost in the controller, before the ring */
+        uint32_t Errors;      /**< Bus errors */
+    } CANQ_STATS_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup CANQ_Public_Functions CANQ Public Functions
+     * @{
+     */
+
+    void CANQ_Init(CANQ_Type* canq, LPC_CAN_TypeDef* CANx, const CANQ_CFG_Type* cfg);
+    Status CANQ_Send(CANQ_Type* canq, const CAN_MSG_Type* msg);
+    Bool CANQ_Receive(CANQ_Type* canq, CAN_MSG_Type* msg);
+    uint32_t CANQ_GetRxCount(const CANQ_Type* canq);
+    CANQ_COUNTER_Type* CANQ_GetCounter(const CANQ_Type* canq, uint32_t id);
+    void CANQ_GetStats(const CANQ_Type* canq, CANQ_STATS_Type* stats);
+    void CANQ_IntHandler(CANQ_Type* canq);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_CANQ_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -104,6 +104,19 @@ extern "C"
 #define GPDMA_REQSEL_UART  ((0UL)) /**< UART TX/RX is selected */
 #define GPDMA_REQSEL_TIMER ((1UL)) /**< Timer match is selected */
 
+/** Number of linked list items in the descriptor pool, can be set from the
+ * compiler command line */
+#ifndef GPDMA_LLI_POOL_SIZE
+#define GPDMA_LLI_POOL_SIZE 16
+#endif
+
+/** GPDMA_LLI_Build() options */
+#define GPDMA_LLI_CIRCULAR    ((1UL << 0)) /**< Link the last item back to the first one */
+#define GPDMA_LLI_INT_SEGMENT ((1UL << 1)) /**< Terminal count interrupt at the end of every segment */
+
+/** Largest transfer size of one linked list item */
+#define GPDMA_LLI_MAX_TRANSFER 4095
+
 /**
  * @}
  */
@@ -406,6 +419,19 @@ extern "C"
         uint32_t Control; /**< GPDMA Control of this LLI */
     } GPDMA_LLI_Type;
 
+    /**
+     * @brief GPDMA transfer segment, one buffer of a scatter-gather chain
+     */
+    typedef struct
+    {
+        uint32_t SrcAddr; /**< Source address, 0 on a peripheral source takes the
+                               connection register */
+        uint32_t DstAddr; /**< Destination address, 0 on a peripheral destination
+                               takes the connection register */
+        uint32_t Size;    /**< Number of transfers, split into several items above
+                               GPDMA_LLI_MAX_TRANSFER */
+    } GPDMA_SEGMENT_Type;
+
     /**
      * @}
      */
@@ -421,6 +447,12 @@ extern "C"
     IntStatus GPDMA_IntGetStatus(GPDMA_Status_Type type, uint8_t channel);
     void GPDMA_ClearIntPending(GPDMA_StateClear_Type type, uint8_t channel);
     void GPDMA_ChannelCmd(uint8_t channelNum, FunctionalState NewState);
+    GPDMA_LLI_Type* GPDMA_LLI_Alloc(void);
+    void GPDMA_LLI_Free(GPDMA_LLI_Type* head);
+    uint32_t GPDMA_LLI_GetFree(void);
+    GPDMA_LLI_Type* GPDMA_LLI_Build(const GPDMA_Channel_CFG_Type* GPDMAChannelConfig, const GPDMA_SEGMENT_Type* segs,
+                                    uint32_t numSegs, uint32_t options);
+    Status GPDMA_SetupChain(const GPDMA_Channel_CFG_Type* GPDMAChannelConfig, const GPDMA_LLI_Type* head);
     // void GPDMA_IntHandler(void);
 
     /**
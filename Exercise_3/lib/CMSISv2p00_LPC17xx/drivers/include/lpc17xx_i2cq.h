@@ -0,0 +1,171 @@
+/**********************************************************************
+ * $Id$		lpc17xx_i2cq.h				2010-05-21
+ *//**
+* @file		lpc17xx_i2cq.h
+* @brief	Contains the interrupt driven I2C transaction queue for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup I2CQ I2CQ (Interrupt driven I2C transaction queue)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_I2CQ_H_
+#define LPC17XX_I2CQ_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+#include "lpc17xx_i2c.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup I2CQ_Public_Macros I2CQ Public Macros
+ * @{
+ */
+
+/** I2CQ_XFER_Type.Status: queued or on the bus */
+#define I2CQ_PENDING 0
+/** I2CQ_XFER_Type.Status: every byte transferred */
+#define I2CQ_DONE 1
+/** I2CQ_XFER_Type.Status: the slave did not acknowledge its address or a byte */
+#define I2CQ_NACK 2
+/** I2CQ_XFER_Type.Status: another master won the bus, nothing was sent after it */
+#define I2CQ_ARB_LOST 3
+/** I2CQ_XFER_Type.Status: illegal START or STOP seen on the bus */
+#define I2CQ_BUS_ERROR 4
+/** I2CQ_XFER_Type.Status: the transaction ran out of ticks and was stopped */
+#define I2CQ_TIMEOUT 5
+
+/** Macro to check a 7 bit slave address */
+#define PARAM_I2CQ_ADDR(n) ((n) <= 0x7F)
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup I2CQ_Public_Types I2CQ Public Types
+     * @{
+     */
+
+    struct I2CQ_XFER_Tag;
+
+    /**
+     * @brief Transaction completion callback. Runs in the I2C interrupt, or in the
+     * tick on a timeout, the buffers and the descriptor belong to the caller again */
+    typedef void (*I2CQ_CALLBACK_Type)(struct I2CQ_XFER_Tag* xfer);
+
+    /**
+     * @brief Transaction descriptor, owned by the caller. The bytes of TxData are
+     * written first, then RxLength bytes are read after a repeated START, so a
+     * register read is a single transaction. Neither buffer may change until the
+     * callback has run */
+    typedef struct I2CQ_XFER_Tag
+    {
+        uint8_t SlaveAddr;           /**< 7 bit slave address */
+        const uint8_t* TxData;       /**< Bytes written */
+        uint32_t TxLength;           /**< Number of bytes written, 0 for a read only transaction */
+        uint8_t* RxData;             /**< Bytes read */
+        uint32_t RxLength;           /**< Number of bytes read, 0 for a write only transaction.
+                                          With both lengths 0 the slave is only addressed */
+        uint32_t Timeout;            /**< I2CQ_Tick() calls the transaction may last once on
+                                          the bus, 0 for no limit */
+        I2CQ_CALLBACK_Type Callback; /**< Called when done, NULL for none */
+        void* Arg;                   /**< Free for the caller */
+        volatile uint8_t Status;     /**< I2CQ_PENDING, then the outcome, I2CQ_DONE... */
+        uint32_t TxCount;            /**< Bytes written and acknowledged */
+        uint32_t RxCount;            /**< Bytes read */
+        struct I2CQ_XFER_Tag* Next;  /**< Private, queue link */
+    } I2CQ_XFER_Type;
+
+    /**
+     * @brief I2C transaction queue state. The fields are private */
+    typedef struct
+    {
+        LPC_I2C_TypeDef* I2Cx;    /**< I2C peripheral */
+        I2CQ_XFER_Type* Head;     /**< Transaction on the bus, NULL when idle */
+        I2CQ_XFER_Type* Tail;     /**< Last queued transaction */
+        uint32_t Remaining;       /**< Ticks left to Head, 0 for no limit */
+        volatile uint8_t Busy;    /**< The interrupt owns the queue, I2CQ_Submit() only appends */
+        uint32_t Depth;           /**< Transactions in the queue */
+        uint32_t MaxDepth;        /**< Most transactions ever queued */
+        uint32_t Transfers;       /**< Transactions completed with I2CQ_DONE */
+        uint32_t Bytes;           /**< Bytes written and read */
+        uint32_t Nacks;           /**< Transactions ended by I2CQ_NACK */
+        uint32_t Timeouts;        /**< Transactions ended by I2CQ_TIMEOUT */
+        uint32_t Errors;          /**< Transactions ended by I2CQ_ARB_LOST or I2CQ_BUS_ERROR */
+    } I2CQ_Type;
+
+    /**
+     * @brief I2C transaction queue statistics */
+    typedef struct
+    {
+        uint32_t Transfers; /**< Transactions completed */
+        uint32_t Bytes;     /**< Bytes written and read */
+        uint32_t MaxDepth;  /**< Most transactions waiting in the queue */
+        uint32_t Nacks;     /**< Transactions not acknowledged */
+        uint32_t Timeouts;  /**< Transactions stopped by their timeout */
+        uint32_t Errors;    /**< Arbitration losses and bus errors */
+    } I2CQ_STATS_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup I2CQ_Public_Functions I2CQ Public Functions
+     * @{
+     */
+
+    void I2CQ_Init(I2CQ_Type* i2cq, LPC_I2C_TypeDef* I2Cx);
+    void I2CQ_Submit(I2CQ_Type* i2cq, I2CQ_XFER_Type* xfer);
+    void I2CQ_Tick(I2CQ_Type* i2cq);
+    Bool I2CQ_IsIdle(const I2CQ_Type* i2cq);
+    void I2CQ_GetStats(const I2CQ_Type* i2cq, I2CQ_STATS_Type* stats);
+    void I2CQ_IntHandler(I2CQ_Type* i2cq);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_I2CQ_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
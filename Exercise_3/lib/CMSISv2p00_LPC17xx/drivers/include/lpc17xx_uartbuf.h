@@ -0,0 +1,144 @@
+/**********************************************************************
+ * $Id$		lpc17xx_uartbuf.h				2010-05-21
+ *//**
+* @file		lpc17xx_uartbuf.h
+* @brief	Contains the interrupt driven ring buffered UART for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup UARTBUF UARTBUF (Interrupt driven ring buffered UART)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_UARTBUF_H_
+#define LPC17XX_UARTBUF_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+#include "lpc17xx_uart.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup UARTBUF_Public_Macros UARTBUF Public Macros
+ * @{
+ */
+
+/** Macro to check a ring size, a power of two */
+#define PARAM_UARTBUF_SIZE(n) (((n) >= 2) && (((n) & ((n)-1)) == 0))
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup UARTBUF_Public_Types UARTBUF Public Types
+     * @{
+     */
+
+    /**
+     * @brief Ring buffered UART configuration */
+    typedef struct
+    {
+        uint8_t* TxBuffer; /**< Transmit ring storage */
+        uint32_t TxSize;   /**< Transmit ring size in bytes, a power of two */
+        uint8_t* RxBuffer; /**< Receive ring storage */
+        uint32_t RxSize;   /**< Receive ring size in bytes, a power of two */
+    } UARTBUF_CFG_Type;
+
+    /**
+     * @brief Single producer, single consumer byte ring. Head and Tail count bytes
+     * and wrap at 2^32, each is written by one side only so no lock is needed */
+    typedef struct
+    {
+        uint8_t* Data;          /**< Storage */
+        uint32_t Mask;          /**< Size - 1 */
+        volatile uint32_t Head; /**< Bytes ever written, moved by the producer */
+        volatile uint32_t Tail; /**< Bytes ever read, moved by the consumer */
+        uint32_t HighWater;     /**< Most bytes ever held, updated by the producer */
+    } UARTBUF_RING_Type;
+
+    /**
+     * @brief Ring buffered UART state. The fields are private */
+    typedef struct
+    {
+        LPC_UART_TypeDef* UARTx;   /**< UART peripheral */
+        UARTBUF_RING_Type Tx;      /**< Filled by UARTBUF_Write(), drained by the interrupt */
+        UARTBUF_RING_Type Rx;      /**< Filled by the interrupt, drained by UARTBUF_Read() */
+        volatile uint8_t TxBusy;   /**< THRE interrupt expected, the transmitter needs no kick */
+        volatile uint32_t Dropped; /**< Bytes received with the receive ring full */
+        volatile uint32_t Errors;  /**< Overrun, parity, framing and break events */
+    } UARTBUF_Type;
+
+    /**
+     * @brief Ring buffered UART statistics */
+    typedef struct
+    {
+        uint32_t TxHighWater; /**< Most bytes waiting in the transmit ring */
+        uint32_t RxHighWater; /**< Most bytes waiting in the receive ring */
+        uint32_t Dropped;     /**< Bytes lost to a full receive ring */
+        uint32_t Errors;      /**< Line status errors, a hardware overrun counts once */
+    } UARTBUF_STATS_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup UARTBUF_Public_Functions UARTBUF Public Functions
+     * @{
+     */
+
+    void UARTBUF_Init(UARTBUF_Type* ub, LPC_UART_TypeDef* UARTx, const UARTBUF_CFG_Type* cfg);
+    void UARTBUF_DeInit(UARTBUF_Type* ub);
+    uint32_t UARTBUF_Write(UARTBUF_Type* ub, const uint8_t* data, uint32_t len);
+    uint32_t UARTBUF_Read(UARTBUF_Type* ub, uint8_t* data, uint32_t len);
+    uint32_t UARTBUF_GetTxFree(const UARTBUF_Type* ub);
+    uint32_t UARTBUF_GetRxCount(const UARTBUF_Type* ub);
+    void UARTBUF_GetStats(const UARTBUF_Type* ub, UARTBUF_STATS_Type* stats);
+    void UARTBUF_IntHandler(UARTBUF_Type* ub);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_UARTBUF_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -0,0 +1,129 @@
+/**********************************************************************
+ * $Id$		lpc17xx_wavegen.h				2010-05-21
+ *//**
+* @file		lpc17xx_wavegen.h
+* @brief	Contains the DAC waveform generator through GPDMA for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup WAVEGEN WAVEGEN (DAC waveform generator through GPDMA)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_WAVEGEN_H_
+#define LPC17XX_WAVEGEN_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+#include "lpc17xx_dac.h"
+#include "lpc17xx_gpdma.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup WAVEGEN_Public_Macros WAVEGEN Public Macros
+ * @{
+ */
+
+/** Highest sample rate, set by the 1 us settling time of the DAC */
+#define WAVEGEN_MAX_RATE 1000000
+
+/** Table entry for a 10-bit DAC code, the DMA writes entries to DACR as they are */
+#define WAVEGEN_SAMPLE(n) DAC_VALUE(n)
+
+/** Highest DAC code */
+#define WAVEGEN_MAX_CODE 1023
+
+/** Macro to check the sample rate */
+#define PARAM_WAVEGEN_RATE(n) (((n) >= 1) && ((n) <= WAVEGEN_MAX_RATE))
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup WAVEGEN_Public_Types WAVEGEN Public Types
+     * @{
+     */
+
+    /**
+     * @brief Waveform generator configuration */
+    typedef struct
+    {
+        uint32_t Rate;      /**< Sample rate in Hz, 1 to WAVEGEN_MAX_RATE. The DAC counter
+                                 runs from PCLK_DAC, so the slowest rate is PCLK_DAC / 65535 */
+        uint8_t DMAChannel; /**< GPDMA channel, 0 to 7, owned by the generator */
+    } WAVEGEN_CFG_Type;
+
+    /**
+     * @brief Waveform generator state. The fields are private */
+    typedef struct
+    {
+        WAVEGEN_CFG_Type Cfg;    /**< Copy of the configuration */
+        GPDMA_LLI_Type* Chain;   /**< Circular chain over the table being played */
+        GPDMA_LLI_Type* Pending; /**< Chain of the next table, linked after the current pass */
+    } WAVEGEN_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup WAVEGEN_Public_Functions WAVEGEN Public Functions
+     * @{
+     */
+
+    void WAVEGEN_FillSine(uint32_t* table, uint32_t size, uint16_t amplitude, uint16_t offset);
+    void WAVEGEN_FillTriangle(uint32_t* table, uint32_t size, uint16_t amplitude, uint16_t offset);
+    void WAVEGEN_FillTable(uint32_t* table, const uint16_t* codes, uint32_t size);
+    Status WAVEGEN_Init(WAVEGEN_Type* gen, const WAVEGEN_CFG_Type* cfg);
+    Status WAVEGEN_Start(WAVEGEN_Type* gen, const uint32_t* table, uint32_t size);
+    void WAVEGEN_Stop(WAVEGEN_Type* gen);
+    Status WAVEGEN_SetTable(WAVEGEN_Type* gen, const uint32_t* table, uint32_t size);
+    Bool WAVEGEN_IsSwapPending(const WAVEGEN_Type* gen);
+    Bool WAVEGEN_IntHandler(WAVEGEN_Type* gen);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_WAVEGEN_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
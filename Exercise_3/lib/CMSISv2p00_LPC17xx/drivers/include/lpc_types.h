@@ -165,6 +165,50 @@ typedef int32_t (*PFI)();
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #endif
 
+/* ADDR32(p) is the 32-bit bus address of object p, as written to peripheral
+ * registers, DMA linked list items and EMAC descriptors; PTR32(a) is the object
+ * at bus address a. In the host build the object must lie below 4 GB, in the
+ * static data or the brk heap of the -no-pie program but not on the stack, and
+ * SIM_Addr32() stops the program when it does not.
+ */
+#ifdef __USE_HOST_SIM
+extern uint32_t SIM_Addr32(const volatile void* p);
+#define ADDR32(p) SIM_Addr32(p)
+#else
+#define ADDR32(p) ((uint32_t)(uintptr_t)(p))
+#endif
+#define PTR32(a) ((void*)(uintptr_t)(a))
+
+/* HWREG_READ(reg) and HWREG_WRITE(reg, value) access a peripheral register on
+ * the hot paths of the drivers, polling loops and inline pin functions. On the
+ * target they are plain accesses. In the host build they call the simulator
+ * directly instead of trapping the access, several times faster: about 2
+ * million accesses per second, a plain access about 300 thousand.
+ */
+#ifdef __USE_HOST_SIM
+extern uint32_t SIM_Read(uint32_t addr, uint8_t size);
+extern void SIM_Write(uint32_t addr, uint32_t value, uint8_t size);
+#define HWREG_READ(reg)         SIM_Read((uint32_t)(uintptr_t)&(reg), sizeof(reg))
+#define HWREG_WRITE(reg, value) SIM_Write((uint32_t)(uintptr_t)&(reg), (value), sizeof(reg))
+#else
+#define HWREG_READ(reg)         (reg)
+#define HWREG_WRITE(reg, value) ((reg) = (value))
+#endif
+
+/* CHECK_PARAM_CALL(expr) checks a parameter of a driver entry point in the
+ * caller's translation unit, where a constant argument is visible to the
+ * compiler; inside the library the parameter is a variable. The timer, ADC and
+ * CAN headers wrap their entry points in macros of the same name built on it.
+ * Only in the release profile (LIBCFG_RELEASE) of an optimizing GCC build, and
+ * not in the library sources (LIBCFG_LIBRARY, set by the drivers Makefile). A
+ * false constant expr stops the build, expr is never evaluated at run time.
+ */
+#if defined(LIBCFG_RELEASE) && defined(__GNUC__) && defined(__OPTIMIZE__) && !defined(LIBCFG_LIBRARY)
+#define CHECK_PARAM_CALLS
+extern void check_failed_const(void) __attribute__((error("CHECK_PARAM failed on a constant parameter")));
+#define CHECK_PARAM_CALL(expr) ((__builtin_constant_p(expr) && !(expr)) ? check_failed_const() : (void)0)
+#endif
+
 /**
  * @}
  */
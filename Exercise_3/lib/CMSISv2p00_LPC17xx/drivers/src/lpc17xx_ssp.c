@@ -412,10 +412,10 @@ uint16_t SSP_ReceiveData(LPC_SSP_TypeDef* SSPx)
                                                                          ***********************************************************************/
 int32_t SSP_ReadWrite(LPC_SSP_TypeDef* SSPx, SSP_DATA_SETUP_Type* dataCfg, SSP_TRANSFER_Type xfType)
 {
-    uint8_t* rdata8;
-    uint8_t* wdata8;
-    uint16_t* rdata16;
-    uint16_t* wdata16;
+    uint8_t* rdata8 = NULL;
+    uint8_t* wdata8 = NULL;
+    uint16_t* rdata16 = NULL;
+    uint16_t* wdata16 = NULL;
     uint32_t stat;
     uint32_t tmp;
     int32_t dataword;
@@ -566,12 +566,12 @@ int32_t SSP_ReadWrite(LPC_SSP_TypeDef* SSPx, SSP_DATA_SETUP_Type* dataCfg, SSP_T
             {
                 if (dataword == 0)
                 {
-                    SSP_SendData(SSPx, (*(uint8_t*)((uint32_t)dataCfg->tx_data + dataCfg->tx_cnt)));
+                    SSP_SendData(SSPx, (*(uint8_t*)((uintptr_t)dataCfg->tx_data + dataCfg->tx_cnt)));
                     dataCfg->tx_cnt++;
                 }
                 else
                 {
-                    SSP_SendData(SSPx, (*(uint16_t*)((uint32_t)dataCfg->tx_data + dataCfg->tx_cnt)));
+                    SSP_SendData(SSPx, (*(uint16_t*)((uintptr_t)dataCfg->tx_data + dataCfg->tx_cnt)));
                     dataCfg->tx_cnt += 2;
                 }
             }
@@ -595,11 +595,11 @@ int32_t SSP_ReadWrite(LPC_SSP_TypeDef* SSPx, SSP_DATA_SETUP_Type* dataCfg, SSP_T
                 {
                     if (dataword == 0)
                     {
-                        *(uint8_t*)((uint32_t)dataCfg->rx_data + dataCfg->rx_cnt) = (uint8_t)tmp;
+                        *(uint8_t*)((uintptr_t)dataCfg->rx_data + dataCfg->rx_cnt) = (uint8_t)tmp;
                     }
                     else
                     {
-                        *(uint16_t*)((uint32_t)dataCfg->rx_data + dataCfg->rx_cnt) = (uint16_t)tmp;
+                        *(uint16_t*)((uintptr_t)dataCfg->rx_data + dataCfg->rx_cnt) = (uint16_t)tmp;
                     }
                 }
                 // Increase counter
@@ -0,0 +1,566 @@
+/**********************************************************************
+ * $Id$		lpc17xx_stdio.c				2010-05-21
+ *//**
+* @file		lpc17xx_stdio.c
+* @brief	Contains all functions support for the buffered console transport behind the newlib stubs on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup STDIO
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_stdio.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _STDIO
+
+#ifdef __USE_HOST_SIM
+#include <unistd.h>
+#endif
+
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup STDIO_Private_Macros STDIO Private Macros
+ * @{
+ */
+
+/** Index mask of the output buffer */
+#define STDIO_MASK (STDIO_BUFFER_SIZE - 1)
+
+/** Semihosting operations */
+#define STDIO_SYS_OPEN  0x01
+#define STDIO_SYS_WRITE 0x05
+#define STDIO_SYS_READ  0x06
+
+/** Semihosting open modes of the ":tt" console, "r" and "w" */
+#define STDIO_SYS_MODE_R 0
+#define STDIO_SYS_MODE_W 4
+
+/**
+ * @}
+ */
+
+/* Private Variables ---------------------------------------------------------- */
+/** @defgroup STDIO_Private_Variables STDIO Private Variables
+ * @{
+ */
+
+STDIO_TRACE_Type STDIO_Trace;
+
+/** Output buffer. Head is moved by the writers, Tail by whoever hands the bytes
+ * to the transport, both count bytes and wrap at 2^32 */
+static uint8_t stdio_buffer[STDIO_BUFFER_SIZE];
+static volatile uint32_t stdio_head;
+static volatile uint32_t stdio_tail;
+
+static STDIO_TRANSPORT_Type stdio_transport;
+static Bool stdio_ready;
+static STDIO_STATS_Type stdio_stats;
+
+/** Semihosting console handles, read and write */
+static int stdio_sys_handle[2];
+
+/**
+ * @}
+ */
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup STDIO_Private_Functions STDIO Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Tell whether the caller is an exception handler
+                                                                         * @param[in]	None
+                                                                         * @return		TRUE in an interrupt
+                                                                         **********************************************************************/
+static Bool stdio_in_irq(void)
+{
+    return (__get_IPSR() & 0x1FF) ? TRUE : FALSE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Hand buffered bytes to the transport, a contiguous run per
+                                                                         * call. A halting transport is only called from thread code and
+                                                                         * with interrupts enabled, interrupts can still append behind it.
+                                                                         * Other transports are called with interrupts disabled so that
+                                                                         * any context can drain
+                                                                         * @param[in]	wait	Keep calling until the buffer is empty
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void stdio_drain(Bool wait)
+{
+    uint32_t primask, used, idx, n;
+
+    for (;;)
+    {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        used = stdio_head - stdio_tail;
+        if (used == 0)
+        {
+            __set_PRIMASK(primask);
+            return;
+        }
+        idx = stdio_tail & STDIO_MASK;
+        if (used > STDIO_BUFFER_SIZE - idx)
+        {
+            used = STDIO_BUFFER_SIZE - idx;
+        }
+        stdio_stats.Flushes++;
+        if (stdio_transport.Halts)
+        {
+            __set_PRIMASK(primask);
+            n = stdio_transport.Write(stdio_transport.Arg, &stdio_buffer[idx], used);
+            stdio_tail += n;
+        }
+        else
+        {
+            n = stdio_transport.Write(stdio_transport.Arg, &stdio_buffer[idx], used);
+            stdio_tail += n;
+            __set_PRIMASK(primask);
+        }
+
+        if ((n == 0) && !wait)
+        {
+            return;
+        }
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Copy bytes into the output buffer, as many as fit
+                                                                         * @param[in]	data	Bytes
+                                                                         * @param[in]	len		Number of bytes
+                                                                         * @return		Number of bytes copied
+                                                                         **********************************************************************/
+static uint32_t stdio_put(const uint8_t* data, uint32_t len)
+{
+    uint32_t primask, used, n, i;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    used = stdio_head - stdio_tail;
+    n = STDIO_BUFFER_SIZE - used;
+    if (n > len)
+    {
+        n = len;
+    }
+    for (i = 0; i < n; i++)
+    {
+        stdio_buffer[(stdio_head + i) & STDIO_MASK] = data[i];
+    }
+    stdio_head += n;
+    if (used + n > stdio_stats.HighWater)
+    {
+        stdio_stats.HighWater = used + n;
+    }
+    __set_PRIMASK(primask);
+    return n;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		UARTBUF transport output
+                                                                         * @param[in]	arg		Ring buffered UART
+                                                                         * @param[in]	data	Bytes
+                                                                         * @param[in]	len		Number of bytes
+                                                                         * @return		Number of bytes taken
+                                                                         **********************************************************************/
+static uint32_t stdio_uartbuf_write(void* arg, const uint8_t* data, uint32_t len)
+{
+    return UARTBUF_Write((UARTBUF_Type*)arg, data, len);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		UARTBUF transport input
+                                                                         * @param[in]	arg		Ring buffered UART
+                                                                         * @param[out]	data	Destination
+                                                                         * @param[in]	len		Room in the destination
+                                                                         * @return		Number of bytes read
+                                                                         **********************************************************************/
+static uint32_t stdio_uartbuf_read(void* arg, uint8_t* data, uint32_t len)
+{
+    return UARTBUF_Read((UARTBUF_Type*)arg, data, len);
+}
+
+#ifdef __USE_HOST_SIM
+/*********************************************************************/ /**
+                                                                         * @brief		Semihosting call. On the host the process console plays the
+                                                                         * debugger console, only the calls used here are served
+                                                                         * @param[in]	op		Operation
+                                                                         * @param[in]	args	Argument block, pointer sized words (32 bits on the target)
+                                                                         * @return		Result of the operation
+                                                                         **********************************************************************/
+static int stdio_sys_call(int op, uintptr_t* args)
+{
+    ssize_t n;
+
+    switch (op)
+    {
+        case STDIO_SYS_OPEN: return (args[1] == STDIO_SYS_MODE_R) ? STDIN_FILENO : STDOUT_FILENO;
+        case STDIO_SYS_WRITE:
+            n = write((int)args[0], (const void*)args[1], args[2]);
+            return (int)(args[2] - ((n > 0) ? (uint32_t)n : 0));
+        case STDIO_SYS_READ:
+            n = read((int)args[0], (void*)args[1], args[2]);
+            return (int)(args[2] - ((n > 0) ? (uint32_t)n : 0));
+        default: return -1;
+    }
+}
+#else
+/*********************************************************************/ /**
+                                                                         * @brief		Semihosting call, served by the attached debugger
+                                                                         * @param[in]	op		Operation
+                                                                         * @param[in]	args	Argument block, pointer sized words (32 bits on the target)
+                                                                         * @return		Result of the operation
+                                                                         **********************************************************************/
+static int stdio_sys_call(int op, uintptr_t* args)
+{
+    register int r0 __ASM("r0") = op;
+    register uintptr_t* r1 __ASM("r1") = args;
+
+    __ASM volatile("bkpt 0xAB" : "+r"(r0) : "r"(r1) : "memory");
+    return r0;
+}
+#endif
+
+/*********************************************************************/ /**
+                                                                         * @brief		Semihosting transport output, SYS_WRITE on the console
+                                                                         * @param[in]	arg		Unused
+                                                                         * @param[in]	data	Bytes
+                                                                         * @param[in]	len		Number of bytes
+                                                                         * @return		Number of bytes taken
+                                                                         **********************************************************************/
+static uint32_t stdio_sys_write(void* arg, const uint8_t* data, uint32_t len)
+{
+    uintptr_t args[3];
+
+    args[0] = (uintptr_t)stdio_sys_handle[1];
+    args[1] = (uintptr_t)data;
+    args[2] = len;
+    /* The call returns the number of bytes not written */
+    return len - (uint32_t)stdio_sys_call(STDIO_SYS_WRITE, args);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Semihosting transport input, SYS_READ on the console. Waits
+                                                                         * for the debugger to deliver a line
+                                                                         * @param[in]	arg		Unused
+                                                                         * @param[out]	data	Destination
+                                                                         * @param[in]	len		Room in the destination
+                                                                         * @return		Number of bytes read
+                                                                         **********************************************************************/
+static uint32_t stdio_sys_read(void* arg, uint8_t* data, uint32_t len)
+{
+    uintptr_t args[3];
+
+    args[0] = (uintptr_t)stdio_sys_handle[0];
+    args[1] = (uintptr_t)data;
+    args[2] = len;
+    return len - (uint32_t)stdio_sys_call(STDIO_SYS_READ, args);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Trace transport output, never full: the oldest bytes are
+                                                                         * overwritten
+                                                                         * @param[in]	arg		Trace buffer
+                                                                         * @param[in]	data	Bytes
+                                                                         * @param[in]	len		Number of bytes
+                                                                         * @return		len
+                                                                         **********************************************************************/
+static uint32_t stdio_trace_write(void* arg, const uint8_t* data, uint32_t len)
+{
+    STDIO_TRACE_Type* trace = (STDIO_TRACE_Type*)arg;
+    uint32_t head = trace->Head;
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        trace->Data[(head + i) & (STDIO_TRACE_SIZE - 1)] = data[i];
+    }
+    trace->Head = head + len;
+    return len;
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup STDIO_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Select the console transport and empty the output buffer
+                                                                         * @param[in]	transport	Transport, copied. NULL discards the
+                                                                         * output, as before any call
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void STDIO_Init(const STDIO_TRANSPORT_Type* transport)
+{
+    CHECK_PARAM(PARAM_STDIO_SIZE(STDIO_BUFFER_SIZE));
+    CHECK_PARAM((transport == NULL) || (transport->Write != NULL));
+
+    stdio_ready = FALSE;
+    stdio_head = 0;
+    stdio_tail = 0;
+    stdio_stats.Bytes = 0;
+    stdio_stats.Flushes = 0;
+    stdio_stats.Dropped = 0;
+    stdio_stats.HighWater = 0;
+    if (transport != NULL)
+    {
+        stdio_transport = *transport;
+        stdio_ready = TRUE;
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Console output, the body of _write() for stdout and stderr.
+                                                                         * The bytes are buffered. A transport that does not halt is handed
+                                                                         * them at once, as far as it takes them. A halting one gets the
+                                                                         * whole buffer when it is full, at the end of a line and on
+                                                                         * STDIO_Flush()
+                                                                         * @param[in]	data	Bytes
+                                                                         * @param[in]	len		Number of bytes
+                                                                         * @return		len
+                                                                         * @note		Thread code waits for room in a full buffer. An interrupt
+                                                                         * never waits: what does not fit is dropped and counted, and a
+                                                                         * halting transport is left to the next thread call
+                                                                         **********************************************************************/
+int STDIO_Write(const char* data, int len)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    Bool irq = stdio_in_irq();
+    Bool eol = FALSE;
+    uint32_t left, n, i;
+
+    if (len <= 0)
+    {
+        return 0;
+    }
+    if (!stdio_ready)
+    {
+        stdio_stats.Dropped += len;
+        return len;
+    }
+    stdio_stats.Bytes += len;
+
+    for (i = 0; i < (uint32_t)len; i++)
+    {
+        if (p[i] == '\n')
+        {
+            eol = TRUE;
+            break;
+        }
+    }
+
+    left = len;
+    for (;;)
+    {
+        n = stdio_put(p, left);
+        p += n;
+        left -= n;
+        if (left == 0)
+        {
+            break;
+        }
+
+        /* Buffer full */
+        if (!irq)
+        {
+            stdio_drain(TRUE);
+        }
+        else if (!stdio_transport.Halts && (n != 0))
+        {
+            stdio_drain(FALSE);
+        }
+        else
+        {
+            stdio_stats.Dropped += left;
+            break;
+        }
+    }
+
+    if (!stdio_transport.Halts)
+    {
+        stdio_drain(FALSE);
+    }
+    else if (!irq && eol)
+    {
+        stdio_drain(TRUE);
+    }
+    return len;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Console input, the body of _read() for stdin. Pending output
+                                                                         * is flushed first so that a prompt shows
+                                                                         * @param[out]	data	Destination
+                                                                         * @param[in]	len		Room in the destination
+                                                                         * @return		Number of bytes read, 0 at end of input
+                                                                         * @note		Thread code waits for at least one byte, an interrupt only
+                                                                         * gets what is already received. A transport without input reads
+                                                                         * as end of input
+                                                                         **********************************************************************/
+int STDIO_Read(char* data, int len)
+{
+    Bool irq = stdio_in_irq();
+    uint32_t n;
+
+    if ((len <= 0) || !stdio_ready || (stdio_transport.Read == NULL))
+    {
+        return 0;
+    }
+    if (irq && stdio_transport.Halts)
+    {
+        return 0;
+    }
+
+    STDIO_Flush();
+    do
+    {
+        n = stdio_transport.Read(stdio_transport.Arg, (uint8_t*)data, len);
+    } while ((n == 0) && !irq && !stdio_transport.Halts);
+    return n;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Hand all buffered output to the transport. From an interrupt
+                                                                         * only what a transport that does not halt takes at once
+                                                                         * @param[in]	None
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void STDIO_Flush(void)
+{
+    if (!stdio_ready)
+    {
+        return;
+    }
+    if (!stdio_in_irq())
+    {
+        stdio_drain(TRUE);
+    }
+    else if (!stdio_transport.Halts)
+    {
+        stdio_drain(FALSE);
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the console statistics
+                                                                         * @param[out]	stats	Statistics since STDIO_Init()
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void STDIO_GetStats(STDIO_STATS_Type* stats)
+{
+    *stats = stdio_stats;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Fill a transport on a ring buffered UART, output and input
+                                                                         * @param[out]	transport	Transport
+                                                                         * @param[in]	ub			Ring buffered UART, set up with
+                                                                         * UARTBUF_Init() and its interrupt enabled
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void STDIO_TransportUARTBUF(STDIO_TRANSPORT_Type* transport, UARTBUF_Type* ub)
+{
+    transport->Write = stdio_uartbuf_write;
+    transport->Read = stdio_uartbuf_read;
+    transport->Arg = ub;
+    transport->Halts = FALSE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Fill a transport on the semihosting console of the debugger,
+                                                                         * output and input. Opens the console, so call it from thread
+                                                                         * code with the debugger attached
+                                                                         * @param[out]	transport	Transport
+                                                                         * @return		None
+                                                                         * @note		Without a debugger the BKPT of the first call faults. On
+                                                                         * the host the calls go to the process stdin and stdout
+                                                                         **********************************************************************/
+void STDIO_TransportSemihost(STDIO_TRANSPORT_Type* transport)
+{
+    uintptr_t args[3];
+
+    args[0] = (uintptr_t)":tt";
+    args[2] = 3;
+    args[1] = STDIO_SYS_MODE_R;
+    stdio_sys_handle[0] = stdio_sys_call(STDIO_SYS_OPEN, args);
+    args[1] = STDIO_SYS_MODE_W;
+    stdio_sys_handle[1] = stdio_sys_call(STDIO_SYS_OPEN, args);
+
+    transport->Write = stdio_sys_write;
+    transport->Read = stdio_sys_read;
+    transport->Arg = NULL;
+    transport->Halts = TRUE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Fill a transport on STDIO_Trace, output only. The buffer is
+                                                                         * cleared and tagged with STDIO_TRACE_MAGIC
+                                                                         * @param[out]	transport	Transport
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void STDIO_TransportTrace(STDIO_TRANSPORT_Type* transport)
+{
+    CHECK_PARAM(PARAM_STDIO_SIZE(STDIO_TRACE_SIZE));
+
+    STDIO_Trace.Magic = STDIO_TRACE_MAGIC;
+    STDIO_Trace.Size = STDIO_TRACE_SIZE;
+    STDIO_Trace.Head = 0;
+
+    transport->Write = stdio_trace_write;
+    transport->Read = NULL;
+    transport->Arg = &STDIO_Trace;
+    transport->Halts = FALSE;
+}
+
+/**
+ * @}
+ */
+
+#endif /* _STDIO */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -0,0 +1,501 @@
+/**********************************************************************
+ * $Id$		lpc17xx_uartdma.c				2010-05-21
+ *//**
+* @file		lpc17xx_uartdma.c
+* @brief	Contains all functions support for the GPDMA driven UART on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup UARTDMA
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include <string.h>
+#include "lpc17xx_uartdma.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _UARTDMA
+
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup UARTDMA_Private_Macros UARTDMA Private Macros
+ * @{
+ */
+
+/** GPDMA channel registers of channel n */
+#define UARTDMA_DMACH(n) ((LPC_GPDMACH_TypeDef*)(LPC_GPDMACH0_BASE + ((uint32_t)(n) << 5)))
+
+/**
+ * @}
+ */
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup UARTDMA_Private_Functions UARTDMA Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Fill the GPDMA channel configuration of one direction
+                                                                         * @param[in]	ud		GPDMA driven UART
+                                                                         * @param[in]	type	GPDMA_TRANSFERTYPE_M2P to transmit, GPDMA_TRANSFERTYPE_P2M
+                                                                         * to receive
+                                                                         * @param[out]	dma_cfg	Channel configuration
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void uartdma_dma_cfg(const UARTDMA_Type* ud, uint32_t type, GPDMA_Channel_CFG_Type* dma_cfg)
+{
+    dma_cfg->ChannelNum = (type == GPDMA_TRANSFERTYPE_M2P) ? ud->Cfg.TxChannel : ud->Cfg.RxChannel;
+    dma_cfg->TransferSize = 0;
+    dma_cfg->TransferWidth = 0;
+    dma_cfg->SrcMemAddr = 0;
+    dma_cfg->DstMemAddr = 0;
+    dma_cfg->TransferType = type;
+    dma_cfg->SrcConn = (type == GPDMA_TRANSFERTYPE_P2M) ? ud->RxConn : 0;
+    dma_cfg->DstConn = (type == GPDMA_TRANSFERTYPE_M2P) ? ud->TxConn : 0;
+    dma_cfg->DMALLI = 0;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Give the next piece of the transmit queue to the DMA, and
+                                                                         * complete the descriptors that are fully sent. Runs with the DMA
+                                                                         * interrupt unable to preempt it
+                                                                         * @param[in]	ud		GPDMA driven UART
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void uartdma_tx_next(UARTDMA_Type* ud)
+{
+    GPDMA_Channel_CFG_Type dma_cfg;
+    UARTDMA_TX_Type* tx;
+    uint32_t size;
+
+    while ((tx = ud->TxHead) != NULL)
+    {
+        if (ud->TxOffset < tx->Length)
+        {
+            size = tx->Length - ud->TxOffset;
+            if (size > GPDMA_LLI_MAX_TRANSFER)
+            {
+                size = GPDMA_LLI_MAX_TRANSFER;
+            }
+            uartdma_dma_cfg(ud, GPDMA_TRANSFERTYPE_M2P, &dma_cfg);
+            dma_cfg.TransferSize = size;
+            dma_cfg.SrcMemAddr = ADDR32(tx->Data + ud->TxOffset);
+            GPDMA_Setup(&dma_cfg);
+            ud->TxOffset += size;
+            GPDMA_ChannelCmd(ud->Cfg.TxChannel, ENABLE);
+            return;
+        }
+
+        /* Unlink before the callback, which may queue the descriptor again */
+        ud->TxHead = tx->Next;
+        if (ud->TxHead == NULL)
+        {
+            ud->TxTail = NULL;
+        }
+        ud->TxDepth--;
+        ud->TxOffset = 0;
+        ud->TxBytes += tx->Length;
+        if (tx->Callback != NULL)
+        {
+            tx->Callback(tx);
+        }
+    }
+    ud->TxBusy = 0;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the number of bytes ever received, the completed halves
+                                                                         * plus the progress of the DMA in the current one
+                                                                         * @param[in]	ud		GPDMA driven UART
+                                                                         * @return		Receive head, wraps at 2^32
+                                                                         **********************************************************************/
+static uint32_t uartdma_rx_head(const UARTDMA_Type* ud)
+{
+    uint32_t size = ud->Cfg.RxSize;
+    uint32_t half = size / 2;
+    uint32_t head = ud->RxHead;
+    uint32_t base = ADDR32(ud->Cfg.RxBuffer) + ((head / half) & 1) * half;
+
+    /* Modulo the buffer size, so a half completed but not yet served by the
+     * interrupt still counts */
+    return head + (UARTDMA_DMACH(ud->Cfg.RxChannel)->DMACCDestAddr + size - base) % size;
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup UARTDMA_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Switch a UART to GPDMA operation: the FIFOs raise DMA requests,
+                                                                         * transmit buffers are queued and sent in place, and reception
+                                                                         * runs continuously into a buffer used as two halves
+                                                                         * @param[in]	ud		GPDMA driven UART
+                                                                         * @param[in]	UARTx	UART peripheral, should be:
+                                                                         * - LPC_UART0: UART0 peripheral
+                                                                         * - LPC_UART1: UART1 peripheral
+                                                                         * - LPC_UART2: UART2 peripheral
+                                                                         * - LPC_UART3: UART3 peripheral
+                                                                         * @param[in]	cfg		Configuration, copied
+                                                                         * @return		ERROR if the GPDMA descriptor pool is exhausted
+                                                                         * @note		UART_Init() and GPDMA_Init() must have been called and the pins
+                                                                         * set. Call UARTDMA_IntHandler() from DMA_IRQHandler. The UART
+                                                                         * interrupt is not used
+                                                                         **********************************************************************/
+Status UARTDMA_Init(UARTDMA_Type* ud, LPC_UART_TypeDef* UARTx, const UARTDMA_CFG_Type* cfg)
+{
+    UART_FIFO_CFG_Type fifo_cfg;
+    GPDMA_Channel_CFG_Type dma_cfg;
+    GPDMA_SEGMENT_Type segs[2];
+    uint32_t half = cfg->RxSize / 2;
+
+    CHECK_PARAM(PARAM_UARTx(UARTx));
+    CHECK_PARAM(PARAM_GPDMA_CHANNEL(cfg->TxChannel));
+    CHECK_PARAM((cfg->RxChannel == UARTDMA_NO_CHANNEL) || PARAM_GPDMA_CHANNEL(cfg->RxChannel));
+    CHECK_PARAM((cfg->RxChannel == UARTDMA_NO_CHANNEL) || PARAM_UARTDMA_RX_SIZE(cfg->RxSize));
+
+    ud->UARTx = UARTx;
+    ud->Cfg = *cfg;
+    if (UARTx == LPC_UART0)
+    {
+        ud->TxConn = GPDMA_CONN_UART0_Tx;
+    }
+    else if (UARTx == (LPC_UART_TypeDef*)LPC_UART1)
+    {
+        ud->TxConn = GPDMA_CONN_UART1_Tx;
+    }
+    else if (UARTx == LPC_UART2)
+    {
+        ud->TxConn = GPDMA_CONN_UART2_Tx;
+    }
+    else
+    {
+        ud->TxConn = GPDMA_CONN_UART3_Tx;
+    }
+    ud->RxConn = ud->TxConn + 1;
+    ud->TxHead = NULL;
+    ud->TxTail = NULL;
+    ud->TxOffset = 0;
+    ud->TxBusy = 0;
+    ud->TxDepth = 0;
+    ud->TxMaxDepth = 0;
+    ud->TxBytes = 0;
+    ud->RxChain = NULL;
+    ud->RxHead = 0;
+    ud->RxTail = 0;
+    ud->RxSeen = 0;
+    ud->RxReported = 0;
+    ud->RxDropped = 0;
+    ud->Errors = 0;
+
+    /* DMA mode with the receive trigger at one character: every byte is moved
+     * as soon as it arrives, the FIFO is left for line rate bursts */
+    fifo_cfg.FIFO_ResetRxBuf = ENABLE;
+    fifo_cfg.FIFO_ResetTxBuf = ENABLE;
+    fifo_cfg.FIFO_DMAMode = ENABLE;
+    fifo_cfg.FIFO_Level = UART_FIFO_TRGLEV0;
+    UART_FIFOConfig(UARTx, &fifo_cfg);
+    UART_TxCmd(UARTx, ENABLE);
+
+    if (cfg->RxChannel == UARTDMA_NO_CHANNEL)
+    {
+        return SUCCESS;
+    }
+
+    /* Both halves chained in a ring, terminal count interrupt on each */
+    uartdma_dma_cfg(ud, GPDMA_TRANSFERTYPE_P2M, &dma_cfg);
+    segs[0].SrcAddr = 0;
+    segs[0].DstAddr = ADDR32(cfg->RxBuffer);
+    segs[0].Size = half;
+    segs[1].SrcAddr = 0;
+    segs[1].DstAddr = ADDR32(cfg->RxBuffer + half);
+    segs[1].Size = half;
+    ud->RxChain = GPDMA_LLI_Build(&dma_cfg, segs, 2, GPDMA_LLI_CIRCULAR | GPDMA_LLI_INT_SEGMENT);
+    if (ud->RxChain == NULL)
+    {
+        return ERROR;
+    }
+    GPDMA_SetupChain(&dma_cfg, ud->RxChain);
+    GPDMA_ChannelCmd(cfg->RxChannel, ENABLE);
+    return SUCCESS;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Stop both DMA channels and leave DMA mode. Queued descriptors
+                                                                         * are dropped without their callbacks
+                                                                         * @param[in]	ud		GPDMA driven UART
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void UARTDMA_DeInit(UARTDMA_Type* ud)
+{
+    UART_FIFO_CFG_Type fifo_cfg;
+
+    GPDMA_ChannelCmd(ud->Cfg.TxChannel, DISABLE);
+    LPC_GPDMA->DMACIntTCClear = GPDMA_DMACIntTCClear_Ch(ud->Cfg.TxChannel);
+    if (ud->RxChain != NULL)
+    {
+        GPDMA_ChannelCmd(ud->Cfg.RxChannel, DISABLE);
+        LPC_GPDMA->DMACIntTCClear = GPDMA_DMACIntTCClear_Ch(ud->Cfg.RxChannel);
+        GPDMA_LLI_Free(ud->RxChain);
+        ud->RxChain = NULL;
+    }
+    ud->TxHead = NULL;
+    ud->TxTail = NULL;
+    ud->TxDepth = 0;
+    ud->TxBusy = 0;
+
+    UART_FIFOConfigStructInit(&fifo_cfg);
+    UART_FIFOConfig(ud->UARTx, &fifo_cfg);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Queue a buffer for transmission, without copying or waiting.
+                                                                         * Buffers are sent back to back in the order they were queued
+                                                                         * @param[in]	ud		GPDMA driven UART
+                                                                         * @param[in]	tx		Descriptor, with Data, Length and Callback set. It must
+                                                                         * not be queued already
+                                                                         * @return		None
+                                                                         * @note		Can be called from any context, including a completion callback
+                                                                         **********************************************************************/
+void UARTDMA_Send(UARTDMA_Type* ud, UARTDMA_TX_Type* tx)
+{
+    uint32_t primask;
+
+    tx->Next = NULL;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (ud->TxTail != NULL)
+    {
+        ud->TxTail->Next = tx;
+    }
+    else
+    {
+        ud->TxHead = tx;
+    }
+    ud->TxTail = tx;
+    if (++ud->TxDepth > ud->TxMaxDepth)
+    {
+        ud->TxMaxDepth = ud->TxDepth;
+    }
+
+    /* An idle channel raises no terminal count, start it here */
+    if (!ud->TxBusy)
+    {
+        ud->TxBusy = 1;
+        uartdma_tx_next(ud);
+    }
+    __set_PRIMASK(primask);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Tell whether the transmit queue is empty
+                                                                         * @param[in]	ud		GPDMA driven UART
+                                                                         * @return		TRUE when every queued buffer has been given to the FIFO. The
+                                                                         * last bytes may still be shifting out, see UART_CheckBusy()
+                                                                         **********************************************************************/
+Bool UARTDMA_IsTxIdle(const UARTDMA_Type* ud)
+{
+    return ud->TxBusy ? FALSE : TRUE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Take received bytes, without waiting
+                                                                         * @param[in]	ud		GPDMA driven UART
+                                                                         * @param[out]	data	Destination
+                                                                         * @param[in]	len		Room in the destination
+                                                                         * @return		Number of bytes read, 0 if nothing was received
+                                                                         * @note		Call from one execution context only, at least once per half
+                                                                         * buffer. Bytes the DMA has overwritten are skipped and counted
+                                                                         **********************************************************************/
+uint32_t UARTDMA_Read(UARTDMA_Type* ud, uint8_t* data, uint32_t len)
+{
+    uint32_t size = ud->Cfg.RxSize;
+    uint32_t head = uartdma_rx_head(ud);
+    uint32_t oldest = head - (head % (size / 2)) + size / 2 - size;
+    uint32_t tail = ud->RxTail;
+    uint32_t index, first;
+
+    /* The half the DMA is filling held the oldest bytes, they are gone */
+    if ((int32_t)(oldest - tail) > 0)
+    {
+        ud->RxDropped += oldest - tail;
+        tail = oldest;
+    }
+    if (len > head - tail)
+    {
+        len = head - tail;
+    }
+    index = tail % size;
+    first = size - index;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(data, &ud->Cfg.RxBuffer[index], first);
+    memcpy(data + first, ud->Cfg.RxBuffer, len - first);
+
+    ud->RxTail = tail + len;
+    return len;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the number of bytes waiting in the receive buffer
+                                                                         * @param[in]	ud		GPDMA driven UART
+                                                                         * @return		Bytes that UARTDMA_Read() can return now, at most the buffer size
+                                                                         **********************************************************************/
+uint32_t UARTDMA_GetRxCount(const UARTDMA_Type* ud)
+{
+    uint32_t count;
+
+    if (ud->RxChain == NULL)
+    {
+        return 0;
+    }
+    count = uartdma_rx_head(ud) - ud->RxTail;
+    return (count > ud->Cfg.RxSize) ? ud->Cfg.RxSize : count;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Flush a partial frame: calls the receive callback when bytes
+                                                                         * arrived before the previous call and none since. Call from a
+                                                                         * periodic tick a few character times long
+                                                                         * @param[in]	ud		GPDMA driven UART
+                                                                         * @return		None
+                                                                         * @note		The UART moves every byte to the DMA as it arrives, so its
+                                                                         * character time-out interrupt never fires in DMA mode, this
+                                                                         * poll stands in for it
+                                                                         **********************************************************************/
+void UARTDMA_RxPoll(UARTDMA_Type* ud)
+{
+    uint32_t head;
+
+    if (ud->RxChain == NULL)
+    {
+        return;
+    }
+    head = uartdma_rx_head(ud);
+    if ((head == ud->RxSeen) && (head != ud->RxReported))
+    {
+        ud->RxReported = head;
+        if (ud->Cfg.RxCallback != NULL)
+        {
+            ud->Cfg.RxCallback(ud, UARTDMA_GetRxCount(ud));
+        }
+    }
+    ud->RxSeen = head;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the transfer counters and the transmit queue high-water mark
+                                                                         * @param[in]	ud		GPDMA driven UART
+                                                                         * @param[out]	stats	Statistics
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void UARTDMA_GetStats(const UARTDMA_Type* ud, UARTDMA_STATS_Type* stats)
+{
+    stats->TxBytes = ud->TxBytes;
+    stats->TxMaxDepth = ud->TxMaxDepth;
+    stats->RxBytes = (ud->RxChain != NULL) ? uartdma_rx_head(ud) : 0;
+    stats->RxDropped = ud->RxDropped;
+    stats->Errors = ud->Errors;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Serve the terminal count and error interrupts of both channels,
+                                                                         * call from DMA_IRQHandler. Starts the next transmit piece and
+                                                                         * runs the callbacks
+                                                                         * @param[in]	ud		GPDMA driven UART
+                                                                         * @return		TRUE if the interrupt was for this UART
+                                                                         **********************************************************************/
+Bool UARTDMA_IntHandler(UARTDMA_Type* ud)
+{
+    uint32_t tx_ch = GPDMA_DMACIntTCStat_Ch(ud->Cfg.TxChannel);
+    uint32_t rx_ch = (ud->RxChain != NULL) ? GPDMA_DMACIntTCStat_Ch(ud->Cfg.RxChannel) : 0;
+    uint32_t head;
+    Bool served = FALSE;
+
+    if (LPC_GPDMA->DMACIntErrStat & (tx_ch | rx_ch))
+    {
+        LPC_GPDMA->DMACIntErrClr = LPC_GPDMA->DMACIntErrStat & (tx_ch | rx_ch);
+        ud->Errors++;
+        served = TRUE;
+
+        /* A bus error stops the channel: give up the rest of the buffer */
+        if (ud->TxBusy && !(LPC_GPDMA->DMACEnbldChns & tx_ch))
+        {
+            ud->TxOffset = ud->TxHead->Length;
+            uartdma_tx_next(ud);
+        }
+    }
+
+    if (LPC_GPDMA->DMACIntTCStat & tx_ch)
+    {
+        LPC_GPDMA->DMACIntTCClear = tx_ch;
+        uartdma_tx_next(ud);
+        served = TRUE;
+    }
+
+    if (LPC_GPDMA->DMACIntTCStat & rx_ch)
+    {
+        LPC_GPDMA->DMACIntTCClear = rx_ch;
+        ud->RxHead += ud->Cfg.RxSize / 2;
+        head = uartdma_rx_head(ud);
+        ud->RxReported = head;
+        if (ud->Cfg.RxCallback != NULL)
+        {
+            ud->Cfg.RxCallback(ud, UARTDMA_GetRxCount(ud));
+        }
+        served = TRUE;
+    }
+    return served;
+}
+
+/**
+ * @}
+ */
+
+#endif /* _UARTDMA */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -0,0 +1,479 @@
+/**********************************************************************
+ * $Id$		lpc17xx_wavegen.c				2010-05-21
+ *//**
+* @file		lpc17xx_wavegen.c
+* @brief	Contains all functions support for the DAC waveform generator through GPDMA on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup WAVEGEN
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_wavegen.h"
+#include "lpc17xx_clkpwr.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _WAVEGEN
+
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup WAVEGEN_Private_Macros WAVEGEN Private Macros
+ * @{
+ */
+
+/** GPDMA channel registers of channel n */
+#define WAVEGEN_DMACH(n) ((LPC_GPDMACH_TypeDef*)(LPC_GPDMACH0_BASE + ((uint32_t)(n) << 5)))
+
+/**
+ * @}
+ */
+
+/* Private Variables ---------------------------------------------------------- */
+/** @defgroup WAVEGEN_Private_Variables WAVEGEN Private Variables
+ * @{
+ */
+
+/** Quarter sine period in 64 steps plus the end point, Q15 */
+static const int16_t wavegen_sine_lut[65] = {
+        0,   804,  1608,  2410,  3212,  4011,  4808,  5602,  6393,  7179,  7962,  8739,  9512,
+    10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530, 18204, 18868,
+    19519, 20159, 20787, 21403, 22005, 22594, 23170, 23731, 24279, 24811, 25329, 25832, 26319,
+    26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956, 30273, 30571, 30852, 31113,
+    31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757, 32767};
+
+/**
+ * @}
+ */
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup WAVEGEN_Private_Functions WAVEGEN Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Sine of a 16-bit phase, interpolated from the quarter period
+                                                                         * table
+                                                                         * @param[in]	phase	Phase, 0x10000 is one period
+                                                                         * @return		Sine, Q15
+                                                                         **********************************************************************/
+static int32_t wavegen_sine(uint32_t phase)
+{
+    uint32_t x = phase & 0x3FFF;
+    uint32_t index;
+    int32_t s;
+
+    if (phase & 0x4000)
+    {
+        x = 0x4000 - x; // falling quarter
+    }
+    index = x >> 8;
+    s = wavegen_sine_lut[index];
+    if (index < 64)
+    {
+        s += ((wavegen_sine_lut[index + 1] - s) * (int32_t)(x & 0xFF)) >> 8;
+    }
+    return (phase & 0x8000) ? -s : s;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Table entry of a Q15 waveform value
+                                                                         * @param[in]	value		Waveform value, Q15
+                                                                         * @param[in]	amplitude	Peak amplitude in DAC codes
+                                                                         * @param[in]	offset		Middle code
+                                                                         * @return		DACR word, the code clamped to the DAC range
+                                                                         **********************************************************************/
+static uint32_t wavegen_sample(int32_t value, uint16_t amplitude, uint16_t offset)
+{
+    int32_t code = (int32_t)offset + (((int32_t)amplitude * value) >> 15);
+
+    if (code < 0)
+    {
+        code = 0;
+    }
+    else if (code > WAVEGEN_MAX_CODE)
+    {
+        code = WAVEGEN_MAX_CODE;
+    }
+    return WAVEGEN_SAMPLE((uint32_t)code);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Build a circular chain over a table
+                                                                         * @param[in]	gen		Waveform generator
+                                                                         * @param[in]	table	Table of DACR words
+                                                                         * @param[in]	size	Table size in samples
+                                                                         * @param[out]	dma_cfg	Channel configuration used to build the chain
+                                                                         * @return		First item of the chain, NULL if the pool ran out
+                                                                         **********************************************************************/
+static GPDMA_LLI_Type* wavegen_build(const WAVEGEN_Type* gen, const uint32_t* table, uint32_t size,
+                                     GPDMA_Channel_CFG_Type* dma_cfg)
+{
+    GPDMA_SEGMENT_Type seg;
+
+    dma_cfg->ChannelNum = gen->Cfg.DMAChannel;
+    dma_cfg->TransferSize = 0;
+    dma_cfg->TransferWidth = 0;
+    dma_cfg->SrcMemAddr = 0;
+    dma_cfg->DstMemAddr = 0;
+    dma_cfg->TransferType = GPDMA_TRANSFERTYPE_M2P;
+    dma_cfg->SrcConn = 0;
+    dma_cfg->DstConn = GPDMA_CONN_DAC;
+    dma_cfg->DMALLI = 0;
+
+    seg.SrcAddr = ADDR32(table);
+    seg.DstAddr = 0;
+    seg.Size = size;
+    return GPDMA_LLI_Build(dma_cfg, &seg, 1, GPDMA_LLI_CIRCULAR);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Check whether a channel runs on a circular chain: its link
+                                                                         * register holds an item of the chain and its source address is
+                                                                         * inside the part of the table that item covers
+                                                                         * @param[in]	head	First item of the chain
+                                                                         * @param[in]	pDMAch	Channel registers
+                                                                         * @return		TRUE if the channel has moved to the chain
+                                                                         **********************************************************************/
+static Bool wavegen_on_chain(const GPDMA_LLI_Type* head, const LPC_GPDMACH_TypeDef* pDMAch)
+{
+    const GPDMA_LLI_Type* item = head;
+    const GPDMA_LLI_Type* prev;
+    uint32_t lli = pDMAch->DMACCLLI;
+    uint32_t src = pDMAch->DMACCSrcAddr;
+
+    do
+    {
+        prev = item;
+        item = (const GPDMA_LLI_Type*)PTR32(item->NextLLI);
+        if (ADDR32(item) == lli)
+        {
+            /* prev is the item being played */
+            return ((src >= prev->SrcAddr) && (src <= prev->SrcAddr + ((prev->Control & 0xFFF) << 2))) ? TRUE
+                                                                                                           : FALSE;
+        }
+    } while (item != head);
+    return FALSE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Return a chain to the pool after cutting the link it may have
+                                                                         * to the next chain
+                                                                         * @param[in]	head	First item of the chain, NULL does nothing
+                                                                         * @param[in]	next	First item of the chain it links to, NULL if none
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void wavegen_free(GPDMA_LLI_Type* head, const GPDMA_LLI_Type* next)
+{
+    GPDMA_LLI_Type* item = head;
+
+    if ((head == NULL) || (next == NULL))
+    {
+        GPDMA_LLI_Free(head);
+        return;
+    }
+    while ((item->NextLLI != ADDR32(next)) && (item->NextLLI != ADDR32(head)))
+    {
+        item = (GPDMA_LLI_Type*)PTR32(item->NextLLI);
+    }
+    item->NextLLI = 0;
+    GPDMA_LLI_Free(head);
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup WAVEGEN_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Fill a table with one sine period
+                                                                         * @param[in]	table		Table of DACR words
+                                                                         * @param[in]	size		Table size in samples, 1 to 65535
+                                                                         * @param[in]	amplitude	Peak amplitude in DAC codes
+                                                                         * @param[in]	offset		Middle code
+                                                                         * @return		None
+                                                                         * @note		The output frequency is the sample rate divided by size
+                                                                         **********************************************************************/
+void WAVEGEN_FillSine(uint32_t* table, uint32_t size, uint16_t amplitude, uint16_t offset)
+{
+    uint32_t i;
+
+    CHECK_PARAM((size >= 1) && (size <= 0xFFFF));
+
+    for (i = 0; i < size; i++)
+    {
+        table[i] = wavegen_sample(wavegen_sine((i << 16) / size), amplitude, offset);
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Fill a table with one triangle period, starting at the middle
+                                                                         * code and rising first, in phase with WAVEGEN_FillSine()
+                                                                         * @param[in]	table		Table of DACR words
+                                                                         * @param[in]	size		Table size in samples, 1 to 65535
+                                                                         * @param[in]	amplitude	Peak amplitude in DAC codes
+                                                                         * @param[in]	offset		Middle code
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void WAVEGEN_FillTriangle(uint32_t* table, uint32_t size, uint16_t amplitude, uint16_t offset)
+{
+    uint32_t i, phase;
+    int32_t value;
+
+    CHECK_PARAM((size >= 1) && (size <= 0xFFFF));
+
+    for (i = 0; i < size; i++)
+    {
+        phase = (i << 16) / size;
+        if (phase < 0x4000)
+        {
+            value = (int32_t)phase * 2;
+        }
+        else if (phase < 0xC000)
+        {
+            value = 0x8000 - ((int32_t)phase - 0x4000) * 2;
+        }
+        else
+        {
+            value = ((int32_t)phase - 0x10000) * 2;
+        }
+        table[i] = wavegen_sample(value, amplitude, offset);
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Fill a table from arbitrary DAC codes
+                                                                         * @param[in]	table	Table of DACR words
+                                                                         * @param[in]	codes	DAC codes, 0 to WAVEGEN_MAX_CODE
+                                                                         * @param[in]	size	Number of codes
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void WAVEGEN_FillTable(uint32_t* table, const uint16_t* codes, uint32_t size)
+{
+    uint32_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        table[i] = WAVEGEN_SAMPLE(codes[i]);
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Initialize a waveform generator: set the DAC for 1 us settling
+                                                                         * and its counter for the sample rate
+                                                                         * @param[in]	gen		Waveform generator
+                                                                         * @param[in]	cfg		Configuration, copied
+                                                                         * @return		ERROR if the sample rate is out of reach of the DAC counter
+                                                                         * @note		GPDMA_Init() must have been called, P0.26 must be set to its
+                                                                         * AOUT function
+                                                                         **********************************************************************/
+Status WAVEGEN_Init(WAVEGEN_Type* gen, const WAVEGEN_CFG_Type* cfg)
+{
+    uint32_t count;
+
+    CHECK_PARAM(PARAM_WAVEGEN_RATE(cfg->Rate));
+    CHECK_PARAM(PARAM_GPDMA_CHANNEL(cfg->DMAChannel));
+
+    gen->Cfg = *cfg;
+    gen->Chain = NULL;
+    gen->Pending = NULL;
+
+    count = CLKPWR_GetPCLK(CLKPWR_PCLKSEL_DAC) / cfg->Rate;
+    if ((count == 0) || (count > 0xFFFF))
+    {
+        return ERROR;
+    }
+    DAC_Init(LPC_DAC);
+    DAC_SetDMATimeOut(LPC_DAC, count);
+    return SUCCESS;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Start playing a table in a loop. Each DAC counter time-out
+                                                                         * latches the next sample through the double buffer and requests
+                                                                         * the one after it, the CPU takes no part
+                                                                         * @param[in]	gen		Waveform generator
+                                                                         * @param[in]	table	Table of DACR words, stays in use until the generator
+                                                                         * moves to another table
+                                                                         * @param[in]	size	Table size in samples
+                                                                         * @return		ERROR if the GPDMA descriptor pool is exhausted
+                                                                         **********************************************************************/
+Status WAVEGEN_Start(WAVEGEN_Type* gen, const uint32_t* table, uint32_t size)
+{
+    GPDMA_Channel_CFG_Type dma_cfg;
+    DAC_CONVERTER_CFG_Type dac_cfg;
+
+    WAVEGEN_Stop(gen);
+
+    gen->Chain = wavegen_build(gen, table, size, &dma_cfg);
+    if (gen->Chain == NULL)
+    {
+        return ERROR;
+    }
+    GPDMA_SetupChain(&dma_cfg, gen->Chain);
+
+    /* Terminal counts only matter while a table swap is pending */
+    WAVEGEN_DMACH(gen->Cfg.DMAChannel)->DMACCConfig &= ~(GPDMA_DMACCxConfig_IE | GPDMA_DMACCxConfig_ITC);
+    GPDMA_ChannelCmd(gen->Cfg.DMAChannel, ENABLE);
+
+    dac_cfg.DBLBUF_ENA = 1;
+    dac_cfg.CNT_ENA = 1;
+    dac_cfg.DMA_ENA = 1;
+    DAC_ConfigDAConverterControl(LPC_DAC, &dac_cfg);
+    return SUCCESS;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Stop the output, the DAC holds its last value, and return the
+                                                                         * chains to the GPDMA pool
+                                                                         * @param[in]	gen		Waveform generator
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void WAVEGEN_Stop(WAVEGEN_Type* gen)
+{
+    DAC_CONVERTER_CFG_Type dac_cfg;
+
+    dac_cfg.DBLBUF_ENA = 0;
+    dac_cfg.CNT_ENA = 0;
+    dac_cfg.DMA_ENA = 0;
+    DAC_ConfigDAConverterControl(LPC_DAC, &dac_cfg);
+
+    GPDMA_ChannelCmd(gen->Cfg.DMAChannel, DISABLE);
+    LPC_GPDMA->DMACIntTCClear = GPDMA_DMACIntTCClear_Ch(gen->Cfg.DMAChannel);
+
+    wavegen_free(gen->Chain, gen->Pending);
+    GPDMA_LLI_Free(gen->Pending);
+    gen->Chain = NULL;
+    gen->Pending = NULL;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Move to another table at the end of the current pass, with no
+                                                                         * gap or repeated sample. Completes in WAVEGEN_IntHandler(), the
+                                                                         * DMA interrupt must be enabled
+                                                                         * @param[in]	gen		Waveform generator
+                                                                         * @param[in]	table	Table of DACR words
+                                                                         * @param[in]	size	Table size in samples
+                                                                         * @return		ERROR if the generator is stopped, a swap is still pending or
+                                                                         * the GPDMA descriptor pool is exhausted
+                                                                         * @note		The current table stays in use until WAVEGEN_IsSwapPending()
+                                                                         * returns FALSE. If the channel is already on the last item of the
+                                                                         * pass, the current table plays once more before the swap
+                                                                         **********************************************************************/
+Status WAVEGEN_SetTable(WAVEGEN_Type* gen, const uint32_t* table, uint32_t size)
+{
+    GPDMA_Channel_CFG_Type dma_cfg;
+    GPDMA_LLI_Type* item;
+
+    if ((gen->Chain == NULL) || (gen->Pending != NULL))
+    {
+        return ERROR;
+    }
+    gen->Pending = wavegen_build(gen, table, size, &dma_cfg);
+    if (gen->Pending == NULL)
+    {
+        return ERROR;
+    }
+
+    /* Redirect the last item of the pass, the channel reads it from memory
+     * when it gets there */
+    item = gen->Chain;
+    while (item->NextLLI != ADDR32(gen->Chain))
+    {
+        item = (GPDMA_LLI_Type*)PTR32(item->NextLLI);
+    }
+    item->NextLLI = ADDR32(gen->Pending);
+
+    LPC_GPDMA->DMACIntTCClear = GPDMA_DMACIntTCClear_Ch(gen->Cfg.DMAChannel);
+    WAVEGEN_DMACH(gen->Cfg.DMAChannel)->DMACCConfig |= GPDMA_DMACCxConfig_ITC;
+    return SUCCESS;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Check whether a table swap is waiting for the end of a pass
+                                                                         * @param[in]	gen		Waveform generator
+                                                                         * @return		TRUE while the previous table is still in use
+                                                                         **********************************************************************/
+Bool WAVEGEN_IsSwapPending(const WAVEGEN_Type* gen)
+{
+    return (gen->Pending != NULL) ? TRUE : FALSE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Serve the terminal count of the generator channel, call from
+                                                                         * DMA_IRQHandler. Once the channel runs on the new table, releases
+                                                                         * the previous one and masks the interrupt again
+                                                                         * @param[in]	gen		Waveform generator
+                                                                         * @return		TRUE if the interrupt was for this generator
+                                                                         * @note		The previous chain goes back to the GPDMA pool from the
+                                                                         * interrupt. GPDMA_LLI_Free() updates the pool with interrupts
+                                                                         * disabled, so thread code may allocate from it meanwhile
+                                                                         * (WAVEGEN_SetTable(), UARTDMA_Init(), I2SDMA_Init(), ADCDMA)
+                                                                         **********************************************************************/
+Bool WAVEGEN_IntHandler(WAVEGEN_Type* gen)
+{
+    if (!(LPC_GPDMA->DMACIntTCStat & GPDMA_DMACIntTCStat_Ch(gen->Cfg.DMAChannel)))
+    {
+        return FALSE;
+    }
+    LPC_GPDMA->DMACIntTCClear = GPDMA_DMACIntTCClear_Ch(gen->Cfg.DMAChannel);
+
+    /* The channel has loaded the first item of the next pass */
+    if ((gen->Pending != NULL) && wavegen_on_chain(gen->Pending, WAVEGEN_DMACH(gen->Cfg.DMAChannel)))
+    {
+        WAVEGEN_DMACH(gen->Cfg.DMAChannel)->DMACCConfig &= ~GPDMA_DMACCxConfig_ITC;
+        wavegen_free(gen->Chain, gen->Pending);
+        gen->Chain = gen->Pending;
+        gen->Pending = NULL;
+    }
+    return TRUE;
+}
+
+/**
+ * @}
+ */
+
+#endif /* _WAVEGEN */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -949,6 +949,8 @@ typedef struct
 /******************************************************************************/
 /*                         Peripheral memory map                              */
 /******************************************************************************/
+/* In host builds (__USE_HOST_SIM) sim_LPC17xx.c maps host memory at these    */
+/* addresses, so the peripheral pointers below are used unchanged.            */
 /* Base addresses                                                             */
 #define LPC_FLASH_BASE        (0x00000000UL)
 #define LPC_RAM_BASE          (0x10000000UL)
@@ -0,0 +1,143 @@
+/**************************************************************************//**
+ * @file     capture_check.c
+ * @brief    Host check of the CAPTURE engine against synthetic PWM edge streams
+ * @version  V1.00
+ *
+ * @note
+ * Usage: capture_check
+ *
+ * Sets the capture engine up as Exercise_5 does (TIMER2 counts both edges of
+ * CAP2.0 on P0.4, each count makes GPDMA copy the free running TIMER3 into
+ * the ring) and feeds P0.4 with PWM streams of several frequencies and duty
+ * cycles, starting low or high, through SIM_GPIO_SetInput() and
+ * SIM_TIM_CaptureInput() at exact cycle times. CAPTURE_Measure() must give
+ * the period and high time within one timebase tick, and the duty cycle
+ * within 0.1 %. Prints one line per stream and exits non zero if any fails.
+ * Built by "make HOST=1 capture_check" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "LPC17xx.h"
+#include "lpc17xx_capture.h"
+#include "lpc17xx_gpdma.h"
+#include "lpc17xx_timer.h"
+#include "sim_LPC17xx.h"
+
+#define CHECK_PORT        0
+#define CHECK_PIN         4
+#define CHECK_EDGES       64
+#define CHECK_PERIODS     10
+
+/* One synthetic PWM stream */
+typedef struct
+{
+    uint32_t freq;                    /* Hz */
+    uint32_t duty;                    /* 1/1000 */
+    uint8_t start_high;               /* pin level before the first edge */
+} Stream_Type;
+
+static const Stream_Type streams[] = {
+    { 1000, 250, 0 },
+    { 5000, 500, 1 },
+    { 20000, 900, 0 },
+    { 50000, 100, 1 },
+    { 2500, 333, 0 },
+};
+
+static uint32_t buffer[CHECK_EDGES];
+static CAPTURE_Type cap;
+
+static void pin(uint8_t level)
+{
+    SIM_GPIO_SetInput(CHECK_PORT, 1UL << CHECK_PIN, level ? (1UL << CHECK_PIN) : 0);
+    SIM_TIM_CaptureInput(2, 0, level);
+}
+
+static uint32_t diff(uint32_t a, uint32_t b)
+{
+    return (a > b) ? a - b : b - a;
+}
+
+static int check(const Stream_Type* s)
+{
+    uint32_t period = SystemCoreClock / s->freq;
+    uint32_t high = (uint32_t)((uint64_t)period * s->duty / 1000);
+    uint32_t rate = CAPTURE_GetTickRate(&cap);
+    uint32_t want_period = (uint32_t)((uint64_t)period * rate / SystemCoreClock);
+    uint32_t want_high = (uint32_t)((uint64_t)high * rate / SystemCoreClock);
+    uint32_t want_duty = (uint32_t)((uint64_t)s->duty * 0xFFFF / 1000);
+    CAPTURE_RESULT_Type r;
+    Status st;
+    uint32_t i;
+    int ok;
+
+    CAPTURE_Stop(&cap);
+    pin(s->start_high);
+    SIM_Advance(period);
+    CAPTURE_Start(&cap);
+
+    /* Whole periods, starting at the edge away from the idle level */
+    for (i = 0; i < CHECK_PERIODS + 2; i++)
+    {
+        if (s->start_high)
+        {
+            pin(0);
+            SIM_Advance(period - high);
+            pin(1);
+            SIM_Advance(high);
+        }
+        else
+        {
+            pin(1);
+            SIM_Advance(high);
+            pin(0);
+            SIM_Advance(period - high);
+        }
+    }
+
+    st = CAPTURE_Measure(&cap, CHECK_PERIODS, &r);
+    ok = (st == SUCCESS) && diff(r.Period, want_period) <= 1 && diff(r.High, want_high) <= 1
+         && diff(r.Duty, want_duty) <= 0xFFFF / 1000;
+    printf("%6u Hz %5.1f %% %-4s  period %7u (%7u)  high %7u (%7u)  duty %5u (%5u)  %s\n", (unsigned)s->freq,
+           s->duty / 10.0, s->start_high ? "high" : "low", (unsigned)r.Period, (unsigned)want_period,
+           (unsigned)r.High, (unsigned)want_high, (unsigned)r.Duty, (unsigned)want_duty, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+int main(void)
+{
+    CAPTURE_CFG_Type cfg;
+    uint32_t failures = 0;
+    uint32_t i;
+
+    SIM_Init();
+    SystemInit();
+    GPDMA_Init();
+
+    cfg.CounterTIMx = LPC_TIM2;
+    cfg.TimebaseTIMx = LPC_TIM3;
+    cfg.CaptureChannel = TIM_COUNTER_INCAP0;
+    cfg.DMAChannel = 0;
+    cfg.PinPort = CHECK_PORT;
+    cfg.PinNum = CHECK_PIN;
+    cfg.Buffer = buffer;
+    cfg.BufferSize = CHECK_EDGES;
+    if (CAPTURE_Init(&cap, &cfg) != SUCCESS)
+    {
+        fprintf(stderr, "capture_check: CAPTURE_Init failed\n");
+        return 1;
+    }
+
+    printf("stream                measured (expected), timebase ticks at %u Hz\n",
+           (unsigned)CAPTURE_GetTickRate(&cap));
+    for (i = 0; i < sizeof(streams) / sizeof(streams[0]); i++)
+    {
+        failures += !check(&streams[i]);
+    }
+    printf("%u of %u streams failed\n", (unsigned)failures, (unsigned)(sizeof(streams) / sizeof(streams[0])));
+    return (failures != 0) ? 1 : 0;
+}
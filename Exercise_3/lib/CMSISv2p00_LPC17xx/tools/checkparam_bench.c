@@ -0,0 +1,325 @@
+/**************************************************************************//**
+ * @file     checkparam_bench.c
+ * @brief    Host benchmark of the debug and release CHECK_PARAM profiles
+ * @version  V1.00
+ *
+ * @note
+ * Usage: checkparam_bench [calls] [debug-lib release-lib]
+ *
+ * Times [calls] (default 1000000) calls of a few GPIO, timer, ADC and CAN
+ * entry points and prints host TSC cycles per call, and the size of each
+ * entry point read with nm from the debug and release libraries (default
+ * liblpcdriver_host.a and liblpcdriver_host_rel.a; set NM to read target
+ * libraries). The program is built twice, checkparam_bench against the
+ * debug library and checkparam_bench_rel against the release one (with
+ * LIBCFG_RELEASE, so its calls go through the release call site checks).
+ * Either one runs the other with -c to fill in the other column.
+ * The peripheral models are detached so the registers are plain memory and
+ * the figures are the cost of the driver code alone. GPIO entry points
+ * have no CHECK_PARAM and serve as the reference.
+ * Built by "make HOST=1 checkparam_bench" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x86intrin.h>
+
+#include "LPC17xx.h"
+#include "lpc17xx_adc.h"
+#include "lpc17xx_can.h"
+#include "lpc17xx_gpio.h"
+#include "lpc17xx_timer.h"
+#include "sim_LPC17xx.h"
+
+#define BENCH_RUNS        5           /* best of */
+#define BENCH_NM_LINE     256
+#define BENCH_REL_SUFFIX  "_rel"
+
+/* Profile of this build, column 0: debug, 1: release */
+#ifdef LIBCFG_RELEASE
+#define BENCH_PROFILE     1
+#else
+#define BENCH_PROFILE     0
+#endif
+
+/* One entry point under test */
+typedef struct
+{
+    const char* name;
+    void (*call)(uint32_t n);
+    double cycles[2];                 /* debug, release; < 0: not measured */
+    long size[2];                     /* bytes; < 0: not found */
+} Bench_Type;
+
+static volatile uint32_t sink;
+
+static void gpio_setvalue(uint32_t n)
+{
+    while (n--)
+    {
+        GPIO_SetValue(0, n);
+    }
+}
+
+static void gpio_readvalue(uint32_t n)
+{
+    uint32_t acc = 0;
+
+    while (n--)
+    {
+        acc += GPIO_ReadValue(n & 3);
+    }
+    sink = acc;
+}
+
+static void tim_getintstatus(uint32_t n)
+{
+    uint32_t acc = 0;
+
+    while (n--)
+    {
+        acc += TIM_GetIntStatus(LPC_TIM0, (TIM_INT_TYPE)(n & 3));
+    }
+    sink = acc;
+}
+
+static void tim_clearintpending(uint32_t n)
+{
+    while (n--)
+    {
+        TIM_ClearIntPending(LPC_TIM0, (TIM_INT_TYPE)(n & 3));
+    }
+}
+
+static void tim_updatematchvalue(uint32_t n)
+{
+    while (n--)
+    {
+        TIM_UpdateMatchValue(LPC_TIM0, n & 3, n);
+    }
+}
+
+static void adc_channelgetstatus(uint32_t n)
+{
+    uint32_t acc = 0;
+
+    while (n--)
+    {
+        acc += ADC_ChannelGetStatus(LPC_ADC, n & 7, ADC_DATA_DONE);
+    }
+    sink = acc;
+}
+
+static void adc_channelgetdata(uint32_t n)
+{
+    uint32_t acc = 0;
+
+    while (n--)
+    {
+        acc += ADC_ChannelGetData(LPC_ADC, n & 7);
+    }
+    sink = acc;
+}
+
+static void can_getctrlstatus(uint32_t n)
+{
+    uint32_t acc = 0;
+
+    while (n--)
+    {
+        acc += CAN_GetCTRLStatus(LPC_CAN1, (CAN_CTRL_STS_Type)(n & 3));
+    }
+    sink = acc;
+}
+
+static void can_setcommand(uint32_t n)
+{
+    while (n--)
+    {
+        CAN_SetCommand(LPC_CAN1, CAN_CMR_RRB);
+    }
+}
+
+static Bench_Type benches[] = {
+    { "GPIO_SetValue", gpio_setvalue, { -1, -1 }, { -1, -1 } },
+    { "GPIO_ReadValue", gpio_readvalue, { -1, -1 }, { -1, -1 } },
+    { "TIM_GetIntStatus", tim_getintstatus, { -1, -1 }, { -1, -1 } },
+    { "TIM_ClearIntPending", tim_clearintpending, { -1, -1 }, { -1, -1 } },
+    { "TIM_UpdateMatchValue", tim_updatematchvalue, { -1, -1 }, { -1, -1 } },
+    { "ADC_ChannelGetStatus", adc_channelgetstatus, { -1, -1 }, { -1, -1 } },
+    { "ADC_ChannelGetData", adc_channelgetdata, { -1, -1 }, { -1, -1 } },
+    { "CAN_GetCTRLStatus", can_getctrlstatus, { -1, -1 }, { -1, -1 } },
+    { "CAN_SetCommand", can_setcommand, { -1, -1 }, { -1, -1 } },
+};
+
+#define BENCH_COUNT       (sizeof(benches) / sizeof(benches[0]))
+
+static Bench_Type* find(const char* name)
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_COUNT; i++)
+    {
+        if (strcmp(benches[i].name, name) == 0)
+        {
+            return &benches[i];
+        }
+    }
+    return NULL;
+}
+
+/* Best of BENCH_RUNS, host cycles per call including the loop */
+static double measure(const Bench_Type* b, uint32_t n)
+{
+    double best = 0;
+    uint32_t run;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+        uint64_t t0 = __rdtsc();
+        double cycles;
+
+        b->call(n);
+        cycles = (double)(__rdtsc() - t0) / (double)n;
+        if (run == 0 || cycles < best)
+        {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+/* Cycles of the other profile: "name cycles" lines of the other build run
+   with -c, checkparam_bench_rel next to checkparam_bench and the reverse */
+static void read_other(const char* self, uint32_t n)
+{
+    size_t len = strlen(self);
+    size_t suffix = strlen(BENCH_REL_SUFFIX);
+    char cmd[BENCH_NM_LINE];
+    char line[BENCH_NM_LINE];
+    char name[64];
+    double cycles;
+    FILE* f;
+
+    if (BENCH_PROFILE == 0)
+    {
+        snprintf(cmd, sizeof(cmd), "%s%s -c %u", self, BENCH_REL_SUFFIX, (unsigned)n);
+    }
+    else if (len > suffix && strcmp(self + len - suffix, BENCH_REL_SUFFIX) == 0)
+    {
+        snprintf(cmd, sizeof(cmd), "%.*s -c %u", (int)(len - suffix), self, (unsigned)n);
+    }
+    else
+    {
+        return;
+    }
+    f = popen(cmd, "r");
+    if (f == NULL)
+    {
+        return;
+    }
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        Bench_Type* b;
+
+        if (sscanf(line, "%63s %lf", name, &cycles) == 2 && (b = find(name)) != NULL)
+        {
+            b->cycles[1 - BENCH_PROFILE] = cycles;
+        }
+    }
+    pclose(f);
+}
+
+/* Entry point sizes from the symbol table of one library */
+static void read_sizes(const char* lib, uint8_t profile)
+{
+    const char* nm = getenv("NM");
+    char cmd[BENCH_NM_LINE];
+    char line[BENCH_NM_LINE];
+    char name[64];
+    char type;
+    unsigned long addr;
+    unsigned long size;
+    FILE* f;
+
+    snprintf(cmd, sizeof(cmd), "%s -S %s 2>/dev/null", (nm != NULL) ? nm : "nm", lib);
+    f = popen(cmd, "r");
+    if (f == NULL)
+    {
+        return;
+    }
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        Bench_Type* b;
+
+        if (sscanf(line, "%lx %lx %c %63s", &addr, &size, &type, name) == 4 && (type == 'T' || type == 't')
+            && (b = find(name)) != NULL)
+        {
+            b->size[profile] = (long)size;
+        }
+    }
+    pclose(f);
+}
+
+static void print_pair(double debug, double release, const char* fmt)
+{
+    char cell[16];
+
+    snprintf(cell, sizeof(cell), fmt, debug);
+    printf(" %8s", (debug >= 0) ? cell : "-");
+    snprintf(cell, sizeof(cell), fmt, release);
+    printf(" %8s", (release >= 0) ? cell : "-");
+    snprintf(cell, sizeof(cell), fmt, debug - release);
+    printf(" %8s", (debug >= 0 && release >= 0) ? cell : "-");
+}
+
+int main(int argc, char** argv)
+{
+    uint8_t child = (argc > 1 && strcmp(argv[1], "-c") == 0);
+    uint32_t n = 1000000;
+    uint32_t i;
+
+    if (argc > 1 + child)
+    {
+        n = (uint32_t)strtoul(argv[1 + child], NULL, 0);
+    }
+
+    SIM_Init();
+    SIM_DetachModel(LPC_GPIO_BASE);
+    SIM_DetachModel(LPC_TIM0_BASE);
+    SIM_DetachModel(LPC_ADC_BASE);
+    SIM_DetachModel(LPC_CAN1_BASE);
+
+    for (i = 0; i < BENCH_COUNT; i++)
+    {
+        benches[i].cycles[BENCH_PROFILE] = measure(&benches[i], n);
+        if (child)
+        {
+            printf("%s %.2f\n", benches[i].name, benches[i].cycles[BENCH_PROFILE]);
+        }
+    }
+    if (child)
+    {
+        return 0;
+    }
+
+    read_other(argv[0], n);
+    read_sizes((argc > 3) ? argv[2] : "liblpcdriver_host.a", 0);
+    read_sizes((argc > 3) ? argv[3] : "liblpcdriver_host_rel.a", 1);
+
+    printf("%u calls, best of %u, host TSC cycles per call and bytes of code\n", (unsigned)n, BENCH_RUNS);
+    printf("entry point             cyc dbg  cyc rel    saved  B debug   B rel    saved\n");
+    for (i = 0; i < BENCH_COUNT; i++)
+    {
+        const Bench_Type* b = &benches[i];
+
+        printf("%-22s", b->name);
+        print_pair(b->cycles[0], b->cycles[1], "%.1f");
+        print_pair((double)b->size[0], (double)b->size[1], "%.0f");
+        printf("\n");
+    }
+    return 0;
+}
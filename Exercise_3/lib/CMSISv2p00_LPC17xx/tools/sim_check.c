@@ -0,0 +1,230 @@
+/**************************************************************************//**
+ * @file     sim_check.c
+ * @brief    Host check of the peripheral models against the unchanged drivers
+ * @version  V1.00
+ *
+ * @note
+ * Usage: sim_check
+ *
+ * Drives the simulator through the driver library as an application would
+ * and checks what the models return: UART0 transmit and receive, an SSP0
+ * loopback transfer, a GPDMA memory to memory copy finished by its terminal
+ * count interrupt, TIMER0 match interrupts at the programmed rate, GPIO
+ * rising edge interrupts through EINT3 and an ADC conversion of an injected
+ * input. Prints one line per check and exits non zero if any fails.
+ * Built by "make HOST=1 sim_check" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "LPC17xx.h"
+#include "lpc17xx_adc.h"
+#include "lpc17xx_gpdma.h"
+#include "lpc17xx_gpio.h"
+#include "lpc17xx_ssp.h"
+#include "lpc17xx_timer.h"
+#include "lpc17xx_uart.h"
+#include "sim_LPC17xx.h"
+
+#define CHECK_DMA_WORDS   64
+#define CHECK_TIM_US      100         /* match period */
+#define CHECK_TIM_MS      10          /* run time, 100 periods */
+#define CHECK_GPIO_PIN    5
+
+static uint32_t dma_src[CHECK_DMA_WORDS];
+static uint32_t dma_dst[CHECK_DMA_WORDS];
+static volatile uint32_t dma_done;
+static volatile uint32_t tim_irqs;
+static volatile uint32_t gpio_irqs;
+static uint32_t failures;
+
+void DMA_IRQHandler(void)
+{
+    if (GPDMA_IntGetStatus(GPDMA_STAT_INTTC, 0))
+    {
+        GPDMA_ClearIntPending(GPDMA_STATCLR_INTTC, 0);
+        dma_done++;
+    }
+}
+
+void TIMER0_IRQHandler(void)
+{
+    if (TIM_GetIntStatus(LPC_TIM0, TIM_MR0_INT))
+    {
+        TIM_ClearIntPending(LPC_TIM0, TIM_MR0_INT);
+        tim_irqs++;
+    }
+}
+
+void EINT3_IRQHandler(void)
+{
+    if (GPIO_GetIntStatus(0, CHECK_GPIO_PIN, 0))
+    {
+        GPIO_ClearInt(0, 1UL << CHECK_GPIO_PIN);
+        gpio_irqs++;
+    }
+}
+
+static void report(const char* name, int ok, const char* detail)
+{
+    printf("%-6s %s  %s\n", name, ok ? "PASS" : "FAIL", detail);
+    if (!ok)
+    {
+        failures++;
+    }
+}
+
+static void check_uart(void)
+{
+    static uint8_t tx[] = "hello";
+    static uint8_t in[] = "world";
+    UART_CFG_Type cfg;
+    uint8_t out[16];
+    uint8_t rx[16];
+    uint32_t sent;
+    uint32_t drained;
+    uint32_t received;
+
+    UART_ConfigStructInit(&cfg);
+    cfg.Baud_rate = 115200;
+    UART_Init(LPC_UART0, &cfg);
+    UART_TxCmd(LPC_UART0, ENABLE);
+
+    sent = UART_Send(LPC_UART0, tx, 5, BLOCKING);
+    SIM_Advance(SystemCoreClock / 1000);
+    drained = SIM_UART_Drain(0, out, sizeof(out));
+    SIM_UART_Inject(0, in, 5);
+    received = UART_Receive(LPC_UART0, rx, 5, BLOCKING);
+    report("uart", sent == 5 && drained == 5 && memcmp(out, tx, 5) == 0 && received == 5 && memcmp(rx, in, 5) == 0,
+           "5 bytes each way at 115200 baud");
+}
+
+static void check_ssp(void)
+{
+    static uint8_t tx[8] = { 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF };
+    static uint8_t rx[8];
+    SSP_CFG_Type cfg;
+    SSP_DATA_SETUP_Type xfer;
+    int32_t n;
+
+    SSP_ConfigStructInit(&cfg);
+    SSP_Init(LPC_SSP0, &cfg);
+    SSP_Cmd(LPC_SSP0, ENABLE);
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.tx_data = tx;
+    xfer.rx_data = rx;
+    xfer.length = sizeof(tx);
+    n = SSP_ReadWrite(LPC_SSP0, &xfer, SSP_TRANSFER_POLLING);
+    report("ssp", n == (int32_t)sizeof(tx) && memcmp(rx, tx, sizeof(tx)) == 0, "8 bytes looped back");
+}
+
+static void check_gpdma(void)
+{
+    GPDMA_Channel_CFG_Type cfg;
+    uint32_t i;
+
+    for (i = 0; i < CHECK_DMA_WORDS; i++)
+    {
+        dma_src[i] = 0x9E3779B9UL * (i + 1);
+    }
+    GPDMA_Init();
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.ChannelNum = 0;
+    cfg.TransferSize = CHECK_DMA_WORDS;
+    cfg.TransferWidth = GPDMA_WIDTH_WORD;
+    cfg.SrcMemAddr = ADDR32(dma_src);
+    cfg.DstMemAddr = ADDR32(dma_dst);
+    cfg.TransferType = GPDMA_TRANSFERTYPE_M2M;
+    GPDMA_Setup(&cfg);
+    NVIC_EnableIRQ(DMA_IRQn);
+    GPDMA_ChannelCmd(0, ENABLE);
+    for (i = 0; i < 100 && dma_done == 0; i++)
+    {
+        SIM_Advance(1000);
+    }
+    NVIC_DisableIRQ(DMA_IRQn);
+    report("gpdma", dma_done == 1 && memcmp(dma_src, dma_dst, sizeof(dma_src)) == 0,
+           "64 words memory to memory, one terminal count interrupt");
+}
+
+static void check_timer(void)
+{
+    TIM_TIMERCFG_Type cfg;
+    TIM_MATCHCFG_Type match;
+    char detail[64];
+
+    TIM_ConfigStructInit(TIM_TIMER_MODE, &cfg);
+    cfg.PrescaleOption = TIM_PRESCALE_USVAL;
+    cfg.PrescaleValue = 1;
+    TIM_Init(LPC_TIM0, TIM_TIMER_MODE, &cfg);
+    memset(&match, 0, sizeof(match));
+    match.MatchChannel = 0;
+    match.IntOnMatch = ENABLE;
+    match.ResetOnMatch = ENABLE;
+    match.MatchValue = CHECK_TIM_US;
+    TIM_ConfigMatch(LPC_TIM0, &match);
+    NVIC_EnableIRQ(TIMER0_IRQn);
+    TIM_Cmd(LPC_TIM0, ENABLE);
+    SIM_Advance(SystemCoreClock / 1000 * CHECK_TIM_MS);
+    TIM_Cmd(LPC_TIM0, DISABLE);
+    NVIC_DisableIRQ(TIMER0_IRQn);
+    snprintf(detail, sizeof(detail), "%u match interrupts in %u ms, %u expected", (unsigned)tim_irqs,
+             (unsigned)CHECK_TIM_MS, (unsigned)(CHECK_TIM_MS * 1000 / CHECK_TIM_US));
+    report("timer", tim_irqs + 1 >= CHECK_TIM_MS * 1000 / CHECK_TIM_US && tim_irqs <= CHECK_TIM_MS * 1000 / CHECK_TIM_US,
+           detail);
+}
+
+static void check_gpio(void)
+{
+    uint32_t mask = 1UL << CHECK_GPIO_PIN;
+
+    GPIO_SetDir(0, mask, 0);
+    SIM_GPIO_SetInput(0, mask, 0);
+    GPIO_IntCmd(0, mask, 0);
+    NVIC_EnableIRQ(EINT3_IRQn);
+    SIM_GPIO_SetInput(0, mask, mask);
+    SIM_ServiceIRQ();
+    SIM_GPIO_SetInput(0, mask, 0);
+    SIM_ServiceIRQ();
+    SIM_GPIO_SetInput(0, mask, mask);
+    SIM_ServiceIRQ();
+    NVIC_DisableIRQ(EINT3_IRQn);
+    report("gpio", gpio_irqs == 2 && (GPIO_ReadValue(0) & mask) != 0, "two rising edges of P0.5, two interrupts");
+}
+
+static void check_adc(void)
+{
+    uint32_t i;
+    uint16_t value = 0;
+
+    SIM_ADC_SetInput(0, 0x5A5);
+    ADC_Init(LPC_ADC, 200000);
+    ADC_ChannelCmd(LPC_ADC, ADC_CHANNEL_0, ENABLE);
+    ADC_StartCmd(LPC_ADC, ADC_START_NOW);
+    for (i = 0; i < 100000; i++)
+    {
+        if (ADC_ChannelGetStatus(LPC_ADC, ADC_CHANNEL_0, ADC_DATA_DONE))
+        {
+            value = ADC_ChannelGetData(LPC_ADC, ADC_CHANNEL_0);
+            break;
+        }
+    }
+    report("adc", value == 0x5A5, "channel 0 converts the injected 0x5A5");
+}
+
+int main(void)
+{
+    SIM_Init();
+    SystemInit();
+    check_uart();
+    check_ssp();
+    check_gpdma();
+    check_timer();
+    check_gpio();
+    check_adc();
+    printf("%u of 6 checks failed\n", (unsigned)failures);
+    return (failures != 0) ? 1 : 0;
+}
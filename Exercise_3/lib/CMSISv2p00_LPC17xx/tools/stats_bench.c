@@ -0,0 +1,210 @@
+/**************************************************************************//**
+ * @file     stats_bench.c
+ * @brief    Host check and benchmark of the STATS running statistics
+ * @version  V1.00
+ *
+ * @note
+ * Usage: stats_bench [samples] [seed]
+ *
+ * First checks every push of a random stream, with runs of rising, falling
+ * and constant samples, against a brute-force computation over the ring:
+ * mean, minimum, maximum and variance must match exactly for windows of 1,
+ * 2, 10 and 1024 samples. Then pushes [samples] (default 1000000) samples
+ * into windows of 8, 64 and 1024 with STATS_OPT_MINMAX | STATS_OPT_VARIANCE
+ * and prints host TSC cycles per push for a random stream and for a
+ * sawtooth, the worst case of the min/max deques. The cost per sample does
+ * not depend on the window length.
+ * Built by "make HOST=1 stats_bench" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <x86intrin.h>
+
+#include "LPC17xx.h"
+#include "lpc17xx_stats.h"
+
+#define BENCH_RUNS        5               /* best of */
+#define BENCH_CHECK_PUSH  5000
+#define BENCH_SPREAD      32767           /* samples stay within this of the first one */
+#define BENCH_BASE        100000
+
+#define BENCH_OPTS        (STATS_OPT_MINMAX | STATS_OPT_VARIANCE)
+
+STATS_DEFINE(win1, 1, BENCH_OPTS);
+STATS_DEFINE(win2, 2, BENCH_OPTS);
+STATS_DEFINE(win8, 8, BENCH_OPTS);
+STATS_DEFINE(win10, 10, BENCH_OPTS);
+STATS_DEFINE(win64, 64, BENCH_OPTS);
+STATS_DEFINE(win1024, 1024, BENCH_OPTS);
+
+static STATS_Type* const checked[] = { &win1, &win2, &win10, &win1024 };
+static STATS_Type* const timed[] = { &win8, &win64, &win1024 };
+
+static int32_t ring[STATS_MAX_WINDOW];
+static int32_t* stream;
+static volatile int32_t sink;
+
+/* Random samples around BENCH_BASE, with runs of rising, falling and constant ones */
+static void make_stream(int32_t* out, uint32_t n)
+{
+    uint32_t i = 0;
+
+    out[i++] = BENCH_BASE;
+    while (i < n)
+    {
+        uint32_t run = 1 + (uint32_t)rand() % 40;
+        int32_t step = (rand() % 3) - 1;
+        int32_t x = BENCH_BASE + (rand() % (2 * BENCH_SPREAD + 1)) - BENCH_SPREAD;
+
+        if ((rand() & 3) != 0)
+        {
+            run = 1;
+        }
+        while (run-- && i < n)
+        {
+            out[i++] = x;
+            x += step * (rand() % 200);
+            if (x > BENCH_BASE + BENCH_SPREAD || x < BENCH_BASE - BENCH_SPREAD)
+            {
+                x = BENCH_BASE;
+            }
+        }
+    }
+}
+
+/* Brute-force statistics of the last count samples of the ring */
+static int check_window(const STATS_Type* s, uint32_t pushed)
+{
+    uint32_t count = (pushed < s->Window) ? pushed : s->Window;
+    int64_t sum = 0;
+    int64_t sum_dev = 0;
+    int64_t sum_sq = 0;
+    int32_t min = ring[0];
+    int32_t max = ring[0];
+    int64_t scatter;
+    int64_t var;
+    uint32_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        int32_t x = ring[(pushed - 1 - i) % s->Window];
+        int64_t d = (int64_t)x - BENCH_BASE;
+
+        sum += x;
+        sum_dev += d;
+        sum_sq += d * d;
+        if (i == 0 || x < min)
+        {
+            min = x;
+        }
+        if (i == 0 || x > max)
+        {
+            max = x;
+        }
+    }
+    scatter = (int64_t)count * sum_sq - sum_dev * sum_dev;
+    var = scatter / ((int64_t)count * count);
+    if (STATS_GetCount(s) != count || STATS_GetSum(s) != sum || STATS_GetMean(s) != (int32_t)(sum / count)
+        || STATS_GetMin(s) != min || STATS_GetMax(s) != max || STATS_GetVariance(s) != (uint32_t)var)
+    {
+        fprintf(stderr,
+                "stats_bench: window %u, push %u: mean %d/%d min %d/%d max %d/%d var %u/%u (library/brute force)\n",
+                (unsigned)s->Window, (unsigned)pushed, (int)STATS_GetMean(s), (int)(sum / count),
+                (int)STATS_GetMin(s), (int)min, (int)STATS_GetMax(s), (int)max, (unsigned)STATS_GetVariance(s),
+                (unsigned)var);
+        return 0;
+    }
+    return 1;
+}
+
+static void check(void)
+{
+    uint32_t w;
+    uint32_t i;
+
+    make_stream(stream, BENCH_CHECK_PUSH);
+    for (w = 0; w < sizeof(checked) / sizeof(checked[0]); w++)
+    {
+        STATS_Type* s = checked[w];
+
+        STATS_Reset(s);
+        for (i = 0; i < BENCH_CHECK_PUSH; i++)
+        {
+            ring[i % s->Window] = stream[i];
+            STATS_Push(s, stream[i]);
+            if (!check_window(s, i + 1))
+            {
+                exit(1);
+            }
+        }
+        printf("window %4u: %u pushes match the brute-force statistics\n", (unsigned)s->Window,
+               (unsigned)BENCH_CHECK_PUSH);
+    }
+}
+
+/* Best of BENCH_RUNS, host cycles per push including the loop and a mean read */
+static double measure(STATS_Type* s, const int32_t* x, uint32_t n)
+{
+    double best = 0;
+    uint32_t run;
+    uint32_t i;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+        uint64_t t0;
+        double cycles;
+
+        STATS_Reset(s);
+        t0 = __rdtsc();
+        for (i = 0; i < n; i++)
+        {
+            STATS_Push(s, x[i]);
+        }
+        sink = STATS_GetMean(s);
+        cycles = (double)(__rdtsc() - t0) / (double)n;
+        if (run == 0 || cycles < best)
+        {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t n = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000000;
+    uint32_t i;
+
+    srand((argc > 2) ? (unsigned)strtoul(argv[2], NULL, 0) : 1);
+    stream = malloc(sizeof(int32_t) * ((n > BENCH_CHECK_PUSH) ? n : BENCH_CHECK_PUSH));
+    if (stream == NULL)
+    {
+        return 1;
+    }
+    check();
+
+    printf("%u pushes, best of %u, host TSC cycles per push, min/max and variance on\n", (unsigned)n,
+           BENCH_RUNS);
+    printf("window    random  sawtooth\n");
+    for (i = 0; i < sizeof(timed) / sizeof(timed[0]); i++)
+    {
+        STATS_Type* s = timed[i];
+        double random_cycles;
+        double saw_cycles;
+        uint32_t j;
+
+        make_stream(stream, n);
+        random_cycles = measure(s, stream, n);
+        for (j = 0; j < n; j++)
+        {
+            stream[j] = BENCH_BASE + (int32_t)(j % (2 * s->Window)) - (int32_t)s->Window;
+        }
+        saw_cycles = measure(s, stream, n);
+        printf("%6u %9.1f %9.1f\n", (unsigned)s->Window, random_cycles, saw_cycles);
+    }
+    free(stream);
+    return 0;
+}
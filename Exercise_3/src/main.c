@@ -19,6 +19,8 @@
 #include "lpc17xx_systick.h" /* Systic * SEk handling */
 #include "lpc17xx_timer.h"   /* Timer handling */
 #include "lpc17xx_adc.h"     /* ADC handling */
+#include "lpc17xx_prof.h"    /* Cycle counter profiling */
+#include "lpc17xx_stats.h"   /* Running statistics */
 
 /* Pin Definitions */
 
@@ -42,6 +44,12 @@
 
 /* ADC frequency */
 #define ADC_FREQ 100000 /* ADC frequency in [Hz] */
+#define ADC_WINDOW 16   /* Conversions averaged into adc_value */
+
+/* Profiling probes */
+#define PROF_EINT3 0  /* EINT3_IRQHandler duration */
+#define PROF_TIMER0 1 /* TIMER0_IRQHandler duration */
+#define PROF_ADC 2    /* ADC_IRQHandler duration */
 
 /* Port 0 */
 #define RED_LED_PIN ((uint32_t)(1 << 22))   /* P0.20 connected to RED_LED */
@@ -49,7 +57,8 @@
 #define BLUE_LED_PIN ((uint32_t)(1 << 21))  /* P0.22 connected to BLUE_LED */
 #define ADC_INPUT ((uint32_t)(1 << 2))      /* P0.2 connected to ADC_INPUT */
 
-static uint32_t adc_value = 0;
+static uint32_t adc_value = 0;         /* Mean of the last ADC_WINDOW conversions */
+STATS_DEFINE(adc_stats, ADC_WINDOW, 0); /* Window of the ADC conversions */
 
 /**
  * @brief Initialize the GPIO peripherals
@@ -57,24 +66,14 @@ static uint32_t adc_value = 0;
  */
 void configure_GPIO_ports(void)
 {
-    PINSEL_CFG_Type pin_cfg;
-
-    pin_cfg.Portnum = PINSEL_PORT_0;
-    pin_cfg.Pinnum = PINSEL_PIN_20;
-    pin_cfg.Funcnum = PINSEL_FUNC_0;
-    pin_cfg.Pinmode = PINSEL_PINMODE_PULLUP;
-    pin_cfg.OpenDrain = PINSEL_PINMODE_NORMAL;
-    PINSEL_ConfigPin(&pin_cfg);
-
-    pin_cfg.Pinnum = PINSEL_PIN_21;
-    PINSEL_ConfigPin(&pin_cfg);
-
-    pin_cfg.Pinnum = PINSEL_PIN_22;
-    PINSEL_ConfigPin(&pin_cfg);
+    static const PINSEL_CFG_Type pin_table[] = {
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_20, PINSEL_FUNC_0, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL),
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_21, PINSEL_FUNC_0, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL),
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_22, PINSEL_FUNC_0, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL),
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_2, PINSEL_FUNC_2, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL),
+    };
 
-    pin_cfg.Pinnum = PINSEL_PIN_2;
-    pin_cfg.Funcnum = PINSEL_FUNC_2;
-    PINSEL_ConfigPin(&pin_cfg);
+    PINSEL_ConfigPins(pin_table, PINSEL_TABLE_SIZE(pin_table));
 
     GPIO_SetDir(PINSEL_PORT_0, RED_LED_PIN | GREEN_LED_PIN | BLUE_LED_PIN, OUTPUT);
 }
@@ -115,6 +114,18 @@ void configure_ADC(void)
     ADC_IntConfig(LPC_ADC, ADC_ADINTEN7, ENABLE);
 }
 
+/**
+ * @brief Start the DWT cycle counter and name the profiling probes
+ *
+ */
+void configure_profiling(void)
+{
+    PROF_Init();
+    PROF_SetName(PROF_EINT3, "EINT3");
+    PROF_SetName(PROF_TIMER0, "TIMER0");
+    PROF_SetName(PROF_ADC, "ADC");
+}
+
 void start_interruptions(void)
 {
     NVIC_EnableIRQ(TIMER0_IRQn);
@@ -141,7 +152,9 @@ void start_ADC(void)
  */
 void EINT3_IRQHandler(void)
 {
+    uint32_t prof_start = PROF_Start(); /* Handler duration probe */
 
+    PROF_Stop(PROF_EINT3, prof_start);
 }
 
 /**
@@ -155,21 +168,30 @@ void SysTick_Handler(void)
 
 void TIMER0_IRQHandler(void)
 {
+    uint32_t prof_start = PROF_Start(); /* Handler duration probe */
+
     NVIC_DisableIRQ(TIMER0_IRQn);
 
     TIM_ClearIntPending(LPC_TIM0, TIM_MR0_INT);
     start_ADC();
 
     NVIC_EnableIRQ(TIMER0_IRQn);
+
+    PROF_Stop(PROF_TIMER0, prof_start);
 }
 
 void ADC_IRQHandler(void)
 {
+    uint32_t prof_start = PROF_Start(); /* Handler duration probe */
+
     NVIC_DisableIRQ(ADC_IRQn);
 
-    adc_value = ADC_ChannelGetData(LPC_ADC, ADC_CHANNEL_7);
+    STATS_Push(&adc_stats, (int32_t)ADC_ChannelGetData(LPC_ADC, ADC_CHANNEL_7));
+    adc_value = (uint32_t)STATS_GetMean(&adc_stats);
 
     NVIC_EnableIRQ(ADC_IRQn);
+
+    PROF_Stop(PROF_ADC, prof_start);
 }
 
 /**
@@ -179,6 +201,7 @@ void ADC_IRQHandler(void)
 int main(void)
 {
     SystemInit();           /* Initialize the system clock (default: 100 MHz) */
+    configure_profiling();  /* Start the profiling probes */
 
     configure_GPIO_ports(); /* Configure GPIO pins */
     configure_SysTick();    /* Configure SysTick */
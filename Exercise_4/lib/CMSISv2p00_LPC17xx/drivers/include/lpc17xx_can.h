@@ -61,6 +61,15 @@ extern "C"
 #define MAX_HW_FULLCAN_OBJ  64
 #define MAX_SW_FULLCAN_OBJ  32
 
+/** Size of the acceptance filter RAM, in words */
+#define CAN_AF_RAM_WORDS    512
+/** Shortest run of consecutive identifiers that CAN_LoadAFTable() makes a group */
+#define CAN_AF_GROUP_MIN    3
+/** Key of a standard identifier for CAN_LoadAFTable(): the AF RAM half word */
+#define CAN_AF_STD_KEY(ctrl, id) ((((uint32_t)(ctrl)) << 13) | ((uint32_t)(id) & 0x7FF))
+/** Key of an extended identifier for CAN_LoadAFTable(): the AF RAM word, flagged */
+#define CAN_AF_EXT_KEY(ctrl, id) ((1UL << 31) | (((uint32_t)(ctrl)) << 29) | ((uint32_t)(id) & 0x1FFFFFFF))
+
 /**
  * @}
  */
@@ -868,6 +877,8 @@ extern "C"
     CAN_ERROR CAN_LoadExplicitEntry(LPC_CAN_TypeDef* CANx, uint32_t ID, CAN_ID_FORMAT_Type format);
     CAN_ERROR CAN_LoadGroupEntry(LPC_CAN_TypeDef* CANx, uint32_t lowerID, uint32_t upperID, CAN_ID_FORMAT_Type format);
     CAN_ERROR CAN_RemoveEntry(AFLUT_ENTRY_Type EntryType, uint16_t position);
+    CAN_ERROR CAN_LoadAFTable(LPC_CANAF_TypeDef* CANAFx, uint32_t* keys, uint32_t count);
+    Bool CAN_LookupAFEntry(uint32_t key);
 
     /* CAN interrupt functions -----------------*/
     void CAN_IRQCmd(LPC_CAN_TypeDef* CANx, CAN_INT_EN_Type arg, FunctionalState NewState);
@@ -879,6 +890,82 @@ extern "C"
     uint32_t CAN_GetCTRLStatus(LPC_CAN_TypeDef* CANx, CAN_CTRL_STS_Type arg);
     uint32_t CAN_GetCRStatus(LPC_CANCR_TypeDef* CANCRx, CAN_CR_STS_Type arg);
 
+/* Call site checks of the CAN controller, acceptance filter and central
+   status arguments (CHECK_PARAM_CALL, lpc_types.h) */
+#ifdef CHECK_PARAM_CALLS
+#define CAN_Init(CANx, baudrate)                                                                                       \
+    (CHECK_PARAM_CALL(PARAM_CANx((CANx))),                                                                             \
+     CAN_Init(CANx, baudrate))
+#define CAN_DeInit(CANx)                                                                                               \
+    (CHECK_PARAM_CALL(PARAM_CANx((CANx))),                                                                             \
+     CAN_DeInit(CANx))
+#define CAN_SetupAFLUT(CANAFx, AFSection)                                                                              \
+    (CHECK_PARAM_CALL(PARAM_CANAFx((CANAFx))),                                                                         \
+     CAN_SetupAFLUT(CANAFx, AFSection))
+#define CAN_LoadExplicitEntry(CANx, id, format)                                                                        \
+    (CHECK_PARAM_CALL(PARAM_CANx((CANx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_ID_FORMAT((format))),                                                                      \
+     CAN_LoadExplicitEntry(CANx, id, format))
+#define CAN_LoadFullCANEntry(CANx, id)                                                                                 \
+    (CHECK_PARAM_CALL(PARAM_CANx((CANx))),                                                                             \
+     CAN_LoadFullCANEntry(CANx, id))
+#define CAN_LoadGroupEntry(CANx, lowerID, upperID, format)                                                             \
+    (CHECK_PARAM_CALL(PARAM_CANx((CANx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_ID_FORMAT((format))),                                                                      \
+     CAN_LoadGroupEntry(CANx, lowerID, upperID, format))
+#define CAN_RemoveEntry(EntryType, position)                                                                           \
+    (CHECK_PARAM_CALL(PARAM_AFLUT_ENTRY_TYPE((EntryType))),                                                            \
+     CHECK_PARAM_CALL(PARAM_POSITION((position))),                                                                     \
+     CAN_RemoveEntry(EntryType, position))
+#define CAN_LoadAFTable(CANAFx, keys, count)                                                                           \
+    (CHECK_PARAM_CALL(PARAM_CANAFx((CANAFx))),                                                                         \
+     CAN_LoadAFTable(CANAFx, keys, count))
+#define CAN_SendMsg(CANx, CAN_Msg)                                                                                     \
+    (CHECK_PARAM_CALL(PARAM_CANx((CANx))),                                                                             \
+     CAN_SendMsg(CANx, CAN_Msg))
+#define CAN_ReceiveMsg(CANx, CAN_Msg)                                                                                  \
+    (CHECK_PARAM_CALL(PARAM_CANx((CANx))),                                                                             \
+     CAN_ReceiveMsg(CANx, CAN_Msg))
+#define FCAN_ReadObj(CANAFx, CAN_Msg)                                                                                  \
+    (CHECK_PARAM_CALL(PARAM_CANAFx((CANAFx))),                                                                         \
+     FCAN_ReadObj(CANAFx, CAN_Msg))
+#define CAN_GetCTRLStatus(CANx, arg)                                                                                   \
+    (CHECK_PARAM_CALL(PARAM_CANx((CANx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_CTRL_STS_TYPE((arg))),                                                                     \
+     CAN_GetCTRLStatus(CANx, arg))
+#define CAN_GetCRStatus(CANCRx, arg)                                                                                   \
+    (CHECK_PARAM_CALL(PARAM_CANCRx((CANCRx))),                                                                         \
+     CHECK_PARAM_CALL(PARAM_CR_STS_TYPE((arg))),                                                                       \
+     CAN_GetCRStatus(CANCRx, arg))
+#define CAN_IRQCmd(CANx, arg, NewState)                                                                                \
+    (CHECK_PARAM_CALL(PARAM_CANx((CANx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_INT_EN_TYPE((arg))),                                                                       \
+     CHECK_PARAM_CALL(PARAM_FUNCTIONALSTATE((NewState))),                                                              \
+     CAN_IRQCmd(CANx, arg, NewState))
+#define CAN_SetAFMode(CANAFx, AFMode)                                                                                  \
+    (CHECK_PARAM_CALL(PARAM_CANAFx((CANAFx))),                                                                         \
+     CHECK_PARAM_CALL(PARAM_AFMODE_TYPE((AFMode))),                                                                    \
+     CAN_SetAFMode(CANAFx, AFMode))
+#define CAN_ModeConfig(CANx, mode, NewState)                                                                           \
+    (CHECK_PARAM_CALL(PARAM_CANx((CANx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_MODE_TYPE((mode))),                                                                        \
+     CHECK_PARAM_CALL(PARAM_FUNCTIONALSTATE((NewState))),                                                              \
+     CAN_ModeConfig(CANx, mode, NewState))
+#define CAN_SetCommand(CANx, CMRType)                                                                                  \
+    (CHECK_PARAM_CALL(PARAM_CANx((CANx))),                                                                             \
+     CAN_SetCommand(CANx, CMRType))
+#define CAN_IntGetStatus(CANx)                                                                                         \
+    (CHECK_PARAM_CALL(PARAM_CANx((CANx))),                                                                             \
+     CAN_IntGetStatus(CANx))
+#define CAN_FullCANIntGetStatus(CANAFx)                                                                                \
+    (CHECK_PARAM_CALL(PARAM_CANAFx((CANAFx))),                                                                         \
+     CAN_FullCANIntGetStatus(CANAFx))
+#define CAN_FullCANPendGetStatus(CANAFx, type)                                                                         \
+    (CHECK_PARAM_CALL(PARAM_CANAFx((CANAFx))),                                                                         \
+     CHECK_PARAM_CALL(PARAM_FULLCAN_IC((type))),                                                                       \
+     CAN_FullCANPendGetStatus(CANAFx, type))
+#endif
+
     /**
      * @}
      */
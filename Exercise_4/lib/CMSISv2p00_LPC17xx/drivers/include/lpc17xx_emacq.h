@@ -0,0 +1,214 @@
+/**********************************************************************
+ * $Id$		lpc17xx_emacq.h				2010-05-21
+ *//**
+* @file		lpc17xx_emacq.h
+* @brief	Contains the zero-copy EMAC descriptor rings and event loop for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup EMACQ EMACQ (Zero-copy EMAC descriptor rings)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_EMACQ_H_
+#define LPC17XX_EMACQ_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+#include "lpc17xx_emac.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup EMACQ_Public_Macros EMACQ Public Macros
+ * @{
+ */
+
+/** Largest receive buffer and transmit fragment, the size field of a descriptor */
+#define EMACQ_MAX_BUF_SIZE 2048
+
+/** Bytes of the descriptor area needed by rx receive descriptors of size bytes
+ * each and tx transmit descriptors: per receive descriptor a descriptor, a
+ * status, a time stamp and the buffer, per transmit descriptor a descriptor,
+ * a status, a time stamp and the frame tag */
+#define EMACQ_MEM_SIZE(rx, tx, size) ((rx) * (20 + (size)) + (tx) * (16 + sizeof(void*)))
+
+/** EMAC interrupts of the event loop */
+#define EMACQ_INT_RX (EMAC_INT_RX_DONE | EMAC_INT_RX_FIN)
+#define EMACQ_INT_ALL (EMACQ_INT_RX | EMAC_INT_RX_OVERRUN | EMAC_INT_TX_DONE | EMAC_INT_TX_UNDERRUN)
+
+/** Macro to check a receive buffer size: a multiple of 4, up to EMACQ_MAX_BUF_SIZE */
+#define PARAM_EMACQ_BUF_SIZE(n) (((n) != 0) && (((n) & 3) == 0) && ((n) <= EMACQ_MAX_BUF_SIZE))
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup EMACQ_Public_Types EMACQ Public Types
+     * @{
+     */
+
+    /**
+     * @brief A received frame lent to the application: Count consecutive
+     * descriptors of the receive ring from Index, wrapping at the end */
+    typedef struct
+    {
+        uint16_t Index;  /**< First descriptor of the frame */
+        uint16_t Count;  /**< Number of descriptors, and buffers, of the frame */
+        uint32_t Length; /**< Frame length in bytes, FCS included */
+    } EMACQ_FRAME_Type;
+
+    /**
+     * @brief One transmit fragment, the data is not copied */
+    typedef struct
+    {
+        const void* Data; /**< Fragment data, in AHB SRAM */
+        uint32_t Length;  /**< Length in bytes, 1 to EMACQ_MAX_BUF_SIZE */
+    } EMACQ_FRAG_Type;
+
+    /**
+     * @brief Descriptor rings configuration */
+    typedef struct
+    {
+        void* Mem;          /**< Descriptors, statuses and receive buffers, AHB SRAM, 8 byte aligned */
+        uint32_t MemSize;   /**< Size of Mem in bytes, at least EMACQ_MEM_SIZE() */
+        uint16_t RxCount;   /**< Receive descriptors, one buffer each, 2 or more */
+        uint16_t RxBufSize; /**< Bytes per receive buffer, see PARAM_EMACQ_BUF_SIZE() */
+        uint16_t TxCount;   /**< Transmit descriptors, one fragment each, 2 or more */
+        void (*TxDone)(void* tag, uint32_t info); /**< Sent frame callback, NULL for none */
+        void (*RxFrame)(const EMACQ_FRAME_Type* frame); /**< Event loop frame handler, NULL for none */
+        uint16_t IrqBudget;  /**< Frames per interrupt before polling takes over, 0: no limit, polls after overruns only */
+        uint16_t PollBudget; /**< Frames handled per EMACQ_Poll() call, 1 or more */
+    } EMACQ_CFG_Type;
+
+    /**
+     * @brief Descriptor rings state. The fields are private */
+    typedef struct
+    {
+        EMACQ_CFG_Type Cfg;             /**< Copy of the configuration */
+        RX_Stat* RxStat;                /**< Receive statuses, in Cfg.Mem */
+        RX_Desc* RxDesc;                /**< Receive descriptors, in Cfg.Mem */
+        TX_Desc* TxDesc;                /**< Transmit descriptors, in Cfg.Mem */
+        void** TxTag;                   /**< Tag of each transmit descriptor, in Cfg.Mem */
+        TX_Stat* TxStat;                /**< Transmit statuses, in Cfg.Mem */
+        uint32_t* RxStamp;              /**< Cycle count each receive descriptor was first seen at */
+        uint32_t* TxStamp;              /**< Cycle count each frame was queued at, by its last descriptor */
+        uint8_t* RxBuf;                 /**< Receive buffers, in Cfg.Mem */
+        uint32_t RxConsume;             /**< Copy of RxConsumeIndex: first descriptor lent or not released */
+        volatile uint32_t RxNext;       /**< First descriptor not lent out yet */
+        uint32_t RxSeen;                /**< First descriptor not time stamped yet */
+        uint32_t TxProduce;             /**< Copy of TxProduceIndex: next descriptor to fill */
+        volatile uint32_t TxDone;       /**< First descriptor not reclaimed yet */
+        volatile uint8_t Polling;       /**< Receive interrupts masked, EMACQ_Poll() handles the frames */
+        volatile uint8_t RxStopped;     /**< Receive overrun: 1 until RxEnd is known, 2 until the ring is empty */
+        uint32_t RxEnd;                 /**< End of the frames completed before the overrun */
+        volatile uint8_t TxStopped;     /**< Transmit underrun being recovered, EMACQ_Send() refuses frames */
+        volatile uint32_t RxFrames;     /**< Frames lent out */
+        volatile uint32_t RxErrors;     /**< Frames received with an error, released unseen */
+        volatile uint32_t RxFull;       /**< Times the receive ring was found full */
+        volatile uint32_t RxOverruns;   /**< Receive datapath overruns, each followed by a datapath reset */
+        volatile uint32_t TxFrames;     /**< Frames sent */
+        volatile uint32_t TxErrors;     /**< Frames whose transmission failed */
+        volatile uint32_t TxFull;       /**< Frames refused by EMACQ_Send(), the ring was full or being reset */
+        volatile uint32_t TxUnderruns;  /**< Transmit datapath underruns, each followed by a datapath reset */
+        volatile uint32_t Interrupts;   /**< EMAC interrupts taken */
+        volatile uint32_t PollSwitches; /**< Times the event loop went over to polling */
+        uint32_t RxLatencyMin;          /**< Shortest frame handler latency, in cycles */
+        uint32_t RxLatencyMax;          /**< Longest frame handler latency, in cycles */
+        uint64_t RxLatencyTotal;        /**< Sum of the frame handler latencies */
+        uint32_t RxHandled;             /**< Frames given to the frame handler */
+        uint32_t TxLatencyMin;          /**< Shortest queued to reclaimed time, in cycles */
+        uint32_t TxLatencyMax;          /**< Longest queued to reclaimed time, in cycles */
+        uint64_t TxLatencyTotal;        /**< Sum of the queued to reclaimed times */
+    } EMACQ_Type;
+
+    /**
+     * @brief Descriptor rings statistics. Latencies are in core clock cycles */
+    typedef struct
+    {
+        uint32_t RxFrames;      /**< Frames lent out */
+        uint32_t RxErrors;      /**< Frames received with an error, released unseen */
+        uint32_t RxLent;        /**< Receive descriptors lent out and not released yet */
+        uint32_t RxFull;        /**< Times the receive ring was found full, frames arriving then are dropped */
+        uint32_t RxOverruns;    /**< Receive datapath overruns, each followed by a datapath reset */
+        uint32_t RxLatencyMin;  /**< Shortest time from first seen in the ring to the frame handler */
+        uint32_t RxLatencyMax;  /**< Longest such time */
+        uint32_t RxLatencyMean; /**< Mean such time */
+        uint32_t TxFrames;      /**< Frames sent */
+        uint32_t TxErrors;      /**< Frames whose transmission failed */
+        uint32_t TxQueued;      /**< Transmit descriptors queued or sent and not reclaimed yet */
+        uint32_t TxFull;        /**< Frames refused by EMACQ_Send(), the ring was full or being reset */
+        uint32_t TxUnderruns;   /**< Transmit datapath underruns, the frames queued then failed */
+        uint32_t TxLatencyMin;  /**< Shortest time from EMACQ_Send() to reclaimed */
+        uint32_t TxLatencyMax;  /**< Longest such time */
+        uint32_t TxLatencyMean; /**< Mean such time */
+        uint32_t Interrupts;    /**< EMAC interrupts taken */
+        uint32_t PollSwitches;  /**< Times the event loop went over to polling */
+        uint8_t Polling;        /**< 1 while the event loop is polling */
+    } EMACQ_STATS_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup EMACQ_Public_Functions EMACQ Public Functions
+     * @{
+     */
+
+    Status EMACQ_Init(EMACQ_Type* emacq, const EMACQ_CFG_Type* cfg);
+    Bool EMACQ_Receive(EMACQ_Type* emacq, EMACQ_FRAME_Type* frame);
+    uint8_t* EMACQ_GetFragment(const EMACQ_Type* emacq, const EMACQ_FRAME_Type* frame, uint32_t n,
+                               uint32_t* len);
+    void EMACQ_Release(EMACQ_Type* emacq, const EMACQ_FRAME_Type* frame);
+    Status EMACQ_Send(EMACQ_Type* emacq, const EMACQ_FRAG_Type* frags, uint32_t count, void* tag);
+    uint32_t EMACQ_ReclaimTx(EMACQ_Type* emacq);
+    void EMACQ_GetStats(const EMACQ_Type* emacq, EMACQ_STATS_Type* stats);
+    void EMACQ_IntHandler(EMACQ_Type* emacq);
+    uint32_t EMACQ_Poll(EMACQ_Type* emacq);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_EMACQ_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
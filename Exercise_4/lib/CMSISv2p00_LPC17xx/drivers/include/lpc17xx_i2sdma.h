@@ -0,0 +1,153 @@
+/**********************************************************************
+ * $Id$		lpc17xx_i2sdma.h				2010-05-21
+ *//**
+* @file		lpc17xx_i2sdma.h
+* @brief	Contains the streaming I2S audio through GPDMA ping-pong buffers for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup I2SDMA I2SDMA (Streaming I2S audio through GPDMA)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_I2SDMA_H_
+#define LPC17XX_I2SDMA_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+#include "lpc17xx_i2s.h"
+#include "lpc17xx_gpdma.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup I2SDMA_Public_Macros I2SDMA Public Macros
+ * @{
+ */
+
+/** Stream directions */
+#define I2SDMA_TX     ((uint8_t)(1 << 0))
+#define I2SDMA_RX     ((uint8_t)(1 << 1))
+#define I2SDMA_DUPLEX (I2SDMA_TX | I2SDMA_RX)
+
+/** FIFO level of the DMA requests, half the 8 word FIFOs. It matches the GPDMA burst of I2S */
+#define I2SDMA_DEPTH 4
+
+/** Largest buffer, in FIFO words. Each half is one DMA pass of at most 4095 transfers */
+#define I2SDMA_MAX_WORDS 8190
+
+/** Samples in a buffer of n FIFO words: a word holds a 16-bit stereo frame or two mono samples */
+#define I2SDMA_SAMPLES(n) ((n) * 2)
+
+/** Macro to check the buffer size */
+#define PARAM_I2SDMA_SIZE(n) (((n) >= 2) && ((n) <= I2SDMA_MAX_WORDS) && (((n) & 1) == 0))
+
+/** Macro to check the direction */
+#define PARAM_I2SDMA_DIR(n) (((n) == I2SDMA_TX) || ((n) == I2SDMA_RX) || ((n) == I2SDMA_DUPLEX))
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup I2SDMA_Public_Types I2SDMA Public Types
+     * @{
+     */
+
+    /**
+     * @brief Half buffer callback. rx is the half just received, tx the half just
+     * played, to be refilled; either is NULL when the stream does not run that way.
+     * Samples are 16-bit, stereo interleaved left first. Runs in the DMA interrupt.
+     * In duplex the tx half is played one half buffer after rx was received, so
+     * writing the processed rx into tx gives a constant latency of BufferSize words.
+     * The callback must return within a half buffer less I2SDMA_DEPTH words */
+    typedef void (*I2SDMA_CALLBACK_Type)(const int16_t* rx, int16_t* tx, uint32_t samples);
+
+    /**
+     * @brief Audio stream configuration structure */
+    typedef struct
+    {
+        uint32_t Rate;                 /**< Sample rate in Hz, 16000 to 96000 */
+        uint8_t Mono;                  /**< I2S_STEREO or I2S_MONO */
+        uint8_t Direction;             /**< I2SDMA_TX, I2SDMA_RX or I2SDMA_DUPLEX. In duplex the
+                                            receiver runs in 4-pin mode on the transmitter clocks */
+        uint8_t TxDMAChannel;          /**< GPDMA channel, 0 to 7, of the transmitter (I2S DMA1) */
+        uint8_t RxDMAChannel;          /**< GPDMA channel, 0 to 7, of the receiver (I2S DMA2) */
+        int16_t* TxBuffer;             /**< Transmit buffer, word aligned, used as two halves */
+        int16_t* RxBuffer;             /**< Receive buffer, word aligned, used as two halves */
+        uint16_t BufferSize;           /**< Size of each buffer in FIFO words, even, 2 to
+                                            I2SDMA_MAX_WORDS */
+        I2SDMA_CALLBACK_Type Callback; /**< Called with each half */
+    } I2SDMA_CFG_Type;
+
+    /**
+     * @brief Audio stream state. The fields are private */
+    typedef struct
+    {
+        I2SDMA_CFG_Type Cfg;     /**< Copy of the configuration */
+        GPDMA_LLI_Type* TxChain; /**< Circular chain over the transmit buffer, one item per half */
+        GPDMA_LLI_Type* RxChain; /**< Circular chain over the receive buffer, one item per half */
+        uint32_t Overruns;       /**< Halves lost because the callback ran late */
+        uint8_t NextHalf;        /**< Half expected to complete next */
+    } I2SDMA_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup I2SDMA_Public_Functions I2SDMA Public Functions
+     * @{
+     */
+
+    Status I2SDMA_Init(I2SDMA_Type* stream, const I2SDMA_CFG_Type* cfg);
+    void I2SDMA_Start(I2SDMA_Type* stream);
+    void I2SDMA_Stop(I2SDMA_Type* stream);
+    Bool I2SDMA_IntHandler(I2SDMA_Type* stream);
+    uint32_t I2SDMA_GetOverruns(const I2SDMA_Type* stream);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_I2SDMA_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
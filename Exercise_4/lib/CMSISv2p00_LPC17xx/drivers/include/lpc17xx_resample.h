@@ -0,0 +1,133 @@
+/**********************************************************************
+ * $Id$		lpc17xx_resample.h				2010-05-21
+ *//**
+* @file		lpc17xx_resample.h
+* @brief	Contains the fixed-point FIR sample-rate conversion of audio blocks for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup RESAMPLE RESAMPLE (Fixed-point FIR sample-rate conversion)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_RESAMPLE_H_
+#define LPC17XX_RESAMPLE_H_
+
+/* Includes ------------------------------------------------------------------- */
+#ifndef ARM_MATH_CM3
+#define ARM_MATH_CM3
+#endif
+#include "LPC17xx.h"
+#include "lpc_types.h"
+#include "arm_math.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup RESAMPLE_Public_Macros RESAMPLE Public Macros
+ * @{
+ */
+
+/** State samples needed by a converter of ch channels, taps coefficients per
+ * filter, factor and block frames per call at the high rate: the filter
+ * histories, and for stereo the scratch of the de-interleaved channels */
+#define RESAMPLE_STATE_SIZE(ch, taps, factor, block)                                                    \
+    ((ch) * (((taps) + (block) - 1) + ((taps) / (factor) + (block) / (factor) - 1)) +                  \
+     (((ch) == 2) ? 2 * ((block) + (block) / (factor)) : 0))
+
+/** Macro to check the configuration */
+#define PARAM_RESAMPLE_FACTOR(n)      (((n) >= 2) && ((n) <= 255))
+#define PARAM_RESAMPLE_CHANNELS(n)    (((n) == 1) || ((n) == 2))
+#define PARAM_RESAMPLE_MULTIPLE(n, f) (((n) != 0) && (((n) % (f)) == 0))
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup RESAMPLE_Public_Types RESAMPLE Public Types
+     * @{
+     */
+
+    /**
+     * @brief Converter configuration structure. Both filters are low-pass at
+     * half the low rate, linear phase (symmetric) so the time reversed order the
+     * CMSIS-DSP filters expect is the natural one */
+    typedef struct
+    {
+        uint8_t Factor;     /**< Ratio of the high to the low rate, 2 to 255 */
+        uint8_t Channels;   /**< 1, or 2 for interleaved stereo left first */
+        uint16_t NumTaps;   /**< Coefficients of each filter, a multiple of Factor */
+        uint16_t BlockSize; /**< Frames per call at the high rate, a multiple of Factor */
+        q15_t* DownCoeffs;  /**< Decimation filter, unity gain, NULL if RESAMPLE_Down() is not used */
+        q15_t* UpCoeffs;    /**< Interpolation filter, gain Factor, NULL if RESAMPLE_Up() is not used */
+        q15_t* State;       /**< RESAMPLE_STATE_SIZE(Channels, NumTaps, Factor, BlockSize) samples */
+    } RESAMPLE_CFG_Type;
+
+    /**
+     * @brief Converter state. The fields are private */
+    typedef struct
+    {
+        RESAMPLE_CFG_Type Cfg;                  /**< Copy of the configuration */
+        arm_fir_decimate_instance_q15 Down[2];  /**< Decimator of each channel */
+        arm_fir_interpolate_instance_q15 Up[2]; /**< Interpolator of each channel */
+        q15_t* Scratch;                         /**< De-interleaved channels, stereo only */
+    } RESAMPLE_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup RESAMPLE_Public_Functions RESAMPLE Public Functions
+     * @{
+     */
+
+    Status RESAMPLE_Init(RESAMPLE_Type* r, const RESAMPLE_CFG_Type* cfg);
+    void RESAMPLE_Down(RESAMPLE_Type* r, const q15_t* src, q15_t* dst);
+    void RESAMPLE_Up(RESAMPLE_Type* r, const q15_t* src, q15_t* dst);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_RESAMPLE_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -38,6 +38,7 @@
 /* Includes ------------------------------------------------------------------- */
 #include "lpc17xx_emac.h"
 #include "lpc17xx_clkpwr.h"
+#include "lpc17xx_crc.h"
 
 /* If this source file built with example, the LPC17xx FW library configuration
  * file in each example directory ("lpc17xx_libcfg.h") must be included,
@@ -51,6 +52,30 @@
 
 #ifdef _EMAC
 
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup EMAC_Private_Macros EMAC Private Macros
+ * @{
+ */
+
+/* Steps of the PHY management state machine */
+#define EMAC_PHY_STEP_RESET      (0) /**< Write the BMCR reset bit */
+#define EMAC_PHY_STEP_WAIT_RESET (1) /**< Read BMCR until the reset is over */
+#define EMAC_PHY_STEP_ID1        (2) /**< Read the PHY identifier */
+#define EMAC_PHY_STEP_ID2        (3)
+#define EMAC_PHY_STEP_MODE       (4) /**< Write the requested mode to BMCR */
+#define EMAC_PHY_STEP_LINK       (5) /**< Read the link status every PollInterval ticks */
+
+/** PHY register holding the link status */
+#ifdef MCB_LPC_1768
+#define EMAC_PHY_REG_LINK EMAC_PHY_REG_STS
+#elif defined(IAR_LPC_1768)
+#define EMAC_PHY_REG_LINK EMAC_PHY_REG_BMSR
+#endif
+
+/**
+ * @}
+ */
+
 /* Private Variables ---------------------------------------------------------- */
 /** @defgroup EMAC_Private_Variables EMAC Private Variables
  * @{
@@ -85,6 +110,27 @@ static uint32_t rx_buf[EMAC_NUM_RX_FRAG][EMAC_ETH_MAX_FLEN >> 2];
 /** Tx buffer data */
 static uint32_t tx_buf[EMAC_NUM_TX_FRAG][EMAC_ETH_MAX_FLEN >> 2];
 
+/* PHY management state machine, see EMAC_PHYTick() */
+/** Configuration given to EMAC_InitAsync() */
+static EMAC_PHY_CFG_Type phy_cfg;
+/** State seen by the application */
+static volatile EMAC_PHY_STATE_Type phy_state = EMAC_PHY_STOPPED;
+/** Current step, one MII transaction each */
+static uint32_t phy_step;
+/** BMCR value of the requested mode */
+static uint16_t phy_mode;
+/** 1 while the transaction of the step is on the MII */
+static uint8_t phy_pending;
+/** Ticks since the reset started, or since the last link status read */
+static uint32_t phy_ticks;
+/** First half of the PHY identifier */
+static int32_t phy_id1;
+/** EMAC_LINK_ bits as last read */
+static volatile uint32_t phy_link;
+/** PHY register of each step */
+static const uint8_t emac_phy_step_reg[] = {EMAC_PHY_REG_BMCR, EMAC_PHY_REG_BMCR, EMAC_PHY_REG_IDR1,
+                                            EMAC_PHY_REG_IDR2, EMAC_PHY_REG_BMCR, EMAC_PHY_REG_LINK};
+
 /**
  * @}
  */
@@ -96,7 +142,13 @@ static int32_t write_PHY(uint32_t PhyReg, uint16_t Value);
 static int32_t read_PHY(uint32_t PhyReg);
 
 static void setEmacAddr(uint8_t abStationAddr[]);
-static int32_t emac_CRCCalc(uint8_t frame_no_fcs[], int32_t frame_len);
+static void emac_mac_init(void);
+static void emac_datapath_init(EMAC_CFG_Type* EMAC_ConfigStruct);
+static int32_t emac_phy_mode(uint32_t ulPHYMode);
+static Bool emac_phy_id_ok(int32_t id1, int32_t id2);
+static uint32_t emac_link_status(int32_t regv);
+static void emac_set_link(uint32_t link);
+static void emac_phy_result(int32_t regv);
 
 /*--------------------------- rx_descr_init ---------------------------------*/
 /*********************************************************************/ /**
@@ -111,15 +163,15 @@ static void rx_descr_init(void)
 
     for (i = 0; i < EMAC_NUM_RX_FRAG; i++)
     {
-        Rx_Desc[i].Packet = (uint32_t)&rx_buf[i];
+        Rx_Desc[i].Packet = ADDR32(&rx_buf[i]);
         Rx_Desc[i].Ctrl = EMAC_RCTRL_INT | (EMAC_ETH_MAX_FLEN - 1);
         Rx_Stat[i].Info = 0;
         Rx_Stat[i].HashCRC = 0;
     }
 
     /* Set EMAC Receive Descriptor Registers. */
-    LPC_EMAC->RxDescriptor = (uint32_t)&Rx_Desc[0];
-    LPC_EMAC->RxStatus = (uint32_t)&Rx_Stat[0];
+    LPC_EMAC->RxDescriptor = ADDR32(&Rx_Desc[0]);
+    LPC_EMAC->RxStatus = ADDR32(&Rx_Stat[0]);
     LPC_EMAC->RxDescriptorNumber = EMAC_NUM_RX_FRAG - 1;
 
     /* Rx Descriptors Point to 0 */
@@ -139,14 +191,14 @@ static void tx_descr_init(void)
 
     for (i = 0; i < EMAC_NUM_TX_FRAG; i++)
     {
-        Tx_Desc[i].Packet = (uint32_t)&tx_buf[i];
+        Tx_Desc[i].Packet = ADDR32(&tx_buf[i]);
         Tx_Desc[i].Ctrl = 0;
         Tx_Stat[i].Info = 0;
     }
 
     /* Set EMAC Transmit Descriptor Registers. */
-    LPC_EMAC->TxDescriptor = (uint32_t)&Tx_Desc[0];
-    LPC_EMAC->TxStatus = (uint32_t)&Tx_Stat[0];
+    LPC_EMAC->TxDescriptor = ADDR32(&Tx_Desc[0]);
+    LPC_EMAC->TxStatus = ADDR32(&Tx_Stat[0]);
     LPC_EMAC->TxDescriptorNumber = EMAC_NUM_TX_FRAG - 1;
 
     /* Tx Descriptors Point to 0 */
@@ -229,65 +281,253 @@ static void setEmacAddr(uint8_t abStationAddr[])
 }
 
 /*********************************************************************/ /**
-                                                                         * @brief		Calculates CRC code for number of
-                                                                         *bytes in the frame
-                                                                         * @param[in]	frame_no_fcs	Pointer to the
-                                                                         *first byte of the frame
-                                                                         * @param[in]	frame_len		length of the frame
-                                                                         *without the FCS
-                                                                         * @return		the CRC as a 32 bit integer
+                                                                         * @brief		Reset the MAC and set up its control and MII management
+                                                                         * registers, the first part of EMAC initialization
+                                                                         * @param[in]	None
+                                                                         * @return		None
                                                                          **********************************************************************/
-static int32_t emac_CRCCalc(uint8_t frame_no_fcs[], int32_t frame_len)
+static void emac_mac_init(void)
 {
-    int i;              // iterator
-    int j;              // another iterator
-    char byte;          // current byte
-    int crc;            // CRC result
-    int q0, q1, q2, q3; // temporary variables
-    crc = 0xFFFFFFFF;
-    for (i = 0; i < frame_len; i++)
+    int32_t tout, tmp;
+
+    /* Set up clock and power for Ethernet module */
+    CLKPWR_ConfigPPWR(CLKPWR_PCONP_PCENET, ENABLE);
+
+    /* Reset all EMAC internal modules */
+    LPC_EMAC->MAC1 = EMAC_MAC1_RES_TX | EMAC_MAC1_RES_MCS_TX | EMAC_MAC1_RES_RX | EMAC_MAC1_RES_MCS_RX |
+                     EMAC_MAC1_SIM_RES | EMAC_MAC1_SOFT_RES;
+
+    LPC_EMAC->Command = EMAC_CR_REG_RES | EMAC_CR_TX_RES | EMAC_CR_RX_RES | EMAC_CR_PASS_RUNT_FRM;
+
+    /* A short delay after reset. */
+    for (tout = 100; tout; tout--)
+        ;
+
+    /* Initialize MAC control registers. */
+    LPC_EMAC->MAC1 = EMAC_MAC1_PASS_ALL;
+    LPC_EMAC->MAC2 = EMAC_MAC2_CRC_EN | EMAC_MAC2_PAD_EN;
+    LPC_EMAC->MAXF = EMAC_ETH_MAX_FLEN;
+    /*
+     * Find the clock that close to desired target clock
+     */
+    tmp = SystemCoreClock / EMAC_MCFG_MII_MAXCLK;
+    for (tout = 0; tout < sizeof(EMAC_clkdiv); tout++)
     {
-        byte = *frame_no_fcs++;
-        for (j = 0; j < 2; j++)
-        {
-            if (((crc >> 28) ^ (byte >> 3)) & 0x00000001)
-            {
-                q3 = 0x04C11DB7;
-            }
-            else
-            {
-                q3 = 0x00000000;
-            }
-            if (((crc >> 29) ^ (byte >> 2)) & 0x00000001)
+        if (EMAC_clkdiv[tout] >= tmp)
+            break;
+    }
+    tout++;
+    // Write to MAC configuration register and reset
+    LPC_EMAC->MCFG = EMAC_MCFG_CLK_SEL(tout) | EMAC_MCFG_RES_MII;
+    // release reset
+    LPC_EMAC->MCFG &= ~(EMAC_MCFG_RES_MII);
+    LPC_EMAC->CLRT = EMAC_CLRT_DEF;
+    LPC_EMAC->IPGR = EMAC_IPGR_P2_DEF;
+
+    /* Enable Reduced MII interface. */
+    LPC_EMAC->Command = EMAC_CR_RMII | EMAC_CR_PASS_RUNT_FRM;
+
+    /* Reset Reduced MII Logic. */
+    //	LPC_EMAC->SUPP = EMAC_SUPP_RES_RMII;
+
+    for (tout = 100; tout; tout--)
+        ;
+    LPC_EMAC->SUPP = 0;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Set the station address, the descriptors, the receive
+                                                                         * filter and the interrupts, then enable both datapaths, the last
+                                                                         * part of EMAC initialization
+                                                                         * @param[in]	EMAC_ConfigStruct Pointer to the EMAC configuration
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void emac_datapath_init(EMAC_CFG_Type* EMAC_ConfigStruct)
+{
+    // Set EMAC address
+    setEmacAddr(EMAC_ConfigStruct->pbEMAC_Addr);
+
+    /* Initialize Tx and Rx DMA Descriptors */
+    rx_descr_init();
+    tx_descr_init();
+
+    // Set Receive Filter register: enable broadcast and multicast
+    LPC_EMAC->RxFilterCtrl = EMAC_RFC_MCAST_EN | EMAC_RFC_BCAST_EN | EMAC_RFC_PERFECT_EN;
+
+    /* Enable Rx Done and Tx Done interrupt for EMAC */
+    LPC_EMAC->IntEnable = EMAC_INT_RX_DONE | EMAC_INT_TX_DONE;
+
+    /* Reset all interrupts */
+    LPC_EMAC->IntClear = 0xFFFF;
+
+    /* Enable receive and transmit mode of MAC Ethernet core */
+    LPC_EMAC->Command |= (EMAC_CR_RX_EN | EMAC_CR_TX_EN);
+    LPC_EMAC->MAC1 |= EMAC_MAC1_REC_EN;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		BMCR value of an EMAC mode
+                                                                         * @param[in]	ulPHYMode	EMAC_MODE_AUTO or a forced mode
+                                                                         * @return		BMCR value, (-1) for an unsupported mode
+                                                                         **********************************************************************/
+static int32_t emac_phy_mode(uint32_t ulPHYMode)
+{
+    switch (ulPHYMode)
+    {
+        case EMAC_MODE_AUTO: return (EMAC_PHY_AUTO_NEG);
+        case EMAC_MODE_10M_FULL: return (EMAC_PHY_FULLD_10M);
+        case EMAC_MODE_10M_HALF: return (EMAC_PHY_HALFD_10M);
+        case EMAC_MODE_100M_FULL: return (EMAC_PHY_FULLD_100M);
+        case EMAC_MODE_100M_HALF: return (EMAC_PHY_HALFD_100M);
+        default: return (-1);
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Check the PHY identifier against the PHY of the board
+                                                                         * @param[in]	id1		PHY Identifier 1 register
+                                                                         * @param[in]	id2		PHY Identifier 2 register
+                                                                         * @return		TRUE if it is the expected PHY
+                                                                         **********************************************************************/
+static Bool emac_phy_id_ok(int32_t id1, int32_t id2)
+{
+#ifdef MCB_LPC_1768
+    return ((((id1 << 16) | (id2 & 0xFFF0)) == EMAC_DP83848C_ID) ? TRUE : FALSE);
+#elif defined(IAR_LPC_1768)
+    return ((((id1 << 16) | id2) == EMAC_KSZ8721BL_ID) ? TRUE : FALSE);
+#endif
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Decode the link status register of the PHY
+                                                                         * @param[in]	regv	Value of EMAC_PHY_REG_LINK
+                                                                         * @return		EMAC_LINK_ bits
+                                                                         **********************************************************************/
+static uint32_t emac_link_status(int32_t regv)
+{
+    uint32_t link = 0;
+
+#ifdef MCB_LPC_1768
+    if (regv & EMAC_PHY_SR_LINK)
+    {
+        link |= EMAC_LINK_UP;
+    }
+    if (!(regv & EMAC_PHY_SR_SPEED))
+    {
+        link |= EMAC_LINK_100M;
+    }
+    if (regv & EMAC_PHY_SR_DUP)
+    {
+        link |= EMAC_LINK_FULL_DUP;
+    }
+#elif defined(IAR_LPC_1768)
+    if (regv & EMAC_PHY_BMSR_LINK_STATUS)
+    {
+        link |= EMAC_LINK_UP;
+    }
+    if (regv & EMAC_PHY_SR_100_SPEED)
+    {
+        link |= EMAC_LINK_100M;
+    }
+    if (regv & EMAC_PHY_SR_FULL_DUP)
+    {
+        link |= EMAC_LINK_FULL_DUP;
+    }
+#endif
+    return link;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Set the MAC to the speed and duplex of the link
+                                                                         * @param[in]	link	EMAC_LINK_ bits
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void emac_set_link(uint32_t link)
+{
+    if (link & EMAC_LINK_FULL_DUP)
+    {
+        /* Full duplex is enabled. */
+        LPC_EMAC->MAC2 |= EMAC_MAC2_FULL_DUP;
+        LPC_EMAC->Command |= EMAC_CR_FULL_DUP;
+        LPC_EMAC->IPGT = EMAC_IPGT_FULL_DUP;
+    }
+    else
+    {
+        /* Half duplex mode. */
+        LPC_EMAC->MAC2 &= ~EMAC_MAC2_FULL_DUP;
+        LPC_EMAC->Command &= ~EMAC_CR_FULL_DUP;
+        LPC_EMAC->IPGT = EMAC_IPGT_HALF_DUP;
+    }
+    LPC_EMAC->SUPP = (link & EMAC_LINK_100M) ? EMAC_SUPP_SPEED : 0;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Take the outcome of the finished MII transaction of the
+                                                                         * current step and move the PHY management state machine on
+                                                                         * @param[in]	regv	Value read, unused after a write
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void emac_phy_result(int32_t regv)
+{
+    uint32_t link;
+
+    switch (phy_step)
+    {
+        case EMAC_PHY_STEP_RESET: phy_step = EMAC_PHY_STEP_WAIT_RESET; break;
+        case EMAC_PHY_STEP_WAIT_RESET:
+            if (!(regv & (EMAC_PHY_BMCR_RESET | EMAC_PHY_BMCR_POWERDOWN)))
             {
-                q2 = 0x09823B6E;
+                /* Reset complete, device not Power Down. */
+                phy_step = EMAC_PHY_STEP_ID1;
             }
-            else
+            else if (phy_ticks > phy_cfg.ResetTimeout)
             {
-                q2 = 0x00000000;
+                phy_state = EMAC_PHY_FAILED;
             }
-            if (((crc >> 30) ^ (byte >> 1)) & 0x00000001)
+            break;
+        case EMAC_PHY_STEP_ID1:
+            phy_id1 = regv;
+            phy_step = EMAC_PHY_STEP_ID2;
+            break;
+        case EMAC_PHY_STEP_ID2:
+            if (emac_phy_id_ok(phy_id1, regv))
             {
-                q1 = 0x130476DC;
+                phy_step = EMAC_PHY_STEP_MODE;
             }
             else
             {
-                q1 = 0x00000000;
+                phy_state = EMAC_PHY_FAILED;
             }
-            if (((crc >> 31) ^ (byte >> 0)) & 0x00000001)
+            break;
+        case EMAC_PHY_STEP_MODE:
+            /* First link status read right away */
+            phy_step = EMAC_PHY_STEP_LINK;
+            phy_ticks = phy_cfg.PollInterval;
+            phy_state = EMAC_PHY_LINK_DOWN;
+            break;
+        default:
+            link = emac_link_status(regv);
+            if (!(link & EMAC_LINK_UP))
             {
-                q0 = 0x2608EDB8;
+                link = 0;
             }
-            else
+            if (link != phy_link)
             {
-                q0 = 0x00000000;
+                if (link & EMAC_LINK_UP)
+                {
+                    emac_set_link(link);
+                }
+                phy_link = link;
+                phy_state = (link & EMAC_LINK_UP) ? EMAC_PHY_LINK_UP : EMAC_PHY_LINK_DOWN;
+                if (phy_cfg.LinkChange != NULL)
+                {
+                    phy_cfg.LinkChange(link);
+                }
             }
-            crc = (crc << 4) ^ q3 ^ q2 ^ q1 ^ q0;
-            byte >>= 4;
-        }
+            break;
     }
-    return crc;
 }
+
 /* End of Private Functions --------------------------------------------------- */
 
 /* Public Functions ----------------------------------------------------------- */
@@ -325,51 +565,12 @@ static int32_t emac_CRCCalc(uint8_t frame_no_fcs[], int32_t frame_len)
 Status EMAC_Init(EMAC_CFG_Type* EMAC_ConfigStruct)
 {
     /* Initialize the EMAC Ethernet controller. */
-    int32_t regv, tout, tmp;
-
-    /* Set up clock and power for Ethernet module */
-    CLKPWR_ConfigPPWR(CLKPWR_PCONP_PCENET, ENABLE);
-
-    /* Reset all EMAC internal modules */
-    LPC_EMAC->MAC1 = EMAC_MAC1_RES_TX | EMAC_MAC1_RES_MCS_TX | EMAC_MAC1_RES_RX | EMAC_MAC1_RES_MCS_RX |
-                     EMAC_MAC1_SIM_RES | EMAC_MAC1_SOFT_RES;
-
-    LPC_EMAC->Command = EMAC_CR_REG_RES | EMAC_CR_TX_RES | EMAC_CR_RX_RES | EMAC_CR_PASS_RUNT_FRM;
-
-    /* A short delay after reset. */
-    for (tout = 100; tout; tout--)
-        ;
-
-    /* Initialize MAC control registers. */
-    LPC_EMAC->MAC1 = EMAC_MAC1_PASS_ALL;
-    LPC_EMAC->MAC2 = EMAC_MAC2_CRC_EN | EMAC_MAC2_PAD_EN;
-    LPC_EMAC->MAXF = EMAC_ETH_MAX_FLEN;
-    /*
-     * Find the clock that close to desired target clock
-     */
-    tmp = SystemCoreClock / EMAC_MCFG_MII_MAXCLK;
-    for (tout = 0; tout < sizeof(EMAC_clkdiv); tout++)
-    {
-        if (EMAC_clkdiv[tout] >= tmp)
-            break;
-    }
-    tout++;
-    // Write to MAC configuration register and reset
-    LPC_EMAC->MCFG = EMAC_MCFG_CLK_SEL(tout) | EMAC_MCFG_RES_MII;
-    // release reset
-    LPC_EMAC->MCFG &= ~(EMAC_MCFG_RES_MII);
-    LPC_EMAC->CLRT = EMAC_CLRT_DEF;
-    LPC_EMAC->IPGR = EMAC_IPGR_P2_DEF;
+    int32_t regv, tout;
 
-    /* Enable Reduced MII interface. */
-    LPC_EMAC->Command = EMAC_CR_RMII | EMAC_CR_PASS_RUNT_FRM;
+    /* The PHY is driven from here, not by EMAC_PHYTick() */
+    phy_state = EMAC_PHY_STOPPED;
 
-    /* Reset Reduced MII Logic. */
-    //	LPC_EMAC->SUPP = EMAC_SUPP_RES_RMII;
-
-    for (tout = 100; tout; tout--)
-        ;
-    LPC_EMAC->SUPP = 0;
+    emac_mac_init();
 
     /* Put the DP83848C in reset mode */
     write_PHY(EMAC_PHY_REG_BMCR, EMAC_PHY_BMCR_RESET);
@@ -396,26 +597,50 @@ Status EMAC_Init(EMAC_CFG_Type* EMAC_ConfigStruct)
         return (ERROR);
     }
 
-    // Set EMAC address
-    setEmacAddr(EMAC_ConfigStruct->pbEMAC_Addr);
-
-    /* Initialize Tx and Rx DMA Descriptors */
-    rx_descr_init();
-    tx_descr_init();
+    emac_datapath_init(EMAC_ConfigStruct);
+    return SUCCESS;
+}
 
-    // Set Receive Filter register: enable broadcast and multicast
-    LPC_EMAC->RxFilterCtrl = EMAC_RFC_MCAST_EN | EMAC_RFC_BCAST_EN | EMAC_RFC_PERFECT_EN;
+/*********************************************************************/ /**
+                                                                         * @brief		Initializes the EMAC peripheral like EMAC_Init(), without
+                                                                         * waiting for the PHY: its reset, mode setting and link are left to
+                                                                         * EMAC_PHYTick()
+                                                                         * @param[in]	EMAC_ConfigStruct Pointer to a EMAC_CFG_Type structure
+                                                                         * that contains the configuration information for the EMAC peripheral
+                                                                         * @param[in]	PHY_ConfigStruct Pointer to a EMAC_PHY_CFG_Type structure
+                                                                         * with the tick timing and the link change callback, copied
+                                                                         * @return		ERROR for an unsupported mode, otherwise SUCCESS
+                                                                         * 
+                                                                         * Note: Returns within microseconds, the MAC and the datapaths are
+                                                                         * ready. Call EMAC_PHYTick() periodically from then on, e.g. from a
+                                                                         * SysTick or timer interrupt; frames can be sent once the link is up. The
+                                                                         * PHY functions EMAC_CheckPHYStatus(), EMAC_SetPHYMode() and
+                                                                         * EMAC_UpdatePHYStatus() must not be used meanwhile, they share the MII
+                                                                         **********************************************************************/
+Status EMAC_InitAsync(EMAC_CFG_Type* EMAC_ConfigStruct, EMAC_PHY_CFG_Type* PHY_ConfigStruct)
+{
+    int32_t mode;
 
-    /* Enable Rx Done and Tx Done interrupt for EMAC */
-    LPC_EMAC->IntEnable = EMAC_INT_RX_DONE | EMAC_INT_TX_DONE;
+    CHECK_PARAM(PHY_ConfigStruct->PollInterval != 0);
 
-    /* Reset all interrupts */
-    LPC_EMAC->IntClear = 0xFFFF;
-
-    /* Enable receive and transmit mode of MAC Ethernet core */
-    LPC_EMAC->Command |= (EMAC_CR_RX_EN | EMAC_CR_TX_EN);
-    LPC_EMAC->MAC1 |= EMAC_MAC1_REC_EN;
+    mode = emac_phy_mode(EMAC_ConfigStruct->Mode);
+    if (mode < 0)
+    {
+        return (ERROR);
+    }
 
+    phy_state = EMAC_PHY_STOPPED;
+    emac_mac_init();
+    emac_datapath_init(EMAC_ConfigStruct);
+
+    phy_cfg = *PHY_ConfigStruct;
+    phy_mode = (uint16_t)mode;
+    phy_step = EMAC_PHY_STEP_RESET;
+    phy_pending = 0;
+    phy_ticks = 0;
+    phy_link = 0;
+    /* Last: EMAC_PHYTick() may run from an interrupt */
+    phy_state = EMAC_PHY_RESETTING;
     return SUCCESS;
 }
 
@@ -589,11 +814,10 @@ int32_t EMAC_UpdatePHYStatus(void)
     int32_t regv, tout;
 
     /* Check the link status. */
-#ifdef MCB_LPC_1768
     for (tout = EMAC_PHY_RESP_TOUT; tout >= 0; tout--)
     {
-        regv = read_PHY(EMAC_PHY_REG_STS);
-        if (regv & EMAC_PHY_SR_LINK)
+        regv = read_PHY(EMAC_PHY_REG_LINK);
+        if (emac_link_status(regv) & EMAC_LINK_UP)
         {
             /* Link is on. */
             break;
@@ -604,73 +828,96 @@ int32_t EMAC_UpdatePHYStatus(void)
             return (-1);
         }
     }
-    /* Configure Full/Half Duplex mode. */
-    if (regv & EMAC_PHY_SR_DUP)
-    {
-        /* Full duplex is enabled. */
-        LPC_EMAC->MAC2 |= EMAC_MAC2_FULL_DUP;
-        LPC_EMAC->Command |= EMAC_CR_FULL_DUP;
-        LPC_EMAC->IPGT = EMAC_IPGT_FULL_DUP;
-    }
-    else
-    {
-        /* Half duplex mode. */
-        LPC_EMAC->IPGT = EMAC_IPGT_HALF_DUP;
-    }
-    if (regv & EMAC_PHY_SR_SPEED)
-    {
-        /* 10MBit mode. */
-        LPC_EMAC->SUPP = 0;
-    }
-    else
+    /* Configure Full/Half Duplex and 100MBit/10MBit mode. */
+    emac_set_link(emac_link_status(regv));
+    // Complete
+    return (0);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Advance the PHY management started by EMAC_InitAsync() by
+                                                                         * one tick: at most one MII transaction is started or completed per
+                                                                         * call, none is waited for
+                                                                         * @param[in]	None
+                                                                         * @return		None
+                                                                         * 
+                                                                         * Note: Call periodically, e.g. every millisecond from SysTick_Handler.
+                                                                         * The PHY is reset and identified, set to the requested mode, then its
+                                                                         * link status is read every PollInterval ticks. On a change the MAC is
+                                                                         * set to the speed and duplex of the link and LinkChange is called, from
+                                                                         * this context
+                                                                         **********************************************************************/
+void EMAC_PHYTick(void)
+{
+    int32_t regv = 0;
+
+    if ((phy_state == EMAC_PHY_STOPPED) || (phy_state == EMAC_PHY_FAILED))
     {
-        /* 100MBit mode. */
-        LPC_EMAC->SUPP = EMAC_SUPP_SPEED;
+        return;
     }
-#elif defined(IAR_LPC_1768)
-    for (tout = EMAC_PHY_RESP_TOUT; tout >= 0; tout--)
+    phy_ticks++;
+
+    if (phy_pending)
     {
-        regv = read_PHY(EMAC_PHY_REG_BMSR);
-        if (regv & EMAC_PHY_BMSR_LINK_STATUS)
+        if (LPC_EMAC->MIND & EMAC_MIND_BUSY)
         {
-            /* Link is on. */
-            break;
+            if (phy_ticks > phy_cfg.ResetTimeout)
+            {
+                phy_state = EMAC_PHY_FAILED;
+            }
+            return;
         }
-        if (tout == 0)
+        phy_pending = 0;
+        if ((phy_step != EMAC_PHY_STEP_RESET) && (phy_step != EMAC_PHY_STEP_MODE))
         {
-            // time out
-            return (-1);
+            LPC_EMAC->MCMD = 0;
+            regv = LPC_EMAC->MRDD;
+        }
+        emac_phy_result(regv);
+        if (phy_state == EMAC_PHY_FAILED)
+        {
+            return;
         }
     }
 
-    /* Configure Full/Half Duplex mode. */
-    if (regv & EMAC_PHY_SR_FULL_DUP)
+    /* Start the transaction of the step, the link status only when due */
+    if ((phy_step == EMAC_PHY_STEP_LINK) && (phy_ticks < phy_cfg.PollInterval))
     {
-        /* Full duplex is enabled. */
-        LPC_EMAC->MAC2 |= EMAC_MAC2_FULL_DUP;
-        LPC_EMAC->Command |= EMAC_CR_FULL_DUP;
-        LPC_EMAC->IPGT = EMAC_IPGT_FULL_DUP;
+        return;
     }
-    else
+    LPC_EMAC->MADR = EMAC_DEF_ADR | emac_phy_step_reg[phy_step];
+    switch (phy_step)
     {
-        /* Half duplex mode. */
-        LPC_EMAC->IPGT = EMAC_IPGT_HALF_DUP;
+        case EMAC_PHY_STEP_RESET: LPC_EMAC->MWTD = EMAC_PHY_BMCR_RESET; break;
+        case EMAC_PHY_STEP_MODE: LPC_EMAC->MWTD = phy_mode; break;
+        case EMAC_PHY_STEP_LINK:
+            phy_ticks = 0;
+            LPC_EMAC->MCMD = EMAC_MCMD_READ;
+            break;
+        default: LPC_EMAC->MCMD = EMAC_MCMD_READ; break;
     }
+    phy_pending = 1;
+}
 
-    /* Configure 100MBit/10MBit mode. */
-    if (!(regv & EMAC_PHY_SR_100_SPEED))
-    {
-        /* 10MBit mode. */
-        LPC_EMAC->SUPP = 0;
-    }
-    else
-    {
-        /* 100MBit mode. */
-        LPC_EMAC->SUPP = EMAC_SUPP_SPEED;
-    }
-#endif
-    // Complete
-    return (0);
+/*********************************************************************/ /**
+                                                                         * @brief		Get the state of the PHY management
+                                                                         * @param[in]	None
+                                                                         * @return		State, EMAC_PHY_STOPPED after EMAC_Init()
+                                                                         **********************************************************************/
+EMAC_PHY_STATE_Type EMAC_GetPHYState(void)
+{
+    return phy_state;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the link status as last read by EMAC_PHYTick(),
+                                                                         * without an MII transaction
+                                                                         * @param[in]	None
+                                                                         * @return		EMAC_LINK_ bits, 0 while the link is down
+                                                                         **********************************************************************/
+uint32_t EMAC_GetLinkStatus(void)
+{
+    return phy_link;
 }
 
 /*********************************************************************/ /**
@@ -706,8 +953,9 @@ void EMAC_SetHashFilter(uint8_t dstMAC_addr[], FunctionalState NewState)
     uint32_t tmp;
     int32_t crc;
 
-    // Calculate the CRC from the destination MAC address
-    crc = emac_CRCCalc(dstMAC_addr, 6);
+    // Calculate the CRC from the destination MAC address. The hash bits are
+    // taken from the CRC register before the final inversion, bit reversed
+    crc = __RBIT(~CRC32_Update(CRC32_INIT, dstMAC_addr, 6));
     // Extract the value from CRC to get index value for hash filter table
     crc = (crc >> 23) & 0x3F;
 
@@ -826,7 +1074,7 @@ void EMAC_WritePacketBuffer(EMAC_PACKETBUF_Type* pDataStruct)
 
     idx = LPC_EMAC->TxProduceIndex;
     sp = (uint32_t*)pDataStruct->pbDataBuf;
-    dp = (uint32_t*)Tx_Desc[idx].Packet;
+    dp = (uint32_t*)PTR32(Tx_Desc[idx].Packet);
     /* Copy frame data to EMAC packet buffers. */
     for (len = (pDataStruct->ulDataLen + 3) >> 2; len; len--)
     {
@@ -851,7 +1099,7 @@ void EMAC_ReadPacketBuffer(EMAC_PACKETBUF_Type* pDataStruct)
 
     idx = LPC_EMAC->RxConsumeIndex;
     dp = (uint32_t*)pDataStruct->pbDataBuf;
-    sp = (uint32_t*)Rx_Desc[idx].Packet;
+    sp = (uint32_t*)PTR32(Rx_Desc[idx].Packet);
 
     if (pDataStruct->pbDataBuf != NULL)
     {
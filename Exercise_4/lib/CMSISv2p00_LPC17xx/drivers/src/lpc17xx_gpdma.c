@@ -138,8 +138,8 @@ const uint8_t GPDMA_LUTPerBurst[] = {
     GPDMA_BSIZE_4,  // SSP1 Tx
     GPDMA_BSIZE_4,  // SSP1 Rx
     GPDMA_BSIZE_1,  // ADC
-    GPDMA_BSIZE_32, // I2S channel 0
-    GPDMA_BSIZE_32, // I2S channel 1
+    GPDMA_BSIZE_4,  // I2S channel 0
+    GPDMA_BSIZE_4,  // I2S channel 1
     GPDMA_BSIZE_1,  // DAC
     GPDMA_BSIZE_1,  // UART0 Tx
     GPDMA_BSIZE_1,  // UART0 Rx
@@ -169,7 +169,7 @@ const uint8_t GPDMA_LUTPerWid[] = {
     GPDMA_WIDTH_WORD, // ADC
     GPDMA_WIDTH_WORD, // I2S channel 0
     GPDMA_WIDTH_WORD, // I2S channel 1
-    GPDMA_WIDTH_BYTE, // DAC
+    GPDMA_WIDTH_WORD, // DAC
     GPDMA_WIDTH_BYTE, // UART0 Tx
     GPDMA_WIDTH_BYTE, // UART0 Rx
     GPDMA_WIDTH_BYTE, // UART1 Tx
@@ -188,6 +188,66 @@ const uint8_t GPDMA_LUTPerWid[] = {
     GPDMA_WIDTH_WORD  // MAT3.1
 };
 
+/** Linked list item pool, word aligned by its type */
+static GPDMA_LLI_Type gpdma_lli_pool[GPDMA_LLI_POOL_SIZE];
+
+/** One bit per pool item, set while allocated */
+static uint32_t gpdma_lli_used[(GPDMA_LLI_POOL_SIZE + 31) / 32];
+
+/**
+ * @}
+ */
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup GPDMA_Private_Functions GPDMA Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the channel control word of a transfer type, without
+                                                                         * the terminal count interrupt bit
+                                                                         * @param[in]	GPDMAChannelConfig	Channel configuration
+                                                                         * @param[in]	size	Transfer size
+                                                                         * @return		Control word, 0 for an unknown transfer type
+                                                                         **********************************************************************/
+static uint32_t gpdma_control(const GPDMA_Channel_CFG_Type* GPDMAChannelConfig, uint32_t size)
+{
+    switch (GPDMAChannelConfig->TransferType)
+    {
+        // Memory to memory
+        case GPDMA_TRANSFERTYPE_M2M:
+            return GPDMA_DMACCxControl_TransferSize(size) | GPDMA_DMACCxControl_SBSize(GPDMA_BSIZE_32) |
+                   GPDMA_DMACCxControl_DBSize(GPDMA_BSIZE_32) |
+                   GPDMA_DMACCxControl_SWidth(GPDMAChannelConfig->TransferWidth) |
+                   GPDMA_DMACCxControl_DWidth(GPDMAChannelConfig->TransferWidth) | GPDMA_DMACCxControl_SI |
+                   GPDMA_DMACCxControl_DI;
+        // Memory to peripheral
+        case GPDMA_TRANSFERTYPE_M2P:
+            return GPDMA_DMACCxControl_TransferSize(size) |
+                   GPDMA_DMACCxControl_SBSize((uint32_t)GPDMA_LUTPerBurst[GPDMAChannelConfig->DstConn]) |
+                   GPDMA_DMACCxControl_DBSize((uint32_t)GPDMA_LUTPerBurst[GPDMAChannelConfig->DstConn]) |
+                   GPDMA_DMACCxControl_SWidth((uint32_t)GPDMA_LUTPerWid[GPDMAChannelConfig->DstConn]) |
+                   GPDMA_DMACCxControl_DWidth((uint32_t)GPDMA_LUTPerWid[GPDMAChannelConfig->DstConn]) |
+                   GPDMA_DMACCxControl_SI;
+        // Peripheral to memory
+        case GPDMA_TRANSFERTYPE_P2M:
+            return GPDMA_DMACCxControl_TransferSize(size) |
+                   GPDMA_DMACCxControl_SBSize((uint32_t)GPDMA_LUTPerBurst[GPDMAChannelConfig->SrcConn]) |
+                   GPDMA_DMACCxControl_DBSize((uint32_t)GPDMA_LUTPerBurst[GPDMAChannelConfig->SrcConn]) |
+                   GPDMA_DMACCxControl_SWidth((uint32_t)GPDMA_LUTPerWid[GPDMAChannelConfig->SrcConn]) |
+                   GPDMA_DMACCxControl_DWidth((uint32_t)GPDMA_LUTPerWid[GPDMAChannelConfig->SrcConn]) |
+                   GPDMA_DMACCxControl_DI;
+        // Peripheral to peripheral
+        case GPDMA_TRANSFERTYPE_P2P:
+            return GPDMA_DMACCxControl_TransferSize(size) |
+                   GPDMA_DMACCxControl_SBSize((uint32_t)GPDMA_LUTPerBurst[GPDMAChannelConfig->SrcConn]) |
+                   GPDMA_DMACCxControl_DBSize((uint32_t)GPDMA_LUTPerBurst[GPDMAChannelConfig->DstConn]) |
+                   GPDMA_DMACCxControl_SWidth((uint32_t)GPDMA_LUTPerWid[GPDMAChannelConfig->SrcConn]) |
+                   GPDMA_DMACCxControl_DWidth((uint32_t)GPDMA_LUTPerWid[GPDMAChannelConfig->DstConn]);
+        default: return 0;
+    }
+}
+
 /**
  * @}
  */
@@ -267,58 +327,33 @@ Status GPDMA_Setup(GPDMA_Channel_CFG_Type* GPDMAChannelConfig)
             // Assign physical source and destination address
             pDMAch->DMACCSrcAddr = GPDMAChannelConfig->SrcMemAddr;
             pDMAch->DMACCDestAddr = GPDMAChannelConfig->DstMemAddr;
-            pDMAch->DMACCControl = GPDMA_DMACCxControl_TransferSize(GPDMAChannelConfig->TransferSize) |
-                                   GPDMA_DMACCxControl_SBSize(GPDMA_BSIZE_32) |
-                                   GPDMA_DMACCxControl_DBSize(GPDMA_BSIZE_32) |
-                                   GPDMA_DMACCxControl_SWidth(GPDMAChannelConfig->TransferWidth) |
-                                   GPDMA_DMACCxControl_DWidth(GPDMAChannelConfig->TransferWidth) |
-                                   GPDMA_DMACCxControl_SI | GPDMA_DMACCxControl_DI | GPDMA_DMACCxControl_I;
             break;
         // Memory to peripheral
         case GPDMA_TRANSFERTYPE_M2P:
             // Assign physical source
             pDMAch->DMACCSrcAddr = GPDMAChannelConfig->SrcMemAddr;
             // Assign peripheral destination address
-            pDMAch->DMACCDestAddr = (uint32_t)GPDMA_LUTPerAddr[GPDMAChannelConfig->DstConn];
-            pDMAch->DMACCControl =
-                GPDMA_DMACCxControl_TransferSize((uint32_t)GPDMAChannelConfig->TransferSize) |
-                GPDMA_DMACCxControl_SBSize((uint32_t)GPDMA_LUTPerBurst[GPDMAChannelConfig->DstConn]) |
-                GPDMA_DMACCxControl_DBSize((uint32_t)GPDMA_LUTPerBurst[GPDMAChannelConfig->DstConn]) |
-                GPDMA_DMACCxControl_SWidth((uint32_t)GPDMA_LUTPerWid[GPDMAChannelConfig->DstConn]) |
-                GPDMA_DMACCxControl_DWidth((uint32_t)GPDMA_LUTPerWid[GPDMAChannelConfig->DstConn]) |
-                GPDMA_DMACCxControl_SI | GPDMA_DMACCxControl_I;
+            pDMAch->DMACCDestAddr = ADDR32(GPDMA_LUTPerAddr[GPDMAChannelConfig->DstConn]);
             break;
         // Peripheral to memory
         case GPDMA_TRANSFERTYPE_P2M:
             // Assign peripheral source address
-            pDMAch->DMACCSrcAddr = (uint32_t)GPDMA_LUTPerAddr[GPDMAChannelConfig->SrcConn];
+            pDMAch->DMACCSrcAddr = ADDR32(GPDMA_LUTPerAddr[GPDMAChannelConfig->SrcConn]);
             // Assign memory destination address
             pDMAch->DMACCDestAddr = GPDMAChannelConfig->DstMemAddr;
-            pDMAch->DMACCControl =
-                GPDMA_DMACCxControl_TransferSize((uint32_t)GPDMAChannelConfig->TransferSize) |
-                GPDMA_DMACCxControl_SBSize((uint32_t)GPDMA_LUTPerBurst[GPDMAChannelConfig->SrcConn]) |
-                GPDMA_DMACCxControl_DBSize((uint32_t)GPDMA_LUTPerBurst[GPDMAChannelConfig->SrcConn]) |
-                GPDMA_DMACCxControl_SWidth((uint32_t)GPDMA_LUTPerWid[GPDMAChannelConfig->SrcConn]) |
-                GPDMA_DMACCxControl_DWidth((uint32_t)GPDMA_LUTPerWid[GPDMAChannelConfig->SrcConn]) |
-                GPDMA_DMACCxControl_DI | GPDMA_DMACCxControl_I;
             break;
         // Peripheral to peripheral
         case GPDMA_TRANSFERTYPE_P2P:
             // Assign peripheral source address
-            pDMAch->DMACCSrcAddr = (uint32_t)GPDMA_LUTPerAddr[GPDMAChannelConfig->SrcConn];
+            pDMAch->DMACCSrcAddr = ADDR32(GPDMA_LUTPerAddr[GPDMAChannelConfig->SrcConn]);
             // Assign peripheral destination address
-            pDMAch->DMACCDestAddr = (uint32_t)GPDMA_LUTPerAddr[GPDMAChannelConfig->DstConn];
-            pDMAch->DMACCControl =
-                GPDMA_DMACCxControl_TransferSize((uint32_t)GPDMAChannelConfig->TransferSize) |
-                GPDMA_DMACCxControl_SBSize((uint32_t)GPDMA_LUTPerBurst[GPDMAChannelConfig->SrcConn]) |
-                GPDMA_DMACCxControl_DBSize((uint32_t)GPDMA_LUTPerBurst[GPDMAChannelConfig->DstConn]) |
-                GPDMA_DMACCxControl_SWidth((uint32_t)GPDMA_LUTPerWid[GPDMAChannelConfig->SrcConn]) |
-                GPDMA_DMACCxControl_DWidth((uint32_t)GPDMA_LUTPerWid[GPDMAChannelConfig->DstConn]) |
-                GPDMA_DMACCxControl_I;
+            pDMAch->DMACCDestAddr = ADDR32(GPDMA_LUTPerAddr[GPDMAChannelConfig->DstConn]);
             break;
         // Do not support any more transfer type, return ERROR
         default: return ERROR;
     }
+    pDMAch->DMACCControl =
+        gpdma_control(GPDMAChannelConfig, (uint32_t)GPDMAChannelConfig->TransferSize) | GPDMA_DMACCxControl_I;
 
     /* Re-Configure DMA Request Select for source peripheral */
     if (GPDMAChannelConfig->SrcConn > 15)
@@ -469,6 +504,220 @@ void GPDMA_ClearIntPending(GPDMA_StateClear_Type type, uint8_t channel)
         LPC_GPDMA->DMACIntErrClr = GPDMA_DMACIntErrClr_Ch(channel);
 }
 
+/*********************************************************************/ /**
+                                                                         * @brief		Take one linked list item from the descriptor pool.
+                                                                         * Callable from interrupts, the pool bitmap is updated with
+                                                                         * interrupts disabled
+                                                                         * @param[in]	None
+                                                                         * @return		Item, or NULL if the pool is empty
+                                                                         **********************************************************************/
+GPDMA_LLI_Type* GPDMA_LLI_Alloc(void)
+{
+    uint32_t word, free, bit, primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for (word = 0; word < (GPDMA_LLI_POOL_SIZE + 31) / 32; word++)
+    {
+        free = ~gpdma_lli_used[word];
+        if (free == 0)
+        {
+            continue;
+        }
+        bit = 31 - __CLZ(free & (~free + 1)); // lowest free item
+        if (word * 32 + bit >= GPDMA_LLI_POOL_SIZE)
+        {
+            break;
+        }
+        gpdma_lli_used[word] |= 1UL << bit;
+        __set_PRIMASK(primask);
+        return &gpdma_lli_pool[word * 32 + bit];
+    }
+    __set_PRIMASK(primask);
+    return NULL;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Return a chain of linked list items to the pool. Follows the
+                                                                         * links until the end of the chain or back to its first item.
+                                                                         * Callable from interrupts, such as a DMA handler releasing a
+                                                                         * finished chain
+                                                                         * @param[in]	head	First item of the chain, NULL does nothing
+                                                                         * @return		None
+                                                                         * @note		The chain must not be in use by a channel.
+                                                                         **********************************************************************/
+void GPDMA_LLI_Free(GPDMA_LLI_Type* head)
+{
+    GPDMA_LLI_Type* item = head;
+    GPDMA_LLI_Type* next;
+    uint32_t index, primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    while (item != NULL)
+    {
+        index = (uint32_t)(item - gpdma_lli_pool);
+        if ((item < gpdma_lli_pool) || (index >= GPDMA_LLI_POOL_SIZE) ||
+            !(gpdma_lli_used[index / 32] & (1UL << (index % 32))))
+        {
+            break; // not a pool item, or already free
+        }
+        next = (GPDMA_LLI_Type*)PTR32(item->NextLLI);
+        gpdma_lli_used[index / 32] &= ~(1UL << (index % 32));
+        item->NextLLI = 0;
+        item = (next == head) ? NULL : next;
+    }
+    __set_PRIMASK(primask);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the number of free items in the descriptor pool
+                                                                         * @param[in]	None
+                                                                         * @return		Free items
+                                                                         **********************************************************************/
+uint32_t GPDMA_LLI_GetFree(void)
+{
+    uint32_t index, free = 0;
+
+    for (index = 0; index < GPDMA_LLI_POOL_SIZE; index++)
+    {
+        if (!(gpdma_lli_used[index / 32] & (1UL << (index % 32))))
+        {
+            free++;
+        }
+    }
+    return free;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Build a scatter-gather chain of linked list items from the
+                                                                         * pool. Segments longer than GPDMA_LLI_MAX_TRANSFER are split
+                                                                         * over several items. The last item always raises the terminal
+                                                                         * count interrupt
+                                                                         * @param[in]	GPDMAChannelConfig	Channel configuration, only TransferType,
+                                                                         * TransferWidth, SrcConn and DstConn are used
+                                                                         * @param[in]	segs	Segments, in transfer order
+                                                                         * @param[in]	numSegs	Number of segments, at least 1
+                                                                         * @param[in]	options	GPDMA_LLI_CIRCULAR and/or GPDMA_LLI_INT_SEGMENT
+                                                                         * @return		First item of the chain, or NULL if the pool ran out or an
+                                                                         * address is not aligned to its transfer width
+                                                                         **********************************************************************/
+GPDMA_LLI_Type* GPDMA_LLI_Build(const GPDMA_Channel_CFG_Type* GPDMAChannelConfig, const GPDMA_SEGMENT_Type* segs,
+                                uint32_t numSegs, uint32_t options)
+{
+    GPDMA_LLI_Type* head = NULL;
+    GPDMA_LLI_Type* tail = NULL;
+    GPDMA_LLI_Type* item;
+    uint32_t control, swidth, dwidth, src, dst, left, n, seg;
+
+    CHECK_PARAM(PARAM_GPDMA_TRANSFERTYPE(GPDMAChannelConfig->TransferType));
+    CHECK_PARAM(numSegs >= 1);
+
+    control = gpdma_control(GPDMAChannelConfig, 0);
+    if (control == 0)
+    {
+        return NULL;
+    }
+    swidth = 1UL << ((control >> 18) & 0x07);
+    dwidth = 1UL << ((control >> 21) & 0x07);
+
+    for (seg = 0; seg < numSegs; seg++)
+    {
+        src = segs[seg].SrcAddr;
+        if ((src == 0) && ((GPDMAChannelConfig->TransferType == GPDMA_TRANSFERTYPE_P2M) ||
+                           (GPDMAChannelConfig->TransferType == GPDMA_TRANSFERTYPE_P2P)))
+        {
+            src = ADDR32(GPDMA_LUTPerAddr[GPDMAChannelConfig->SrcConn]);
+        }
+        dst = segs[seg].DstAddr;
+        if ((dst == 0) && ((GPDMAChannelConfig->TransferType == GPDMA_TRANSFERTYPE_M2P) ||
+                           (GPDMAChannelConfig->TransferType == GPDMA_TRANSFERTYPE_P2P)))
+        {
+            dst = ADDR32(GPDMA_LUTPerAddr[GPDMAChannelConfig->DstConn]);
+        }
+        if ((src & (swidth - 1)) || (dst & (dwidth - 1)) || (segs[seg].Size == 0))
+        {
+            GPDMA_LLI_Free(head);
+            return NULL;
+        }
+
+        for (left = segs[seg].Size; left != 0; left -= n)
+        {
+            item = GPDMA_LLI_Alloc();
+            if (item == NULL)
+            {
+                GPDMA_LLI_Free(head);
+                return NULL;
+            }
+            n = (left > GPDMA_LLI_MAX_TRANSFER) ? GPDMA_LLI_MAX_TRANSFER : left;
+            item->SrcAddr = src;
+            item->DstAddr = dst;
+            item->NextLLI = 0;
+            item->Control = control | GPDMA_DMACCxControl_TransferSize(n);
+            if (tail == NULL)
+            {
+                head = item;
+            }
+            else
+            {
+                tail->NextLLI = ADDR32(item);
+            }
+            tail = item;
+
+            if (control & GPDMA_DMACCxControl_SI)
+            {
+                src += n * swidth;
+            }
+            if (control & GPDMA_DMACCxControl_DI)
+            {
+                dst += n * dwidth;
+            }
+        }
+        if (options & GPDMA_LLI_INT_SEGMENT)
+        {
+            tail->Control |= GPDMA_DMACCxControl_I;
+        }
+    }
+
+    tail->Control |= GPDMA_DMACCxControl_I;
+    if (options & GPDMA_LLI_CIRCULAR)
+    {
+        tail->NextLLI = ADDR32(head);
+    }
+    return head;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Setup a GPDMA channel to run a chain built by GPDMA_LLI_Build().
+                                                                         * The channel starts with the first item, then follows the links
+                                                                         * with no CPU work
+                                                                         * @param[in]	GPDMAChannelConfig	Channel configuration, same as given to
+                                                                         * GPDMA_LLI_Build()
+                                                                         * @param[in]	head	First item of the chain
+                                                                         * @return		ERROR if the channel is enabled, SUCCESS otherwise
+                                                                         **********************************************************************/
+Status GPDMA_SetupChain(const GPDMA_Channel_CFG_Type* GPDMAChannelConfig, const GPDMA_LLI_Type* head)
+{
+    GPDMA_Channel_CFG_Type cfg = *GPDMAChannelConfig;
+    LPC_GPDMACH_TypeDef* pDMAch;
+
+    cfg.TransferSize = head->Control & 0xFFF;
+    cfg.SrcMemAddr = head->SrcAddr;
+    cfg.DstMemAddr = head->DstAddr;
+    cfg.DMALLI = head->NextLLI;
+    if (GPDMA_Setup(&cfg) == ERROR)
+    {
+        return ERROR;
+    }
+
+    // The first item may not use the connection registers or the default interrupt bit
+    pDMAch = (LPC_GPDMACH_TypeDef*)pGPDMACh[cfg.ChannelNum];
+    pDMAch->DMACCSrcAddr = head->SrcAddr;
+    pDMAch->DMACCDestAddr = head->DstAddr;
+    pDMAch->DMACCControl = head->Control;
+    return SUCCESS;
+}
+
 /**
  * @}
  */
@@ -378,7 +378,7 @@ Status I2S_FreqConfig(LPC_I2S_TypeDef* I2Sx, uint32_t Freq, uint8_t TRMode)
     uint32_t x, y;
     uint64_t divider;
     uint16_t dif;
-    uint16_t x_divide, y_divide;
+    uint16_t x_divide, y_divide = 1;
     uint16_t err, ErrorOptimal = 0xFFFF;
 
     uint32_t N;
@@ -452,7 +452,9 @@ Status I2S_FreqConfig(LPC_I2S_TypeDef* I2Sx, uint32_t Freq, uint8_t TRMode)
             y_divide = y;
         }
     }
-    x_divide = ((uint64_t)y_divide * Freq * (channel * wordwidth) * N * 2) / i2s_clk;
+    /* Rounded: y_divide was chosen for y * divider closest to an integer,
+     * which is as likely to fall just below it */
+    x_divide = (((uint64_t)y_divide * Freq * (channel * wordwidth) * N * 2) + i2s_clk / 2) / i2s_clk;
     if (x_divide >= 256)
         x_divide = 0xFF;
     if (x_divide == 0)
@@ -466,7 +468,7 @@ Status I2S_FreqConfig(LPC_I2S_TypeDef* I2Sx, uint32_t Freq, uint8_t TRMode)
     else // Receiver
     {
         I2Sx->I2SRXBITRATE = N - 1;
-        I2Sx->I2STXRATE = y_divide | (x_divide << 8);
+        I2Sx->I2SRXRATE = y_divide | (x_divide << 8);
     }
     return SUCCESS;
 }
@@ -38,6 +38,16 @@
 /* Includes ------------------------------------------------------------------- */
 #include "lpc17xx_pinsel.h"
 
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
 /* Public Functions ----------------------------------------------------------- */
 
 static void set_PinFunc(uint8_t portnum, uint8_t pinnum, uint8_t funcnum);
@@ -317,11 +327,86 @@ void PINSEL_SetI2C0Pins(uint8_t i2cPinMode, FunctionalState filterSlewRateEnable
                                                                          **********************************************************************/
 void PINSEL_ConfigPin(PINSEL_CFG_Type* PinCfg)
 {
+    CHECK_PARAM(PARAM_PINSEL_PORT(PinCfg->Portnum));
+    CHECK_PARAM(PARAM_PINSEL_PIN(PinCfg->Pinnum));
+    CHECK_PARAM(PARAM_PINSEL_FUNC(PinCfg->Funcnum));
+    CHECK_PARAM(PARAM_PINSEL_PINMODE(PinCfg->Pinmode));
+    CHECK_PARAM(PARAM_PINSEL_OD(PinCfg->OpenDrain));
+
     set_PinFunc(PinCfg->Portnum, PinCfg->Pinnum, PinCfg->Funcnum);
     set_ResistorMode(PinCfg->Portnum, PinCfg->Pinnum, PinCfg->Pinmode);
     set_OpenDrainMode(PinCfg->Portnum, PinCfg->Pinnum, PinCfg->OpenDrain);
 }
 
+/*********************************************************************/ /**
+                                                                         * @brief		Configure a table of pins. The table is folded into
+                                                                         * one clear and one set mask per PINSEL, PINMODE and
+                                                                         * PINMODE_OD register, then each register the table
+                                                                         * touches is written once. A pin listed twice takes its
+                                                                         * last entry, as with successive PINSEL_ConfigPin() calls.
+                                                                         * Every entry is checked as by PINSEL_ConfigPin(), an entry
+                                                                         * with a port or pin out of range is skipped.
+                                                                         * @param[in]	PinTable	Pointer to a table of PINSEL_CFG_Type,
+                                                                         * usually const and built with PINSEL_CFG()
+                                                                         * @param[in]	NumPins		Number of entries in PinTable
+                                                                         * @return 		None
+                                                                         **********************************************************************/
+void PINSEL_ConfigPins(const PINSEL_CFG_Type* PinTable, uint32_t NumPins)
+{
+    uint32_t sel_clr[PINSEL_NUM_PINSEL] = {0}, sel_set[PINSEL_NUM_PINSEL] = {0};
+    uint32_t mode_clr[PINSEL_NUM_PINSEL] = {0}, mode_set[PINSEL_NUM_PINSEL] = {0};
+    uint32_t od_clr[PINSEL_NUM_OD] = {0}, od_set[PINSEL_NUM_OD] = {0};
+    volatile uint32_t* pPinSel = (volatile uint32_t*)&LPC_PINCON->PINSEL0;
+    volatile uint32_t* pPinMode = (volatile uint32_t*)&LPC_PINCON->PINMODE0;
+    volatile uint32_t* pPinOD = (volatile uint32_t*)&LPC_PINCON->PINMODE_OD0;
+    uint32_t i, idx, shift, bit;
+
+    for (i = 0; i < NumPins; i++)
+    {
+        CHECK_PARAM(PARAM_PINSEL_PORT(PinTable[i].Portnum));
+        CHECK_PARAM(PARAM_PINSEL_PIN(PinTable[i].Pinnum));
+        CHECK_PARAM(PARAM_PINSEL_FUNC(PinTable[i].Funcnum));
+        CHECK_PARAM(PARAM_PINSEL_PINMODE(PinTable[i].Pinmode));
+        CHECK_PARAM(PARAM_PINSEL_OD(PinTable[i].OpenDrain));
+        /* The release profile does not check at run time, never index past the masks */
+        if (!PARAM_PINSEL_PORT(PinTable[i].Portnum) || !PARAM_PINSEL_PIN(PinTable[i].Pinnum))
+        {
+            continue;
+        }
+
+        idx = 2 * PinTable[i].Portnum + (PinTable[i].Pinnum >> 4);
+        shift = (PinTable[i].Pinnum & 0x0F) * 2;
+        bit = 0x01UL << PinTable[i].Pinnum;
+
+        sel_clr[idx] |= 0x03UL << shift;
+        sel_set[idx] = (sel_set[idx] & ~(0x03UL << shift)) | ((uint32_t)PinTable[i].Funcnum << shift);
+        mode_clr[idx] |= 0x03UL << shift;
+        mode_set[idx] = (mode_set[idx] & ~(0x03UL << shift)) | ((uint32_t)PinTable[i].Pinmode << shift);
+        od_clr[PinTable[i].Portnum] |= bit;
+        od_set[PinTable[i].Portnum] &= ~bit;
+        if (PinTable[i].OpenDrain == PINSEL_PINMODE_OPENDRAIN)
+        {
+            od_set[PinTable[i].Portnum] |= bit;
+        }
+    }
+
+    for (i = 0; i < PINSEL_NUM_PINSEL; i++)
+    {
+        if (sel_clr[i] != 0)
+        {
+            pPinSel[i] = (pPinSel[i] & ~sel_clr[i]) | sel_set[i];
+            pPinMode[i] = (pPinMode[i] & ~mode_clr[i]) | mode_set[i];
+        }
+    }
+    for (i = 0; i < PINSEL_NUM_OD; i++)
+    {
+        if (od_clr[i] != 0)
+        {
+            pPinOD[i] = (pPinOD[i] & ~od_clr[i]) | od_set[i];
+        }
+    }
+}
+
 /**
  * @}
  */
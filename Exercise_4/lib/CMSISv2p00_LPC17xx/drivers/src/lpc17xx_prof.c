@@ -0,0 +1,262 @@
+/**********************************************************************
+ * $Id$		lpc17xx_prof.c				2010-05-21
+ *//**
+* @file		lpc17xx_prof.c
+* @brief	Contains all functions support for the DWT cycle counter profiling probes on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup PROF
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_prof.h"
+#include "debug_frmwrk.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _PROF
+
+/* Private Variables ---------------------------------------------------------- */
+/** @defgroup PROF_Private_Variables PROF Private Variables
+ * @{
+ */
+
+/** Probe table */
+static PROF_PROBE_Type prof_probes[PROF_MAX_PROBES];
+
+/** Cycles taken by an empty PROF_Start()/PROF_Stop() pair */
+static uint32_t prof_overhead;
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup PROF_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Enable the DWT cycle counter, clear the probe table and
+                                                                         * measure the cost of reading the counter
+                                                                         * @param[in]	None
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void PROF_Init(void)
+{
+    uint32_t start, i;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    prof_overhead = 0xFFFFFFFF;
+    for (i = 0; i < 4; i++)
+    {
+        start = PROF_Start();
+        start = DWT->CYCCNT - start;
+        if (start < prof_overhead)
+        {
+            prof_overhead = start;
+        }
+    }
+
+    PROF_Reset();
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Clear the statistics of every probe, names are kept
+                                                                         * @param[in]	None
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void PROF_Reset(void)
+{
+    uint8_t probe, bin;
+
+    for (probe = 0; probe < PROF_MAX_PROBES; probe++)
+    {
+        prof_probes[probe].Count = 0;
+        prof_probes[probe].Min = 0xFFFFFFFF;
+        prof_probes[probe].Max = 0;
+        prof_probes[probe].Total = 0;
+        for (bin = 0; bin < PROF_HIST_BINS; bin++)
+        {
+            prof_probes[probe].Hist[bin] = 0;
+        }
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Name a probe for PROF_Dump()
+                                                                         * @param[in]	probe	Probe index, 0 to PROF_MAX_PROBES - 1
+                                                                         * @param[in]	name	Name string, must stay valid
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void PROF_SetName(uint8_t probe, const char* name)
+{
+    CHECK_PARAM(PARAM_PROF_PROBE(probe));
+
+    prof_probes[probe].Name = name;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Add one measured duration to a probe
+                                                                         * @param[in]	probe	Probe index, 0 to PROF_MAX_PROBES - 1
+                                                                         * @param[in]	cycles	Duration including the probe overhead
+                                                                         * @return		None
+                                                                         * @note		A probe must only be used from one execution context
+                                                                         * (one ISR or the main loop), the update is not atomic.
+                                                                         **********************************************************************/
+void PROF_Record(uint8_t probe, uint32_t cycles)
+{
+    PROF_PROBE_Type* p;
+    uint32_t bin;
+
+    CHECK_PARAM(PARAM_PROF_PROBE(probe));
+
+    p = &prof_probes[probe];
+    cycles = (cycles > prof_overhead) ? (cycles - prof_overhead) : 0;
+
+    p->Count++;
+    p->Total += cycles;
+    if (cycles < p->Min)
+    {
+        p->Min = cycles;
+    }
+    if (cycles > p->Max)
+    {
+        p->Max = cycles;
+    }
+
+    bin = (cycles == 0) ? 0 : (31 - __CLZ(cycles));
+    if (bin >= PROF_HIST_BINS)
+    {
+        bin = PROF_HIST_BINS - 1;
+    }
+    p->Hist[bin]++;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the statistics of a probe
+                                                                         * @param[in]	probe	Probe index, 0 to PROF_MAX_PROBES - 1
+                                                                         * @return		Pointer to the probe entry
+                                                                         **********************************************************************/
+const PROF_PROBE_Type* PROF_GetProbe(uint8_t probe)
+{
+    CHECK_PARAM(PARAM_PROF_PROBE(probe));
+
+    return &prof_probes[probe];
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the mean duration of a probe
+                                                                         * @param[in]	probe	Probe index, 0 to PROF_MAX_PROBES - 1
+                                                                         * @return		Mean duration in cycles, 0 if nothing was measured
+                                                                         **********************************************************************/
+uint32_t PROF_GetMean(uint8_t probe)
+{
+    CHECK_PARAM(PARAM_PROF_PROBE(probe));
+
+    if (prof_probes[probe].Count == 0)
+    {
+        return 0;
+    }
+    return (uint32_t)(prof_probes[probe].Total / prof_probes[probe].Count);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Print every named probe through the debug framework UART:
+                                                                         * count, min, mean and max in cycles, then the non empty
+                                                                         * histogram bins as "lower bound: count"
+                                                                         * @param[in]	None
+                                                                         * @return		None
+                                                                         * @note		debug_frmwrk_init() must have been called
+                                                                         **********************************************************************/
+void PROF_Dump(void)
+{
+#ifdef _DBGFWK
+    PROF_PROBE_Type* p;
+    uint8_t probe, bin;
+
+    for (probe = 0; probe < PROF_MAX_PROBES; probe++)
+    {
+        p = &prof_probes[probe];
+        if (p->Name == NULL)
+        {
+            continue;
+        }
+
+        _DBG(p->Name);
+        _DBG(": n=");
+        _DBD32(p->Count);
+        if (p->Count != 0)
+        {
+            _DBG(" min=");
+            _DBD32(p->Min);
+            _DBG(" mean=");
+            _DBD32(PROF_GetMean(probe));
+            _DBG(" max=");
+            _DBD32(p->Max);
+        }
+        _DBG_("");
+
+        for (bin = 0; bin < PROF_HIST_BINS; bin++)
+        {
+            if (p->Hist[bin] != 0)
+            {
+                _DBG("  ");
+                _DBD32((bin == 0) ? 0 : (1UL << bin));
+                _DBG(": ");
+                _DBD32(p->Hist[bin]);
+                _DBG_("");
+            }
+        }
+    }
+#endif /* _DBGFWK */
+}
+
+/**
+ * @}
+ */
+
+#endif /* _PROF */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
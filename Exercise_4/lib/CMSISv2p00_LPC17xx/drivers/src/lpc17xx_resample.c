@@ -0,0 +1,310 @@
+/**********************************************************************
+ * $Id$		lpc17xx_resample.c				2010-05-21
+ *//**
+* @file		lpc17xx_resample.c
+* @brief	Contains all functions support for the fixed-point FIR sample-rate conversion on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup RESAMPLE
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_resample.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _RESAMPLE
+
+#ifdef _RESAMPLE_FIR
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup RESAMPLE_Private_Functions RESAMPLE Private Functions
+ * @{
+ */
+
+/* The Q15 FIR decimator and interpolator of CMSIS-DSP, which arm_math.h
+ * declares but this library does not carry. Same arithmetic as its reference
+ * code: 64-bit accumulation, result shifted by 15 and saturated */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Initialize a Q15 FIR decimator, see arm_math.h
+                                                                         * @return		ARM_MATH_LENGTH_ERROR if blockSize is not a multiple of M
+                                                                         **********************************************************************/
+arm_status arm_fir_decimate_init_q15(arm_fir_decimate_instance_q15* S, uint16_t numTaps, uint8_t M, q15_t* pCoeffs,
+                                     q15_t* pState, uint32_t blockSize)
+{
+    uint32_t i;
+
+    if ((blockSize % M) != 0)
+    {
+        return ARM_MATH_LENGTH_ERROR;
+    }
+    S->M = M;
+    S->numTaps = numTaps;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    for (i = 0; i < numTaps + blockSize - 1; i++)
+    {
+        pState[i] = 0;
+    }
+    return ARM_MATH_SUCCESS;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Filter and decimate blockSize samples into blockSize / M
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void arm_fir_decimate_q15(const arm_fir_decimate_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
+{
+    q15_t* pState = S->pState;
+    q15_t* pStateCurnt = S->pState + (S->numTaps - 1);
+    uint32_t i, k;
+    q63_t acc;
+
+    for (i = blockSize / S->M; i > 0; i--)
+    {
+        for (k = 0; k < S->M; k++)
+        {
+            *pStateCurnt++ = *pSrc++;
+        }
+        acc = 0;
+        for (k = 0; k < S->numTaps; k++)
+        {
+            acc += (q31_t)pState[k] * S->pCoeffs[k];
+        }
+        pState += S->M;
+        *pDst++ = (q15_t)__SSAT((q31_t)(acc >> 15), 16);
+    }
+
+    /* Keep the last numTaps - 1 samples for the next call */
+    for (k = 0; k < S->numTaps - 1u; k++)
+    {
+        S->pState[k] = pState[k];
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Initialize a Q15 FIR interpolator, see arm_math.h
+                                                                         * @return		ARM_MATH_LENGTH_ERROR if numTaps is not a multiple of L
+                                                                         **********************************************************************/
+arm_status arm_fir_interpolate_init_q15(arm_fir_interpolate_instance_q15* S, uint8_t L, uint16_t numTaps,
+                                        q15_t* pCoeffs, q15_t* pState, uint32_t blockSize)
+{
+    uint32_t i;
+
+    if ((numTaps % L) != 0)
+    {
+        return ARM_MATH_LENGTH_ERROR;
+    }
+    S->L = L;
+    S->phaseLength = numTaps / L;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    for (i = 0; i < blockSize + S->phaseLength - 1; i++)
+    {
+        pState[i] = 0;
+    }
+    return ARM_MATH_SUCCESS;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Upsample and filter blockSize samples into blockSize * L, one
+                                                                         * polyphase branch per output
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void arm_fir_interpolate_q15(const arm_fir_interpolate_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
+{
+    q15_t* pState = S->pState;
+    q15_t* pStateCurnt = S->pState + (S->phaseLength - 1);
+    uint32_t i, j, t;
+    q63_t sum;
+
+    for (i = blockSize; i > 0; i--)
+    {
+        *pStateCurnt++ = *pSrc++;
+        for (j = 1; j <= S->L; j++)
+        {
+            sum = 0;
+            for (t = 0; t < S->phaseLength; t++)
+            {
+                sum += (q31_t)pState[t] * S->pCoeffs[(S->L - j) + t * S->L];
+            }
+            *pDst++ = (q15_t)__SSAT((q31_t)(sum >> 15), 16);
+        }
+        pState++;
+    }
+
+    /* Keep the last phaseLength - 1 samples for the next call */
+    for (t = 0; t < S->phaseLength - 1u; t++)
+    {
+        S->pState[t] = pState[t];
+    }
+}
+
+/**
+ * @}
+ */
+
+#endif /* _RESAMPLE_FIR */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup RESAMPLE_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Initialize a converter between a high rate and the rate
+                                                                         * Factor times lower, clearing the filter histories
+                                                                         * @param[in]	r		Converter
+                                                                         * @param[in]	cfg		Configuration, copied
+                                                                         * @return		ERROR if NumTaps or BlockSize is not a multiple of Factor
+                                                                         **********************************************************************/
+Status RESAMPLE_Init(RESAMPLE_Type* r, const RESAMPLE_CFG_Type* cfg)
+{
+    uint32_t low = cfg->BlockSize / cfg->Factor;
+    q15_t* state = cfg->State;
+    uint8_t c;
+
+    CHECK_PARAM(PARAM_RESAMPLE_FACTOR(cfg->Factor));
+    CHECK_PARAM(PARAM_RESAMPLE_CHANNELS(cfg->Channels));
+
+    if (!PARAM_RESAMPLE_MULTIPLE(cfg->NumTaps, cfg->Factor) || !PARAM_RESAMPLE_MULTIPLE(cfg->BlockSize, cfg->Factor))
+    {
+        return ERROR;
+    }
+    r->Cfg = *cfg;
+    for (c = 0; c < cfg->Channels; c++)
+    {
+        if (cfg->DownCoeffs != NULL)
+        {
+            arm_fir_decimate_init_q15(&r->Down[c], cfg->NumTaps, cfg->Factor, cfg->DownCoeffs, state, cfg->BlockSize);
+        }
+        state += cfg->NumTaps + cfg->BlockSize - 1;
+        if (cfg->UpCoeffs != NULL)
+        {
+            arm_fir_interpolate_init_q15(&r->Up[c], cfg->Factor, cfg->NumTaps, cfg->UpCoeffs, state, low);
+        }
+        state += cfg->NumTaps / cfg->Factor + low - 1;
+    }
+    r->Scratch = (cfg->Channels == 2) ? state : NULL;
+    return SUCCESS;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Convert a block down: BlockSize frames in, BlockSize / Factor
+                                                                         * frames out
+                                                                         * @param[in]	r		Converter, initialized with DownCoeffs
+                                                                         * @param[in]	src		BlockSize frames at the high rate
+                                                                         * @param[out]	dst		BlockSize / Factor frames at the low rate
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void RESAMPLE_Down(RESAMPLE_Type* r, const q15_t* src, q15_t* dst)
+{
+    uint32_t n = r->Cfg.BlockSize;
+    uint32_t low = n / r->Cfg.Factor;
+    q15_t* left = r->Scratch;
+    q15_t* right = left + n;
+    q15_t* out = right + n;
+    uint32_t i;
+
+    if (r->Cfg.Channels == 1)
+    {
+        arm_fir_decimate_q15(&r->Down[0], (q15_t*)src, dst, n);
+        return;
+    }
+    for (i = 0; i < n; i++)
+    {
+        left[i] = src[2 * i];
+        right[i] = src[2 * i + 1];
+    }
+    arm_fir_decimate_q15(&r->Down[0], left, out, n);
+    arm_fir_decimate_q15(&r->Down[1], right, out + low, n);
+    for (i = 0; i < low; i++)
+    {
+        dst[2 * i] = out[i];
+        dst[2 * i + 1] = out[low + i];
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Convert a block up: BlockSize / Factor frames in, BlockSize
+                                                                         * frames out
+                                                                         * @param[in]	r		Converter, initialized with UpCoeffs
+                                                                         * @param[in]	src		BlockSize / Factor frames at the low rate
+                                                                         * @param[out]	dst		BlockSize frames at the high rate
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void RESAMPLE_Up(RESAMPLE_Type* r, const q15_t* src, q15_t* dst)
+{
+    uint32_t n = r->Cfg.BlockSize;
+    uint32_t low = n / r->Cfg.Factor;
+    q15_t* left = r->Scratch;
+    q15_t* right = left + n;
+    q15_t* in = right + n;
+    uint32_t i;
+
+    if (r->Cfg.Channels == 1)
+    {
+        arm_fir_interpolate_q15(&r->Up[0], (q15_t*)src, dst, low);
+        return;
+    }
+    for (i = 0; i < low; i++)
+    {
+        in[i] = src[2 * i];
+        in[low + i] = src[2 * i + 1];
+    }
+    arm_fir_interpolate_q15(&r->Up[0], in, left, low);
+    arm_fir_interpolate_q15(&r->Up[1], in + low, right, low);
+    for (i = 0; i < n; i++)
+    {
+        dst[2 * i] = left[i];
+        dst[2 * i + 1] = right[i];
+    }
+}
+
+/**
+ * @}
+ */
+
+#endif /* _RESAMPLE */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
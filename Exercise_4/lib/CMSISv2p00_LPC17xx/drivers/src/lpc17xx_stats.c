@@ -0,0 +1,286 @@
+/**********************************************************************
+ * $Id$		lpc17xx_stats.c				2010-05-21
+ *//**
+* @file		lpc17xx_stats.c
+* @brief	Contains all functions support for the fixed window running statistics on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup STATS
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_stats.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _STATS
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup STATS_Private_Functions STATS Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Add the sample about to be written at Head to a monotonic
+                                                                         * deque. Every slot enters and leaves the deque once, so the
+                                                                         * cost is amortized O(1)
+                                                                         * @param[in]	stats	Statistics block, sample not written yet
+                                                                         * @param[in]	q		Deque storage, Window entries
+                                                                         * @param[in]	first	Front of the deque
+                                                                         * @param[in]	len		Entries in the deque
+                                                                         * @param[in]	sample	New sample
+                                                                         * @param[in]	isMax	1 for the maximum deque, 0 for the minimum one
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void stats_deque_push(const STATS_Type* stats, uint16_t* q, uint16_t* first, uint16_t* len, int32_t sample,
+                             uint8_t isMax)
+{
+    uint16_t back;
+
+    /* The oldest sample leaves the window */
+    if ((stats->Count == stats->Window) && (*len != 0) && (q[*first] == stats->Head))
+    {
+        *first = (*first + 1 == stats->Window) ? 0 : (*first + 1);
+        (*len)--;
+    }
+
+    /* Samples the new one dominates can never be the extreme again */
+    while (*len != 0)
+    {
+        back = *first + *len - 1;
+        if (back >= stats->Window)
+        {
+            back -= stats->Window;
+        }
+        if (isMax ? (stats->Samples[q[back]] > sample) : (stats->Samples[q[back]] < sample))
+        {
+            break;
+        }
+        (*len)--;
+    }
+
+    back = *first + *len;
+    if (back >= stats->Window)
+    {
+        back -= stats->Window;
+    }
+    q[back] = stats->Head;
+    (*len)++;
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup STATS_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Empty the window
+                                                                         * @param[in]	stats	Statistics block
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void STATS_Reset(STATS_Type* stats)
+{
+    CHECK_PARAM(PARAM_STATS_WINDOW(stats->Window));
+
+    stats->Head = 0;
+    stats->Count = 0;
+    stats->MinFirst = 0;
+    stats->MinLen = 0;
+    stats->MaxFirst = 0;
+    stats->MaxLen = 0;
+    stats->Ref = 0;
+    stats->Sum = 0;
+    stats->Scatter = 0;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Add a sample, dropping the oldest one once the window is full.
+                                                                         * Integer only, safe to call from an ISR
+                                                                         * @param[in]	stats	Statistics block
+                                                                         * @param[in]	sample	New sample
+                                                                         * @return		None
+                                                                         * @note		A block must only be used from one execution context
+                                                                         * (one ISR or the main loop), the update is not atomic.
+                                                                         **********************************************************************/
+void STATS_Push(STATS_Type* stats, int32_t sample)
+{
+    uint16_t n = stats->Count;
+    uint8_t full = (n == stats->Window);
+    int32_t old = full ? stats->Samples[stats->Head] : 0;
+    int64_t d, dold, sumd, e;
+
+    if (stats->Options & STATS_OPT_VARIANCE)
+    {
+        if (n == 0)
+        {
+            stats->Ref = sample;
+            stats->Scatter = 0;
+        }
+        else
+        {
+            /* Offsets from Ref keep the squares small, the variance does not change */
+            sumd = stats->Sum - (int64_t)n * stats->Ref;
+            d = (int64_t)sample - stats->Ref;
+            if (full)
+            {
+                /* Welford remove and add in one step, scaled by the window
+                 * size: dC = (d - dold) * (n * (d + dold) - (sum + new sum)) */
+                dold = (int64_t)old - stats->Ref;
+                stats->Scatter += (d - dold) * ((int64_t)n * (d + dold) - (2 * sumd + d - dold));
+            }
+            else
+            {
+                /* Welford add, scaled by the count: C' = ((n + 1) C + (n d - sum)^2) / n,
+                 * the division is exact */
+                e = (int64_t)n * d - sumd;
+                stats->Scatter = ((int64_t)(n + 1) * stats->Scatter + e * e) / n;
+            }
+        }
+    }
+
+    if (stats->Options & STATS_OPT_MINMAX)
+    {
+        stats_deque_push(stats, stats->MinQ, &stats->MinFirst, &stats->MinLen, sample, 0);
+        stats_deque_push(stats, stats->MaxQ, &stats->MaxFirst, &stats->MaxLen, sample, 1);
+    }
+
+    stats->Sum += (int64_t)sample - old;
+    stats->Samples[stats->Head] = sample;
+    stats->Head = (stats->Head + 1 == stats->Window) ? 0 : (stats->Head + 1);
+    if (!full)
+    {
+        stats->Count = n + 1;
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the mean of the window, rounded toward zero
+                                                                         * @param[in]	stats	Statistics block
+                                                                         * @return		Mean, 0 if the window is empty
+                                                                         **********************************************************************/
+int32_t STATS_GetMean(const STATS_Type* stats)
+{
+    if (stats->Count == 0)
+    {
+        return 0;
+    }
+    return (int32_t)(stats->Sum / stats->Count);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the mean of the window in fixed point
+                                                                         * @param[in]	stats		Statistics block
+                                                                         * @param[in]	fracBits	Fractional bits of the result, 0 to 16
+                                                                         * @return		Mean * 2^fracBits, 0 if the window is empty
+                                                                         **********************************************************************/
+int32_t STATS_GetMeanFrac(const STATS_Type* stats, uint8_t fracBits)
+{
+    CHECK_PARAM(fracBits <= 16);
+
+    if (stats->Count == 0)
+    {
+        return 0;
+    }
+    return (int32_t)((stats->Sum * ((int64_t)1 << fracBits)) / stats->Count);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the smallest sample of the window
+                                                                         * @param[in]	stats	Statistics block, with STATS_OPT_MINMAX
+                                                                         * @return		Minimum, 0 if the window is empty
+                                                                         **********************************************************************/
+int32_t STATS_GetMin(const STATS_Type* stats)
+{
+    CHECK_PARAM(stats->Options & STATS_OPT_MINMAX);
+
+    if (stats->MinLen == 0)
+    {
+        return 0;
+    }
+    return stats->Samples[stats->MinQ[stats->MinFirst]];
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the largest sample of the window
+                                                                         * @param[in]	stats	Statistics block, with STATS_OPT_MINMAX
+                                                                         * @return		Maximum, 0 if the window is empty
+                                                                         **********************************************************************/
+int32_t STATS_GetMax(const STATS_Type* stats)
+{
+    CHECK_PARAM(stats->Options & STATS_OPT_MINMAX);
+
+    if (stats->MaxLen == 0)
+    {
+        return 0;
+    }
+    return stats->Samples[stats->MaxQ[stats->MaxFirst]];
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the population variance of the window
+                                                                         * @param[in]	stats	Statistics block, with STATS_OPT_VARIANCE
+                                                                         * @return		Variance rounded down, saturated to 0xFFFFFFFF
+                                                                         **********************************************************************/
+uint32_t STATS_GetVariance(const STATS_Type* stats)
+{
+    int64_t var;
+
+    CHECK_PARAM(stats->Options & STATS_OPT_VARIANCE);
+
+    if (stats->Count == 0)
+    {
+        return 0;
+    }
+    var = stats->Scatter / ((int64_t)stats->Count * stats->Count);
+    return (var > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)var;
+}
+
+/**
+ * @}
+ */
+
+#endif /* _STATS */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
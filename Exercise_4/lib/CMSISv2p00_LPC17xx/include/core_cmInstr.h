@@ -260,6 +260,149 @@ static __INLINE __ASM int32_t __REVSH(int32_t value)
 #include <cmsis_iar.h>
 
 
+#elif defined ( __USE_HOST_SIM ) /*------------------ Host Simulator -------------------*/
+/* Host simulator functions (see sim_LPC17xx.h). The core is the host CPU,
+   hint instructions hand control to the peripheral model and the exclusive
+   monitor is emulated so LDREX/STREX loops behave as on the target. Like the
+   Cortex-M3 local monitor it does not compare addresses: a store exclusive
+   succeeds if no exception or CLREX came since the last load exclusive. */
+
+extern volatile uint32_t * volatile SIM_ExclusiveAddr;
+extern void SIM_WaitForInterrupt(void);
+
+static __INLINE void __NOP(void)
+{
+  __ASM volatile ("nop");
+}
+
+static __INLINE void __WFI(void)
+{
+  SIM_WaitForInterrupt();
+}
+
+static __INLINE void __WFE(void)
+{
+  SIM_WaitForInterrupt();
+}
+
+static __INLINE void __SEV(void)
+{
+}
+
+static __INLINE void __ISB(void)
+{
+  __ASM volatile ("" : : : "memory");
+}
+
+static __INLINE void __DSB(void)
+{
+  __sync_synchronize();
+}
+
+static __INLINE void __DMB(void)
+{
+  __sync_synchronize();
+}
+
+static __INLINE uint32_t __REV(uint32_t value)
+{
+  return __builtin_bswap32(value);
+}
+
+static __INLINE uint32_t __REV16(uint32_t value)
+{
+  return ((value & 0xFF00FF00UL) >> 8) | ((value & 0x00FF00FFUL) << 8);
+}
+
+static __INLINE int32_t __REVSH(int32_t value)
+{
+  return (int16_t)__builtin_bswap16((uint16_t)value);
+}
+
+#if       (__CORTEX_M >= 0x03)
+
+static __INLINE uint32_t __RBIT(uint32_t value)
+{
+  uint32_t result = 0;
+  uint32_t i;
+
+  for (i = 0; i < 32; i++)
+  {
+    result = (result << 1) | (value & 1);
+    value >>= 1;
+  }
+  return(result);
+}
+
+static __INLINE uint8_t __LDREXB(volatile uint8_t *addr)
+{
+  SIM_ExclusiveAddr = (volatile uint32_t *)addr;
+  return(*addr);
+}
+
+static __INLINE uint16_t __LDREXH(volatile uint16_t *addr)
+{
+  SIM_ExclusiveAddr = (volatile uint32_t *)addr;
+  return(*addr);
+}
+
+static __INLINE uint32_t __LDREXW(volatile uint32_t *addr)
+{
+  SIM_ExclusiveAddr = addr;
+  return(*addr);
+}
+
+static __INLINE uint32_t __STREXB(uint8_t value, volatile uint8_t *addr)
+{
+  if (SIM_ExclusiveAddr == 0) return(1);
+  SIM_ExclusiveAddr = 0;
+  *addr = value;
+  return(0);
+}
+
+static __INLINE uint32_t __STREXH(uint16_t value, volatile uint16_t *addr)
+{
+  if (SIM_ExclusiveAddr == 0) return(1);
+  SIM_ExclusiveAddr = 0;
+  *addr = value;
+  return(0);
+}
+
+static __INLINE uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)
+{
+  if (SIM_ExclusiveAddr == 0) return(1);
+  SIM_ExclusiveAddr = 0;
+  *addr = value;
+  return(0);
+}
+
+static __INLINE void __CLREX(void)
+{
+  SIM_ExclusiveAddr = 0;
+}
+
+#define __SSAT(ARG1,ARG2) \
+({                          \
+  int64_t __ARG1 = (int32_t)(ARG1); \
+  int64_t __MAX = (int64_t)((1ULL << ((ARG2) - 1)) - 1); \
+  (uint32_t)((__ARG1 > __MAX) ? __MAX : ((__ARG1 < -__MAX - 1) ? (-__MAX - 1) : __ARG1)); \
+ })
+
+#define __USAT(ARG1,ARG2) \
+({                          \
+  int64_t __ARG1 = (int32_t)(ARG1); \
+  int64_t __MAX = (int64_t)((1ULL << (ARG2)) - 1); \
+  (uint32_t)((__ARG1 > __MAX) ? __MAX : ((__ARG1 < 0) ? 0 : __ARG1)); \
+ })
+
+static __INLINE uint8_t __CLZ(uint32_t value)
+{
+  return (value == 0) ? 32 : (uint8_t)__builtin_clz(value);
+}
+
+#endif /* (__CORTEX_M >= 0x03) */
+
+
 #elif defined ( __GNUC__ ) /*------------------ GNU Compiler ---------------------*/
 /* GNU gcc specific functions */
 
@@ -0,0 +1,3524 @@
+/**************************************************************************//**
+ * @file     sim_LPC17xx_periph.c
+ * @brief    Host register simulator for the NXP LPC17xx Device Series,
+ *           behavioural models of the on-chip peripherals
+ * @version  V1.00
+ *
+ * @note
+ * Models: system control (PLL, oscillator), GPIO and GPIO interrupts,
+ * UART0..3, SSP0/1, I2C0..2, CAN1/2, EMAC, TIMER0..3, ADC, DAC, I2S and
+ * GPDMA. Each model keeps its register image in the shadow view and only adds
+ * the behaviour the driver library can observe: FIFOs, status flags,
+ * write-1-to-clear bits, counters, IRQ lines and DMA request lines. Timing is
+ * in core clock cycles and uses the PCLKSELx dividers, so baud rates and
+ * sample rates come out as on the target.
+ *
+ ******************************************************************************/
+
+#ifdef __USE_HOST_SIM
+
+#include <stddef.h>
+#include <string.h>
+
+#include "LPC17xx.h"
+#include "sim_LPC17xx.h"
+
+/** @addtogroup LPC17xx_Simulator
+ * @{
+ */
+
+#define SIM_OFS(type, reg)      ((uint32_t)offsetof(type, reg))
+#define SIM_REG(base, type, reg) (*SIM_Reg((base) + SIM_OFS(type, reg)))
+
+#define SIM_DMA_CONNS           24              /* GPDMA_CONN_SSP0_Tx .. GPDMA_CONN_MAT3_1 */
+#define SIM_DMA_CHANNELS        8
+#define SIM_DMA_MAX_BURSTS      65536           /* bursts moved per service call           */
+
+/* PCLKSEL bit positions (CLKPWR_PCLKSEL_xxx) */
+#define SIM_PCLK_TIMER0         2
+#define SIM_PCLK_TIMER1         4
+#define SIM_PCLK_UART0          6
+#define SIM_PCLK_UART1          8
+#define SIM_PCLK_SSP1           20
+#define SIM_PCLK_DAC            22
+#define SIM_PCLK_ADC            24
+#define SIM_PCLK_CAN1           26
+#define SIM_PCLK_CAN2           28
+#define SIM_PCLK_SSP0           42
+#define SIM_PCLK_TIMER2         44
+#define SIM_PCLK_TIMER3         46
+#define SIM_PCLK_UART2          48
+#define SIM_PCLK_UART3          50
+#define SIM_PCLK_I2S            54
+
+static void sim_dma_service(void);
+static void sim_adc_trigger(uint8_t mode);
+
+/* Core clock cycles per peripheral clock of the block at PCLKSEL position pos */
+static uint32_t sim_pclk_div(uint32_t pos)
+{
+    static const uint8_t div[4] = { 4, 1, 2, 8 };
+    uint32_t sel;
+
+    sel = (pos < 32) ? SIM_REG(LPC_SC_BASE, LPC_SC_TypeDef, PCLKSEL0)
+                     : SIM_REG(LPC_SC_BASE, LPC_SC_TypeDef, PCLKSEL1);
+    return div[(sel >> (pos & 31)) & 3];
+}
+
+static void sim_irq_line(IRQn_Type irq, uint32_t asserted)
+{
+    if (asserted)
+    {
+        SIM_SetPendingIRQ(irq);
+    }
+}
+
+
+/*----------------------------------------------------------------------------
+  System control: oscillator, PLL0/PLL1 feed sequence, external interrupts
+ *----------------------------------------------------------------------------*/
+#define SIM_SC(reg)             SIM_REG(LPC_SC_BASE, LPC_SC_TypeDef, reg)
+
+static uint8_t sim_pll_feed[2];
+
+static void sim_sc_feed(uint8_t pll, uint32_t value)
+{
+    uint32_t con, cfg;
+
+    if (value == 0xAA)
+    {
+        sim_pll_feed[pll] = 1;
+        return;
+    }
+    if ((value != 0x55) || !sim_pll_feed[pll])
+    {
+        sim_pll_feed[pll] = 0;
+        return;
+    }
+    sim_pll_feed[pll] = 0;
+
+    /* Feed complete: the PLL takes the new settings and locks at once */
+    if (pll == 0)
+    {
+        con = SIM_SC(PLL0CON);
+        cfg = SIM_SC(PLL0CFG);
+        SIM_SC(PLL0STAT) = (cfg & 0x00FF7FFFUL) | ((con & 3UL) << 24) | ((con & 1UL) << 26);
+    }
+    else
+    {
+        con = SIM_SC(PLL1CON);
+        cfg = SIM_SC(PLL1CFG);
+        SIM_SC(PLL1STAT) = (cfg & 0x7FUL) | ((con & 3UL) << 8) | ((con & 1UL) << 10);
+    }
+}
+
+static void sim_sc_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    volatile uint32_t* reg = SIM_Reg(model->base + offset);
+
+    switch (offset)
+    {
+        case SIM_OFS(LPC_SC_TypeDef, PLL0FEED):
+            sim_sc_feed(0, *reg & 0xFF);
+            *reg = 0;
+            break;
+        case SIM_OFS(LPC_SC_TypeDef, PLL1FEED):
+            sim_sc_feed(1, *reg & 0xFF);
+            *reg = 0;
+            break;
+        case SIM_OFS(LPC_SC_TypeDef, PLL0STAT):
+        case SIM_OFS(LPC_SC_TypeDef, PLL1STAT):
+            *reg = prev;                                          /* read-only */
+            break;
+        case SIM_OFS(LPC_SC_TypeDef, SCS):
+            /* OSCSTAT follows OSCEN, the crystal starts immediately */
+            *reg = (*reg & ~(1UL << 6)) | ((*reg & (1UL << 5)) << 1);
+            break;
+        case SIM_OFS(LPC_SC_TypeDef, EXTINT):
+            *reg = prev & ~*reg;                                  /* write-1-to-clear */
+            break;
+        default:
+            break;
+    }
+}
+
+static void sim_sc_reset(SIM_Model_Type* model)
+{
+    (void)model;
+    sim_pll_feed[0] = sim_pll_feed[1] = 0;
+    SIM_SC(PCONP) = 0x042887DEUL;
+    SIM_SC(FLASHCFG) = 0x0000303AUL;
+}
+
+static SIM_Model_Type sim_sc_model =
+{
+    LPC_SC_BASE, "SC", sim_sc_reset, NULL, NULL, sim_sc_write, NULL, NULL, 0
+};
+
+
+/*----------------------------------------------------------------------------
+  GPIO ports and GPIO interrupts (EINT3)
+ *----------------------------------------------------------------------------*/
+#define SIM_GPIO_PORTS          5
+#define SIM_GPIO_PORT_SIZE      0x20
+#define SIM_GPIOINT_PAGE        (LPC_GPIOINT_BASE & ~0xFFFUL)
+#define SIM_GPIOINT(reg)        SIM_REG(LPC_GPIOINT_BASE, LPC_GPIOINT_TypeDef, reg)
+
+static uint32_t sim_gpio_latch[SIM_GPIO_PORTS];
+static uint32_t sim_gpio_input[SIM_GPIO_PORTS];
+static uint32_t sim_gpio_level[SIM_GPIO_PORTS];
+
+static void sim_gpioint_lines(void)
+{
+    uint32_t status = 0;
+
+    if (SIM_GPIOINT(IO0IntStatR) | SIM_GPIOINT(IO0IntStatF)) status |= 1UL << 0;
+    if (SIM_GPIOINT(IO2IntStatR) | SIM_GPIOINT(IO2IntStatF)) status |= 1UL << 2;
+    SIM_GPIOINT(IntStatus) = status;
+    sim_irq_line(EINT3_IRQn, status);
+}
+
+/* Recompute the pin levels of a port and latch GPIO interrupt edges */
+static void sim_gpio_refresh(uint8_t port)
+{
+    uint32_t base = LPC_GPIO_BASE + port * SIM_GPIO_PORT_SIZE;
+    uint32_t dir  = SIM_REG(base, LPC_GPIO_TypeDef, FIODIR);
+    uint32_t mask = SIM_REG(base, LPC_GPIO_TypeDef, FIOMASK);
+    uint32_t level = (sim_gpio_latch[port] & dir) | (sim_gpio_input[port] & ~dir);
+    uint32_t rise = level & ~sim_gpio_level[port];
+    uint32_t fall = sim_gpio_level[port] & ~level;
+
+    sim_gpio_level[port] = level;
+    SIM_REG(base, LPC_GPIO_TypeDef, FIOPIN) = level & ~mask;
+    SIM_REG(base, LPC_GPIO_TypeDef, FIOSET) = sim_gpio_latch[port];
+    SIM_REG(base, LPC_GPIO_TypeDef, FIOCLR) = 0;
+
+    if ((rise | fall) == 0)
+    {
+        return;
+    }
+    if (port == 0)
+    {
+        SIM_GPIOINT(IO0IntStatR) |= rise & SIM_GPIOINT(IO0IntEnR);
+        SIM_GPIOINT(IO0IntStatF) |= fall & SIM_GPIOINT(IO0IntEnF);
+    }
+    else if (port == 2)
+    {
+        SIM_GPIOINT(IO2IntStatR) |= rise & SIM_GPIOINT(IO2IntEnR);
+        SIM_GPIOINT(IO2IntStatF) |= fall & SIM_GPIOINT(IO2IntEnF);
+    }
+    sim_gpioint_lines();
+}
+
+static void sim_gpio_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    uint8_t port = (uint8_t)(offset / SIM_GPIO_PORT_SIZE);
+    uint32_t base = LPC_GPIO_BASE + port * SIM_GPIO_PORT_SIZE;
+    uint32_t value = *SIM_Reg(model->base + offset);
+    uint32_t mask;
+
+    (void)prev;
+    if (port >= SIM_GPIO_PORTS)
+    {
+        return;
+    }
+
+    /* Byte and halfword stores leave the other lanes of the image unchanged,
+     * which is harmless for every register of the port below */
+    mask = SIM_REG(base, LPC_GPIO_TypeDef, FIOMASK);
+    switch (offset % SIM_GPIO_PORT_SIZE)
+    {
+        case SIM_OFS(LPC_GPIO_TypeDef, FIOPIN):
+            sim_gpio_latch[port] = (sim_gpio_latch[port] & mask) | (value & ~mask);
+            break;
+        case SIM_OFS(LPC_GPIO_TypeDef, FIOSET):
+            sim_gpio_latch[port] |= value & ~mask;
+            break;
+        case SIM_OFS(LPC_GPIO_TypeDef, FIOCLR):
+            sim_gpio_latch[port] &= ~(value & ~mask);
+            break;
+        default:
+            break;
+    }
+    sim_gpio_refresh(port);
+}
+
+static void sim_gpio_reset(SIM_Model_Type* model)
+{
+    uint8_t port;
+
+    (void)model;
+    for (port = 0; port < SIM_GPIO_PORTS; port++)
+    {
+        sim_gpio_latch[port] = 0;
+        sim_gpio_level[port] = sim_gpio_input[port];
+        SIM_REG(LPC_GPIO_BASE + port * SIM_GPIO_PORT_SIZE, LPC_GPIO_TypeDef, FIOPIN) = sim_gpio_input[port];
+    }
+}
+
+static SIM_Model_Type sim_gpio_model =
+{
+    LPC_GPIO_BASE, "GPIO", sim_gpio_reset, NULL, NULL, sim_gpio_write, NULL, NULL, 0
+};
+
+static void sim_gpioint_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    volatile uint32_t* reg = SIM_Reg(model->base + offset);
+    uint32_t value = *reg;
+
+    switch (offset - (LPC_GPIOINT_BASE - SIM_GPIOINT_PAGE))
+    {
+        case SIM_OFS(LPC_GPIOINT_TypeDef, IO0IntClr):
+            SIM_GPIOINT(IO0IntStatR) &= ~value;
+            SIM_GPIOINT(IO0IntStatF) &= ~value;
+            *reg = 0;
+            break;
+        case SIM_OFS(LPC_GPIOINT_TypeDef, IO2IntClr):
+            SIM_GPIOINT(IO2IntStatR) &= ~value;
+            SIM_GPIOINT(IO2IntStatF) &= ~value;
+            *reg = 0;
+            break;
+        case SIM_OFS(LPC_GPIOINT_TypeDef, IntStatus):
+        case SIM_OFS(LPC_GPIOINT_TypeDef, IO0IntStatR):
+        case SIM_OFS(LPC_GPIOINT_TypeDef, IO0IntStatF):
+        case SIM_OFS(LPC_GPIOINT_TypeDef, IO2IntStatR):
+        case SIM_OFS(LPC_GPIOINT_TypeDef, IO2IntStatF):
+            *reg = prev;                                          /* read-only */
+            break;
+        default:
+            break;
+    }
+    sim_gpioint_lines();
+}
+
+static void sim_gpioint_update(SIM_Model_Type* model)
+{
+    (void)model;
+    sim_gpioint_lines();
+}
+
+static SIM_Model_Type sim_gpioint_model =
+{
+    SIM_GPIOINT_PAGE, "GPIOINT", NULL, NULL, NULL, sim_gpioint_write, NULL, sim_gpioint_update, 0
+};
+
+/**
+ * Drive GPIO input pins from the host side (pins configured as inputs)
+ *
+ * @param  port   GPIO port 0..4
+ * @param  mask   pins to change
+ * @param  value  new levels of the pins in mask
+ */
+void SIM_GPIO_SetInput(uint8_t port, uint32_t mask, uint32_t value)
+{
+    if (port >= SIM_GPIO_PORTS)
+    {
+        return;
+    }
+    sim_gpio_input[port] = (sim_gpio_input[port] & ~mask) | (value & mask);
+    sim_gpio_refresh(port);
+}
+
+/**
+ * Levels driven by the pins configured as outputs
+ *
+ * @param  port  GPIO port 0..4
+ * @return output latch, masked by FIODIR
+ */
+uint32_t SIM_GPIO_GetOutput(uint8_t port)
+{
+    if (port >= SIM_GPIO_PORTS)
+    {
+        return 0;
+    }
+    return sim_gpio_latch[port] &
+           SIM_REG(LPC_GPIO_BASE + port * SIM_GPIO_PORT_SIZE, LPC_GPIO_TypeDef, FIODIR);
+}
+
+
+/*----------------------------------------------------------------------------
+  UART0..3
+ *----------------------------------------------------------------------------*/
+#define SIM_UART_FIFO           16
+
+#define SIM_UART_LCR_DLAB       (1UL << 7)
+#define SIM_UART_FCR_FIFO_EN    (1UL << 0)
+#define SIM_UART_FCR_RX_RESET   (1UL << 1)
+#define SIM_UART_FCR_TX_RESET   (1UL << 2)
+#define SIM_UART_FCR_DMA        (1UL << 3)
+#define SIM_UART_IER_RBR        (1UL << 0)
+#define SIM_UART_IER_THRE       (1UL << 1)
+#define SIM_UART_IER_RLS        (1UL << 2)
+#define SIM_UART_LSR_RDR        (1UL << 0)
+#define SIM_UART_LSR_OE         (1UL << 1)
+#define SIM_UART_LSR_THRE       (1UL << 5)
+#define SIM_UART_LSR_TEMT       (1UL << 6)
+#define SIM_UART_IIR_NONE       0x01
+#define SIM_UART_IIR_RLS        0x06
+#define SIM_UART_IIR_RDA        0x04
+#define SIM_UART_IIR_CTI        0x0C
+#define SIM_UART_IIR_THRE       0x02
+
+typedef struct
+{
+    SIM_Model_Type model;
+    IRQn_Type irq;
+    uint8_t pclk;
+    uint8_t conn_tx;
+    uint8_t paced;
+    uint8_t dll, dlm, ier, fcr;
+    uint8_t overrun;
+    uint8_t thre_int;
+    uint8_t rx[SIM_UART_FIFO], rx_head, rx_count;
+    uint8_t tx[SIM_UART_FIFO], tx_head, tx_count;
+    uint64_t rx_time, tx_time;
+    uint8_t backlog[SIM_UART_BUF_SIZE];
+    uint32_t backlog_head, backlog_count;
+    uint8_t capture[SIM_UART_BUF_SIZE];
+    uint32_t capture_head, capture_count;
+} SIM_UART_Type;
+
+static SIM_UART_Type sim_uart[4] =
+{
+    { { LPC_UART0_BASE, "UART0" }, UART0_IRQn, SIM_PCLK_UART0, 8 },
+    { { LPC_UART1_BASE, "UART1" }, UART1_IRQn, SIM_PCLK_UART1, 10 },
+    { { LPC_UART2_BASE, "UART2" }, UART2_IRQn, SIM_PCLK_UART2, 12 },
+    { { LPC_UART3_BASE, "UART3" }, UART3_IRQn, SIM_PCLK_UART3, 14 },
+};
+
+static volatile uint8_t* sim_uart_reg8(SIM_UART_Type* u, uint32_t offset)
+{
+    return (volatile uint8_t*)SIM_Reg(u->model.base + offset);
+}
+
+/* Core clock cycles taken by one character at the programmed baud rate */
+static uint64_t sim_uart_char_time(SIM_UART_Type* u)
+{
+    uint8_t lcr = *sim_uart_reg8(u, SIM_OFS(LPC_UART_TypeDef, LCR));
+    uint8_t fdr = *sim_uart_reg8(u, SIM_OFS(LPC_UART_TypeDef, FDR));
+    uint32_t divisor = ((uint32_t)u->dlm << 8) | u->dll;
+    uint32_t mul = (fdr >> 4) ? (fdr >> 4) : 1;
+    uint32_t bits = 1 + 5 + (lcr & 3) + ((lcr >> 3) & 1) + 1 + ((lcr >> 2) & 1);
+
+    if (divisor == 0)
+    {
+        divisor = 1;
+    }
+    return ((uint64_t)sim_pclk_div(u->pclk) * 16 * divisor * bits * (mul + (fdr & 0xF))) / mul;
+}
+
+static uint8_t sim_uart_trigger(SIM_UART_Type* u)
+{
+    static const uint8_t level[4] = { 1, 4, 8, 14 };
+
+    return level[u->fcr >> 6];
+}
+
+static uint8_t sim_uart_iir(SIM_UART_Type* u)
+{
+    if ((u->ier & SIM_UART_IER_RLS) && u->overrun)
+    {
+        return SIM_UART_IIR_RLS;
+    }
+    if ((u->ier & SIM_UART_IER_RBR) && u->rx_count)
+    {
+        return (u->rx_count >= sim_uart_trigger(u)) ? SIM_UART_IIR_RDA : SIM_UART_IIR_CTI;
+    }
+    if ((u->ier & SIM_UART_IER_THRE) && u->thre_int)
+    {
+        return SIM_UART_IIR_THRE;
+    }
+    return SIM_UART_IIR_NONE;
+}
+
+static void sim_uart_lines(SIM_UART_Type* u)
+{
+    uint8_t dma = (u->fcr & SIM_UART_FCR_DMA) != 0;
+
+    sim_irq_line(u->irq, sim_uart_iir(u) != SIM_UART_IIR_NONE);
+    SIM_DMARequest(u->conn_tx, dma && (u->tx_count < SIM_UART_FIFO));
+    SIM_DMARequest(u->conn_tx + 1, dma && (u->rx_count != 0));
+}
+
+static void sim_uart_capture(SIM_UART_Type* u, uint8_t c)
+{
+    u->capture[(u->capture_head + u->capture_count) % SIM_UART_BUF_SIZE] = c;
+    if (u->capture_count < SIM_UART_BUF_SIZE)
+    {
+        u->capture_count++;
+    }
+    else
+    {
+        u->capture_head = (u->capture_head + 1) % SIM_UART_BUF_SIZE;  /* drop the oldest */
+    }
+}
+
+/* Move one character from the host backlog into the RX FIFO */
+static void sim_uart_receive(SIM_UART_Type* u)
+{
+    uint8_t c = u->backlog[u->backlog_head];
+
+    u->backlog_head = (u->backlog_head + 1) % SIM_UART_BUF_SIZE;
+    u->backlog_count--;
+    if (u->rx_count == SIM_UART_FIFO)
+    {
+        u->overrun = 1;
+        return;
+    }
+    u->rx[(u->rx_head + u->rx_count++) % SIM_UART_FIFO] = c;
+}
+
+/* Unpaced mode: characters arrive and leave as fast as the FIFOs allow */
+static void sim_uart_flow(SIM_UART_Type* u)
+{
+    if (u->paced)
+    {
+        return;
+    }
+    while (u->backlog_count && (u->rx_count < SIM_UART_FIFO))
+    {
+        sim_uart_receive(u);
+    }
+    while (u->tx_count)
+    {
+        sim_uart_capture(u, u->tx[u->tx_head]);
+        u->tx_head = (u->tx_head + 1) % SIM_UART_FIFO;
+        if (--u->tx_count == 0)
+        {
+            u->thre_int = 1;
+        }
+    }
+}
+
+static void sim_uart_read(SIM_Model_Type* model, uint32_t offset)
+{
+    SIM_UART_Type* u = (SIM_UART_Type*)model;
+    uint8_t dlab = (*sim_uart_reg8(u, SIM_OFS(LPC_UART_TypeDef, LCR)) & SIM_UART_LCR_DLAB) != 0;
+    uint8_t lsr;
+
+    switch (offset)
+    {
+        case 0x00:
+            *sim_uart_reg8(u, offset) = dlab ? u->dll : (u->rx_count ? u->rx[u->rx_head] : 0);
+            break;
+        case 0x04:
+            *SIM_Reg(model->base + offset) = dlab ? u->dlm : u->ier;
+            break;
+        case SIM_OFS(LPC_UART_TypeDef, IIR):
+            *SIM_Reg(model->base + offset) = sim_uart_iir(u) | ((u->fcr & SIM_UART_FCR_FIFO_EN) ? 0xC0 : 0);
+            break;
+        case SIM_OFS(LPC_UART_TypeDef, LSR):
+            lsr = 0;
+            if (u->rx_count)   lsr |= SIM_UART_LSR_RDR;
+            if (u->overrun)    lsr |= SIM_UART_LSR_OE;
+            if (!u->tx_count)  lsr |= SIM_UART_LSR_THRE | SIM_UART_LSR_TEMT;
+            *sim_uart_reg8(u, offset) = lsr;
+            break;
+        case SIM_OFS(LPC_UART_TypeDef, FIFOLVL):
+            *SIM_Reg(model->base + offset) = u->rx_count | ((uint32_t)u->tx_count << 8);
+            break;
+        default:
+            break;
+    }
+}
+
+static void sim_uart_read_done(SIM_Model_Type* model, uint32_t offset)
+{
+    SIM_UART_Type* u = (SIM_UART_Type*)model;
+    uint8_t dlab = (*sim_uart_reg8(u, SIM_OFS(LPC_UART_TypeDef, LCR)) & SIM_UART_LCR_DLAB) != 0;
+
+    if ((offset == 0x00) && !dlab && u->rx_count)
+    {
+        u->rx_head = (u->rx_head + 1) % SIM_UART_FIFO;
+        u->rx_count--;
+    }
+    else if (offset == SIM_OFS(LPC_UART_TypeDef, IIR))
+    {
+        if ((*SIM_Reg(model->base + offset) & 0x0F) == SIM_UART_IIR_THRE)
+        {
+            u->thre_int = 0;                        /* reading IIR clears the THRE source */
+        }
+    }
+    else if (offset == SIM_OFS(LPC_UART_TypeDef, LSR))
+    {
+        u->overrun = 0;
+    }
+    else
+    {
+        return;
+    }
+    sim_uart_flow(u);
+    sim_uart_lines(u);
+}
+
+static void sim_uart_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    SIM_UART_Type* u = (SIM_UART_Type*)model;
+    uint32_t value = *SIM_Reg(model->base + offset);
+    uint8_t dlab = (*sim_uart_reg8(u, SIM_OFS(LPC_UART_TypeDef, LCR)) & SIM_UART_LCR_DLAB) != 0;
+
+    switch (offset)
+    {
+        case 0x00:
+            if (dlab)
+            {
+                u->dll = (uint8_t)value;
+            }
+            else
+            {
+                if (u->tx_count < SIM_UART_FIFO)
+                {
+                    if (u->paced && !u->tx_count)
+                    {
+                        u->tx_time = 0;
+                    }
+                    u->tx[(u->tx_head + u->tx_count++) % SIM_UART_FIFO] = (uint8_t)value;
+                }
+                u->thre_int = 0;
+            }
+            break;
+        case 0x04:
+            if (dlab)
+            {
+                u->dlm = (uint8_t)value;
+            }
+            else
+            {
+                if ((value & ~u->ier & SIM_UART_IER_THRE) && !u->tx_count)
+                {
+                    u->thre_int = 1;
+                }
+                u->ier = (uint8_t)(value & 0x307);
+            }
+            break;
+        case SIM_OFS(LPC_UART_TypeDef, FCR):
+            if (value & SIM_UART_FCR_RX_RESET)
+            {
+                u->rx_head = u->rx_count = 0;
+            }
+            if (value & SIM_UART_FCR_TX_RESET)
+            {
+                u->tx_head = u->tx_count = 0;
+            }
+            u->fcr = (uint8_t)(value & 0xC9);
+            *SIM_Reg(model->base + offset) = prev;              /* IIR shares the address */
+            break;
+        case SIM_OFS(LPC_UART_TypeDef, LSR):
+            *SIM_Reg(model->base + offset) = prev;              /* read-only */
+            break;
+        default:
+            return;
+    }
+    sim_uart_flow(u);
+    sim_uart_lines(u);
+}
+
+static void sim_uart_advance(SIM_Model_Type* model, uint32_t cycles)
+{
+    SIM_UART_Type* u = (SIM_UART_Type*)model;
+    uint64_t char_time;
+    uint8_t changed = 0;
+
+    if (!u->paced || (!u->tx_count && !u->backlog_count))
+    {
+        return;
+    }
+    char_time = sim_uart_char_time(u);
+
+    if (u->tx_count)
+    {
+        u->tx_time += cycles;
+        while (u->tx_count && (u->tx_time >= char_time))
+        {
+            u->tx_time -= char_time;
+            sim_uart_capture(u, u->tx[u->tx_head]);
+            u->tx_head = (u->tx_head + 1) % SIM_UART_FIFO;
+            if (--u->tx_count == 0)
+            {
+                u->thre_int = 1;
+            }
+            changed = 1;
+        }
+    }
+    if (u->backlog_count)
+    {
+        u->rx_time += cycles;
+        while (u->backlog_count && (u->rx_time >= char_time))
+        {
+            u->rx_time -= char_time;
+            sim_uart_receive(u);
+            changed = 1;
+        }
+    }
+    if (changed)
+    {
+        sim_uart_lines(u);
+    }
+}
+
+static void sim_uart_update(SIM_Model_Type* model)
+{
+    sim_uart_lines((SIM_UART_Type*)model);
+}
+
+static void sim_uart_reset(SIM_Model_Type* model)
+{
+    SIM_UART_Type* u = (SIM_UART_Type*)model;
+
+    u->dll = 1;
+    u->dlm = u->ier = u->fcr = 0;
+    u->overrun = 0;
+    u->thre_int = 0;
+    u->rx_head = u->rx_count = 0;
+    u->tx_head = u->tx_count = 0;
+    u->rx_time = u->tx_time = 0;
+    u->backlog_head = u->backlog_count = 0;
+    u->capture_head = u->capture_count = 0;
+    *sim_uart_reg8(u, SIM_OFS(LPC_UART_TypeDef, LCR)) = 0x03;
+    *sim_uart_reg8(u, SIM_OFS(LPC_UART_TypeDef, FDR)) = 0x10;
+    *sim_uart_reg8(u, SIM_OFS(LPC_UART_TypeDef, TER)) = 0x80;
+}
+
+/**
+ * Queue characters for the UART receiver. Unpaced they fill the RX FIFO
+ * as soon as there is room, paced they arrive at the programmed baud rate.
+ *
+ * @param  uart  UART number 0..3
+ * @param  data  characters
+ * @param  len   number of characters, the excess over the backlog is dropped
+ */
+void SIM_UART_Inject(uint8_t uart, const uint8_t* data, uint32_t len)
+{
+    SIM_UART_Type* u;
+
+    if (uart > 3)
+    {
+        return;
+    }
+    u = &sim_uart[uart];
+    while (len-- && (u->backlog_count < SIM_UART_BUF_SIZE))
+    {
+        u->backlog[(u->backlog_head + u->backlog_count++) % SIM_UART_BUF_SIZE] = *data++;
+    }
+    sim_uart_flow(u);
+    sim_uart_lines(u);
+}
+
+/**
+ * Fetch the characters the UART has transmitted so far
+ *
+ * @param  uart  UART number 0..3
+ * @param  data  destination buffer
+ * @param  max   size of data
+ * @return number of characters copied
+ */
+uint32_t SIM_UART_Drain(uint8_t uart, uint8_t* data, uint32_t max)
+{
+    SIM_UART_Type* u;
+    uint32_t n = 0;
+
+    if (uart > 3)
+    {
+        return 0;
+    }
+    u = &sim_uart[uart];
+    while ((n < max) && u->capture_count)
+    {
+        data[n++] = u->capture[u->capture_head];
+        u->capture_head = (u->capture_head + 1) % SIM_UART_BUF_SIZE;
+        u->capture_count--;
+    }
+    return n;
+}
+
+/**
+ * Select unpaced (default, infinitely fast line) or baud rate paced timing
+ *
+ * @param  uart    UART number 0..3
+ * @param  enable  1: paced
+ */
+void SIM_UART_SetPaced(uint8_t uart, uint8_t enable)
+{
+    if (uart > 3)
+    {
+        return;
+    }
+    sim_uart[uart].paced = enable;
+    sim_uart[uart].rx_time = sim_uart[uart].tx_time = 0;
+    sim_uart_flow(&sim_uart[uart]);
+    sim_uart_lines(&sim_uart[uart]);
+}
+
+
+/*----------------------------------------------------------------------------
+  SSP0/1
+ *----------------------------------------------------------------------------*/
+#define SIM_SSP_FIFO            8
+
+#define SIM_SSP_CR1_LBM         (1UL << 0)
+#define SIM_SSP_CR1_SSE         (1UL << 1)
+#define SIM_SSP_SR_TFE          (1UL << 0)
+#define SIM_SSP_SR_TNF          (1UL << 1)
+#define SIM_SSP_SR_RNE          (1UL << 2)
+#define SIM_SSP_SR_RFF          (1UL << 3)
+#define SIM_SSP_INT_ROR         (1UL << 0)
+#define SIM_SSP_INT_RT          (1UL << 1)
+#define SIM_SSP_INT_RX          (1UL << 2)
+#define SIM_SSP_INT_TX          (1UL << 3)
+#define SIM_SSP_DMA_RX          (1UL << 0)
+#define SIM_SSP_DMA_TX          (1UL << 1)
+
+typedef struct
+{
+    SIM_Model_Type model;
+    IRQn_Type irq;
+    uint8_t num;
+    uint8_t conn_tx;
+    uint8_t ror;
+    uint16_t rx[SIM_SSP_FIFO];
+    uint8_t rx_head, rx_count;
+    uint16_t (*device)(uint8_t ssp, uint16_t mosi);
+} SIM_SSP_Type;
+
+static SIM_SSP_Type sim_ssp[2] =
+{
+    { { LPC_SSP0_BASE, "SSP0" }, SSP0_IRQn, 0, 0 },
+    { { LPC_SSP1_BASE, "SSP1" }, SSP1_IRQn, 1, 2 },
+};
+
+#define SIM_SSP(u, reg)         SIM_REG((u)->model.base, LPC_SSP_TypeDef, reg)
+
+static uint32_t sim_ssp_ris(SIM_SSP_Type* s)
+{
+    uint32_t ris = SIM_SSP_INT_TX;                        /* the TX FIFO never fills */
+
+    if (s->ror)                             ris |= SIM_SSP_INT_ROR;
+    if (s->rx_count)                        ris |= SIM_SSP_INT_RT;
+    if (s->rx_count >= SIM_SSP_FIFO / 2)    ris |= SIM_SSP_INT_RX;
+    return ris;
+}
+
+static void sim_ssp_lines(SIM_SSP_Type* s)
+{
+    uint32_t dmacr = SIM_SSP(s, DMACR);
+
+    sim_irq_line(s->irq, sim_ssp_ris(s) & SIM_SSP(s, IMSC));
+    SIM_DMARequest(s->conn_tx, (dmacr & SIM_SSP_DMA_TX) != 0);
+    SIM_DMARequest(s->conn_tx + 1, (dmacr & SIM_SSP_DMA_RX) && s->rx_count);
+}
+
+static void sim_ssp_read(SIM_Model_Type* model, uint32_t offset)
+{
+    SIM_SSP_Type* s = (SIM_SSP_Type*)model;
+    uint32_t sr = SIM_SSP_SR_TFE | SIM_SSP_SR_TNF;
+
+    switch (offset)
+    {
+        case SIM_OFS(LPC_SSP_TypeDef, DR):
+            SIM_SSP(s, DR) = s->rx_count ? s->rx[s->rx_head] : 0;
+            break;
+        case SIM_OFS(LPC_SSP_TypeDef, SR):
+            if (s->rx_count)                   sr |= SIM_SSP_SR_RNE;
+            if (s->rx_count == SIM_SSP_FIFO)   sr |= SIM_SSP_SR_RFF;
+            SIM_SSP(s, SR) = sr;
+            break;
+        case SIM_OFS(LPC_SSP_TypeDef, RIS):
+            SIM_SSP(s, RIS) = sim_ssp_ris(s);
+            break;
+        case SIM_OFS(LPC_SSP_TypeDef, MIS):
+            SIM_SSP(s, MIS) = sim_ssp_ris(s) & SIM_SSP(s, IMSC);
+            break;
+        default:
+            break;
+    }
+}
+
+static void sim_ssp_read_done(SIM_Model_Type* model, uint32_t offset)
+{
+    SIM_SSP_Type* s = (SIM_SSP_Type*)model;
+
+    if ((offset == SIM_OFS(LPC_SSP_TypeDef, DR)) && s->rx_count)
+    {
+        s->rx_head = (s->rx_head + 1) % SIM_SSP_FIFO;
+        s->rx_count--;
+        sim_ssp_lines(s);
+    }
+}
+
+static void sim_ssp_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    SIM_SSP_Type* s = (SIM_SSP_Type*)model;
+    volatile uint32_t* reg = SIM_Reg(model->base + offset);
+    uint32_t bits, mosi, miso;
+
+    switch (offset)
+    {
+        case SIM_OFS(LPC_SSP_TypeDef, DR):
+            if (!(SIM_SSP(s, CR1) & SIM_SSP_CR1_SSE))
+            {
+                break;
+            }
+            /* The frame is exchanged at once: the slave answers every frame */
+            bits = (SIM_SSP(s, CR0) & 0xF) + 1;
+            mosi = *reg & ((1UL << bits) - 1);
+            if ((SIM_SSP(s, CR1) & SIM_SSP_CR1_LBM) || (s->device == NULL))
+            {
+                miso = mosi;
+            }
+            else
+            {
+                miso = s->device(s->num, (uint16_t)mosi) & ((1UL << bits) - 1);
+            }
+            if (s->rx_count == SIM_SSP_FIFO)
+            {
+                s->ror = 1;
+            }
+            else
+            {
+                s->rx[(s->rx_head + s->rx_count++) % SIM_SSP_FIFO] = (uint16_t)miso;
+            }
+            break;
+        case SIM_OFS(LPC_SSP_TypeDef, ICR):
+            if (*reg & SIM_SSP_INT_ROR)
+            {
+                s->ror = 0;
+            }
+            *reg = 0;
+            break;
+        case SIM_OFS(LPC_SSP_TypeDef, SR):
+        case SIM_OFS(LPC_SSP_TypeDef, RIS):
+        case SIM_OFS(LPC_SSP_TypeDef, MIS):
+            *reg = prev;                                          /* read-only */
+            break;
+        default:
+            break;
+    }
+    sim_ssp_lines(s);
+}
+
+static void sim_ssp_update(SIM_Model_Type* model)
+{
+    sim_ssp_lines((SIM_SSP_Type*)model);
+}
+
+static void sim_ssp_reset(SIM_Model_Type* model)
+{
+    SIM_SSP_Type* s = (SIM_SSP_Type*)model;
+
+    s->ror = 0;
+    s->rx_head = s->rx_count = 0;
+    SIM_SSP(s, SR) = SIM_SSP_SR_TFE | SIM_SSP_SR_TNF;
+}
+
+/**
+ * Attach a slave device to an SSP bus
+ *
+ * @param  ssp     SSP number 0..1
+ * @param  device  called with every frame sent, returns the frame received;
+ *                 NULL (default) loops MOSI back to MISO
+ */
+void SIM_SSP_SetDevice(uint8_t ssp, uint16_t (*device)(uint8_t ssp, uint16_t mosi))
+{
+    if (ssp < 2)
+    {
+        sim_ssp[ssp].device = device;
+    }
+}
+
+
+/*----------------------------------------------------------------------------
+  I2C0..2, master mode. The slaves are a script: every bus event consumes the
+  next I2STAT code queued by SIM_I2C_Inject(), the data bytes of the receive
+  states come from the same injection. An empty script leaves the bus hung,
+  SI never comes back.
+ *----------------------------------------------------------------------------*/
+#define SIM_I2C_SCRIPT          256
+
+#define SIM_I2C_CON_AA          (1UL << 2)
+#define SIM_I2C_CON_SI          (1UL << 3)
+#define SIM_I2C_CON_STO         (1UL << 4)
+#define SIM_I2C_CON_STA         (1UL << 5)
+#define SIM_I2C_CON_I2EN        (1UL << 6)
+#define SIM_I2C_STAT_IDLE       0xF8
+
+typedef struct
+{
+    SIM_Model_Type model;
+    IRQn_Type irq;
+    uint8_t stat[SIM_I2C_SCRIPT], data[SIM_I2C_SCRIPT];
+    uint32_t script_head, script_count;
+    uint8_t capture[SIM_I2C_SCRIPT];
+    uint32_t capture_head, capture_count;
+    uint32_t stops;
+} SIM_I2C_Type;
+
+static SIM_I2C_Type sim_i2c[3] =
+{
+    { { LPC_I2C0_BASE, "I2C0" }, I2C0_IRQn },
+    { { LPC_I2C1_BASE, "I2C1" }, I2C1_IRQn },
+    { { LPC_I2C2_BASE, "I2C2" }, I2C2_IRQn },
+};
+
+#define SIM_I2C(u, reg)         SIM_REG((u)->model.base, LPC_I2C_TypeDef, reg)
+
+/* States after which the master still holds the bus and clocks on */
+static uint8_t sim_i2c_active(uint8_t stat)
+{
+    return (stat >= 0x08) && (stat <= 0x50) && (stat != 0x38);
+}
+
+/* States in which the master loads I2DAT with a byte to send */
+static uint8_t sim_i2c_sends(uint8_t stat)
+{
+    return (stat == 0x08) || (stat == 0x10) || (stat == 0x18) || (stat == 0x28);
+}
+
+static void sim_i2c_lines(SIM_I2C_Type* s)
+{
+    sim_irq_line(s->irq, SIM_I2C(s, I2CONSET) & SIM_I2C_CON_SI);
+}
+
+/* Move to the next scripted state */
+static void sim_i2c_next(SIM_I2C_Type* s)
+{
+    uint8_t stat = SIM_I2C_STAT_IDLE;
+
+    if (s->script_count)
+    {
+        stat = s->stat[s->script_head];
+        if ((stat == 0x50) || (stat == 0x58))
+        {
+            SIM_I2C(s, I2DAT) = s->data[s->script_head];
+        }
+        s->script_head = (s->script_head + 1) % SIM_I2C_SCRIPT;
+        s->script_count--;
+    }
+    SIM_I2C(s, I2STAT) = stat;
+    if (stat != SIM_I2C_STAT_IDLE)
+    {
+        SIM_I2C(s, I2CONSET) |= SIM_I2C_CON_SI;
+    }
+}
+
+/* The flags act once SI is clear: STO releases the bus, STA (re)starts it,
+ * otherwise clearing SI lets the transfer go on by one byte */
+static void sim_i2c_step(SIM_I2C_Type* s, uint32_t before)
+{
+    uint32_t con = SIM_I2C(s, I2CONSET);
+    uint8_t stat = (uint8_t)SIM_I2C(s, I2STAT);
+
+    if (!(con & SIM_I2C_CON_I2EN) || (con & SIM_I2C_CON_SI))
+    {
+        return;
+    }
+    if (con & SIM_I2C_CON_STO)
+    {
+        s->stops++;
+        SIM_I2C(s, I2CONSET) = con & ~SIM_I2C_CON_STO;
+        SIM_I2C(s, I2STAT) = SIM_I2C_STAT_IDLE;
+        if (con & SIM_I2C_CON_STA)
+        {
+            sim_i2c_next(s);
+        }
+    }
+    else if (before & SIM_I2C_CON_SI)
+    {
+        if (!(con & SIM_I2C_CON_STA) && sim_i2c_sends(stat) && (s->capture_count < SIM_I2C_SCRIPT))
+        {
+            s->capture[(s->capture_head + s->capture_count++) % SIM_I2C_SCRIPT] = (uint8_t)SIM_I2C(s, I2DAT);
+        }
+        if ((con & SIM_I2C_CON_STA) || sim_i2c_active(stat))
+        {
+            sim_i2c_next(s);
+        }
+        else
+        {
+            SIM_I2C(s, I2STAT) = SIM_I2C_STAT_IDLE;       /* not addressed slave */
+        }
+    }
+    else if ((con & SIM_I2C_CON_STA) && !(before & SIM_I2C_CON_STA) && (stat == SIM_I2C_STAT_IDLE))
+    {
+        sim_i2c_next(s);
+    }
+}
+
+static void sim_i2c_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    SIM_I2C_Type* s = (SIM_I2C_Type*)model;
+    volatile uint32_t* reg = SIM_Reg(model->base + offset);
+    uint32_t before = SIM_I2C(s, I2CONSET);
+
+    switch (offset)
+    {
+        case SIM_OFS(LPC_I2C_TypeDef, I2CONSET):
+            before = prev;
+            *reg = (prev | (*reg & ~SIM_I2C_CON_SI)) & 0x7C;      /* SI is set by the bus only */
+            sim_i2c_step(s, before);
+            break;
+        case SIM_OFS(LPC_I2C_TypeDef, I2CONCLR):
+            SIM_I2C(s, I2CONSET) = before & ~*reg;
+            *reg = 0;                                             /* write-only */
+            sim_i2c_step(s, before);
+            break;
+        case SIM_OFS(LPC_I2C_TypeDef, I2STAT):
+            *reg = prev;                                          /* read-only */
+            break;
+        default:
+            break;
+    }
+    sim_i2c_lines(s);
+}
+
+static void sim_i2c_update(SIM_Model_Type* model)
+{
+    sim_i2c_lines((SIM_I2C_Type*)model);
+}
+
+static void sim_i2c_reset(SIM_Model_Type* model)
+{
+    SIM_I2C_Type* s = (SIM_I2C_Type*)model;
+
+    s->script_head = s->script_count = 0;
+    s->capture_head = s->capture_count = 0;
+    s->stops = 0;
+    SIM_I2C(s, I2STAT) = SIM_I2C_STAT_IDLE;
+}
+
+/**
+ * Queue the bus states the slaves will produce, in the order the master
+ * meets them. Each bus event of the master (START, a byte sent or acknowledged,
+ * repeated START) takes the next one; a STOP alone takes none.
+ *
+ * @param  i2c   I2C number 0..2
+ * @param  stat  I2STAT codes, 0x08 START, 0x18 SLA+W ACK, 0x50 data received...
+ * @param  data  byte loaded in I2DAT with each 0x50 / 0x58 code, NULL for none
+ * @param  len   number of codes, the excess over the script size is dropped
+ */
+void SIM_I2C_Inject(uint8_t i2c, const uint8_t* stat, const uint8_t* data, uint32_t len)
+{
+    SIM_I2C_Type* s;
+    uint32_t i, n;
+
+    if (i2c > 2)
+    {
+        return;
+    }
+    s = &sim_i2c[i2c];
+    for (i = 0; (i < len) && (s->script_count < SIM_I2C_SCRIPT); i++)
+    {
+        n = (s->script_head + s->script_count++) % SIM_I2C_SCRIPT;
+        s->stat[n] = stat[i];
+        s->data[n] = (data != NULL) ? data[i] : 0xFF;
+    }
+}
+
+/**
+ * Fetch the bytes the master has sent so far, slave addresses included
+ *
+ * @param  i2c   I2C number 0..2
+ * @param  data  destination buffer
+ * @param  max   size of data
+ * @return number of bytes copied
+ */
+uint32_t SIM_I2C_Drain(uint8_t i2c, uint8_t* data, uint32_t max)
+{
+    SIM_I2C_Type* s;
+    uint32_t n = 0;
+
+    if (i2c > 2)
+    {
+        return 0;
+    }
+    s = &sim_i2c[i2c];
+    while ((n < max) && s->capture_count)
+    {
+        data[n++] = s->capture[s->capture_head];
+        s->capture_head = (s->capture_head + 1) % SIM_I2C_SCRIPT;
+        s->capture_count--;
+    }
+    return n;
+}
+
+/**
+ * Get the number of STOP conditions sent
+ *
+ * @param  i2c  I2C number 0..2
+ * @return STOP conditions since the reset
+ */
+uint32_t SIM_I2C_GetStops(uint8_t i2c)
+{
+    if (i2c > 2)
+    {
+        return 0;
+    }
+    return sim_i2c[i2c].stops;
+}
+
+
+/*----------------------------------------------------------------------------
+  CAN1/2. Received frames come from a host backlog, transmitted frames go to
+  a host capture. Unpaced, frames move as soon as the buffers allow; paced,
+  each takes its bit time at the programmed BTR, stuff bits left out, so a
+  backlog arrives at the full bus load. Both directions get the whole bus,
+  received frames do not arbitrate against transmitted ones. The acceptance
+  filter is not modelled, every frame is received.
+ *----------------------------------------------------------------------------*/
+#define SIM_CAN_MOD_RM          (1UL << 0)
+#define SIM_CAN_MOD_TPM         (1UL << 3)
+#define SIM_CAN_CMR_TR          (1UL << 0)
+#define SIM_CAN_CMR_AT          (1UL << 1)
+#define SIM_CAN_CMR_RRB         (1UL << 2)
+#define SIM_CAN_CMR_CDO         (1UL << 3)
+#define SIM_CAN_CMR_SRR         (1UL << 4)
+#define SIM_CAN_CMR_STB(n)      (1UL << (5 + (n)))
+#define SIM_CAN_ICR_RI          (1UL << 0)
+#define SIM_CAN_ICR_DOI         (1UL << 3)
+#define SIM_CAN_ICR_TI(n)       ((n) ? (1UL << (8 + (n))) : (1UL << 1))
+#define SIM_CAN_TFI_FF          (1UL << 31)
+#define SIM_CAN_TFI_RTR         (1UL << 30)
+
+typedef struct
+{
+    SIM_Model_Type model;
+    uint8_t pclk;
+    uint8_t paced;
+    uint8_t rbs, dos;
+    uint8_t tbs[3], tcs[3];
+    int8_t tx_active;                               /* buffer on the bus, -1 idle */
+    uint32_t icr;
+    uint64_t rx_time, tx_time;
+    SIM_CAN_Frame_Type backlog[SIM_CAN_BUF_SIZE];
+    uint32_t backlog_head, backlog_count;
+    SIM_CAN_Frame_Type capture[SIM_CAN_BUF_SIZE];
+    uint32_t capture_head, capture_count;
+} SIM_CAN_Type;
+
+static SIM_CAN_Type sim_can[2] =
+{
+    { { LPC_CAN1_BASE, "CAN1" }, SIM_PCLK_CAN1 },
+    { { LPC_CAN2_BASE, "CAN2" }, SIM_PCLK_CAN2 },
+};
+
+#define SIM_CAN(c, reg)         SIM_REG((c)->model.base, LPC_CAN_TypeDef, reg)
+
+/* Transmit buffer n registers, TFI at +0, TID +4, TDA +8, TDB +12 */
+static volatile uint32_t* sim_can_txbuf(SIM_CAN_Type* c, uint8_t n)
+{
+    return SIM_Reg(c->model.base + SIM_OFS(LPC_CAN_TypeDef, TFI1) + 16 * n);
+}
+
+/* Core clock cycles of one bit, then of a whole frame and its interframe space */
+static uint64_t sim_can_frame_time(SIM_CAN_Type* c, uint8_t ext, uint8_t rtr, uint8_t len)
+{
+    uint32_t btr = SIM_CAN(c, BTR);
+    uint32_t tq = ((btr >> 16) & 0xF) + ((btr >> 20) & 0x7) + 3;
+    uint32_t bits = (ext ? 67 : 47) + (rtr ? 0 : 8 * ((len > 8) ? 8 : len));
+
+    return (uint64_t)sim_pclk_div(c->pclk) * ((btr & 0x3FF) + 1) * tq * bits;
+}
+
+static void sim_can_lines(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < 2; i++)
+    {
+        if (sim_can[i].icr & SIM_CAN(&sim_can[i], IER))
+        {
+            sim_irq_line(CAN_IRQn, 1);
+        }
+    }
+}
+
+/* Recompute the status bits the driver reads */
+static void sim_can_status(SIM_CAN_Type* c)
+{
+    uint32_t sr = 0, gsr;
+    uint8_t n;
+
+    if (c->rbs)
+    {
+        sr |= 0x00010101UL;
+    }
+    if (c->dos)
+    {
+        sr |= 0x00020202UL;
+    }
+    for (n = 0; n < 3; n++)
+    {
+        if (c->tbs[n])                sr |= 1UL << (2 + 8 * n);
+        if (c->tcs[n])                sr |= 1UL << (3 + 8 * n);
+        if (c->tx_active == (int8_t)n) sr |= 1UL << (5 + 8 * n);
+    }
+    SIM_CAN(c, SR) = sr;
+    gsr = (sr & 0x3) | ((c->tbs[0] && c->tbs[1] && c->tbs[2]) ? 0x04 : 0) |
+          ((c->tcs[0] && c->tcs[1] && c->tcs[2]) ? 0x08 : 0) | ((c->tx_active >= 0) ? 0x20 : 0);
+    SIM_CAN(c, GSR) = (SIM_CAN(c, GSR) & 0xFFFF0000UL) | gsr;
+    if (c->rbs && (SIM_CAN(c, IER) & SIM_CAN_ICR_RI))
+    {
+        c->icr |= SIM_CAN_ICR_RI;
+    }
+    else
+    {
+        c->icr &= ~SIM_CAN_ICR_RI;
+    }
+    SIM_CAN(c, ICR) = c->icr;
+}
+
+/* Arbitration value of a transmit buffer: the lowest goes first. In ID mode a
+ * standard frame beats an extended one with the same base identifier */
+static uint32_t sim_can_priority(SIM_CAN_Type* c, uint8_t n)
+{
+    volatile uint32_t* buf = sim_can_txbuf(c, n);
+
+    if (SIM_CAN(c, MOD) & SIM_CAN_MOD_TPM)
+    {
+        return buf[0] & 0xFF;
+    }
+    if (buf[0] & SIM_CAN_TFI_FF)
+    {
+        return ((buf[1] & 0x1FFFFFFFUL) >> 18 << 19) | (1UL << 18) | (buf[1] & 0x3FFFF);
+    }
+    return (buf[1] & 0x7FF) << 19;
+}
+
+/* Put the highest priority requested buffer on the bus, lowest number on a tie */
+static void sim_can_arbitrate(SIM_CAN_Type* c)
+{
+    uint32_t best = 0, prio;
+    int8_t n, pick = -1;
+
+    if ((c->tx_active >= 0) || (SIM_CAN(c, MOD) & SIM_CAN_MOD_RM))
+    {
+        return;
+    }
+    for (n = 0; n < 3; n++)
+    {
+        if (!c->tbs[n])
+        {
+            prio = sim_can_priority(c, (uint8_t)n);
+            if ((pick < 0) || (prio < best))
+            {
+                best = prio;
+                pick = n;
+            }
+        }
+    }
+    c->tx_active = pick;
+    c->tx_time = 0;
+}
+
+/* Frame of the buffer on the bus is through: capture it, release the buffer */
+static void sim_can_sent(SIM_CAN_Type* c)
+{
+    volatile uint32_t* buf = sim_can_txbuf(c, (uint8_t)c->tx_active);
+    SIM_CAN_Frame_Type* f;
+    uint8_t n = (uint8_t)c->tx_active;
+    uint8_t i;
+
+    f = &c->capture[(c->capture_head + c->capture_count) % SIM_CAN_BUF_SIZE];
+    f->ext = (buf[0] & SIM_CAN_TFI_FF) != 0;
+    f->rtr = (buf[0] & SIM_CAN_TFI_RTR) != 0;
+    f->len = (buf[0] >> 16) & 0xF;
+    f->id = buf[1] & (f->ext ? 0x1FFFFFFFUL : 0x7FFUL);
+    for (i = 0; i < 4; i++)
+    {
+        f->data[i] = (uint8_t)(buf[2] >> (8 * i));
+        f->data[4 + i] = (uint8_t)(buf[3] >> (8 * i));
+    }
+    if (c->capture_count < SIM_CAN_BUF_SIZE)
+    {
+        c->capture_count++;
+    }
+    else
+    {
+        c->capture_head = (c->capture_head + 1) % SIM_CAN_BUF_SIZE;   /* drop the oldest */
+    }
+
+    c->tbs[n] = 1;
+    c->tcs[n] = 1;
+    c->tx_active = -1;
+    if (SIM_CAN(c, IER) & SIM_CAN_ICR_TI(n))
+    {
+        c->icr |= SIM_CAN_ICR_TI(n);
+    }
+}
+
+/* Frame at the head of the backlog is through: into the receive buffer, or
+ * lost to an overrun if the driver has not released the previous one */
+static void sim_can_received(SIM_CAN_Type* c)
+{
+    SIM_CAN_Frame_Type* f = &c->backlog[c->backlog_head];
+
+    c->backlog_head = (c->backlog_head + 1) % SIM_CAN_BUF_SIZE;
+    c->backlog_count--;
+    if (c->rbs)
+    {
+        c->dos = 1;
+        if (SIM_CAN(c, IER) & SIM_CAN_ICR_DOI)
+        {
+            c->icr |= SIM_CAN_ICR_DOI;
+        }
+        return;
+    }
+    c->rbs = 1;
+    SIM_CAN(c, RFS) = ((uint32_t)f->ext << 31) | ((uint32_t)f->rtr << 30) | ((uint32_t)(f->len & 0xF) << 16);
+    SIM_CAN(c, RID) = f->id;
+    SIM_CAN(c, RDA) = f->data[0] | ((uint32_t)f->data[1] << 8) | ((uint32_t)f->data[2] << 16) |
+                      ((uint32_t)f->data[3] << 24);
+    SIM_CAN(c, RDB) = f->data[4] | ((uint32_t)f->data[5] << 8) | ((uint32_t)f->data[6] << 16) |
+                      ((uint32_t)f->data[7] << 24);
+}
+
+/* Unpaced mode: frames arrive and leave as fast as the buffers allow */
+static void sim_can_flow(SIM_CAN_Type* c)
+{
+    if (c->paced)
+    {
+        return;
+    }
+    while (c->backlog_count && !c->rbs)
+    {
+        sim_can_received(c);
+    }
+    for (sim_can_arbitrate(c); c->tx_active >= 0; sim_can_arbitrate(c))
+    {
+        sim_can_sent(c);
+    }
+}
+
+static void sim_can_read_done(SIM_Model_Type* model, uint32_t offset)
+{
+    SIM_CAN_Type* c = (SIM_CAN_Type*)model;
+
+    if (offset == SIM_OFS(LPC_CAN_TypeDef, ICR))
+    {
+        c->icr &= SIM_CAN_ICR_RI;                             /* read-to-clear, RI follows RBS */
+        sim_can_status(c);
+    }
+}
+
+static void sim_can_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    SIM_CAN_Type* c = (SIM_CAN_Type*)model;
+    volatile uint32_t* reg = SIM_Reg(model->base + offset);
+    uint32_t cmr;
+    uint8_t n;
+
+    switch (offset)
+    {
+        case SIM_OFS(LPC_CAN_TypeDef, CMR):
+            cmr = *reg;
+            *reg = 0;                                             /* write-only */
+            if (cmr & SIM_CAN_CMR_RRB)
+            {
+                c->rbs = 0;
+            }
+            if (cmr & SIM_CAN_CMR_CDO)
+            {
+                c->dos = 0;
+            }
+            if (!(cmr & (SIM_CAN_CMR_STB(0) | SIM_CAN_CMR_STB(1) | SIM_CAN_CMR_STB(2))))
+            {
+                cmr |= SIM_CAN_CMR_STB(0);
+            }
+            for (n = 0; n < 3; n++)
+            {
+                if (!(cmr & SIM_CAN_CMR_STB(n)))
+                {
+                    continue;
+                }
+                if (cmr & (SIM_CAN_CMR_TR | SIM_CAN_CMR_SRR))
+                {
+                    c->tbs[n] = 0;
+                    c->tcs[n] = 0;
+                }
+                else if ((cmr & SIM_CAN_CMR_AT) && !c->tbs[n] && (c->tx_active != (int8_t)n))
+                {
+                    c->tbs[n] = 1;                                  /* aborted before it started */
+                    if (SIM_CAN(c, IER) & SIM_CAN_ICR_TI(n))
+                    {
+                        c->icr |= SIM_CAN_ICR_TI(n);
+                    }
+                }
+            }
+            if (c->paced)
+            {
+                sim_can_arbitrate(c);
+            }
+            break;
+        case SIM_OFS(LPC_CAN_TypeDef, ICR):
+        case SIM_OFS(LPC_CAN_TypeDef, SR):
+            *reg = prev;                                          /* read-only */
+            break;
+        default:
+            break;
+    }
+    sim_can_flow(c);
+    sim_can_status(c);
+    sim_can_lines();
+}
+
+static void sim_can_advance(SIM_Model_Type* model, uint32_t cycles)
+{
+    SIM_CAN_Type* c = (SIM_CAN_Type*)model;
+    SIM_CAN_Frame_Type* f;
+    volatile uint32_t* buf;
+    uint64_t t;
+    uint8_t changed = 0;
+
+    if (!c->paced)
+    {
+        return;
+    }
+    if (c->tx_active >= 0)
+    {
+        c->tx_time += cycles;
+        while (c->tx_active >= 0)
+        {
+            buf = sim_can_txbuf(c, (uint8_t)c->tx_active);
+            t = sim_can_frame_time(c, (buf[0] & SIM_CAN_TFI_FF) != 0, (buf[0] & SIM_CAN_TFI_RTR) != 0,
+                                   (buf[0] >> 16) & 0xF);
+            if (c->tx_time < t)
+            {
+                break;
+            }
+            sim_can_sent(c);
+            sim_can_arbitrate(c);
+            c->tx_time = (c->tx_active >= 0) ? c->tx_time - t : 0;
+            changed = 1;
+        }
+    }
+    if (c->backlog_count)
+    {
+        c->rx_time += cycles;
+        while (c->backlog_count)
+        {
+            f = &c->backlog[c->backlog_head];
+            t = sim_can_frame_time(c, f->ext, f->rtr, f->len);
+            if (c->rx_time < t)
+            {
+                break;
+            }
+            c->rx_time -= t;
+            sim_can_received(c);
+            changed = 1;
+        }
+        if (!c->backlog_count)
+        {
+            c->rx_time = 0;
+        }
+    }
+    if (changed)
+    {
+        sim_can_status(c);
+        sim_can_lines();
+    }
+}
+
+static void sim_can_update(SIM_Model_Type* model)
+{
+    (void)model;
+    sim_can_lines();
+}
+
+static void sim_can_reset(SIM_Model_Type* model)
+{
+    SIM_CAN_Type* c = (SIM_CAN_Type*)model;
+    uint8_t n;
+
+    c->rbs = c->dos = 0;
+    for (n = 0; n < 3; n++)
+    {
+        c->tbs[n] = 1;
+        c->tcs[n] = 1;
+    }
+    c->tx_active = -1;
+    c->icr = 0;
+    c->rx_time = c->tx_time = 0;
+    c->backlog_head = c->backlog_count = 0;
+    c->capture_head = c->capture_count = 0;
+    SIM_CAN(c, MOD) = SIM_CAN_MOD_RM;
+    SIM_CAN(c, BTR) = 0x001C0000UL;
+    sim_can_status(c);
+}
+
+/**
+ * Queue frames for the CAN receiver, paced or not like the UART
+ *
+ * @param  can     CAN number 1..2
+ * @param  frames  frames, in bus order
+ * @param  count   number of frames, the excess over the backlog is dropped
+ */
+void SIM_CAN_Inject(uint8_t can, const SIM_CAN_Frame_Type* frames, uint32_t count)
+{
+    SIM_CAN_Type* c;
+
+    if ((can < 1) || (can > 2))
+    {
+        return;
+    }
+    c = &sim_can[can - 1];
+    while (count-- && (c->backlog_count < SIM_CAN_BUF_SIZE))
+    {
+        c->backlog[(c->backlog_head + c->backlog_count++) % SIM_CAN_BUF_SIZE] = *frames++;
+    }
+    sim_can_flow(c);
+    sim_can_status(c);
+    sim_can_lines();
+}
+
+/**
+ * Fetch the frames the CAN controller has transmitted so far
+ *
+ * @param  can     CAN number 1..2
+ * @param  frames  destination
+ * @param  max     size of frames
+ * @return number of frames copied
+ */
+uint32_t SIM_CAN_Drain(uint8_t can, SIM_CAN_Frame_Type* frames, uint32_t max)
+{
+    SIM_CAN_Type* c;
+    uint32_t n = 0;
+
+    if ((can < 1) || (can > 2))
+    {
+        return 0;
+    }
+    c = &sim_can[can - 1];
+    while ((n < max) && c->capture_count)
+    {
+        frames[n++] = c->capture[c->capture_head];
+        c->capture_head = (c->capture_head + 1) % SIM_CAN_BUF_SIZE;
+        c->capture_count--;
+    }
+    return n;
+}
+
+/**
+ * Select unpaced (default) or bit rate paced timing
+ *
+ * @param  can     CAN number 1..2
+ * @param  enable  1: paced
+ */
+void SIM_CAN_SetPaced(uint8_t can, uint8_t enable)
+{
+    SIM_CAN_Type* c;
+
+    if ((can < 1) || (can > 2))
+    {
+        return;
+    }
+    c = &sim_can[can - 1];
+    c->paced = enable;
+    c->rx_time = c->tx_time = 0;
+    sim_can_flow(c);
+    sim_can_status(c);
+    sim_can_lines();
+}
+
+
+/*----------------------------------------------------------------------------
+  EMAC with a DP83848C PHY at address 1. By default MII management
+  transactions take no time, the PHY reset and auto-negotiation complete at
+  once with a 100 Mbit full duplex link. With SIM_EMAC_SetPHYTiming() they
+  take their time: an MII transaction 64 MDC periods, the reset and the
+  auto-negotiation as given, the link staying down meanwhile. The link also
+  follows SIM_EMAC_SetLink(), the cable. Received frames come from a host backlog and are written
+  through the receive descriptor ring, FCS appended; transmitted frames are
+  gathered from the transmit descriptors into a host capture. Unpaced, frames
+  move as soon as the rings allow; paced, each takes its wire time with
+  preamble and interframe gap at the SUPP speed, so a backlog arrives at the
+  full line rate. The receive filter is not modelled, every frame is taken.
+  A frame finding no free receive descriptor is dropped and counted.
+  SIM_EMAC_Fault() raises a receive overrun or a transmit underrun: as on
+  the target the datapath stops until reset with the Command RX_RES or
+  TX_RES bit, frames arriving meanwhile are dropped and counted.
+ *----------------------------------------------------------------------------*/
+#define SIM_EMAC_PHY_ADR        1
+#define SIM_EMAC_PHY_REGS       32
+#define SIM_EMAC_WIRE_BYTES     24              /* preamble, SFD, FCS and interframe gap    */
+#define SIM_EMAC_MAC1_REC_EN    (1UL << 0)
+#define SIM_EMAC_SUPP_SPEED     (1UL << 8)
+#define SIM_EMAC_MCMD_READ      (1UL << 0)
+#define SIM_EMAC_MIND_BUSY      (1UL << 0)
+#define SIM_EMAC_CR_RX_EN       (1UL << 0)
+#define SIM_EMAC_CR_TX_EN       (1UL << 1)
+#define SIM_EMAC_CR_TX_RES      (1UL << 4)
+#define SIM_EMAC_CR_RX_RES      (1UL << 5)
+#define SIM_EMAC_INT_RX_OVERRUN (1UL << 0)
+#define SIM_EMAC_INT_RX_FIN     (1UL << 2)
+#define SIM_EMAC_INT_RX_DONE    (1UL << 3)
+#define SIM_EMAC_INT_TX_UNDERRUN (1UL << 4)
+#define SIM_EMAC_INT_TX_FIN     (1UL << 6)
+#define SIM_EMAC_INT_TX_DONE    (1UL << 7)
+#define SIM_EMAC_CTRL_SIZE      0x7FFUL
+#define SIM_EMAC_CTRL_LAST      (1UL << 30)
+#define SIM_EMAC_CTRL_INT       (1UL << 31)
+#define SIM_EMAC_RINFO_NO_DESCR (1UL << 29)
+#define SIM_EMAC_RINFO_LAST     (1UL << 30)
+#define SIM_EMAC_RINFO_ERR      (1UL << 31)
+#define SIM_EMAC_BMCR_RESET     (1U << 15)
+#define SIM_EMAC_BMCR_AN        (1U << 12)
+#define SIM_EMAC_BMCR_RE_AN     (1U << 9)
+#define SIM_EMAC_BMSR_LINK      (1U << 2)
+#define SIM_EMAC_BMSR_AN_DONE   (1U << 5)
+#define SIM_EMAC_STS_LINK       (1U << 0)
+#define SIM_EMAC_STS_AN_DONE    (1U << 4)
+#define SIM_EMAC_PHY_READY      0
+#define SIM_EMAC_PHY_RESET      1
+#define SIM_EMAC_PHY_ANEG       2
+
+typedef struct
+{
+    uint16_t len;
+    uint8_t data[SIM_EMAC_MAX_FLEN];
+} SIM_EMAC_Frame_Type;
+
+typedef struct
+{
+    SIM_Model_Type model;
+    uint8_t paced;
+    uint16_t phy[SIM_EMAC_PHY_REGS];
+    uint8_t phy_state;                                      /* SIM_EMAC_PHY_READY, _RESET or _ANEG */
+    uint8_t cable;                                          /* link partner connected               */
+    uint8_t mii_read;
+    uint16_t mii_adr, mii_value;
+    uint32_t reset_time, aneg_time;                         /* 0, 0: untimed PHY management         */
+    uint64_t mii_time, phy_time;                            /* cycles left of each, 0 when idle     */
+    uint64_t rx_time, tx_time;
+    uint32_t dropped;
+    uint8_t rx_fault, tx_fault;                             /* datapath stopped until reset         */
+    SIM_EMAC_Frame_Type backlog[SIM_EMAC_BUF_SIZE];
+    uint32_t backlog_head, backlog_count;
+    SIM_EMAC_Frame_Type capture[SIM_EMAC_BUF_SIZE];
+    uint32_t capture_head, capture_count;
+} SIM_EMAC_Type;
+
+static SIM_EMAC_Type sim_emac = { { LPC_EMAC_BASE, "EMAC" }, 0, { 0 }, SIM_EMAC_PHY_READY, 1 };
+
+#define SIM_EMAC(reg)           SIM_REG(LPC_EMAC_BASE, LPC_EMAC_TypeDef, reg)
+
+/* Descriptor and status words live in ordinary RAM, as on the target */
+static volatile uint32_t* sim_emac_mem(uint32_t addr)
+{
+    return (volatile uint32_t*)(uintptr_t)addr;
+}
+
+/* CRC-32 of the frame, appended least significant byte first as the FCS */
+static uint32_t sim_emac_fcs(const uint8_t* data, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+    uint8_t b;
+
+    while (len--)
+    {
+        crc ^= *data++;
+        for (b = 0; b < 8; b++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+/* Core clock cycles of a frame of len bytes (FCS excluded) on the wire */
+static uint64_t sim_emac_frame_time(uint32_t len)
+{
+    uint32_t per_bit = (SIM_EMAC(SUPP) & SIM_EMAC_SUPP_SPEED) ? SIM_CORE_CLOCK / 100000000UL
+                                                              : SIM_CORE_CLOCK / 10000000UL;
+
+    if (len < 60)
+    {
+        len = 60;                                             /* padded to the minimum frame */
+    }
+    return (uint64_t)(len + SIM_EMAC_WIRE_BYTES) * 8 * per_bit;
+}
+
+static void sim_emac_lines(void)
+{
+    if (SIM_EMAC(IntStatus) & SIM_EMAC(IntEnable))
+    {
+        sim_irq_line(ENET_IRQn, 1);
+    }
+}
+
+/* The link is up once the PHY is through its reset and auto-negotiation,
+ * with the cable in */
+static void sim_emac_phy_link(SIM_EMAC_Type* e)
+{
+    e->phy[0x01] &= ~(SIM_EMAC_BMSR_LINK | SIM_EMAC_BMSR_AN_DONE);
+    e->phy[0x10] &= ~(SIM_EMAC_STS_LINK | SIM_EMAC_STS_AN_DONE);
+    if (e->cable && (e->phy_state == SIM_EMAC_PHY_READY))
+    {
+        e->phy[0x01] |= SIM_EMAC_BMSR_LINK;
+        e->phy[0x10] |= SIM_EMAC_STS_LINK;
+        if (e->phy[0x00] & SIM_EMAC_BMCR_AN)
+        {
+            e->phy[0x01] |= SIM_EMAC_BMSR_AN_DONE;
+            e->phy[0x10] |= SIM_EMAC_STS_AN_DONE;
+        }
+    }
+}
+
+/* (Re)start auto-negotiation; its time only runs with the cable in */
+static void sim_emac_phy_aneg(SIM_EMAC_Type* e)
+{
+    e->phy_state = (e->aneg_time != 0) ? SIM_EMAC_PHY_ANEG : SIM_EMAC_PHY_READY;
+    e->phy_time = e->aneg_time;
+    sim_emac_phy_link(e);
+}
+
+static void sim_emac_phy_reset(SIM_EMAC_Type* e)
+{
+    memset(e->phy, 0, sizeof(e->phy));
+    e->phy[0x00] = SIM_EMAC_BMCR_AN | 0x2100;               /* BMCR: auto-negotiation, 100 full */
+    e->phy[0x01] = 0x7809;                                  /* BMSR: abilities                  */
+    e->phy[0x02] = 0x2000;                                  /* PHYIDR1, DP83848C                */
+    e->phy[0x03] = 0x5C90;                                  /* PHYIDR2                          */
+    e->phy[0x04] = 0x01E1;                                  /* ANAR                             */
+    e->phy[0x05] = 0x45E1;                                  /* ANLPAR                           */
+    e->phy[0x10] = 1U << 2;                                 /* PHYSTS: full duplex              */
+    sim_emac_phy_aneg(e);
+}
+
+static void sim_emac_phy_write(SIM_EMAC_Type* e, uint8_t reg, uint16_t value)
+{
+    uint16_t prev = e->phy[0x00];
+
+    if (reg == 0x00)
+    {
+        if (value & SIM_EMAC_BMCR_RESET)
+        {
+            if (e->reset_time == 0)
+            {
+                sim_emac_phy_reset(e);                            /* self clearing, done at once */
+                return;
+            }
+            e->phy[0x00] |= SIM_EMAC_BMCR_RESET;
+            e->phy_state = SIM_EMAC_PHY_RESET;
+            e->phy_time = e->reset_time;
+            sim_emac_phy_link(e);
+            return;
+        }
+        e->phy[0x00] = value & ~SIM_EMAC_BMCR_RE_AN;
+        e->phy[0x10] &= ~((1U << 2) | (1U << 1));
+        if ((value & SIM_EMAC_BMCR_AN) ? !(e->phy[0x04] & 0x0180) : !(value & (1U << 13)))
+        {
+            e->phy[0x10] |= 1U << 1;                            /* PHYSTS speed bit: 10 Mbit */
+        }
+        if ((value & SIM_EMAC_BMCR_AN) ? (e->phy[0x04] & 0x0140) != 0 : (value & (1U << 8)) != 0)
+        {
+            e->phy[0x10] |= 1U << 2;
+        }
+        if (!(value & SIM_EMAC_BMCR_AN))
+        {
+            e->phy_state = SIM_EMAC_PHY_READY;                  /* forced mode links at once */
+            e->phy_time = 0;
+            sim_emac_phy_link(e);
+        }
+        else if (!(prev & SIM_EMAC_BMCR_AN) || (value & SIM_EMAC_BMCR_RE_AN))
+        {
+            sim_emac_phy_aneg(e);
+        }
+        else
+        {
+            sim_emac_phy_link(e);
+        }
+        return;
+    }
+    if ((reg != 0x01) && (reg != 0x02) && (reg != 0x03) && (reg != 0x10))
+    {
+        e->phy[reg] = value;
+    }
+}
+
+/* End of an MII management transaction: read data valid, write applied */
+static void sim_emac_mii_done(SIM_EMAC_Type* e)
+{
+    uint8_t phy = (e->mii_adr >> 8) & 0x1F, reg = e->mii_adr & 0x1F;
+
+    SIM_EMAC(MIND) &= ~SIM_EMAC_MIND_BUSY;
+    if (e->mii_read)
+    {
+        SIM_EMAC(MRDD) = (phy == SIM_EMAC_PHY_ADR) ? e->phy[reg] : 0xFFFF;
+    }
+    else if (phy == SIM_EMAC_PHY_ADR)
+    {
+        sim_emac_phy_write(e, reg, e->mii_value);
+    }
+}
+
+/* A transaction shifts 64 bits at the MDC rate, host clock over MCFG CLK_SEL */
+static void sim_emac_mii_start(SIM_EMAC_Type* e, uint8_t read, uint16_t value)
+{
+    static const uint8_t clkdiv[16] = { 4, 4, 6, 8, 10, 14, 20, 28, 36, 40, 44, 48, 52, 56, 60, 64 };
+
+    e->mii_read = read;
+    e->mii_adr = (uint16_t)SIM_EMAC(MADR);
+    e->mii_value = value;
+    if ((e->reset_time == 0) && (e->aneg_time == 0))
+    {
+        sim_emac_mii_done(e);
+        return;
+    }
+    e->mii_time = 64UL * clkdiv[(SIM_EMAC(MCFG) >> 2) & 0xF];
+    SIM_EMAC(MIND) |= SIM_EMAC_MIND_BUSY;
+}
+
+static void sim_emac_phy_advance(SIM_EMAC_Type* e, uint32_t cycles)
+{
+    if (e->mii_time != 0)
+    {
+        if (cycles < e->mii_time)
+        {
+            e->mii_time -= cycles;
+        }
+        else
+        {
+            e->mii_time = 0;
+            sim_emac_mii_done(e);
+        }
+    }
+    if ((e->phy_time != 0) && ((e->phy_state == SIM_EMAC_PHY_RESET) || e->cable))
+    {
+        if (cycles < e->phy_time)
+        {
+            e->phy_time -= cycles;
+        }
+        else if (e->phy_state == SIM_EMAC_PHY_RESET)
+        {
+            sim_emac_phy_reset(e);                              /* then auto-negotiation */
+        }
+        else
+        {
+            e->phy_time = 0;
+            e->phy_state = SIM_EMAC_PHY_READY;
+            sim_emac_phy_link(e);
+        }
+    }
+}
+
+static uint32_t sim_emac_rx_free(void)
+{
+    uint32_t n = SIM_EMAC(RxDescriptorNumber) + 1;
+
+    return (SIM_EMAC(RxConsumeIndex) + n - SIM_EMAC(RxProduceIndex) - 1) % n;
+}
+
+/* Frame at the head of the backlog is through: into the receive ring, or
+ * dropped if the driver has not released enough descriptors */
+static void sim_emac_received(SIM_EMAC_Type* e)
+{
+    SIM_EMAC_Frame_Type* f = &e->backlog[e->backlog_head];
+    uint32_t n = SIM_EMAC(RxDescriptorNumber) + 1;
+    uint32_t idx = SIM_EMAC(RxProduceIndex);
+    uint32_t len = f->len, done = 0, chunk, fcs, info = 0;
+    volatile uint32_t* desc, *stat;
+
+    e->backlog_head = (e->backlog_head + 1) % SIM_EMAC_BUF_SIZE;
+    e->backlog_count--;
+    fcs = sim_emac_fcs(f->data, len);
+    memcpy(&f->data[len], &fcs, 4);
+    len += 4;
+    if (e->rx_fault)
+    {
+        e->dropped++;
+        return;
+    }
+    if (sim_emac_rx_free() == 0)
+    {
+        e->dropped++;
+        SIM_EMAC(IntStatus) |= SIM_EMAC_INT_RX_FIN;
+        return;
+    }
+    while (done < len)
+    {
+        desc = sim_emac_mem(SIM_EMAC(RxDescriptor) + 8 * idx);
+        stat = sim_emac_mem(SIM_EMAC(RxStatus) + 8 * idx);
+        chunk = (desc[1] & SIM_EMAC_CTRL_SIZE) + 1;
+        if (chunk > len - done)
+        {
+            chunk = len - done;
+        }
+        memcpy((void*)(uintptr_t)desc[0], &f->data[done], chunk);
+        done += chunk;
+        info = chunk - 1;
+        if (done == len)
+        {
+            info |= SIM_EMAC_RINFO_LAST;
+        }
+        else if (sim_emac_rx_free() == 1)
+        {
+            info |= SIM_EMAC_RINFO_LAST | SIM_EMAC_RINFO_NO_DESCR | SIM_EMAC_RINFO_ERR;
+            done = len;                                         /* rest of the frame lost */
+        }
+        stat[0] = info;
+        stat[1] = 0;
+        if (desc[1] & SIM_EMAC_CTRL_INT)
+        {
+            SIM_EMAC(IntStatus) |= SIM_EMAC_INT_RX_DONE;
+        }
+        idx = (idx + 1) % n;
+        SIM_EMAC(RxProduceIndex) = idx;
+    }
+    SIM_EMAC(RSV) = (len & 0xFFFF) | (1UL << 23);
+    if (sim_emac_rx_free() == 0)
+    {
+        SIM_EMAC(IntStatus) |= SIM_EMAC_INT_RX_FIN;
+    }
+}
+
+static uint8_t sim_emac_rx_ready(SIM_EMAC_Type* e)
+{
+    return e->backlog_count && (SIM_EMAC(Command) & SIM_EMAC_CR_RX_EN) &&
+           (SIM_EMAC(MAC1) & SIM_EMAC_MAC1_REC_EN);
+}
+
+/* Length of the frame queued at TxConsumeIndex, 0 while its last fragment
+ * has not been produced yet */
+static uint32_t sim_emac_tx_pending(void)
+{
+    uint32_t n = SIM_EMAC(TxDescriptorNumber) + 1;
+    uint32_t idx = SIM_EMAC(TxConsumeIndex);
+    uint32_t len = 0, ctrl;
+
+    if (!(SIM_EMAC(Command) & SIM_EMAC_CR_TX_EN) || sim_emac.tx_fault)
+    {
+        return 0;
+    }
+    while (idx != SIM_EMAC(TxProduceIndex))
+    {
+        ctrl = sim_emac_mem(SIM_EMAC(TxDescriptor) + 8 * idx)[1];
+        len += (ctrl & SIM_EMAC_CTRL_SIZE) + 1;
+        if (ctrl & SIM_EMAC_CTRL_LAST)
+        {
+            return len;
+        }
+        idx = (idx + 1) % n;
+    }
+    return 0;
+}
+
+/* Frame at TxConsumeIndex is through: gather it into the capture, release
+ * its descriptors */
+static void sim_emac_sent(SIM_EMAC_Type* e)
+{
+    SIM_EMAC_Frame_Type* f;
+    uint32_t n = SIM_EMAC(TxDescriptorNumber) + 1;
+    uint32_t idx = SIM_EMAC(TxConsumeIndex);
+    uint32_t ctrl, chunk;
+    volatile uint32_t* desc;
+
+    f = &e->capture[(e->capture_head + e->capture_count) % SIM_EMAC_BUF_SIZE];
+    f->len = 0;
+    do
+    {
+        desc = sim_emac_mem(SIM_EMAC(TxDescriptor) + 8 * idx);
+        ctrl = desc[1];
+        chunk = (ctrl & SIM_EMAC_CTRL_SIZE) + 1;
+        if (f->len + chunk <= SIM_EMAC_MAX_FLEN)
+        {
+            memcpy(&f->data[f->len], (const void*)(uintptr_t)desc[0], chunk);
+            f->len += chunk;
+        }
+        *sim_emac_mem(SIM_EMAC(TxStatus) + 4 * idx) = 0;
+        if (ctrl & SIM_EMAC_CTRL_INT)
+        {
+            SIM_EMAC(IntStatus) |= SIM_EMAC_INT_TX_DONE;
+        }
+        idx = (idx + 1) % n;
+        SIM_EMAC(TxConsumeIndex) = idx;
+    } while (!(ctrl & SIM_EMAC_CTRL_LAST));
+    if (idx == SIM_EMAC(TxProduceIndex))
+    {
+        SIM_EMAC(IntStatus) |= SIM_EMAC_INT_TX_FIN;
+    }
+
+    if (e->capture_count < SIM_EMAC_BUF_SIZE)
+    {
+        e->capture_count++;
+    }
+    else
+    {
+        e->capture_head = (e->capture_head + 1) % SIM_EMAC_BUF_SIZE;   /* drop the oldest */
+    }
+}
+
+/* Unpaced mode: frames arrive and leave as fast as the rings allow */
+static void sim_emac_flow(SIM_EMAC_Type* e)
+{
+    if (e->paced)
+    {
+        return;
+    }
+    while (sim_emac_rx_ready(e) && (sim_emac_rx_free() != 0))
+    {
+        sim_emac_received(e);
+    }
+    while (sim_emac_tx_pending() != 0)
+    {
+        sim_emac_sent(e);
+    }
+}
+
+static void sim_emac_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    SIM_EMAC_Type* e = (SIM_EMAC_Type*)model;
+    volatile uint32_t* reg = SIM_Reg(model->base + offset);
+    uint32_t value = *reg;
+
+    switch (offset)
+    {
+        case SIM_OFS(LPC_EMAC_TypeDef, MCMD):
+            if (value & SIM_EMAC_MCMD_READ)
+            {
+                sim_emac_mii_start(e, 1, 0);
+            }
+            break;
+        case SIM_OFS(LPC_EMAC_TypeDef, MWTD):
+            sim_emac_mii_start(e, 0, (uint16_t)value);
+            break;
+        case SIM_OFS(LPC_EMAC_TypeDef, MRDD):
+        case SIM_OFS(LPC_EMAC_TypeDef, MIND):
+        case SIM_OFS(LPC_EMAC_TypeDef, Status):
+        case SIM_OFS(LPC_EMAC_TypeDef, RxProduceIndex):
+        case SIM_OFS(LPC_EMAC_TypeDef, TxConsumeIndex):
+        case SIM_OFS(LPC_EMAC_TypeDef, RSV):
+        case SIM_OFS(LPC_EMAC_TypeDef, IntStatus):
+            *reg = prev;                                          /* read-only */
+            break;
+        case SIM_OFS(LPC_EMAC_TypeDef, Command):
+            if (value & SIM_EMAC_CR_RX_RES)
+            {
+                SIM_EMAC(RxProduceIndex) = 0;
+                e->rx_time = 0;
+                e->rx_fault = 0;
+            }
+            if (value & SIM_EMAC_CR_TX_RES)
+            {
+                SIM_EMAC(TxConsumeIndex) = 0;
+                e->tx_time = 0;
+                e->tx_fault = 0;
+            }
+            *reg = value & ~(SIM_EMAC_CR_RX_RES | SIM_EMAC_CR_TX_RES | (1UL << 3));   /* self clearing */
+            SIM_EMAC(Status) = *reg & (SIM_EMAC_CR_RX_EN | SIM_EMAC_CR_TX_EN) &
+                               ~((e->rx_fault ? SIM_EMAC_CR_RX_EN : 0) | (e->tx_fault ? SIM_EMAC_CR_TX_EN : 0));
+            break;
+        case SIM_OFS(LPC_EMAC_TypeDef, IntClear):
+            SIM_EMAC(IntStatus) &= ~value;
+            *reg = 0;                                             /* write-only */
+            break;
+        case SIM_OFS(LPC_EMAC_TypeDef, IntSet):
+            SIM_EMAC(IntStatus) |= value;
+            *reg = 0;
+            break;
+        default:
+            break;
+    }
+    sim_emac_flow(e);
+    sim_emac_lines();
+}
+
+static void sim_emac_advance(SIM_Model_Type* model, uint32_t cycles)
+{
+    SIM_EMAC_Type* e = (SIM_EMAC_Type*)model;
+    uint32_t len;
+    uint64_t t;
+    uint8_t changed = 0;
+
+    sim_emac_phy_advance(e, cycles);
+    if (!e->paced)
+    {
+        return;
+    }
+    if (sim_emac_tx_pending() != 0)
+    {
+        e->tx_time += cycles;
+        while ((len = sim_emac_tx_pending()) != 0)
+        {
+            t = sim_emac_frame_time(len);
+            if (e->tx_time < t)
+            {
+                break;
+            }
+            e->tx_time -= t;
+            sim_emac_sent(e);
+            changed = 1;
+        }
+        if (sim_emac_tx_pending() == 0)
+        {
+            e->tx_time = 0;
+        }
+    }
+    if (sim_emac_rx_ready(e))
+    {
+        e->rx_time += cycles;
+        while (sim_emac_rx_ready(e))
+        {
+            t = sim_emac_frame_time(e->backlog[e->backlog_head].len);
+            if (e->rx_time < t)
+            {
+                break;
+            }
+            e->rx_time -= t;
+            sim_emac_received(e);
+            changed = 1;
+        }
+        if (!e->backlog_count)
+        {
+            e->rx_time = 0;
+        }
+    }
+    if (changed)
+    {
+        sim_emac_lines();
+    }
+}
+
+static void sim_emac_update(SIM_Model_Type* model)
+{
+    (void)model;
+    sim_emac_lines();
+}
+
+static void sim_emac_reset(SIM_Model_Type* model)
+{
+    SIM_EMAC_Type* e = (SIM_EMAC_Type*)model;
+
+    e->rx_time = e->tx_time = 0;
+    e->mii_time = 0;
+    e->dropped = 0;
+    e->rx_fault = e->tx_fault = 0;
+    e->backlog_head = e->backlog_count = 0;
+    e->capture_head = e->capture_count = 0;
+    sim_emac_phy_reset(e);
+    SIM_EMAC(MAC1) = 0x8000;
+    SIM_EMAC(Module_ID) = 0x39022000UL;
+}
+
+/**
+ * Queue one frame for the EMAC receiver, paced or not like the UART
+ *
+ * @param  frame  destination address onwards, without FCS
+ * @param  len    14..SIM_EMAC_MAX_FLEN - 4 bytes
+ * @return 1 if queued, 0 if the backlog is full or len is out of range
+ */
+uint32_t SIM_EMAC_Inject(const uint8_t* frame, uint32_t len)
+{
+    SIM_EMAC_Type* e = &sim_emac;
+    SIM_EMAC_Frame_Type* f;
+
+    if ((len < 14) || (len > SIM_EMAC_MAX_FLEN - 4) || (e->backlog_count == SIM_EMAC_BUF_SIZE))
+    {
+        return 0;
+    }
+    f = &e->backlog[(e->backlog_head + e->backlog_count++) % SIM_EMAC_BUF_SIZE];
+    memcpy(f->data, frame, len);
+    f->len = (uint16_t)len;
+    sim_emac_flow(e);
+    sim_emac_lines();
+    return 1;
+}
+
+/**
+ * Fetch the oldest frame the EMAC has transmitted
+ *
+ * @param  frame  destination, without FCS
+ * @param  max    size of frame, a longer frame is truncated
+ * @return frame length, 0 if none is left
+ */
+uint32_t SIM_EMAC_Drain(uint8_t* frame, uint32_t max)
+{
+    SIM_EMAC_Type* e = &sim_emac;
+    SIM_EMAC_Frame_Type* f;
+    uint32_t len;
+
+    if (!e->capture_count)
+    {
+        return 0;
+    }
+    f = &e->capture[e->capture_head];
+    len = f->len;
+    memcpy(frame, f->data, (len < max) ? len : max);
+    e->capture_head = (e->capture_head + 1) % SIM_EMAC_BUF_SIZE;
+    e->capture_count--;
+    return len;
+}
+
+/**
+ * Select unpaced (default) or line rate paced timing
+ *
+ * @param  enable  1: paced
+ */
+void SIM_EMAC_SetPaced(uint8_t enable)
+{
+    sim_emac.paced = enable;
+    sim_emac.rx_time = sim_emac.tx_time = 0;
+    sim_emac_flow(&sim_emac);
+    sim_emac_lines();
+}
+
+/**
+ * Frames dropped so far for want of a free receive descriptor, or while
+ * the receive datapath was stopped by SIM_EMAC_Fault()
+ *
+ * @return number of frames
+ */
+uint32_t SIM_EMAC_GetDropped(void)
+{
+    return sim_emac.dropped;
+}
+
+/**
+ * Stop a datapath as a receive overrun or a transmit underrun does: its
+ * interrupt status is raised and it stays stopped, a frame being sent
+ * staying queued, until the Command RX_RES or TX_RES bit resets it
+ *
+ * @param  status  EMAC_INT_RX_OVERRUN and/or EMAC_INT_TX_UNDERRUN
+ */
+void SIM_EMAC_Fault(uint32_t status)
+{
+    SIM_EMAC_Type* e = &sim_emac;
+
+    if (status & SIM_EMAC_INT_RX_OVERRUN)
+    {
+        e->rx_fault = 1;
+        e->rx_time = 0;
+        SIM_EMAC(Status) &= ~SIM_EMAC_CR_RX_EN;
+    }
+    if (status & SIM_EMAC_INT_TX_UNDERRUN)
+    {
+        e->tx_fault = 1;
+        e->tx_time = 0;
+        SIM_EMAC(Status) &= ~SIM_EMAC_CR_TX_EN;
+    }
+    SIM_EMAC(IntStatus) |= status & (SIM_EMAC_INT_RX_OVERRUN | SIM_EMAC_INT_TX_UNDERRUN);
+    sim_emac_lines();
+}
+
+/**
+ * Give the PHY management the timing of the hardware: MII transactions
+ * take 64 MDC periods, a PHY reset and an auto-negotiation the times given,
+ * the link staying down meanwhile. Both 0 (default): all of it at once
+ *
+ * @param  reset_us  PHY reset time, microseconds
+ * @param  aneg_us   auto-negotiation time, microseconds
+ */
+void SIM_EMAC_SetPHYTiming(uint32_t reset_us, uint32_t aneg_us)
+{
+    sim_emac.reset_time = reset_us * (SIM_CORE_CLOCK / 1000000UL);
+    sim_emac.aneg_time = aneg_us * (SIM_CORE_CLOCK / 1000000UL);
+}
+
+/**
+ * Plug the cable in or pull it out. The link drops at once and comes back
+ * after an auto-negotiation, or at once in a forced mode
+ *
+ * @param  up  1: link partner connected (default)
+ */
+void SIM_EMAC_SetLink(uint8_t up)
+{
+    SIM_EMAC_Type* e = &sim_emac;
+
+    if (up && !e->cable && (e->phy_state == SIM_EMAC_PHY_READY) && (e->phy[0x00] & SIM_EMAC_BMCR_AN))
+    {
+        e->cable = 1;
+        sim_emac_phy_aneg(e);
+        return;
+    }
+    e->cable = up;
+    sim_emac_phy_link(e);
+}
+
+
+/*----------------------------------------------------------------------------
+  TIMER0..3
+ *----------------------------------------------------------------------------*/
+#define SIM_TIM_TCR_EN          (1UL << 0)
+#define SIM_TIM_TCR_RESET       (1UL << 1)
+
+typedef struct
+{
+    SIM_Model_Type model;
+    IRQn_Type irq;
+    uint8_t pclk;
+    uint8_t num;
+    uint8_t cap_level[2];
+    uint8_t reset_pending;
+    uint32_t time;
+} SIM_TIM_Type;
+
+static SIM_TIM_Type sim_tim[4] =
+{
+    { { LPC_TIM0_BASE, "TIMER0" }, TIMER0_IRQn, SIM_PCLK_TIMER0, 0 },
+    { { LPC_TIM1_BASE, "TIMER1" }, TIMER1_IRQn, SIM_PCLK_TIMER1, 1 },
+    { { LPC_TIM2_BASE, "TIMER2" }, TIMER2_IRQn, SIM_PCLK_TIMER2, 2 },
+    { { LPC_TIM3_BASE, "TIMER3" }, TIMER3_IRQn, SIM_PCLK_TIMER3, 3 },
+};
+
+#define SIM_TIM(t, reg)         SIM_REG((t)->model.base, LPC_TIM_TypeDef, reg)
+
+static void sim_tim_lines(SIM_TIM_Type* t)
+{
+    sim_irq_line(t->irq, SIM_TIM(t, IR) & 0x3F);
+}
+
+static void sim_tim_match(SIM_TIM_Type* t, uint8_t ch)
+{
+    uint32_t mcr = SIM_TIM(t, MCR) >> (3 * ch);
+    uint32_t emr = SIM_TIM(t, EMR);
+    uint32_t prev = emr;
+
+    if (mcr & 1)
+    {
+        SIM_TIM(t, IR) |= 1UL << ch;
+    }
+    if (mcr & 2)
+    {
+        t->reset_pending = 1;                       /* TC reads MRn for one count */
+    }
+    if (mcr & 4)
+    {
+        SIM_TIM(t, TCR) &= ~SIM_TIM_TCR_EN;
+    }
+
+    /* External match output */
+    switch ((emr >> (4 + 2 * ch)) & 3)
+    {
+        case 1: emr &= ~(1UL << ch); break;
+        case 2: emr |= 1UL << ch;    break;
+        case 3: emr ^= 1UL << ch;    break;
+        default: break;
+    }
+    SIM_TIM(t, EMR) = emr;
+
+    /* MATx.0/MATx.1 DMA requests and ADC start triggers */
+    if (ch < 2)
+    {
+        SIM_DMAPulse((uint8_t)(16 + 2 * t->num + ch));
+    }
+    /* The ADC starts on the edge of the MATx.y output selected by ADCR.EDGE */
+    if (((emr ^ prev) >> ch) & 1)
+    {
+        if (((emr >> ch) & 1) == !(SIM_REG(LPC_ADC_BASE, LPC_ADC_TypeDef, ADCR) & (1UL << 27)))
+        {
+            if      ((t->num == 0) && (ch == 1)) sim_adc_trigger(4);
+            else if ((t->num == 0) && (ch == 3)) sim_adc_trigger(5);
+            else if ((t->num == 1) && (ch == 0)) sim_adc_trigger(6);
+            else if ((t->num == 1) && (ch == 1)) sim_adc_trigger(7);
+        }
+    }
+}
+
+/* Advance the timer counter by ticks prescaled counts, handling each match */
+static void sim_tim_count(SIM_TIM_Type* t, uint64_t ticks)
+{
+    uint64_t prescale = (uint64_t)SIM_TIM(t, PR) + 1;
+    uint64_t total = SIM_TIM(t, PC) + ticks;
+    uint64_t counts = total / prescale;
+    uint32_t tc, dist, next;
+    uint8_t ch;
+
+    SIM_TIM(t, PC) = (uint32_t)(total % prescale);
+    while (counts && (SIM_TIM(t, TCR) & SIM_TIM_TCR_EN))
+    {
+        if (t->reset_pending)
+        {
+            t->reset_pending = 0;
+            SIM_TIM(t, TC) = 0;
+            counts--;
+            continue;
+        }
+        tc = SIM_TIM(t, TC);
+        next = 0;
+        for (ch = 0; ch < 4; ch++)
+        {
+            dist = *SIM_Reg(t->model.base + SIM_OFS(LPC_TIM_TypeDef, MR0) + 4 * ch) - tc;
+            if ((dist != 0) && ((next == 0) || (dist < next)))
+            {
+                next = dist;
+            }
+        }
+        if ((next == 0) || (counts < next))
+        {
+            SIM_TIM(t, TC) = tc + (uint32_t)counts;
+            break;
+        }
+        counts -= next;
+        SIM_TIM(t, TC) = tc + next;
+        for (ch = 0; ch < 4; ch++)
+        {
+            if (*SIM_Reg(t->model.base + SIM_OFS(LPC_TIM_TypeDef, MR0) + 4 * ch) == tc + next)
+            {
+                sim_tim_match(t, ch);
+            }
+        }
+    }
+    sim_tim_lines(t);
+}
+
+static void sim_tim_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    SIM_TIM_Type* t = (SIM_TIM_Type*)model;
+    volatile uint32_t* reg = SIM_Reg(model->base + offset);
+
+    switch (offset)
+    {
+        case SIM_OFS(LPC_TIM_TypeDef, IR):
+            *reg = prev & ~*reg;                                  /* write-1-to-clear */
+            break;
+        case SIM_OFS(LPC_TIM_TypeDef, TCR):
+            if (*reg & SIM_TIM_TCR_RESET)
+            {
+                SIM_TIM(t, TC) = 0;
+                SIM_TIM(t, PC) = 0;
+                t->reset_pending = 0;
+            }
+            break;
+        case SIM_OFS(LPC_TIM_TypeDef, CR0):
+        case SIM_OFS(LPC_TIM_TypeDef, CR1):
+            *reg = prev;                                          /* read-only */
+            break;
+        default:
+            break;
+    }
+    sim_tim_lines(t);
+}
+
+static void sim_tim_advance(SIM_Model_Type* model, uint32_t cycles)
+{
+    SIM_TIM_Type* t = (SIM_TIM_Type*)model;
+    uint32_t div;
+
+    if (((SIM_TIM(t, TCR) & (SIM_TIM_TCR_EN | SIM_TIM_TCR_RESET)) != SIM_TIM_TCR_EN) ||
+        (SIM_TIM(t, CTCR) & 3))
+    {
+        return;                                     /* stopped, held in reset or counter mode */
+    }
+    div = sim_pclk_div(t->pclk);
+    t->time += cycles;
+    if (t->time >= div)
+    {
+        sim_tim_count(t, t->time / div);
+        t->time %= div;
+    }
+}
+
+static void sim_tim_update(SIM_Model_Type* model)
+{
+    sim_tim_lines((SIM_TIM_Type*)model);
+}
+
+static void sim_tim_reset(SIM_Model_Type* model)
+{
+    SIM_TIM_Type* t = (SIM_TIM_Type*)model;
+
+    t->time = 0;
+    t->reset_pending = 0;
+    t->cap_level[0] = t->cap_level[1] = 0;
+}
+
+/**
+ * Drive a timer capture input CAPn.ch
+ *
+ * @param  timer    timer 0..3
+ * @param  channel  capture channel 0..1
+ * @param  level    new pin level
+ */
+void SIM_TIM_CaptureInput(uint8_t timer, uint8_t channel, uint8_t level)
+{
+    SIM_TIM_Type* t;
+    uint32_t ccr, ctcr;
+    uint8_t rise, fall;
+
+    if ((timer > 3) || (channel > 1))
+    {
+        return;
+    }
+    t = &sim_tim[timer];
+    level = (level != 0);
+    if (level == t->cap_level[channel])
+    {
+        return;
+    }
+    t->cap_level[channel] = level;
+    rise = level;
+    fall = !level;
+
+    /* Counter mode counts edges of the selected CAP input */
+    ctcr = SIM_TIM(t, CTCR);
+    if ((ctcr & 3) && (((ctcr >> 2) & 3) == channel) &&
+        ((SIM_TIM(t, TCR) & (SIM_TIM_TCR_EN | SIM_TIM_TCR_RESET)) == SIM_TIM_TCR_EN) &&
+        ((rise && (ctcr & 1)) || (fall && (ctcr & 2))))
+    {
+        if (t->reset_pending)
+        {
+            t->reset_pending = 0;                     /* reset on match took effect on the next PCLK */
+            SIM_TIM(t, TC) = 0;
+        }
+        sim_tim_count(t, 1);
+    }
+
+    ccr = SIM_TIM(t, CCR) >> (3 * channel);
+    if ((rise && (ccr & 1)) || (fall && (ccr & 2)))
+    {
+        *SIM_Reg(t->model.base + SIM_OFS(LPC_TIM_TypeDef, CR0) + 4 * channel) = SIM_TIM(t, TC);
+        if (ccr & 4)
+        {
+            SIM_TIM(t, IR) |= 1UL << (4 + channel);
+        }
+        if ((timer == 0) && (channel == 1))
+        {
+            sim_adc_trigger(3);
+        }
+    }
+    sim_tim_lines(t);
+}
+
+
+/*----------------------------------------------------------------------------
+  ADC
+ *----------------------------------------------------------------------------*/
+#define SIM_ADC(reg)            SIM_REG(LPC_ADC_BASE, LPC_ADC_TypeDef, reg)
+#define SIM_ADC_DR(ch)          (*SIM_Reg(LPC_ADC_BASE + SIM_OFS(LPC_ADC_TypeDef, ADDR0) + 4 * (ch)))
+
+#define SIM_ADC_CR_BURST        (1UL << 16)
+#define SIM_ADC_CR_PDN          (1UL << 21)
+#define SIM_ADC_DR_OVERRUN      (1UL << 30)
+#define SIM_ADC_DR_DONE         (1UL << 31)
+#define SIM_ADC_CONV_CLOCKS     65
+
+static uint16_t sim_adc_input[8];
+static int8_t sim_adc_channel = -1;             /* channel being converted, -1: idle */
+static uint8_t sim_adc_armed;                   /* START mode waiting for its trigger */
+static uint64_t sim_adc_time;
+
+static void sim_adc_lines(void)
+{
+    uint32_t inten = SIM_ADC(ADINTEN);
+    uint32_t stat = 0;
+    uint32_t dr;
+    uint8_t ch;
+
+    for (ch = 0; ch < 8; ch++)
+    {
+        dr = SIM_ADC_DR(ch);
+        if (dr & SIM_ADC_DR_DONE)    stat |= 1UL << ch;
+        if (dr & SIM_ADC_DR_OVERRUN) stat |= 1UL << (8 + ch);
+    }
+    if ((stat & inten & 0xFF) || ((inten & 0x100) && (SIM_ADC(ADGDR) & SIM_ADC_DR_DONE)))
+    {
+        stat |= 1UL << 16;
+    }
+    SIM_ADC(ADSTAT) = stat;
+    sim_irq_line(ADC_IRQn, stat & (1UL << 16));
+    SIM_DMARequest(4, (stat & (1UL << 16)) != 0);
+}
+
+static uint64_t sim_adc_conv_time(void)
+{
+    return (uint64_t)SIM_ADC_CONV_CLOCKS * (((SIM_ADC(ADCR) >> 8) & 0xFF) + 1) * sim_pclk_div(SIM_PCLK_ADC);
+}
+
+/* First selected channel at or after ch, -1 if none */
+static int8_t sim_adc_next_channel(uint8_t ch)
+{
+    uint32_t sel = SIM_ADC(ADCR) & 0xFF;
+    uint8_t i;
+
+    for (i = 0; i < 8; i++)
+    {
+        if (sel & (1UL << ((ch + i) & 7)))
+        {
+            return (int8_t)((ch + i) & 7);
+        }
+    }
+    return -1;
+}
+
+static void sim_adc_start(void)
+{
+    sim_adc_channel = sim_adc_next_channel(0);
+    sim_adc_time = 0;
+}
+
+static void sim_adc_trigger(uint8_t mode)
+{
+    uint32_t cr = SIM_ADC(ADCR);
+
+    if ((sim_adc_armed == mode) && (cr & SIM_ADC_CR_PDN) && !(cr & SIM_ADC_CR_BURST))
+    {
+        sim_adc_start();
+    }
+}
+
+static void sim_adc_complete(uint8_t ch)
+{
+    uint32_t result = ((uint32_t)(sim_adc_input[ch] & 0xFFF)) << 4;
+    uint32_t dr = SIM_ADC_DR(ch);
+    uint32_t gdr = SIM_ADC(ADGDR);
+
+    SIM_ADC_DR(ch) = SIM_ADC_DR_DONE | ((dr & SIM_ADC_DR_DONE) ? SIM_ADC_DR_OVERRUN : 0) | result;
+    SIM_ADC(ADGDR) = SIM_ADC_DR_DONE | ((gdr & SIM_ADC_DR_DONE) ? SIM_ADC_DR_OVERRUN : 0) |
+                     ((uint32_t)ch << 24) | result;
+}
+
+static void sim_adc_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    volatile uint32_t* reg = SIM_Reg(model->base + offset);
+    uint32_t start;
+
+    if (offset == SIM_OFS(LPC_ADC_TypeDef, ADCR))
+    {
+        start = (*reg >> 24) & 7;
+        sim_adc_armed = 0;
+        if (!(*reg & SIM_ADC_CR_PDN))
+        {
+            sim_adc_channel = -1;
+        }
+        else if (*reg & SIM_ADC_CR_BURST)
+        {
+            if (!(prev & SIM_ADC_CR_BURST) || (sim_adc_channel < 0))
+            {
+                sim_adc_start();
+            }
+        }
+        else if (start == 1)
+        {
+            sim_adc_start();
+        }
+        else if (start != 0)
+        {
+            sim_adc_armed = (uint8_t)start;
+        }
+    }
+    else if ((offset >= SIM_OFS(LPC_ADC_TypeDef, ADDR0)) && (offset <= SIM_OFS(LPC_ADC_TypeDef, ADSTAT)))
+    {
+        *reg = prev;                                            /* read-only */
+    }
+    sim_adc_lines();
+}
+
+static void sim_adc_read_done(SIM_Model_Type* model, uint32_t offset)
+{
+    uint32_t gdr;
+
+    (void)model;
+    if (offset == SIM_OFS(LPC_ADC_TypeDef, ADGDR))
+    {
+        /* Also retire the channel's own DONE flag so a DMA read drops the request */
+        gdr = SIM_ADC(ADGDR);
+        SIM_ADC(ADGDR) = gdr & ~(SIM_ADC_DR_DONE | SIM_ADC_DR_OVERRUN);
+        SIM_ADC_DR((gdr >> 24) & 7) &= ~(SIM_ADC_DR_DONE | SIM_ADC_DR_OVERRUN);
+    }
+    else if ((offset >= SIM_OFS(LPC_ADC_TypeDef, ADDR0)) && (offset < SIM_OFS(LPC_ADC_TypeDef, ADSTAT)))
+    {
+        *SIM_Reg(LPC_ADC_BASE + offset) &= ~(SIM_ADC_DR_DONE | SIM_ADC_DR_OVERRUN);
+    }
+    else
+    {
+        return;
+    }
+    sim_adc_lines();
+}
+
+static void sim_adc_advance(SIM_Model_Type* model, uint32_t cycles)
+{
+    uint64_t conv;
+    uint8_t ch;
+
+    (void)model;
+    if (sim_adc_channel < 0)
+    {
+        return;
+    }
+    conv = sim_adc_conv_time();
+    sim_adc_time += cycles;
+    while ((sim_adc_channel >= 0) && (sim_adc_time >= conv))
+    {
+        sim_adc_time -= conv;
+        ch = (uint8_t)sim_adc_channel;
+        sim_adc_complete(ch);
+        sim_adc_channel = (SIM_ADC(ADCR) & SIM_ADC_CR_BURST) ? sim_adc_next_channel(ch + 1) : -1;
+        sim_adc_lines();
+    }
+}
+
+static void sim_adc_update(SIM_Model_Type* model)
+{
+    (void)model;
+    sim_adc_lines();
+}
+
+static void sim_adc_reset(SIM_Model_Type* model)
+{
+    (void)model;
+    sim_adc_channel = -1;
+    sim_adc_armed = 0;
+    sim_adc_time = 0;
+    SIM_ADC(ADINTEN) = 0x100;
+}
+
+static SIM_Model_Type sim_adc_model =
+{
+    LPC_ADC_BASE, "ADC", sim_adc_reset, NULL, sim_adc_read_done, sim_adc_write, sim_adc_advance, sim_adc_update, 0
+};
+
+/**
+ * Set the voltage on an ADC input
+ *
+ * @param  channel  AD0.0..AD0.7
+ * @param  value    12-bit conversion result
+ */
+void SIM_ADC_SetInput(uint8_t channel, uint16_t value)
+{
+    if (channel < 8)
+    {
+        sim_adc_input[channel] = value & 0xFFF;
+    }
+}
+
+
+/*----------------------------------------------------------------------------
+  DAC
+ *----------------------------------------------------------------------------*/
+#define SIM_DAC(reg)            SIM_REG(LPC_DAC_BASE, LPC_DAC_TypeDef, reg)
+
+#define SIM_DAC_INT_DMA_REQ     (1UL << 0)
+#define SIM_DAC_DBLBUF_ENA      (1UL << 1)
+#define SIM_DAC_CNT_ENA         (1UL << 2)
+#define SIM_DAC_DMA_ENA         (1UL << 3)
+
+static uint16_t sim_dac_output;
+static uint16_t sim_dac_buffer;
+static uint32_t sim_dac_count;
+static uint32_t sim_dac_time;
+static void (*sim_dac_sink)(uint16_t value, uint64_t cycle);
+
+static void sim_dac_set(uint16_t value)
+{
+    sim_dac_output = value;
+    if (sim_dac_sink != NULL)
+    {
+        sim_dac_sink(value, SIM_GetCycles());
+    }
+}
+
+static void sim_dac_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    volatile uint32_t* reg = SIM_Reg(model->base + offset);
+    uint32_t ctrl = SIM_DAC(DACCTRL);
+    uint16_t value;
+
+    if (offset == SIM_OFS(LPC_DAC_TypeDef, DACR))
+    {
+        value = (uint16_t)((*reg >> 6) & 0x3FF);
+        SIM_DAC(DACCTRL) = ctrl & ~SIM_DAC_INT_DMA_REQ;
+        if ((ctrl & (SIM_DAC_DBLBUF_ENA | SIM_DAC_CNT_ENA)) == (SIM_DAC_DBLBUF_ENA | SIM_DAC_CNT_ENA))
+        {
+            sim_dac_buffer = value;                   /* takes effect at the next time-out */
+        }
+        else
+        {
+            sim_dac_set(value);
+        }
+    }
+    else if (offset == SIM_OFS(LPC_DAC_TypeDef, DACCTRL))
+    {
+        *reg = (*reg & ~SIM_DAC_INT_DMA_REQ) | (prev & SIM_DAC_INT_DMA_REQ);
+        if ((*reg & SIM_DAC_CNT_ENA) && !(prev & SIM_DAC_CNT_ENA))
+        {
+            sim_dac_count = SIM_DAC(DACCNTVAL) & 0xFFFF;
+            sim_dac_time = 0;
+        }
+    }
+}
+
+static void sim_dac_advance(SIM_Model_Type* model, uint32_t cycles)
+{
+    uint32_t ctrl = SIM_DAC(DACCTRL);
+    uint32_t div, ticks;
+
+    (void)model;
+    if (!(ctrl & SIM_DAC_CNT_ENA))
+    {
+        return;
+    }
+    div = sim_pclk_div(SIM_PCLK_DAC);
+    sim_dac_time += cycles;
+    ticks = sim_dac_time / div;
+    sim_dac_time %= div;
+
+    /* The counter runs down from DACCNTVAL, each time-out raises a request */
+    while (ticks)
+    {
+        if (ticks < sim_dac_count)
+        {
+            sim_dac_count -= ticks;
+            break;
+        }
+        ticks -= sim_dac_count ? sim_dac_count : 1;
+        sim_dac_count = SIM_DAC(DACCNTVAL) & 0xFFFF;
+        ctrl = SIM_DAC(DACCTRL);
+        if (ctrl & SIM_DAC_DBLBUF_ENA)
+        {
+            sim_dac_set(sim_dac_buffer);
+        }
+        SIM_DAC(DACCTRL) = ctrl | SIM_DAC_INT_DMA_REQ;
+        if (ctrl & SIM_DAC_DMA_ENA)
+        {
+            SIM_DMAPulse(7);
+        }
+    }
+}
+
+static void sim_dac_reset(SIM_Model_Type* model)
+{
+    (void)model;
+    sim_dac_output = 0;
+    sim_dac_buffer = 0;
+    sim_dac_count = 0;
+    sim_dac_time = 0;
+}
+
+static SIM_Model_Type sim_dac_model =
+{
+    LPC_DAC_BASE, "DAC", sim_dac_reset, NULL, NULL, sim_dac_write, sim_dac_advance, NULL, 0
+};
+
+/**
+ * Observe every DAC output update
+ *
+ * @param  sink  called with the 10-bit value and the cycle it was applied at
+ */
+void SIM_DAC_SetSink(void (*sink)(uint16_t value, uint64_t cycle))
+{
+    sim_dac_sink = sink;
+}
+
+uint16_t SIM_DAC_GetOutput(void)
+{
+    return sim_dac_output;
+}
+
+
+/*----------------------------------------------------------------------------
+  I2S
+ *----------------------------------------------------------------------------*/
+#define SIM_I2S(reg)            SIM_REG(LPC_I2S_BASE, LPC_I2S_TypeDef, reg)
+
+#define SIM_I2S_FIFO            8
+#define SIM_I2S_STOP            (1UL << 3)
+#define SIM_I2S_RESET           (1UL << 4)
+#define SIM_I2S_MUTE            (1UL << 15)
+#define SIM_I2S_4PIN            (1UL << 2)
+
+/* One direction. The line moves one 32-bit FIFO word per 32 bit clocks:
+ * a 16-bit stereo frame or two 16-bit mono samples */
+typedef struct
+{
+    uint32_t fifo[SIM_I2S_FIFO];
+    uint8_t head, count;
+    uint64_t time;                                /* core cycles times X of the rate */
+    uint32_t errors;                              /* TX underruns, RX overruns */
+} SIM_I2S_Dir_Type;
+
+static SIM_I2S_Dir_Type sim_i2s_tx, sim_i2s_rx;
+static void (*sim_i2s_sink)(uint32_t word, uint64_t cycle);
+static uint32_t (*sim_i2s_source)(uint64_t cycle);
+
+static uint8_t sim_i2s_running(uint32_t ctrl)
+{
+    return !(ctrl & (SIM_I2S_STOP | SIM_I2S_RESET));
+}
+
+/* Bit clock of a direction: PCLK * X / Y / 2 / (BITRATE + 1). Returns the
+ * cost of a word in core cycles times X, 0 when the divider is not set. In
+ * 4-pin mode the receiver runs on the transmitter clock */
+static uint64_t sim_i2s_word_time(uint8_t rx, uint32_t* x)
+{
+    uint32_t rate = SIM_I2S(I2STXRATE), bitrate = SIM_I2S(I2STXBITRATE);
+
+    if (rx && !(SIM_I2S(I2SRXMODE) & SIM_I2S_4PIN))
+    {
+        rate = SIM_I2S(I2SRXRATE);
+        bitrate = SIM_I2S(I2SRXBITRATE);
+    }
+    *x = (rate >> 8) & 0xFF;
+    if ((*x == 0) || ((rate & 0xFF) == 0))
+    {
+        return 0;
+    }
+    return 64ULL * sim_pclk_div(SIM_PCLK_I2S) * (rate & 0xFF) * ((bitrate & 0x3F) + 1);
+}
+
+/* dmareq = (rx_depth <= rx_level) || (tx_depth >= tx_level), per enabled direction */
+static uint8_t sim_i2s_dmareq(uint32_t dma)
+{
+    return ((dma & 1) && (((dma >> 8) & 0x1F) <= sim_i2s_rx.count)) ||
+           ((dma & 2) && (((dma >> 16) & 0x1F) >= sim_i2s_tx.count));
+}
+
+static void sim_i2s_lines(void)
+{
+    uint32_t irq = SIM_I2S(I2SIRQ);
+    uint8_t dma1 = sim_i2s_dmareq(SIM_I2S(I2SDMA1));
+    uint8_t dma2 = sim_i2s_dmareq(SIM_I2S(I2SDMA2));
+    uint8_t req = sim_i2s_dmareq(irq);
+
+    SIM_I2S(I2SSTATE) = req | (dma1 << 1) | (dma2 << 2) | ((uint32_t)sim_i2s_rx.count << 8) |
+                        ((uint32_t)sim_i2s_tx.count << 16);
+    sim_irq_line(I2S_IRQn, req);
+    SIM_DMARequest(5, dma1);
+    SIM_DMARequest(6, dma2);
+}
+
+/* One word out of the transmit shift register, zero when muted or starved */
+static void sim_i2s_send(void)
+{
+    uint32_t word = 0;
+
+    if (sim_i2s_tx.count)
+    {
+        word = sim_i2s_tx.fifo[sim_i2s_tx.head];
+        sim_i2s_tx.head = (sim_i2s_tx.head + 1) % SIM_I2S_FIFO;
+        sim_i2s_tx.count--;
+    }
+    else
+    {
+        sim_i2s_tx.errors++;
+    }
+    if (SIM_I2S(I2SDAO) & SIM_I2S_MUTE)
+    {
+        word = 0;
+    }
+    if (sim_i2s_sink != NULL)
+    {
+        sim_i2s_sink(word, SIM_GetCycles());
+    }
+}
+
+static void sim_i2s_receive(void)
+{
+    uint32_t word = (sim_i2s_source != NULL) ? sim_i2s_source(SIM_GetCycles()) : 0;
+
+    if (sim_i2s_rx.count == SIM_I2S_FIFO)
+    {
+        sim_i2s_rx.errors++;
+        return;
+    }
+    sim_i2s_rx.fifo[(sim_i2s_rx.head + sim_i2s_rx.count++) % SIM_I2S_FIFO] = word;
+}
+
+static void sim_i2s_read(SIM_Model_Type* model, uint32_t offset)
+{
+    (void)model;
+    if (offset == SIM_OFS(LPC_I2S_TypeDef, I2SRXFIFO))
+    {
+        SIM_I2S(I2SRXFIFO) = sim_i2s_rx.count ? sim_i2s_rx.fifo[sim_i2s_rx.head] : 0;
+    }
+}
+
+static void sim_i2s_read_done(SIM_Model_Type* model, uint32_t offset)
+{
+    (void)model;
+    if ((offset == SIM_OFS(LPC_I2S_TypeDef, I2SRXFIFO)) && sim_i2s_rx.count)
+    {
+        sim_i2s_rx.head = (sim_i2s_rx.head + 1) % SIM_I2S_FIFO;
+        sim_i2s_rx.count--;
+        sim_i2s_lines();
+    }
+}
+
+static void sim_i2s_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    volatile uint32_t* reg = SIM_Reg(model->base + offset);
+
+    switch (offset)
+    {
+        case SIM_OFS(LPC_I2S_TypeDef, I2SDAO):
+        case SIM_OFS(LPC_I2S_TypeDef, I2SDAI):
+            if (*reg & SIM_I2S_RESET)
+            {
+                if (offset == SIM_OFS(LPC_I2S_TypeDef, I2SDAO))
+                {
+                    sim_i2s_tx.head = sim_i2s_tx.count = 0;
+                }
+                else
+                {
+                    sim_i2s_rx.head = sim_i2s_rx.count = 0;
+                }
+            }
+            if (sim_i2s_running(*reg) && !sim_i2s_running(prev))
+            {
+                /* The first word goes out a full word time after the start. A 4-pin
+                 * receiver joins the word clock of a running transmitter */
+                if (offset == SIM_OFS(LPC_I2S_TypeDef, I2SDAO))
+                {
+                    sim_i2s_tx.time = 0;
+                }
+                else
+                {
+                    sim_i2s_rx.time = ((SIM_I2S(I2SRXMODE) & SIM_I2S_4PIN) && sim_i2s_running(SIM_I2S(I2SDAO)))
+                        ? sim_i2s_tx.time : 0;
+                }
+            }
+            break;
+        case SIM_OFS(LPC_I2S_TypeDef, I2STXFIFO):
+            if (sim_i2s_tx.count < SIM_I2S_FIFO)
+            {
+                sim_i2s_tx.fifo[(sim_i2s_tx.head + sim_i2s_tx.count++) % SIM_I2S_FIFO] = *reg;
+            }
+            break;
+        case SIM_OFS(LPC_I2S_TypeDef, I2SRXFIFO):
+        case SIM_OFS(LPC_I2S_TypeDef, I2SSTATE):
+            *reg = prev;                                          /* read-only */
+            break;
+        default:
+            break;
+    }
+    sim_i2s_lines();
+}
+
+static void sim_i2s_advance(SIM_Model_Type* model, uint32_t cycles)
+{
+    uint64_t word;
+    uint32_t x;
+    uint8_t changed = 0;
+
+    (void)model;
+    if (sim_i2s_running(SIM_I2S(I2SDAO)) && ((word = sim_i2s_word_time(0, &x)) != 0))
+    {
+        sim_i2s_tx.time += (uint64_t)cycles * x;
+        while (sim_i2s_tx.time >= word)
+        {
+            sim_i2s_tx.time -= word;
+            sim_i2s_send();
+            changed = 1;
+        }
+    }
+    if (sim_i2s_running(SIM_I2S(I2SDAI)) && ((word = sim_i2s_word_time(1, &x)) != 0))
+    {
+        sim_i2s_rx.time += (uint64_t)cycles * x;
+        while (sim_i2s_rx.time >= word)
+        {
+            sim_i2s_rx.time -= word;
+            sim_i2s_receive();
+            changed = 1;
+        }
+    }
+    if (changed)
+    {
+        sim_i2s_lines();
+    }
+}
+
+static void sim_i2s_update(SIM_Model_Type* model)
+{
+    (void)model;
+    sim_i2s_lines();
+}
+
+static void sim_i2s_reset(SIM_Model_Type* model)
+{
+    (void)model;
+    memset(&sim_i2s_tx, 0, sizeof(sim_i2s_tx));
+    memset(&sim_i2s_rx, 0, sizeof(sim_i2s_rx));
+    SIM_I2S(I2SDAO) = 0x87E1;
+    SIM_I2S(I2SDAI) = 0x07E1;
+}
+
+static SIM_Model_Type sim_i2s_model =
+{
+    LPC_I2S_BASE, "I2S", sim_i2s_reset, sim_i2s_read, sim_i2s_read_done, sim_i2s_write, sim_i2s_advance,
+    sim_i2s_update, 0
+};
+
+/**
+ * Feed the I2S receiver
+ *
+ * @param  source  called for every received word with the current cycle,
+ *                 NULL receives zeros
+ */
+void SIM_I2S_SetSource(uint32_t (*source)(uint64_t cycle))
+{
+    sim_i2s_source = source;
+}
+
+/**
+ * Observe every word the I2S transmitter shifts out
+ *
+ * @param  sink  called with the word and the cycle it went out at
+ */
+void SIM_I2S_SetSink(void (*sink)(uint32_t word, uint64_t cycle))
+{
+    sim_i2s_sink = sink;
+}
+
+/**
+ * Words lost since the last reset: sent while the transmit FIFO was empty,
+ * or received while the receive FIFO was full
+ *
+ * @param  underruns  transmit underruns, may be NULL
+ * @param  overruns   receive overruns, may be NULL
+ */
+void SIM_I2S_GetErrors(uint32_t* underruns, uint32_t* overruns)
+{
+    if (underruns != NULL)
+    {
+        *underruns = sim_i2s_tx.errors;
+    }
+    if (overruns != NULL)
+    {
+        *overruns = sim_i2s_rx.errors;
+    }
+}
+
+
+/*----------------------------------------------------------------------------
+  GPDMA
+ *----------------------------------------------------------------------------*/
+#define SIM_DMA(reg)            SIM_REG(LPC_GPDMA_BASE, LPC_GPDMA_TypeDef, reg)
+#define SIM_DMACH(ch, reg)      SIM_REG(LPC_GPDMACH0_BASE + (ch) * 0x20, LPC_GPDMACH_TypeDef, reg)
+
+#define SIM_DMA_CTRL_SI         (1UL << 26)
+#define SIM_DMA_CTRL_DI         (1UL << 27)
+#define SIM_DMA_CTRL_I          (1UL << 31)
+#define SIM_DMA_CFG_E           (1UL << 0)
+#define SIM_DMA_CFG_IE          (1UL << 14)
+#define SIM_DMA_CFG_ITC         (1UL << 15)
+#define SIM_DMA_CFG_H           (1UL << 18)
+
+enum { SIM_DMA_M2M, SIM_DMA_M2P, SIM_DMA_P2M, SIM_DMA_P2P };
+
+static uint8_t sim_dma_level[SIM_DMA_CONNS];
+static uint8_t sim_dma_pulse[SIM_DMA_CONNS];
+static uint8_t sim_dma_busy;
+static uint8_t sim_dma_again;
+
+static void sim_dma_lines(void)
+{
+    uint32_t tc = 0, err = 0;
+    uint8_t ch;
+
+    for (ch = 0; ch < SIM_DMA_CHANNELS; ch++)
+    {
+        if (SIM_DMACH(ch, DMACCConfig) & SIM_DMA_CFG_ITC) tc  |= 1UL << ch;
+        if (SIM_DMACH(ch, DMACCConfig) & SIM_DMA_CFG_IE)  err |= 1UL << ch;
+    }
+    SIM_DMA(DMACIntTCStat)  = SIM_DMA(DMACRawIntTCStat) & tc;
+    SIM_DMA(DMACIntErrStat) = SIM_DMA(DMACRawIntErrStat) & err;
+    SIM_DMA(DMACIntStat)    = SIM_DMA(DMACIntTCStat) | SIM_DMA(DMACIntErrStat);
+    sim_irq_line(DMA_IRQn, SIM_DMA(DMACIntStat));
+}
+
+/* Request line of a peripheral number, after the DMAREQSEL UART/timer mux */
+static uint8_t sim_dma_conn(uint32_t periph)
+{
+    if ((periph >= 8) && (SIM_SC(DMAREQSEL) & (1UL << (periph - 8))))
+    {
+        return (uint8_t)(periph + 8);
+    }
+    return (uint8_t)periph;
+}
+
+/* Run one burst of channel ch if its request is active, return 1 if it did */
+static uint8_t sim_dma_channel(uint8_t ch)
+{
+    static const uint16_t burst[8] = { 1, 4, 8, 16, 32, 64, 128, 256 };
+    uint32_t config = SIM_DMACH(ch, DMACCConfig);
+    uint32_t control, src, dst, lli, items;
+    uint8_t type, conn = 0, swidth, dwidth, pulsed = 0;
+
+    if (!(config & SIM_DMA_CFG_E) || (config & SIM_DMA_CFG_H))
+    {
+        return 0;
+    }
+
+    switch ((config >> 11) & 7)
+    {
+        case 0:          type = SIM_DMA_M2M; break;
+        case 1: case 5:  type = SIM_DMA_M2P; break;
+        case 2: case 6:  type = SIM_DMA_P2M; break;
+        default:         type = SIM_DMA_P2P; break;
+    }
+    if (type != SIM_DMA_M2M)
+    {
+        conn = sim_dma_conn((type == SIM_DMA_M2P) ? (config >> 6) & 0x1F : (config >> 1) & 0x1F);
+        if (conn >= SIM_DMA_CONNS)
+        {
+            return 0;
+        }
+        if (!sim_dma_level[conn])
+        {
+            if (!sim_dma_pulse[conn])
+            {
+                return 0;
+            }
+            sim_dma_pulse[conn] = 0;
+            pulsed = 1;
+        }
+    }
+
+    control = SIM_DMACH(ch, DMACCControl);
+    src = SIM_DMACH(ch, DMACCSrcAddr);
+    dst = SIM_DMACH(ch, DMACCDestAddr);
+    swidth = (uint8_t)(1U << ((control >> 18) & 3));
+    dwidth = (uint8_t)(1U << ((control >> 21) & 3));
+    items = control & 0xFFF;
+    if (type != SIM_DMA_M2M)
+    {
+        lli = burst[(control >> ((type == SIM_DMA_M2P) ? 15 : 12)) & 7];
+        if (items > lli)
+        {
+            items = lli;
+        }
+    }
+
+    while (items--)
+    {
+        SIM_BusWrite(dst, SIM_BusRead(src, swidth), dwidth);
+        if (control & SIM_DMA_CTRL_SI) src += swidth;
+        if (control & SIM_DMA_CTRL_DI) dst += dwidth;
+        control--;
+        /* A level request that drops ends the burst early */
+        if ((type != SIM_DMA_M2M) && !pulsed && !sim_dma_level[conn])
+        {
+            break;
+        }
+    }
+    SIM_DMACH(ch, DMACCSrcAddr) = src;
+    SIM_DMACH(ch, DMACCDestAddr) = dst;
+    SIM_DMACH(ch, DMACCControl) = control;
+    if (control & 0xFFF)
+    {
+        return 1;
+    }
+
+    /* Terminal count: flag it, then follow the linked list or stop */
+    if (control & SIM_DMA_CTRL_I)
+    {
+        SIM_DMA(DMACRawIntTCStat) |= 1UL << ch;
+    }
+    lli = SIM_DMACH(ch, DMACCLLI) & ~3UL;
+    if (lli != 0)
+    {
+        SIM_DMACH(ch, DMACCSrcAddr)  = SIM_BusRead(lli, 4);
+        SIM_DMACH(ch, DMACCDestAddr) = SIM_BusRead(lli + 4, 4);
+        SIM_DMACH(ch, DMACCLLI)      = SIM_BusRead(lli + 8, 4);
+        SIM_DMACH(ch, DMACCControl)  = SIM_BusRead(lli + 12, 4);
+    }
+    else
+    {
+        SIM_DMACH(ch, DMACCConfig) &= ~SIM_DMA_CFG_E;
+        SIM_DMA(DMACEnbldChns) &= ~(1UL << ch);
+    }
+    sim_dma_lines();
+    return 1;
+}
+
+/* Run the enabled channels until no request is left (bounded) */
+static void sim_dma_service(void)
+{
+    uint32_t rounds = SIM_DMA_MAX_BURSTS;
+    uint8_t progress, ch;
+
+    if (sim_dma_busy)
+    {
+        sim_dma_again = 1;                          /* a transfer changed a request line */
+        return;
+    }
+    if (!(SIM_DMA(DMACConfig) & 1) || !SIM_DMA(DMACEnbldChns))
+    {
+        return;
+    }
+    sim_dma_busy = 1;
+    do
+    {
+        sim_dma_again = 0;
+        progress = 0;
+        for (ch = 0; ch < SIM_DMA_CHANNELS; ch++)
+        {
+            progress |= sim_dma_channel(ch);
+        }
+    } while ((progress || sim_dma_again) && --rounds);
+    sim_dma_busy = 0;
+}
+
+static void sim_dma_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    volatile uint32_t* reg = SIM_Reg(model->base + offset);
+    uint32_t ch;
+
+    switch (offset)
+    {
+        case SIM_OFS(LPC_GPDMA_TypeDef, DMACIntTCClear):
+            SIM_DMA(DMACRawIntTCStat) &= ~*reg;
+            *reg = 0;
+            break;
+        case SIM_OFS(LPC_GPDMA_TypeDef, DMACIntErrClr):
+            SIM_DMA(DMACRawIntErrStat) &= ~*reg;
+            *reg = 0;
+            break;
+        case SIM_OFS(LPC_GPDMA_TypeDef, DMACIntStat):
+        case SIM_OFS(LPC_GPDMA_TypeDef, DMACIntTCStat):
+        case SIM_OFS(LPC_GPDMA_TypeDef, DMACIntErrStat):
+        case SIM_OFS(LPC_GPDMA_TypeDef, DMACRawIntTCStat):
+        case SIM_OFS(LPC_GPDMA_TypeDef, DMACRawIntErrStat):
+        case SIM_OFS(LPC_GPDMA_TypeDef, DMACEnbldChns):
+            *reg = prev;                                          /* read-only */
+            break;
+        default:
+            if ((offset >= LPC_GPDMACH0_BASE - LPC_GPDMA_BASE) &&
+                (((offset - (LPC_GPDMACH0_BASE - LPC_GPDMA_BASE)) % 0x20) == SIM_OFS(LPC_GPDMACH_TypeDef, DMACCConfig)))
+            {
+                ch = (offset - (LPC_GPDMACH0_BASE - LPC_GPDMA_BASE)) / 0x20;
+                if (ch >= SIM_DMA_CHANNELS)
+                {
+                    break;
+                }
+                *reg &= ~(1UL << 17);                               /* A: the FIFO is never busy */
+                if ((*reg & SIM_DMA_CFG_E) && (SIM_DMA(DMACConfig) & 1))
+                {
+                    SIM_DMA(DMACEnbldChns) |= 1UL << ch;
+                }
+                else
+                {
+                    *reg &= ~SIM_DMA_CFG_E;
+                    SIM_DMA(DMACEnbldChns) &= ~(1UL << ch);
+                }
+            }
+            break;
+    }
+    sim_dma_lines();
+    sim_dma_service();
+}
+
+static void sim_dma_update(SIM_Model_Type* model)
+{
+    (void)model;
+    sim_dma_lines();
+}
+
+static void sim_dma_reset(SIM_Model_Type* model)
+{
+    (void)model;
+    memset(sim_dma_level, 0, sizeof(sim_dma_level));
+    memset(sim_dma_pulse, 0, sizeof(sim_dma_pulse));
+    sim_dma_busy = 0;
+    sim_dma_again = 0;
+}
+
+static SIM_Model_Type sim_dma_model =
+{
+    LPC_GPDMA_BASE, "GPDMA", sim_dma_reset, NULL, NULL, sim_dma_write, NULL, sim_dma_update, 0
+};
+
+/**
+ * Drive a level sensitive DMA request line (GPDMA_CONN_xxx numbering)
+ *
+ * @param  connection  0..23
+ * @param  level       1: request asserted
+ */
+void SIM_DMARequest(uint8_t connection, uint8_t level)
+{
+    if (connection >= SIM_DMA_CONNS)
+    {
+        return;
+    }
+    sim_dma_level[connection] = (level != 0);
+    if (level)
+    {
+        sim_dma_service();
+    }
+}
+
+/**
+ * Raise a single DMA request that stays latched until a channel serves it
+ * (timer match, DAC time-out)
+ *
+ * @param  connection  0..23
+ */
+void SIM_DMAPulse(uint8_t connection)
+{
+    if (connection >= SIM_DMA_CONNS)
+    {
+        return;
+    }
+    sim_dma_pulse[connection] = 1;
+    sim_dma_service();
+}
+
+
+/*----------------------------------------------------------------------------
+  Default model set
+ *----------------------------------------------------------------------------*/
+/**
+ * Attach every model in this file. Called by SIM_Init(); a test bench may
+ * SIM_DetachModel() the blocks it does not use to run them as plain memory.
+ */
+void SIM_AttachDefaultModels(void)
+{
+    uint8_t i;
+
+    SIM_AttachModel(&sim_sc_model);
+    SIM_AttachModel(&sim_gpio_model);
+    SIM_AttachModel(&sim_gpioint_model);
+    for (i = 0; i < 4; i++)
+    {
+        sim_uart[i].model.reset     = sim_uart_reset;
+        sim_uart[i].model.read      = sim_uart_read;
+        sim_uart[i].model.read_done = sim_uart_read_done;
+        sim_uart[i].model.write     = sim_uart_write;
+        sim_uart[i].model.advance   = sim_uart_advance;
+        sim_uart[i].model.update    = sim_uart_update;
+        SIM_AttachModel(&sim_uart[i].model);
+
+        sim_tim[i].model.reset   = sim_tim_reset;
+        sim_tim[i].model.write   = sim_tim_write;
+        sim_tim[i].model.advance = sim_tim_advance;
+        sim_tim[i].model.update  = sim_tim_update;
+        SIM_AttachModel(&sim_tim[i].model);
+    }
+    for (i = 0; i < 2; i++)
+    {
+        sim_ssp[i].model.reset     = sim_ssp_reset;
+        sim_ssp[i].model.read      = sim_ssp_read;
+        sim_ssp[i].model.read_done = sim_ssp_read_done;
+        sim_ssp[i].model.write     = sim_ssp_write;
+        sim_ssp[i].model.update    = sim_ssp_update;
+        SIM_AttachModel(&sim_ssp[i].model);
+    }
+    for (i = 0; i < 3; i++)
+    {
+        sim_i2c[i].model.reset  = sim_i2c_reset;
+        sim_i2c[i].model.write  = sim_i2c_write;
+        sim_i2c[i].model.update = sim_i2c_update;
+        SIM_AttachModel(&sim_i2c[i].model);
+    }
+    for (i = 0; i < 2; i++)
+    {
+        sim_can[i].model.reset     = sim_can_reset;
+        sim_can[i].model.read_done = sim_can_read_done;
+        sim_can[i].model.write     = sim_can_write;
+        sim_can[i].model.advance   = sim_can_advance;
+        sim_can[i].model.update    = sim_can_update;
+        SIM_AttachModel(&sim_can[i].model);
+    }
+    sim_emac.model.reset   = sim_emac_reset;
+    sim_emac.model.write   = sim_emac_write;
+    sim_emac.model.advance = sim_emac_advance;
+    sim_emac.model.update  = sim_emac_update;
+    SIM_AttachModel(&sim_emac.model);
+    SIM_AttachModel(&sim_adc_model);
+    SIM_AttachModel(&sim_dac_model);
+    SIM_AttachModel(&sim_i2s_model);
+    SIM_AttachModel(&sim_dma_model);
+}
+
+/**
+ * @}
+ */
+
+#endif /* __USE_HOST_SIM */
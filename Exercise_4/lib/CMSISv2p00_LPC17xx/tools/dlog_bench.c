@@ -0,0 +1,181 @@
+/**************************************************************************//**
+ * @file     dlog_bench.c
+ * @brief    Host benchmark of the deferred logger against blocking debug output
+ * @version  V1.00
+ *
+ * @note
+ * Usage: dlog_bench [records]
+ *
+ * First prints the same message, "adc " + a 32-bit decimal + "\n\r", a few
+ * times three ways: through the blocking debug framework (_DBG/_DBD32/_DBG_
+ * on UART0 at 115200 baud, paced as on the target), through the same calls
+ * after DLOG_AttachDebug(), and as one DLOG() call. Each is timed twice.
+ * The simulator only charges time for register accesses, so the DWT cycle
+ * count of simulated time, the "UART wait" column, is the time spent on the
+ * UART and reads 0 when the message never touches it. The logger's own CPU
+ * work is the "host ns" column, from clock_gettime(); for the blocking case
+ * it is mostly the simulator polling the paced UART.
+ * Then times [records] (default 1000000) DLOG_Put() calls of 0 to 4
+ * arguments, and DLOG_Process() per record in binary and text mode, in host
+ * TSC cycles.
+ * Built by "make HOST=1 dlog_bench" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <x86intrin.h>
+
+#include "LPC17xx.h"
+#include "debug_frmwrk.h"
+#include "lpc17xx_dlog.h"
+#include "lpc17xx_prof.h"
+#include "sim_LPC17xx.h"
+
+#define BENCH_MESSAGES    8
+#define BENCH_BATCH       32          /* records per ring fill, 7 words at most each */
+#define BENCH_RUNS        5           /* best of */
+
+static uint64_t sink_bytes;
+
+static uint32_t sink(void* arg, const uint8_t* data, uint32_t len)
+{
+    (void)arg;
+    (void)data;
+    sink_bytes += len;
+    return len;
+}
+
+static void logger_init(uint8_t mode)
+{
+    DLOG_CFG_Type cfg;
+
+    cfg.Mode = mode;
+    cfg.Sink = sink;
+    cfg.SinkArg = NULL;
+    DLOG_Init(&cfg);
+}
+
+static void message_dbg(uint32_t value)
+{
+    _DBG("adc ");
+    _DBD32(value);
+    _DBG_("");
+}
+
+static void message_dlog(uint32_t value)
+{
+    DLOG("adc %u\n\r", value);
+}
+
+/* Mean UART wait in DWT cycles and host time of one message, the UART is emptied in between */
+static void time_message(const char* name, void (*message)(uint32_t value))
+{
+    uint8_t out[64];
+    uint64_t dwt = 0;
+    uint64_t host_ns = 0;
+    uint32_t i;
+
+    for (i = 0; i < BENCH_MESSAGES; i++)
+    {
+        uint32_t start;
+        struct timespec t0, t1;
+
+        SIM_Advance(SystemCoreClock / 100);
+        while (SIM_UART_Drain(0, out, sizeof(out)) != 0)
+        {
+        }
+        DLOG_Process();
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        start = PROF_Start();
+        message(1000000 + i);
+        dwt += DWT->CYCCNT - start;
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        host_ns += (uint64_t)(t1.tv_sec - t0.tv_sec) * 1000000000 + t1.tv_nsec - t0.tv_nsec;
+    }
+    printf("%-28s %10.0f %10.0f\n", name, (double)dwt / BENCH_MESSAGES, (double)host_ns / BENCH_MESSAGES);
+}
+
+/* Best of BENCH_RUNS, host cycles per DLOG_Put() and per record of DLOG_Process() */
+static void time_put(uint32_t nargs, uint32_t n, double* put, double* process)
+{
+    static const uint32_t args[DLOG_MAX_ARGS] = { 1, 22, 333, 4444 };
+    static const char* const fmts[] = { "tick\n", "a %u\n", "a %u b %u\n", "a %u b %u c %u\n",
+                                        "a %u b %u c %u d %x\n" };
+    uint32_t run;
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+        uint64_t put_cycles = 0;
+        uint64_t process_cycles = 0;
+        uint32_t done;
+
+        for (done = 0; done < n; done += BENCH_BATCH)
+        {
+            uint64_t t0 = __rdtsc();
+            uint32_t i;
+
+            for (i = 0; i < BENCH_BATCH; i++)
+            {
+                DLOG_Put(fmts[nargs], nargs, args);
+            }
+            put_cycles += __rdtsc() - t0;
+            t0 = __rdtsc();
+            DLOG_Process();
+            process_cycles += __rdtsc() - t0;
+        }
+        done = n / BENCH_BATCH * BENCH_BATCH;
+        if (run == 0 || (double)put_cycles / done < *put)
+        {
+            *put = (double)put_cycles / done;
+        }
+        if (run == 0 || (double)process_cycles / done < *process)
+        {
+            *process = (double)process_cycles / done;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t n = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000000;
+    DLOG_STATS_Type stats;
+    uint32_t nargs;
+
+    SIM_Init();
+    SystemInit();
+    debug_frmwrk_init();
+    SIM_UART_SetPaced(0, 1);
+    PROF_Init();
+    logger_init(DLOG_MODE_TEXT);
+
+    printf("one message, mean of %-7u %10s %10s\n", BENCH_MESSAGES, "UART wait", "host ns");
+    time_message("_DBG, blocking UART", message_dbg);
+    DLOG_AttachDebug();
+    time_message("_DBG after DLOG_AttachDebug", message_dbg);
+    time_message("DLOG()", message_dlog);
+
+    printf("\n%u records, best of %u, host TSC cycles per record\n", (unsigned)n, BENCH_RUNS);
+    printf("args  DLOG_Put  Process text  Process binary\n");
+    SIM_UART_SetPaced(0, 0);
+    for (nargs = 0; nargs <= DLOG_MAX_ARGS; nargs++)
+    {
+        double put_text = 0, process_text = 0, put_bin = 0, process_bin = 0;
+
+        logger_init(DLOG_MODE_TEXT);
+        time_put(nargs, n, &put_text, &process_text);
+        logger_init(DLOG_MODE_BINARY);
+        time_put(nargs, n, &put_bin, &process_bin);
+        printf("%4u %9.1f %13.1f %15.1f\n", (unsigned)nargs, (put_text < put_bin) ? put_text : put_bin,
+               process_text, process_bin);
+    }
+    DLOG_GetStats(&stats);
+    if (stats.Dropped != 0)
+    {
+        fprintf(stderr, "dlog_bench: %u records dropped\n", (unsigned)stats.Dropped);
+        return 1;
+    }
+    return 0;
+}
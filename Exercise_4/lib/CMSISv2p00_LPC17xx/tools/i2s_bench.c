@@ -0,0 +1,413 @@
+/**************************************************************************//**
+ * @file     i2s_bench.c
+ * @brief    Host benchmark of the I2SDMA audio stream, direct and resampled
+ * @version  V1.00
+ *
+ * @note
+ * Usage: i2s_bench [ms] [buffer words]
+ *
+ * Streams 48 kHz 16-bit stereo in duplex through I2SDMA for [ms] (default
+ * 500) of simulated time, buffers of [buffer words] (default 96, two halves
+ * of 1 ms) on each side, the receiver looped to the transmitter by the half
+ * buffer callback. The run is made twice:
+ * - direct:    each received word carries its index, the callback copies
+ *              the half straight through
+ * - resampled: a 200 Hz to 3 kHz sweep on the left channel and a 1 kHz tone
+ *              on the right, the callback converts the half down to 16 kHz
+ *              with RESAMPLE_Down() and back up with RESAMPLE_Up(), 48 tap
+ *              Blackman windowed sinc filters
+ * For each it prints the input-to-output latency in frames and ms (the
+ * direct run follows every word, the resampled run finds the lag that best
+ * matches the output to the sweep, which does not repeat as a tone would),
+ * its jitter in core cycles, the I2S FIFO
+ * underruns and overruns, the halves the callback lost and the interrupt
+ * rate. The callback is charged BENCH_MAC_CYCLES per multiply-accumulate
+ * and BENCH_SAMPLE_CYCLES per sample moved, its worst case is given as a
+ * share of the half buffer period. The resampled run also prints the
+ * signal-to-error ratio of the round trip and the host time per half.
+ * Built by "make HOST=1 i2s_bench" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "LPC17xx.h"
+#include "sim_LPC17xx.h"
+#include "lpc17xx_gpdma.h"
+#include "lpc17xx_i2sdma.h"
+#include "lpc17xx_resample.h"
+
+#define BENCH_RATE            48000
+#define BENCH_FACTOR          3           /* 48 kHz to 16 kHz */
+#define BENCH_TAPS            48
+#define BENCH_CUTOFF          7000.0      /* Hz, below the 8 kHz Nyquist of the low rate */
+#define BENCH_MAX_WORDS       2048
+#define BENCH_MAX_LAG         4096        /* frames */
+#define BENCH_MAC_CYCLES      3           /* two loads and a multiply-accumulate on the Cortex-M3 */
+#define BENCH_SAMPLE_CYCLES   4
+#define BENCH_SWEEP_FROM      200.0
+#define BENCH_SWEEP_TO        3000.0
+#define BENCH_TONE            1000.0
+#define BENCH_AMPLITUDE       12000.0
+
+/* One streaming run */
+typedef struct
+{
+    const char* name;
+    uint8_t resample;
+    uint32_t lag;                   /* frames */
+    uint64_t jitter;                /* core cycles */
+    uint32_t underruns;
+    uint32_t overruns;
+    uint32_t lost;
+    uint64_t irqs;
+    uint64_t cycles;
+    uint64_t cb_max;                /* core cycles */
+    uint64_t host_ns;
+    uint32_t blocks;
+    double snr;
+} Bench_Type;
+
+static I2SDMA_Type stream;
+static RESAMPLE_Type rs;
+static uint32_t words;
+static uint32_t run_ms;
+static uint8_t resampling;
+
+static int16_t tx_buf[I2SDMA_SAMPLES(BENCH_MAX_WORDS)];
+static int16_t rx_buf[I2SDMA_SAMPLES(BENCH_MAX_WORDS)];
+static q15_t low_buf[I2SDMA_SAMPLES(BENCH_MAX_WORDS) / BENCH_FACTOR];
+static q15_t down_coeffs[BENCH_TAPS];
+static q15_t up_coeffs[BENCH_TAPS];
+static q15_t rs_state[RESAMPLE_STATE_SIZE(2, BENCH_TAPS, BENCH_FACTOR, BENCH_MAX_WORDS / 2)];
+
+/* Word clock bookkeeping: the receiver and the transmitter run on the same
+ * edges, every word is numbered on either side */
+static uint64_t rx_cycle[BENCH_MAX_LAG];
+static uint32_t rx_count;
+static uint32_t tx_count;
+static uint64_t lat_min, lat_max;
+static uint32_t lag_min, lag_max;
+static uint32_t gaps;
+static int16_t* rx_left;              /* left samples received and sent, resampled run */
+static int16_t* tx_left;
+static uint32_t cap;
+static uint64_t cb_max;
+static uint64_t host_ns;
+static uint32_t blocks;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int16_t tone(uint32_t frame)
+{
+    return (int16_t)lrint(BENCH_AMPLITUDE * sin(2.0 * M_PI * BENCH_TONE * frame / BENCH_RATE));
+}
+
+/* Linear sweep over the run length, going on past it */
+static int16_t sweep(uint32_t frame)
+{
+    double t = (double)frame / BENCH_RATE, span = run_ms / 1000.0;
+
+    return (int16_t)lrint(BENCH_AMPLITUDE *
+                          sin(2.0 * M_PI * (BENCH_SWEEP_FROM * t + (BENCH_SWEEP_TO - BENCH_SWEEP_FROM) * t * t / (2.0 * span))));
+}
+
+/* Direct run: word n + 1 is the n-th word received, 0 is silence */
+static uint32_t source(uint64_t cycle)
+{
+    uint32_t n = rx_count++;
+    int16_t left;
+
+    rx_cycle[n % BENCH_MAX_LAG] = cycle;
+    if (resampling)
+    {
+        left = sweep(n);
+        if (n < cap)
+        {
+            rx_left[n] = left;
+        }
+        return (uint16_t)left | ((uint32_t)(uint16_t)tone(n) << 16);
+    }
+    return n + 1;
+}
+
+static void sink(uint32_t word, uint64_t cycle)
+{
+    static uint32_t last;
+    uint32_t n = tx_count++, lag;
+    uint64_t lat;
+
+    if (resampling)
+    {
+        if (n < cap)
+        {
+            tx_left[n] = (int16_t)word;
+        }
+        return;
+    }
+    if (word == 0)
+    {
+        return;
+    }
+    if ((last != 0) && (word != last + 1))
+    {
+        gaps++;
+    }
+    last = word;
+    lag = n - (word - 1);
+    lat = cycle - rx_cycle[(word - 1) % BENCH_MAX_LAG];
+    if ((lag_max == 0) || (lat < lat_min))
+    {
+        lat_min = lat;
+    }
+    if (lat > lat_max)
+    {
+        lat_max = lat;
+    }
+    if ((lag_max == 0) || (lag < lag_min))
+    {
+        lag_min = lag;
+    }
+    if (lag > lag_max)
+    {
+        lag_max = lag;
+    }
+}
+
+static void on_half(const int16_t* rx, int16_t* tx, uint32_t samples)
+{
+    uint64_t c0 = SIM_GetCycles(), t0;
+
+    if (!resampling)
+    {
+        memcpy(tx, rx, samples * sizeof(int16_t));
+        SIM_Advance(samples * BENCH_SAMPLE_CYCLES);
+    }
+    else
+    {
+        /* Processing at 16 kHz would go between the two conversions */
+        t0 = now_ns();
+        RESAMPLE_Down(&rs, rx, low_buf);
+        RESAMPLE_Up(&rs, low_buf, tx);
+        host_ns += now_ns() - t0;
+        blocks++;
+        /* NumTaps multiply-accumulates per low rate output of the decimator,
+         * NumTaps / Factor per high rate output of the interpolator. The samples
+         * are moved four times by the de-interleaving and re-interleaving */
+        SIM_Advance(2 * samples / BENCH_FACTOR * BENCH_TAPS * BENCH_MAC_CYCLES + 4 * samples * BENCH_SAMPLE_CYCLES);
+    }
+    if (SIM_GetCycles() - c0 > cb_max)
+    {
+        cb_max = SIM_GetCycles() - c0;
+    }
+}
+
+void DMA_IRQHandler(void)
+{
+    I2SDMA_IntHandler(&stream);
+}
+
+/* Blackman windowed sinc low-pass at BENCH_CUTOFF, DC gain [gain] */
+static void design(q15_t* h, double gain)
+{
+    double d[BENCH_TAPS], sum = 0.0, x, w;
+    uint32_t n;
+
+    for (n = 0; n < BENCH_TAPS; n++)
+    {
+        x = n - (BENCH_TAPS - 1) / 2.0;
+        w = 0.42 - 0.5 * cos(2.0 * M_PI * n / (BENCH_TAPS - 1)) + 0.08 * cos(4.0 * M_PI * n / (BENCH_TAPS - 1));
+        d[n] = w * sin(2.0 * M_PI * BENCH_CUTOFF / BENCH_RATE * x) / (M_PI * x);
+        sum += d[n];
+    }
+    for (n = 0; n < BENCH_TAPS; n++)
+    {
+        x = lrint(d[n] * gain / sum * 32768.0);
+        h[n] = (q15_t)((x > 32767.0) ? 32767 : x);
+    }
+}
+
+/* Lag of the sent left channel behind the received one, and the signal-to-error ratio there */
+static void match(Bench_Type* b)
+{
+    uint32_t n = (tx_count < cap) ? tx_count : cap;
+    uint32_t lag, i, from;
+    double err, sig, ref, best = -1.0;
+
+    if (n > rx_count)
+    {
+        n = rx_count;
+    }
+    for (lag = 0; lag < BENCH_MAX_LAG / 4; lag++)
+    {
+        from = lag + BENCH_RATE / 100;          /* past the filter start-up */
+        err = sig = 0.0;
+        for (i = from; i < n; i++)
+        {
+            ref = rx_left[i - lag];
+            sig += ref * ref;
+            err += (tx_left[i] - ref) * (tx_left[i] - ref);
+        }
+        if ((sig > 0.0) && ((best < 0.0) || (err / sig < best)))
+        {
+            best = err / sig;
+            b->lag = lag;
+        }
+    }
+    b->snr = (best > 0.0) ? -10.0 * log10(best) : INFINITY;
+}
+
+static void run(Bench_Type* b)
+{
+    I2SDMA_CFG_Type cfg;
+    RESAMPLE_CFG_Type rs_cfg;
+    uint64_t irq0, c0;
+
+    SIM_Reset();
+    SystemInit();
+    GPDMA_Init();
+    SIM_I2S_SetSource(source);
+    SIM_I2S_SetSink(sink);
+
+    resampling = b->resample;
+    rx_count = tx_count = 0;
+    lag_min = lag_max = 0;
+    lat_min = lat_max = 0;
+    gaps = 0;
+    cb_max = 0;
+    host_ns = 0;
+    blocks = 0;
+
+    if (resampling)
+    {
+        rs_cfg.Factor = BENCH_FACTOR;
+        rs_cfg.Channels = 2;
+        rs_cfg.NumTaps = BENCH_TAPS;
+        rs_cfg.BlockSize = (uint16_t)(words / 2);
+        rs_cfg.DownCoeffs = down_coeffs;
+        rs_cfg.UpCoeffs = up_coeffs;
+        rs_cfg.State = rs_state;
+        if (RESAMPLE_Init(&rs, &rs_cfg) != SUCCESS)
+        {
+            fprintf(stderr, "i2s_bench: RESAMPLE_Init failed, %u words per half is not a multiple of %u\n",
+                    (unsigned)(words / 2), (unsigned)BENCH_FACTOR);
+            exit(1);
+        }
+    }
+
+    cfg.Rate = BENCH_RATE;
+    cfg.Mono = I2S_STEREO;
+    cfg.Direction = I2SDMA_DUPLEX;
+    cfg.TxDMAChannel = 0;
+    cfg.RxDMAChannel = 1;
+    cfg.TxBuffer = tx_buf;
+    cfg.RxBuffer = rx_buf;
+    cfg.BufferSize = (uint16_t)words;
+    cfg.Callback = on_half;
+    if (I2SDMA_Init(&stream, &cfg) != SUCCESS)
+    {
+        fprintf(stderr, "i2s_bench: I2SDMA_Init failed\n");
+        exit(1);
+    }
+    NVIC_EnableIRQ(DMA_IRQn);
+
+    irq0 = SIM_GetIRQCount(DMA_IRQn);
+    c0 = SIM_GetCycles();
+    I2SDMA_Start(&stream);
+    SIM_Advance(run_ms * (SystemCoreClock / 1000));
+    I2SDMA_Stop(&stream);
+
+    /* The callback charges come on top of the run */
+    b->cycles = SIM_GetCycles() - c0;
+    b->irqs = SIM_GetIRQCount(DMA_IRQn) - irq0;
+    b->lost = I2SDMA_GetOverruns(&stream);
+    SIM_I2S_GetErrors(&b->underruns, &b->overruns);
+    b->cb_max = cb_max;
+    b->host_ns = host_ns;
+    b->blocks = blocks;
+    if (resampling)
+    {
+        match(b);
+    }
+    else
+    {
+        if ((gaps != 0) || (lag_min != lag_max))
+        {
+            fprintf(stderr, "i2s_bench: %u gaps in the word sequence, lag %u to %u frames\n", (unsigned)gaps,
+                    (unsigned)lag_min, (unsigned)lag_max);
+            exit(1);
+        }
+        b->lag = lag_max;
+        b->jitter = lat_max - lat_min;
+    }
+}
+
+static void report(Bench_Type* b)
+{
+    double half_cycles = (double)SystemCoreClock * (words / 2) / BENCH_RATE;
+
+    printf("%-9s %6u %7.3f ", b->name, (unsigned)b->lag, 1000.0 * b->lag / BENCH_RATE);
+    if (b->resample)
+    {
+        printf("%7s", "-");                     /* the lag is found to the frame only */
+    }
+    else
+    {
+        printf("%7u", (unsigned)b->jitter);
+    }
+    printf(" %6u %6u %5u %8.0f %8.1f%%", (unsigned)b->underruns, (unsigned)b->overruns, (unsigned)b->lost,
+           (double)b->irqs * SystemCoreClock / b->cycles, 100.0 * b->cb_max / half_cycles);
+    if (b->resample)
+    {
+        printf(" %7.1f dB %6.2f us", b->snr, (double)b->host_ns / b->blocks / 1000.0);
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    Bench_Type direct = { "direct", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0.0 };
+    Bench_Type resampled = { "resampled", 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0.0 };
+
+    run_ms = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 500;
+    words = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 96;
+    if (!PARAM_I2SDMA_SIZE(words) || (words > BENCH_MAX_WORDS))
+    {
+        fprintf(stderr, "i2s_bench: buffer of %u words, even and at most %u\n", (unsigned)words,
+                (unsigned)BENCH_MAX_WORDS);
+        return 1;
+    }
+    cap = run_ms * (BENCH_RATE / 1000) + BENCH_RATE;
+    rx_left = malloc(cap * sizeof(int16_t));
+    tx_left = malloc(cap * sizeof(int16_t));
+    if ((rx_left == NULL) || (tx_left == NULL))
+    {
+        fprintf(stderr, "i2s_bench: out of memory\n");
+        return 1;
+    }
+    design(down_coeffs, 1.0);
+    design(up_coeffs, BENCH_FACTOR);
+
+    SIM_Init();
+    run(&direct);
+    run(&resampled);
+
+    printf("%u Hz stereo duplex, %u ms, buffers of %u words (%.2f ms per half), %u MHz core\n", (unsigned)BENCH_RATE,
+           (unsigned)run_ms, (unsigned)words, 1000.0 * (words / 2) / BENCH_RATE,
+           (unsigned)(SystemCoreClock / 1000000));
+    printf("run        frames      ms  jitter  under   over  lost  irq/s  callback      SNR  host/half\n");
+    report(&direct);
+    report(&resampled);
+    return 0;
+}
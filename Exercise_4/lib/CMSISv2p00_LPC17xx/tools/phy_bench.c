@@ -0,0 +1,199 @@
+/**************************************************************************//**
+ * @file     phy_bench.c
+ * @brief    Host benchmark of the EMAC boot time, blocking against ticked PHY
+ * @version  V1.00
+ *
+ * @note
+ * Usage: phy_bench [auto-negotiation ms] [other init ms]
+ *
+ * Boots the simulated board twice with a PHY that takes 1 ms to reset and
+ * [auto-negotiation ms] (default 500) to negotiate, MII transactions taking
+ * their 64 MDC periods:
+ * - blocking: EMAC_Init(), then the other peripherals
+ * - async:    EMAC_InitAsync() with EMAC_PHYTick() run from a 1 ms SysTick,
+ *             the other peripherals brought up meanwhile
+ * Bringing up the other peripherals is stood in for by [other init ms]
+ * (default 50) of simulated work. The board is ready once both the link is
+ * up and the other peripherals are. It prints, in simulated time, when
+ * EMAC initialization returned, when the other peripherals were ready, when
+ * the link came up and the boot-to-ready time, then the processor time the
+ * ticks took and how fast a pulled and replugged cable is seen.
+ * The blocking run charges 256 cycles per register access: its busy-waits
+ * then poll the MII a few times per transaction instead of a thousand, so
+ * the host gets through the negotiation in seconds. Each poll of it is seen
+ * a little later, which is noise next to the negotiation. The async run
+ * charges 4 cycles, about what an access costs on the target.
+ * Built by "make HOST=1 phy_bench" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "LPC17xx.h"
+#include "sim_LPC17xx.h"
+#include "lpc17xx_emac.h"
+
+#define BENCH_RESET_US          1000
+#define BENCH_BLOCKING_COST     256         /* cycles per trapped access, blocking run */
+#define BENCH_ASYNC_COST        4           /* cycles per trapped access, async run */
+#define BENCH_TICK_HZ           1000
+#define BENCH_POLL_INTERVAL     10          /* ticks between link status reads */
+#define BENCH_RESET_TIMEOUT     100         /* ticks */
+
+/* Times of one boot, cycles from its start */
+typedef struct
+{
+    const char* name;
+    uint64_t init;
+    uint64_t others;
+    uint64_t link;
+} Bench_Type;
+
+static uint32_t aneg_ms;
+static uint32_t other_ms;
+static volatile uint64_t link_at;
+static volatile uint32_t link_bits;
+static uint64_t tick_cycles;
+static uint32_t ticks;
+
+void SysTick_Handler(void)
+{
+    uint64_t c0 = SIM_GetCycles();
+
+    EMAC_PHYTick();
+    tick_cycles += SIM_GetCycles() - c0;
+    ticks++;
+}
+
+static void on_link(uint32_t link)
+{
+    link_bits = link;
+    link_at = SIM_GetCycles();
+}
+
+static double ms(uint64_t cycles)
+{
+    return (double)cycles * 1000.0 / (double)SystemCoreClock;
+}
+
+/* Let the ticks run until the link is as wanted, at most 10 s */
+static void wait_link(uint32_t up)
+{
+    uint64_t limit = SIM_GetCycles() + 10ULL * SystemCoreClock;
+
+    while (((link_bits & EMAC_LINK_UP) != up) && (SIM_GetCycles() < limit))
+    {
+        __WFI();
+    }
+    if ((link_bits & EMAC_LINK_UP) != up)
+    {
+        fprintf(stderr, "phy_bench: link never went %s, PHY state %d\n", up ? "up" : "down",
+                (int)EMAC_GetPHYState());
+        exit(1);
+    }
+}
+
+static void boot(void)
+{
+    SIM_Reset();
+    SystemInit();
+    SIM_EMAC_SetPHYTiming(BENCH_RESET_US, aneg_ms * 1000);
+    SIM_EMAC_SetLink(1);
+}
+
+static void run_blocking(Bench_Type* b, EMAC_CFG_Type* cfg)
+{
+    uint64_t c0;
+
+    boot();
+    SIM_SetAccessCost(BENCH_BLOCKING_COST);
+    c0 = SIM_GetCycles();
+    if (EMAC_Init(cfg) != SUCCESS)
+    {
+        fprintf(stderr, "phy_bench: EMAC_Init failed\n");
+        exit(1);
+    }
+    b->init = b->link = SIM_GetCycles() - c0;
+    SIM_SetAccessCost(BENCH_ASYNC_COST);
+    if (EMAC_CheckPHYStatus(EMAC_PHY_STAT_LINK) != 1)
+    {
+        fprintf(stderr, "phy_bench: no link after EMAC_Init\n");
+        exit(1);
+    }
+    SIM_Advance(other_ms * (SystemCoreClock / 1000));
+    b->others = SIM_GetCycles() - c0;
+}
+
+static void run_async(Bench_Type* b, EMAC_CFG_Type* cfg)
+{
+    EMAC_PHY_CFG_Type phy = { BENCH_RESET_TIMEOUT, BENCH_POLL_INTERVAL, on_link };
+    uint64_t c0;
+
+    boot();
+    SIM_SetAccessCost(BENCH_ASYNC_COST);
+    link_bits = 0;
+    tick_cycles = 0;
+    ticks = 0;
+    SysTick_Config(SystemCoreClock / BENCH_TICK_HZ);
+    c0 = SIM_GetCycles();
+    if (EMAC_InitAsync(cfg, &phy) != SUCCESS)
+    {
+        fprintf(stderr, "phy_bench: EMAC_InitAsync failed\n");
+        exit(1);
+    }
+    b->init = SIM_GetCycles() - c0;
+    SIM_Advance(other_ms * (SystemCoreClock / 1000));
+    b->others = SIM_GetCycles() - c0;
+    wait_link(EMAC_LINK_UP);
+    b->link = link_at - c0;
+}
+
+static void report(Bench_Type* b)
+{
+    printf("%-9s %10.3f ms %10.1f ms %10.1f ms %10.1f ms\n", b->name, ms(b->init), ms(b->others), ms(b->link),
+           ms((b->others > b->link) ? b->others : b->link));
+}
+
+int main(int argc, char** argv)
+{
+    static uint8_t mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+    EMAC_CFG_Type cfg = { EMAC_MODE_AUTO, mac };
+    Bench_Type blocking = { "blocking", 0, 0, 0 };
+    Bench_Type async = { "async", 0, 0, 0 };
+    uint64_t c0, down, up;
+    uint32_t boot_ticks;
+    double boot_tick_cycles;
+
+    aneg_ms = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 500;
+    other_ms = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 50;
+
+    SIM_Init();
+    run_blocking(&blocking, &cfg);
+    run_async(&async, &cfg);
+    boot_ticks = ticks;
+    boot_tick_cycles = (double)tick_cycles;
+
+    /* Cable pulled, then plugged back in */
+    c0 = SIM_GetCycles();
+    SIM_EMAC_SetLink(0);
+    wait_link(0);
+    down = link_at - c0;
+    c0 = SIM_GetCycles();
+    SIM_EMAC_SetLink(1);
+    wait_link(EMAC_LINK_UP);
+    up = link_at - c0;
+
+    printf("PHY reset %u us, auto-negotiation %u ms, other peripherals %u ms, %u MHz core\n",
+           (unsigned)BENCH_RESET_US, (unsigned)aneg_ms, (unsigned)other_ms, (unsigned)(SystemCoreClock / 1000000));
+    printf("%-9s %13s %13s %13s %13s\n", "", "EMAC init", "others ready", "link up", "boot to ready");
+    report(&blocking);
+    report(&async);
+    printf("async PHY management: %u ticks to link up, %.0f cycles per tick, %.3f%% of the processor at %u Hz\n",
+           (unsigned)boot_ticks, boot_tick_cycles / boot_ticks,
+           100.0 * boot_tick_cycles / boot_ticks * BENCH_TICK_HZ / SystemCoreClock, (unsigned)BENCH_TICK_HZ);
+    printf("cable pulled: link down seen after %.1f ms; plugged back: link up after %.1f ms, 0x%x\n", ms(down), ms(up),
+           (unsigned)link_bits);
+    return 0;
+}
@@ -0,0 +1,249 @@
+/**************************************************************************//**
+ * @file     stdio_check.c
+ * @brief    Host check of the STDIO console buffering and the newlib stubs
+ * @version  V1.00
+ *
+ * @note
+ * Usage: stdio_check
+ *
+ * Builds the application's newlib stubs (../../../src/newlib_stubs.c) into
+ * the program, their allocator and _exit renamed out of the way of the C
+ * library, and writes and reads through _write() and _read() as newlib
+ * does. A recording transport stands for the UART, the halting one for
+ * semihosting. Checks that a halting transport only gets the output at the
+ * end of a line, on a full buffer and on STDIO_Flush(), that stderr is
+ * flushed at once, that an interrupt never calls a halting transport and
+ * drops what does not fit, that a transport that does not halt gets the
+ * bytes at once as far as it takes them, that _read() flushes a pending
+ * prompt before reading stdin, that other descriptors fail with EBADF and
+ * that the trace transport keeps the newest bytes. Prints one line per case
+ * and exits non zero if any fails.
+ * Built by "make HOST=1 stdio_check" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "LPC17xx.h"
+#include "lpc17xx_stdio.h"
+#include "sim_LPC17xx.h"
+
+/* The stubs replace the allocator and _exit of the C library on the target */
+#define malloc            stubs_malloc
+#define free              stubs_free
+#define realloc           stubs_realloc
+#define calloc            stubs_calloc
+#define _exit             stubs_exit
+#define environ           stubs_environ
+#include "../../../src/newlib_stubs.c"
+#undef malloc
+#undef free
+#undef realloc
+#undef calloc
+#undef _exit
+#undef environ
+
+int errno;                                /* the stubs' errno, not the C library's */
+char _ebss;                               /* linker script symbols of the heap region */
+char _vStackTop;
+
+#define CHECK_LOG_SIZE    1024
+#define CHECK_IRQ         TIMER3_IRQn
+
+/* Recording transport: what was handed over, and the number of calls */
+static uint8_t out_log[CHECK_LOG_SIZE];
+static uint32_t out_len;
+static uint32_t out_calls;
+static uint32_t out_limit;                /* bytes taken per call, 0: all */
+static uint32_t out_irq_calls;            /* calls made from an interrupt */
+static const char* in_data;
+static uint32_t in_len;
+static uint32_t in_out_len;               /* output handed over before the first read */
+static STDIO_TRANSPORT_Type transport;
+static uint32_t failures;
+
+static uint32_t rec_write(void* arg, const uint8_t* data, uint32_t len)
+{
+    if (out_limit != 0 && len > out_limit)
+    {
+        len = out_limit;
+    }
+    if (out_len + len > CHECK_LOG_SIZE)
+    {
+        len = CHECK_LOG_SIZE - out_len;
+    }
+    memcpy(&out_log[out_len], data, len);
+    out_len += len;
+    out_calls++;
+    if (__get_IPSR() != 0)
+    {
+        out_irq_calls++;
+    }
+    return len;
+}
+
+static uint32_t rec_read(void* arg, uint8_t* data, uint32_t len)
+{
+    if (in_out_len == (uint32_t)-1)
+    {
+        in_out_len = out_len;
+    }
+    if (len > in_len)
+    {
+        len = in_len;
+    }
+    memcpy(data, in_data, len);
+    in_data += len;
+    in_len -= len;
+    return len;
+}
+
+static void start(uint8_t halts, uint32_t limit)
+{
+    out_len = 0;
+    out_calls = 0;
+    out_irq_calls = 0;
+    out_limit = limit;
+    in_out_len = (uint32_t)-1;
+    transport.Write = rec_write;
+    transport.Read = rec_read;
+    transport.Arg = NULL;
+    transport.Halts = halts;
+    STDIO_Init(&transport);
+}
+
+static void check(const char* name, int ok)
+{
+    printf("%-44s %s\n", name, ok ? "PASS" : "FAIL");
+    if (!ok)
+    {
+        failures++;
+    }
+}
+
+static int logged(const char* text)
+{
+    return (out_len == strlen(text)) && (memcmp(out_log, text, out_len) == 0);
+}
+
+static void fill(char* buf, uint32_t len, uint32_t seed)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        buf[i] = (char)('a' + (seed + i) % 26);
+    }
+}
+
+/* Interrupt writes of the last case */
+static const char* irq_text;
+static int irq_len;
+
+void TIMER3_IRQHandler(void)
+{
+    _write(STDOUT_FILENO, (char*)irq_text, irq_len);
+}
+
+static void irq_write(const char* text, int len)
+{
+    irq_text = text;
+    irq_len = len;
+    NVIC_EnableIRQ(CHECK_IRQ);
+    NVIC_SetPendingIRQ(CHECK_IRQ);
+    SIM_ServiceIRQ();
+    NVIC_DisableIRQ(CHECK_IRQ);
+}
+
+int main(void)
+{
+    static char big[600];
+    static char in[16];
+    STDIO_STATS_Type stats;
+    int n;
+
+    SIM_Init();
+    SystemInit();
+
+    /* No transport yet: the output is discarded and counted */
+    STDIO_Init(NULL);
+    n = _write(STDOUT_FILENO, "lost", 4);
+    STDIO_GetStats(&stats);
+    check("no transport drops", n == 4 && stats.Dropped == 4 && stats.Flushes == 0);
+
+    /* Halting transport: held back until the end of the line */
+    start(1, 0);
+    _write(STDOUT_FILENO, "abc", 3);
+    check("halting: no output before the newline", out_calls == 0);
+    _write(STDOUT_FILENO, "def\nx", 5);
+    check("halting: one call at the newline", out_calls == 1 && logged("abcdef\nx"));
+
+    /* stderr is flushed at once, behind the pending stdout bytes */
+    start(1, 0);
+    _write(STDOUT_FILENO, "out ", 4);
+    n = _write(STDERR_FILENO, "err", 3);
+    check("stderr flushed at once", n == 3 && logged("out err"));
+
+    /* A full buffer is handed over, the rest on STDIO_Flush() */
+    start(1, 0);
+    fill(big, STDIO_BUFFER_SIZE + 44, 0);
+    _write(STDOUT_FILENO, big, STDIO_BUFFER_SIZE + 44);
+    check("halting: full buffer handed over", out_len == STDIO_BUFFER_SIZE);
+    STDIO_Flush();
+    STDIO_GetStats(&stats);
+    check("halting: rest on STDIO_Flush()", out_len == STDIO_BUFFER_SIZE + 44
+          && memcmp(out_log, big, out_len) == 0 && stats.HighWater == STDIO_BUFFER_SIZE);
+
+    /* A transport that does not halt takes the bytes at once, 16 per call */
+    start(0, 16);
+    fill(big, 100, 3);
+    _write(STDOUT_FILENO, big, 100);
+    check("non halting: written at once in pieces", out_len == 100 && memcmp(out_log, big, 100) == 0
+          && out_calls == 7);
+
+    /* _read() flushes the prompt first, then reads stdin */
+    start(1, 0);
+    in_data = "42\n";
+    in_len = 3;
+    _write(STDOUT_FILENO, "value? ", 7);
+    n = _read(STDIN_FILENO, in, sizeof(in));
+    check("_read() flushes the prompt and reads stdin", n == 3 && memcmp(in, "42\n", 3) == 0 && in_out_len == 7);
+
+    /* Other descriptors */
+    errno = 0;
+    n = _write(3, "x", 1);
+    check("_write() to another descriptor fails", n == -1 && errno == EBADF);
+    errno = 0;
+    n = _read(STDOUT_FILENO, in, sizeof(in));
+    check("_read() from stdout fails", n == -1 && errno == EBADF);
+
+    /* An interrupt never calls a halting transport, and drops what does not fit */
+    start(1, 0);
+    fill(big, STDIO_BUFFER_SIZE + 10, 5);
+    irq_write(big, 10);
+    check("interrupt: halting transport not called", out_calls == 0);
+    irq_write(big + 10, STDIO_BUFFER_SIZE);
+    STDIO_GetStats(&stats);
+    check("interrupt: overflow dropped", out_calls == 0 && stats.Dropped == 10);
+    STDIO_Flush();
+    check("interrupt: thread flush hands it over", out_irq_calls == 0 && out_len == STDIO_BUFFER_SIZE
+          && memcmp(out_log, big, out_len) == 0);
+
+    /* Trace transport: the newest STDIO_TRACE_SIZE bytes */
+    STDIO_TransportTrace(&transport);
+    STDIO_Init(&transport);
+    fill(big, sizeof(big), 7);
+    for (n = 0; n < 4; n++)
+    {
+        _write(STDOUT_FILENO, big, sizeof(big));
+    }
+    check("trace keeps the newest bytes", STDIO_Trace.Magic == STDIO_TRACE_MAGIC
+          && STDIO_Trace.Head == 4 * sizeof(big)
+          && memcmp(&STDIO_Trace.Data[(STDIO_Trace.Head - sizeof(big)) % STDIO_TRACE_SIZE], big,
+                    STDIO_TRACE_SIZE - (STDIO_Trace.Head - sizeof(big)) % STDIO_TRACE_SIZE) == 0);
+
+    printf("%u checks failed\n", (unsigned)failures);
+    return (failures != 0) ? 1 : 0;
+}
@@ -19,6 +19,9 @@
 #include "lpc17xx_systick.h" /* Systic * SEk handling */
 #include "lpc17xx_timer.h"   /* Timer handling */
 #include "lpc17xx_adc.h"     /* ADC handling */
+#include "lpc17xx_gpdma.h"   /* DMA handling */
+#include "lpc17xx_adcdma.h"  /* ADC acquisition through DMA */
+#include "lpc17xx_prof.h"    /* Cycle counter profiling */
 
 /* Pin Definitions */
 
@@ -41,7 +44,17 @@
 #define SECOND_IN_US 1000000 /* 1 second in [us] */
 
 /* ADC frequency */
-#define ADC_FREQ 100000 /* ADC frequency in [Hz] */
+#define ADC_FREQ 200000 /* ADC frequency in [Hz] */
+
+/* ADC acquisition */
+#define ADC_DMA_CHANNEL 0   /* GPDMA channel that moves the conversions */
+#define ADC_BUFFER_SIZE 512 /* Samples in the ping-pong buffer, two halves */
+
+/* Profiling probes */
+#define PROF_EINT3 0  /* EINT3_IRQHandler duration */
+#define PROF_TIMER0 1 /* TIMER0_IRQHandler duration */
+#define PROF_ADC 2    /* ADC_IRQHandler duration */
+#define PROF_DMA 3    /* DMA_IRQHandler duration */
 
 /* Port 0 */
 #define RED_LED_PIN ((uint32_t)(1 << 22))   /* P0.20 connected to RED_LED */
@@ -49,7 +62,9 @@
 #define BLUE_LED_PIN ((uint32_t)(1 << 21))  /* P0.22 connected to BLUE_LED */
 #define ADC_INPUT ((uint32_t)(1 << 2))      /* P0.2 connected to ADC_INPUT */
 
-static uint32_t adc_value = 0;
+static uint32_t adc_value = 0;               /* Mean of the last half buffer */
+static uint32_t adc_buffer[ADC_BUFFER_SIZE]; /* Ping-pong buffer, filled by DMA */
+static ADCDMA_Type adc_acquisition;          /* Continuous acquisition of AD0.7 */
 
 /**
  * @brief Initialize the GPIO peripherals
@@ -57,24 +72,14 @@ static uint32_t adc_value = 0;
  */
 void configure_GPIO_ports(void)
 {
-    PINSEL_CFG_Type pin_cfg;
-
-    pin_cfg.Portnum = PINSEL_PORT_0;
-    pin_cfg.Pinnum = PINSEL_PIN_20;
-    pin_cfg.Funcnum = PINSEL_FUNC_0;
-    pin_cfg.Pinmode = PINSEL_PINMODE_PULLUP;
-    pin_cfg.OpenDrain = PINSEL_PINMODE_NORMAL;
-    PINSEL_ConfigPin(&pin_cfg);
-
-    pin_cfg.Pinnum = PINSEL_PIN_21;
-    PINSEL_ConfigPin(&pin_cfg);
-
-    pin_cfg.Pinnum = PINSEL_PIN_22;
-    PINSEL_ConfigPin(&pin_cfg);
+    static const PINSEL_CFG_Type pin_table[] = {
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_20, PINSEL_FUNC_0, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL),
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_21, PINSEL_FUNC_0, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL),
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_22, PINSEL_FUNC_0, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL),
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_2, PINSEL_FUNC_2, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL),
+    };
 
-    pin_cfg.Pinnum = PINSEL_PIN_2;
-    pin_cfg.Funcnum = PINSEL_FUNC_2;
-    PINSEL_ConfigPin(&pin_cfg);
+    PINSEL_ConfigPins(pin_table, PINSEL_TABLE_SIZE(pin_table));
 
     GPIO_SetDir(PINSEL_PORT_0, RED_LED_PIN | GREEN_LED_PIN | BLUE_LED_PIN, OUTPUT);
 }
@@ -91,12 +96,57 @@ void configure_timer(void)
 {
 }
 
+/**
+ * @brief Average a half buffer of conversions into adc_value
+ *
+ */
+void adc_half_done(uint32_t* samples, uint32_t count)
+{
+    uint32_t i, sum = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        sum += ADC_GDR_RESULT(samples[i]);
+    }
+    adc_value = sum / count;
+}
+
+/**
+ * @brief Sample AD0.7 back to back at ADC_FREQ, the DMA fills the ping-pong buffer
+ *
+ */
 void configure_ADC(void)
 {
+    ADCDMA_CFG_Type adc_cfg;
+
+    GPDMA_Init();
+
+    adc_cfg.Rate = ADC_FREQ;
+    adc_cfg.Channels = (uint8_t)(1 << ADC_CHANNEL_7);
+    adc_cfg.StartMode = ADC_START_CONTINUOUS;
+    adc_cfg.DMAChannel = ADC_DMA_CHANNEL;
+    adc_cfg.Buffer = adc_buffer;
+    adc_cfg.BufferSize = ADC_BUFFER_SIZE;
+    adc_cfg.Callback = adc_half_done;
+    ADCDMA_Init(&adc_acquisition, &adc_cfg);
+}
+
+/**
+ * @brief Start the DWT cycle counter and name the profiling probes
+ *
+ */
+void configure_profiling(void)
+{
+    PROF_Init();
+    PROF_SetName(PROF_EINT3, "EINT3");
+    PROF_SetName(PROF_TIMER0, "TIMER0");
+    PROF_SetName(PROF_ADC, "ADC");
+    PROF_SetName(PROF_DMA, "DMA");
 }
 
 void start_interruptions(void)
 {
+    NVIC_EnableIRQ(DMA_IRQn);
 }
 
 void start_SysTick(void)
@@ -109,6 +159,7 @@ void start_timer(void)
 
 void start_ADC(void)
 {
+    ADCDMA_Start(&adc_acquisition);
 }
 
 /**
@@ -117,6 +168,9 @@ void start_ADC(void)
  */
 void EINT3_IRQHandler(void)
 {
+    uint32_t prof_start = PROF_Start(); /* Handler duration probe */
+
+    PROF_Stop(PROF_EINT3, prof_start);
 }
 
 /**
@@ -129,10 +183,29 @@ void SysTick_Handler(void)
 
 void TIMER0_IRQHandler(void)
 {
+    uint32_t prof_start = PROF_Start(); /* Handler duration probe */
+
+    PROF_Stop(PROF_TIMER0, prof_start);
 }
 
 void ADC_IRQHandler(void)
 {
+    uint32_t prof_start = PROF_Start(); /* Handler duration probe */
+
+    PROF_Stop(PROF_ADC, prof_start);
+}
+
+/**
+ * @brief One interrupt per half buffer of conversions
+ *
+ */
+void DMA_IRQHandler(void)
+{
+    uint32_t prof_start = PROF_Start(); /* Handler duration probe */
+
+    ADCDMA_IntHandler(&adc_acquisition);
+
+    PROF_Stop(PROF_DMA, prof_start);
 }
 
 /**
@@ -142,6 +215,12 @@ void ADC_IRQHandler(void)
 int main(void)
 {
     SystemInit();           /* Initialize the system clock (default: 100 MHz) */
+    configure_profiling();  /* Start the profiling probes */
+
+    configure_GPIO_ports(); /* Configure GPIO pins */
+    configure_ADC();        /* Configure ADC */
+    start_interruptions();  /* Enable interruptions */
+    start_ADC();            /* Start ADC */
 
     while (TRUE)
     {
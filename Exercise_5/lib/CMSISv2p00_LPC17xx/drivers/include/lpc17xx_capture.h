@@ -0,0 +1,141 @@
+/**********************************************************************
+ * $Id$		lpc17xx_capture.h				2010-05-21
+ *//**
+* @file		lpc17xx_capture.h
+* @brief	Contains the edge timestamp capture engine for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup CAPTURE CAPTURE (Edge timestamp capture engine)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_CAPTURE_H_
+#define LPC17XX_CAPTURE_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+#include "lpc17xx_gpdma.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup CAPTURE_Public_Macros CAPTURE Public Macros
+ * @{
+ */
+
+/** Largest ring buffer, in edges. One DMA pass is at most 4095 transfers and
+ * the ring must hold an even number of edges so that the slot parity gives
+ * the edge polarity */
+#define CAPTURE_MAX_EDGES 4094
+
+/** Macro to check the ring buffer size */
+#define PARAM_CAPTURE_SIZE(n) (((n) >= 4) && ((n) <= CAPTURE_MAX_EDGES) && (((n) & 1) == 0))
+
+/** Macro to check the number of periods of a measurement */
+#define PARAM_CAPTURE_PERIODS(cap, n) (((n) >= 1) && ((2 * (uint32_t)(n)) < (cap)->Cfg.BufferSize))
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup CAPTURE_Public_Types CAPTURE Public Types
+     * @{
+     */
+
+    /**
+     * @brief Capture engine configuration structure */
+    typedef struct
+    {
+        LPC_TIM_TypeDef* CounterTIMx;  /**< Timer whose CAPn.x pin carries the signal, runs in counter mode */
+        LPC_TIM_TypeDef* TimebaseTIMx; /**< Free running timer giving the timestamps, must differ from CounterTIMx */
+        uint8_t CaptureChannel;        /**< Input pin of CounterTIMx, should be:
+                                       - TIM_COUNTER_INCAP0: CAPn.0
+                                       - TIM_COUNTER_INCAP1: CAPn.1
+                                       */
+        uint8_t DMAChannel;            /**< GPDMA channel, 0 to 7, owned by the engine */
+        uint8_t PinPort;               /**< GPIO port of the capture pin, read to find the edge polarity */
+        uint8_t PinNum;                /**< GPIO pin of the capture pin */
+        uint32_t* Buffer;              /**< Timestamp ring buffer */
+        uint16_t BufferSize;           /**< Ring buffer size in edges, even, 4 to CAPTURE_MAX_EDGES */
+    } CAPTURE_CFG_Type;
+
+    /**
+     * @brief Capture engine state, one per captured pin. The fields are private */
+    typedef struct
+    {
+        CAPTURE_CFG_Type Cfg;  /**< Copy of the configuration */
+        GPDMA_LLI_Type* Chain; /**< Circular chain from the GPDMA pool, makes the DMA pass a ring */
+        uint8_t FirstRising;   /**< Slot 0 holds a rising edge */
+    } CAPTURE_Type;
+
+    /**
+     * @brief Result of a measurement, times in timebase ticks */
+    typedef struct
+    {
+        uint32_t Period; /**< Mean period */
+        uint32_t High;   /**< Mean high time */
+        uint16_t Duty;   /**< Duty cycle, 0 to 0xFFFF for 0 to 1 */
+    } CAPTURE_RESULT_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup CAPTURE_Public_Functions CAPTURE Public Functions
+     * @{
+     */
+
+    Status CAPTURE_Init(CAPTURE_Type* cap, const CAPTURE_CFG_Type* cfg);
+    void CAPTURE_Start(CAPTURE_Type* cap);
+    void CAPTURE_Stop(CAPTURE_Type* cap);
+    uint32_t CAPTURE_GetCount(const CAPTURE_Type* cap);
+    uint32_t CAPTURE_GetTickRate(const CAPTURE_Type* cap);
+    Status CAPTURE_Measure(const CAPTURE_Type* cap, uint16_t periods, CAPTURE_RESULT_Type* result);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_CAPTURE_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -0,0 +1,143 @@
+/**********************************************************************
+ * $Id$		lpc17xx_prof.h				2010-05-21
+ *//**
+* @file		lpc17xx_prof.h
+* @brief	Contains the cycle counter profiling probes for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup PROF PROF (Cycle counter profiling probes)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_PROF_H_
+#define LPC17XX_PROF_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup PROF_Public_Macros PROF Public Macros
+ * @{
+ */
+
+/** Number of probes in the probe table */
+#define PROF_MAX_PROBES 8
+/** Number of histogram bins. Bin n counts durations from 2^n to 2^(n+1)-1
+ * cycles, the last bin also counts every longer duration */
+#define PROF_HIST_BINS 16
+
+/** Open a scoped probe, the statements up to PROF_SCOPE_END() are measured */
+#define PROF_SCOPE_BEGIN(probe)                    \
+    do                                             \
+    {                                              \
+        uint32_t prof_scope_start_ = PROF_Start();
+/** Close the scope opened by PROF_SCOPE_BEGIN() and record its duration */
+#define PROF_SCOPE_END(probe)                      \
+        PROF_Stop((probe), prof_scope_start_);     \
+    } while (0)
+
+/** Macro to check the probe index */
+#define PARAM_PROF_PROBE(n) ((n) < PROF_MAX_PROBES)
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup PROF_Public_Types PROF Public Types
+     * @{
+     */
+
+    /**
+     * @brief Statistics of one probe, in core clock cycles */
+    typedef struct
+    {
+        const char* Name;              /**< Name printed by PROF_Dump() */
+        uint32_t Count;                /**< Number of measurements */
+        uint32_t Min;                  /**< Shortest duration */
+        uint32_t Max;                  /**< Longest duration */
+        uint64_t Total;                /**< Sum of all durations, for the mean */
+        uint32_t Hist[PROF_HIST_BINS]; /**< log2 histogram of the durations */
+    } PROF_PROBE_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup PROF_Public_Functions PROF Public Functions
+     * @{
+     */
+
+    void PROF_Init(void);
+    void PROF_Reset(void);
+    void PROF_SetName(uint8_t probe, const char* name);
+    void PROF_Record(uint8_t probe, uint32_t cycles);
+    const PROF_PROBE_Type* PROF_GetProbe(uint8_t probe);
+    uint32_t PROF_GetMean(uint8_t probe);
+    void PROF_Dump(void);
+
+    /**
+     * @brief  Take the start time of a measurement
+     * @return Current DWT cycle count */
+    static inline uint32_t PROF_Start(void)
+    {
+        return DWT->CYCCNT;
+    }
+
+    /**
+     * @brief  End a measurement started by PROF_Start() and record it
+     * @param[in] probe  Probe index, 0 to PROF_MAX_PROBES - 1
+     * @param[in] start  Value returned by PROF_Start() */
+    static inline void PROF_Stop(uint8_t probe, uint32_t start)
+    {
+        PROF_Record(probe, DWT->CYCCNT - start);
+    }
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_PROF_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
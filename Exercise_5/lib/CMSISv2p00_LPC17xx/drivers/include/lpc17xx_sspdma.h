@@ -0,0 +1,176 @@
+/**********************************************************************
+ * $Id$		lpc17xx_sspdma.h				2010-05-21
+ *//**
+* @file		lpc17xx_sspdma.h
+* @brief	Contains the GPDMA driven SSP transaction queue for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup SSPDMA SSPDMA (GPDMA driven SSP transaction queue)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_SSPDMA_H_
+#define LPC17XX_SSPDMA_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+#include "lpc17xx_ssp.h"
+#include "lpc17xx_gpdma.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup SSPDMA_Public_Macros SSPDMA Public Macros
+ * @{
+ */
+
+/** SSPDMA_XFER_Type.ChipSelect value when the SSEL pin of the SSP is used */
+#define SSPDMA_NO_CS 0xFF
+
+/** SSPDMA_XFER_Type.Flags: leave the chip select asserted after the transfer, for
+ * a command and its data queued as two transfers */
+#define SSPDMA_KEEP_CS ((uint8_t)(1 << 0))
+
+/** Macro to check the channel pair. Receive must have the higher priority, a
+ * lower channel number, so that it never falls behind transmit */
+#define PARAM_SSPDMA_CHANNELS(tx, rx) (PARAM_GPDMA_CHANNEL(tx) && PARAM_GPDMA_CHANNEL(rx) && ((rx) < (tx)))
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup SSPDMA_Public_Types SSPDMA Public Types
+     * @{
+     */
+
+    struct SSPDMA_XFER_Tag;
+
+    /**
+     * @brief Transfer completion callback. Runs in the DMA interrupt once the last
+     * byte is received, the buffers and the descriptor belong to the caller again */
+    typedef void (*SSPDMA_CALLBACK_Type)(struct SSPDMA_XFER_Tag* xfer);
+
+    /**
+     * @brief Chip select hook, drives the select line of a device, for example with
+     * GPIO_ClearValue() to assert and GPIO_SetValue() to release */
+    typedef void (*SSPDMA_CS_Type)(uint8_t cs, FunctionalState assert);
+
+    /**
+     * @brief Transfer descriptor, owned by the caller. Both buffers are used where
+     * they are, so neither may change until the callback has run */
+    typedef struct SSPDMA_XFER_Tag
+    {
+        const uint8_t* TxData;         /**< Bytes sent, NULL sends the dummy byte */
+        uint8_t* RxData;               /**< Bytes received, NULL discards them */
+        uint32_t Length;               /**< Number of frames, any size */
+        uint8_t ChipSelect;            /**< Device, passed to the chip select hook, or SSPDMA_NO_CS */
+        uint8_t Flags;                 /**< 0 or SSPDMA_KEEP_CS */
+        SSPDMA_CALLBACK_Type Callback; /**< Called when done, NULL for none */
+        void* Arg;                     /**< Free for the caller */
+        struct SSPDMA_XFER_Tag* Next;  /**< Private, queue link */
+    } SSPDMA_XFER_Type;
+
+    /**
+     * @brief GPDMA driven SSP configuration */
+    typedef struct
+    {
+        uint8_t TxChannel;         /**< GPDMA channel for transmit, 0 to 7 */
+        uint8_t RxChannel;         /**< GPDMA channel for receive, below TxChannel */
+        uint8_t Dummy;             /**< Frame sent by read only transfers, 0xFF for SD cards */
+        SSPDMA_CS_Type ChipSelect; /**< Chip select hook, NULL if only SSEL is used */
+    } SSPDMA_CFG_Type;
+
+    /**
+     * @brief GPDMA driven SSP state. The fields are private */
+    typedef struct
+    {
+        LPC_SSP_TypeDef* SSPx;    /**< SSP peripheral */
+        SSPDMA_CFG_Type Cfg;      /**< Copy of the configuration, Dummy is the source of
+                                       read only transfers */
+        uint8_t TxConn;           /**< GPDMA connection of the transmitter */
+        uint8_t RxConn;           /**< GPDMA connection of the receiver */
+        uint8_t CsActive;         /**< Asserted chip select, SSPDMA_NO_CS for none */
+        uint8_t Sink;             /**< Destination of the frames of write only transfers */
+        SSPDMA_XFER_Type* Head;   /**< Transfer on the bus, NULL when idle */
+        SSPDMA_XFER_Type* Tail;   /**< Last queued transfer */
+        uint32_t Offset;          /**< Frames of Head given to the DMA so far */
+        volatile uint8_t Busy;    /**< The interrupt owns the queue, SSPDMA_Submit() only appends */
+        uint32_t Depth;           /**< Transfers in the queue */
+        uint32_t MaxDepth;        /**< Most transfers ever queued */
+        uint32_t Transfers;       /**< Transfers completed */
+        uint32_t Bytes;           /**< Frames exchanged */
+        volatile uint32_t Errors; /**< GPDMA bus errors */
+    } SSPDMA_Type;
+
+    /**
+     * @brief GPDMA driven SSP statistics */
+    typedef struct
+    {
+        uint32_t Transfers; /**< Transfers completed */
+        uint32_t Bytes;     /**< Frames exchanged */
+        uint32_t MaxDepth;  /**< Most transfers waiting in the queue */
+        uint32_t Errors;    /**< GPDMA bus errors, each abandons its transfer */
+    } SSPDMA_STATS_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup SSPDMA_Public_Functions SSPDMA Public Functions
+     * @{
+     */
+
+    void SSPDMA_Init(SSPDMA_Type* ssp, LPC_SSP_TypeDef* SSPx, const SSPDMA_CFG_Type* cfg);
+    void SSPDMA_DeInit(SSPDMA_Type* ssp);
+    void SSPDMA_Submit(SSPDMA_Type* ssp, SSPDMA_XFER_Type* xfer);
+    Bool SSPDMA_IsIdle(const SSPDMA_Type* ssp);
+    void SSPDMA_GetStats(const SSPDMA_Type* ssp, SSPDMA_STATS_Type* stats);
+    Bool SSPDMA_IntHandler(SSPDMA_Type* ssp);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_SSPDMA_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
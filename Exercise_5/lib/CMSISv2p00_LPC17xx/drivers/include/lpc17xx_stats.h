@@ -0,0 +1,155 @@
+/**********************************************************************
+ * $Id$		lpc17xx_stats.h				2010-05-21
+ *//**
+* @file		lpc17xx_stats.h
+* @brief	Contains the fixed window running statistics for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup STATS STATS (Fixed window running statistics)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_STATS_H_
+#define LPC17XX_STATS_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup STATS_Public_Macros STATS Public Macros
+ * @{
+ */
+
+/** Largest window, in samples */
+#define STATS_MAX_WINDOW 1024
+
+/** Track the window minimum and maximum (monotonic deques, 4 bytes per sample) */
+#define STATS_OPT_MINMAX   ((uint8_t)(1 << 0))
+/** Track the window variance. Samples must stay within +/-32767 of the first
+ * sample pushed after a reset, or the 64-bit accumulator may overflow */
+#define STATS_OPT_VARIANCE ((uint8_t)(1 << 1))
+
+/** Define a static statistics block and its storage, no heap and no init call
+ * needed. window and options must be constants */
+#define STATS_DEFINE(name, window, options)                                                                            \
+    typedef char name##_window_check[PARAM_STATS_WINDOW(window) ? 1 : -1];                                             \
+    static int32_t name##_samples[(window)];                                                                           \
+    static uint16_t name##_minq[((options) & STATS_OPT_MINMAX) ? (window) : 1];                                        \
+    static uint16_t name##_maxq[((options) & STATS_OPT_MINMAX) ? (window) : 1];                                        \
+    static STATS_Type name = {name##_samples, name##_minq, name##_maxq, (window), (options)}
+
+/** Macro to check the window size */
+#define PARAM_STATS_WINDOW(n) (((n) >= 1) && ((n) <= STATS_MAX_WINDOW))
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup STATS_Public_Types STATS Public Types
+     * @{
+     */
+
+    /**
+     * @brief Running statistics over the last Window samples. Only the first
+     * five fields are set up by STATS_DEFINE(), the others are private */
+    typedef struct
+    {
+        int32_t* Samples;  /**< Sample ring, Window entries */
+        uint16_t* MinQ;    /**< Slots of increasing samples, front is the minimum */
+        uint16_t* MaxQ;    /**< Slots of decreasing samples, front is the maximum */
+        uint16_t Window;   /**< Window size in samples */
+        uint8_t Options;   /**< STATS_OPT_MINMAX and/or STATS_OPT_VARIANCE */
+        uint16_t Head;     /**< Next slot to write, holds the oldest sample once full */
+        uint16_t Count;    /**< Samples in the window */
+        uint16_t MinFirst; /**< Front of MinQ */
+        uint16_t MinLen;   /**< Entries in MinQ */
+        uint16_t MaxFirst; /**< Front of MaxQ */
+        uint16_t MaxLen;   /**< Entries in MaxQ */
+        int32_t Ref;       /**< First sample, variance is computed on offsets from it */
+        int64_t Sum;       /**< Sum of the window */
+        int64_t Scatter;   /**< Count * sum of squared deviations from the mean */
+    } STATS_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup STATS_Public_Functions STATS Public Functions
+     * @{
+     */
+
+    void STATS_Reset(STATS_Type* stats);
+    void STATS_Push(STATS_Type* stats, int32_t sample);
+    int32_t STATS_GetMean(const STATS_Type* stats);
+    int32_t STATS_GetMeanFrac(const STATS_Type* stats, uint8_t fracBits);
+    int32_t STATS_GetMin(const STATS_Type* stats);
+    int32_t STATS_GetMax(const STATS_Type* stats);
+    uint32_t STATS_GetVariance(const STATS_Type* stats);
+
+    /**
+     * @brief  Get the number of samples in the window
+     * @param[in] stats  Statistics block
+     * @return 0 to Window */
+    static inline uint16_t STATS_GetCount(const STATS_Type* stats)
+    {
+        return stats->Count;
+    }
+
+    /**
+     * @brief  Get the sum of the window
+     * @param[in] stats  Statistics block
+     * @return Exact sum of the samples in the window */
+    static inline int64_t STATS_GetSum(const STATS_Type* stats)
+    {
+        return stats->Sum;
+    }
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_STATS_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -0,0 +1,159 @@
+/**********************************************************************
+ * $Id$		lpc17xx_stdio.h				2010-05-21
+ *//**
+* @file		lpc17xx_stdio.h
+* @brief	Contains the buffered console transport behind the newlib stubs for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup STDIO STDIO (Buffered console behind the newlib stubs)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_STDIO_H_
+#define LPC17XX_STDIO_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+#include "lpc17xx_uartbuf.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup STDIO_Public_Macros STDIO Public Macros
+ * @{
+ */
+
+/** Output buffer size in bytes, a power of two. Can be overridden with -D */
+#ifndef STDIO_BUFFER_SIZE
+#define STDIO_BUFFER_SIZE 256
+#endif
+
+/** Trace buffer size in bytes, a power of two. Can be overridden with -D */
+#ifndef STDIO_TRACE_SIZE
+#define STDIO_TRACE_SIZE 1024
+#endif
+
+/** Macro to check a buffer size, a power of two */
+#define PARAM_STDIO_SIZE(n) (((n) >= 2) && (((n) & ((n)-1)) == 0))
+
+/** First word of STDIO_Trace once set up, "TRCE" in a memory dump */
+#define STDIO_TRACE_MAGIC 0x45435254UL
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup STDIO_Public_Types STDIO Public Types
+     * @{
+     */
+
+    /**
+     * @brief Console transport. Write takes what it can and returns the number of
+     * bytes taken, Read returns at most len bytes, 0 if none are waiting */
+    typedef struct
+    {
+        uint32_t (*Write)(void* arg, const uint8_t* data, uint32_t len); /**< Output, never NULL */
+        uint32_t (*Read)(void* arg, uint8_t* data, uint32_t len);        /**< Input, NULL if there is none */
+        void* Arg;                                                       /**< First argument of Write and Read */
+        uint8_t Halts; /**< Each call stops the core (semihosting). Interrupts never call it,
+                       output is handed over when the buffer is full, on a newline and on
+                       STDIO_Flush() */
+    } STDIO_TRANSPORT_Type;
+
+    /**
+     * @brief In-RAM trace buffer for a debugger to read. Head counts the bytes ever
+     * written, the newest are just below Data[Head % Size] */
+    typedef struct
+    {
+        uint32_t Magic;                  /**< STDIO_TRACE_MAGIC */
+        uint32_t Size;                   /**< STDIO_TRACE_SIZE */
+        volatile uint32_t Head;          /**< Bytes ever written */
+        uint8_t Data[STDIO_TRACE_SIZE];  /**< Oldest bytes are overwritten */
+    } STDIO_TRACE_Type;
+
+    /**
+     * @brief Console statistics */
+    typedef struct
+    {
+        uint32_t Bytes;     /**< Bytes written by the program */
+        uint32_t Flushes;   /**< Calls into the transport Write */
+        uint32_t Dropped;   /**< Bytes lost: buffer full in an interrupt, or no transport */
+        uint32_t HighWater; /**< Most bytes waiting in the output buffer */
+    } STDIO_STATS_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Variables ----------------------------------------------------------- */
+    /** @defgroup STDIO_Public_Variables STDIO Public Variables
+     * @{
+     */
+
+    /** Trace buffer of STDIO_TransportTrace(), at a fixed symbol for the debugger */
+    extern STDIO_TRACE_Type STDIO_Trace;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup STDIO_Public_Functions STDIO Public Functions
+     * @{
+     */
+
+    void STDIO_Init(const STDIO_TRANSPORT_Type* transport);
+    int STDIO_Write(const char* data, int len);
+    int STDIO_Read(char* data, int len);
+    void STDIO_Flush(void);
+    void STDIO_GetStats(STDIO_STATS_Type* stats);
+    void STDIO_TransportUARTBUF(STDIO_TRANSPORT_Type* transport, UARTBUF_Type* ub);
+    void STDIO_TransportSemihost(STDIO_TRANSPORT_Type* transport);
+    void STDIO_TransportTrace(STDIO_TRANSPORT_Type* transport);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_STDIO_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
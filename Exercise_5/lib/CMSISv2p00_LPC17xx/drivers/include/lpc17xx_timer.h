@@ -153,8 +153,8 @@ extern "C"
 
 /* Macro check TIMER mode */
 #define PARAM_TIM_MODE_OPT(MODE)                                                                                       \
-    ((MODE == TIM_TIMER_MODE) || (MODE == TIM_COUNTER_RISING_MODE) || (MODE == TIM_COUNTER_RISING_MODE) ||             \
-     (MODE == TIM_COUNTER_RISING_MODE))
+    ((MODE == TIM_TIMER_MODE) || (MODE == TIM_COUNTER_RISING_MODE) || (MODE == TIM_COUNTER_FALLING_MODE) ||            \
+     (MODE == TIM_COUNTER_ANY_MODE))
 
 /* Macro check TIMER prescale value */
 #define PARAM_TIM_PRESCALE_OPT(OPT) ((OPT == TIM_PRESCALE_TICKVAL) || (OPT == TIM_PRESCALE_USVAL))
@@ -337,6 +337,53 @@ extern "C"
     uint32_t TIM_GetCaptureValue(LPC_TIM_TypeDef* TIMx, TIM_COUNTER_INPUT_OPT CaptureChannel);
     void TIM_ResetCounter(LPC_TIM_TypeDef* TIMx);
 
+/* Call site checks of the timer arguments, e.g. a timer pointer or match
+   channel out of range (CHECK_PARAM_CALL, lpc_types.h) */
+#ifdef CHECK_PARAM_CALLS
+#define TIM_GetIntStatus(TIMx, IntFlag)                                                                                \
+    (CHECK_PARAM_CALL(PARAM_TIMx((TIMx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_TIM_INT_TYPE((IntFlag))),                                                                  \
+     TIM_GetIntStatus(TIMx, IntFlag))
+#define TIM_GetIntCaptureStatus(TIMx, IntFlag)                                                                         \
+    (CHECK_PARAM_CALL(PARAM_TIMx((TIMx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_TIM_INT_TYPE((IntFlag))),                                                                  \
+     TIM_GetIntCaptureStatus(TIMx, IntFlag))
+#define TIM_ClearIntPending(TIMx, IntFlag)                                                                             \
+    (CHECK_PARAM_CALL(PARAM_TIMx((TIMx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_TIM_INT_TYPE((IntFlag))),                                                                  \
+     TIM_ClearIntPending(TIMx, IntFlag))
+#define TIM_ClearIntCapturePending(TIMx, IntFlag)                                                                      \
+    (CHECK_PARAM_CALL(PARAM_TIMx((TIMx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_TIM_INT_TYPE((IntFlag))),                                                                  \
+     TIM_ClearIntCapturePending(TIMx, IntFlag))
+#define TIM_Init(TIMx, TimerCounterMode, TIM_ConfigStruct)                                                             \
+    (CHECK_PARAM_CALL(PARAM_TIMx((TIMx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_TIM_MODE_OPT((TimerCounterMode))),                                                         \
+     TIM_Init(TIMx, TimerCounterMode, TIM_ConfigStruct))
+#define TIM_DeInit(TIMx)                                                                                               \
+    (CHECK_PARAM_CALL(PARAM_TIMx((TIMx))),                                                                             \
+     TIM_DeInit(TIMx))
+#define TIM_Cmd(TIMx, NewState)                                                                                        \
+    (CHECK_PARAM_CALL(PARAM_TIMx((TIMx))),                                                                             \
+     TIM_Cmd(TIMx, NewState))
+#define TIM_ResetCounter(TIMx)                                                                                         \
+    (CHECK_PARAM_CALL(PARAM_TIMx((TIMx))),                                                                             \
+     TIM_ResetCounter(TIMx))
+#define TIM_ConfigMatch(TIMx, TIM_MatchConfigStruct)                                                                   \
+    (CHECK_PARAM_CALL(PARAM_TIMx((TIMx))),                                                                             \
+     TIM_ConfigMatch(TIMx, TIM_MatchConfigStruct))
+#define TIM_UpdateMatchValue(TIMx, MatchChannel, MatchValue)                                                           \
+    (CHECK_PARAM_CALL(PARAM_TIMx((TIMx))),                                                                             \
+     TIM_UpdateMatchValue(TIMx, MatchChannel, MatchValue))
+#define TIM_ConfigCapture(TIMx, TIM_CaptureConfigStruct)                                                               \
+    (CHECK_PARAM_CALL(PARAM_TIMx((TIMx))),                                                                             \
+     TIM_ConfigCapture(TIMx, TIM_CaptureConfigStruct))
+#define TIM_GetCaptureValue(TIMx, CaptureChannel)                                                                      \
+    (CHECK_PARAM_CALL(PARAM_TIMx((TIMx))),                                                                             \
+     CHECK_PARAM_CALL(PARAM_TIM_COUNTER_INPUT_OPT((CaptureChannel))),                                                  \
+     TIM_GetCaptureValue(TIMx, CaptureChannel))
+#endif
+
 /**
  * @}
  */
@@ -0,0 +1,183 @@
+/**********************************************************************
+ * $Id$		lpc17xx_uartdma.h				2010-05-21
+ *//**
+* @file		lpc17xx_uartdma.h
+* @brief	Contains the GPDMA driven UART for LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @defgroup UARTDMA UARTDMA (GPDMA driven UART)
+ * @ingroup LPC1700CMSIS_FwLib_Drivers
+ * @{
+ */
+
+#ifndef LPC17XX_UARTDMA_H_
+#define LPC17XX_UARTDMA_H_
+
+/* Includes ------------------------------------------------------------------- */
+#include "LPC17xx.h"
+#include "lpc_types.h"
+#include "lpc17xx_uart.h"
+#include "lpc17xx_gpdma.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Public Macros -------------------------------------------------------------- */
+/** @defgroup UARTDMA_Public_Macros UARTDMA Public Macros
+ * @{
+ */
+
+/** UARTDMA_CFG_Type.RxChannel value for a transmit only UART */
+#define UARTDMA_NO_CHANNEL 0xFF
+
+/** Largest receive buffer. Each half is one DMA pass of at most 4095 bytes */
+#define UARTDMA_MAX_RX_SIZE 8190
+
+/** Macro to check the receive buffer size */
+#define PARAM_UARTDMA_RX_SIZE(n) (((n) >= 2) && ((n) <= UARTDMA_MAX_RX_SIZE) && (((n) & 1) == 0))
+
+    /**
+     * @}
+     */
+
+    /* Public Types --------------------------------------------------------------- */
+    /** @defgroup UARTDMA_Public_Types UARTDMA Public Types
+     * @{
+     */
+
+    struct UARTDMA_TX_Tag;
+
+    /**
+     * @brief Transmit completion callback. Runs in the DMA interrupt once the last
+     * byte is in the transmit FIFO, the buffer and the descriptor belong to the
+     * caller again */
+    typedef void (*UARTDMA_TX_CALLBACK_Type)(struct UARTDMA_TX_Tag* tx);
+
+    /**
+     * @brief Transmit descriptor, owned by the caller. The buffer is sent where it
+     * is, so neither may change until the callback has run */
+    typedef struct UARTDMA_TX_Tag
+    {
+        const uint8_t* Data;               /**< Bytes to send */
+        uint32_t Length;                   /**< Number of bytes, any size */
+        UARTDMA_TX_CALLBACK_Type Callback; /**< Called when sent, NULL for none */
+        void* Arg;                         /**< Free for the caller */
+        struct UARTDMA_TX_Tag* Next;       /**< Private, queue link */
+    } UARTDMA_TX_Type;
+
+    struct UARTDMA_Tag;
+
+    /**
+     * @brief Receive callback, tells how many bytes UARTDMA_Read() can return. Runs
+     * in the DMA interrupt when a half of the buffer is full, or from UARTDMA_RxPoll()
+     * when the line went idle with a partial frame */
+    typedef void (*UARTDMA_RX_CALLBACK_Type)(struct UARTDMA_Tag* ud, uint32_t count);
+
+    /**
+     * @brief GPDMA driven UART configuration */
+    typedef struct
+    {
+        uint8_t TxChannel;                   /**< GPDMA channel for transmit, 0 to 7 */
+        uint8_t RxChannel;                   /**< GPDMA channel for receive, 0 to 7 or
+                                                  UARTDMA_NO_CHANNEL */
+        uint8_t* RxBuffer;                   /**< Receive buffer, used as two halves */
+        uint16_t RxSize;                     /**< Receive buffer size, even, 2 to UARTDMA_MAX_RX_SIZE */
+        UARTDMA_RX_CALLBACK_Type RxCallback; /**< Called when bytes are waiting, NULL for none */
+    } UARTDMA_CFG_Type;
+
+    /**
+     * @brief GPDMA driven UART state. The fields are private */
+    typedef struct UARTDMA_Tag
+    {
+        LPC_UART_TypeDef* UARTx;     /**< UART peripheral */
+        UARTDMA_CFG_Type Cfg;        /**< Copy of the configuration */
+        uint8_t TxConn;              /**< GPDMA connection of the transmitter */
+        uint8_t RxConn;              /**< GPDMA connection of the receiver */
+        UARTDMA_TX_Type* TxHead;     /**< Descriptor being sent, NULL when idle */
+        UARTDMA_TX_Type* TxTail;     /**< Last queued descriptor */
+        uint32_t TxOffset;           /**< Bytes of TxHead given to the DMA so far */
+        volatile uint8_t TxBusy;     /**< The interrupt owns the queue, UARTDMA_Send() only appends */
+        uint32_t TxDepth;            /**< Descriptors in the queue */
+        uint32_t TxMaxDepth;         /**< Most descriptors ever queued */
+        uint32_t TxBytes;            /**< Bytes sent */
+        GPDMA_LLI_Type* RxChain;     /**< Circular chain from the GPDMA pool, one item per half */
+        volatile uint32_t RxHead;    /**< Bytes in completed halves, moved by the interrupt */
+        uint32_t RxTail;             /**< Bytes ever read, moved by UARTDMA_Read() */
+        uint32_t RxSeen;             /**< Head at the previous UARTDMA_RxPoll() */
+        uint32_t RxReported;         /**< Head at the last receive callback */
+        volatile uint32_t RxDropped; /**< Bytes overwritten before they were read */
+        volatile uint32_t Errors;    /**< GPDMA bus errors */
+    } UARTDMA_Type;
+
+    /**
+     * @brief GPDMA driven UART statistics */
+    typedef struct
+    {
+        uint32_t TxBytes;    /**< Bytes sent */
+        uint32_t TxMaxDepth; /**< Most descriptors waiting in the transmit queue */
+        uint32_t RxBytes;    /**< Bytes received */
+        uint32_t RxDropped;  /**< Bytes lost to a late reader */
+        uint32_t Errors;     /**< GPDMA bus errors */
+    } UARTDMA_STATS_Type;
+
+    /**
+     * @}
+     */
+
+    /* Public Functions ----------------------------------------------------------- */
+    /** @defgroup UARTDMA_Public_Functions UARTDMA Public Functions
+     * @{
+     */
+
+    Status UARTDMA_Init(UARTDMA_Type* ud, LPC_UART_TypeDef* UARTx, const UARTDMA_CFG_Type* cfg);
+    void UARTDMA_DeInit(UARTDMA_Type* ud);
+    void UARTDMA_Send(UARTDMA_Type* ud, UARTDMA_TX_Type* tx);
+    Bool UARTDMA_IsTxIdle(const UARTDMA_Type* ud);
+    uint32_t UARTDMA_Read(UARTDMA_Type* ud, uint8_t* data, uint32_t len);
+    uint32_t UARTDMA_GetRxCount(const UARTDMA_Type* ud);
+    void UARTDMA_RxPoll(UARTDMA_Type* ud);
+    void UARTDMA_GetStats(const UARTDMA_Type* ud, UARTDMA_STATS_Type* stats);
+    Bool UARTDMA_IntHandler(UARTDMA_Type* ud);
+
+    /**
+     * @}
+     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC17XX_UARTDMA_H_ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -0,0 +1,249 @@
+/**********************************************************************
+ * $Id$		lpc17xx_adcdma.c				2010-05-21
+ *//**
+* @file		lpc17xx_adcdma.c
+* @brief	Contains all functions support for the continuous ADC acquisition through GPDMA on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup ADCDMA
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_adcdma.h"
+#include "lpc17xx_adc.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _ADCDMA
+
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup ADCDMA_Private_Macros ADCDMA Private Macros
+ * @{
+ */
+
+/** GPDMA channel registers of channel n */
+#define ADCDMA_DMACH(n) ((LPC_GPDMACH_TypeDef*)(LPC_GPDMACH0_BASE + ((uint32_t)(n) << 5)))
+
+/**
+ * @}
+ */
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup ADCDMA_Private_Functions ADCDMA Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Fill the GPDMA channel configuration of an acquisition
+                                                                         * @param[in]	acq		Acquisition
+                                                                         * @param[out]	dma_cfg	Channel configuration
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void adcdma_dma_cfg(const ADCDMA_Type* acq, GPDMA_Channel_CFG_Type* dma_cfg)
+{
+    dma_cfg->ChannelNum = acq->Cfg.DMAChannel;
+    dma_cfg->TransferSize = 0;
+    dma_cfg->TransferWidth = 0;
+    dma_cfg->SrcMemAddr = 0;
+    dma_cfg->DstMemAddr = 0;
+    dma_cfg->TransferType = GPDMA_TRANSFERTYPE_P2M;
+    dma_cfg->SrcConn = GPDMA_CONN_ADC;
+    dma_cfg->DstConn = 0;
+    dma_cfg->DMALLI = 0;
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup ADCDMA_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Initialize a continuous acquisition: power the ADC at the
+                                                                         * requested rate, select the inputs and route every finished
+                                                                         * conversion to a DMA request instead of the ADC interrupt
+                                                                         * @param[in]	acq		Acquisition
+                                                                         * @param[in]	cfg		Configuration, copied
+                                                                         * @return		ERROR if the GPDMA descriptor pool is exhausted
+                                                                         * @note		GPDMA_Init() must have been called, the input pins must be
+                                                                         * set to their AD0.n function. ADC_IRQn must stay disabled, the
+                                                                         * DMA request is the ADC interrupt line
+                                                                         **********************************************************************/
+Status ADCDMA_Init(ADCDMA_Type* acq, const ADCDMA_CFG_Type* cfg)
+{
+    uint32_t half = cfg->BufferSize / 2;
+    GPDMA_Channel_CFG_Type dma_cfg;
+    GPDMA_SEGMENT_Type segs[2];
+    uint8_t ch;
+
+    CHECK_PARAM(PARAM_ADCDMA_SIZE(cfg->BufferSize));
+    CHECK_PARAM(PARAM_ADCDMA_START(cfg->StartMode));
+    CHECK_PARAM(PARAM_GPDMA_CHANNEL(cfg->DMAChannel));
+    CHECK_PARAM(cfg->Channels != 0);
+
+    acq->Cfg = *cfg;
+    acq->Overruns = 0;
+    acq->NextHalf = 0;
+
+    ADC_Init(LPC_ADC, cfg->Rate);
+    for (ch = 0; ch < 8; ch++)
+    {
+        if (cfg->Channels & (1 << ch))
+        {
+            ADC_ChannelCmd(LPC_ADC, ch, ENABLE);
+        }
+    }
+
+    /* One input: its own DONE flag. Several: the global flag, the sample word
+     * then tells which input it came from */
+    LPC_ADC->ADINTEN = (cfg->Channels & (cfg->Channels - 1)) ? ADC_INTEN_GLOBAL : cfg->Channels;
+
+    /* Both halves chained in a ring, terminal count interrupt on each */
+    adcdma_dma_cfg(acq, &dma_cfg);
+    segs[0].SrcAddr = 0;
+    segs[0].DstAddr = ADDR32(cfg->Buffer);
+    segs[0].Size = half;
+    segs[1].SrcAddr = 0;
+    segs[1].DstAddr = ADDR32(cfg->Buffer + half);
+    segs[1].Size = half;
+    acq->Chain = GPDMA_LLI_Build(&dma_cfg, segs, 2, GPDMA_LLI_CIRCULAR | GPDMA_LLI_INT_SEGMENT);
+    return (acq->Chain != NULL) ? SUCCESS : ERROR;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Start converting from the first half of the buffer
+                                                                         * @param[in]	acq		Acquisition
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void ADCDMA_Start(ADCDMA_Type* acq)
+{
+    GPDMA_Channel_CFG_Type dma_cfg;
+
+    ADCDMA_Stop(acq);
+
+    /* Drop a result left over from a previous run */
+    (void)LPC_ADC->ADGDR;
+
+    adcdma_dma_cfg(acq, &dma_cfg);
+    GPDMA_SetupChain(&dma_cfg, acq->Chain);
+
+    acq->NextHalf = 0;
+    GPDMA_ChannelCmd(acq->Cfg.DMAChannel, ENABLE);
+
+    if (acq->Cfg.StartMode == ADC_START_CONTINUOUS)
+    {
+        ADC_BurstCmd(LPC_ADC, ENABLE);
+    }
+    else
+    {
+        ADC_EdgeStartConfig(LPC_ADC, ADC_START_ON_RISING);
+        ADC_StartCmd(LPC_ADC, acq->Cfg.StartMode);
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Stop converting and release the DMA channel
+                                                                         * @param[in]	acq		Acquisition
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void ADCDMA_Stop(ADCDMA_Type* acq)
+{
+    ADC_BurstCmd(LPC_ADC, DISABLE);
+    ADC_StartCmd(LPC_ADC, ADC_START_CONTINUOUS);
+    GPDMA_ChannelCmd(acq->Cfg.DMAChannel, DISABLE);
+    LPC_GPDMA->DMACIntTCClear = GPDMA_DMACIntTCClear_Ch(acq->Cfg.DMAChannel);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Serve the terminal count of the acquisition channel, call from
+                                                                         * DMA_IRQHandler. Calls the callback with the half that was just
+                                                                         * filled, the DMA is already filling the other one
+                                                                         * @param[in]	acq		Acquisition
+                                                                         * @return		TRUE if the interrupt was for this acquisition
+                                                                         **********************************************************************/
+Bool ADCDMA_IntHandler(ADCDMA_Type* acq)
+{
+    uint32_t half = acq->Cfg.BufferSize / 2;
+    uint8_t done;
+
+    if (!(LPC_GPDMA->DMACIntTCStat & GPDMA_DMACIntTCStat_Ch(acq->Cfg.DMAChannel)))
+    {
+        return FALSE;
+    }
+    LPC_GPDMA->DMACIntTCClear = GPDMA_DMACIntTCClear_Ch(acq->Cfg.DMAChannel);
+
+    /* The channel has loaded the item of the half it now fills, whose link
+     * points back at the finished one */
+    done = (ADCDMA_DMACH(acq->Cfg.DMAChannel)->DMACCLLI == ADDR32(acq->Chain)) ? 0 : 1;
+    if (done != acq->NextHalf)
+    {
+        acq->Overruns++;
+    }
+    acq->NextHalf = done ^ 1;
+
+    if (acq->Cfg.Callback != NULL)
+    {
+        acq->Cfg.Callback(acq->Cfg.Buffer + done * half, half);
+    }
+    return TRUE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the number of halves lost because the callback did not
+                                                                         * return before the DMA wrapped around
+                                                                         * @param[in]	acq		Acquisition
+                                                                         * @return		Overrun count since ADCDMA_Init()
+                                                                         **********************************************************************/
+uint32_t ADCDMA_GetOverruns(const ADCDMA_Type* acq)
+{
+    return acq->Overruns;
+}
+
+/**
+ * @}
+ */
+
+#endif /* _ADCDMA */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -71,6 +71,8 @@ uint16_t CANAF_gext_cnt = 0;
 
 /* Private Variables ---------------------------------------------------------- */
 static void can_SetBaudrate(LPC_CAN_TypeDef* CANx, uint32_t baudrate);
+static void can_af_sort(uint32_t* keys, uint32_t count);
+static uint32_t can_af_run(const uint32_t* keys, uint32_t first, uint32_t count);
 
 /*********************************************************************/ /**
                                                                          * @brief 		Setting CAN baud rate (bps)
@@ -130,6 +132,77 @@ static void can_SetBaudrate(LPC_CAN_TypeDef* CANx, uint32_t baudrate)
     /* Return to normal operating */
     CANx->MOD = 0;
 }
+
+/*********************************************************************/ /**
+                                                                         * @brief 		Sort acceptance filter keys in ascending order, in
+                                                                         *place (heapsort, no recursion and no scratch memory)
+                                                                         * @param[in] 	keys	Keys made with CAN_AF_STD_KEY() or
+                                                                         *CAN_AF_EXT_KEY()
+                                                                         * @param[in]	count	Number of keys
+                                                                         * @return 		None
+                                                                         ***********************************************************************/
+static void can_af_sort(uint32_t* keys, uint32_t count)
+{
+    uint32_t i, n, root, child, tmp;
+
+    for (i = count / 2; i-- > 0;)
+    {
+        for (root = i; (child = 2 * root + 1) < count; root = child)
+        {
+            if ((child + 1 < count) && (keys[child + 1] > keys[child]))
+            {
+                child++;
+            }
+            if (keys[root] >= keys[child])
+            {
+                break;
+            }
+            tmp = keys[root];
+            keys[root] = keys[child];
+            keys[child] = tmp;
+        }
+    }
+    for (n = count; n-- > 1;)
+    {
+        tmp = keys[0];
+        keys[0] = keys[n];
+        keys[n] = tmp;
+        for (root = 0; (child = 2 * root + 1) < n; root = child)
+        {
+            if ((child + 1 < n) && (keys[child + 1] > keys[child]))
+            {
+                child++;
+            }
+            if (keys[root] >= keys[child])
+            {
+                break;
+            }
+            tmp = keys[root];
+            keys[root] = keys[child];
+            keys[child] = tmp;
+        }
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief 		Get the length of the run of consecutive identifiers
+                                                                         *of one controller and one format starting at a key
+                                                                         * @param[in] 	keys	Sorted keys without duplicates
+                                                                         * @param[in]	first	Index of the first key of the run
+                                                                         * @param[in]	count	Number of keys
+                                                                         * @return 		Run length, at least 1
+                                                                         ***********************************************************************/
+static uint32_t can_af_run(const uint32_t* keys, uint32_t first, uint32_t count)
+{
+    uint32_t i = first + 1;
+
+    /* Bits 29 and up hold the format and, for extended keys, the controller */
+    while ((i < count) && (keys[i] == keys[i - 1] + 1) && ((keys[i] >> 29) == (keys[i - 1] >> 29)))
+    {
+        i++;
+    }
+    return i - first;
+}
 /* End of Private Functions ----------------------------------------------------*/
 
 /* Public Functions ----------------------------------------------------------- */
@@ -305,7 +378,7 @@ CAN_ERROR CAN_SetupAFLUT(LPC_CANAF_TypeDef* CANAFx, AF_SectionDef* AFSection)
                 count++;
                 CANAF_FullCAN_cnt++;
             }
-            AFSection->FullCAN_Sec = (FullCAN_Entry*)((uint32_t)(AFSection->FullCAN_Sec) + sizeof(FullCAN_Entry));
+            AFSection->FullCAN_Sec = (FullCAN_Entry*)((uintptr_t)(AFSection->FullCAN_Sec) + sizeof(FullCAN_Entry));
         }
     }
 
@@ -360,7 +433,7 @@ CAN_ERROR CAN_SetupAFLUT(LPC_CANAF_TypeDef* CANAFx, AF_SectionDef* AFSection)
                 count++;
                 CANAF_std_cnt++;
             }
-            AFSection->SFF_Sec = (SFF_Entry*)((uint32_t)(AFSection->SFF_Sec) + sizeof(SFF_Entry));
+            AFSection->SFF_Sec = (SFF_Entry*)((uintptr_t)(AFSection->SFF_Sec) + sizeof(SFF_Entry));
         }
     }
 
@@ -402,7 +475,7 @@ CAN_ERROR CAN_SetupAFLUT(LPC_CANAF_TypeDef* CANAFx, AF_SectionDef* AFSection)
             LPC_CANAF_RAM->mask[count] = entry;
             CANAF_gstd_cnt++;
             count++;
-            AFSection->SFF_GPR_Sec = (SFF_GPR_Entry*)((uint32_t)(AFSection->SFF_GPR_Sec) + sizeof(SFF_GPR_Entry));
+            AFSection->SFF_GPR_Sec = (SFF_GPR_Entry*)((uintptr_t)(AFSection->SFF_GPR_Sec) + sizeof(SFF_GPR_Entry));
         }
     }
 
@@ -435,7 +508,7 @@ CAN_ERROR CAN_SetupAFLUT(LPC_CANAF_TypeDef* CANAFx, AF_SectionDef* AFSection)
             LPC_CANAF_RAM->mask[count] = entry;
             CANAF_ext_cnt++;
             count++;
-            AFSection->EFF_Sec = (EFF_Entry*)((uint32_t)(AFSection->EFF_Sec) + sizeof(EFF_Entry));
+            AFSection->EFF_Sec = (EFF_Entry*)((uintptr_t)(AFSection->EFF_Sec) + sizeof(EFF_Entry));
         }
     }
 
@@ -474,7 +547,7 @@ CAN_ERROR CAN_SetupAFLUT(LPC_CANAF_TypeDef* CANAFx, AF_SectionDef* AFSection)
             entry = (ctrl2 << 29) | (upperEID << 0);
             LPC_CANAF_RAM->mask[count++] = entry;
             CANAF_gext_cnt++;
-            AFSection->EFF_GPR_Sec = (EFF_GPR_Entry*)((uint32_t)(AFSection->EFF_GPR_Sec) + sizeof(EFF_GPR_Entry));
+            AFSection->EFF_GPR_Sec = (EFF_GPR_Entry*)((uintptr_t)(AFSection->EFF_GPR_Sec) + sizeof(EFF_GPR_Entry));
         }
     }
     // update address values
@@ -1361,6 +1434,255 @@ CAN_ERROR CAN_RemoveEntry(AFLUT_ENTRY_Type EntryType, uint16_t position)
     return CAN_OK;
 }
 
+/********************************************************************/ /**
+                                                                        * @brief		Load a whole identifier set into the AF Look-Up
+                                                                        *Table in one pass, replacing its content. The keys
+                                                                        *are sorted and duplicates dropped, runs of at least
+                                                                        *CAN_AF_GROUP_MIN consecutive identifiers become
+                                                                        *group entries, the others explicit entries
+                                                                        * @param[in]	CANAFx	pointer to LPC_CANAF_TypeDef
+                                                                        *Should be: LPC_CANAF
+                                                                        * @param[in]	keys	Identifier set, keys made with
+                                                                        *CAN_AF_STD_KEY() or CAN_AF_EXT_KEY(). Sorted and
+                                                                        *compacted in place, the array is scratch on return
+                                                                        * @param[in]	count	Number of keys
+                                                                        * @return 		CAN Error, could be:
+                                                                        * 				- CAN_OBJECTS_FULL_ERROR: the set
+                                                                        *does not fit in the AF RAM, the table is unchanged
+                                                                        * 				- CAN_OK: the set is loaded
+                                                                        * @note		The table has no FullCAN section. The cost
+                                                                        *is the sort and one AF RAM write per word, where
+                                                                        *CAN_LoadExplicitEntry() shifts the table on each insert
+                                                                        *********************************************************************/
+CAN_ERROR CAN_LoadAFTable(LPC_CANAF_TypeDef* CANAFx, uint32_t* keys, uint32_t count)
+{
+    uint32_t i, j, n, std, run, pos, half = 0;
+    uint16_t sff = 0, sff_grp = 0, eff = 0, eff_grp = 0;
+
+    CHECK_PARAM(PARAM_CANAFx(CANAFx));
+
+    /* Sort and drop the duplicates, the standard keys come first */
+    can_af_sort(keys, count);
+    for (i = 1, n = (count != 0) ? 1 : 0; i < count; i++)
+    {
+        if (keys[i] != keys[n - 1])
+        {
+            keys[n++] = keys[i];
+        }
+    }
+    for (std = 0; (std < n) && !(keys[std] & (1UL << 31)); std++)
+    {
+    }
+
+    /* Size the sections before touching the table */
+    for (i = 0; i < n; i += run)
+    {
+        run = can_af_run(keys, i, n);
+        if (run >= CAN_AF_GROUP_MIN)
+        {
+            if (i < std)
+            {
+                sff_grp++;
+            }
+            else
+            {
+                eff_grp++;
+            }
+        }
+        else if (i < std)
+        {
+            sff += run;
+        }
+        else
+        {
+            eff += run;
+        }
+    }
+    if (((sff + 1) >> 1) + sff_grp + eff + (eff_grp << 1) > CAN_AF_RAM_WORDS)
+    {
+        return CAN_OBJECTS_FULL_ERROR;
+    }
+
+    CANAFx->AFMR = 0x01;
+    pos = 0;
+
+    /* Explicit standard identifiers, two per word, the first one high. An odd
+     * count is padded with a disabled entry that sorts last */
+    for (i = 0; i < std; i += run)
+    {
+        run = can_af_run(keys, i, std);
+        for (j = i; (run < CAN_AF_GROUP_MIN) && (j < i + run); j++)
+        {
+            if (half == 0)
+            {
+                half = (keys[j] << 16) | 0x0000FFFF;
+            }
+            else
+            {
+                LPC_CANAF_RAM->mask[pos++] = (half & 0xFFFF0000) | keys[j];
+                half = 0;
+            }
+        }
+    }
+    if (half != 0)
+    {
+        LPC_CANAF_RAM->mask[pos++] = half;
+    }
+
+    /* Standard groups, lower and upper bound in one word */
+    for (i = 0; i < std; i += run)
+    {
+        run = can_af_run(keys, i, std);
+        if (run >= CAN_AF_GROUP_MIN)
+        {
+            LPC_CANAF_RAM->mask[pos++] = (keys[i] << 16) | keys[i + run - 1];
+        }
+    }
+
+    /* Explicit extended identifiers, then extended groups in two words */
+    for (i = std; i < n; i += run)
+    {
+        run = can_af_run(keys, i, n);
+        for (j = i; (run < CAN_AF_GROUP_MIN) && (j < i + run); j++)
+        {
+            LPC_CANAF_RAM->mask[pos++] = keys[j] & 0x3FFFFFFF;
+        }
+    }
+    for (i = std; i < n; i += run)
+    {
+        run = can_af_run(keys, i, n);
+        if (run >= CAN_AF_GROUP_MIN)
+        {
+            LPC_CANAF_RAM->mask[pos++] = keys[i] & 0x3FFFFFFF;
+            LPC_CANAF_RAM->mask[pos++] = keys[i + run - 1] & 0x3FFFFFFF;
+        }
+    }
+
+    /* Section pointers, and the counts the entry by entry functions work from */
+    FULLCAN_ENABLE = DISABLE;
+    CANAF_FullCAN_cnt = 0;
+    CANAF_std_cnt = sff;
+    CANAF_gstd_cnt = sff_grp;
+    CANAF_ext_cnt = eff;
+    CANAF_gext_cnt = eff_grp;
+    CANAFx->SFF_sa = 0;
+    CANAFx->SFF_GRP_sa = ((sff + 1) >> 1) << 2;
+    CANAFx->EFF_sa = CANAFx->SFF_GRP_sa + (sff_grp << 2);
+    CANAFx->EFF_GRP_sa = CANAFx->EFF_sa + (eff << 2);
+    CANAFx->ENDofTable = CANAFx->EFF_GRP_sa + (eff_grp << 3);
+
+    CANAFx->AFMR = 0x00;
+    return CAN_OK;
+}
+
+/********************************************************************/ /**
+                                                                        * @brief		Tell whether the AF Look-Up Table accepts an
+                                                                        *identifier, by binary search of its explicit and
+                                                                        *group sections as the acceptance filter does
+                                                                        * @param[in]	key		Identifier, made with
+                                                                        *CAN_AF_STD_KEY() or CAN_AF_EXT_KEY()
+                                                                        * @return 		TRUE if an enabled entry matches
+                                                                        * @note		FullCAN entries are not searched
+                                                                        *********************************************************************/
+Bool CAN_LookupAFEntry(uint32_t key)
+{
+    uint32_t base, lo, hi, mid, entry, lower, upper;
+
+    if (!(key & (1UL << 31)))
+    {
+        /* Explicit standard: two per word, the even one high */
+        base = LPC_CANAF->SFF_sa >> 2;
+        lo = 0;
+        hi = CANAF_std_cnt;
+        while (lo < hi)
+        {
+            mid = (lo + hi) / 2;
+            entry = LPC_CANAF_RAM->mask[base + (mid >> 1)] >> ((mid & 1) ? 0 : 16);
+            if ((entry & 0xE7FF) < key)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        if (lo < CANAF_std_cnt)
+        {
+            entry = LPC_CANAF_RAM->mask[base + (lo >> 1)] >> ((lo & 1) ? 0 : 16);
+            if (((entry & 0xE7FF) == key) && !(entry & 0x1000))
+            {
+                return TRUE;
+            }
+        }
+
+        /* Standard groups: the last one whose lower bound is not above key */
+        base = LPC_CANAF->SFF_GRP_sa >> 2;
+        lo = 0;
+        hi = CANAF_gstd_cnt;
+        while (lo < hi)
+        {
+            mid = (lo + hi) / 2;
+            if (((LPC_CANAF_RAM->mask[base + mid] >> 16) & 0xE7FF) <= key)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        if (lo == 0)
+        {
+            return FALSE;
+        }
+        entry = LPC_CANAF_RAM->mask[base + lo - 1];
+        lower = (entry >> 16) & 0xE7FF;
+        upper = entry & 0xE7FF;
+        return ((key >= lower) && (key <= upper) && !(entry & 0x10001000)) ? TRUE : FALSE;
+    }
+
+    /* Explicit extended */
+    key &= 0x3FFFFFFF;
+    base = LPC_CANAF->EFF_sa >> 2;
+    lo = 0;
+    hi = CANAF_ext_cnt;
+    while (lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if (LPC_CANAF_RAM->mask[base + mid] < key)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if ((lo < CANAF_ext_cnt) && (LPC_CANAF_RAM->mask[base + lo] == key))
+    {
+        return TRUE;
+    }
+
+    /* Extended groups, two words each */
+    base = LPC_CANAF->EFF_GRP_sa >> 2;
+    lo = 0;
+    hi = CANAF_gext_cnt;
+    while (lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if (LPC_CANAF_RAM->mask[base + 2 * mid] <= key)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return ((lo != 0) && (key <= LPC_CANAF_RAM->mask[base + 2 * lo - 1])) ? TRUE : FALSE;
+}
+
 /********************************************************************/ /**
                                                                         * @brief		Send message data
                                                                         * @param[in]	CANx pointer to LPC_CAN_TypeDef,
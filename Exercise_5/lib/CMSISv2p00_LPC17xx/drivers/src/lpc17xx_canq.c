@@ -0,0 +1,493 @@
+/**********************************************************************
+ * $Id$		lpc17xx_canq.c				2010-05-21
+ *//**
+* @file		lpc17xx_canq.c
+* @brief	Contains all functions support for the interrupt driven CAN frame queues on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup CANQ
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_canq.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _CANQ
+
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup CANQ_Private_Macros CANQ Private Macros
+ * @{
+ */
+
+/** Transmit buffer n (0 to 2) registers: TFI, TID, TDA, TDB */
+#define CANQ_TXBUF(CANx, n) ((volatile uint32_t*)&(CANx)->TFI1 + 4 * (n))
+
+/** Released and completed flags of transmit buffer n (0 to 2) in CANxSR */
+#define CANQ_SR_TBS(n) (CAN_SR_TBS1 << (8 * (n)))
+#define CANQ_SR_TCS(n) (CAN_SR_TCS1 << (8 * (n)))
+
+/** Select flag of transmit buffer n (0 to 2) in CANxCMR */
+#define CANQ_CMR_STB(n) (CAN_CMR_STB1 << (n))
+
+/**
+ * @}
+ */
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup CANQ_Private_Functions CANQ Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Compute the arbitration value of a frame: base identifier,
+                                                                         * IDE, extended identifier, RTR, in bus order. A standard frame
+                                                                         * beats an extended one with the same base identifier, a data
+                                                                         * frame beats a remote one
+                                                                         * @param[in]	msg		Frame
+                                                                         * @return		Key, the lowest wins
+                                                                         **********************************************************************/
+static uint32_t canq_key(const CAN_MSG_Type* msg)
+{
+    uint32_t key;
+
+    if (msg->format == EXT_ID_FORMAT)
+    {
+        key = ((msg->id >> 18) & 0x7FF) << 19 | (1UL << 18) | (msg->id & 0x3FFFF);
+    }
+    else
+    {
+        key = (msg->id & 0x7FF) << 19;
+    }
+    return (key << 1) | (msg->type == REMOTE_FRAME);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Find the counters of an identifier, by binary search
+                                                                         * @param[in]	canq	CAN frame queues
+                                                                         * @param[in]	id		Identifier
+                                                                         * @return		Counters, NULL if the identifier is not counted
+                                                                         **********************************************************************/
+static CANQ_COUNTER_Type* canq_counter(const CANQ_Type* canq, uint32_t id)
+{
+    CANQ_COUNTER_Type* c = canq->Cfg.Counters;
+    uint32_t lo = 0, hi = canq->Cfg.NumCounters, mid;
+
+    while (lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if (c[mid].Id < id)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return ((lo < canq->Cfg.NumCounters) && (c[lo].Id == id)) ? &c[lo] : NULL;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Tell whether a queued frame goes before another one
+                                                                         * @param[in]	a		Entry
+                                                                         * @param[in]	b		Entry
+                                                                         * @return		TRUE if a has the lower key, or the same key and was
+                                                                         * queued first
+                                                                         **********************************************************************/
+static Bool canq_before(const CANQ_TX_ENTRY_Type* a, const CANQ_TX_ENTRY_Type* b)
+{
+    if (a->Key != b->Key)
+    {
+        return (a->Key < b->Key) ? TRUE : FALSE;
+    }
+    return ((int32_t)(a->Seq - b->Seq) < 0) ? TRUE : FALSE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Remove the first frame of the transmit queue
+                                                                         * @param[in]	canq	CAN frame queues, with at least one frame queued
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void canq_pop(CANQ_Type* canq)
+{
+    CANQ_TX_ENTRY_Type* heap = canq->Cfg.TxBuffer;
+    CANQ_TX_ENTRY_Type last = heap[--canq->TxCount];
+    uint32_t i = 0, child;
+
+    /* Sift the last entry down from the root */
+    while ((child = 2 * i + 1) < canq->TxCount)
+    {
+        if ((child + 1 < canq->TxCount) && canq_before(&heap[child + 1], &heap[child]))
+        {
+            child++;
+        }
+        if (!canq_before(&heap[child], &last))
+        {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Move the first frames of the transmit queue to the free
+                                                                         * transmit buffers. Runs with the CAN interrupt unable to preempt it
+                                                                         * @param[in]	canq	CAN frame queues
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void canq_fill(CANQ_Type* canq)
+{
+    LPC_CAN_TypeDef* CANx = canq->CANx;
+    CANQ_TX_ENTRY_Type* head = canq->Cfg.TxBuffer;
+    volatile uint32_t* buf;
+    uint8_t n, first;
+
+    while (canq->TxCount != 0)
+    {
+        /* The controller sends equal identifiers lowest buffer first: a frame
+         * must go above every buffer holding its identifier */
+        first = 0;
+        for (n = 0; n < 3; n++)
+        {
+            if ((canq->TxBusy & (1 << n)) && ((canq->TxKey[n] >> 1) == (head->Key >> 1)))
+            {
+                first = n + 1;
+            }
+        }
+        for (n = first; (n < 3) && (canq->TxBusy & (1 << n)); n++)
+        {
+        }
+        if (n == 3)
+        {
+            return;
+        }
+
+        buf = CANQ_TXBUF(CANx, n);
+        buf[0] = ((uint32_t)head->Msg.len << 16) | ((head->Msg.type == REMOTE_FRAME) ? (1UL << 30) : 0) |
+                 ((head->Msg.format == EXT_ID_FORMAT) ? (1UL << 31) : 0);
+        buf[1] = head->Msg.id;
+        buf[2] = head->Msg.dataA[0] | ((uint32_t)head->Msg.dataA[1] << 8) | ((uint32_t)head->Msg.dataA[2] << 16) |
+                 ((uint32_t)head->Msg.dataA[3] << 24);
+        buf[3] = head->Msg.dataB[0] | ((uint32_t)head->Msg.dataB[1] << 8) | ((uint32_t)head->Msg.dataB[2] << 16) |
+                 ((uint32_t)head->Msg.dataB[3] << 24);
+        CANx->CMR = CAN_CMR_TR | CANQ_CMR_STB(n);
+
+        canq->TxBusy |= 1 << n;
+        canq->TxKey[n] = head->Key;
+        canq->TxId[n] = head->Msg.id;
+        canq_pop(canq);
+    }
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup CANQ_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Set up the frame queues of a CAN controller and enable its
+                                                                         * interrupts
+                                                                         * @param[in]	canq	CAN frame queues
+                                                                         * @param[in]	CANx	CAN peripheral, should be:
+                                                                         * - LPC_CAN1: CAN1 peripheral
+                                                                         * - LPC_CAN2: CAN2 peripheral
+                                                                         * @param[in]	cfg		Configuration, copied. The buffers and the
+                                                                         * counters stay in use
+                                                                         * @return		None
+                                                                         * @note		CAN_Init() must have been called, the pins set and the
+                                                                         * acceptance filter loaded or bypassed. Call CANQ_IntHandler() of
+                                                                         * each controller in use from CAN_IRQHandler. CAN_SendMsg() and
+                                                                         * CAN_ReceiveMsg() must not be used on the same controller
+                                                                         **********************************************************************/
+void CANQ_Init(CANQ_Type* canq, LPC_CAN_TypeDef* CANx, const CANQ_CFG_Type* cfg)
+{
+    uint32_t i;
+
+    CHECK_PARAM(PARAM_CANx(CANx));
+    CHECK_PARAM(PARAM_CANQ_RX_SIZE(cfg->RxSize));
+    CHECK_PARAM(cfg->TxSize != 0);
+
+    canq->CANx = CANx;
+    canq->Cfg = *cfg;
+    canq->RxHead = 0;
+    canq->RxTail = 0;
+    canq->RxHighWater = 0;
+    canq->TxCount = 0;
+    canq->TxSeq = 0;
+    canq->TxHighWater = 0;
+    canq->TxBusy = 0;
+    canq->RxFrames = 0;
+    canq->TxFrames = 0;
+    canq->RxDropped = 0;
+    canq->Overruns = 0;
+    canq->Errors = 0;
+    for (i = 0; i < cfg->NumCounters; i++)
+    {
+        cfg->Counters[i].Rx = 0;
+        cfg->Counters[i].Tx = 0;
+    }
+
+    /* Identifier priority between the transmit buffers, as on the bus */
+    CAN_ModeConfig(CANx, CAN_TXPRIORITY_MODE, DISABLE);
+    CANx->CMR = CAN_CMR_RRB | CAN_CMR_CDO;
+    (void)CANx->ICR;
+    CANx->IER = CAN_IER_RIE | CAN_IER_TIE1 | CAN_IER_TIE2 | CAN_IER_TIE3 | CAN_IER_DOIE | CAN_IER_BEIE;
+    NVIC_EnableIRQ(CAN_IRQn);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Queue a frame for transmission, without waiting. The frames
+                                                                         * go out in identifier order, those of one identifier in the order
+                                                                         * they were queued
+                                                                         * @param[in]	canq	CAN frame queues
+                                                                         * @param[in]	msg		Frame, copied
+                                                                         * @return		ERROR if the transmit queue is full
+                                                                         * @note		Can be called from any context
+                                                                         **********************************************************************/
+Status CANQ_Send(CANQ_Type* canq, const CAN_MSG_Type* msg)
+{
+    CANQ_TX_ENTRY_Type* heap = canq->Cfg.TxBuffer;
+    CANQ_TX_ENTRY_Type entry;
+    uint32_t primask, i, parent;
+
+    CHECK_PARAM(PARAM_ID_FORMAT(msg->format));
+    CHECK_PARAM(PARAM_DLC(msg->len));
+    CHECK_PARAM(PARAM_FRAME_TYPE(msg->type));
+
+    entry.Msg = *msg;
+    entry.Key = canq_key(msg);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (canq->TxCount == canq->Cfg.TxSize)
+    {
+        __set_PRIMASK(primask);
+        return ERROR;
+    }
+    entry.Seq = canq->TxSeq++;
+
+    /* Sift up from the new leaf */
+    i = canq->TxCount++;
+    while (i > 0)
+    {
+        parent = (i - 1) / 2;
+        if (!canq_before(&entry, &heap[parent]))
+        {
+            break;
+        }
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = entry;
+    if (canq->TxCount > canq->TxHighWater)
+    {
+        canq->TxHighWater = canq->TxCount;
+    }
+
+    canq_fill(canq);
+    __set_PRIMASK(primask);
+    return SUCCESS;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Take the oldest received frame
+                                                                         * @param[in]	canq	CAN frame queues
+                                                                         * @param[out]	msg		Frame
+                                                                         * @return		FALSE if no frame is waiting
+                                                                         * @note		Single consumer: call from one context only
+                                                                         **********************************************************************/
+Bool CANQ_Receive(CANQ_Type* canq, CAN_MSG_Type* msg)
+{
+    uint32_t tail = canq->RxTail;
+
+    if (canq->RxHead == tail)
+    {
+        return FALSE;
+    }
+    __DMB();
+    *msg = canq->Cfg.RxBuffer[tail & (canq->Cfg.RxSize - 1)];
+    __DMB();
+    canq->RxTail = tail + 1;
+    return TRUE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the number of frames waiting in the receive ring
+                                                                         * @param[in]	canq	CAN frame queues
+                                                                         * @return		Frames that CANQ_Receive() can return now
+                                                                         **********************************************************************/
+uint32_t CANQ_GetRxCount(const CANQ_Type* canq)
+{
+    return canq->RxHead - canq->RxTail;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the counters of an identifier
+                                                                         * @param[in]	canq	CAN frame queues
+                                                                         * @param[in]	id		Identifier
+                                                                         * @return		Counters, NULL if id is not in the configured table
+                                                                         **********************************************************************/
+CANQ_COUNTER_Type* CANQ_GetCounter(const CANQ_Type* canq, uint32_t id)
+{
+    return canq_counter(canq, id);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the frame counters and the queue depths
+                                                                         * @param[in]	canq	CAN frame queues
+                                                                         * @param[out]	stats	Statistics since CANQ_Init()
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void CANQ_GetStats(const CANQ_Type* canq, CANQ_STATS_Type* stats)
+{
+    stats->RxFrames = canq->RxFrames;
+    stats->TxFrames = canq->TxFrames;
+    stats->RxDepth = canq->RxHead - canq->RxTail;
+    stats->RxHighWater = canq->RxHighWater;
+    stats->TxDepth = canq->TxCount;
+    stats->TxHighWater = canq->TxHighWater;
+    stats->RxDropped = canq->RxDropped;
+    stats->Overruns = canq->Overruns;
+    stats->Errors = canq->Errors;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Serve the interrupt of a CAN controller, call from
+                                                                         * CAN_IRQHandler. Empties the receive buffer into the ring and
+                                                                         * refills the transmit buffers that have been sent
+                                                                         * @param[in]	canq	CAN frame queues
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void CANQ_IntHandler(CANQ_Type* canq)
+{
+    LPC_CAN_TypeDef* CANx = canq->CANx;
+    CANQ_COUNTER_Type* counter;
+    CAN_MSG_Type* msg;
+    uint32_t icr = CANx->ICR;
+    uint32_t head = canq->RxHead;
+    uint32_t sr, rfs, data, used;
+    uint8_t n;
+
+    /* Receive, also when the interrupt was for transmit */
+    while ((sr = CANx->SR) & CAN_SR_RBS)
+    {
+        rfs = CANx->RFS;
+        used = head - canq->RxTail;
+        if (used < canq->Cfg.RxSize)
+        {
+            msg = &canq->Cfg.RxBuffer[head & (canq->Cfg.RxSize - 1)];
+            msg->format = (rfs & (1UL << 31)) ? EXT_ID_FORMAT : STD_ID_FORMAT;
+            msg->type = (rfs & (1UL << 30)) ? REMOTE_FRAME : DATA_FRAME;
+            msg->len = (rfs >> 16) & 0xF;
+            msg->id = CANx->RID;
+            data = CANx->RDA;
+            msg->dataA[0] = (uint8_t)data;
+            msg->dataA[1] = (uint8_t)(data >> 8);
+            msg->dataA[2] = (uint8_t)(data >> 16);
+            msg->dataA[3] = (uint8_t)(data >> 24);
+            data = CANx->RDB;
+            msg->dataB[0] = (uint8_t)data;
+            msg->dataB[1] = (uint8_t)(data >> 8);
+            msg->dataB[2] = (uint8_t)(data >> 16);
+            msg->dataB[3] = (uint8_t)(data >> 24);
+            head++;
+            if (used + 1 > canq->RxHighWater)
+            {
+                canq->RxHighWater = used + 1;
+            }
+            if ((counter = canq_counter(canq, msg->id)) != NULL)
+            {
+                counter->Rx++;
+            }
+        }
+        else
+        {
+            canq->RxDropped++;
+        }
+        canq->RxFrames++;
+        CANx->CMR = CAN_CMR_RRB;
+    }
+    __DMB();
+    canq->RxHead = head;
+
+    /* Transmit buffers released since the last time */
+    for (n = 0; n < 3; n++)
+    {
+        if ((canq->TxBusy & (1 << n)) && (sr & CANQ_SR_TBS(n)))
+        {
+            canq->TxBusy &= ~(1 << n);
+            if (sr & CANQ_SR_TCS(n))
+            {
+                canq->TxFrames++;
+                if ((counter = canq_counter(canq, canq->TxId[n])) != NULL)
+                {
+                    counter->Tx++;
+                }
+            }
+        }
+    }
+    canq_fill(canq);
+
+    if (icr & CAN_ICR_DOI)
+    {
+        canq->Overruns++;
+        CANx->CMR = CAN_CMR_CDO;
+    }
+    if (icr & CAN_ICR_BEI)
+    {
+        canq->Errors++;
+    }
+}
+
+/**
+ * @}
+ */
+
+#endif /* _CANQ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
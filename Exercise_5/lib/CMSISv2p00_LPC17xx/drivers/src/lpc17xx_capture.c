@@ -0,0 +1,342 @@
+/**********************************************************************
+ * $Id$		lpc17xx_capture.c				2010-05-21
+ *//**
+* @file		lpc17xx_capture.c
+* @brief	Contains all functions support for the edge timestamp capture engine on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup CAPTURE
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_capture.h"
+#include "lpc17xx_timer.h"
+#include "lpc17xx_gpio.h"
+#include "lpc17xx_clkpwr.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _CAPTURE
+
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup CAPTURE_Private_Macros CAPTURE Private Macros
+ * @{
+ */
+
+/** GPDMA channel registers of channel n */
+#define CAPTURE_DMACH(n) ((LPC_GPDMACH_TypeDef*)(LPC_GPDMACH0_BASE + ((uint32_t)(n) << 5)))
+
+/** Slot s of the ring holds a rising edge */
+#define CAPTURE_IS_RISING(cap, s) ((((s) & 1) == 0) == ((cap)->FirstRising != 0))
+
+/**
+ * @}
+ */
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup CAPTURE_Private_Functions CAPTURE Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the number of a timer
+                                                                         * @param[in]	TIMx	Timer peripheral, LPC_TIM0 to LPC_TIM3
+                                                                         * @return		0 to 3
+                                                                         **********************************************************************/
+static uint8_t capture_tim_num(LPC_TIM_TypeDef* TIMx)
+{
+    if (TIMx == LPC_TIM0)
+    {
+        return 0;
+    }
+    else if (TIMx == LPC_TIM1)
+    {
+        return 1;
+    }
+    else if (TIMx == LPC_TIM2)
+    {
+        return 2;
+    }
+    return 3;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Fill the GPDMA channel configuration of a capture engine. The
+                                                                         * match request would copy MRn, the chain reads the timebase
+                                                                         * counter instead
+                                                                         * @param[in]	cap		Capture engine
+                                                                         * @param[out]	dma_cfg	Channel configuration
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void capture_dma_cfg(const CAPTURE_Type* cap, GPDMA_Channel_CFG_Type* dma_cfg)
+{
+    dma_cfg->ChannelNum = cap->Cfg.DMAChannel;
+    dma_cfg->TransferSize = 0;
+    dma_cfg->TransferWidth = 0;
+    dma_cfg->SrcMemAddr = 0;
+    dma_cfg->DstMemAddr = 0;
+    dma_cfg->TransferType = GPDMA_TRANSFERTYPE_P2M;
+    dma_cfg->SrcConn = GPDMA_CONN_MAT0_0 + 2 * capture_tim_num(cap->Cfg.CounterTIMx);
+    dma_cfg->DstConn = 0;
+    dma_cfg->DMALLI = 0;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Program the DMA channel for a new pass over the ring and
+                                                                         * enable it. Every MATn.0 request copies the timebase counter
+                                                                         * into the next slot, the chain reloads the channel at the end
+                                                                         * of the ring
+                                                                         * @param[in]	cap		Capture engine
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void capture_load_channel(CAPTURE_Type* cap)
+{
+    GPDMA_Channel_CFG_Type dma_cfg;
+
+    GPDMA_ChannelCmd(cap->Cfg.DMAChannel, DISABLE);
+
+    capture_dma_cfg(cap, &dma_cfg);
+    GPDMA_SetupChain(&dma_cfg, cap->Chain);
+
+    /* The terminal count only raises the raw status, used to detect the wrap */
+    CAPTURE_DMACH(cap->Cfg.DMAChannel)->DMACCConfig &= ~(GPDMA_DMACCxConfig_IE | GPDMA_DMACCxConfig_ITC);
+
+    GPDMA_ChannelCmd(cap->Cfg.DMAChannel, ENABLE);
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup CAPTURE_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Initialize a capture engine: start the timebase timer and set
+                                                                         * the counter timer to count both edges of its CAP pin, with a
+                                                                         * match on every count that requests one DMA transfer
+                                                                         * @param[in]	cap		Capture engine
+                                                                         * @param[in]	cfg		Configuration, copied
+                                                                         * @return		ERROR if the GPDMA descriptor pool is exhausted
+                                                                         * @note		GPDMA_Init() must have been called, the capture pin must be
+                                                                         * set to its CAPn.x function
+                                                                         **********************************************************************/
+Status CAPTURE_Init(CAPTURE_Type* cap, const CAPTURE_CFG_Type* cfg)
+{
+    TIM_TIMERCFG_Type timer_cfg;
+    TIM_COUNTERCFG_Type counter_cfg;
+    TIM_MATCHCFG_Type match_cfg;
+    GPDMA_Channel_CFG_Type dma_cfg;
+    GPDMA_SEGMENT_Type seg;
+
+    CHECK_PARAM(PARAM_TIMx(cfg->CounterTIMx));
+    CHECK_PARAM(PARAM_TIMx(cfg->TimebaseTIMx));
+    CHECK_PARAM(cfg->CounterTIMx != cfg->TimebaseTIMx);
+    CHECK_PARAM(PARAM_TIM_COUNTER_INPUT_OPT(cfg->CaptureChannel));
+    CHECK_PARAM(PARAM_GPDMA_CHANNEL(cfg->DMAChannel));
+    CHECK_PARAM(PARAM_CAPTURE_SIZE(cfg->BufferSize));
+
+    cap->Cfg = *cfg;
+    cap->FirstRising = 0;
+
+    /* Timebase, one tick per PCLK */
+    timer_cfg.PrescaleOption = TIM_PRESCALE_TICKVAL;
+    timer_cfg.PrescaleValue = 1;
+    TIM_Init(cfg->TimebaseTIMx, TIM_TIMER_MODE, &timer_cfg);
+    TIM_Cmd(cfg->TimebaseTIMx, ENABLE);
+
+    /* Counter: MR0 = 1 with reset matches on every edge, the MATn.0 request
+     * stands in for the capture event, which has no DMA request line */
+    counter_cfg.CounterOption = cfg->CaptureChannel;
+    counter_cfg.CountInputSelect = cfg->CaptureChannel;
+    TIM_Init(cfg->CounterTIMx, TIM_COUNTER_ANY_MODE, &counter_cfg);
+
+    match_cfg.MatchChannel = 0;
+    match_cfg.IntOnMatch = DISABLE;
+    match_cfg.StopOnMatch = DISABLE;
+    match_cfg.ResetOnMatch = ENABLE;
+    match_cfg.ExtMatchOutputType = TIM_EXTMATCH_NOTHING;
+    match_cfg.MatchValue = 1;
+    TIM_ConfigMatch(cfg->CounterTIMx, &match_cfg);
+
+    /* One segment over the whole ring, linked back to itself */
+    capture_dma_cfg(cap, &dma_cfg);
+    seg.SrcAddr = ADDR32(&cfg->TimebaseTIMx->TC);
+    seg.DstAddr = ADDR32(cfg->Buffer);
+    seg.Size = cfg->BufferSize;
+    cap->Chain = GPDMA_LLI_Build(&dma_cfg, &seg, 1, GPDMA_LLI_CIRCULAR);
+    return (cap->Chain != NULL) ? SUCCESS : ERROR;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Empty the ring and start capturing. The pin level is sampled
+                                                                         * around the counter enable to know the polarity of the first
+                                                                         * edge, an edge in between makes it start over
+                                                                         * @param[in]	cap		Capture engine
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void CAPTURE_Start(CAPTURE_Type* cap)
+{
+    uint8_t level;
+
+    for (;;)
+    {
+        TIM_Cmd(cap->Cfg.CounterTIMx, DISABLE);
+        TIM_ResetCounter(cap->Cfg.CounterTIMx);
+        capture_load_channel(cap);
+        LPC_GPDMA->DMACIntTCClear = GPDMA_DMACIntTCClear_Ch(cap->Cfg.DMAChannel);
+
+        level = GPIO_PinRead(cap->Cfg.PinPort, cap->Cfg.PinNum);
+        TIM_Cmd(cap->Cfg.CounterTIMx, ENABLE);
+        if (GPIO_PinRead(cap->Cfg.PinPort, cap->Cfg.PinNum) == level)
+        {
+            break;
+        }
+    }
+    cap->FirstRising = (level == 0);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Stop capturing, the ring keeps its content
+                                                                         * @param[in]	cap		Capture engine
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void CAPTURE_Stop(CAPTURE_Type* cap)
+{
+    TIM_Cmd(cap->Cfg.CounterTIMx, DISABLE);
+    GPDMA_ChannelCmd(cap->Cfg.DMAChannel, DISABLE);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the number of edges held by the ring
+                                                                         * @param[in]	cap		Capture engine
+                                                                         * @return		0 to BufferSize
+                                                                         **********************************************************************/
+uint32_t CAPTURE_GetCount(const CAPTURE_Type* cap)
+{
+    uint32_t index;
+
+    /* Status first: a wrap between the two reads only hides new edges */
+    if (LPC_GPDMA->DMACRawIntTCStat & GPDMA_DMACRawIntTCStat_Ch(cap->Cfg.DMAChannel))
+    {
+        return cap->Cfg.BufferSize;
+    }
+    index = (CAPTURE_DMACH(cap->Cfg.DMAChannel)->DMACCDestAddr - ADDR32(cap->Cfg.Buffer)) >> 2;
+    return (index > cap->Cfg.BufferSize) ? cap->Cfg.BufferSize : index;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the frequency of the timebase
+                                                                         * @param[in]	cap		Capture engine
+                                                                         * @return		Timestamp ticks per second
+                                                                         **********************************************************************/
+uint32_t CAPTURE_GetTickRate(const CAPTURE_Type* cap)
+{
+    static const uint8_t pclksel[4] = {CLKPWR_PCLKSEL_TIMER0, CLKPWR_PCLKSEL_TIMER1, CLKPWR_PCLKSEL_TIMER2,
+                                       CLKPWR_PCLKSEL_TIMER3};
+
+    return CLKPWR_GetPCLK(pclksel[capture_tim_num(cap->Cfg.TimebaseTIMx)]) / (cap->Cfg.TimebaseTIMx->PR + 1);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Average the last periods of the signal, ending at the newest
+                                                                         * rising edge. Only reads the ring, costs O(periods)
+                                                                         * @param[in]	cap		Capture engine
+                                                                         * @param[in]	periods	Number of periods, 1 to BufferSize / 2 - 1
+                                                                         * @param[out]	result	Mean period, high time and duty cycle
+                                                                         * @return		SUCCESS, or ERROR if the ring holds too few edges
+                                                                         **********************************************************************/
+Status CAPTURE_Measure(const CAPTURE_Type* cap, uint16_t periods, CAPTURE_RESULT_Type* result)
+{
+    const uint32_t* t = cap->Cfg.Buffer;
+    uint32_t size = cap->Cfg.BufferSize;
+    uint32_t count, r, rise, fall, span, high, k;
+
+    CHECK_PARAM(PARAM_CAPTURE_PERIODS(cap, periods));
+
+    count = CAPTURE_GetCount(cap);
+    if (count == 0)
+    {
+        return ERROR;
+    }
+    r = (uint32_t)(CAPTURE_DMACH(cap->Cfg.DMAChannel)->DMACCDestAddr - ADDR32(t)) >> 2;
+    r = (r + size - 1) % size;
+    if (!CAPTURE_IS_RISING(cap, r))
+    {
+        r = (r + size - 1) % size;
+        count--;
+    }
+    if (count < 2 * (uint32_t)periods + 1)
+    {
+        return ERROR;
+    }
+
+    /* Walk back one rising/falling pair per period */
+    high = 0;
+    rise = r;
+    for (k = 0; k < periods; k++)
+    {
+        fall = (rise + size - 1) % size;
+        rise = (fall + size - 1) % size;
+        high += t[fall] - t[rise];
+    }
+    span = t[r] - t[rise];
+    if (span == 0)
+    {
+        return ERROR;
+    }
+
+    result->Period = span / periods;
+    result->High = high / periods;
+    k = (uint32_t)(((uint64_t)high << 16) / span);
+    result->Duty = (uint16_t)((k > 0xFFFF) ? 0xFFFF : k);
+    return SUCCESS;
+}
+
+/**
+ * @}
+ */
+
+#endif /* _CAPTURE */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -0,0 +1,716 @@
+/**********************************************************************
+ * $Id$		lpc17xx_emacq.c				2010-05-21
+ *//**
+* @file		lpc17xx_emacq.c
+* @brief	Contains all functions support for the zero-copy EMAC descriptor rings and event loop on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup EMACQ
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_emacq.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _EMACQ
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup EMACQ_Private_Functions EMACQ Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		End of the receive descriptors the EMAC has filled: after an
+                                                                         * overrun, the end of the last frame it completed before it
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @return		Descriptor index
+                                                                         **********************************************************************/
+static uint32_t emacq_rx_produce(const EMACQ_Type* emacq)
+{
+    return (emacq->RxStopped == 2) ? emacq->RxEnd : LPC_EMAC->RxProduceIndex;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Empty the receive ring and point the EMAC at its start
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @return		None
+                                                                         * @note		The receive datapath must be stopped or just reset
+                                                                         **********************************************************************/
+static void emacq_rx_arm(EMACQ_Type* emacq)
+{
+    uint32_t i;
+
+    for (i = 0; i < emacq->Cfg.RxCount; i++)
+    {
+        emacq->RxStat[i].Info = 0;
+        emacq->RxStat[i].HashCRC = 0;
+    }
+    emacq->RxConsume = 0;
+    emacq->RxNext = 0;
+    emacq->RxSeen = 0;
+    emacq->RxStopped = 0;
+    LPC_EMAC->RxDescriptor = ADDR32(emacq->RxDesc);
+    LPC_EMAC->RxStatus = ADDR32(emacq->RxStat);
+    LPC_EMAC->RxDescriptorNumber = emacq->Cfg.RxCount - 1;
+    LPC_EMAC->RxConsumeIndex = 0;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Empty the transmit ring and point the EMAC at its start
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @return		None
+                                                                         * @note		The transmit datapath must be stopped or just reset
+                                                                         **********************************************************************/
+static void emacq_tx_arm(EMACQ_Type* emacq)
+{
+    uint32_t i;
+
+    for (i = 0; i < emacq->Cfg.TxCount; i++)
+    {
+        emacq->TxDesc[i].Packet = 0;
+        emacq->TxDesc[i].Ctrl = 0;
+        emacq->TxTag[i] = NULL;
+        emacq->TxStat[i].Info = 0;
+    }
+    emacq->TxProduce = 0;
+    emacq->TxDone = 0;
+    LPC_EMAC->TxDescriptor = ADDR32(emacq->TxDesc);
+    LPC_EMAC->TxStatus = ADDR32(emacq->TxStat);
+    LPC_EMAC->TxDescriptorNumber = emacq->Cfg.TxCount - 1;
+    LPC_EMAC->TxProduceIndex = 0;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Mark the descriptors of a frame as released and give every
+                                                                         * released descriptor at the head of the receive ring back to the EMAC
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @param[in]	index	First descriptor of the frame
+                                                                         * @param[in]	count	Number of descriptors of the frame
+                                                                         * @return		None
+                                                                         * @note		A released descriptor has a zero status word: the EMAC never
+                                                                         * writes one, a fragment is at least one byte or carries the last flag
+                                                                         **********************************************************************/
+static void emacq_release(EMACQ_Type* emacq, uint32_t index, uint32_t count)
+{
+    uint32_t consume, primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    while (count--)
+    {
+        emacq->RxStat[index].Info = 0;
+        index = (index + 1 == emacq->Cfg.RxCount) ? 0 : index + 1;
+    }
+    consume = emacq->RxConsume;
+    while ((consume != emacq->RxNext) && (emacq->RxStat[consume].Info == 0))
+    {
+        consume = (consume + 1 == emacq->Cfg.RxCount) ? 0 : consume + 1;
+    }
+    if (consume != emacq->RxConsume)
+    {
+        emacq->RxConsume = consume;
+        LPC_EMAC->RxConsumeIndex = consume;
+    }
+    __set_PRIMASK(primask);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Time stamp the receive descriptors the EMAC has filled since
+                                                                         * the last call
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void emacq_stamp(EMACQ_Type* emacq)
+{
+    uint32_t produce, now;
+
+    produce = emacq_rx_produce(emacq);
+    now = DWT->CYCCNT;
+    while (emacq->RxSeen != produce)
+    {
+        emacq->RxStamp[emacq->RxSeen] = now;
+        emacq->RxSeen = (emacq->RxSeen + 1 == emacq->Cfg.RxCount) ? 0 : emacq->RxSeen + 1;
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Recover the receive datapath from an overrun, which stops it
+                                                                         * for good. The frames the EMAC completed before are handed over first;
+                                                                         * once they are all released, the datapath is reset and the ring re-armed
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @return		None
+                                                                         * @note		Call from the context handing the frames over
+                                                                         **********************************************************************/
+static void emacq_rx_recover(EMACQ_Type* emacq)
+{
+    uint32_t produce, index, info;
+
+    if (emacq->RxStopped == 1)
+    {
+        /* A frame cut short by the overrun has no last fragment: it is dropped */
+        emacq_stamp(emacq);
+        produce = LPC_EMAC->RxProduceIndex;
+        emacq->RxEnd = emacq->RxNext;
+        for (index = emacq->RxNext; index != produce;)
+        {
+            info = emacq->RxStat[index].Info;
+            index = (index + 1 == emacq->Cfg.RxCount) ? 0 : index + 1;
+            if (info & EMAC_RINFO_LAST_FLAG)
+            {
+                emacq->RxEnd = index;
+            }
+        }
+        emacq->RxSeen = emacq->RxEnd;
+        emacq->RxStopped = 2;
+    }
+    if ((emacq->RxNext == emacq->RxEnd) && (emacq->RxConsume == emacq->RxEnd))
+    {
+        LPC_EMAC->Command |= EMAC_CR_RX_RES;
+        emacq_rx_arm(emacq);
+        LPC_EMAC->Command |= EMAC_CR_RX_EN;
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Take back transmit descriptors and call Cfg.TxDone for each
+                                                                         * frame they complete
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @param[in]	end		First descriptor not to take back
+                                                                         * @param[in]	fail	Status of the frames, 0 to use the one the EMAC wrote
+                                                                         * @return		Number of frames taken back
+                                                                         **********************************************************************/
+static uint32_t emacq_tx_reclaim(EMACQ_Type* emacq, uint32_t end, uint32_t fail)
+{
+    uint32_t done, last, latency, info = 0, frames = 0;
+    void* tag;
+
+    for (done = emacq->TxDone; done != end;)
+    {
+        info |= fail ? fail : emacq->TxStat[done].Info;
+        last = emacq->TxDesc[done].Ctrl & EMAC_TCTRL_LAST;
+        tag = emacq->TxTag[done];
+        latency = DWT->CYCCNT - emacq->TxStamp[done];
+        done = (done + 1 == emacq->Cfg.TxCount) ? 0 : done + 1;
+        emacq->TxDone = done;
+        if (last)
+        {
+            frames++;
+            if (latency < emacq->TxLatencyMin)
+            {
+                emacq->TxLatencyMin = latency;
+            }
+            if (latency > emacq->TxLatencyMax)
+            {
+                emacq->TxLatencyMax = latency;
+            }
+            emacq->TxLatencyTotal += latency;
+            if (info & EMAC_TINFO_ERR)
+            {
+                emacq->TxErrors++;
+            }
+            else
+            {
+                emacq->TxFrames++;
+            }
+            if (emacq->Cfg.TxDone != NULL)
+            {
+                emacq->Cfg.TxDone(tag, info);
+            }
+            info = 0;
+        }
+    }
+    return frames;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Recover the transmit datapath from an underrun, which stops
+                                                                         * it for good: the frames sent are reclaimed, those still queued fail
+                                                                         * with EMAC_TINFO_UNDERRUN, then the datapath is reset and the ring
+                                                                         * re-armed
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @return		None
+                                                                         * @note		Call from the context reclaiming the frames
+                                                                         **********************************************************************/
+static void emacq_tx_recover(EMACQ_Type* emacq)
+{
+    /* Cfg.TxDone may queue frames again: refused until the ring is re-armed */
+    emacq->TxStopped = 1;
+    LPC_EMAC->Command &= ~EMAC_CR_TX_EN;
+    emacq_tx_reclaim(emacq, LPC_EMAC->TxConsumeIndex, 0);
+    emacq_tx_reclaim(emacq, emacq->TxProduce, EMAC_TINFO_ERR | EMAC_TINFO_UNDERRUN);
+    LPC_EMAC->Command |= EMAC_CR_TX_RES;
+    emacq_tx_arm(emacq);
+    LPC_EMAC->Command |= EMAC_CR_TX_EN;
+    emacq->TxStopped = 0;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Hand received frames to the frame handler
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @param[in]	budget	Most frames to hand over, 0 for no limit
+                                                                         * @return		Number of frames handed over
+                                                                         **********************************************************************/
+static uint32_t emacq_rx_batch(EMACQ_Type* emacq, uint32_t budget)
+{
+    EMACQ_FRAME_Type frame;
+    uint32_t n = 0, last, latency;
+
+    if (emacq->RxStopped)
+    {
+        emacq_rx_recover(emacq);
+    }
+    emacq_stamp(emacq);
+    while (((budget == 0) || (n < budget)) && EMACQ_Receive(emacq, &frame))
+    {
+        /* Frames completed since the batch started are seen now */
+        emacq_stamp(emacq);
+        last = frame.Index + frame.Count - 1;
+        if (last >= emacq->Cfg.RxCount)
+        {
+            last -= emacq->Cfg.RxCount;
+        }
+        latency = DWT->CYCCNT - emacq->RxStamp[last];
+        if (latency < emacq->RxLatencyMin)
+        {
+            emacq->RxLatencyMin = latency;
+        }
+        if (latency > emacq->RxLatencyMax)
+        {
+            emacq->RxLatencyMax = latency;
+        }
+        emacq->RxLatencyTotal += latency;
+        emacq->RxHandled++;
+        emacq->Cfg.RxFrame(&frame);
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup EMACQ_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Move the EMAC onto caller sized descriptor rings whose
+                                                                         * receive buffers are lent to the application instead of copied
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @param[in]	cfg		Configuration, copied. Cfg.Mem stays in use
+                                                                         * @return		ERROR if Cfg.Mem is not 8 byte aligned or too small,
+                                                                         * otherwise SUCCESS
+                                                                         * @note		EMAC_Init() must have been called. The receive and transmit
+                                                                         * datapaths are reset: frames held by the EMAC_ReadPacketBuffer() and
+                                                                         * EMAC_WritePacketBuffer() descriptors are lost, and those functions must
+                                                                         * not be used afterwards. Transmit fragments must be in AHB SRAM too, the
+                                                                         * EMAC DMA reaches nothing else. With Cfg.RxFrame set the event loop is
+                                                                         * started: call EMACQ_IntHandler() from ENET_IRQHandler and EMACQ_Poll()
+                                                                         * from the main loop. Latencies use the DWT cycle counter, enabled here
+                                                                         **********************************************************************/
+Status EMACQ_Init(EMACQ_Type* emacq, const EMACQ_CFG_Type* cfg)
+{
+    uint8_t* mem = (uint8_t*)cfg->Mem;
+    uint32_t i;
+
+    CHECK_PARAM(PARAM_EMACQ_BUF_SIZE(cfg->RxBufSize));
+    CHECK_PARAM((cfg->RxCount >= 2) && (cfg->TxCount >= 2));
+    CHECK_PARAM((cfg->RxFrame == NULL) || (cfg->PollBudget != 0));
+
+    if (((ADDR32(mem) & 7) != 0) ||
+        (cfg->MemSize < EMACQ_MEM_SIZE(cfg->RxCount, cfg->TxCount, cfg->RxBufSize)))
+    {
+        return ERROR;
+    }
+
+    /* Stop both datapaths before the rings change under them */
+    LPC_EMAC->IntEnable = 0;
+    LPC_EMAC->MAC1 &= ~EMAC_MAC1_REC_EN;
+    LPC_EMAC->Command &= ~(EMAC_CR_RX_EN | EMAC_CR_TX_EN);
+    LPC_EMAC->Command |= EMAC_CR_RX_RES | EMAC_CR_TX_RES;
+
+    /* The 8 byte aligned statuses first, the byte buffers last */
+    emacq->Cfg = *cfg;
+    emacq->RxStat = (RX_Stat*)mem;
+    mem += cfg->RxCount * sizeof(RX_Stat);
+    emacq->RxDesc = (RX_Desc*)mem;
+    mem += cfg->RxCount * sizeof(RX_Desc);
+    emacq->TxDesc = (TX_Desc*)mem;
+    mem += cfg->TxCount * sizeof(TX_Desc);
+    emacq->TxTag = (void**)mem;
+    mem += cfg->TxCount * sizeof(void*);
+    emacq->TxStat = (TX_Stat*)mem;
+    mem += cfg->TxCount * sizeof(TX_Stat);
+    emacq->RxStamp = (uint32_t*)mem;
+    mem += cfg->RxCount * sizeof(uint32_t);
+    emacq->TxStamp = (uint32_t*)mem;
+    mem += cfg->TxCount * sizeof(uint32_t);
+    emacq->RxBuf = mem;
+
+    for (i = 0; i < cfg->RxCount; i++)
+    {
+        emacq->RxDesc[i].Packet = ADDR32(&emacq->RxBuf[i * cfg->RxBufSize]);
+        emacq->RxDesc[i].Ctrl = EMAC_RCTRL_INT | (cfg->RxBufSize - 1);
+    }
+    emacq_rx_arm(emacq);
+    emacq_tx_arm(emacq);
+    emacq->TxStopped = 0;
+    emacq->Polling = 0;
+    emacq->RxFrames = 0;
+    emacq->RxErrors = 0;
+    emacq->RxFull = 0;
+    emacq->RxOverruns = 0;
+    emacq->TxFrames = 0;
+    emacq->TxErrors = 0;
+    emacq->TxFull = 0;
+    emacq->TxUnderruns = 0;
+    emacq->Interrupts = 0;
+    emacq->PollSwitches = 0;
+    emacq->RxLatencyMin = 0xFFFFFFFF;
+    emacq->RxLatencyMax = 0;
+    emacq->RxLatencyTotal = 0;
+    emacq->RxHandled = 0;
+    emacq->TxLatencyMin = 0xFFFFFFFF;
+    emacq->TxLatencyMax = 0;
+    emacq->TxLatencyTotal = 0;
+
+    if (cfg->RxFrame != NULL)
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        LPC_EMAC->IntClear = 0xFFFF;
+        LPC_EMAC->IntEnable = EMACQ_INT_ALL;
+        NVIC_EnableIRQ(ENET_IRQn);
+    }
+
+    LPC_EMAC->Command |= EMAC_CR_RX_EN | EMAC_CR_TX_EN;
+    LPC_EMAC->MAC1 |= EMAC_MAC1_REC_EN;
+    return SUCCESS;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Borrow the next complete received frame. Its buffers stay
+                                                                         * the application's, and out of the receive ring, until EMACQ_Release()
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @param[out]	frame	Frame lent out
+                                                                         * @return		FALSE if no complete frame is waiting
+                                                                         * @note		Frames received with an error are released here and counted.
+                                                                         * Call from one context only; frames may be released in any order, from
+                                                                         * any context
+                                                                         **********************************************************************/
+Bool EMACQ_Receive(EMACQ_Type* emacq, EMACQ_FRAME_Type* frame)
+{
+    uint32_t produce, index, next, count, length, info;
+
+    produce = emacq_rx_produce(emacq);
+    for (;;)
+    {
+        index = emacq->RxNext;
+        next = index;
+        count = 0;
+        length = 0;
+        do
+        {
+            if (next == produce)
+            {
+                return FALSE;
+            }
+            info = emacq->RxStat[next].Info;
+            length += (info & EMAC_RINFO_SIZE) + 1;
+            count++;
+            next = (next + 1 == emacq->Cfg.RxCount) ? 0 : next + 1;
+        } while (!(info & EMAC_RINFO_LAST_FLAG));
+
+        emacq->RxNext = next;
+        if (!(info & (EMAC_RINFO_ERR_MASK | EMAC_RINFO_NO_DESCR)))
+        {
+            break;
+        }
+        emacq->RxErrors++;
+        emacq_release(emacq, index, count);
+    }
+
+    emacq->RxFrames++;
+    frame->Index = (uint16_t)index;
+    frame->Count = (uint16_t)count;
+    frame->Length = length;
+    return TRUE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Locate one buffer of a lent frame
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @param[in]	frame	Frame from EMACQ_Receive()
+                                                                         * @param[in]	n		Buffer of the frame, 0 to frame->Count - 1
+                                                                         * @param[out]	len		Bytes of the frame in this buffer
+                                                                         * @return		First byte of the buffer
+                                                                         **********************************************************************/
+uint8_t* EMACQ_GetFragment(const EMACQ_Type* emacq, const EMACQ_FRAME_Type* frame, uint32_t n, uint32_t* len)
+{
+    uint32_t index = frame->Index + n;
+
+    if (index >= emacq->Cfg.RxCount)
+    {
+        index -= emacq->Cfg.RxCount;
+    }
+    *len = (emacq->RxStat[index].Info & EMAC_RINFO_SIZE) + 1;
+    return &emacq->RxBuf[index * emacq->Cfg.RxBufSize];
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Give the buffers of a lent frame back to the receive ring
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @param[in]	frame	Frame from EMACQ_Receive(), released once
+                                                                         * @return		None
+                                                                         * @note		Can be called from any context. The EMAC gets a buffer back
+                                                                         * once every frame before it has been released as well
+                                                                         **********************************************************************/
+void EMACQ_Release(EMACQ_Type* emacq, const EMACQ_FRAME_Type* frame)
+{
+    emacq_release(emacq, frame->Index, frame->Count);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Queue a frame made of one or more fragments for
+                                                                         * transmission, without copying them
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @param[in]	frags	Fragments in frame order; the data must stay
+                                                                         * unchanged until the frame is reclaimed
+                                                                         * @param[in]	count	Number of fragments, 1 to Cfg.TxCount - 1
+                                                                         * @param[in]	tag		Passed to Cfg.TxDone once the frame is sent, e.g. the
+                                                                         * buffer to free or the lent frame to release
+                                                                         * @return		ERROR if the transmit ring has fewer than count free
+                                                                         * descriptors
+                                                                         * @note		Can be called from any context. The EMAC pads the frame and
+                                                                         * appends the FCS
+                                                                         **********************************************************************/
+Status EMACQ_Send(EMACQ_Type* emacq, const EMACQ_FRAG_Type* frags, uint32_t count, void* tag)
+{
+    uint32_t produce, free, i, primask;
+
+    CHECK_PARAM(count != 0);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    produce = emacq->TxProduce;
+    free = emacq->TxDone + emacq->Cfg.TxCount - produce - 1;
+    if (free >= emacq->Cfg.TxCount)
+    {
+        free -= emacq->Cfg.TxCount;
+    }
+    if ((count > free) || emacq->TxStopped)
+    {
+        emacq->TxFull++;
+        __set_PRIMASK(primask);
+        return ERROR;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        emacq->TxDesc[produce].Packet = ADDR32(frags[i].Data);
+        emacq->TxDesc[produce].Ctrl = (frags[i].Length - 1) & EMAC_TCTRL_SIZE;
+        emacq->TxTag[produce] = NULL;
+        if (i + 1 == count)
+        {
+            emacq->TxDesc[produce].Ctrl |= EMAC_TCTRL_LAST | EMAC_TCTRL_INT;
+            emacq->TxTag[produce] = tag;
+            emacq->TxStamp[produce] = DWT->CYCCNT;
+        }
+        produce = (produce + 1 == emacq->Cfg.TxCount) ? 0 : produce + 1;
+    }
+
+    /* One index update hands the whole frame over */
+    emacq->TxProduce = produce;
+    LPC_EMAC->TxProduceIndex = produce;
+    __set_PRIMASK(primask);
+    return SUCCESS;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Take back the transmit descriptors the EMAC is done with
+                                                                         * and call Cfg.TxDone for each frame they complete
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @return		Number of frames reclaimed
+                                                                         * @note		Call from one context only, e.g. on EMAC_INT_TX_DONE or
+                                                                         * when EMACQ_Send() finds the ring full. EMACQ_IntHandler() calls it
+                                                                         * when the event loop runs
+                                                                         **********************************************************************/
+uint32_t EMACQ_ReclaimTx(EMACQ_Type* emacq)
+{
+    return emacq_tx_reclaim(emacq, LPC_EMAC->TxConsumeIndex, 0);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Read the descriptor rings statistics
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @param[out]	stats	Statistics
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void EMACQ_GetStats(const EMACQ_Type* emacq, EMACQ_STATS_Type* stats)
+{
+    uint32_t n, sent;
+
+    stats->RxFrames = emacq->RxFrames;
+    stats->RxErrors = emacq->RxErrors;
+    n = emacq->RxNext + emacq->Cfg.RxCount - emacq->RxConsume;
+    stats->RxLent = (n >= emacq->Cfg.RxCount) ? n - emacq->Cfg.RxCount : n;
+    stats->RxFull = emacq->RxFull;
+    stats->RxOverruns = emacq->RxOverruns;
+    stats->RxLatencyMin = emacq->RxHandled ? emacq->RxLatencyMin : 0;
+    stats->RxLatencyMax = emacq->RxLatencyMax;
+    stats->RxLatencyMean = emacq->RxHandled ? (uint32_t)(emacq->RxLatencyTotal / emacq->RxHandled) : 0;
+    stats->TxFrames = emacq->TxFrames;
+    stats->TxErrors = emacq->TxErrors;
+    n = emacq->TxProduce + emacq->Cfg.TxCount - emacq->TxDone;
+    stats->TxQueued = (n >= emacq->Cfg.TxCount) ? n - emacq->Cfg.TxCount : n;
+    stats->TxFull = emacq->TxFull;
+    stats->TxUnderruns = emacq->TxUnderruns;
+    sent = emacq->TxFrames + emacq->TxErrors;
+    stats->TxLatencyMin = sent ? emacq->TxLatencyMin : 0;
+    stats->TxLatencyMax = emacq->TxLatencyMax;
+    stats->TxLatencyMean = sent ? (uint32_t)(emacq->TxLatencyTotal / sent) : 0;
+    stats->Interrupts = emacq->Interrupts;
+    stats->PollSwitches = emacq->PollSwitches;
+    stats->Polling = emacq->Polling;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		EMAC interrupt handler of the event loop. Reclaims sent
+                                                                         * frames and hands up to Cfg.IrqBudget received frames to Cfg.RxFrame.
+                                                                         * With more waiting, masks the receive interrupts and leaves the rest to
+                                                                         * EMACQ_Poll(), so a flood of frames cannot starve the main loop
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @return		None
+                                                                         * @note		Call from ENET_IRQHandler. A receive overrun or a transmit
+                                                                         * underrun stops its EMAC datapath: the transmit one is reset here, the
+                                                                         * receive one once EMACQ_Poll() has emptied the ring
+                                                                         **********************************************************************/
+void EMACQ_IntHandler(EMACQ_Type* emacq)
+{
+    uint32_t status;
+
+    status = LPC_EMAC->IntStatus & LPC_EMAC->IntEnable;
+    LPC_EMAC->IntClear = status;
+    emacq->Interrupts++;
+
+    if (status & EMAC_INT_RX_OVERRUN)
+    {
+        /* Stop here, the frame handing context recovers, see emacq_rx_recover() */
+        emacq->RxOverruns++;
+        LPC_EMAC->Command &= ~EMAC_CR_RX_EN;
+        emacq->RxStopped = 1;
+    }
+    if (status & EMAC_INT_RX_FIN)
+    {
+        emacq->RxFull++;
+    }
+    if (status & EMAC_INT_TX_UNDERRUN)
+    {
+        emacq->TxUnderruns++;
+        emacq_tx_recover(emacq);
+    }
+    else if (status & EMAC_INT_TX_DONE)
+    {
+        EMACQ_ReclaimTx(emacq);
+    }
+
+    if ((status & (EMACQ_INT_RX | EMAC_INT_RX_OVERRUN)) && !emacq->Polling)
+    {
+        emacq_rx_batch(emacq, emacq->Cfg.IrqBudget);
+        if (emacq->RxStopped ||
+            ((emacq->Cfg.IrqBudget != 0) && (emacq_rx_produce(emacq) != emacq->RxNext)))
+        {
+            /* Still busy, or recovering from an overrun: go over to polling
+             * until the ring runs dry */
+            LPC_EMAC->IntEnable &= ~EMACQ_INT_RX;
+            emacq->Polling = 1;
+            emacq->PollSwitches++;
+        }
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Polling half of the event loop: while the receive
+                                                                         * interrupts are masked, hand up to Cfg.PollBudget received frames to
+                                                                         * Cfg.RxFrame per call. Once the ring is found empty the receive
+                                                                         * interrupts take over again
+                                                                         * @param[in]	emacq	Descriptor rings
+                                                                         * @return		Number of frames handed over
+                                                                         * @note		Call from the main loop, as often as it gets round
+                                                                         **********************************************************************/
+uint32_t EMACQ_Poll(EMACQ_Type* emacq)
+{
+    uint32_t n;
+
+    if (!emacq->Polling)
+    {
+        return 0;
+    }
+    if (LPC_EMAC->IntStatus & EMAC_INT_RX_FIN)
+    {
+        emacq->RxFull++;
+        LPC_EMAC->IntClear = EMAC_INT_RX_FIN;
+    }
+
+    n = emacq_rx_batch(emacq, emacq->Cfg.PollBudget);
+    if (n < emacq->Cfg.PollBudget)
+    {
+        /* Clear first: a frame landing after the check raises RX_DONE again */
+        LPC_EMAC->IntClear = EMACQ_INT_RX;
+        if (!emacq->RxStopped && (LPC_EMAC->RxProduceIndex == emacq->RxNext))
+        {
+            emacq->Polling = 0;
+            LPC_EMAC->IntEnable |= EMACQ_INT_RX;
+        }
+    }
+    return n;
+}
+
+/**
+ * @}
+ */
+
+#endif /* _EMACQ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
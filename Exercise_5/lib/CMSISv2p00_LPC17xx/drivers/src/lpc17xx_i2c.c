@@ -62,7 +62,7 @@
  */
 typedef struct
 {
-    uint32_t txrx_setup; /* Transmission setup */
+    void* txrx_setup;    /* Transmission setup */
     int32_t dir;         /* Current direction phase, 0 - write, 1 - read */
 } I2C_CFG_T;
 
@@ -1023,7 +1023,7 @@ Status I2C_MasterTransferData(LPC_I2C_TypeDef* I2Cx, I2C_M_SETUP_Type* TransferC
     else if (Opt == I2C_TRANSFER_INTERRUPT)
     {
         // Setup tx_rx data, callback and interrupt handler
-        i2cdat[i2cId].txrx_setup = (uint32_t)TransferCfg;
+        i2cdat[i2cId].txrx_setup = TransferCfg;
 
         // Set direction phase, write first
         i2cdat[i2cId].dir = 0;
@@ -1164,7 +1164,7 @@ Status I2C_SlaveTransferData(LPC_I2C_TypeDef* I2Cx, I2C_S_SETUP_Type* TransferCf
     else if (Opt == I2C_TRANSFER_INTERRUPT)
     {
         // Setup tx_rx data, callback and interrupt handler
-        i2cdat[i2cId].txrx_setup = (uint32_t)TransferCfg;
+        i2cdat[i2cId].txrx_setup = TransferCfg;
 
         // Set direction phase, read first
         i2cdat[i2cId].dir = 1;
@@ -0,0 +1,381 @@
+/**********************************************************************
+ * $Id$		lpc17xx_i2cq.c				2010-05-21
+ *//**
+* @file		lpc17xx_i2cq.c
+* @brief	Contains all functions support for the interrupt driven I2C transaction queue on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup I2CQ
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_i2cq.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _I2CQ
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup I2CQ_Private_Functions I2CQ Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Start the head transaction, the START goes out once the bus
+                                                                         * is free, after the STOP of the previous one if any
+                                                                         * @param[in]	i2cq	I2C transaction queue
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void i2cq_start(I2CQ_Type* i2cq)
+{
+    i2cq->Remaining = i2cq->Head->Timeout;
+    i2cq->I2Cx->I2CONSET = I2C_I2CONSET_STA;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		End the head transaction and start the next one. Runs with
+                                                                         * the I2C interrupt unable to preempt it
+                                                                         * @param[in]	i2cq	I2C transaction queue
+                                                                         * @param[in]	status	Outcome, I2CQ_DONE...
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void i2cq_complete(I2CQ_Type* i2cq, uint8_t status)
+{
+    LPC_I2C_TypeDef* I2Cx = i2cq->I2Cx;
+    I2CQ_XFER_Type* xfer = i2cq->Head;
+
+    /* Release the bus, unless it was lost to another master */
+    if (status != I2CQ_ARB_LOST)
+    {
+        I2Cx->I2CONSET = I2C_I2CONSET_STO;
+    }
+    I2Cx->I2CONCLR = I2C_I2CONCLR_AAC | I2C_I2CONCLR_STAC | I2C_I2CONCLR_SIC;
+
+    /* Unlink before the callback, which may queue the descriptor again */
+    i2cq->Head = xfer->Next;
+    if (i2cq->Head == NULL)
+    {
+        i2cq->Tail = NULL;
+    }
+    i2cq->Depth--;
+    i2cq->Bytes += xfer->TxCount + xfer->RxCount;
+    switch (status)
+    {
+        case I2CQ_DONE: i2cq->Transfers++; break;
+        case I2CQ_NACK: i2cq->Nacks++; break;
+        case I2CQ_TIMEOUT: i2cq->Timeouts++; break;
+        default: i2cq->Errors++; break;
+    }
+    xfer->Status = status;
+    if (xfer->Callback != NULL)
+    {
+        xfer->Callback(xfer);
+    }
+
+    if (i2cq->Head != NULL)
+    {
+        i2cq_start(i2cq);
+    }
+    else
+    {
+        i2cq->Busy = 0;
+    }
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup I2CQ_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Set up an empty transaction queue on an I2C bus and enable its
+                                                                         * interrupt
+                                                                         * @param[in]	i2cq	I2C transaction queue
+                                                                         * @param[in]	I2Cx	I2C peripheral, should be:
+                                                                         * - LPC_I2C0: I2C0 peripheral
+                                                                         * - LPC_I2C1: I2C1 peripheral
+                                                                         * - LPC_I2C2: I2C2 peripheral
+                                                                         * @return		None
+                                                                         * @note		I2C_Init() and I2C_Cmd() must have been called and the pins
+                                                                         * set. Call I2CQ_IntHandler() from the I2Cn_IRQHandler of the bus,
+                                                                         * and I2CQ_Tick() from a periodic timer if timeouts are used.
+                                                                         * I2C_MasterTransferData() must not be used on the same bus
+                                                                         **********************************************************************/
+void I2CQ_Init(I2CQ_Type* i2cq, LPC_I2C_TypeDef* I2Cx)
+{
+    CHECK_PARAM(PARAM_I2Cx(I2Cx));
+
+    i2cq->I2Cx = I2Cx;
+    i2cq->Head = NULL;
+    i2cq->Tail = NULL;
+    i2cq->Remaining = 0;
+    i2cq->Busy = 0;
+    i2cq->Depth = 0;
+    i2cq->MaxDepth = 0;
+    i2cq->Transfers = 0;
+    i2cq->Bytes = 0;
+    i2cq->Nacks = 0;
+    i2cq->Timeouts = 0;
+    i2cq->Errors = 0;
+
+    I2Cx->I2CONCLR = I2C_I2CONCLR_AAC | I2C_I2CONCLR_STAC | I2C_I2CONCLR_SIC;
+    I2C_IntCmd(I2Cx, TRUE);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Queue a transaction, without copying or waiting. Transactions
+                                                                         * run in the order they were queued, the next one is started from
+                                                                         * the interrupt that ends the previous one
+                                                                         * @param[in]	i2cq	I2C transaction queue
+                                                                         * @param[in]	xfer	Descriptor, with SlaveAddr, the buffers and
+                                                                         * lengths, Timeout and Callback set. It must not be queued already
+                                                                         * @return		None
+                                                                         * @note		Can be called from any context, including a completion callback
+                                                                         **********************************************************************/
+void I2CQ_Submit(I2CQ_Type* i2cq, I2CQ_XFER_Type* xfer)
+{
+    uint32_t primask;
+
+    CHECK_PARAM(PARAM_I2CQ_ADDR(xfer->SlaveAddr));
+
+    xfer->Status = I2CQ_PENDING;
+    xfer->TxCount = 0;
+    xfer->RxCount = 0;
+    xfer->Next = NULL;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (i2cq->Tail != NULL)
+    {
+        i2cq->Tail->Next = xfer;
+    }
+    else
+    {
+        i2cq->Head = xfer;
+    }
+    i2cq->Tail = xfer;
+    if (++i2cq->Depth > i2cq->MaxDepth)
+    {
+        i2cq->MaxDepth = i2cq->Depth;
+    }
+
+    /* An idle bus raises no interrupt, start here */
+    if (!i2cq->Busy)
+    {
+        i2cq->Busy = 1;
+        i2cq_start(i2cq);
+    }
+    __set_PRIMASK(primask);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Count down the timeout of the transaction on the bus, call
+                                                                         * from a periodic timer interrupt. A transaction that runs out is
+                                                                         * stopped with I2CQ_TIMEOUT and the next one started
+                                                                         * @param[in]	i2cq	I2C transaction queue
+                                                                         * @return		None
+                                                                         * @note		The first tick may come right after the start: a Timeout
+                                                                         * of n allows between n - 1 and n tick periods
+                                                                         **********************************************************************/
+void I2CQ_Tick(I2CQ_Type* i2cq)
+{
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (i2cq->Busy && (i2cq->Remaining != 0) && (--i2cq->Remaining == 0))
+    {
+        i2cq_complete(i2cq, I2CQ_TIMEOUT);
+    }
+    __set_PRIMASK(primask);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Tell whether the transaction queue is empty
+                                                                         * @param[in]	i2cq	I2C transaction queue
+                                                                         * @return		TRUE when every transaction has ended
+                                                                         **********************************************************************/
+Bool I2CQ_IsIdle(const I2CQ_Type* i2cq)
+{
+    return i2cq->Busy ? FALSE : TRUE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the transaction statistics
+                                                                         * @param[in]	i2cq	I2C transaction queue
+                                                                         * @param[out]	stats	Statistics since I2CQ_Init()
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void I2CQ_GetStats(const I2CQ_Type* i2cq, I2CQ_STATS_Type* stats)
+{
+    stats->Transfers = i2cq->Transfers;
+    stats->Bytes = i2cq->Bytes;
+    stats->MaxDepth = i2cq->MaxDepth;
+    stats->Nacks = i2cq->Nacks;
+    stats->Timeouts = i2cq->Timeouts;
+    stats->Errors = i2cq->Errors;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Serve the I2C interrupt, call from the I2Cn_IRQHandler of
+                                                                         * the bus. Moves the transaction on the bus by one state, and on
+                                                                         * its last state starts the next one
+                                                                         * @param[in]	i2cq	I2C transaction queue
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void I2CQ_IntHandler(I2CQ_Type* i2cq)
+{
+    LPC_I2C_TypeDef* I2Cx = i2cq->I2Cx;
+    I2CQ_XFER_Type* xfer = i2cq->Head;
+    uint8_t stat = I2Cx->I2STAT & I2C_STAT_CODE_BITMASK;
+
+    if (xfer == NULL)
+    {
+        /* Timed out transaction, or a slave state: nothing to do */
+        I2Cx->I2CONCLR = I2C_I2CONCLR_STAC | I2C_I2CONCLR_SIC;
+        return;
+    }
+
+    switch (stat)
+    {
+        /* START or repeated START: address the slave, for writing while there
+         * are bytes to write */
+        case I2C_I2STAT_M_TX_START:
+        case I2C_I2STAT_M_TX_RESTART:
+            if ((xfer->TxCount < xfer->TxLength) || (xfer->RxLength == 0))
+            {
+                I2Cx->I2DAT = (uint32_t)xfer->SlaveAddr << 1;
+            }
+            else
+            {
+                I2Cx->I2DAT = ((uint32_t)xfer->SlaveAddr << 1) | 0x01;
+            }
+            I2Cx->I2CONCLR = I2C_I2CONCLR_STAC | I2C_I2CONCLR_SIC;
+            break;
+
+        /* Address or byte acknowledged: next byte, then the repeated START of
+         * the read, or the end */
+        case I2C_I2STAT_M_TX_DAT_ACK:
+            xfer->TxCount++;
+            /* no break */
+        case I2C_I2STAT_M_TX_SLAW_ACK:
+            if (xfer->TxCount < xfer->TxLength)
+            {
+                I2Cx->I2DAT = xfer->TxData[xfer->TxCount];
+                I2Cx->I2CONCLR = I2C_I2CONCLR_SIC;
+            }
+            else if (xfer->RxLength != 0)
+            {
+                I2Cx->I2CONSET = I2C_I2CONSET_STA;
+                I2Cx->I2CONCLR = I2C_I2CONCLR_SIC;
+            }
+            else
+            {
+                i2cq_complete(i2cq, I2CQ_DONE);
+            }
+            break;
+
+        /* The last byte of a write may be refused, the slave has it */
+        case I2C_I2STAT_M_TX_DAT_NACK:
+            if ((xfer->TxCount + 1 == xfer->TxLength) && (xfer->RxLength == 0))
+            {
+                xfer->TxCount++;
+                i2cq_complete(i2cq, I2CQ_DONE);
+            }
+            else
+            {
+                i2cq_complete(i2cq, I2CQ_NACK);
+            }
+            break;
+
+        case I2C_I2STAT_M_TX_SLAW_NACK:
+        case I2C_I2STAT_M_RX_SLAR_NACK: i2cq_complete(i2cq, I2CQ_NACK); break;
+
+        /* Addressed for reading: acknowledge every byte but the last */
+        case I2C_I2STAT_M_RX_SLAR_ACK:
+            if (xfer->RxLength > 1)
+            {
+                I2Cx->I2CONSET = I2C_I2CONSET_AA;
+                I2Cx->I2CONCLR = I2C_I2CONCLR_SIC;
+            }
+            else
+            {
+                I2Cx->I2CONCLR = I2C_I2CONCLR_AAC | I2C_I2CONCLR_SIC;
+            }
+            break;
+
+        case I2C_I2STAT_M_RX_DAT_ACK:
+            xfer->RxData[xfer->RxCount++] = (uint8_t)I2Cx->I2DAT;
+            if (xfer->RxCount + 1 < xfer->RxLength)
+            {
+                I2Cx->I2CONSET = I2C_I2CONSET_AA;
+                I2Cx->I2CONCLR = I2C_I2CONCLR_SIC;
+            }
+            else
+            {
+                I2Cx->I2CONCLR = I2C_I2CONCLR_AAC | I2C_I2CONCLR_SIC;
+            }
+            break;
+
+        case I2C_I2STAT_M_RX_DAT_NACK:
+            xfer->RxData[xfer->RxCount++] = (uint8_t)I2Cx->I2DAT;
+            i2cq_complete(i2cq, I2CQ_DONE);
+            break;
+
+        case I2C_I2STAT_M_TX_ARB_LOST: i2cq_complete(i2cq, I2CQ_ARB_LOST); break;
+
+        case I2C_I2STAT_BUS_ERROR: i2cq_complete(i2cq, I2CQ_BUS_ERROR); break;
+
+        default: I2Cx->I2CONCLR = I2C_I2CONCLR_SIC; break;
+    }
+}
+
+/**
+ * @}
+ */
+
+#endif /* _I2CQ */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -0,0 +1,386 @@
+/**********************************************************************
+ * $Id$		lpc17xx_i2sdma.c				2010-05-21
+ *//**
+* @file		lpc17xx_i2sdma.c
+* @brief	Contains all functions support for the streaming I2S audio through GPDMA on LPC17xx
+* @version	2.0
+* @date		21. May. 2010
+* @author	NXP MCU SW Application Team
+*
+* Copyright(C) 2010, NXP Semiconductor
+* All rights reserved.
+*
+***********************************************************************
+* Software that is described herein is for illustrative purposes only
+* which provides customers with programming information regarding the
+* products. This software is supplied "AS IS" without any warranties.
+* NXP Semiconductors assumes no responsibility or liability for the
+* use of the software, conveys no license or title under any patent,
+* copyright, or mask work right to the product. NXP Semiconductors
+* reserves the right to make changes in the software without
+* notification. NXP Semiconductors also make no representation or
+* warranty that such application will be suitable for the specified
+* use without further testing or modification.
+* Permission to use, copy, modify, and distribute this software and its
+* documentation is hereby granted, under NXP Semiconductors'
+* relevant copyright in the software, without fee, provided that it
+* is used in conjunction with NXP Semiconductors microcontrollers.  This
+* copyright, permission, and disclaimer notice must appear in all copies of
+* this code.
+**********************************************************************/
+
+
+/* Peripheral group ----------------------------------------------------------- */
+/** @addtogroup I2SDMA
+ * @{
+ */
+
+/* Includes ------------------------------------------------------------------- */
+#include "lpc17xx_i2sdma.h"
+
+/* If this source file built with example, the LPC17xx FW library configuration
+ * file in each example directory ("lpc17xx_libcfg.h") must be included,
+ * otherwise the default FW library configuration file must be included instead
+ */
+#ifdef __BUILD_WITH_EXAMPLE__
+#include "lpc17xx_libcfg.h"
+#else
+#include "lpc17xx_libcfg_default.h"
+#endif /* __BUILD_WITH_EXAMPLE__ */
+
+#ifdef _I2SDMA
+
+/* Private Macros ------------------------------------------------------------- */
+/** @defgroup I2SDMA_Private_Macros I2SDMA Private Macros
+ * @{
+ */
+
+/** GPDMA channel registers of channel n */
+#define I2SDMA_DMACH(n) ((LPC_GPDMACH_TypeDef*)(LPC_GPDMACH0_BASE + ((uint32_t)(n) << 5)))
+
+/**
+ * @}
+ */
+
+/* Private Functions ---------------------------------------------------------- */
+/** @defgroup I2SDMA_Private_Functions I2SDMA Private Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Fill the GPDMA channel configuration of one direction
+                                                                         * @param[in]	stream	Audio stream
+                                                                         * @param[in]	dir		I2SDMA_TX or I2SDMA_RX
+                                                                         * @param[out]	dma_cfg	Channel configuration
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void i2sdma_dma_cfg(const I2SDMA_Type* stream, uint8_t dir, GPDMA_Channel_CFG_Type* dma_cfg)
+{
+    dma_cfg->TransferSize = 0;
+    dma_cfg->TransferWidth = 0;
+    dma_cfg->SrcMemAddr = 0;
+    dma_cfg->DstMemAddr = 0;
+    dma_cfg->DMALLI = 0;
+    if (dir == I2SDMA_TX)
+    {
+        dma_cfg->ChannelNum = stream->Cfg.TxDMAChannel;
+        dma_cfg->TransferType = GPDMA_TRANSFERTYPE_M2P;
+        dma_cfg->SrcConn = 0;
+        dma_cfg->DstConn = GPDMA_CONN_I2S_Channel_0;
+    }
+    else
+    {
+        dma_cfg->ChannelNum = stream->Cfg.RxDMAChannel;
+        dma_cfg->TransferType = GPDMA_TRANSFERTYPE_P2M;
+        dma_cfg->SrcConn = GPDMA_CONN_I2S_Channel_1;
+        dma_cfg->DstConn = 0;
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Build the circular chain of one direction, one item per half
+                                                                         * @param[in]	stream	Audio stream
+                                                                         * @param[in]	dir		I2SDMA_TX or I2SDMA_RX
+                                                                         * @return		Chain, NULL if the GPDMA descriptor pool is exhausted
+                                                                         **********************************************************************/
+static GPDMA_LLI_Type* i2sdma_chain(const I2SDMA_Type* stream, uint8_t dir)
+{
+    uint32_t half = stream->Cfg.BufferSize / 2;
+    uint32_t buf = ADDR32((dir == I2SDMA_TX) ? stream->Cfg.TxBuffer : stream->Cfg.RxBuffer);
+    GPDMA_Channel_CFG_Type dma_cfg;
+    GPDMA_SEGMENT_Type segs[2];
+    uint8_t i;
+
+    i2sdma_dma_cfg(stream, dir, &dma_cfg);
+    for (i = 0; i < 2; i++)
+    {
+        segs[i].SrcAddr = (dir == I2SDMA_TX) ? buf + i * half * 4 : 0;
+        segs[i].DstAddr = (dir == I2SDMA_TX) ? 0 : buf + i * half * 4;
+        segs[i].Size = half;
+    }
+    return GPDMA_LLI_Build(&dma_cfg, segs, 2, GPDMA_LLI_CIRCULAR | GPDMA_LLI_INT_SEGMENT);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Start one direction from the first half of its buffer
+                                                                         * @param[in]	stream	Audio stream
+                                                                         * @param[in]	dir		I2SDMA_TX or I2SDMA_RX
+                                                                         * @return		None
+                                                                         **********************************************************************/
+static void i2sdma_start_dir(I2SDMA_Type* stream, uint8_t dir)
+{
+    GPDMA_Channel_CFG_Type dma_cfg;
+
+    i2sdma_dma_cfg(stream, dir, &dma_cfg);
+    GPDMA_SetupChain(&dma_cfg, (dir == I2SDMA_TX) ? stream->TxChain : stream->RxChain);
+    if ((dir == I2SDMA_TX) && (stream->Cfg.Direction == I2SDMA_DUPLEX))
+    {
+        /* The receiver paces a duplex stream, the transmit half is found from its channel */
+        I2SDMA_DMACH(stream->Cfg.TxDMAChannel)->DMACCConfig &= ~GPDMA_DMACCxConfig_ITC;
+    }
+    GPDMA_ChannelCmd(dma_cfg.ChannelNum, ENABLE);
+    I2S_DMACmd(LPC_I2S, (dir == I2SDMA_TX) ? I2S_DMA_1 : I2S_DMA_2, (dir == I2SDMA_TX) ? I2S_TX_MODE : I2S_RX_MODE,
+               ENABLE);
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the half of a direction its channel has finished last
+                                                                         * @param[in]	ch		GPDMA channel of the direction
+                                                                         * @param[in]	chain	Chain of the direction
+                                                                         * @return		0 or 1
+                                                                         **********************************************************************/
+static uint8_t i2sdma_done_half(uint8_t ch, const GPDMA_LLI_Type* chain)
+{
+    /* The channel has loaded the item of the half it now moves, whose link
+     * points back at the finished one */
+    return (I2SDMA_DMACH(ch)->DMACCLLI == ADDR32(chain)) ? 0 : 1;
+}
+
+/**
+ * @}
+ */
+
+/* Public Functions ----------------------------------------------------------- */
+/** @addtogroup I2SDMA_Public_Functions
+ * @{
+ */
+
+/*********************************************************************/ /**
+                                                                         * @brief		Initialize an audio stream: power the I2S, set 16-bit words at
+                                                                         * the requested rate, route the FIFOs to DMA requests at half level
+                                                                         * and build the ping-pong chains
+                                                                         * @param[in]	stream	Audio stream
+                                                                         * @param[in]	cfg		Configuration, copied
+                                                                         * @return		ERROR if the rate cannot be reached or the GPDMA descriptor
+                                                                         * pool is exhausted
+                                                                         * @note		GPDMA_Init() must have been called, the I2S pins must be set to
+                                                                         * their function. The transmitter is the master of the bus clocks
+                                                                         **********************************************************************/
+Status I2SDMA_Init(I2SDMA_Type* stream, const I2SDMA_CFG_Type* cfg)
+{
+    I2S_CFG_Type i2s_cfg;
+    I2S_MODEConf_Type mode;
+    I2S_DMAConf_Type dma;
+
+    CHECK_PARAM(PARAM_I2SDMA_SIZE(cfg->BufferSize));
+    CHECK_PARAM(PARAM_I2SDMA_DIR(cfg->Direction));
+    CHECK_PARAM(PARAM_I2S_CHANNEL(cfg->Mono));
+    CHECK_PARAM(PRAM_I2S_FREQ(cfg->Rate));
+    CHECK_PARAM(PARAM_GPDMA_CHANNEL(cfg->TxDMAChannel));
+    CHECK_PARAM(PARAM_GPDMA_CHANNEL(cfg->RxDMAChannel));
+
+    stream->Cfg = *cfg;
+    stream->TxChain = NULL;
+    stream->RxChain = NULL;
+    stream->Overruns = 0;
+    stream->NextHalf = 0;
+
+    I2S_Init(LPC_I2S);
+    i2s_cfg.wordwidth = I2S_WORDWIDTH_16;
+    i2s_cfg.mono = cfg->Mono;
+    i2s_cfg.stop = I2S_STOP_ENABLE;
+    i2s_cfg.reset = I2S_RESET_ENABLE;
+    i2s_cfg.ws_sel = I2S_MASTER_MODE;
+    i2s_cfg.mute = I2S_MUTE_DISABLE;
+    I2S_Config(LPC_I2S, I2S_TX_MODE, &i2s_cfg);
+
+    /* In duplex the receiver takes the transmitter clocks (4-pin mode): both
+     * directions move their words on the same edges */
+    mode.clksel = I2S_CLKSEL_FRDCLK;
+    mode.fpin = I2S_4PIN_DISABLE;
+    mode.mcena = I2S_MCLK_DISABLE;
+    I2S_ModeConfig(LPC_I2S, &mode, I2S_TX_MODE);
+    if (cfg->Direction == I2SDMA_DUPLEX)
+    {
+        i2s_cfg.ws_sel = I2S_SLAVE_MODE;
+        mode.fpin = I2S_4PIN_ENABLE;
+    }
+    I2S_Config(LPC_I2S, I2S_RX_MODE, &i2s_cfg);
+    I2S_ModeConfig(LPC_I2S, &mode, I2S_RX_MODE);
+
+    if (I2S_FreqConfig(LPC_I2S, cfg->Rate, (cfg->Direction == I2SDMA_RX) ? I2S_RX_MODE : I2S_TX_MODE) != SUCCESS)
+    {
+        return ERROR;
+    }
+
+    /* DMA1 feeds the transmitter, DMA2 drains the receiver: the GPDMA
+     * connections I2S_Channel_0 and I2S_Channel_1 point at those FIFOs */
+    dma.DMAIndex = I2S_DMA_1;
+    dma.depth = I2SDMA_DEPTH;
+    I2S_DMAConfig(LPC_I2S, &dma, I2S_TX_MODE);
+    dma.DMAIndex = I2S_DMA_2;
+    I2S_DMAConfig(LPC_I2S, &dma, I2S_RX_MODE);
+
+    if (cfg->Direction & I2SDMA_TX)
+    {
+        stream->TxChain = i2sdma_chain(stream, I2SDMA_TX);
+        if (stream->TxChain == NULL)
+        {
+            return ERROR;
+        }
+    }
+    if (cfg->Direction & I2SDMA_RX)
+    {
+        stream->RxChain = i2sdma_chain(stream, I2SDMA_RX);
+        if (stream->RxChain == NULL)
+        {
+            GPDMA_LLI_Free(stream->TxChain);
+            stream->TxChain = NULL;
+            return ERROR;
+        }
+    }
+    return SUCCESS;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Start streaming from the first half of the buffers. The
+                                                                         * transmit buffer is cleared, the first buffer played is silence
+                                                                         * @param[in]	stream	Audio stream
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void I2SDMA_Start(I2SDMA_Type* stream)
+{
+    uint32_t i;
+
+    I2SDMA_Stop(stream);
+    stream->NextHalf = 0;
+
+    /* The transmit FIFO is filled before the clocks run, the transmitter
+     * starts first so that a 4-pin receiver follows its word clock */
+    if (stream->Cfg.Direction & I2SDMA_TX)
+    {
+        for (i = 0; i < I2SDMA_SAMPLES(stream->Cfg.BufferSize); i++)
+        {
+            stream->Cfg.TxBuffer[i] = 0;
+        }
+        i2sdma_start_dir(stream, I2SDMA_TX);
+    }
+    if (stream->Cfg.Direction & I2SDMA_RX)
+    {
+        i2sdma_start_dir(stream, I2SDMA_RX);
+    }
+    if (stream->Cfg.Direction & I2SDMA_TX)
+    {
+        LPC_I2S->I2SDAO &= ~(I2S_DAO_RESET | I2S_DAO_STOP | I2S_DAO_MUTE);
+    }
+    if (stream->Cfg.Direction & I2SDMA_RX)
+    {
+        LPC_I2S->I2SDAI &= ~(I2S_DAI_RESET | I2S_DAI_STOP);
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Stop streaming, flush the FIFOs and release the DMA channels
+                                                                         * @param[in]	stream	Audio stream
+                                                                         * @return		None
+                                                                         **********************************************************************/
+void I2SDMA_Stop(I2SDMA_Type* stream)
+{
+    if (stream->Cfg.Direction & I2SDMA_TX)
+    {
+        I2S_Stop(LPC_I2S, I2S_TX_MODE);
+        I2S_DMACmd(LPC_I2S, I2S_DMA_1, I2S_TX_MODE, DISABLE);
+        GPDMA_ChannelCmd(stream->Cfg.TxDMAChannel, DISABLE);
+        LPC_GPDMA->DMACIntTCClear = GPDMA_DMACIntTCClear_Ch(stream->Cfg.TxDMAChannel);
+    }
+    if (stream->Cfg.Direction & I2SDMA_RX)
+    {
+        I2S_Stop(LPC_I2S, I2S_RX_MODE);
+        I2S_DMACmd(LPC_I2S, I2S_DMA_2, I2S_RX_MODE, DISABLE);
+        GPDMA_ChannelCmd(stream->Cfg.RxDMAChannel, DISABLE);
+        LPC_GPDMA->DMACIntTCClear = GPDMA_DMACIntTCClear_Ch(stream->Cfg.RxDMAChannel);
+    }
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Serve the terminal count of the stream, call from
+                                                                         * DMA_IRQHandler. Calls the callback with the halves to process, the
+                                                                         * DMA is already moving the other ones
+                                                                         * @param[in]	stream	Audio stream
+                                                                         * @return		TRUE if the interrupt was for this stream
+                                                                         **********************************************************************/
+Bool I2SDMA_IntHandler(I2SDMA_Type* stream)
+{
+    uint32_t half = stream->Cfg.BufferSize / 2;
+    uint8_t rx_dir = (stream->Cfg.Direction & I2SDMA_RX) != 0;
+    uint8_t ch = rx_dir ? stream->Cfg.RxDMAChannel : stream->Cfg.TxDMAChannel;
+    int16_t* rx = NULL;
+    int16_t* tx = NULL;
+    uint8_t done;
+
+    if (!(LPC_GPDMA->DMACIntTCStat & GPDMA_DMACIntTCStat_Ch(ch)))
+    {
+        return FALSE;
+    }
+    LPC_GPDMA->DMACIntTCClear = GPDMA_DMACIntTCClear_Ch(ch);
+
+    done = i2sdma_done_half(ch, rx_dir ? stream->RxChain : stream->TxChain);
+    if (done != stream->NextHalf)
+    {
+        stream->Overruns++;
+    }
+    stream->NextHalf = done ^ 1;
+
+    if (rx_dir)
+    {
+        rx = stream->Cfg.RxBuffer + done * I2SDMA_SAMPLES(half);
+    }
+    if (stream->Cfg.Direction & I2SDMA_TX)
+    {
+        /* In duplex the transmitter has moved a FIFO ahead: refill the half it left */
+        if (rx_dir)
+        {
+            done = i2sdma_done_half(stream->Cfg.TxDMAChannel, stream->TxChain);
+        }
+        tx = stream->Cfg.TxBuffer + done * I2SDMA_SAMPLES(half);
+    }
+
+    if (stream->Cfg.Callback != NULL)
+    {
+        stream->Cfg.Callback(rx, tx, I2SDMA_SAMPLES(half));
+    }
+    return TRUE;
+}
+
+/*********************************************************************/ /**
+                                                                         * @brief		Get the number of halves lost because the callback did not
+                                                                         * return before the DMA wrapped around
+                                                                         * @param[in]	stream	Audio stream
+                                                                         * @return		Overrun count since I2SDMA_Init()
+                                                                         **********************************************************************/
+uint32_t I2SDMA_GetOverruns(const I2SDMA_Type* stream)
+{
+    return stream->Overruns;
+}
+
+/**
+ * @}
+ */
+
+#endif /* _I2SDMA */
+
+/**
+ * @}
+ */
+
+/* --------------------------------- End Of File ------------------------------ */
@@ -0,0 +1,140 @@
+/**************************************************************************//**
+ * @file     sim_LPC17xx.h
+ * @brief    Host register simulator for the NXP LPC17xx Device Series
+ * @version  V1.00
+ *
+ * @note
+ * Only used when the library is built for the host (-D__USE_HOST_SIM).
+ * The peripheral address map of LPC17xx.h is backed by host memory placed
+ * at the same addresses, so the driver library runs unchanged on Linux.
+ * Register blocks with side effects (FIFOs, write-1-to-clear bits, status
+ * flags, IRQ lines) are attached to a behavioural model; every access to
+ * them traps into the model, all other registers are plain memory.
+ *
+ ******************************************************************************/
+
+
+#ifndef __SIM_LPC17xx_H
+#define __SIM_LPC17xx_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "LPC17xx.h"
+
+/** @addtogroup LPC17xx_Simulator
+ * @{
+ */
+
+#define SIM_CORE_CLOCK        100000000UL   /*!< Simulated core clock after SystemInit [Hz] */
+#define SIM_MAX_MODELS        32            /*!< Maximum number of attached peripheral models */
+#define SIM_UART_BUF_SIZE     4096          /*!< Host side UART RX backlog / TX capture size */
+#define SIM_CAN_BUF_SIZE      1024          /*!< Host side CAN RX backlog / TX capture size, frames */
+#define SIM_EMAC_BUF_SIZE     64            /*!< Host side EMAC RX backlog / TX capture size, frames */
+#define SIM_EMAC_MAX_FLEN     1536          /*!< Longest EMAC frame the host side holds, FCS included */
+
+
+/**
+ * @brief  Behavioural model of one peripheral register block.
+ *
+ * All hooks are optional. Hooks receive the offset of the accessed word
+ * from @ref base and work on the register image through SIM_Reg(), never
+ * through the peripheral pointers of LPC17xx.h.
+ */
+typedef struct SIM_Model
+{
+    uint32_t base;                                                         /*!< Register block base address (4 KB aligned)     */
+    const char* name;                                                      /*!< Name used in statistics                        */
+    void (*reset)(struct SIM_Model* model);                                /*!< Load reset values                              */
+    void (*read)(struct SIM_Model* model, uint32_t offset);                /*!< Before a load, refresh computed registers      */
+    void (*read_done)(struct SIM_Model* model, uint32_t offset);           /*!< After a load, read-to-clear side effects       */
+    void (*write)(struct SIM_Model* model, uint32_t offset, uint32_t prev);/*!< After a store, prev is the word before it      */
+    void (*advance)(struct SIM_Model* model, uint32_t cycles);             /*!< Simulated time has moved on                    */
+    void (*update)(struct SIM_Model* model);                               /*!< Re-evaluate IRQ and DMA request lines          */
+    uint64_t accesses;                                                     /*!< Number of trapped accesses                     */
+} SIM_Model_Type;
+
+
+/**
+ * @brief  CAN frame as seen on the bus, for SIM_CAN_Inject() / SIM_CAN_Drain()
+ */
+typedef struct
+{
+    uint32_t id;                                  /*!< Identifier, 11 or 29 bits      */
+    uint8_t ext;                                  /*!< 1: 29 bit identifier           */
+    uint8_t rtr;                                  /*!< 1: remote frame                */
+    uint8_t len;                                  /*!< Data length code, 0..8         */
+    uint8_t data[8];                              /*!< Data bytes                     */
+} SIM_CAN_Frame_Type;
+
+
+/* Simulator control ---------------------------------------------------------*/
+extern void SIM_Init (void);
+extern void SIM_Reset (void);
+extern void SIM_AttachModel (SIM_Model_Type* model);
+extern void SIM_DetachModel (uint32_t base);
+extern volatile uint32_t* SIM_Reg (uint32_t addr);
+extern uint32_t SIM_Addr32 (const volatile void* p);
+extern uint32_t SIM_BusRead (uint32_t addr, uint8_t size);
+extern void SIM_BusWrite (uint32_t addr, uint32_t value, uint8_t size);
+extern uint32_t SIM_Read (uint32_t addr, uint8_t size);
+extern void SIM_Write (uint32_t addr, uint32_t value, uint8_t size);
+
+/* Simulated time ------------------------------------------------------------*/
+extern void SIM_Advance (uint32_t cycles);
+extern uint64_t SIM_GetCycles (void);
+extern void SIM_SetAccessCost (uint32_t cycles);
+extern void SIM_SetAccessEmulation (uint8_t enable);
+
+/* Interrupts ----------------------------------------------------------------*/
+extern void SIM_SetPendingIRQ (IRQn_Type IRQn);
+extern void SIM_ServiceIRQ (void);
+extern void SIM_WaitForInterrupt (void);
+extern void SIM_SetAsyncIRQ (uint8_t enable);
+
+/* Statistics ----------------------------------------------------------------*/
+extern uint64_t SIM_GetAccessCount (void);
+extern uint64_t SIM_GetIRQCount (IRQn_Type IRQn);
+
+/* Peripheral models (sim_LPC17xx_periph.c) ----------------------------------*/
+extern void SIM_AttachDefaultModels (void);
+extern void SIM_DMARequest (uint8_t connection, uint8_t level);
+extern void SIM_DMAPulse (uint8_t connection);
+extern void SIM_GPIO_SetInput (uint8_t port, uint32_t mask, uint32_t value);
+extern uint32_t SIM_GPIO_GetOutput (uint8_t port);
+extern void SIM_UART_Inject (uint8_t uart, const uint8_t* data, uint32_t len);
+extern uint32_t SIM_UART_Drain (uint8_t uart, uint8_t* data, uint32_t max);
+extern void SIM_UART_SetPaced (uint8_t uart, uint8_t enable);
+extern void SIM_SSP_SetDevice (uint8_t ssp, uint16_t (*device)(uint8_t ssp, uint16_t mosi));
+extern void SIM_I2C_Inject (uint8_t i2c, const uint8_t* stat, const uint8_t* data, uint32_t len);
+extern uint32_t SIM_I2C_Drain (uint8_t i2c, uint8_t* data, uint32_t max);
+extern uint32_t SIM_I2C_GetStops (uint8_t i2c);
+extern void SIM_CAN_Inject (uint8_t can, const SIM_CAN_Frame_Type* frames, uint32_t count);
+extern uint32_t SIM_CAN_Drain (uint8_t can, SIM_CAN_Frame_Type* frames, uint32_t max);
+extern void SIM_CAN_SetPaced (uint8_t can, uint8_t enable);
+extern uint32_t SIM_EMAC_Inject (const uint8_t* frame, uint32_t len);
+extern uint32_t SIM_EMAC_Drain (uint8_t* frame, uint32_t max);
+extern void SIM_EMAC_SetPaced (uint8_t enable);
+extern uint32_t SIM_EMAC_GetDropped (void);
+extern void SIM_EMAC_Fault (uint32_t status);
+extern void SIM_EMAC_SetPHYTiming (uint32_t reset_us, uint32_t aneg_us);
+extern void SIM_EMAC_SetLink (uint8_t up);
+extern void SIM_TIM_CaptureInput (uint8_t timer, uint8_t channel, uint8_t level);
+extern void SIM_ADC_SetInput (uint8_t channel, uint16_t value);
+extern void SIM_DAC_SetSink (void (*sink)(uint16_t value, uint64_t cycle));
+extern uint16_t SIM_DAC_GetOutput (void);
+extern void SIM_I2S_SetSource (uint32_t (*source)(uint64_t cycle));
+extern void SIM_I2S_SetSink (void (*sink)(uint32_t word, uint64_t cycle));
+extern void SIM_I2S_GetErrors (uint32_t* underruns, uint32_t* overruns);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SIM_LPC17xx_H */
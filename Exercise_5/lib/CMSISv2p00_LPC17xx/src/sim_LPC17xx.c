@@ -0,0 +1,1217 @@
+/**************************************************************************//**
+ * @file     sim_LPC17xx.c
+ * @brief    Host register simulator for the NXP LPC17xx Device Series,
+ *           memory map, access trapping, NVIC and simulated time
+ * @version  V1.00
+ *
+ * @note
+ * The LPC17xx address ranges are mapped twice from one memfd: once at the
+ * real addresses, used by the unchanged driver code, and once as a shadow
+ * view used by the models. Pages owned by a model are PROT_NONE in the real
+ * view. A load or store to them raises SIGSEGV. The common x86-64 mov forms
+ * the compiler emits for register accesses are decoded and carried out by
+ * the handler on the model bus (SIM_BusRead/SIM_BusWrite), one signal per
+ * access. Any other instruction takes the slow path: the handler runs the
+ * model's hook, opens the page and single steps the faulting instruction
+ * (x86 TF); the SIGTRAP that follows runs the store hook and closes the page
+ * again. Unmodelled registers are ordinary memory and cost nothing extra.
+ * A trapped access costs a signal delivery, a plain LPC_x->REG access runs
+ * at about 300 thousand per second decoded and 60 to 80 thousand single
+ * stepped: well below the millions of accesses per second the target does.
+ * Only HWREG_READ() and HWREG_WRITE() (lpc_types.h) skip the trap and reach
+ * about 2 million per second. The hot driver paths use them, every other
+ * register access in the drivers and applications runs at the trapped rate.
+ * Figures of tools/sim_bench.c on an idle host.
+ * The bit-band alias of the AHB SRAM / GPIO range is a PROT_NONE mapping
+ * too; its accesses are turned into read-modify-writes of the target word.
+ *
+ ******************************************************************************/
+
+#ifdef __USE_HOST_SIM
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "LPC17xx.h"
+#include "sim_LPC17xx.h"
+
+#if !defined(__linux__) || !defined(__x86_64__)
+#error "The LPC17xx host simulator needs Linux on x86-64"
+#endif
+
+/** @addtogroup LPC17xx_Simulator
+ * @{
+ */
+
+#define SIM_PAGE_SIZE     4096UL
+#define SIM_MAX_NEST      8                 /* nested trapped accesses (IRQs taken inside a trap) */
+#define SIM_EFLAGS_TF     0x100             /* x86 trap flag                                   */
+#define SIM_PF_WRITE      0x2               /* page fault error code: write access             */
+#define SIM_NUM_IRQ       35                /* WDT_IRQn .. CANActivity_IRQn                     */
+#define SIM_WFI_STEP      100               /* cycles advanced per __WFI poll                  */
+#define SIM_WFI_LIMIT     1000000000UL      /* give up waiting for an IRQ after 10 s          */
+#define SIM_BB_REF        0x20000000UL      /* SRAM bit-band region                            */
+#define SIM_BB_ALIAS      0x22000000UL      /* SRAM bit-band alias                             */
+#define SIM_BB_BASE       (SIM_BB_ALIAS + ((LPC_AHBRAM0_BASE - SIM_BB_REF) << 5))
+#define SIM_BB_SIZE       (0x24000UL << 5)  /* alias of the AHB SRAM banks and GPIO            */
+
+/* Address ranges backed by the simulator */
+typedef struct
+{
+    uint32_t base;
+    uint32_t size;
+    uint8_t* shadow;
+    SIM_Model_Type** pages;
+} SIM_Region_Type;
+
+/* One trapped access in flight */
+typedef struct
+{
+    SIM_Model_Type* model;
+    uint32_t addr;
+    uint32_t prev;
+    uint8_t write;
+    uint8_t alias;                            /* bit-band alias access, model is NULL */
+} SIM_Access_Type;
+
+/* A decoded load or store, one of the mov forms sim_decode() knows */
+typedef struct
+{
+    uint8_t len;                              /* instruction length                    */
+    uint8_t size;                             /* access size in bytes                  */
+    uint8_t write;
+    uint8_t sign;                             /* movsx: sign extend the loaded value   */
+    uint8_t dsize;                            /* size of the loaded register           */
+    uint8_t high;                             /* AH, CH, DH or BH                      */
+    int8_t reg;                               /* gregs index, -1: immediate            */
+    uint32_t imm;
+} SIM_Insn_Type;
+
+static SIM_Model_Type* sim_pages_ram[(0x24000UL)  / SIM_PAGE_SIZE];
+static SIM_Model_Type* sim_pages_apb[(0x100000UL) / SIM_PAGE_SIZE];
+static SIM_Model_Type* sim_pages_ahb[(0x10000UL)  / SIM_PAGE_SIZE];
+static SIM_Model_Type* sim_pages_ppb[(0x10000UL)  / SIM_PAGE_SIZE];
+
+static SIM_Region_Type sim_regions[] =
+{
+    { LPC_AHBRAM0_BASE, 0x24000UL,  NULL, sim_pages_ram },  /* AHB SRAM banks and GPIO    */
+    { LPC_APB0_BASE,    0x100000UL, NULL, sim_pages_apb },  /* APB0 and APB1 peripherals  */
+    { LPC_AHB_BASE,     0x10000UL,  NULL, sim_pages_ahb },  /* EMAC, GPDMA, USB           */
+    { ITM_BASE,         0x10000UL,  NULL, sim_pages_ppb },  /* ITM, DWT, SCS (NVIC, SCB)  */
+};
+
+#define SIM_NUM_REGIONS   (sizeof(sim_regions) / sizeof(sim_regions[0]))
+
+volatile SIM_CoreReg_Type SIM_CoreReg;
+volatile uint32_t* volatile SIM_ExclusiveAddr;
+
+static SIM_Model_Type* sim_models[SIM_MAX_MODELS];
+static uint32_t sim_num_models;
+static SIM_Access_Type sim_access[SIM_MAX_NEST];
+static volatile int sim_depth;
+static uint8_t sim_initialized;
+static uint8_t sim_async_irq = 1;
+static uint8_t sim_emulate_access = 1;
+static uint32_t sim_access_cost = 1;
+static uint64_t sim_cycles;
+static uint64_t sim_num_accesses;
+static uint64_t sim_irq_count[SIM_NUM_IRQ + 16];
+static uint64_t sim_irq_taken;
+static uint32_t sim_active_prio = 0x100;
+
+/* Host vector table: the application's handlers, if it defines them */
+#define SIM_WEAK __attribute__((weak))
+SIM_WEAK void SysTick_Handler(void);
+SIM_WEAK void PendSV_Handler(void);
+SIM_WEAK void WDT_IRQHandler(void);
+SIM_WEAK void TIMER0_IRQHandler(void);
+SIM_WEAK void TIMER1_IRQHandler(void);
+SIM_WEAK void TIMER2_IRQHandler(void);
+SIM_WEAK void TIMER3_IRQHandler(void);
+SIM_WEAK void UART0_IRQHandler(void);
+SIM_WEAK void UART1_IRQHandler(void);
+SIM_WEAK void UART2_IRQHandler(void);
+SIM_WEAK void UART3_IRQHandler(void);
+SIM_WEAK void PWM1_IRQHandler(void);
+SIM_WEAK void I2C0_IRQHandler(void);
+SIM_WEAK void I2C1_IRQHandler(void);
+SIM_WEAK void I2C2_IRQHandler(void);
+SIM_WEAK void SPI_IRQHandler(void);
+SIM_WEAK void SSP0_IRQHandler(void);
+SIM_WEAK void SSP1_IRQHandler(void);
+SIM_WEAK void PLL0_IRQHandler(void);
+SIM_WEAK void RTC_IRQHandler(void);
+SIM_WEAK void EINT0_IRQHandler(void);
+SIM_WEAK void EINT1_IRQHandler(void);
+SIM_WEAK void EINT2_IRQHandler(void);
+SIM_WEAK void EINT3_IRQHandler(void);
+SIM_WEAK void ADC_IRQHandler(void);
+SIM_WEAK void BOD_IRQHandler(void);
+SIM_WEAK void USB_IRQHandler(void);
+SIM_WEAK void CAN_IRQHandler(void);
+SIM_WEAK void DMA_IRQHandler(void);
+SIM_WEAK void I2S_IRQHandler(void);
+SIM_WEAK void ENET_IRQHandler(void);
+SIM_WEAK void RIT_IRQHandler(void);
+SIM_WEAK void MCPWM_IRQHandler(void);
+SIM_WEAK void QEI_IRQHandler(void);
+SIM_WEAK void PLL1_IRQHandler(void);
+
+static void (*const sim_vectors[SIM_NUM_IRQ])(void) =
+{
+    WDT_IRQHandler,    TIMER0_IRQHandler, TIMER1_IRQHandler, TIMER2_IRQHandler,
+    TIMER3_IRQHandler, UART0_IRQHandler,  UART1_IRQHandler,  UART2_IRQHandler,
+    UART3_IRQHandler,  PWM1_IRQHandler,   I2C0_IRQHandler,   I2C1_IRQHandler,
+    I2C2_IRQHandler,   SPI_IRQHandler,    SSP0_IRQHandler,   SSP1_IRQHandler,
+    PLL0_IRQHandler,   RTC_IRQHandler,    EINT0_IRQHandler,  EINT1_IRQHandler,
+    EINT2_IRQHandler,  EINT3_IRQHandler,  ADC_IRQHandler,    BOD_IRQHandler,
+    USB_IRQHandler,    CAN_IRQHandler,    DMA_IRQHandler,    I2S_IRQHandler,
+    ENET_IRQHandler,   RIT_IRQHandler,    MCPWM_IRQHandler,  QEI_IRQHandler,
+    PLL1_IRQHandler,   NULL,              NULL,
+};
+
+
+/*----------------------------------------------------------------------------
+  Memory map
+ *----------------------------------------------------------------------------*/
+static SIM_Region_Type* sim_region(uint32_t addr)
+{
+    uint32_t i;
+
+    for (i = 0; i < SIM_NUM_REGIONS; i++)
+    {
+        if ((addr - sim_regions[i].base) < sim_regions[i].size)
+        {
+            return &sim_regions[i];
+        }
+    }
+    return NULL;
+}
+
+static SIM_Model_Type* sim_model_at(uint32_t addr)
+{
+    SIM_Region_Type* region = sim_region(addr);
+
+    if (region == NULL)
+    {
+        return NULL;
+    }
+    return region->pages[(addr - region->base) / SIM_PAGE_SIZE];
+}
+
+static void sim_protect(uint32_t addr, int prot)
+{
+    mprotect((void*)(uintptr_t)(addr & ~(SIM_PAGE_SIZE - 1)), SIM_PAGE_SIZE, prot);
+}
+
+/**
+ * Shadow (always accessible) view of a simulated register
+ *
+ * @param  addr  LPC17xx address of the register
+ * @return pointer to the register image, NULL outside the simulated map
+ */
+volatile uint32_t* SIM_Reg(uint32_t addr)
+{
+    SIM_Region_Type* region = sim_region(addr);
+
+    if (region == NULL)
+    {
+        return NULL;
+    }
+    return (volatile uint32_t*)(region->shadow + ((addr - region->base) & ~3UL));
+}
+
+/**
+ * 32-bit bus address of a host object, ADDR32() of the drivers
+ *
+ * @param  p  object handed to a peripheral register, a DMA or a descriptor
+ * @return its address; the program stops if it lies above 4 GB, where a
+ *         truncated address would silently point elsewhere
+ */
+uint32_t SIM_Addr32(const volatile void* p)
+{
+    if ((uintptr_t)p > 0xFFFFFFFFUL)
+    {
+        fprintf(stderr, "sim: %p is out of reach of the 32-bit bus (a stack or mmap buffer?)\n", (const void*)p);
+        abort();
+    }
+    return (uint32_t)(uintptr_t)p;
+}
+
+
+/*----------------------------------------------------------------------------
+  Access trapping
+ *----------------------------------------------------------------------------*/
+static void sim_advance(uint32_t cycles);
+
+static void sim_fault(int sig)
+{
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+/* Target word and bit of a bit-band alias address */
+static uint32_t sim_bb_word(uint32_t alias)
+{
+    return SIM_BB_REF + (((alias - SIM_BB_ALIAS) >> 5) & ~3UL);
+}
+
+static uint32_t sim_bb_bit(uint32_t alias)
+{
+    return (alias >> 2) & 0x1F;
+}
+
+/* gregs index of x86-64 register number n */
+static const uint8_t sim_gregs[16] =
+{
+    REG_RAX, REG_RCX, REG_RDX, REG_RBX, REG_RSP, REG_RBP, REG_RSI, REG_RDI,
+    REG_R8,  REG_R9,  REG_R10, REG_R11, REG_R12, REG_R13, REG_R14, REG_R15,
+};
+
+/* Decode mov, movzx and movsx between a register or an immediate and memory */
+static int sim_decode(const uint8_t* ip, SIM_Insn_Type* insn)
+{
+    const uint8_t* p = ip;
+    uint8_t opsize = 4;
+    uint8_t rex = 0;
+    uint8_t op;
+    uint8_t modrm;
+    uint8_t r;
+
+    if (*p == 0x66)
+    {
+        opsize = 2;
+        p++;
+    }
+    if ((*p & 0xF0) == 0x40)
+    {
+        rex = *p++;
+    }
+    memset(insn, 0, sizeof(*insn));
+
+    op = *p++;
+    switch (op)
+    {
+        case 0x88: insn->write = 1; insn->size = 1; break;
+        case 0x89: insn->write = 1; insn->size = opsize; break;
+        case 0x8A: insn->size = 1; insn->dsize = 1; break;
+        case 0x8B: insn->size = opsize; insn->dsize = opsize; break;
+        case 0xC6: insn->write = 1; insn->size = 1; break;
+        case 0xC7: insn->write = 1; insn->size = opsize; break;
+        case 0x63:                                      /* movsxd r64, m32 */
+            if (!(rex & 8))
+            {
+                return 0;
+            }
+            insn->size = 4;
+            insn->sign = 1;
+            break;
+        case 0x0F:
+            op = *p++;
+            if ((op & 0xF6) != 0xB6)                    /* B6/B7 movzx, BE/BF movsx */
+            {
+                return 0;
+            }
+            insn->size = (op & 1) ? 2 : 1;
+            insn->dsize = opsize;
+            insn->sign = (op & 8) != 0;
+            break;
+        default: return 0;
+    }
+    if (rex & 8)
+    {
+        /* 64-bit loads and stores are no register accesses, leave them to the slow path */
+        if (insn->write || op == 0x8A || op == 0x8B)
+        {
+            return 0;
+        }
+        insn->dsize = 8;
+    }
+
+    modrm = *p++;
+    r = ((modrm >> 3) & 7) | ((rex & 4) ? 8 : 0);
+    if ((modrm >> 6) == 3)
+    {
+        return 0;
+    }
+    if ((modrm & 7) == 4)
+    {
+        if ((modrm >> 6) == 0 && (*p & 7) == 5)
+        {
+            p += 4;                                     /* SIB without base, disp32 */
+        }
+        p++;
+    }
+    else if ((modrm >> 6) == 0 && (modrm & 7) == 5)
+    {
+        p += 4;                                         /* RIP relative */
+    }
+    p += ((modrm >> 6) == 1) ? 1 : ((modrm >> 6) == 2) ? 4 : 0;
+
+    if (op == 0xC6 || op == 0xC7)
+    {
+        if (r != 0)
+        {
+            return 0;
+        }
+        insn->reg = -1;
+        switch (insn->size)
+        {
+            case 1:  insn->imm = p[0]; break;
+            case 2:  insn->imm = p[0] | ((uint32_t)p[1] << 8); break;
+            default: memcpy(&insn->imm, p, 4); break;
+        }
+        p += insn->size;
+    }
+    else if ((op == 0x88 || op == 0x8A) && rex == 0 && r >= 4)
+    {
+        insn->reg = (int8_t)sim_gregs[r - 4];
+        insn->high = 1;
+    }
+    else
+    {
+        insn->reg = (int8_t)sim_gregs[r];
+    }
+    insn->len = (uint8_t)(p - ip);
+    return 1;
+}
+
+/* Time, statistics and interrupts after each trapped access */
+static void sim_access_done(void)
+{
+    sim_num_accesses++;
+    if (sim_access_cost != 0)
+    {
+        sim_advance(sim_access_cost);
+    }
+    if (sim_async_irq)
+    {
+        SIM_ServiceIRQ();
+    }
+}
+
+/* Carry out a decoded access on the model bus and step over the instruction */
+static int sim_emulate(ucontext_t* uc, uint32_t addr, uint8_t alias)
+{
+    greg_t* gregs = uc->uc_mcontext.gregs;
+    SIM_Insn_Type insn;
+    uint64_t reg;
+    uint32_t value;
+
+    if (!sim_decode((const uint8_t*)gregs[REG_RIP], &insn) || (alias && (addr & 3) != 0))
+    {
+        return 0;
+    }
+
+    if (insn.write)
+    {
+        value = (insn.reg < 0) ? insn.imm : (uint32_t)((uint64_t)gregs[insn.reg] >> (insn.high ? 8 : 0));
+        if (alias)
+        {
+            /* Locked read-modify-write of the target word, as the bus matrix does */
+            uint32_t word = sim_bb_word(addr);
+            uint32_t mask = 1UL << sim_bb_bit(addr);
+
+            SIM_BusWrite(word, (SIM_BusRead(word, 4) & ~mask) | ((value & 1UL) ? mask : 0), 4);
+        }
+        else
+        {
+            SIM_BusWrite(addr, value, insn.size);
+        }
+    }
+    else
+    {
+        value = alias ? ((SIM_BusRead(sim_bb_word(addr), 4) >> sim_bb_bit(addr)) & 1UL) : SIM_BusRead(addr, insn.size);
+        if (insn.sign)
+        {
+            reg = (insn.size == 1) ? (uint64_t)(int64_t)(int8_t)value
+                : (insn.size == 2) ? (uint64_t)(int64_t)(int16_t)value : (uint64_t)(int64_t)(int32_t)value;
+        }
+        else
+        {
+            reg = value;
+        }
+        switch (insn.dsize)
+        {
+            case 1:
+                if (insn.high)
+                {
+                    gregs[insn.reg] = (greg_t)(((uint64_t)gregs[insn.reg] & ~0xFF00ULL) | ((reg & 0xFF) << 8));
+                }
+                else
+                {
+                    gregs[insn.reg] = (greg_t)(((uint64_t)gregs[insn.reg] & ~0xFFULL) | (reg & 0xFF));
+                }
+                break;
+            case 2:  gregs[insn.reg] = (greg_t)(((uint64_t)gregs[insn.reg] & ~0xFFFFULL) | (reg & 0xFFFF)); break;
+            case 4:  gregs[insn.reg] = (greg_t)(reg & 0xFFFFFFFFULL); break;
+            default: gregs[insn.reg] = (greg_t)reg; break;
+        }
+    }
+    gregs[REG_RIP] += insn.len;
+    return 1;
+}
+
+static void sim_segv_handler(int sig, siginfo_t* info, void* context)
+{
+    ucontext_t* uc = (ucontext_t*)context;
+    uintptr_t fault = (uintptr_t)info->si_addr;
+    SIM_Model_Type* model = NULL;
+    SIM_Access_Type* access;
+    uint8_t alias = 0;
+
+    if (fault <= 0xFFFFFFFFUL)
+    {
+        model = sim_model_at((uint32_t)fault);
+        alias = ((uint32_t)fault - SIM_BB_BASE) < SIM_BB_SIZE;
+    }
+    if ((model == NULL) && !alias)
+    {
+        sim_fault(sig);
+        return;
+    }
+    if (sim_emulate_access && sim_emulate(uc, (uint32_t)fault, alias))
+    {
+        sim_access_done();
+        return;
+    }
+    if (sim_depth == SIM_MAX_NEST)
+    {
+        sim_fault(sig);
+        return;
+    }
+
+    access = &sim_access[sim_depth++];
+    access->model = model;
+    access->alias = alias;
+    access->addr  = (uint32_t)fault & ~3UL;
+    access->write = (uc->uc_mcontext.gregs[REG_ERR] & SIM_PF_WRITE) != 0;
+
+    if (alias)
+    {
+        /* The alias word reads as the target bit; a store is applied on SIGTRAP */
+        sim_protect(access->addr, PROT_READ | PROT_WRITE);
+        if (!access->write)
+        {
+            *(volatile uint32_t*)(uintptr_t)access->addr =
+                (SIM_BusRead(sim_bb_word(access->addr), 4) >> sim_bb_bit(access->addr)) & 1UL;
+        }
+        uc->uc_mcontext.gregs[REG_EFL] |= SIM_EFLAGS_TF;
+        return;
+    }
+
+    access->prev  = *SIM_Reg(access->addr);
+    model->accesses++;
+
+    if (!access->write && (model->read != NULL))
+    {
+        model->read(model, access->addr - model->base);
+    }
+
+    sim_protect(access->addr, PROT_READ | PROT_WRITE);
+    uc->uc_mcontext.gregs[REG_EFL] |= SIM_EFLAGS_TF;
+}
+
+static void sim_trap_handler(int sig, siginfo_t* info, void* context)
+{
+    ucontext_t* uc = (ucontext_t*)context;
+    SIM_Access_Type* access;
+    SIM_Model_Type* model;
+
+    (void)info;
+    if (sim_depth == 0)
+    {
+        sim_fault(sig);
+        return;
+    }
+
+    uc->uc_mcontext.gregs[REG_EFL] &= ~SIM_EFLAGS_TF;
+    access = &sim_access[--sim_depth];
+    model = access->model;
+
+    if (access->alias)
+    {
+        /* Locked read-modify-write of the target word, as the bus matrix does */
+        if (access->write)
+        {
+            uint32_t word = sim_bb_word(access->addr);
+            uint32_t mask = 1UL << sim_bb_bit(access->addr);
+            uint32_t value = SIM_BusRead(word, 4) & ~mask;
+
+            if (*(volatile uint32_t*)(uintptr_t)access->addr & 1UL)
+            {
+                value |= mask;
+            }
+            SIM_BusWrite(word, value, 4);
+        }
+        sim_protect(access->addr, PROT_NONE);
+    }
+    else
+    {
+        sim_protect(access->addr, PROT_NONE);
+        if (access->write)
+        {
+            if (model->write != NULL)
+            {
+                model->write(model, access->addr - model->base, access->prev);
+            }
+        }
+        else if (model->read_done != NULL)
+        {
+            model->read_done(model, access->addr - model->base);
+        }
+    }
+    sim_access_done();
+}
+
+/**
+ * Load through the model bus (used by the DMA model and test benches)
+ *
+ * @param  addr  address, simulated register or host memory below 4 GB
+ * @param  size  access size in bytes (1, 2 or 4)
+ * @return value read
+ */
+uint32_t SIM_BusRead(uint32_t addr, uint8_t size)
+{
+    SIM_Model_Type* model = sim_model_at(addr);
+    volatile uint8_t* p;
+    volatile uint32_t* reg = SIM_Reg(addr);
+    uint32_t value;
+
+    if (model != NULL && model->read != NULL)
+    {
+        model->read(model, (addr & ~3UL) - model->base);
+    }
+
+    p = (reg != NULL) ? ((volatile uint8_t*)reg + (addr & 3)) : (volatile uint8_t*)(uintptr_t)addr;
+    switch (size)
+    {
+        case 1:  value = *p; break;
+        case 2:  value = *(volatile uint16_t*)p; break;
+        default: value = *(volatile uint32_t*)p; break;
+    }
+
+    if (model != NULL)
+    {
+        model->accesses++;
+        if (model->read_done != NULL)
+        {
+            model->read_done(model, (addr & ~3UL) - model->base);
+        }
+    }
+    return value;
+}
+
+/**
+ * Store through the model bus (used by the DMA model and test benches)
+ *
+ * @param  addr   address, simulated register or host memory below 4 GB
+ * @param  value  value to store
+ * @param  size   access size in bytes (1, 2 or 4)
+ */
+void SIM_BusWrite(uint32_t addr, uint32_t value, uint8_t size)
+{
+    SIM_Model_Type* model = sim_model_at(addr);
+    volatile uint32_t* reg = SIM_Reg(addr);
+    volatile uint8_t* p;
+    uint32_t prev = (reg != NULL) ? *reg : 0;
+
+    p = (reg != NULL) ? ((volatile uint8_t*)reg + (addr & 3)) : (volatile uint8_t*)(uintptr_t)addr;
+    switch (size)
+    {
+        case 1:  *p = (uint8_t)value; break;
+        case 2:  *(volatile uint16_t*)p = (uint16_t)value; break;
+        default: *(volatile uint32_t*)p = value; break;
+    }
+
+    if (model != NULL)
+    {
+        model->accesses++;
+        if (model->write != NULL)
+        {
+            model->write(model, (addr & ~3UL) - model->base, prev);
+        }
+    }
+}
+
+
+/**
+ * Load by the simulated CPU without a trap, HWREG_READ() of the drivers. It
+ * costs time and takes interrupts as a trapped access does
+ *
+ * @param  addr  address of the register
+ * @param  size  access size in bytes (1, 2 or 4)
+ * @return value read
+ */
+uint32_t SIM_Read(uint32_t addr, uint8_t size)
+{
+    uint32_t value = SIM_BusRead(addr, size);
+
+    sim_access_done();
+    return value;
+}
+
+/**
+ * Store by the simulated CPU without a trap, HWREG_WRITE() of the drivers
+ *
+ * @param  addr   address of the register
+ * @param  value  value to store
+ * @param  size   access size in bytes (1, 2 or 4)
+ */
+void SIM_Write(uint32_t addr, uint32_t value, uint8_t size)
+{
+    SIM_BusWrite(addr, value, size);
+    sim_access_done();
+}
+
+
+/*----------------------------------------------------------------------------
+  Core peripherals: NVIC, SCB, SysTick
+ *----------------------------------------------------------------------------*/
+#define SIM_SCS_OFS(reg)   ((uint32_t)((uintptr_t)&(reg) - SCS_BASE))
+
+static uint8_t sim_irq_prio(int32_t irq)
+{
+    volatile uint32_t* ip;
+
+    if (irq < 0)
+    {
+        ip = SIM_Reg((uint32_t)(uintptr_t)&SCB->SHP[(irq & 0xF) - 4]);
+        return (uint8_t)(*ip >> (8 * (((irq & 0xF) - 4) & 3)));
+    }
+    ip = SIM_Reg((uint32_t)(uintptr_t)&NVIC->IP[irq]);
+    return (uint8_t)(*ip >> (8 * (irq & 3)));
+}
+
+static void sim_core_write(SIM_Model_Type* model, uint32_t offset, uint32_t prev)
+{
+    volatile uint32_t* reg = SIM_Reg(SCS_BASE + offset);
+    uint32_t value = *reg;
+    uint32_t n;
+
+    (void)model;
+    if (offset >= SIM_SCS_OFS(NVIC->ISER[0]) && offset < SIM_SCS_OFS(NVIC->ISER[8]))
+    {
+        n = (offset - SIM_SCS_OFS(NVIC->ISER[0])) / 4;
+        *reg = prev | value;
+        *SIM_Reg((uint32_t)(uintptr_t)&NVIC->ICER[n]) = *reg;
+    }
+    else if (offset >= SIM_SCS_OFS(NVIC->ICER[0]) && offset < SIM_SCS_OFS(NVIC->ICER[8]))
+    {
+        n = (offset - SIM_SCS_OFS(NVIC->ICER[0])) / 4;
+        *reg = prev & ~value;
+        *SIM_Reg((uint32_t)(uintptr_t)&NVIC->ISER[n]) = *reg;
+    }
+    else if (offset >= SIM_SCS_OFS(NVIC->ISPR[0]) && offset < SIM_SCS_OFS(NVIC->ISPR[8]))
+    {
+        n = (offset - SIM_SCS_OFS(NVIC->ISPR[0])) / 4;
+        *reg = prev | value;
+        *SIM_Reg((uint32_t)(uintptr_t)&NVIC->ICPR[n]) = *reg;
+    }
+    else if (offset >= SIM_SCS_OFS(NVIC->ICPR[0]) && offset < SIM_SCS_OFS(NVIC->ICPR[8]))
+    {
+        n = (offset - SIM_SCS_OFS(NVIC->ICPR[0])) / 4;
+        *reg = prev & ~value;
+        *SIM_Reg((uint32_t)(uintptr_t)&NVIC->ISPR[n]) = *reg;
+    }
+    else if (offset >= SIM_SCS_OFS(NVIC->IABR[0]) && offset < SIM_SCS_OFS(NVIC->IABR[8]))
+    {
+        *reg = prev;                                          /* read-only */
+    }
+    else if (offset == SIM_SCS_OFS(SCB->ICSR))
+    {
+        n = prev | (value & (SCB_ICSR_PENDSTSET_Msk | SCB_ICSR_PENDSVSET_Msk));
+        if (value & SCB_ICSR_PENDSTCLR_Msk) n &= ~SCB_ICSR_PENDSTSET_Msk;
+        if (value & SCB_ICSR_PENDSVCLR_Msk) n &= ~SCB_ICSR_PENDSVSET_Msk;
+        *reg = n;
+    }
+    else if (offset == SIM_SCS_OFS(SysTick->VAL))
+    {
+        *reg = 0;
+        *SIM_Reg((uint32_t)(uintptr_t)&SysTick->CTRL) &= ~SysTick_CTRL_COUNTFLAG_Msk;
+    }
+    else if (offset == SIM_SCS_OFS(SysTick->CTRL))
+    {
+        *reg = (value & ~SysTick_CTRL_COUNTFLAG_Msk) | (prev & SysTick_CTRL_COUNTFLAG_Msk);
+    }
+}
+
+static void sim_core_read_done(SIM_Model_Type* model, uint32_t offset)
+{
+    (void)model;
+    if (offset == SIM_SCS_OFS(SysTick->CTRL))
+    {
+        *SIM_Reg((uint32_t)(uintptr_t)&SysTick->CTRL) &= ~SysTick_CTRL_COUNTFLAG_Msk;
+    }
+}
+
+static void sim_core_reset(SIM_Model_Type* model)
+{
+    (void)model;
+    *SIM_Reg((uint32_t)(uintptr_t)&SysTick->CALIB) = 0x000F423FUL;   /* 10 ms at 100 MHz */
+    *SIM_Reg((uint32_t)(uintptr_t)&SCB->CPUID) = 0x412FC230UL;       /* Cortex-M3 r2p0   */
+    *SIM_Reg((uint32_t)(uintptr_t)&DWT->CTRL) = 0x40000000UL;        /* 4 comparators    */
+}
+
+static void sim_core_advance(SIM_Model_Type* model, uint32_t cycles)
+{
+    volatile uint32_t* ctrl = SIM_Reg((uint32_t)(uintptr_t)&SysTick->CTRL);
+    volatile uint32_t* val = SIM_Reg((uint32_t)(uintptr_t)&SysTick->VAL);
+    uint32_t load = *SIM_Reg((uint32_t)(uintptr_t)&SysTick->LOAD) & SysTick_LOAD_RELOAD_Msk;
+    uint64_t left;
+
+    (void)model;
+    if (!(*ctrl & SysTick_CTRL_ENABLE_Msk))
+    {
+        return;
+    }
+
+    /* VAL counts down to 0, the next tick reloads it and flags the wrap */
+    left = cycles;
+    while (left > *val)
+    {
+        left -= (uint64_t)*val + 1;
+        *val = load;
+        *ctrl |= SysTick_CTRL_COUNTFLAG_Msk;
+        if (*ctrl & SysTick_CTRL_TICKINT_Msk)
+        {
+            *SIM_Reg((uint32_t)(uintptr_t)&SCB->ICSR) |= SCB_ICSR_PENDSTSET_Msk;
+        }
+        if (load == 0)
+        {
+            return;
+        }
+    }
+    *val -= (uint32_t)left;
+}
+
+static SIM_Model_Type sim_core_model =
+{
+    SCS_BASE, "SCS", sim_core_reset, NULL, sim_core_read_done, sim_core_write, sim_core_advance, NULL, 0
+};
+
+/* DWT cycle counter, plain memory updated as time advances */
+static void sim_dwt_advance(uint32_t cycles)
+{
+    if ((*SIM_Reg((uint32_t)(uintptr_t)&CoreDebug->DEMCR) & CoreDebug_DEMCR_TRCENA_Msk) &&
+        (*SIM_Reg((uint32_t)(uintptr_t)&DWT->CTRL) & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        *SIM_Reg((uint32_t)(uintptr_t)&DWT->CYCCNT) += cycles;
+    }
+}
+
+
+/*----------------------------------------------------------------------------
+  Interrupts
+ *----------------------------------------------------------------------------*/
+/**
+ * Latch an interrupt request in the NVIC
+ *
+ * @param  IRQn  interrupt number
+ */
+void SIM_SetPendingIRQ(IRQn_Type IRQn)
+{
+    if (IRQn == SysTick_IRQn)
+    {
+        *SIM_Reg((uint32_t)(uintptr_t)&SCB->ICSR) |= SCB_ICSR_PENDSTSET_Msk;
+    }
+    else if (IRQn == PendSV_IRQn)
+    {
+        *SIM_Reg((uint32_t)(uintptr_t)&SCB->ICSR) |= SCB_ICSR_PENDSVSET_Msk;
+    }
+    else if (IRQn >= 0)
+    {
+        *SIM_Reg((uint32_t)(uintptr_t)&NVIC->ISPR[IRQn >> 5]) |= 1UL << (IRQn & 0x1F);
+        *SIM_Reg((uint32_t)(uintptr_t)&NVIC->ICPR[IRQn >> 5]) |= 1UL << (IRQn & 0x1F);
+    }
+}
+
+static void sim_clear_pending(int32_t irq)
+{
+    if (irq == SysTick_IRQn)
+    {
+        *SIM_Reg((uint32_t)(uintptr_t)&SCB->ICSR) &= ~SCB_ICSR_PENDSTSET_Msk;
+    }
+    else if (irq == PendSV_IRQn)
+    {
+        *SIM_Reg((uint32_t)(uintptr_t)&SCB->ICSR) &= ~SCB_ICSR_PENDSVSET_Msk;
+    }
+    else
+    {
+        *SIM_Reg((uint32_t)(uintptr_t)&NVIC->ISPR[irq >> 5]) &= ~(1UL << (irq & 0x1F));
+        *SIM_Reg((uint32_t)(uintptr_t)&NVIC->ICPR[irq >> 5]) &= ~(1UL << (irq & 0x1F));
+    }
+}
+
+/* Highest priority pending and enabled interrupt that may preempt, or 0x7F */
+static int32_t sim_next_irq(uint32_t* prio)
+{
+    uint32_t icsr = *SIM_Reg((uint32_t)(uintptr_t)&SCB->ICSR);
+    uint32_t limit = sim_active_prio;
+    uint32_t p;
+    int32_t best = 0x7F;
+    int32_t irq;
+
+    if (SIM_CoreReg.PRIMASK || SIM_CoreReg.FAULTMASK)
+    {
+        return best;
+    }
+    if ((SIM_CoreReg.BASEPRI != 0) && (SIM_CoreReg.BASEPRI < limit))
+    {
+        limit = SIM_CoreReg.BASEPRI;
+    }
+
+    if (icsr & SCB_ICSR_PENDSTSET_Msk)
+    {
+        p = sim_irq_prio(SysTick_IRQn);
+        if (p < limit) { limit = p; best = SysTick_IRQn; }
+    }
+    for (irq = 0; irq < SIM_NUM_IRQ; irq++)
+    {
+        if ((*SIM_Reg((uint32_t)(uintptr_t)&NVIC->ISPR[irq >> 5]) &
+             *SIM_Reg((uint32_t)(uintptr_t)&NVIC->ISER[irq >> 5]) & (1UL << (irq & 0x1F))) == 0)
+        {
+            continue;
+        }
+        p = sim_irq_prio(irq);
+        if (p < limit) { limit = p; best = irq; }
+    }
+    if (icsr & SCB_ICSR_PENDSVSET_Msk)
+    {
+        p = sim_irq_prio(PendSV_IRQn);
+        if (p < limit) { limit = p; best = PendSV_IRQn; }
+    }
+
+    *prio = limit;
+    return best;
+}
+
+/**
+ * Take every pending interrupt allowed by the current masking, highest
+ * priority first, calling the application's handler like an exception entry.
+ */
+void SIM_ServiceIRQ(void)
+{
+    void (*handler)(void);
+    uint32_t saved_prio, saved_ipsr, prio;
+    int32_t irq;
+    uint32_t i;
+
+    if (!sim_initialized)
+    {
+        return;
+    }
+
+    while ((irq = sim_next_irq(&prio)) != 0x7F)
+    {
+        sim_clear_pending(irq);
+        sim_irq_count[irq + 16]++;
+        sim_irq_taken++;
+
+        if (irq == SysTick_IRQn)      handler = SysTick_Handler;
+        else if (irq == PendSV_IRQn)  handler = PendSV_Handler;
+        else                          handler = sim_vectors[irq];
+
+        if (handler == NULL)
+        {
+            continue;                                     /* default handler: ignore */
+        }
+
+        saved_prio = sim_active_prio;
+        saved_ipsr = SIM_CoreReg.IPSR;
+        sim_active_prio = prio;
+        SIM_CoreReg.IPSR = (uint32_t)(irq + 16);
+        SIM_ExclusiveAddr = 0;                          /* exception entry clears the monitor */
+        if (irq >= 0)
+        {
+            *SIM_Reg((uint32_t)(uintptr_t)&NVIC->IABR[irq >> 5]) |= 1UL << (irq & 0x1F);
+        }
+        handler();
+        if (irq >= 0)
+        {
+            *SIM_Reg((uint32_t)(uintptr_t)&NVIC->IABR[irq >> 5]) &= ~(1UL << (irq & 0x1F));
+        }
+        SIM_ExclusiveAddr = 0;
+        SIM_CoreReg.IPSR = saved_ipsr;
+        sim_active_prio = saved_prio;
+
+        /* Level sensitive sources still asserted pend again */
+        for (i = 0; i < sim_num_models; i++)
+        {
+            if (sim_models[i]->update != NULL)
+            {
+                sim_models[i]->update(sim_models[i]);
+            }
+        }
+    }
+}
+
+/**
+ * Emulation of WFI: let simulated time run until an interrupt is taken,
+ * by SIM_Advance on the way or here
+ */
+void SIM_WaitForInterrupt(void)
+{
+    uint32_t prio;
+    uint64_t waited = 0, taken = sim_irq_taken;
+
+    while ((sim_irq_taken == taken) && (sim_next_irq(&prio) == 0x7F) && (waited < SIM_WFI_LIMIT))
+    {
+        SIM_Advance(SIM_WFI_STEP);
+        waited += SIM_WFI_STEP;
+    }
+    SIM_ServiceIRQ();
+}
+
+/**
+ * Select whether interrupts are taken at trapped register accesses
+ * (default) or only at __WFI, __enable_irq and SIM_Advance/SIM_ServiceIRQ
+ *
+ * @param  enable  0: synchronous only, 1: also at register accesses
+ */
+void SIM_SetAsyncIRQ(uint8_t enable)
+{
+    sim_async_irq = enable;
+}
+
+uint64_t SIM_GetIRQCount(IRQn_Type IRQn)
+{
+    return sim_irq_count[IRQn + 16];
+}
+
+
+/*----------------------------------------------------------------------------
+  Simulated time
+ *----------------------------------------------------------------------------*/
+static void sim_advance(uint32_t cycles)
+{
+    uint32_t i;
+
+    sim_cycles += cycles;
+    sim_dwt_advance(cycles);
+    for (i = 0; i < sim_num_models; i++)
+    {
+        if (sim_models[i]->advance != NULL)
+        {
+            sim_models[i]->advance(sim_models[i], cycles);
+        }
+    }
+}
+
+/**
+ * Advance simulated time, running timers, counters and paced peripherals.
+ * Interrupts are taken every SIM_WFI_STEP cycles on the way, so periodic
+ * sources are not merged into one request.
+ *
+ * @param  cycles  core clock cycles
+ */
+void SIM_Advance(uint32_t cycles)
+{
+    uint32_t step;
+
+    do
+    {
+        step = (cycles > SIM_WFI_STEP) ? SIM_WFI_STEP : cycles;
+        sim_advance(step);
+        SIM_ServiceIRQ();
+        cycles -= step;
+    } while (cycles != 0);
+}
+
+uint64_t SIM_GetCycles(void)
+{
+    return sim_cycles;
+}
+
+/**
+ * Set how many core cycles each trapped register access costs. A non zero
+ * cost lets polling loops see time based status bits change.
+ *
+ * @param  cycles  cycles per access (default 1)
+ */
+void SIM_SetAccessCost(uint32_t cycles)
+{
+    sim_access_cost = cycles;
+}
+
+uint64_t SIM_GetAccessCount(void)
+{
+    return sim_num_accesses;
+}
+
+/**
+ * Select how trapped register accesses are carried out
+ *
+ * @param  enable  1: decode the common mov forms and perform them on the
+ *                 model bus (default), 0: single step every access
+ */
+void SIM_SetAccessEmulation(uint8_t enable)
+{
+    sim_emulate_access = enable;
+}
+
+
+/*----------------------------------------------------------------------------
+  Set up
+ *----------------------------------------------------------------------------*/
+/**
+ * Register a peripheral model and start trapping accesses to its page
+ *
+ * @param  model  model, base must be 4 KB aligned
+ */
+void SIM_AttachModel(SIM_Model_Type* model)
+{
+    SIM_Region_Type* region = sim_region(model->base);
+
+    if ((region == NULL) || (sim_num_models == SIM_MAX_MODELS))
+    {
+        fprintf(stderr, "sim: cannot attach model %s\n", model->name);
+        abort();
+    }
+    SIM_DetachModel(model->base);
+    region->pages[(model->base - region->base) / SIM_PAGE_SIZE] = model;
+    sim_models[sim_num_models++] = model;
+    if (model->reset != NULL)
+    {
+        model->reset(model);
+    }
+    sim_protect(model->base, PROT_NONE);
+}
+
+/**
+ * Turn a modelled page back into plain memory (fastest, no side effects)
+ *
+ * @param  base  page address
+ */
+void SIM_DetachModel(uint32_t base)
+{
+    SIM_Region_Type* region = sim_region(base);
+    uint32_t i;
+
+    if (region == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < sim_num_models; i++)
+    {
+        if (sim_models[i]->base == base)
+        {
+            sim_models[i] = sim_models[--sim_num_models];
+            break;
+        }
+    }
+    region->pages[(base - region->base) / SIM_PAGE_SIZE] = NULL;
+    sim_protect(base, PROT_READ | PROT_WRITE);
+}
+
+/**
+ * Clear every register image and reload the models' reset values
+ */
+void SIM_Reset(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < SIM_NUM_REGIONS; i++)
+    {
+        memset(sim_regions[i].shadow, 0, sim_regions[i].size);
+    }
+    memset((void*)&SIM_CoreReg, 0, sizeof(SIM_CoreReg));
+    SIM_CoreReg.MSP = LPC_RAM_BASE + 0x8000UL;
+    SIM_ExclusiveAddr = 0;
+    sim_cycles = 0;
+    sim_num_accesses = 0;
+    sim_active_prio = 0x100;
+    memset(sim_irq_count, 0, sizeof(sim_irq_count));
+    for (i = 0; i < sim_num_models; i++)
+    {
+        sim_models[i]->accesses = 0;
+        if (sim_models[i]->reset != NULL)
+        {
+            sim_models[i]->reset(sim_models[i]);
+        }
+    }
+}
+
+/**
+ * Map the LPC17xx address space, install the trap handlers and attach the
+ * default peripheral models. Call once before SystemInit().
+ */
+void SIM_Init(void)
+{
+    struct sigaction sa;
+    size_t total = 0, offset = 0;
+    uint32_t i;
+    void* p;
+    int fd;
+
+    if (sim_initialized)
+    {
+        SIM_Reset();
+        return;
+    }
+
+    for (i = 0; i < SIM_NUM_REGIONS; i++)
+    {
+        total += sim_regions[i].size;
+    }
+    fd = memfd_create("lpc17xx", 0);
+    if ((fd < 0) || (ftruncate(fd, (off_t)total) != 0))
+    {
+        perror("sim: memfd");
+        abort();
+    }
+
+    for (i = 0; i < SIM_NUM_REGIONS; i++)
+    {
+        p = mmap((void*)(uintptr_t)sim_regions[i].base, sim_regions[i].size, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_FIXED_NOREPLACE, fd, (off_t)offset);
+        if (p != (void*)(uintptr_t)sim_regions[i].base)
+        {
+            fprintf(stderr, "sim: cannot map 0x%08X (link the host build with -no-pie)\n",
+                    (unsigned)sim_regions[i].base);
+            abort();
+        }
+        p = mmap(NULL, sim_regions[i].size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t)offset);
+        if (p == MAP_FAILED)
+        {
+            perror("sim: shadow mmap");
+            abort();
+        }
+        sim_regions[i].shadow = (uint8_t*)p;
+        offset += sim_regions[i].size;
+    }
+    close(fd);
+
+    p = mmap((void*)(uintptr_t)SIM_BB_BASE, SIM_BB_SIZE, PROT_NONE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (p != (void*)(uintptr_t)SIM_BB_BASE)
+    {
+        perror("sim: bit-band alias mmap");
+        abort();
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+    sa.sa_sigaction = sim_segv_handler;
+    sigaction(SIGSEGV, &sa, NULL);
+    sa.sa_sigaction = sim_trap_handler;
+    sigaction(SIGTRAP, &sa, NULL);
+
+    sim_initialized = 1;
+    SIM_AttachModel(&sim_core_model);
+    SIM_AttachDefaultModels();
+    SIM_Reset();
+}
+
+/**
+ * @}
+ */
+
+#endif /* __USE_HOST_SIM */
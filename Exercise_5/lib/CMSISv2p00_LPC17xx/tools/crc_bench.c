@@ -0,0 +1,199 @@
+/**************************************************************************//**
+ * @file     crc_bench.c
+ * @brief    Host throughput benchmark of the CRC-32 variants
+ * @version  V1.00
+ *
+ * @note
+ * Usage: crc_bench [megabytes] [seed]
+ *
+ * Runs the nibble, slicing-by-4 and slicing-by-8 variants of CRC and the
+ * bit-serial routine EMAC used before them over random data. It prints
+ * bytes per cycle for blocks of 6 (a MAC address for the hash filter), 64,
+ * 1518 (an Ethernet frame) and 65536 bytes. Each size is run until about
+ * [megabytes] MB (default 64) have been processed. Cycles are host TSC
+ * cycles, so the ratios carry over to the Cortex-M3 better than the
+ * absolute figures. All routines are first checked against each other,
+ * split calls against whole ones, and the FCS residue.
+ * Built by "make HOST=1 crc_bench" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <x86intrin.h>
+
+#include "LPC17xx.h"
+#include "lpc17xx_crc.h"
+
+#define BENCH_BUF_SIZE    65536
+#define BENCH_OFFSET      1           /* blocks start off a word boundary */
+
+typedef uint32_t (*Crc_Func)(uint32_t crc, const void* data, uint32_t len);
+
+/* One routine under test */
+typedef struct
+{
+    const char* name;
+    Crc_Func func;
+} Bench_Type;
+
+static uint8_t buf[BENCH_BUF_SIZE + 16];
+static uint32_t rng;
+
+static uint32_t next_random(void)
+{
+    rng = rng * 1664525UL + 1013904223UL;
+    return rng >> 8;
+}
+
+/* The routine EMAC_SetHashFilter() used: four conditional XORs per nibble,
+ * most significant bit first. Its result is the bit reversed CRC register */
+static uint32_t legacy_crc(uint8_t frame_no_fcs[], int32_t frame_len)
+{
+    int i, j;
+    char byte;
+    int crc;
+    int q0, q1, q2, q3;
+
+    crc = 0xFFFFFFFF;
+    for (i = 0; i < frame_len; i++)
+    {
+        byte = *frame_no_fcs++;
+        for (j = 0; j < 2; j++)
+        {
+            q3 = (((crc >> 28) ^ (byte >> 3)) & 0x00000001) ? 0x04C11DB7 : 0x00000000;
+            q2 = (((crc >> 29) ^ (byte >> 2)) & 0x00000001) ? 0x09823B6E : 0x00000000;
+            q1 = (((crc >> 30) ^ (byte >> 1)) & 0x00000001) ? 0x130476DC : 0x00000000;
+            q0 = (((crc >> 31) ^ (byte >> 0)) & 0x00000001) ? 0x2608EDB8 : 0x00000000;
+            crc = (crc << 4) ^ q3 ^ q2 ^ q1 ^ q0;
+            byte >>= 4;
+        }
+    }
+    return crc;
+}
+
+/* Same interface as the others: the bit reversal is not part of the cost */
+static uint32_t legacy_update(uint32_t crc, const void* data, uint32_t len)
+{
+    (void)crc;
+    return legacy_crc((uint8_t*)data, (int32_t)len);
+}
+
+static Bench_Type benches[] =
+{
+    { "legacy", legacy_update },
+    { "nibble", CRC32_UpdateNibble },
+    { "slice4", CRC32_UpdateSlice4 },
+    { "slice8", CRC32_UpdateSlice8 },
+};
+
+#define BENCH_COUNT   (sizeof(benches) / sizeof(benches[0]))
+#define BENCH_SIZES   4
+
+static void fail(const char* what, uint32_t len)
+{
+    fprintf(stderr, "crc_bench: %s mismatch at length %u\n", what, (unsigned)len);
+    exit(1);
+}
+
+static void check(void)
+{
+    uint32_t i, len, off, split, ref, crc;
+
+    if (CRC32_UpdateNibble(CRC32_INIT, "123456789", 9) != 0xCBF43926UL)
+    {
+        fail("check value", 9);
+    }
+    for (i = 0; i < 2000; i++)
+    {
+        len = next_random() % 2000;
+        off = next_random() % 16;
+        ref = CRC32_UpdateNibble(CRC32_INIT, buf + off, len);
+        if ((CRC32_UpdateSlice4(CRC32_INIT, buf + off, len) != ref) ||
+            (CRC32_UpdateSlice8(CRC32_INIT, buf + off, len) != ref))
+        {
+            fail("variant", len);
+        }
+        if ((uint32_t)legacy_crc(buf + off, (int32_t)len) != __RBIT(~ref))
+        {
+            fail("legacy", len);
+        }
+        split = (len != 0) ? next_random() % len : 0;
+        crc = CRC32_UpdateSlice8(CRC32_INIT, buf + off, split);
+        if (CRC32_UpdateSlice4(crc, buf + off + split, len - split) != ref)
+        {
+            fail("incremental", len);
+        }
+    }
+
+    /* Data followed by its CRC, least significant byte first */
+    crc = CRC32_UpdateSlice8(CRC32_INIT, buf, 1514);
+    buf[1514] = (uint8_t)crc;
+    buf[1515] = (uint8_t)(crc >> 8);
+    buf[1516] = (uint8_t)(crc >> 16);
+    buf[1517] = (uint8_t)(crc >> 24);
+    if (!CRC32_FCS_OK(buf, 1518))
+    {
+        fail("FCS residue", 1518);
+    }
+}
+
+static double run(Bench_Type* b, uint32_t len, uint64_t total)
+{
+    uint64_t reps = (total + len - 1) / len, r, t0, cycles;
+    volatile uint32_t sink = 0;
+
+    t0 = __rdtsc();
+    for (r = 0; r < reps; r++)
+    {
+        sink ^= b->func(CRC32_INIT, buf + BENCH_OFFSET, len);
+    }
+    cycles = __rdtsc() - t0;
+    (void)sink;
+    return (double)(reps * len) / (double)cycles;
+}
+
+int main(int argc, char** argv)
+{
+    static const uint32_t sizes[BENCH_SIZES] = { 6, 64, 1518, 65536 };
+    uint64_t total = ((argc > 1) ? strtoull(argv[1], NULL, 0) : 64ULL) << 20;
+    uint32_t seed = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 1;
+    double bpc[BENCH_SIZES], legacy = 1.0;
+    uint32_t i, s;
+
+    rng = seed;
+    for (i = 0; i < sizeof(buf); i++)
+    {
+        buf[i] = (uint8_t)next_random();
+    }
+    check();
+    for (i = 0; i < sizeof(buf); i++)
+    {
+        buf[i] = (uint8_t)next_random();
+    }
+
+    printf("bytes per host cycle, %llu MB per size\n", (unsigned long long)(total >> 20));
+    printf("%-8s", "");
+    for (s = 0; s < BENCH_SIZES; s++)
+    {
+        printf(" %9u B", (unsigned)sizes[s]);
+    }
+    printf("  x legacy at 1518 B\n");
+    for (i = 0; i < BENCH_COUNT; i++)
+    {
+        printf("%-8s", benches[i].name);
+        for (s = 0; s < BENCH_SIZES; s++)
+        {
+            /* The legacy routine is slow: a sixteenth of the data is enough */
+            bpc[s] = run(&benches[i], sizes[s], (i == 0) ? total / 16 : total);
+            printf(" %11.3f", bpc[s]);
+        }
+        if (i == 0)
+        {
+            legacy = bpc[2];
+        }
+        printf(" %10.1f\n", bpc[2] / legacy);
+    }
+    return 0;
+}
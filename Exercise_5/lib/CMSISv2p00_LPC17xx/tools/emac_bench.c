@@ -0,0 +1,433 @@
+/**************************************************************************//**
+ * @file     emac_bench.c
+ * @brief    Host benchmark of the EMACQ event loop under receive load
+ * @version  V1.00
+ *
+ * @note
+ * Usage: emac_bench [frames] [cycles per frame] [file.pcap]
+ *
+ * Replays [frames] frames (default 20000) to the simulated EMAC at 100
+ * Mbit/s line rate, back to back. The frames come from a classic pcap file
+ * of Ethernet frames (either byte order, microsecond or nanosecond stamps;
+ * the stamps are ignored and the file is repeated as needed), or without
+ * one from a broadcast storm of minimum size frames. The frame handler
+ * charges [cycles per frame] simulated cycles (default 1000, 10 us at 100
+ * MHz) and releases the frame; the main loop alternates EMACQ_Poll() with
+ * slices of application work. The run is made twice:
+ * - irq:  every frame handled in the interrupt (IrqBudget 0)
+ * - napi: a few frames per interrupt, then polling from the main loop
+ * For each it prints the frames handled per simulated and per host second,
+ * the frames dropped for want of a descriptor, the share of the simulated
+ * time left to the application (near 0 when the interrupt livelocks it),
+ * the handler latency, and the interrupts and switches to polling taken.
+ * Both runs are then repeated sending a frame per frame handled and per
+ * main loop pass, while the EMAC takes a receive overrun and a transmit
+ * underrun (SIM_EMAC_Fault()) at a few points of the storm. Each stops its
+ * datapath until EMACQ resets it: frames must still be received and sent
+ * after the last fault, and every queued frame must come back through
+ * Cfg.TxDone, sent or failed by an underrun. Exits non zero if a run stalls
+ * or does not recover.
+ * Built by "make HOST=1 emac_bench" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "LPC17xx.h"
+#include "sim_LPC17xx.h"
+#include "lpc17xx_emac.h"
+#include "lpc17xx_emacq.h"
+
+#define BENCH_RX_COUNT      96
+#define BENCH_RX_BUF_SIZE   256
+#define BENCH_TX_COUNT      8
+#define BENCH_APP_SLICE     2000        /* cycles of application work per main loop pass */
+#define BENCH_IRQ_BUDGET    8
+#define BENCH_POLL_BUDGET   16
+#define BENCH_STORM_LEN     60          /* minimum frame without FCS */
+#define BENCH_FAULTS        4           /* overrun and underrun points of the recovery runs */
+
+/* One frame of the source */
+typedef struct
+{
+    const uint8_t* data;
+    uint32_t len;
+} Frame_Type;
+
+/* One run of the event loop */
+typedef struct
+{
+    const char* name;
+    uint16_t irq_budget;
+    uint64_t handled;
+    uint64_t app_cycles;
+    uint64_t cycles;
+    uint64_t total_ns;
+    uint32_t dropped;
+    EMACQ_STATS_Type stats;
+    uint32_t faults;                    /* overrun and underrun points, 0 for none */
+    uint32_t tx_queued;
+    uint32_t tx_sent;                   /* frames on the wire */
+    uint32_t tx_ok;                     /* Cfg.TxDone calls without and with an error */
+    uint32_t tx_failed;
+    uint64_t rx_after;                  /* frames handled and sent after the last fault */
+    uint32_t tx_after;
+} Bench_Type;
+
+static EMACQ_Type emacq;
+static Frame_Type* source;
+static uint32_t source_count;
+static uint32_t total;
+static uint32_t injected;
+static uint32_t work;
+static uint64_t handled;
+static uint32_t tx_ok;
+static uint32_t tx_failed;
+static Bench_Type* bench;
+static EMACQ_FRAG_Type reply;
+static uint32_t faults;
+static uint32_t sent_at_fault;
+static volatile uint32_t sink;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t pcap_u32(const uint8_t* p, int swap)
+{
+    return swap ? ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]
+                : ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+}
+
+/* Index the frames of a pcap file. Frames the simulator cannot carry are skipped */
+static void load_pcap(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    uint8_t* buf;
+    uint32_t magic, len, skipped = 0;
+    long size, pos;
+    int swap;
+
+    if (f == NULL)
+    {
+        perror(path);
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    rewind(f);
+    buf = malloc((size_t)size + 1);
+    if ((buf == NULL) || (fread(buf, 1, (size_t)size, f) != (size_t)size) || (size < 24))
+    {
+        fprintf(stderr, "emac_bench: cannot read %s\n", path);
+        exit(1);
+    }
+    fclose(f);
+
+    magic = pcap_u32(buf, 0);
+    if ((magic == 0xA1B2C3D4UL) || (magic == 0xA1B23C4DUL))
+    {
+        swap = 0;
+    }
+    else if ((magic == 0xD4C3B2A1UL) || (magic == 0x4D3CB2A1UL))
+    {
+        swap = 1;
+    }
+    else
+    {
+        fprintf(stderr, "emac_bench: %s is not a pcap file\n", path);
+        exit(1);
+    }
+    if (pcap_u32(buf + 20, swap) != 1)
+    {
+        fprintf(stderr, "emac_bench: %s does not hold Ethernet frames\n", path);
+        exit(1);
+    }
+
+    source = malloc(((size_t)size / 16 + 1) * sizeof(Frame_Type));
+    for (pos = 24; pos + 16 <= size; pos += 16 + len)
+    {
+        len = pcap_u32(buf + pos + 8, swap);
+        if (pos + 16 + (long)len > size)
+        {
+            break;
+        }
+        if ((len < 14) || (len > SIM_EMAC_MAX_FLEN - 4))
+        {
+            skipped++;
+            continue;
+        }
+        source[source_count].data = buf + pos + 16;
+        source[source_count].len = len;
+        source_count++;
+    }
+    if (source_count == 0)
+    {
+        fprintf(stderr, "emac_bench: no usable frame in %s\n", path);
+        exit(1);
+    }
+    if (skipped != 0)
+    {
+        printf("%u frames of %s skipped, too short or too long\n", (unsigned)skipped, path);
+    }
+}
+
+/* Broadcast ARP requests, the usual storm */
+static void make_storm(void)
+{
+    static uint8_t frame[BENCH_STORM_LEN];
+    static Frame_Type storm = { frame, BENCH_STORM_LEN };
+    static const uint8_t head[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02, 0x00, 0x00, 0x00, 0x00, 0x01,
+                                                                    0x08, 0x06, 0x00, 0x01, 0x08, 0x00, 0x06, 0x04, 0x00, 0x01 };
+
+    memcpy(frame, head, sizeof(head));
+    source = &storm;
+    source_count = 1;
+}
+
+/* The line keeps delivering whatever the processor does: the backlog is
+ * topped up from the frame handler as well as from the main loop */
+static void feed(void)
+{
+    const Frame_Type* f;
+
+    while (injected < total)
+    {
+        f = &source[injected % source_count];
+        if (!SIM_EMAC_Inject(f->data, f->len))
+        {
+            break;
+        }
+        injected++;
+    }
+}
+
+static void on_sent(void* tag, uint32_t info)
+{
+    (void)tag;
+    if (info & EMAC_TINFO_ERR)
+    {
+        tx_failed++;
+    }
+    else
+    {
+        tx_ok++;
+    }
+}
+
+/* Count the frames that reached the wire */
+static uint32_t drain(void)
+{
+    static uint8_t frame[SIM_EMAC_MAX_FLEN];
+    uint32_t n = 0;
+
+    while (SIM_EMAC_Drain(frame, sizeof(frame)) != 0)
+    {
+        n++;
+    }
+    return n;
+}
+
+/* Recovery runs: a frame sent per call, and the faults spread over the
+ * first half of the storm. Called from the frame handler as well as from
+ * the main loop, which the interrupt may starve */
+static void traffic(void)
+{
+    Bench_Type* b = bench;
+
+    if (b->faults == 0)
+    {
+        return;
+    }
+    if ((faults < b->faults) && (handled >= (uint64_t)total * (faults + 1) / (2 * b->faults + 2)))
+    {
+        SIM_EMAC_Fault(EMAC_INT_RX_OVERRUN | EMAC_INT_TX_UNDERRUN);
+        faults++;
+        b->rx_after = handled;
+        sent_at_fault = b->tx_sent;
+    }
+    if (EMACQ_Send(&emacq, &reply, 1, NULL) == SUCCESS)
+    {
+        b->tx_queued++;
+    }
+    b->tx_sent += drain();
+}
+
+static void on_frame(const EMACQ_FRAME_Type* frame)
+{
+    uint32_t len;
+
+    sink += EMACQ_GetFragment(&emacq, frame, 0, &len)[12];
+    SIM_Advance(work);
+    EMACQ_Release(&emacq, frame);
+    handled++;
+    feed();
+    traffic();
+}
+
+void ENET_IRQHandler(void)
+{
+    EMACQ_IntHandler(&emacq);
+}
+
+static void run(Bench_Type* b)
+{
+    static uint8_t mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+    EMAC_CFG_Type emac_cfg = { EMAC_MODE_AUTO, mac };
+    EMACQ_CFG_Type cfg;
+    uint64_t t0, c0, limit;
+
+    SIM_Reset();
+    SystemInit();
+    if (EMAC_Init(&emac_cfg) != SUCCESS)
+    {
+        fprintf(stderr, "emac_bench: EMAC_Init failed\n");
+        exit(1);
+    }
+    SIM_EMAC_SetPaced(1);
+
+    cfg.Mem = (void*)LPC_AHBRAM0_BASE;
+    cfg.MemSize = EMACQ_MEM_SIZE(BENCH_RX_COUNT, BENCH_TX_COUNT, BENCH_RX_BUF_SIZE);
+    cfg.RxCount = BENCH_RX_COUNT;
+    cfg.RxBufSize = BENCH_RX_BUF_SIZE;
+    cfg.TxCount = BENCH_TX_COUNT;
+    cfg.TxDone = on_sent;
+    cfg.RxFrame = on_frame;
+    cfg.IrqBudget = b->irq_budget;
+    cfg.PollBudget = BENCH_POLL_BUDGET;
+    if (EMACQ_Init(&emacq, &cfg) != SUCCESS)
+    {
+        fprintf(stderr, "emac_bench: EMACQ_Init failed\n");
+        exit(1);
+    }
+
+    /* The frame to send follows the rings in AHB SRAM */
+    reply.Data = (const uint8_t*)cfg.Mem + ((cfg.MemSize + 7) & ~7UL);
+    reply.Length = BENCH_STORM_LEN;
+    memcpy((void*)reply.Data, source[0].data, (source[0].len < BENCH_STORM_LEN) ? source[0].len : BENCH_STORM_LEN);
+
+    bench = b;
+    faults = 0;
+    sent_at_fault = 0;
+    injected = 0;
+    handled = 0;
+    tx_ok = 0;
+    tx_failed = 0;
+    limit = (uint64_t)total * (work + 10000) + 1000000;
+    t0 = now_ns();
+    c0 = SIM_GetCycles();
+    feed();
+    while (handled + SIM_EMAC_GetDropped() < total)
+    {
+        EMACQ_Poll(&emacq);
+        traffic();
+        SIM_Advance(BENCH_APP_SLICE);
+        b->app_cycles += BENCH_APP_SLICE;
+        feed();
+        if (SIM_GetCycles() - c0 > limit)
+        {
+            fprintf(stderr, "emac_bench: %s run stalled after %llu frames\n", b->name, (unsigned long long)handled);
+            exit(1);
+        }
+    }
+    b->total_ns = now_ns() - t0;
+    b->cycles = SIM_GetCycles() - c0;
+    b->handled = handled;
+    b->dropped = SIM_EMAC_GetDropped();
+
+    /* Let the transmit ring empty */
+    EMACQ_GetStats(&emacq, &b->stats);
+    while (b->stats.TxQueued != 0)
+    {
+        SIM_Advance(BENCH_APP_SLICE);
+        b->tx_sent += drain();
+        EMACQ_GetStats(&emacq, &b->stats);
+        if (SIM_GetCycles() - c0 > limit)
+        {
+            fprintf(stderr, "emac_bench: %s run stalled sending\n", b->name);
+            exit(1);
+        }
+    }
+    b->tx_sent += drain();
+    b->rx_after = handled - b->rx_after;
+    b->tx_after = b->tx_sent - sent_at_fault;
+    b->tx_ok = tx_ok;
+    b->tx_failed = tx_failed;
+}
+
+/* The EMAC came back after every fault, no frame went missing */
+static int recovered(const Bench_Type* b)
+{
+    return (b->stats.RxOverruns == b->faults) && (b->stats.TxUnderruns == b->faults) && (b->rx_after != 0)
+           && (b->tx_after != 0) && (b->tx_ok + b->tx_failed == b->tx_queued)
+           && (b->tx_ok == b->tx_sent) && (b->stats.RxErrors == 0);
+}
+
+static void report_recovery(const Bench_Type* b)
+{
+    printf("%-5s %8u %9u %9llu %8u %8u %9u %8u  %s\n", b->name, (unsigned)b->stats.RxOverruns,
+           (unsigned)b->stats.TxUnderruns, (unsigned long long)b->rx_after, (unsigned)b->tx_queued,
+           (unsigned)b->tx_failed, (unsigned)b->tx_after, (unsigned)b->dropped, recovered(b) ? "PASS" : "FAIL");
+}
+
+static void report(Bench_Type* b)
+{
+    double mhz = (double)SystemCoreClock / 1e6;
+
+    printf("%-5s %9.0f %10.0f %8u %6u %8.1f%% %8.1f %9.1f %10u %6u\n", b->name,
+           (double)b->handled * mhz * 1e6 / (double)b->cycles, (double)b->handled * 1e9 / (double)b->total_ns,
+           (unsigned)b->dropped, (unsigned)b->stats.RxFull, 100.0 * (double)b->app_cycles / (double)b->cycles,
+           (double)b->stats.RxLatencyMean / mhz, (double)b->stats.RxLatencyMax / mhz, (unsigned)b->stats.Interrupts,
+           (unsigned)b->stats.PollSwitches);
+}
+
+int main(int argc, char** argv)
+{
+    Bench_Type irq = { "irq", 0, 0, 0, 0, 0, 0, { 0 } };
+    Bench_Type napi = { "napi", BENCH_IRQ_BUDGET, 0, 0, 0, 0, 0, { 0 } };
+    Bench_Type irq_faults = { "irq", 0, 0, 0, 0, 0, 0, { 0 }, BENCH_FAULTS };
+    Bench_Type napi_faults = { "napi", BENCH_IRQ_BUDGET, 0, 0, 0, 0, 0, { 0 }, BENCH_FAULTS };
+
+    total = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000;
+    work = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 1000;
+    if (argc > 3)
+    {
+        load_pcap(argv[3]);
+    }
+    else
+    {
+        make_storm();
+    }
+
+    SIM_Init();
+    run(&irq);
+    run(&napi);
+    run(&irq_faults);
+    run(&napi_faults);
+    if (irq.stats.RxErrors || napi.stats.RxErrors)
+    {
+        fprintf(stderr, "emac_bench: frames received with errors\n");
+        return 1;
+    }
+
+    printf("%u frames from %s, %u cycles per frame, %u descriptors of %u bytes\n", (unsigned)total,
+           (argc > 3) ? argv[3] : "a broadcast storm", (unsigned)work, (unsigned)BENCH_RX_COUNT,
+           (unsigned)BENCH_RX_BUF_SIZE);
+    printf("mode   frames/s host fr/s  dropped   full app share  mean us    max us interrupts  polls\n");
+    report(&irq);
+    report(&napi);
+    printf("\n%u receive overruns and transmit underruns, frames sent from the handler and the main loop\n",
+           BENCH_FAULTS);
+    printf("mode  overruns underruns  rx after tx queued tx failed  tx after  dropped\n");
+    report_recovery(&irq_faults);
+    report_recovery(&napi_faults);
+    return (recovered(&irq_faults) && recovered(&napi_faults)) ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+/**************************************************************************//**
+ * @file     gpio_toggle_check.c
+ * @brief    Host check that pin toggles from an interrupt are not lost
+ * @version  V1.00
+ *
+ * @note
+ * Usage: gpio_toggle_check [toggles]
+ *
+ * The TIMER0 match interrupt toggles P0.0 with GPIO_PinToggle() while the
+ * main loop toggles the same pin [toggles] (default 20000) times, first with
+ * a plain read-modify-write of FIOPIN and then with GPIO_PinToggle(). After
+ * each main loop toggle, with interrupts masked, the latch of P0.0 is
+ * compared with the parity of all the toggles so far; a mismatch is a lost
+ * update. The other pins of the port carry a fixed pattern that must survive.
+ * The simulator takes pending interrupts between the accesses of the main
+ * loop, so the plain read-modify-write loses updates and GPIO_PinToggle(),
+ * whose store exclusive fails and retries, must not.
+ * Built by "make HOST=1 gpio_toggle_check" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "LPC17xx.h"
+#include "lpc17xx_gpio.h"
+#include "lpc17xx_timer.h"
+#include "sim_LPC17xx.h"
+
+#define CHECK_PIN         0
+#define CHECK_PATTERN     0xA5A5A5A4UL    /* other outputs, pin 0 low */
+#define CHECK_ACCESS_COST 7               /* cycles per register access */
+#define CHECK_MATCH       10               /* timer ticks between interrupts */
+
+static volatile uint32_t isr_toggles;
+
+void TIMER0_IRQHandler(void)
+{
+    TIM_ClearIntPending(LPC_TIM0, TIM_MR0_INT);
+    GPIO_PinToggle(0, CHECK_PIN);
+    isr_toggles++;
+}
+
+/* The former way: sample FIOPIN, write it back with one bit flipped */
+static void toggle_rmw(void)
+{
+    LPC_GPIO0->FIOPIN ^= 1UL << CHECK_PIN;
+}
+
+static void toggle_pin(void)
+{
+    GPIO_PinToggle(0, CHECK_PIN);
+}
+
+static void timer_start(void)
+{
+    TIM_TIMERCFG_Type cfg;
+    TIM_MATCHCFG_Type match;
+
+    cfg.PrescaleOption = TIM_PRESCALE_TICKVAL;
+    cfg.PrescaleValue = 1;
+    TIM_Init(LPC_TIM0, TIM_TIMER_MODE, &cfg);
+    memset(&match, 0, sizeof(match));
+    match.MatchChannel = 0;
+    match.IntOnMatch = ENABLE;
+    match.ResetOnMatch = ENABLE;
+    match.MatchValue = CHECK_MATCH;
+    TIM_ConfigMatch(LPC_TIM0, &match);
+    NVIC_EnableIRQ(TIMER0_IRQn);
+    TIM_Cmd(LPC_TIM0, ENABLE);
+}
+
+/* Returns the number of lost interrupt toggles, exits on a corrupted pin */
+static uint32_t run(const char* name, void (*toggle)(void), uint32_t n)
+{
+    uint32_t lost = 0;
+    uint32_t out;
+    uint32_t i;
+
+    SIM_Reset();
+    SIM_SetAccessCost(CHECK_ACCESS_COST);
+    LPC_GPIO0->FIODIR = 0xFFFFFFFFUL;
+    LPC_GPIO0->FIOSET = CHECK_PATTERN;
+    isr_toggles = 0;
+    timer_start();
+
+    for (i = 0; i < n; i++)
+    {
+        toggle();
+
+        __disable_irq();
+        out = SIM_GPIO_GetOutput(0);
+        if (((out >> CHECK_PIN) & 1) != ((i + 1 + isr_toggles + lost) & 1))
+        {
+            lost++;
+        }
+        if ((out & ~(1UL << CHECK_PIN)) != CHECK_PATTERN)
+        {
+            fprintf(stderr, "gpio_toggle_check: %s: outputs 0x%08X after %u toggles\n", name, (unsigned)out,
+                    (unsigned)i + 1);
+            exit(1);
+        }
+        __enable_irq();
+    }
+
+    TIM_Cmd(LPC_TIM0, DISABLE);
+    NVIC_DisableIRQ(TIMER0_IRQn);
+    printf("%-16s %6u main toggles %6u interrupt toggles %6u lost\n", name, (unsigned)n, (unsigned)isr_toggles,
+           (unsigned)lost);
+    return lost;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t n = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000;
+    uint32_t lost_rmw;
+    uint32_t lost_pin;
+
+    SIM_Init();
+    lost_rmw = run("FIOPIN ^=", toggle_rmw, n);
+    lost_pin = run("GPIO_PinToggle", toggle_pin, n);
+    if (lost_pin != 0 || lost_rmw == 0)
+    {
+        printf("FAIL: GPIO_PinToggle must lose none, the plain read-modify-write some\n");
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
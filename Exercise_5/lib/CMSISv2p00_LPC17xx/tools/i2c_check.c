@@ -0,0 +1,182 @@
+/**************************************************************************//**
+ * @file     i2c_check.c
+ * @brief    Host check of the I2CQ transaction queue against injected I2STAT sequences
+ * @version  V1.00
+ *
+ * @note
+ * Usage: i2c_check
+ *
+ * Runs I2CQ on I2C1 against scripted slaves: each bus event of the master
+ * takes the next I2STAT code queued with SIM_I2C_Inject(). Four scenarios:
+ * a chain of a register read (write, repeated START, read), a write and a
+ * read, completed in order from the interrupt; an address NACK; a hung bus
+ * (no more codes) stopped by the I2CQ_Tick() timeout, after which the next
+ * transaction runs; and arbitration loss. The bytes put on the bus, the
+ * STOP conditions, the statuses and the statistics are checked. Prints one
+ * line per scenario and exits non zero if any fails.
+ * Built by "make HOST=1 i2c_check" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "LPC17xx.h"
+#include "lpc17xx_i2c.h"
+#include "lpc17xx_i2cq.h"
+#include "sim_LPC17xx.h"
+
+#define CHECK_BUS         1
+#define CHECK_MAX_DONE    8
+
+static I2CQ_Type queue;
+static uint32_t done_order[CHECK_MAX_DONE];
+static uint32_t done_count;
+static uint32_t failures;
+
+void I2C1_IRQHandler(void)
+{
+    I2CQ_IntHandler(&queue);
+}
+
+static void done(I2CQ_XFER_Type* xfer)
+{
+    if (done_count < CHECK_MAX_DONE)
+    {
+        done_order[done_count] = (uint32_t)(uintptr_t)xfer->Arg;
+    }
+    done_count++;
+}
+
+static void xfer_init(I2CQ_XFER_Type* xfer, uint8_t addr, const uint8_t* tx, uint32_t txLen, uint8_t* rx,
+                      uint32_t rxLen, uint32_t timeout, uint32_t id)
+{
+    memset(xfer, 0, sizeof(*xfer));
+    xfer->SlaveAddr = addr;
+    xfer->TxData = tx;
+    xfer->TxLength = txLen;
+    xfer->RxData = rx;
+    xfer->RxLength = rxLen;
+    xfer->Timeout = timeout;
+    xfer->Callback = done;
+    xfer->Arg = (void*)(uintptr_t)id;
+}
+
+static void report(const char* name, int ok)
+{
+    printf("%-24s %s\n", name, ok ? "PASS" : "FAIL");
+    if (!ok)
+    {
+        failures++;
+    }
+}
+
+/* Register read, write and read queued together, run back to back by the interrupt */
+static void check_chain(void)
+{
+    static const uint8_t stat[] = { 0x08, 0x18, 0x28, 0x10, 0x40, 0x50, 0x58,     /* write reg, read 2 */
+                                    0x08, 0x18, 0x28, 0x28,                       /* write 2 */
+                                    0x08, 0x40, 0x58 };                           /* read 1 */
+    static const uint8_t data[] = { 0, 0, 0, 0, 0, 0xAB, 0xCD, 0, 0, 0, 0, 0, 0, 0x33 };
+    static const uint8_t bus[] = { 0x3A, 0x0F, 0x3B, 0x3A, 0x20, 0x47, 0xA1 };
+    static const uint8_t reg = 0x0F;
+    static const uint8_t wr[2] = { 0x20, 0x47 };
+    uint8_t rd[2] = { 0 };
+    uint8_t rd1 = 0;
+    uint8_t out[16];
+    I2CQ_XFER_Type x1, x2, x3;
+    uint32_t n;
+
+    done_count = 0;
+    SIM_I2C_Inject(CHECK_BUS, stat, data, sizeof(stat));
+    xfer_init(&x1, 0x1D, &reg, 1, rd, 2, 10, 1);
+    xfer_init(&x2, 0x1D, wr, 2, NULL, 0, 10, 2);
+    xfer_init(&x3, 0x50, NULL, 0, &rd1, 1, 10, 3);
+    __disable_irq();
+    I2CQ_Submit(&queue, &x1);
+    I2CQ_Submit(&queue, &x2);
+    I2CQ_Submit(&queue, &x3);
+    __enable_irq();
+
+    n = SIM_I2C_Drain(CHECK_BUS, out, sizeof(out));
+    report("chained read/write/read",
+           I2CQ_IsIdle(&queue) && x1.Status == I2CQ_DONE && rd[0] == 0xAB && rd[1] == 0xCD
+               && x2.Status == I2CQ_DONE && x2.TxCount == 2 && x3.Status == I2CQ_DONE && rd1 == 0x33
+               && done_count == 3 && done_order[0] == 1 && done_order[1] == 2 && done_order[2] == 3
+               && n == sizeof(bus) && memcmp(out, bus, n) == 0 && SIM_I2C_GetStops(CHECK_BUS) == 3);
+}
+
+/* The slave does not acknowledge its address */
+static void check_nack(void)
+{
+    static const uint8_t stat[] = { 0x08, 0x20 };
+    static const uint8_t wr[2] = { 0x20, 0x47 };
+    I2CQ_XFER_Type x;
+    uint32_t stops = SIM_I2C_GetStops(CHECK_BUS);
+
+    SIM_I2C_Inject(CHECK_BUS, stat, NULL, sizeof(stat));
+    xfer_init(&x, 0x10, wr, 2, NULL, 0, 0, 4);
+    I2CQ_Submit(&queue, &x);
+    report("address NACK", x.Status == I2CQ_NACK && x.TxCount == 0 && I2CQ_IsIdle(&queue)
+                               && SIM_I2C_GetStops(CHECK_BUS) == stops + 1);
+}
+
+/* No slave answers after START: the timeout frees the bus for the next transaction */
+static void check_timeout(void)
+{
+    static const uint8_t probe[] = { 0x08, 0x18 };
+    static const uint8_t wr[2] = { 0x20, 0x47 };
+    I2CQ_XFER_Type hung, next;
+    int waiting;
+
+    xfer_init(&hung, 0x11, wr, 2, NULL, 0, 3, 5);
+    xfer_init(&next, 0x12, NULL, 0, NULL, 0, 3, 6);
+    I2CQ_Submit(&queue, &hung);
+    I2CQ_Submit(&queue, &next);
+    I2CQ_Tick(&queue);
+    I2CQ_Tick(&queue);
+    waiting = (hung.Status == I2CQ_PENDING) && (next.Status == I2CQ_PENDING);
+    SIM_I2C_Inject(CHECK_BUS, probe, NULL, sizeof(probe));
+    I2CQ_Tick(&queue);
+    report("hung bus timeout", waiting && hung.Status == I2CQ_TIMEOUT && next.Status == I2CQ_DONE
+                                   && I2CQ_IsIdle(&queue));
+}
+
+/* Another master wins the bus during the address */
+static void check_arbitration(void)
+{
+    static const uint8_t stat[] = { 0x08, 0x38 };
+    static const uint8_t wr[2] = { 0x20, 0x47 };
+    I2CQ_XFER_Type x;
+
+    SIM_I2C_Inject(CHECK_BUS, stat, NULL, sizeof(stat));
+    xfer_init(&x, 0x1D, wr, 2, NULL, 0, 10, 7);
+    I2CQ_Submit(&queue, &x);
+    report("arbitration loss", x.Status == I2CQ_ARB_LOST && x.TxCount == 0 && I2CQ_IsIdle(&queue));
+}
+
+int main(void)
+{
+    I2CQ_STATS_Type stats;
+
+    SIM_Init();
+    SystemInit();
+    I2C_Init(LPC_I2C1, 100000);
+    I2C_Cmd(LPC_I2C1, I2C_MASTER_MODE, ENABLE);
+    I2CQ_Init(&queue, LPC_I2C1);
+
+    check_chain();
+    check_nack();
+    check_timeout();
+    check_arbitration();
+
+    I2CQ_GetStats(&queue, &stats);
+    printf("transfers %u bytes %u max depth %u nacks %u timeouts %u errors %u\n", (unsigned)stats.Transfers,
+           (unsigned)stats.Bytes, (unsigned)stats.MaxDepth, (unsigned)stats.Nacks, (unsigned)stats.Timeouts,
+           (unsigned)stats.Errors);
+    report("statistics", stats.Transfers == 4 && stats.Nacks == 1 && stats.Timeouts == 1 && stats.Errors == 1
+                             && stats.MaxDepth == 3);
+    printf("%u checks failed\n", (unsigned)failures);
+    return (failures != 0) ? 1 : 0;
+}
@@ -0,0 +1,191 @@
+/**************************************************************************//**
+ * @file     sim_bench.c
+ * @brief    Host benchmark of the register access paths of the simulator
+ * @version  V1.00
+ *
+ * @note
+ * Usage: sim_bench [accesses]
+ *
+ * Runs [accesses] (default 1000000) loads or stores on a few hot modelled
+ * registers, UART0 LSR, GPIO0 FIOSET, TIM0 TC and a bit-band alias of
+ * FIOSET, three ways: through HWREG_READ()/HWREG_WRITE(), which call the
+ * simulator directly; as plain accesses trapped and carried out by the
+ * SIGSEGV handler (the decoded mov forms); and trapped and single stepped.
+ * It prints accesses per second of host time. Each run checks that every
+ * access reached the model.
+ * A trapped access costs at least one signal delivery: on an idle host a
+ * plain register access runs at about 300 thousand per second decoded and
+ * 60 to 80 thousand single stepped, the 100 MHz target does tens of
+ * millions. Only the accessors reach about 2 million per second, and only
+ * the polling loops and inline pin functions of the drivers use them.
+ * Built by "make HOST=1 sim_bench" in ../drivers.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "LPC17xx.h"
+#include "lpc17xx_gpio.h"
+#include "sim_LPC17xx.h"
+
+/* One register under test */
+typedef struct
+{
+    const char* name;
+    void (*plain)(uint32_t n);
+    void (*accessor)(uint32_t n);             /* NULL: none */
+    uint8_t gpio;                             /* sets all port 0 outputs */
+} Bench_Type;
+
+static volatile uint32_t sink;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void uart_lsr(uint32_t n)
+{
+    uint32_t acc = 0;
+
+    while (n--)
+    {
+        acc += LPC_UART0->LSR;
+    }
+    sink = acc;
+}
+
+static void uart_lsr_hwreg(uint32_t n)
+{
+    uint32_t acc = 0;
+
+    while (n--)
+    {
+        acc += HWREG_READ(LPC_UART0->LSR);
+    }
+    sink = acc;
+}
+
+static void gpio_fioset(uint32_t n)
+{
+    while (n--)
+    {
+        LPC_GPIO0->FIOSET = 1UL << (n & 31);
+    }
+}
+
+static void gpio_fioset_hwreg(uint32_t n)
+{
+    while (n--)
+    {
+        HWREG_WRITE(LPC_GPIO0->FIOSET, 1UL << (n & 31));
+    }
+}
+
+static void tim_tc(uint32_t n)
+{
+    uint32_t acc = 0;
+
+    while (n--)
+    {
+        acc += LPC_TIM0->TC;
+    }
+    sink = acc;
+}
+
+static void tim_tc_hwreg(uint32_t n)
+{
+    uint32_t acc = 0;
+
+    while (n--)
+    {
+        acc += HWREG_READ(LPC_TIM0->TC);
+    }
+    sink = acc;
+}
+
+static void gpio_bitband(uint32_t n)
+{
+    while (n--)
+    {
+        GPIO_BITBAND(LPC_GPIO0->FIOSET, n & 31) = 1;
+    }
+}
+
+static const Bench_Type benches[] = {
+    { "UART0 LSR load", uart_lsr, uart_lsr_hwreg, 0 },
+    { "GPIO0 FIOSET store", gpio_fioset, gpio_fioset_hwreg, 1 },
+    { "TIM0 TC load", tim_tc, tim_tc_hwreg, 0 },
+    { "FIOSET bit-band store", gpio_bitband, NULL, 1 },
+};
+
+/* Accesses per second of one register: path 0 accessor, 1 emulated, 2 single stepped */
+static double run(const Bench_Type* b, uint8_t path, uint32_t n)
+{
+    uint64_t count;
+    uint64_t t0;
+    uint64_t dt;
+
+    SIM_Reset();
+    SIM_SetAccessEmulation(path < 2);
+    LPC_GPIO0->FIODIR = 0xFFFFFFFFUL;
+    LPC_TIM0->TCR = 1;
+    count = SIM_GetAccessCount();
+    t0 = now_ns();
+    ((path == 0) ? b->accessor : b->plain)(n);
+    dt = now_ns() - t0;
+    count = SIM_GetAccessCount() - count;
+
+    /* The bit-band store is one access to the alias, none to the GPIO model */
+    if (count != n)
+    {
+        fprintf(stderr, "sim_bench: %s: %llu of %u accesses trapped\n", b->name, (unsigned long long)count,
+                (unsigned)n);
+        exit(1);
+    }
+    if (b->gpio)
+    {
+        if (SIM_GPIO_GetOutput(0) != 0xFFFFFFFFUL)
+        {
+            fprintf(stderr, "sim_bench: %s: outputs 0x%08X\n", b->name, (unsigned)SIM_GPIO_GetOutput(0));
+            exit(1);
+        }
+    }
+    return (double)n * 1e9 / (double)dt;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t n = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000000;
+    uint32_t i;
+
+    SIM_Init();
+    printf("%u accesses per run, accesses per second of host time\n", (unsigned)n);
+    printf("register                 HWREG_ ns/acc     emulated ns/acc   single step ns/acc\n");
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++)
+    {
+        const Bench_Type* b = &benches[i];
+        double emulated = run(b, 1, n);
+        double stepped = run(b, 2, n);
+
+        if (b->accessor != NULL)
+        {
+            double direct = run(b, 0, n);
+
+            printf("%-22s %10.0f %6.0f", b->name, direct, 1e9 / direct);
+        }
+        else
+        {
+            printf("%-22s %10s %6s", b->name, "-", "-");
+        }
+        printf("   %10.0f %6.0f    %10.0f %6.0f\n", emulated, 1e9 / emulated, stepped, 1e9 / stepped);
+    }
+    SIM_SetAccessEmulation(1);
+    return 0;
+}
@@ -21,6 +21,8 @@
 #include "lpc17xx_adc.h"     /* ADC handling */
 #include "lpc17xx_dac.h"     /* DAC handling */
 #include "lpc17xx_gpdma.h"   /* DMA handling */
+#include "lpc17xx_capture.h" /* Edge timestamp capture */
+#include "lpc17xx_prof.h"    /* Cycle counter profiling */
 
 /* --- DEFINEs and TYPEDEFs --- */
 
@@ -57,7 +59,8 @@
  * @brief Timer defines.
  *
  */
-#define SECOND_IN_US 1000000 /* 1 second in [us] */
+#define SECOND_IN_US 1000000    /* 1 second in [us] */
+#define DAC_UPDATE_TIME 500000 /* DAC update period in [us] */
 
 /**
  * @brief ADC defines.
@@ -65,6 +68,28 @@
  */
 #define ADC_FREQ 100000 /* ADC frequency in [Hz] */
 
+/**
+ * @brief PWM capture defines.
+ *
+ */
+#define CAPTURE_DMA_CHANNEL 0 /* GPDMA channel that stores the edge timestamps */
+#define CAPTURE_EDGES 64      /* Edges kept in the timestamp ring */
+#define CAPTURE_PERIODS 10    /* PWM periods averaged for the DAC output */
+
+/**
+ * @brief DAC defines.
+ *
+ */
+#define DAC_DUTY_SHIFT 6 /* Duty cycle (16 bits) to DAC value (10 bits) */
+
+/**
+ * @brief Profiling probes defines.
+ *
+ */
+#define PROF_EINT3 0  /* EINT3_IRQHandler duration */
+#define PROF_TIMER0 1 /* TIMER0_IRQHandler duration */
+#define PROF_ADC 2    /* ADC_IRQHandler duration */
+
 /**
  * @brief Ports pins defines.
  *
@@ -80,6 +105,28 @@
  */
 static uint32_t adc_value = 0; /* ADC conversion value */
 
+/**
+ * @brief PWM capture variables.
+ *
+ */
+static uint32_t capture_buffer[CAPTURE_EDGES]; /* Timestamps of the PWM edges, filled by DMA */
+static CAPTURE_Type pwm_capture;               /* Capture engine of P0.4 (CAP2.0) */
+
+/* --- Function prototypes --- */
+
+void setup(void);
+void config_profiling(void);
+void config_GPIO_ports(void);
+void config_SysTick(void);
+void config_timer(void);
+void config_ADC(void);
+void config_DAC(void);
+void config_DMA(void);
+void start_int(void);
+void start_SysTick(void);
+void start_timer(void);
+void start_ADC(void);
+
 /* --- Methods --- */
 
 /**
@@ -91,6 +138,9 @@ void setup(void)
     /* Initialize the system clock and power (default clock: 100 [MHz]) */
     SystemInit();
 
+    /* Start the DWT cycle counter used by the profiling probes. */
+    config_profiling();
+
     /* Load the configuration of each peripheral. */
     config_GPIO_ports();
     config_SysTick();
@@ -98,6 +148,22 @@ void setup(void)
     config_ADC();
     config_DAC();
     config_DMA();
+
+    /* Start the peripherals. */
+    start_timer();
+    start_int();
+}
+
+/**
+ * @brief Start the profiling probes.
+ *
+ */
+void config_profiling(void)
+{
+    PROF_Init();
+    PROF_SetName(PROF_EINT3, "EINT3");
+    PROF_SetName(PROF_TIMER0, "TIMER0");
+    PROF_SetName(PROF_ADC, "ADC");
 }
 
 /**
@@ -106,21 +172,12 @@ void setup(void)
  */
 void config_GPIO_ports(void)
 {
-    PINSEL_CFG_Type pin_cfg;
+    static const PINSEL_CFG_Type pin_table[] = {
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_4, PINSEL_FUNC_3, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL),  /* CAP2.0 */
+        PINSEL_CFG(PINSEL_PORT_0, PINSEL_PIN_26, PINSEL_FUNC_2, PINSEL_PINMODE_PULLUP, PINSEL_PINMODE_NORMAL), /* AOUT */
+    };
 
-    pin_cfg.Portnum = PINSEL_PORT_0;
-    pin_cfg.Pinnum = PINSEL_PIN_4;
-    pin_cfg.Funcnum = PINSEL_FUNC_3;
-    pin_cfg.Pinmode = PINSEL_PINMODE_PULLUP;
-    pin_cfg.OpenDrain = PINSEL_PINMODE_NORMAL;
-    PINSEL_ConfigPin(&pin_cfg);
-
-    pin_cfg.Portnum = PINSEL_PORT_0;
-    pin_cfg.Pinnum = PINSEL_PIN_26;
-    pin_cfg.Funcnum = PINSEL_FUNC_2;
-    pin_cfg.Pinmode = PINSEL_PINMODE_PULLUP;
-    pin_cfg.OpenDrain = PINSEL_PINMODE_NORMAL;
-    PINSEL_ConfigPin(&pin_cfg);
+    PINSEL_ConfigPins(pin_table, PINSEL_TABLE_SIZE(pin_table));
 
     GPIO_SetDir(PINSEL_PORT_0, PWM_SIGNAL_INPUT_PIN, INPUT);
     GPIO_SetDir(PINSEL_PORT_0, DAC_OUTPUT_PIN, OUTPUT);
@@ -135,12 +192,25 @@ void config_SysTick(void)
 }
 
 /**
- * @brief Configure timer 0.
+ * @brief Configure timer 0 to update the DAC every 0.5 [s].
  *
  */
 void config_timer(void)
 {
-    
+    TIM_TIMERCFG_Type timer_cfg;
+    TIM_MATCHCFG_Type match_cfg;
+
+    timer_cfg.PrescaleOption = TIM_PRESCALE_USVAL;
+    timer_cfg.PrescaleValue = (uint32_t)1;
+    TIM_Init(LPC_TIM0, TIM_TIMER_MODE, &timer_cfg);
+
+    match_cfg.MatchChannel = 0;
+    match_cfg.IntOnMatch = ENABLE;
+    match_cfg.StopOnMatch = DISABLE;
+    match_cfg.ResetOnMatch = ENABLE;
+    match_cfg.ExtMatchOutputType = TIM_EXTMATCH_NOTHING;
+    match_cfg.MatchValue = (uint32_t)DAC_UPDATE_TIME;
+    TIM_ConfigMatch(LPC_TIM0, &match_cfg);
 }
 
 /**
@@ -157,14 +227,31 @@ void config_ADC(void)
  */
 void config_DAC(void)
 {
+    DAC_Init(LPC_DAC);
 }
 
 /**
- * @brief Configure DMA.
+ * @brief Configure DMA to timestamp every PWM edge, without interrupts.
  *
+ * Timer 2 counts both edges of CAP2.0 and each count raises a DMA request
+ * that copies the free running timer 3 into the ring buffer.
  */
 void config_DMA(void)
 {
+    CAPTURE_CFG_Type capture_cfg;
+
+    GPDMA_Init();
+
+    capture_cfg.CounterTIMx = LPC_TIM2;
+    capture_cfg.TimebaseTIMx = LPC_TIM3;
+    capture_cfg.CaptureChannel = TIM_COUNTER_INCAP0;
+    capture_cfg.DMAChannel = CAPTURE_DMA_CHANNEL;
+    capture_cfg.PinPort = PINSEL_PORT_0;
+    capture_cfg.PinNum = PINSEL_PIN_4;
+    capture_cfg.Buffer = capture_buffer;
+    capture_cfg.BufferSize = CAPTURE_EDGES;
+    CAPTURE_Init(&pwm_capture, &capture_cfg);
+    CAPTURE_Start(&pwm_capture);
 }
 
 /**
@@ -173,6 +260,7 @@ void config_DMA(void)
  */
 void start_int(void)
 {
+    NVIC_EnableIRQ(TIMER0_IRQn);
 }
 
 /**
@@ -189,6 +277,7 @@ void start_SysTick(void)
  */
 void start_timer(void)
 {
+    TIM_Cmd(LPC_TIM0, ENABLE);
 }
 
 /**
@@ -205,6 +294,9 @@ void start_ADC(void)
  */
 void EINT3_IRQHandler(void)
 {
+    uint32_t prof_start = PROF_Start(); /* Handler duration probe */
+
+    PROF_Stop(PROF_EINT3, prof_start);
 }
 
 /**
@@ -216,11 +308,22 @@ void SysTick_Handler(void)
 }
 
 /**
- * @brief Overwrite the Timer 0 handler routine.
+ * @brief Overwrite the Timer 0 handler routine, output the duty cycle of the
+ * last PWM periods on the DAC.
  *
  */
 void TIMER0_IRQHandler(void)
 {
+    uint32_t prof_start = PROF_Start(); /* Handler duration probe */
+    CAPTURE_RESULT_Type pwm;
+
+    if (CAPTURE_Measure(&pwm_capture, CAPTURE_PERIODS, &pwm) == SUCCESS)
+    {
+        DAC_UpdateValue(LPC_DAC, (uint32_t)(pwm.Duty >> DAC_DUTY_SHIFT));
+    }
+    TIM_ClearIntPending(LPC_TIM0, TIM_MR0_INT);
+
+    PROF_Stop(PROF_TIMER0, prof_start);
 }
 
 /**
@@ -229,6 +332,9 @@ void TIMER0_IRQHandler(void)
  */
 void ADC_IRQHandler(void)
 {
+    uint32_t prof_start = PROF_Start(); /* Handler duration probe */
+
+    PROF_Stop(PROF_ADC, prof_start);
 }
 
 /* --- Main method --- */
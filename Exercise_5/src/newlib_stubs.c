@@ -6,9 +6,18 @@
  *
  * @note Avoid modifying this file unless necessary. These implementations are minimal and may need
  *       to be expanded based on specific project requirements.
+ * @note Console input and output go through the STDIO driver module: select a transport (UART ring,
+ *       semihosting or RAM trace buffer) with `STDIO_Init()`, until then the output is discarded.
+ * @note `malloc` and friends are served by the HEAP driver module (TLSF, constant time, usable from
+ *       interrupts) on the RAM between the end of the BSS segment and the stack reserve.
  */
 
 #include <errno.h>
+#ifdef __USE_HOST_SIM
+struct _reent; // The host C library has no reent.h, the stubs are only built for tools/stdio_check.c there.
+#else
+#include <reent.h>
+#endif
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -18,17 +27,27 @@
 
 #include "LPC17xx.h"
 #include "core_cm3.h"
+#include "lpc17xx_heap.h"
+#include "lpc17xx_stdio.h"
 
 #undef errno
 
 extern int errno; //!< The `errno` variable is set by system calls and some library functions in the event of an error
                   //!< to indicate what went wrong. Each thread has its own error value, so `errno` is thread-local.
 
+#ifndef NEWLIB_STACK_SIZE
+#define NEWLIB_STACK_SIZE 2048 //!< Bytes kept for the stack below `_vStackTop`, the heap ends there.
+#endif
+
 extern char _ebss; //!< This variable is defined by the linker script and marks the end of the BSS segment. It is used
-                   //!< as the initial value of the heap in the `_sbrk` implementation.
+                   //!< as the start of the heap.
+
+extern char _vStackTop; //!< Defined by the linker script, the initial stack pointer. The stack grows down from here.
 
-static char* heap_end; //!< `heap_end` is a pointer to the current end of the heap, used by the `_sbrk` function to
-                       //!< manage dynamic memory allocation.
+HEAP_Type newlib_heap; //!< Heap behind `malloc`, pass it to `HEAP_GetStats()` for the high-water mark and the
+                       //!< fragmentation.
+
+static volatile int heap_ready; //!< Set once `newlib_heap` has been set up on its region.
 
 char* __env[1] = {0}; //!< The `__env` array is a placeholder for environment variables. In this minimal implementation,
                       //!< it contains only a single `NULL` pointer, indicating that no environment variables are set.
@@ -180,27 +199,137 @@ int _lseek(int file, int ptr, int dir)
  * @brief Increases program data space (heap).
  *
  * @param incr Number of bytes to increase heap by.
- * @return Pointer to the start of the new heap area on success, (caddr_t)-1 on error.
+ * @return (caddr_t)-1, the heap region belongs to the allocator behind `malloc`.
  */
 caddr_t _sbrk(int incr)
 {
-    if (heap_end == 0)
+    errno = ENOMEM;
+    return (caddr_t)-1;
+}
+
+/**
+ * @brief Returns the heap, set up on its region on first use.
+ *
+ * @return Heap behind `malloc`.
+ */
+static HEAP_Type* heap_get(void)
+{
+    uint32_t primask;
+
+    if (!heap_ready)
+    {
+        // The first call may come from an interrupt, set up only once.
+        primask = __get_PRIMASK();
+        __disable_irq();
+        if (!heap_ready)
+        {
+            HEAP_Init(&newlib_heap, &_ebss, (uint32_t)(&_vStackTop - &_ebss) - NEWLIB_STACK_SIZE);
+            heap_ready = 1;
+        }
+        __set_PRIMASK(primask);
+    }
+    return &newlib_heap;
+}
+
+/**
+ * @brief Allocates memory.
+ *
+ * @param size Number of bytes.
+ * @return Pointer to the block, aligned to 8 bytes, NULL if out of memory.
+ */
+void* malloc(size_t size)
+{
+    void* ptr = HEAP_Alloc(heap_get(), size);
+
+    if (ptr == NULL)
+    {
+        errno = ENOMEM;
+    }
+    return ptr;
+}
+
+/**
+ * @brief Frees memory.
+ *
+ * @param ptr Block from `malloc`, `calloc` or `realloc`, NULL is ignored.
+ */
+void free(void* ptr)
+{
+    HEAP_Free(heap_get(), ptr);
+}
+
+/**
+ * @brief Resizes a block of memory, keeping its contents.
+ *
+ * @param ptr Block, NULL allocates.
+ * @param size New number of bytes, 0 frees.
+ * @return Pointer to the block, NULL if out of memory (the old block is kept).
+ */
+void* realloc(void* ptr, size_t size)
+{
+    void* moved = HEAP_Realloc(heap_get(), ptr, size);
+
+    if ((moved == NULL) && (size != 0))
     {
-        heap_end = &_ebss;
+        errno = ENOMEM;
     }
+    return moved;
+}
 
-    char* prev_heap_end = heap_end;
-    char* stack = (char*)__get_MSP();
+/**
+ * @brief Allocates zeroed memory for an array.
+ *
+ * @param count Number of elements.
+ * @param size Size of an element.
+ * @return Pointer to the block, NULL if out of memory or on overflow.
+ */
+void* calloc(size_t count, size_t size)
+{
+    void* ptr;
 
-    if (heap_end + incr > stack)
+    if ((size != 0) && (count > (size_t)-1 / size))
     {
-        _write(STDERR_FILENO, "Heap and stack collision\n", 25);
         errno = ENOMEM;
-        return (caddr_t)-1;
+        return NULL;
+    }
+    ptr = malloc(count * size);
+    if (ptr != NULL)
+    {
+        memset(ptr, 0, count * size);
     }
+    return ptr;
+}
+
+/**
+ * @brief Reentrant `malloc`, called by the C library itself.
+ */
+void* _malloc_r(struct _reent* r, size_t size)
+{
+    return malloc(size);
+}
+
+/**
+ * @brief Reentrant `free`, called by the C library itself.
+ */
+void _free_r(struct _reent* r, void* ptr)
+{
+    free(ptr);
+}
+
+/**
+ * @brief Reentrant `realloc`, called by the C library itself.
+ */
+void* _realloc_r(struct _reent* r, void* ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
 
-    heap_end += incr;
-    return (caddr_t)prev_heap_end;
+/**
+ * @brief Reentrant `calloc`, called by the C library itself.
+ */
+void* _calloc_r(struct _reent* r, size_t count, size_t size)
+{
+    return calloc(count, size);
 }
 
 /**
@@ -215,9 +344,7 @@ int _read(int file, char* ptr, int len)
 {
     switch (file)
     {
-        case STDIN_FILENO:
-            // Implement input reading if necessary
-            return 0;
+        case STDIN_FILENO: return STDIO_Read(ptr, len);
         default: errno = EBADF; return -1;
     }
 }
@@ -282,9 +409,11 @@ int _write(int file, char* ptr, int len)
 {
     switch (file)
     {
-        case STDOUT_FILENO:
+        case STDOUT_FILENO: return STDIO_Write(ptr, len);
         case STDERR_FILENO:
-            // Implement output writing if necessary
+            // Error output is not held back until the end of a line.
+            len = STDIO_Write(ptr, len);
+            STDIO_Flush();
             return len;
         default: errno = EBADF; return -1;
     }